@@ -37,6 +37,9 @@
 #include <iostream>
 #include <string>
 #include <array>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
 
 template<typename T, size_t N>
 class circ_buf {
@@ -130,4 +133,121 @@ private:
 	unsigned n;
 };
 
+/* Size of a cache line, circ_buf_rec slots are aligned to this */
+#define CIRC_BUF_CACHE_LINE 64
+
+/**
+ * Circular buffer of fixed size character records.
+ *
+ * Records are copied into N preallocated, cache line aligned slots of S
+ * bytes each, so push_back() never allocates.  Any number of threads may
+ * call push_back() concurrently.  snapshot() and dump() do not remove
+ * records and may run concurrently with push_back(); a slot that is
+ * being overwritten while it is read is skipped.
+ */
+template<size_t N, size_t S>
+class circ_buf_rec {
+public:
+	circ_buf_rec() :
+			next(0)
+	{
+		clear();
+	}
+
+	/* Add a record, truncated to S - 1 characters */
+	void push_back(const char *rec, size_t len)
+	{
+		uint64_t seq = next.fetch_add(1, std::memory_order_relaxed);
+		slot &s = buffer[seq % N];
+
+		/* Invalidate the slot while it is being written */
+		s.seq.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		if (len >= S) {
+			len = S - 1;
+		}
+		memcpy(s.data, rec, len);
+		s.data[len] = '\0';
+		s.len = len;
+
+		s.seq.store(seq + 1, std::memory_order_release);
+	} /* push_back() */
+
+	void push_back(const char *rec)
+	{
+		push_back(rec, strnlen(rec, S - 1));
+	}
+
+	/**
+	 * Call f(const char *rec, size_t len) for each record, oldest first.
+	 * Returns the number of records passed to f.
+	 */
+	template<typename F>
+	unsigned snapshot(F f) const
+	{
+		char data[S];
+		uint64_t last = next.load(std::memory_order_acquire);
+		uint64_t seq = (last > N) ? last - N : 0;
+		unsigned count = 0;
+
+		for (; seq < last; seq++) {
+			const slot &s = buffer[seq % N];
+			uint64_t s1 = s.seq.load(std::memory_order_acquire);
+			uint32_t len = s.len;
+
+			if ((s1 != seq + 1) || (len >= S)) {
+				continue;
+			}
+			memcpy(data, s.data, len);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (s.seq.load(std::memory_order_relaxed) != s1) {
+				continue;
+			}
+			data[len] = '\0';
+			f((const char *)data, (size_t)len);
+			count++;
+		}
+		return count;
+	} /* snapshot() */
+
+	void dump() const
+	{
+		snapshot([](const char *rec, size_t len) {
+			std::cout << rec;
+			if (!len || ('\n' != rec[len - 1])) {
+				std::cout << std::endl;
+			}
+		});
+	} /* dump() */
+
+	/* Discard all records, must not run concurrently with push_back() */
+	void clear()
+	{
+		for (size_t i = 0; i < N; i++) {
+			buffer[i].seq.store(0, std::memory_order_relaxed);
+			buffer[i].len = 0;
+		}
+		next.store(0, std::memory_order_release);
+	} /* clear() */
+
+	/* Number of records currently held */
+	size_t size() const
+	{
+		uint64_t last = next.load(std::memory_order_acquire);
+		return (last > N) ? N : last;
+	}
+
+private:
+	struct alignas(CIRC_BUF_CACHE_LINE) slot {
+		std::atomic<uint64_t> seq; /* Sequence number + 1, 0 if invalid */
+		uint32_t len;
+		char data[S];
+	};
+
+	/* Producers only contend on the next sequence number */
+	alignas(CIRC_BUF_CACHE_LINE) std::atomic<uint64_t> next;
+	std::array<slot, N> buffer;
+};
+
 #endif /* __CIRC_BUF_H__ */
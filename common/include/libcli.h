@@ -140,6 +140,10 @@ int update_string(char **target, char *new_str, int len);
  */
 int get_v_str(char **target, char *parm, int chk_slash);
 
+/* Frees a string allocated by update_string or get_v_str, sets *target NULL
+ */
+void free_string(char **target);
+
 /* CLI initialization/command binding routine.
  * The console_cleanup function is invoked by the "quit" command
  * on exit from the CLI.
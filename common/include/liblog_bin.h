@@ -0,0 +1,152 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2016, Integrated Device Technology Inc.
+ Copyright (c) 2016, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#ifndef __LIBLOG_BIN_H__
+#define __LIBLOG_BIN_H__
+
+/**
+ * Binary log format.
+ *
+ * In binary mode rdma_log() does not format the log line.  Instead the
+ * address of the format string and the raw argument values are captured
+ * into a fixed size record in a memory mapped file.  The format string,
+ * file name, function name and level string are written once to a string
+ * table in the same file, keyed by their address in the logging process.
+ *
+ * File layout:
+ *   struct rdma_log_bin_hdr                   (one page)
+ *   string table                              (str_tab_size bytes)
+ *   struct rdma_log_bin_rec[num_recs]         (ring of records)
+ *
+ * The decoder (rdma_log_decode) turns the records back into the same one
+ * line text format produced by rdma_log().
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RDMA_LOG_BIN_MAGIC	0x474f4c42 /* "BLOG" */
+#define RDMA_LOG_BIN_VERSION	1
+
+#define RDMA_LOG_BIN_HDR_SIZE	4096
+#define RDMA_LOG_BIN_REC_SIZE	256
+#define RDMA_LOG_BIN_DFLT_RECS	16384
+#define RDMA_LOG_BIN_STR_TAB_SIZE (256 * 1024)
+
+/* Set in arg_len when the arguments did not fit in the record */
+#define RDMA_LOG_BIN_ARGS_TRUNC	0x8000
+#define RDMA_LOG_BIN_ARGS_LEN(x) ((x) & ~RDMA_LOG_BIN_ARGS_TRUNC)
+
+struct rdma_log_bin_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t rec_size;
+	uint32_t num_recs;
+	uint64_t str_tab_offset;
+	uint64_t str_tab_size;
+	uint64_t rec_offset;
+	uint64_t str_tab_used; /* Bytes of string table in use */
+	uint64_t next_seq; /* Sequence number of next record */
+};
+
+/* String table entry, padded to a multiple of 8 bytes */
+struct rdma_log_bin_str {
+	uint64_t key; /* Address of the string in the logging process */
+	uint32_t len; /* Length of str, excluding the terminating NUL */
+	char str[4];
+};
+
+#define RDMA_LOG_BIN_REC_HDR_SIZE 64
+#define RDMA_LOG_BIN_ARG_SPACE (RDMA_LOG_BIN_REC_SIZE - RDMA_LOG_BIN_REC_HDR_SIZE)
+
+struct rdma_log_bin_rec {
+	uint64_t seq; /* Record sequence number + 1, 0 while being written */
+	uint64_t fmt; /* String table keys */
+	uint64_t file;
+	uint64_t func;
+	uint64_t level_str;
+	int64_t tv_sec;
+	int32_t tv_usec;
+	int32_t tid;
+	int32_t line_num;
+	uint16_t level;
+	uint16_t arg_len; /* Bytes of args[] used, RDMA_LOG_BIN_ARGS_TRUNC */
+	uint8_t args[RDMA_LOG_BIN_ARG_SPACE];
+};
+
+/**
+ * A binary log mapped for decoding, either a file written by another
+ * process or the live log of this process.
+ */
+struct rdma_log_bin_map {
+	const struct rdma_log_bin_hdr *hdr;
+	size_t size;
+	void *str_idx; /* Private, string table index */
+	int owner; /* Non-zero if the mapping must be unmapped on close */
+};
+
+/* Callback for each decoded log line */
+typedef void (*rdma_log_bin_line_cb)(const char *line, void *arg);
+
+int rdma_log_bin_init(const char *log_filename, unsigned num_recs);
+
+void rdma_log_bin_close(void);
+
+int rdma_log_bin_active(void);
+
+int rdma_log_bin_va(unsigned level, const char *level_str, const char *file,
+		int line_num, const char *func, const char *format,
+		va_list args);
+
+int rdma_log_bin_open(const char *path, struct rdma_log_bin_map *map);
+
+int rdma_log_bin_open_live(struct rdma_log_bin_map *map);
+
+void rdma_log_bin_unmap(struct rdma_log_bin_map *map);
+
+int rdma_log_bin_format(struct rdma_log_bin_map *map,
+		const struct rdma_log_bin_rec *rec, char *buf, size_t buf_len);
+
+int rdma_log_bin_walk(struct rdma_log_bin_map *map, unsigned max_lines,
+		rdma_log_bin_line_cb cb, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LIBLOG_BIN_H__ */
@@ -48,6 +48,53 @@ extern "C" {
 
 int get_rsvd_phys_mem(char *parm_name, uint64_t *start_addr, uint64_t *size);
 
+/* Buddy allocator for reserved physical memory.
+ *
+ * The allocator hands out physical address ranges from a reserved region.
+ * Its metadata is kept in a POSIX shared memory object, so every process
+ * on the node that opens the same object shares one view of the region.
+ * Blocks are powers of two between 2^RSVD_BUDDY_MIN_ORDER bytes and the
+ * largest naturally aligned block that fits in the region.  A block of
+ * 2^k bytes is aligned to 2^k relative to the region start.
+ */
+#define RSVD_BUDDY_MIN_ORDER	12 /* 4 KB, the page size */
+#define RSVD_BUDDY_MAX_ORDER	63
+#define RSVD_BUDDY_SHM_FMT	"/RIO_RSVD_BUDDY_%s"
+
+struct rsvd_buddy;
+
+struct rsvd_buddy_stats {
+	uint64_t start_addr; /* Physical start address of the region */
+	uint64_t size; /* Bytes in the region */
+	uint64_t free_bytes; /* Bytes not allocated */
+	uint64_t largest_free; /* Size of the largest free block */
+	uint32_t free_blocks[RSVD_BUDDY_MAX_ORDER + 1]; /* Free, by order */
+	uint64_t allocs; /* Blocks currently allocated */
+	uint64_t alloc_total; /* Successful allocations since creation */
+	uint64_t alloc_fails; /* Failed allocations since creation */
+	uint32_t frag_pct; /* External fragmentation, 0 to 100 */
+};
+
+int rsvd_buddy_attach(const char *shm_name, uint64_t start_addr,
+		uint64_t size, struct rsvd_buddy **buddy);
+
+int rsvd_buddy_open(char *parm_name, struct rsvd_buddy **buddy);
+
+void rsvd_buddy_close(struct rsvd_buddy *buddy);
+
+int rsvd_buddy_unlink(const char *shm_name);
+
+int rsvd_buddy_alloc(struct rsvd_buddy *buddy, uint64_t size, uint64_t align,
+		uint64_t *phys_addr);
+
+int rsvd_buddy_alloc_ibwin(struct rsvd_buddy *buddy, uint64_t size,
+		uint64_t *phys_addr);
+
+int rsvd_buddy_free(struct rsvd_buddy *buddy, uint64_t phys_addr);
+
+int rsvd_buddy_get_stats(struct rsvd_buddy *buddy,
+		struct rsvd_buddy_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
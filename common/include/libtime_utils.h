@@ -74,6 +74,78 @@ void time_track_lim(int i, const struct timespec *limit,
 
 void time_sleep(const struct timespec *delay);
 
+/* Integer nanosecond time API.
+ *
+ * Times and time differences are held in a signed 64 bit count of
+ * nanoseconds, which covers +/- 292 years, so no seconds/nanoseconds
+ * normalization is required for any operation.
+ */
+#define TIME_NSEC_PER_SEC 1000000000LL
+
+static inline int64_t time_ts_to_ns(const struct timespec *ts)
+{
+	return (int64_t)ts->tv_sec * TIME_NSEC_PER_SEC + ts->tv_nsec;
+}
+
+static inline struct timespec time_ns_to_ts(int64_t ns)
+{
+	struct timespec ts;
+
+	ts.tv_sec = ns / TIME_NSEC_PER_SEC;
+	ts.tv_nsec = ns % TIME_NSEC_PER_SEC;
+	if (ts.tv_nsec < 0) {
+		ts.tv_sec--;
+		ts.tv_nsec += TIME_NSEC_PER_SEC;
+	}
+	return ts;
+}
+
+static inline int64_t time_ns_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return time_ts_to_ns(&ts);
+}
+
+static inline int64_t time_ns_diff(int64_t start, int64_t end)
+{
+	return end - start;
+}
+
+/* Running statistics of a series of nanosecond samples.
+ * Mean and variance are tracked with Welford's algorithm.
+ */
+struct time_ns_stats {
+	uint64_t count;
+	int64_t total;
+	int64_t min;
+	int64_t max;
+	double mean;
+	double m2; /* Sum of squared differences from the mean */
+};
+
+void time_ns_stats_init(struct time_ns_stats *st);
+
+void time_ns_stats_add(struct time_ns_stats *st, int64_t sample);
+
+void time_ns_stats_merge(struct time_ns_stats *st,
+		const struct time_ns_stats *other);
+
+double time_ns_stats_variance(const struct time_ns_stats *st);
+
+double time_ns_stats_stddev(const struct time_ns_stats *st);
+
+/* Bulk operations over arrays of samples */
+void time_ns_from_ts(const struct timespec *ts, int64_t *ns, int n);
+
+void time_ns_deltas(const int64_t *ns, int64_t *deltas, int n);
+
+void time_ns_reduce(const int64_t *samples, int n, struct time_ns_stats *st);
+
+int seq_ts_deltas_ns(const struct seq_ts *ts, int st_i, int end_i,
+		int64_t *deltas);
+
 #ifdef __cplusplus
 }
 #endif
@@ -316,6 +316,25 @@ int riomp_mgmt_rcfg_read(riomp_mport_t mport_handle, did_val_t did_val, hc_t hc,
 int riomp_mgmt_rcfg_write(riomp_mport_t mport_handle, did_val_t did_val,
 		hc_t hc, uint32_t offset, uint32_t size, uint32_t data);
 
+/**
+ * @brief write consecutive registers of a target RapidIO device
+ *
+ * Writes size bytes with a single request to the mport driver, which
+ * splits it into maintenance write transactions.
+ *
+ * @param[in] mport_handle valid mport handle
+ * @param[in] did_val Device destination ID
+ * @param[in] hc hop count
+ * @param[in] offset modulo four register offset
+ * @param[in] size number of bytes to write, a non-zero multiple of 4
+ * @param[in] data write data
+ * @return status of the function call
+ * @retval 0 on success
+ * @retval -errno on error
+ */
+int riomp_mgmt_rcfg_write_blk(riomp_mport_t mport_handle, did_val_t did_val,
+		hc_t hc, uint32_t offset, uint32_t size, const uint32_t *data);
+
 /**
  * @brief enable a range of doorbell events
  *
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2017 Integrated Device Technology, Inc.
+ * Copyright 2017 RapidIO.org
+ *
+ * Simulated mport management routines for the RapidIO mport device library.
+ * Only fabric simulators and their test programs need this header.
+ *
+ * This software is available to you under a choice of one of two licenses.
+ * You may choose to be licensed under the terms of the GNU General Public
+ * License(GPL) Version 2, or the BSD-3 Clause license below:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __RAPIDIO_MPORT_SIM_H__
+#define __RAPIDIO_MPORT_SIM_H__
+
+#include <stdint.h>
+#include "rio_route.h"
+#include "rapidio_mport_mgmt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief simulated mport management routines
+ *
+ * Replace the mport driver for mport handles created while the routines
+ * are registered, so that the fabric management software can run against
+ * a simulated fabric.  Each routine has the same parameters and return
+ * values as the management routine of the same name, except that the
+ * mport handle is replaced by ctx and the mport ID number.  Routines which
+ * are NULL return -ENOSYS.
+ */
+struct riomp_mgmt_sim_ops {
+	void *ctx; /**< passed to every routine */
+	int (*query)(void *ctx, uint8_t mport_id,
+			struct riomp_mgmt_mport_properties *qresp);
+	int (*destid_set)(void *ctx, uint8_t mport_id, did_val_t did_val);
+	int (*lcfg_read)(void *ctx, uint8_t mport_id, uint32_t offset,
+			uint32_t size, uint32_t *data);
+	int (*lcfg_write)(void *ctx, uint8_t mport_id, uint32_t offset,
+			uint32_t size, uint32_t data);
+	int (*rcfg_read)(void *ctx, uint8_t mport_id, did_val_t did_val,
+			hc_t hc, uint32_t offset, uint32_t size,
+			uint32_t *data);
+	int (*rcfg_write)(void *ctx, uint8_t mport_id, did_val_t did_val,
+			hc_t hc, uint32_t offset, uint32_t size,
+			uint32_t data);
+	int (*rcfg_write_blk)(void *ctx, uint8_t mport_id, did_val_t did_val,
+			hc_t hc, uint32_t offset, uint32_t size,
+			const uint32_t *data);
+	int (*device_add)(void *ctx, uint8_t mport_id, did_val_t did_val,
+			hc_t hc, ct_t ct, const char *name);
+	int (*device_del)(void *ctx, uint8_t mport_id, did_val_t did_val,
+			hc_t hc, ct_t ct, const char *name);
+};
+
+/** @brief fd of mport handles which use the simulated management routines */
+#define RIOMP_MGMT_SIM_FD (-1)
+
+/**
+ * @brief register simulated mport management routines
+ *
+ * Mport handles created after this call use ops rather than the mport
+ * device, and have the fd RIOMP_MGMT_SIM_FD.  Handles created before the
+ * call are not affected.  ops must remain valid until it is unregistered,
+ * and until all handles using it are destroyed.
+ *
+ * @param[in] ops simulated management routines, NULL to use the mport
+ *            device again
+ * @return status of the function call
+ * @retval 0 on success
+ */
+int riomp_mgmt_set_sim_ops(const struct riomp_mgmt_sim_ops *ops);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RAPIDIO_MPORT_SIM_H__ */
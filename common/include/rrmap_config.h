@@ -63,6 +63,10 @@ extern "C" {
 #define FMD_DFLT_LOG_LEVEL ((RDMA_LL_ERR < RDMA_LL)?RDMA_LL_WARN:RDMA_LL)
 #define FMD_DFLT_MAST_INTERVAL 5
 #define FMD_DFLT_MAST_DEVID 0xFD
+#define FMD_DFLT_INIT_WORKERS 0
+#define FMD_DFLT_SC_PERIOD 0
+#define FMD_DFLT_PS_PERIOD 10000
+#define FMD_DFLT_MT_ACCT 0
 
 /** \brief File transfer and CM_SOCK demo default CM ports */
 #define FXFR_DFLT_SVR_CM_PORT 5555
@@ -78,11 +82,14 @@ extern "C" {
 
 #define FMD_MAX_LOG_FILE_NAME 100
 #define FMD_LOG_FILE_FMT "fmd_%05d_log"
+#define FMD_BIN_LOG_FILE_FMT "fmd_%05d_log.bin"
 
 #define FMD_MAX_SHM_FN_LEN 100
 #define FMD_DFLT_SHM_DIR "/dev/shm"
 #define FMD_DFLT_DD_FN "/RIO_SM_DEV_DIR"
 #define FMD_DFLT_DD_MTX_FN "/RIO_SM_DEV_DIR_MUTEX"
+#define FMD_DFLT_SC_FN "/RIO_SM_SC_STATS"
+#define FMD_DFLT_MT_FN "/RIO_SM_MT_STATS"
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,97 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2016, Integrated Device Technology Inc.
+ Copyright (c) 2016, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#ifndef __TOK_READER_H__
+#define __TOK_READER_H__
+
+/**
+ * Whitespace separated token reader for configuration files.
+ *
+ * The whole file is read into one buffer and tokens are returned as
+ * views into that buffer.  Each token
+ * is NUL terminated in place, so it can be passed directly to the
+ * tok_parse_*() and parm_idx() functions.  No memory is allocated per
+ * line or per token.  Token views remain valid until tok_rdr_close().
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TOK_RDR_DFLT_DELIM " \t\r"
+
+struct tok_view {
+	char *str; /* NUL terminated token */
+	uint32_t len;
+	uint32_t line; /* Line of the token, starting at 1 */
+	uint32_t col; /* Column of the first character, starting at 1 */
+};
+
+struct tok_rdr {
+	char *buf; /* Input, buf[size] is always '\0' */
+	size_t size;
+	bool owned; /* buf is freed by tok_rdr_close() */
+	char *pos; /* Next character to scan */
+	char *end;
+	char *line_start;
+	uint32_t line;
+	bool eol; /* The current line has been consumed */
+	const char *comment; /* Tokens starting with this end the line */
+	size_t comment_len;
+	uint8_t cls[256]; /* Character classes */
+	struct tok_view last; /* Last token returned, for error messages */
+};
+
+int tok_rdr_open(struct tok_rdr *rdr, const char *filename,
+		const char *delim, const char *comment);
+
+int tok_rdr_init(struct tok_rdr *rdr, char *buf, size_t size,
+		const char *delim, const char *comment);
+
+void tok_rdr_close(struct tok_rdr *rdr);
+
+int tok_rdr_next(struct tok_rdr *rdr, struct tok_view *tok);
+
+int tok_rdr_next_in_line(struct tok_rdr *rdr, struct tok_view *tok);
+
+int tok_rdr_next_line(struct tok_rdr *rdr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TOK_READER_H__ */
@@ -212,6 +212,12 @@ int update_string(char **target, char *new_str, int len)
 	return -ENOMEM;
 }
 
+void free_string(char **target)
+{
+	free(*target);
+	*target = NULL;
+}
+
 int get_v_str(char **target, char *parm, int chk_slash)
 {
 	int len;
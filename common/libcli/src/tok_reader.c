@@ -0,0 +1,341 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2016, Integrated Device Technology Inc.
+ Copyright (c) 2016, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "tok_reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TOK_RDR_READ_CHUNK 4096
+
+enum tok_cls {
+	TOK_CLS_CHAR = 0,
+	TOK_CLS_DELIM,
+	TOK_CLS_NL,
+	TOK_CLS_NUL, /* Terminates the input, or an embedded NUL */
+};
+
+static inline void new_line(struct tok_rdr *rdr)
+{
+	rdr->line++;
+	rdr->line_start = rdr->pos;
+	rdr->eol = false;
+}
+
+/* Skip delimiters, returns false at the end of the line or input */
+static inline bool skip_delim(struct tok_rdr *rdr)
+{
+	char *p = rdr->pos;
+	bool rc = false;
+
+	for (;;) {
+		switch (rdr->cls[(unsigned char)*p]) {
+		case TOK_CLS_CHAR:
+			rc = true;
+			goto done;
+		case TOK_CLS_NL:
+			p++;
+			rdr->eol = true;
+			goto done;
+		case TOK_CLS_NUL:
+			if (p >= rdr->end) {
+				rdr->eol = true;
+				goto done;
+			}
+			p++;
+			break;
+		default:
+			p++;
+		}
+	}
+done:
+	rdr->pos = p;
+	return rc;
+}
+
+static inline void skip_line(struct tok_rdr *rdr)
+{
+	char *nl;
+
+	if (rdr->eol) {
+		return;
+	}
+	nl = (char *)memchr(rdr->pos, '\n', rdr->end - rdr->pos);
+	rdr->pos = (NULL == nl) ? rdr->end : nl + 1;
+	rdr->eol = true;
+}
+
+/* Take the token at pos, returns true if it starts a comment */
+static inline bool take_tok(struct tok_rdr *rdr, struct tok_view *tok)
+{
+	char *s = rdr->pos;
+	char *p = s;
+
+	/* buf[size] is '\0', which always ends a token */
+	while (TOK_CLS_CHAR == rdr->cls[(unsigned char)*p]) {
+		p++;
+	}
+
+	rdr->last.str = s;
+	rdr->last.len = (uint32_t)(p - s);
+	rdr->last.line = rdr->line;
+	rdr->last.col = (uint32_t)(s - rdr->line_start) + 1;
+
+	if (p < rdr->end) {
+		if ('\n' == *p) {
+			rdr->eol = true;
+		}
+		*p++ = '\0';
+	}
+	rdr->pos = p;
+
+	if (rdr->comment_len && (rdr->last.len >= rdr->comment_len)
+			&& !memcmp(s, rdr->comment, rdr->comment_len)) {
+		skip_line(rdr);
+		return true;
+	}
+	*tok = rdr->last;
+	return false;
+}
+
+/**
+ * @brief Initialize a reader over a caller supplied buffer.
+ *
+ * @param[out] rdr The reader
+ * @param[in] buf Input text, modified in place. buf[size] must be '\0'.
+ * @param[in] size Number of characters of input
+ * @param[in] delim Characters that separate tokens, in addition to the
+ *            newline. NULL selects TOK_RDR_DFLT_DELIM.
+ * @param[in] comment Prefix of tokens that start a comment which extends
+ *            to the end of the line, or NULL
+ * @retval 0 on success, -1 with errno set on failure
+ */
+int tok_rdr_init(struct tok_rdr *rdr, char *buf, size_t size,
+		const char *delim, const char *comment)
+{
+	if ((NULL == rdr) || (NULL == buf) || buf[size]) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	memset(rdr, 0, sizeof(*rdr));
+	rdr->buf = buf;
+	rdr->size = size;
+	rdr->pos = buf;
+	rdr->end = buf + size;
+	rdr->line_start = buf;
+	rdr->eol = true;
+
+	if (NULL == delim) {
+		delim = TOK_RDR_DFLT_DELIM;
+	}
+	for (; *delim; delim++) {
+		rdr->cls[(unsigned char)*delim] = TOK_CLS_DELIM;
+	}
+	rdr->cls['\n'] = TOK_CLS_NL;
+	rdr->cls[0] = TOK_CLS_NUL;
+
+	if ((NULL != comment) && *comment) {
+		rdr->comment = comment;
+		rdr->comment_len = strlen(comment);
+	}
+	return 0;
+}
+
+/* Read all of fd, size_hint avoids reallocation for regular files */
+static char *read_fd(int fd, size_t size_hint, size_t *size)
+{
+	/* Room for the NUL, and for the read that detects end of file */
+	size_t cap = size_hint + 2;
+	size_t len = 0;
+	ssize_t bytes;
+	char *buf;
+	char *tmp;
+
+	if (cap < TOK_RDR_READ_CHUNK) {
+		cap = TOK_RDR_READ_CHUNK;
+	}
+	buf = (char *)malloc(cap);
+	if (NULL == buf) {
+		return NULL;
+	}
+
+	do {
+		if (len + 1 >= cap) {
+			cap *= 2;
+			tmp = (char *)realloc(buf, cap);
+			if (NULL == tmp) {
+				free(buf);
+				return NULL;
+			}
+			buf = tmp;
+		}
+		bytes = read(fd, buf + len, cap - len - 1);
+		if (bytes < 0) {
+			if (EINTR == errno) {
+				continue;
+			}
+			free(buf);
+			return NULL;
+		}
+		len += bytes;
+	} while (bytes);
+
+	buf[len] = '\0';
+	*size = len;
+	return buf;
+}
+
+/**
+ * @brief Open a file for reading tokens.
+ *
+ * The file is read into a single buffer with one read() for regular
+ * files.  A private mapping was measured to be slower, as terminating
+ * the tokens in place copies every page on write.
+ *
+ * @param[out] rdr The reader, release with tok_rdr_close()
+ * @param[in] filename File to read
+ * @param[in] delim Token separators, see tok_rdr_init()
+ * @param[in] comment Comment prefix, see tok_rdr_init()
+ * @retval 0 on success, -1 with errno set on failure
+ */
+int tok_rdr_open(struct tok_rdr *rdr, const char *filename,
+		const char *delim, const char *comment)
+{
+	struct stat st;
+	char *buf;
+	size_t size = 0;
+	int fd;
+
+	if ((NULL == rdr) || (NULL == filename)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		return -1;
+	}
+	if (fstat(fd, &st) < 0) {
+		goto fail;
+	}
+
+	buf = read_fd(fd, S_ISREG(st.st_mode) ? (size_t)st.st_size : 0,
+			&size);
+	if (NULL == buf) {
+		goto fail;
+	}
+	close(fd);
+
+	tok_rdr_init(rdr, buf, size, delim, comment);
+	rdr->owned = true;
+	return 0;
+
+fail:
+	close(fd);
+	return -1;
+}
+
+void tok_rdr_close(struct tok_rdr *rdr)
+{
+	if ((NULL == rdr) || !rdr->owned) {
+		return;
+	}
+	free(rdr->buf);
+	rdr->buf = rdr->pos = rdr->end = rdr->line_start = NULL;
+	rdr->owned = false;
+}
+
+/**
+ * @brief Return the next token, crossing line boundaries and skipping
+ *        comments.
+ *
+ * @retval 0 tok is valid, 1 at end of input
+ */
+int tok_rdr_next(struct tok_rdr *rdr, struct tok_view *tok)
+{
+	for (;;) {
+		if (rdr->eol) {
+			if (rdr->pos >= rdr->end) {
+				return 1;
+			}
+			new_line(rdr);
+		}
+		if (skip_delim(rdr) && !take_tok(rdr, tok)) {
+			return 0;
+		}
+	}
+}
+
+/**
+ * @brief Return the next token on the current line.
+ *
+ * @retval 0 tok is valid, 1 at end of line or input
+ */
+int tok_rdr_next_in_line(struct tok_rdr *rdr, struct tok_view *tok)
+{
+	if (rdr->eol || !skip_delim(rdr) || take_tok(rdr, tok)) {
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Discard the rest of the current line and start the next one.
+ *
+ * @retval 0 a new line has started, 1 at end of input
+ */
+int tok_rdr_next_line(struct tok_rdr *rdr)
+{
+	skip_line(rdr);
+	if (rdr->pos >= rdr->end) {
+		return 1;
+	}
+	new_line(rdr);
+	return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,324 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2016, Integrated Device Technology Inc.
+ Copyright (c) 2016, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ l of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this l of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <stdarg.h>
+#include <setjmp.h>
+#include "cmocka.h"
+
+#include "tok_reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEST_FILE "/tmp/tok_reader_test.cfg"
+#define BENCH_LINES 100000
+
+static void check_tok(struct tok_view *tok, const char *str, uint32_t line,
+		uint32_t col)
+{
+	assert_string_equal(str, tok->str);
+	assert_int_equal(strlen(str), tok->len);
+	assert_int_equal(line, tok->line);
+	assert_int_equal(col, tok->col);
+}
+
+static void tok_rdr_init_test(void **state)
+{
+	struct tok_rdr rdr;
+	char buf[] = "abc";
+
+	errno = 0;
+	assert_int_equal(-1, tok_rdr_init(NULL, buf, 3, NULL, NULL));
+	assert_int_equal(EINVAL, errno);
+
+	// buf[size] must be '\0'
+	errno = 0;
+	assert_int_equal(-1, tok_rdr_init(&rdr, buf, 2, NULL, NULL));
+	assert_int_equal(EINVAL, errno);
+
+	errno = 0;
+	assert_int_equal(-1, tok_rdr_open(&rdr, "/tmp/no/such/file", NULL,
+			NULL));
+	assert_int_equal(ENOENT, errno);
+
+	(void)state; // unused
+}
+
+static void tok_rdr_next_test(void **state)
+{
+	struct tok_rdr rdr;
+	struct tok_view tok;
+	char buf[] = "SWITCH sw1  0x10\r\n\n\t  PORT 2 // a comment\n"
+			"// whole line\nEOF";
+
+	assert_int_equal(0, tok_rdr_init(&rdr, buf, strlen(buf), NULL, "//"));
+	assert_int_equal(0, tok_rdr_next(&rdr, &tok));
+	check_tok(&tok, "SWITCH", 1, 1);
+	assert_int_equal(0, tok_rdr_next(&rdr, &tok));
+	check_tok(&tok, "sw1", 1, 8);
+	assert_int_equal(0, tok_rdr_next(&rdr, &tok));
+	check_tok(&tok, "0x10", 1, 13);
+	assert_int_equal(0, tok_rdr_next(&rdr, &tok));
+	check_tok(&tok, "PORT", 3, 4);
+	assert_int_equal(0, tok_rdr_next(&rdr, &tok));
+	check_tok(&tok, "2", 3, 9);
+	assert_int_equal(0, tok_rdr_next(&rdr, &tok));
+	check_tok(&tok, "EOF", 5, 1);
+	assert_int_equal(1, tok_rdr_next(&rdr, &tok));
+	assert_int_equal(1, tok_rdr_next(&rdr, &tok));
+
+	// Last token is available for error messages
+	assert_int_equal(5, rdr.last.line);
+	assert_string_equal("EOF", rdr.last.str);
+
+	(void)state; // unused
+}
+
+static void tok_rdr_line_test(void **state)
+{
+	struct tok_rdr rdr;
+	struct tok_view tok;
+	char buf[] = "A 1 2\nB\n\nC 3,4\n";
+
+	assert_int_equal(0, tok_rdr_init(&rdr, buf, strlen(buf), " ,", NULL));
+
+	// No line has been started yet
+	assert_int_equal(1, tok_rdr_next_in_line(&rdr, &tok));
+
+	assert_int_equal(0, tok_rdr_next_line(&rdr));
+	assert_int_equal(0, tok_rdr_next_in_line(&rdr, &tok));
+	check_tok(&tok, "A", 1, 1);
+	assert_int_equal(0, tok_rdr_next_in_line(&rdr, &tok));
+	check_tok(&tok, "1", 1, 3);
+
+	// Rest of the line is discarded
+	assert_int_equal(0, tok_rdr_next_line(&rdr));
+	assert_int_equal(0, tok_rdr_next_in_line(&rdr, &tok));
+	check_tok(&tok, "B", 2, 1);
+	assert_int_equal(1, tok_rdr_next_in_line(&rdr, &tok));
+	assert_int_equal(1, tok_rdr_next_in_line(&rdr, &tok));
+
+	assert_int_equal(0, tok_rdr_next_line(&rdr));
+	assert_int_equal(1, tok_rdr_next_in_line(&rdr, &tok));
+
+	assert_int_equal(0, tok_rdr_next_line(&rdr));
+	assert_int_equal(0, tok_rdr_next_in_line(&rdr, &tok));
+	check_tok(&tok, "C", 4, 1);
+	assert_int_equal(0, tok_rdr_next_in_line(&rdr, &tok));
+	check_tok(&tok, "3", 4, 3);
+	assert_int_equal(0, tok_rdr_next_in_line(&rdr, &tok));
+	check_tok(&tok, "4", 4, 5);
+	assert_int_equal(1, tok_rdr_next_in_line(&rdr, &tok));
+
+	assert_int_equal(1, tok_rdr_next_line(&rdr));
+
+	(void)state; // unused
+}
+
+static void tok_rdr_empty_test(void **state)
+{
+	struct tok_rdr rdr;
+	struct tok_view tok;
+	char empty[] = "";
+	char blank[] = " \n\t\n";
+
+	assert_int_equal(0, tok_rdr_init(&rdr, empty, 0, NULL, NULL));
+	assert_int_equal(1, tok_rdr_next(&rdr, &tok));
+	assert_int_equal(1, tok_rdr_next_line(&rdr));
+
+	assert_int_equal(0, tok_rdr_init(&rdr, blank, strlen(blank), NULL,
+			NULL));
+	assert_int_equal(1, tok_rdr_next(&rdr, &tok));
+
+	(void)state; // unused
+}
+
+static void write_file(const char *fn, const char *text, size_t len)
+{
+	FILE *f = fopen(fn, "w");
+
+	assert_non_null(f);
+	assert_int_equal(len, fwrite(text, 1, len, f));
+	assert_int_equal(0, fclose(f));
+}
+
+static void tok_rdr_open_test(void **state)
+{
+	struct tok_rdr rdr;
+	struct tok_view tok;
+	long page = sysconf(_SC_PAGESIZE);
+	char *text;
+	uint32_t cnt;
+	long i;
+
+	write_file(TEST_FILE, "X Y\nZ", 5);
+	assert_int_equal(0, tok_rdr_open(&rdr, TEST_FILE, NULL, NULL));
+	assert_int_equal(0, tok_rdr_next(&rdr, &tok));
+	check_tok(&tok, "X", 1, 1);
+	assert_int_equal(0, tok_rdr_next(&rdr, &tok));
+	check_tok(&tok, "Y", 1, 3);
+	assert_int_equal(0, tok_rdr_next(&rdr, &tok));
+	check_tok(&tok, "Z", 2, 1);
+	assert_int_equal(1, tok_rdr_next(&rdr, &tok));
+	tok_rdr_close(&rdr);
+
+	// Input ending exactly on a page boundary
+	text = (char *)malloc(page);
+	assert_non_null(text);
+	for (i = 0; i < page; i += 2) {
+		text[i] = 'a';
+		text[i + 1] = '\n';
+	}
+	text[page - 2] = 'z';
+	write_file(TEST_FILE, text, page);
+	free(text);
+
+	assert_int_equal(0, tok_rdr_open(&rdr, TEST_FILE, NULL, NULL));
+	assert_int_equal(page, rdr.size);
+	for (cnt = 0; !tok_rdr_next(&rdr, &tok); cnt++) {
+		assert_int_equal(1, tok.len);
+		assert_int_equal(cnt + 1, tok.line);
+	}
+	assert_int_equal(page / 2, cnt);
+	assert_string_equal("z", rdr.last.str);
+	tok_rdr_close(&rdr);
+
+	unlink(TEST_FILE);
+	(void)state; // unused
+}
+
+static double elapsed(struct timespec *st, struct timespec *end)
+{
+	return (end->tv_sec - st->tv_sec)
+			+ (end->tv_nsec - st->tv_nsec) / 1000000000.0;
+}
+
+// Compare against the getline() and strtok_r() loop previously used by libcfg
+static void tok_rdr_bench_test(void **state)
+{
+	struct tok_rdr rdr;
+	struct tok_view tok;
+	struct timespec st, end;
+	size_t line_sz = 256;
+	char *line;
+	char *save_ptr;
+	char *t;
+	uint64_t old_cnt = 0, new_cnt = 0;
+	double old_t, new_t;
+	FILE *f;
+	int i;
+
+	f = fopen(TEST_FILE, "w");
+	assert_non_null(f);
+	for (i = 0; i < BENCH_LINES; i++) {
+		switch (i % 4) {
+		case 0:
+			fprintf(f, "SWITCH CPS1848 sw_%d 0x%x 0x%x\n", i,
+					i & 0xFFFF, 0x10000 + i);
+			break;
+		case 1:
+			fprintf(f, "\tDFLTPORT %d // default route\n", i % 18);
+			break;
+		case 2:
+			fprintf(f, "\tROUTE dev08 0x%02x %d\n", i & 0xFF,
+					i % 18);
+			break;
+		default:
+			fprintf(f, "CONNECT sw_%d %d ep_%d 0\n", i - 3, i % 18,
+					i);
+		}
+	}
+	assert_int_equal(0, fclose(f));
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	f = fopen(TEST_FILE, "r");
+	assert_non_null(f);
+	line = (char *)malloc(line_sz);
+	while (getline(&line, &line_sz, f) > 0) {
+		t = strtok_r(line, " \t\r\n", &save_ptr);
+		while ((NULL != t) && strncmp(t, "//", 2)) {
+			old_cnt++;
+			t = strtok_r(NULL, " \t\r\n", &save_ptr);
+		}
+	}
+	free(line);
+	fclose(f);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	old_t = elapsed(&st, &end);
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	assert_int_equal(0, tok_rdr_open(&rdr, TEST_FILE, NULL, "//"));
+	while (!tok_rdr_next(&rdr, &tok)) {
+		new_cnt++;
+	}
+	tok_rdr_close(&rdr);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	new_t = elapsed(&st, &end);
+
+	assert_int_equal(old_cnt, new_cnt);
+	printf("%d lines, %lu tokens: getline/strtok_r %.2f ms, "
+			"tok_rdr %.2f ms\n", BENCH_LINES,
+			(unsigned long)new_cnt, old_t * 1000, new_t * 1000);
+
+	unlink(TEST_FILE);
+	(void)state; // unused
+}
+
+int main(int argc, char *argv[])
+{
+	(void)argv; // not used
+	argc++; // not used
+
+	const struct CMUnitTest tests[] = {
+	cmocka_unit_test(tok_rdr_init_test),
+	cmocka_unit_test(tok_rdr_next_test),
+	cmocka_unit_test(tok_rdr_line_test),
+	cmocka_unit_test(tok_rdr_empty_test),
+	cmocka_unit_test(tok_rdr_open_test),
+	cmocka_unit_test(tok_rdr_bench_test), };
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -50,6 +50,7 @@
 
 #include "circ_buf.h"
 #include "liblog.h"
+#include "liblog_bin.h"
 
 using std::string;
 
@@ -64,7 +65,7 @@ extern unsigned RDMA_LL;
 unsigned g_level = RDMA_LL; /* Default log level from build */
 unsigned g_disp_level = RDMA_LL_CRIT; /* Default log level from build */
 
-static circ_buf<string, NUM_LOG_LINES> log_buf;
+static circ_buf_rec<NUM_LOG_LINES, LOG_LINE_SIZE> log_buf;
 static unsigned circ_buf_en = 0;
 static sem_t log_buf_sem;
 
@@ -72,7 +73,7 @@ static FILE* log_file = NULL;
 
 int rdma_log_init(const char *log_filename, unsigned circ_buf_en)
 {
-	/* Semaphore for protecting access to log_buf */
+	/* Semaphore for protecting access to log_file and stdout */
 	if (sem_init(&log_buf_sem, 0, 1) == -1) {
 		perror("rdma_log_init: sem_init()");
 		return -1;
@@ -113,6 +114,7 @@ int rdma_log_init(const char *log_filename, unsigned circ_buf_en)
 
 void rdma_log_close()
 {
+	rdma_log_bin_close();
 	if (log_file) {
 		fclose(log_file);
 		log_file = NULL;
@@ -121,8 +123,28 @@ void rdma_log_close()
 	}
 } /* rdma_log_close() */
 
+static void rdma_log_dump_line(const char *line, void *arg)
+{
+	size_t len = strlen(line);
+
+	(void)arg;
+	std::cout << line;
+	if (!len || ('\n' != line[len - 1])) {
+		std::cout << std::endl;
+	}
+} /* rdma_log_dump_line() */
+
 void rdma_log_dump()
 {
+	struct rdma_log_bin_map map;
+
+	/* In binary mode the in-memory log is the binary record ring */
+	if (rdma_log_bin_active() && !rdma_log_bin_open_live(&map)) {
+		rdma_log_bin_walk(&map, NUM_LOG_LINES, rdma_log_dump_line,
+				NULL);
+		rdma_log_bin_unmap(&map);
+		return;
+	}
 	log_buf.dump();
 } /* rdma_log_dump() */
 
@@ -133,12 +155,24 @@ int rdma_log(unsigned level, const char *level_str, const char *file,
 	va_list args;
 	int n;
 	int p;
+	size_t len;
 	time_t cur_time;
 	struct timeval tv;
 	char asc_time[26] = {0};
 
 	char *oneline_fmt = (char *)"%4s %s.%06ldus tid=%ld %s:%4d %s(): ";
 
+	/* Binary mode, only format the line if it must be displayed */
+	if (rdma_log_bin_active()) {
+		va_start(args, format);
+		n = rdma_log_bin_va(level, level_str, file, line_num, func,
+				format, args);
+		va_end(args);
+		if (level > g_disp_level) {
+			return n;
+		}
+	}
+
 	/* Prefix with level_str, timestamp, filename, line no., and func */
 	time(&cur_time);
 	ctime_r(&cur_time, asc_time);
@@ -154,21 +188,28 @@ int rdma_log(unsigned level, const char *level_str, const char *file,
 	p = vsnprintf(buffer + n, sizeof(buffer) - n, format, args);
 	va_end(args);
 
-	/* Push log line into circular log buffer and log file */
-	string log_line(buffer);
-	sem_wait(&log_buf_sem);
-	if (circ_buf_en) {
-		log_buf.push_back(log_line);
+	/* Length of the (possibly truncated) log line */
+	len = n + ((p > 0) ? p : 0);
+	if (len >= sizeof(buffer)) {
+		len = sizeof(buffer) - 1;
 	}
-	if (log_file) {
-		fputs(log_line.c_str(), log_file);
+
+	/* Push log line into circular log buffer, no locking required */
+	if (circ_buf_en && !rdma_log_bin_active()) {
+		log_buf.push_back(buffer, len);
+	}
+
+	/* Write log line to log file and display */
+	sem_wait(&log_buf_sem);
+	if (log_file && !rdma_log_bin_active()) {
+		fputs(buffer, log_file);
 		fflush(log_file);
 	}
 	if (level <= g_disp_level) {
 		fflush(stderr);
 		fflush(stdout);
-		fprintf(stdout, "%s", log_line.c_str());
-		if ('\n' != buffer[n + p - 1]) {
+		fprintf(stdout, "%s", buffer);
+		if (!len || ('\n' != buffer[len - 1])) {
 			fprintf(stdout, "\n");
 		}
 		fflush(stdout);
@@ -0,0 +1,1051 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2016, Integrated Device Technology Inc.
+ Copyright (c) 2016, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+/* System includes */
+#include <sys/time.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <stddef.h>
+
+/* C++ standard library */
+#include <string>
+#include <unordered_map>
+
+#include <cstdio>
+#include <cstring>
+#include <cstdarg>
+
+#include "rrmap_config.h"
+#include "liblog_bin.h"
+
+using std::string;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of format/file/function strings tracked by this process */
+#define BIN_STR_KEYS 16384
+
+static struct rdma_log_bin_hdr *bin_hdr = NULL;
+static size_t bin_size = 0;
+static unsigned bin_writers = 0; /* Threads in rdma_log_bin_va() */
+static sem_t bin_str_sem;
+static uint64_t bin_str_keys[BIN_STR_KEYS];
+static unsigned bin_str_key_cnt = 0;
+static __thread long bin_tid = 0;
+
+static_assert(sizeof(struct rdma_log_bin_rec) == RDMA_LOG_BIN_REC_SIZE,
+		"Binary log record size mismatch");
+
+/* Kinds of argument a printf conversion specification consumes */
+enum bin_arg_kind {
+	BA_NONE, /* Invalid or unsupported specification */
+	BA_PCT, /* %% */
+	BA_INT,
+	BA_LONG,
+	BA_LLONG,
+	BA_INTMAX,
+	BA_SIZE,
+	BA_PTRDIFF,
+	BA_DBL,
+	BA_LDBL,
+	BA_STR,
+	BA_PTR,
+	BA_COUNT /* %n, consumes a pointer, produces no output */
+};
+
+struct bin_spec {
+	const char *start; /* Points to the '%' */
+	const char *end; /* Points to the character after the conversion */
+	bool width_star;
+	bool prec_star;
+	enum bin_arg_kind kind;
+};
+
+/**
+ * @brief Parse one printf conversion specification
+ *
+ * @param[in] p Points to the '%' starting the specification
+ * @param[out] s Parsed specification
+ * @return Pointer to the first character following the specification
+ */
+static const char *bin_parse_spec(const char *p, struct bin_spec *s)
+{
+	enum { LEN_NONE, LEN_HH, LEN_H, LEN_L, LEN_LL, LEN_BIG_L, LEN_J,
+		LEN_Z, LEN_T } len = LEN_NONE;
+
+	s->start = p++;
+	s->width_star = false;
+	s->prec_star = false;
+	s->kind = BA_NONE;
+
+	if ('%' == *p) {
+		s->kind = BA_PCT;
+		s->end = p + 1;
+		return s->end;
+	}
+
+	while (*p && strchr("-+ #0'", *p)) {
+		p++;
+	}
+	if ('*' == *p) {
+		s->width_star = true;
+		p++;
+	} else {
+		while ((*p >= '0') && (*p <= '9')) {
+			p++;
+		}
+	}
+	if ('.' == *p) {
+		p++;
+		if ('*' == *p) {
+			s->prec_star = true;
+			p++;
+		} else {
+			while ((*p >= '0') && (*p <= '9')) {
+				p++;
+			}
+		}
+	}
+
+	switch (*p) {
+	case 'h':
+		len = ('h' == *(p + 1)) ? LEN_HH : LEN_H;
+		p += (LEN_HH == len) ? 2 : 1;
+		break;
+	case 'l':
+		len = ('l' == *(p + 1)) ? LEN_LL : LEN_L;
+		p += (LEN_LL == len) ? 2 : 1;
+		break;
+	case 'q':
+		len = LEN_LL;
+		p++;
+		break;
+	case 'L':
+		len = LEN_BIG_L;
+		p++;
+		break;
+	case 'j':
+		len = LEN_J;
+		p++;
+		break;
+	case 'z':
+	case 'Z':
+		len = LEN_Z;
+		p++;
+		break;
+	case 't':
+		len = LEN_T;
+		p++;
+		break;
+	default:
+		break;
+	}
+
+	switch (*p) {
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'o':
+	case 'x':
+	case 'X':
+		switch (len) {
+		case LEN_L:
+			s->kind = BA_LONG;
+			break;
+		case LEN_LL:
+		case LEN_BIG_L:
+			s->kind = BA_LLONG;
+			break;
+		case LEN_J:
+			s->kind = BA_INTMAX;
+			break;
+		case LEN_Z:
+			s->kind = BA_SIZE;
+			break;
+		case LEN_T:
+			s->kind = BA_PTRDIFF;
+			break;
+		default:
+			s->kind = BA_INT;
+			break;
+		}
+		break;
+	case 'c':
+		s->kind = BA_INT;
+		break;
+	case 'e':
+	case 'E':
+	case 'f':
+	case 'F':
+	case 'g':
+	case 'G':
+	case 'a':
+	case 'A':
+		s->kind = (LEN_BIG_L == len) ? BA_LDBL : BA_DBL;
+		break;
+	case 's':
+		/* Wide strings are not supported */
+		s->kind = (LEN_L == len) ? BA_NONE : BA_STR;
+		break;
+	case 'p':
+		s->kind = BA_PTR;
+		break;
+	case 'n':
+		s->kind = BA_COUNT;
+		break;
+	default:
+		s->kind = BA_NONE;
+		s->end = p;
+		return p;
+	}
+
+	s->end = p + 1;
+	return s->end;
+} /* bin_parse_spec() */
+
+static inline bool bin_put(struct rdma_log_bin_rec *rec, const void *val,
+		size_t len)
+{
+	if ((rec->arg_len + len) > RDMA_LOG_BIN_ARG_SPACE) {
+		rec->arg_len |= RDMA_LOG_BIN_ARGS_TRUNC;
+		return false;
+	}
+	memcpy(&rec->args[rec->arg_len], val, len);
+	rec->arg_len += len;
+	return true;
+} /* bin_put() */
+
+static inline bool bin_put_int(struct rdma_log_bin_rec *rec, int64_t val)
+{
+	return bin_put(rec, &val, sizeof(val));
+}
+
+static inline bool bin_put_str(struct rdma_log_bin_rec *rec, const char *str)
+{
+	size_t avail;
+	uint16_t len;
+
+	if (NULL == str) {
+		str = "(null)";
+	}
+
+	avail = RDMA_LOG_BIN_ARG_SPACE - rec->arg_len;
+	if (avail <= sizeof(len)) {
+		rec->arg_len |= RDMA_LOG_BIN_ARGS_TRUNC;
+		return false;
+	}
+	avail -= sizeof(len);
+
+	len = (uint16_t)strnlen(str, avail + 1);
+	if (len > avail) {
+		len = avail;
+		memcpy(&rec->args[rec->arg_len], &len, sizeof(len));
+		memcpy(&rec->args[rec->arg_len + sizeof(len)], str, len);
+		rec->arg_len += sizeof(len) + len;
+		rec->arg_len |= RDMA_LOG_BIN_ARGS_TRUNC;
+		return false;
+	}
+	memcpy(&rec->args[rec->arg_len], &len, sizeof(len));
+	memcpy(&rec->args[rec->arg_len + sizeof(len)], str, len);
+	rec->arg_len += sizeof(len) + len;
+	return true;
+} /* bin_put_str() */
+
+/**
+ * @brief Capture the arguments consumed by format into the record.
+ */
+static void bin_capture_args(struct rdma_log_bin_rec *rec, const char *format,
+		va_list args)
+{
+	struct bin_spec s;
+	const char *p = format;
+	bool ok = true;
+
+	while (ok && (NULL != (p = strchr(p, '%')))) {
+		p = bin_parse_spec(p, &s);
+
+		if (BA_NONE == s.kind) {
+			break;
+		}
+		if (BA_PCT == s.kind) {
+			continue;
+		}
+		if (s.width_star) {
+			ok = bin_put_int(rec, va_arg(args, int));
+		}
+		if (ok && s.prec_star) {
+			ok = bin_put_int(rec, va_arg(args, int));
+		}
+		if (!ok) {
+			break;
+		}
+
+		switch (s.kind) {
+		case BA_INT:
+			ok = bin_put_int(rec, va_arg(args, int));
+			break;
+		case BA_LONG:
+			ok = bin_put_int(rec, va_arg(args, long));
+			break;
+		case BA_LLONG:
+			ok = bin_put_int(rec, va_arg(args, long long));
+			break;
+		case BA_INTMAX:
+			ok = bin_put_int(rec, va_arg(args, intmax_t));
+			break;
+		case BA_SIZE:
+			ok = bin_put_int(rec, va_arg(args, size_t));
+			break;
+		case BA_PTRDIFF:
+			ok = bin_put_int(rec, va_arg(args, ptrdiff_t));
+			break;
+		case BA_DBL: {
+			double d = va_arg(args, double);
+			ok = bin_put(rec, &d, sizeof(d));
+			break;
+		}
+		case BA_LDBL: {
+			long double ld = va_arg(args, long double);
+			ok = bin_put(rec, &ld, sizeof(ld));
+			break;
+		}
+		case BA_STR:
+			ok = bin_put_str(rec, va_arg(args, const char *));
+			break;
+		case BA_PTR:
+			ok = bin_put_int(rec,
+					(int64_t)(uintptr_t)va_arg(args, void *));
+			break;
+		case BA_COUNT:
+			(void)va_arg(args, void *);
+			break;
+		default:
+			ok = false;
+			break;
+		}
+	}
+} /* bin_capture_args() */
+
+static inline unsigned bin_key_hash(uint64_t key)
+{
+	return (unsigned)(((key >> 3) * 0x9E3779B97F4A7C15ULL) >> 50)
+			% BIN_STR_KEYS;
+}
+
+static bool bin_str_known(uint64_t key)
+{
+	unsigned idx = bin_key_hash(key);
+	unsigned i;
+	uint64_t k;
+
+	for (i = 0; i < BIN_STR_KEYS; i++) {
+		k = __atomic_load_n(&bin_str_keys[idx], __ATOMIC_ACQUIRE);
+		if (k == key) {
+			return true;
+		}
+		if (!k) {
+			return false;
+		}
+		idx = (idx + 1) % BIN_STR_KEYS;
+	}
+	return false;
+} /* bin_str_known() */
+
+/**
+ * @brief Return the string table key for str, adding str to the string
+ *        table of the binary log the first time it is seen.
+ *
+ * If the string table is full the key is still returned, the decoder
+ * displays the key value in place of the missing string.
+ */
+static uint64_t bin_intern(struct rdma_log_bin_hdr *hdr, const char *str)
+{
+	uint64_t key = (uint64_t)(uintptr_t)str;
+	struct rdma_log_bin_str *ent;
+	size_t len;
+	size_t ent_len;
+	unsigned idx;
+
+	if ((NULL == str) || bin_str_known(key)) {
+		return key;
+	}
+
+	sem_wait(&bin_str_sem);
+	if (bin_str_known(key)) {
+		goto exit;
+	}
+	/* Keep the key table at most 3/4 full */
+	if (bin_str_key_cnt >= (BIN_STR_KEYS / 4) * 3) {
+		goto exit;
+	}
+
+	len = strlen(str);
+	ent_len = (offsetof(struct rdma_log_bin_str, str) + len + 1 + 7) & ~7;
+	if ((hdr->str_tab_used + ent_len) > hdr->str_tab_size) {
+		goto exit;
+	}
+
+	ent = (struct rdma_log_bin_str *)((uint8_t *)hdr
+			+ hdr->str_tab_offset + hdr->str_tab_used);
+	ent->key = key;
+	ent->len = len;
+	memcpy(ent->str, str, len + 1);
+	__atomic_store_n(&hdr->str_tab_used,
+			hdr->str_tab_used + ent_len, __ATOMIC_RELEASE);
+
+	idx = bin_key_hash(key);
+	while (bin_str_keys[idx]) {
+		idx = (idx + 1) % BIN_STR_KEYS;
+	}
+	__atomic_store_n(&bin_str_keys[idx], key, __ATOMIC_RELEASE);
+	bin_str_key_cnt++;
+exit:
+	sem_post(&bin_str_sem);
+	return key;
+} /* bin_intern() */
+
+/**
+ * @brief Switch logging to binary mode, writing records to a memory
+ *        mapped file.
+ *
+ * @param[in] log_filename Name of binary log file.  Relative names are
+ *            created in DEFAULT_LOG_DIR.
+ * @param[in] num_recs Number of records in the ring, 0 for the default.
+ * @return 0 for success, negative errno for failure
+ */
+int rdma_log_bin_init(const char *log_filename, unsigned num_recs)
+{
+	struct rdma_log_bin_hdr *hdr;
+	size_t size;
+	int fd;
+
+	if ((NULL == log_filename) || (NULL != bin_hdr)) {
+		return -EINVAL;
+	}
+
+	if (!num_recs) {
+		num_recs = RDMA_LOG_BIN_DFLT_RECS;
+	}
+
+	string filename(log_filename);
+	if ('/' != log_filename[0]) {
+		if ((mkdir(DEFAULT_LOG_DIR, 0755) < 0) && (EEXIST != errno)) {
+			fprintf(stderr, "Failed to create '%s'\n",
+					DEFAULT_LOG_DIR);
+			return -ENOENT;
+		}
+		filename.insert(0, DEFAULT_LOG_DIR);
+	}
+
+	if (sem_init(&bin_str_sem, 0, 1) == -1) {
+		perror("rdma_log_bin_init: sem_init()");
+		return -errno;
+	}
+
+	size = RDMA_LOG_BIN_HDR_SIZE + RDMA_LOG_BIN_STR_TAB_SIZE
+			+ (size_t)num_recs * RDMA_LOG_BIN_REC_SIZE;
+
+	fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+			0644);
+	if (fd < 0) {
+		perror("rdma_log_bin_init: open()");
+		return -ENOENT;
+	}
+	if (ftruncate(fd, size) < 0) {
+		perror("rdma_log_bin_init: ftruncate()");
+		close(fd);
+		return -ENOSPC;
+	}
+
+	hdr = (struct rdma_log_bin_hdr *)mmap(NULL, size,
+			PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (MAP_FAILED == hdr) {
+		perror("rdma_log_bin_init: mmap()");
+		return -ENOMEM;
+	}
+
+	hdr->version = RDMA_LOG_BIN_VERSION;
+	hdr->rec_size = RDMA_LOG_BIN_REC_SIZE;
+	hdr->num_recs = num_recs;
+	hdr->str_tab_offset = RDMA_LOG_BIN_HDR_SIZE;
+	hdr->str_tab_size = RDMA_LOG_BIN_STR_TAB_SIZE;
+	hdr->rec_offset = RDMA_LOG_BIN_HDR_SIZE + RDMA_LOG_BIN_STR_TAB_SIZE;
+	hdr->str_tab_used = 0;
+	hdr->next_seq = 0;
+	__atomic_store_n(&hdr->magic, RDMA_LOG_BIN_MAGIC, __ATOMIC_RELEASE);
+
+	memset(bin_str_keys, 0, sizeof(bin_str_keys));
+	bin_str_key_cnt = 0;
+	bin_size = size;
+	__atomic_store_n(&bin_hdr, hdr, __ATOMIC_RELEASE);
+
+	return 0;
+} /* rdma_log_bin_init() */
+
+void rdma_log_bin_close(void)
+{
+	struct rdma_log_bin_hdr *hdr;
+
+	hdr = __atomic_exchange_n(&bin_hdr, (struct rdma_log_bin_hdr *)NULL,
+			__ATOMIC_SEQ_CST);
+	if (NULL == hdr) {
+		return;
+	}
+
+	/* Threads which found the log active may still be writing to it,
+	 * new writers see that binary logging is off.
+	 */
+	while (__atomic_load_n(&bin_writers, __ATOMIC_SEQ_CST)) {
+		sched_yield();
+	}
+	msync(hdr, bin_size, MS_ASYNC);
+	munmap(hdr, bin_size);
+	sem_destroy(&bin_str_sem);
+} /* rdma_log_bin_close() */
+
+int rdma_log_bin_active(void)
+{
+	return NULL != __atomic_load_n(&bin_hdr, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Write one binary log record.  No formatting is performed, the
+ *        format string address and the raw argument values are saved.
+ *
+ * @return 0 for success, -1 if binary logging is not active
+ */
+int rdma_log_bin_va(unsigned level, const char *level_str, const char *file,
+		int line_num, const char *func, const char *format,
+		va_list args)
+{
+	struct rdma_log_bin_hdr *hdr;
+	struct rdma_log_bin_rec *rec;
+	struct timeval tv;
+	uint64_t seq;
+	va_list ap;
+
+	/* Counted as a writer before looking for the log, so that
+	 * rdma_log_bin_close() waits for this record to be complete.
+	 */
+	__atomic_fetch_add(&bin_writers, 1, __ATOMIC_SEQ_CST);
+	hdr = __atomic_load_n(&bin_hdr, __ATOMIC_SEQ_CST);
+	if (NULL == hdr) {
+		__atomic_fetch_sub(&bin_writers, 1, __ATOMIC_RELEASE);
+		return -1;
+	}
+
+	if (!bin_tid) {
+		bin_tid = syscall(SYS_gettid);
+	}
+	gettimeofday(&tv, NULL);
+
+	seq = __atomic_fetch_add(&hdr->next_seq, 1, __ATOMIC_RELAXED);
+	rec = (struct rdma_log_bin_rec *)((uint8_t *)hdr + hdr->rec_offset
+			+ (seq % hdr->num_recs) * RDMA_LOG_BIN_REC_SIZE);
+
+	/* Mark the record invalid while it is being written */
+	__atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	rec->fmt = bin_intern(hdr, format);
+	rec->file = bin_intern(hdr, file);
+	rec->func = bin_intern(hdr, func);
+	rec->level_str = bin_intern(hdr, level_str);
+	rec->tv_sec = tv.tv_sec;
+	rec->tv_usec = tv.tv_usec;
+	rec->tid = bin_tid;
+	rec->line_num = line_num;
+	rec->level = level;
+	rec->arg_len = 0;
+
+	va_copy(ap, args);
+	bin_capture_args(rec, format, ap);
+	va_end(ap);
+
+	__atomic_store_n(&rec->seq, seq + 1, __ATOMIC_RELEASE);
+	__atomic_fetch_sub(&bin_writers, 1, __ATOMIC_RELEASE);
+	return 0;
+} /* rdma_log_bin_va() */
+
+/* Index from string table key to string, built incrementally */
+struct bin_str_idx {
+	std::unordered_map<uint64_t, const char *> strs;
+	uint64_t scanned;
+};
+
+static void bin_idx_scan(struct rdma_log_bin_map *map)
+{
+	struct bin_str_idx *idx = (struct bin_str_idx *)map->str_idx;
+	const struct rdma_log_bin_hdr *hdr = map->hdr;
+	const uint8_t *tab = (const uint8_t *)hdr + hdr->str_tab_offset;
+	const struct rdma_log_bin_str *ent;
+	uint64_t used;
+	uint64_t ent_len;
+
+	used = __atomic_load_n(&hdr->str_tab_used, __ATOMIC_ACQUIRE);
+	if (used > hdr->str_tab_size) {
+		used = hdr->str_tab_size;
+	}
+
+	while ((idx->scanned + offsetof(struct rdma_log_bin_str, str))
+			< used) {
+		ent = (const struct rdma_log_bin_str *)(tab + idx->scanned);
+		ent_len = (offsetof(struct rdma_log_bin_str, str) + ent->len
+				+ 1 + 7) & ~7;
+		if ((idx->scanned + ent_len) > used) {
+			break;
+		}
+		idx->strs[ent->key] = ent->str;
+		idx->scanned += ent_len;
+	}
+} /* bin_idx_scan() */
+
+static const char *bin_lookup(struct rdma_log_bin_map *map, uint64_t key)
+{
+	struct bin_str_idx *idx = (struct bin_str_idx *)map->str_idx;
+	std::unordered_map<uint64_t, const char *>::iterator it;
+
+	it = idx->strs.find(key);
+	if (idx->strs.end() == it) {
+		/* The string may have been added since the last scan */
+		bin_idx_scan(map);
+		it = idx->strs.find(key);
+		if (idx->strs.end() == it) {
+			return NULL;
+		}
+	}
+	return it->second;
+} /* bin_lookup() */
+
+static int bin_map_setup(struct rdma_log_bin_map *map)
+{
+	const struct rdma_log_bin_hdr *hdr = map->hdr;
+
+	if ((map->size < RDMA_LOG_BIN_HDR_SIZE)
+			|| (RDMA_LOG_BIN_MAGIC != hdr->magic)
+			|| (RDMA_LOG_BIN_VERSION != hdr->version)
+			|| (RDMA_LOG_BIN_REC_SIZE != hdr->rec_size)
+			|| !hdr->num_recs
+			|| ((hdr->str_tab_offset + hdr->str_tab_size)
+					> hdr->rec_offset)
+			|| ((hdr->rec_offset + (uint64_t)hdr->num_recs
+					* RDMA_LOG_BIN_REC_SIZE) > map->size)) {
+		return -EINVAL;
+	}
+
+	map->str_idx = new bin_str_idx();
+	((struct bin_str_idx *)map->str_idx)->scanned = 0;
+	bin_idx_scan(map);
+	return 0;
+} /* bin_map_setup() */
+
+/**
+ * @brief Map a binary log file for decoding.
+ *
+ * @param[in] path Binary log file name
+ * @param[out] map Mapping, release with rdma_log_bin_unmap()
+ * @return 0 for success, negative errno for failure
+ */
+int rdma_log_bin_open(const char *path, struct rdma_log_bin_map *map)
+{
+	struct stat st;
+	void *base;
+	int fd;
+	int rc;
+
+	memset(map, 0, sizeof(*map));
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return -errno;
+	}
+	if (fstat(fd, &st) < 0) {
+		rc = -errno;
+		close(fd);
+		return rc;
+	}
+	if ((size_t)st.st_size < RDMA_LOG_BIN_HDR_SIZE) {
+		close(fd);
+		return -EINVAL;
+	}
+
+	base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (MAP_FAILED == base) {
+		return -ENOMEM;
+	}
+
+	map->hdr = (const struct rdma_log_bin_hdr *)base;
+	map->size = st.st_size;
+	map->owner = 1;
+
+	rc = bin_map_setup(map);
+	if (rc) {
+		munmap(base, st.st_size);
+		memset(map, 0, sizeof(*map));
+	}
+	return rc;
+} /* rdma_log_bin_open() */
+
+/**
+ * @brief Access the binary log of this process for decoding.
+ */
+int rdma_log_bin_open_live(struct rdma_log_bin_map *map)
+{
+	memset(map, 0, sizeof(*map));
+
+	map->hdr = __atomic_load_n(&bin_hdr, __ATOMIC_ACQUIRE);
+	if (NULL == map->hdr) {
+		return -ENOENT;
+	}
+	map->size = bin_size;
+	map->owner = 0;
+	return bin_map_setup(map);
+} /* rdma_log_bin_open_live() */
+
+void rdma_log_bin_unmap(struct rdma_log_bin_map *map)
+{
+	delete (struct bin_str_idx *)map->str_idx;
+	if (map->owner && (NULL != map->hdr)) {
+		munmap((void *)map->hdr, map->size);
+	}
+	memset(map, 0, sizeof(*map));
+} /* rdma_log_bin_unmap() */
+
+/* Append formatted text to buf, tracking the space remaining */
+static void bin_append(char *buf, size_t buf_len, size_t *pos, int n)
+{
+	if (n > 0) {
+		*pos += n;
+	}
+	if (*pos >= buf_len) {
+		*pos = buf_len - 1;
+	}
+	buf[*pos] = '\0';
+}
+
+static inline bool bin_get(const struct rdma_log_bin_rec *rec, size_t *off,
+		void *val, size_t len)
+{
+	if ((*off + len) > RDMA_LOG_BIN_ARGS_LEN(rec->arg_len)) {
+		return false;
+	}
+	memcpy(val, &rec->args[*off], len);
+	*off += len;
+	return true;
+}
+
+/**
+ * @brief Format a binary log record into the rdma_log() one line format.
+ *
+ * @param[in] map Binary log containing the record
+ * @param[in] rec Record to format
+ * @param[out] buf Formatted text
+ * @param[in] buf_len Size of buf
+ * @return Number of characters in buf
+ */
+int rdma_log_bin_format(struct rdma_log_bin_map *map,
+		const struct rdma_log_bin_rec *rec, char *buf, size_t buf_len)
+{
+	const char *oneline_fmt = "%4s %s.%06ldus tid=%ld %s:%4d %s(): ";
+	const char *fmt;
+	const char *file;
+	const char *func;
+	const char *level_str;
+	char asc_time[26] = {0};
+	char spec[64];
+	char str[RDMA_LOG_BIN_ARG_SPACE + 1];
+	struct bin_spec s;
+	time_t cur_time;
+	size_t pos = 0;
+	size_t off = 0;
+	const char *p;
+	const char *q;
+	int64_t star[2];
+	int64_t iv;
+	double dv;
+	long double ldv;
+	uint16_t slen;
+	unsigned n_star;
+	unsigned i;
+	size_t sp;
+
+	if (!buf_len) {
+		return 0;
+	}
+	buf[0] = '\0';
+
+	fmt = bin_lookup(map, rec->fmt);
+	file = bin_lookup(map, rec->file);
+	func = bin_lookup(map, rec->func);
+	level_str = bin_lookup(map, rec->level_str);
+
+	cur_time = rec->tv_sec;
+	ctime_r(&cur_time, asc_time);
+	asc_time[strlen(asc_time) - 1] = '\0';
+	bin_append(buf, buf_len, &pos,
+			snprintf(buf, buf_len, oneline_fmt,
+					level_str ? level_str : "?", asc_time,
+					(long)rec->tv_usec, (long)rec->tid,
+					file ? file : "?", rec->line_num,
+					func ? func : "?"));
+
+	if (NULL == fmt) {
+		bin_append(buf, buf_len, &pos,
+				snprintf(buf + pos, buf_len - pos,
+						"<format 0x%llx unavailable>\n",
+						(unsigned long long)rec->fmt));
+		return pos;
+	}
+
+	p = fmt;
+	while (*p && (pos < (buf_len - 1))) {
+		q = strchr(p, '%');
+		if (NULL == q) {
+			q = p + strlen(p);
+		}
+		/* Copy literal text */
+		if (q > p) {
+			sp = q - p;
+			if (sp > (buf_len - 1 - pos)) {
+				sp = buf_len - 1 - pos;
+			}
+			memcpy(buf + pos, p, sp);
+			pos += sp;
+			buf[pos] = '\0';
+		}
+		if (!*q) {
+			break;
+		}
+
+		p = bin_parse_spec(q, &s);
+		if (BA_PCT == s.kind) {
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, "%%"));
+			continue;
+		}
+		if (BA_NONE == s.kind) {
+			/* Copy the rest of the format unchanged */
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, "%s",
+							q));
+			break;
+		}
+
+		n_star = 0;
+		if (s.width_star && !bin_get(rec, &off, &star[n_star++],
+				sizeof(star[0]))) {
+			goto args_done;
+		}
+		if (s.prec_star && !bin_get(rec, &off, &star[n_star++],
+				sizeof(star[0]))) {
+			goto args_done;
+		}
+
+		/* Rebuild the specification with '*' replaced by values */
+		sp = 0;
+		i = 0;
+		for (q = s.start; (q < s.end) && (sp < (sizeof(spec) - 24));
+				q++) {
+			if (('*' == *q) && (i < n_star)) {
+				sp += snprintf(spec + sp, sizeof(spec) - sp,
+						"%d", (int)star[i++]);
+			} else {
+				spec[sp++] = *q;
+			}
+		}
+		spec[sp] = '\0';
+
+		switch (s.kind) {
+		case BA_INT:
+			if (!bin_get(rec, &off, &iv, sizeof(iv))) {
+				goto args_done;
+			}
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, spec,
+							(int)iv));
+			break;
+		case BA_LONG:
+			if (!bin_get(rec, &off, &iv, sizeof(iv))) {
+				goto args_done;
+			}
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, spec,
+							(long)iv));
+			break;
+		case BA_LLONG:
+			if (!bin_get(rec, &off, &iv, sizeof(iv))) {
+				goto args_done;
+			}
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, spec,
+							(long long)iv));
+			break;
+		case BA_INTMAX:
+			if (!bin_get(rec, &off, &iv, sizeof(iv))) {
+				goto args_done;
+			}
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, spec,
+							(intmax_t)iv));
+			break;
+		case BA_SIZE:
+			if (!bin_get(rec, &off, &iv, sizeof(iv))) {
+				goto args_done;
+			}
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, spec,
+							(size_t)iv));
+			break;
+		case BA_PTRDIFF:
+			if (!bin_get(rec, &off, &iv, sizeof(iv))) {
+				goto args_done;
+			}
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, spec,
+							(ptrdiff_t)iv));
+			break;
+		case BA_DBL:
+			if (!bin_get(rec, &off, &dv, sizeof(dv))) {
+				goto args_done;
+			}
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, spec,
+							dv));
+			break;
+		case BA_LDBL:
+			if (!bin_get(rec, &off, &ldv, sizeof(ldv))) {
+				goto args_done;
+			}
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, spec,
+							ldv));
+			break;
+		case BA_STR:
+			if (!bin_get(rec, &off, &slen, sizeof(slen))
+					|| (slen > RDMA_LOG_BIN_ARG_SPACE)
+					|| !bin_get(rec, &off, str, slen)) {
+				goto args_done;
+			}
+			str[slen] = '\0';
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, spec,
+							str));
+			break;
+		case BA_PTR:
+			if (!bin_get(rec, &off, &iv, sizeof(iv))) {
+				goto args_done;
+			}
+			bin_append(buf, buf_len, &pos,
+					snprintf(buf + pos, buf_len - pos, spec,
+							(void *)(uintptr_t)iv));
+			break;
+		case BA_COUNT:
+		default:
+			break;
+		}
+	}
+	return pos;
+
+args_done:
+	/* Arguments did not fit in the record */
+	bin_append(buf, buf_len, &pos,
+			snprintf(buf + pos, buf_len - pos, "...\n"));
+	return pos;
+} /* rdma_log_bin_format() */
+
+/**
+ * @brief Decode the records in the ring from oldest to newest.
+ *
+ * @param[in] map Binary log
+ * @param[in] max_lines Maximum number of (most recent) records to decode,
+ *            0 for all records in the ring.
+ * @param[in] cb Called with each decoded line
+ * @param[in] arg Passed to cb
+ * @return Number of lines decoded
+ */
+int rdma_log_bin_walk(struct rdma_log_bin_map *map, unsigned max_lines,
+		rdma_log_bin_line_cb cb, void *arg)
+{
+	const struct rdma_log_bin_hdr *hdr = map->hdr;
+	const struct rdma_log_bin_rec *recs;
+	struct rdma_log_bin_rec rec;
+	char line[1024];
+	uint64_t next;
+	uint64_t first;
+	uint64_t seq;
+	uint64_t s1;
+	uint64_t s2;
+	int count = 0;
+
+	recs = (const struct rdma_log_bin_rec *)((const uint8_t *)hdr
+			+ hdr->rec_offset);
+	next = __atomic_load_n(&hdr->next_seq, __ATOMIC_ACQUIRE);
+	first = (next > hdr->num_recs) ? next - hdr->num_recs : 0;
+	if (max_lines && ((next - first) > max_lines)) {
+		first = next - max_lines;
+	}
+
+	for (seq = first; seq < next; seq++) {
+		const struct rdma_log_bin_rec *r = &recs[seq % hdr->num_recs];
+
+		s1 = __atomic_load_n(&r->seq, __ATOMIC_ACQUIRE);
+		memcpy(&rec, r, sizeof(rec));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		s2 = __atomic_load_n(&r->seq, __ATOMIC_RELAXED);
+
+		/* Skip records being written or already overwritten */
+		if ((s1 != (seq + 1)) || (s1 != s2)) {
+			continue;
+		}
+		rdma_log_bin_format(map, &rec, line, sizeof(line));
+		cb(line, arg);
+		count++;
+	}
+	return count;
+} /* rdma_log_bin_walk() */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,461 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2016, Integrated Device Technology Inc.
+ Copyright (c) 2016, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/* circ_buf.h includes iostream, which conflicts with cmocka's fail() */
+#include "circ_buf.h"
+
+#include <setjmp.h>
+#include "cmocka.h"
+
+#include "liblog.h"
+#include "liblog_bin.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEST_MAX_LINES 16
+#define TEST_LINE_SIZE 1024
+
+struct test_lines {
+	int count;
+	char line[TEST_MAX_LINES][TEST_LINE_SIZE];
+};
+
+static char test_fn[64];
+
+static void save_line(const char *line, void *arg)
+{
+	struct test_lines *lines = (struct test_lines *)arg;
+
+	if (lines->count < TEST_MAX_LINES) {
+		snprintf(lines->line[lines->count++], TEST_LINE_SIZE, "%s",
+				line);
+	}
+}
+
+/* Return the message part of a one line log entry */
+static const char *msg_of(const char *line)
+{
+	const char *msg = strstr(line, "(): ");
+
+	assert_non_null(msg);
+	return msg + 4;
+}
+
+static int setup(void **state, unsigned num_recs)
+{
+	snprintf(test_fn, sizeof(test_fn), "/tmp/liblog_test_%d.blog",
+			getpid());
+	assert_int_equal(0, rdma_log_bin_init(test_fn, num_recs));
+	assert_int_equal(1, rdma_log_bin_active());
+	(void)state;
+	return 0;
+}
+
+static int setup_dflt(void **state)
+{
+	return setup(state, 0);
+}
+
+static int setup_small(void **state)
+{
+	return setup(state, 4);
+}
+
+static int teardown(void **state)
+{
+	rdma_log_bin_close();
+	unlink(test_fn);
+	(void)state;
+	return 0;
+}
+
+static void decode_file(struct test_lines *lines, unsigned max_lines)
+{
+	struct rdma_log_bin_map map;
+
+	memset(lines, 0, sizeof(*lines));
+	assert_int_equal(0, rdma_log_bin_open(test_fn, &map));
+	rdma_log_bin_walk(&map, max_lines, save_line, lines);
+	rdma_log_bin_unmap(&map);
+}
+
+static void bin_format_test(void **state)
+{
+	struct test_lines lines;
+	char expect[TEST_LINE_SIZE];
+	const char *str = "a string";
+
+	rdma_log(RDMA_LL_INFO, "INFO", __FILE__, __LINE__, __func__,
+			"int %d uint %u hex 0x%08x\n", -5, 7u, 0xabcd);
+	rdma_log(RDMA_LL_INFO, "INFO", __FILE__, __LINE__, __func__,
+			"long %ld ull %llu size %zu\n", -123456789L,
+			0xFFFFFFFFFFFFFFFFULL, (size_t)42);
+	rdma_log(RDMA_LL_INFO, "INFO", __FILE__, __LINE__, __func__,
+			"str \"%s\" %-10s| %.3s c=%c %%\n", str, "left",
+			"truncated", 'x');
+	rdma_log(RDMA_LL_INFO, "INFO", __FILE__, __LINE__, __func__,
+			"dbl %5.2f %e width %*d prec %.*s\n", 3.14159, 1e10,
+			6, 99, 2, "abc");
+	rdma_log(RDMA_LL_INFO, "INFO", __FILE__, __LINE__, __func__,
+			"no newline %p", (void *)0x1234);
+
+	decode_file(&lines, 0);
+	assert_int_equal(5, lines.count);
+
+	assert_string_equal("int -5 uint 7 hex 0x0000abcd\n",
+			msg_of(lines.line[0]));
+	snprintf(expect, sizeof(expect), "long %ld ull %llu size %zu\n",
+			-123456789L, 0xFFFFFFFFFFFFFFFFULL, (size_t)42);
+	assert_string_equal(expect, msg_of(lines.line[1]));
+	assert_string_equal("str \"a string\" left      | tru c=x %\n",
+			msg_of(lines.line[2]));
+	snprintf(expect, sizeof(expect), "dbl %5.2f %e width %*d prec %.*s\n",
+			3.14159, 1e10, 6, 99, 2, "abc");
+	assert_string_equal(expect, msg_of(lines.line[3]));
+	snprintf(expect, sizeof(expect), "no newline %p", (void *)0x1234);
+	assert_string_equal(expect, msg_of(lines.line[4]));
+
+	/* Prefix matches the text log format */
+	assert_int_equal(0, strncmp("INFO ", lines.line[0], 5));
+	assert_non_null(strstr(lines.line[0], "liblog_test.c:"));
+	assert_non_null(strstr(lines.line[0], "bin_format_test(): "));
+
+	(void)state;
+}
+
+static void bin_truncate_test(void **state)
+{
+	struct test_lines lines;
+	char big[400];
+
+	memset(big, 'z', sizeof(big) - 1);
+	big[sizeof(big) - 1] = '\0';
+
+	rdma_log(RDMA_LL_INFO, "INFO", __FILE__, __LINE__, __func__,
+			"%s %d\n", big, 5);
+
+	decode_file(&lines, 0);
+	assert_int_equal(1, lines.count);
+	assert_int_equal(0, strncmp("zzzz", msg_of(lines.line[0]), 4));
+	assert_non_null(strstr(lines.line[0], "...\n"));
+
+	(void)state;
+}
+
+static void bin_wrap_test(void **state)
+{
+	struct test_lines lines;
+	char expect[32];
+	int i;
+
+	for (i = 0; i < 10; i++) {
+		rdma_log(RDMA_LL_INFO, "INFO", __FILE__, __LINE__, __func__,
+				"line %d\n", i);
+	}
+
+	/* Ring holds the last 4 records */
+	decode_file(&lines, 0);
+	assert_int_equal(4, lines.count);
+	for (i = 0; i < 4; i++) {
+		snprintf(expect, sizeof(expect), "line %d\n", i + 6);
+		assert_string_equal(expect, msg_of(lines.line[i]));
+	}
+
+	/* Limit to the most recent lines */
+	decode_file(&lines, 2);
+	assert_int_equal(2, lines.count);
+	assert_string_equal("line 8\n", msg_of(lines.line[0]));
+	assert_string_equal("line 9\n", msg_of(lines.line[1]));
+
+	(void)state;
+}
+
+static void bin_live_test(void **state)
+{
+	struct rdma_log_bin_map map;
+	struct test_lines lines;
+
+	memset(&lines, 0, sizeof(lines));
+	rdma_log(RDMA_LL_INFO, "INFO", __FILE__, __LINE__, __func__,
+			"live %s\n", "entry");
+
+	assert_int_equal(0, rdma_log_bin_open_live(&map));
+	assert_int_equal(1, rdma_log_bin_walk(&map, NUM_LOG_LINES, save_line,
+			&lines));
+	rdma_log_bin_unmap(&map);
+	assert_string_equal("live entry\n", msg_of(lines.line[0]));
+
+	(void)state;
+}
+
+#define BIN_WRITERS 4
+
+static int bin_write(const char *format, ...)
+{
+	va_list args;
+	int rc;
+
+	va_start(args, format);
+	rc = rdma_log_bin_va(RDMA_LL_INFO, "INFO", __FILE__, __LINE__,
+			__func__, format, args);
+	va_end(args);
+	return rc;
+}
+
+static void *bin_writer(void *arg)
+{
+	int i = 0;
+
+	while (!bin_write("writer %d %d\n", *(int *)arg, i++)) {
+	}
+	return NULL;
+}
+
+static void bin_close_test(void **state)
+{
+	struct test_lines lines;
+	pthread_t thr[BIN_WRITERS];
+	int idx[BIN_WRITERS];
+	int i;
+
+	for (i = 0; i < BIN_WRITERS; i++) {
+		idx[i] = i;
+		assert_int_equal(0, pthread_create(&thr[i], NULL, bin_writer,
+				&idx[i]));
+	}
+
+	/* Close while writers are active, writers stop once it is closed */
+	usleep(10000);
+	rdma_log_bin_close();
+	assert_int_equal(0, rdma_log_bin_active());
+	for (i = 0; i < BIN_WRITERS; i++) {
+		pthread_join(thr[i], NULL);
+	}
+
+	decode_file(&lines, 0);
+	assert_true(lines.count > 0);
+	for (i = 0; i < lines.count; i++) {
+		assert_int_equal(0, strncmp("writer ", msg_of(lines.line[i]),
+				7));
+	}
+
+	(void)state;
+}
+
+static void bin_bad_file_test(void **state)
+{
+	struct rdma_log_bin_map map;
+	char fn[64];
+	FILE *f;
+
+	snprintf(fn, sizeof(fn), "/tmp/liblog_test_bad_%d.blog", getpid());
+	f = fopen(fn, "w");
+	assert_non_null(f);
+	fputs("This is not a binary log\n", f);
+	fclose(f);
+
+	assert_int_not_equal(0, rdma_log_bin_open(fn, &map));
+	assert_int_not_equal(0, rdma_log_bin_open("/nonexistent/file", &map));
+	unlink(fn);
+
+	(void)state;
+}
+
+#define RING_RECS 8
+#define RING_REC_SIZE 32
+
+typedef circ_buf_rec<RING_RECS, RING_REC_SIZE> test_ring_t;
+
+static void ring_save(struct test_lines *lines, test_ring_t *ring)
+{
+	memset(lines, 0, sizeof(*lines));
+	ring->snapshot([lines](const char *rec, size_t len) {
+		assert_int_equal(len, strlen(rec));
+		save_line(rec, lines);
+	});
+}
+
+static void ring_push_test(void **state)
+{
+	test_ring_t ring;
+	struct test_lines lines;
+	char rec[RING_REC_SIZE];
+	int i;
+
+	ring_save(&lines, &ring);
+	assert_int_equal(0, lines.count);
+	assert_int_equal(0, ring.size());
+
+	for (i = 0; i < 3; i++) {
+		snprintf(rec, sizeof(rec), "rec %d\n", i);
+		ring.push_back(rec);
+	}
+	assert_int_equal(3, ring.size());
+
+	/* Snapshots do not remove records */
+	ring_save(&lines, &ring);
+	assert_int_equal(3, lines.count);
+	ring_save(&lines, &ring);
+	assert_int_equal(3, lines.count);
+	assert_string_equal("rec 0\n", lines.line[0]);
+	assert_string_equal("rec 2\n", lines.line[2]);
+
+	ring.clear();
+	ring_save(&lines, &ring);
+	assert_int_equal(0, lines.count);
+
+	(void)state;
+}
+
+static void ring_wrap_test(void **state)
+{
+	test_ring_t ring;
+	struct test_lines lines;
+	char rec[RING_REC_SIZE];
+	int i;
+
+	for (i = 0; i < RING_RECS + 5; i++) {
+		snprintf(rec, sizeof(rec), "rec %d", i);
+		ring.push_back(rec, strlen(rec));
+	}
+	assert_int_equal(RING_RECS, ring.size());
+
+	ring_save(&lines, &ring);
+	assert_int_equal(RING_RECS, lines.count);
+	for (i = 0; i < RING_RECS; i++) {
+		snprintf(rec, sizeof(rec), "rec %d", i + 5);
+		assert_string_equal(rec, lines.line[i]);
+	}
+
+	/* Records longer than the slot are truncated */
+	memset(rec, 'y', sizeof(rec));
+	ring.push_back(rec, sizeof(rec));
+	ring_save(&lines, &ring);
+	assert_int_equal(RING_REC_SIZE - 1, strlen(lines.line[RING_RECS - 1]));
+
+	(void)state;
+}
+
+#define RING_THREADS 4
+#define RING_PUSHES 10000
+
+struct ring_thread_info {
+	test_ring_t *ring;
+	int idx;
+};
+
+static void *ring_producer(void *arg)
+{
+	struct ring_thread_info *info = (struct ring_thread_info *)arg;
+	char rec[RING_REC_SIZE];
+	int i;
+
+	for (i = 0; i < RING_PUSHES; i++) {
+		snprintf(rec, sizeof(rec), "t%d %d", info->idx, i);
+		info->ring->push_back(rec);
+	}
+	return NULL;
+}
+
+static void ring_mpsc_test(void **state)
+{
+	test_ring_t ring;
+	struct ring_thread_info info[RING_THREADS];
+	pthread_t thr[RING_THREADS];
+	unsigned bad = 0;
+	int i;
+
+	for (i = 0; i < RING_THREADS; i++) {
+		info[i].ring = &ring;
+		info[i].idx = i;
+		assert_int_equal(0, pthread_create(&thr[i], NULL,
+				ring_producer, &info[i]));
+	}
+
+	/* Snapshot while producers run, every record must be intact */
+	for (i = 0; i < 1000; i++) {
+		ring.snapshot([&bad](const char *rec, size_t len) {
+			int t, n;
+			(void)len;
+			if ((2 != sscanf(rec, "t%d %d", &t, &n))
+					|| (t < 0) || (t >= RING_THREADS)
+					|| (n < 0) || (n >= RING_PUSHES)) {
+				bad++;
+			}
+		});
+	}
+
+	for (i = 0; i < RING_THREADS; i++) {
+		pthread_join(thr[i], NULL);
+	}
+
+	assert_int_equal(0, bad);
+	assert_int_equal(RING_RECS, ring.size());
+	assert_int_equal(RING_RECS, ring.snapshot([](const char *, size_t) {}));
+
+	(void)state;
+}
+
+int main(int argc, char *argv[])
+{
+	(void)argv; // not used
+	argc++; // not used
+
+	const struct CMUnitTest tests[] = {
+	cmocka_unit_test_setup_teardown(bin_format_test, setup_dflt, teardown),
+	cmocka_unit_test_setup_teardown(bin_truncate_test, setup_dflt,
+			teardown),
+	cmocka_unit_test_setup_teardown(bin_wrap_test, setup_small, teardown),
+	cmocka_unit_test_setup_teardown(bin_live_test, setup_dflt, teardown),
+	cmocka_unit_test_setup_teardown(bin_close_test, setup_small,
+			teardown),
+	cmocka_unit_test(bin_bad_file_test),
+	cmocka_unit_test(ring_push_test),
+	cmocka_unit_test(ring_wrap_test),
+	cmocka_unit_test(ring_mpsc_test), };
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
+
+#ifdef __cplusplus
+}
+#endif
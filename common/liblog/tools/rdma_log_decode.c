@@ -0,0 +1,116 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2016, Integrated Device Technology Inc.
+ Copyright (c) 2016, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+/**
+ * \file rdma_log_decode.c
+ * \brief Converts a binary log written by rdma_log_bin_init() to text.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#include "tok_parse.h"
+#include "liblog_bin.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void usage(char *program)
+{
+	printf("%s - convert a binary log to text\n", program);
+	printf("Usage:\n");
+	printf("  %s [options] <binary log file>\n", program);
+	printf("Options are:\n");
+	printf("  -h\n");
+	printf("    display this message\n");
+	printf("  -n <lines>\n");
+	printf("    only display the last <lines> log lines (default all)\n");
+	printf("\n");
+}
+
+static void print_line(const char *line, void *arg)
+{
+	size_t len = strlen(line);
+
+	fputs(line, (FILE *)arg);
+	if (!len || ('\n' != line[len - 1])) {
+		fputc('\n', (FILE *)arg);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	struct rdma_log_bin_map map;
+	uint32_t max_lines = 0;
+	int rc;
+	int c;
+
+	while (-1 != (c = getopt(argc, argv, "hn:"))) {
+		switch (c) {
+		case 'n':
+			if (tok_parse_ul(optarg, &max_lines, 0)) {
+				printf(TOK_ERR_UL_HEX_MSG_FMT, "Lines");
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (optind >= argc) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	rc = rdma_log_bin_open(argv[optind], &map);
+	if (rc) {
+		fprintf(stderr, "Cannot open binary log \"%s\": %s\n",
+				argv[optind], strerror(-rc));
+		exit(EXIT_FAILURE);
+	}
+
+	rdma_log_bin_walk(&map, max_lines, print_line, stdout);
+	rdma_log_bin_unmap(&map);
+	return EXIT_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
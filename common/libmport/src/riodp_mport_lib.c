@@ -55,6 +55,7 @@
 #include "rio_misc.h"
 #include "string_util.h"
 #include "rapidio_mport_mgmt.h"
+#include "rapidio_mport_sim.h"
 #include "rapidio_mport_dma.h"
 #include "rapidio_mport_sock.h"
 
@@ -83,6 +84,18 @@ struct rapidio_mport_socket {
 	struct rio_channel ch;
 };
 
+/* Simulated management routines, see riomp_mgmt_set_sim_ops */
+static const struct riomp_mgmt_sim_ops *riomp_sim_ops;
+
+#define RIOMP_SIM_NO_OP(op) \
+	((NULL == riomp_sim_ops) || (NULL == riomp_sim_ops->op))
+
+int riomp_mgmt_set_sim_ops(const struct riomp_mgmt_sim_ops *ops)
+{
+	riomp_sim_ops = ops;
+	return 0;
+}
+
 int riomp_mgmt_mport_create_handle(uint32_t mport_id, int flags,
 		riomp_mport_t *mport_handle)
 {
@@ -98,6 +111,11 @@ int riomp_mgmt_mport_create_handle(uint32_t mport_id, int flags,
 
 	const int oflags = flags & 0xFFFF;
 
+	if (NULL != riomp_sim_ops) {
+		fd = RIOMP_MGMT_SIM_FD;
+		goto alloc;
+	}
+
 	snprintf(path, sizeof(path), RIO_MPORT_DEV_PATH "%d", mport_id);
 
 	fd = open(path, O_RDWR | O_CLOEXEC | oflags);
@@ -105,11 +123,14 @@ int riomp_mgmt_mport_create_handle(uint32_t mport_id, int flags,
 		return -errno;
 	}
 
+alloc:
 	hnd = (struct rapidio_mport_handle *)calloc(1,
 			sizeof(struct rapidio_mport_handle));
 	if (!(hnd)) {
 		ret = -errno;
-		close(fd);
+		if (RIOMP_MGMT_SIM_FD != fd) {
+			close(fd);
+		}
 		return ret;
 	}
 
@@ -129,7 +150,9 @@ int riomp_mgmt_mport_destroy_handle(riomp_mport_t *mport_handle)
 		return -EINVAL;
 	}
 
-	close(hnd->fd);
+	if (RIOMP_MGMT_SIM_FD != hnd->fd) {
+		close(hnd->fd);
+	}
 	free(hnd);
 
 	return 0;
@@ -709,6 +732,14 @@ int riomp_mgmt_query(riomp_mport_t mport_handle,
 		return -EINVAL;
 	}
 
+	if (RIOMP_MGMT_SIM_FD == hnd->fd) {
+		if (RIOMP_SIM_NO_OP(query)) {
+			return -ENOSYS;
+		}
+		return riomp_sim_ops->query(riomp_sim_ops->ctx, hnd->mport_id,
+				qresp);
+	}
+
 	memset(&prop, 0, sizeof(prop));
 	if (ioctl(hnd->fd, RIO_MPORT_GET_PROPERTIES, &prop)) {
 		return -errno;
@@ -752,6 +783,14 @@ int riomp_mgmt_lcfg_read(riomp_mport_t mport_handle, uint32_t offset,
 	// on a successfull return
 	*data = 0;
 
+	if (RIOMP_MGMT_SIM_FD == hnd->fd) {
+		if (RIOMP_SIM_NO_OP(lcfg_read)) {
+			return -ENOSYS;
+		}
+		return riomp_sim_ops->lcfg_read(riomp_sim_ops->ctx,
+				hnd->mport_id, offset, size, data);
+	}
+
 	memset(&mt, 0, sizeof(mt));
 	mt.offset = offset;
 	mt.length = size;
@@ -777,6 +816,14 @@ int riomp_mgmt_lcfg_write(riomp_mport_t mport_handle, uint32_t offset,
 		return -EINVAL;
 	}
 
+	if (RIOMP_MGMT_SIM_FD == hnd->fd) {
+		if (RIOMP_SIM_NO_OP(lcfg_write)) {
+			return -ENOSYS;
+		}
+		return riomp_sim_ops->lcfg_write(riomp_sim_ops->ctx,
+				hnd->mport_id, offset, size, data);
+	}
+
 	memset(&mt, 0, sizeof(mt));
 	mt.offset = offset;
 	mt.length = size;
@@ -806,6 +853,14 @@ int riomp_mgmt_rcfg_read(riomp_mport_t mport_handle, did_val_t did_val,
 	// on a successfull return
 	*data = 0;
 
+	if (RIOMP_MGMT_SIM_FD == hnd->fd) {
+		if (RIOMP_SIM_NO_OP(rcfg_read)) {
+			return -ENOSYS;
+		}
+		return riomp_sim_ops->rcfg_read(riomp_sim_ops->ctx,
+				hnd->mport_id, did_val, hc, offset, size, data);
+	}
+
 	mt.rioid = did_val;
 	mt.hopcount = hc;
 	memset(&mt.pad0, 0, sizeof(mt.pad0));
@@ -833,6 +888,14 @@ int riomp_mgmt_rcfg_write(riomp_mport_t mport_handle, did_val_t did_val,
 		return -EINVAL;
 	}
 
+	if (RIOMP_MGMT_SIM_FD == hnd->fd) {
+		if (RIOMP_SIM_NO_OP(rcfg_write)) {
+			return -ENOSYS;
+		}
+		return riomp_sim_ops->rcfg_write(riomp_sim_ops->ctx,
+				hnd->mport_id, did_val, hc, offset, size, data);
+	}
+
 	mt.rioid = did_val;
 	mt.hopcount = hc;
 	memset(&mt.pad0, 0, sizeof(mt.pad0));
@@ -846,6 +909,41 @@ int riomp_mgmt_rcfg_write(riomp_mport_t mport_handle, did_val_t did_val,
 	return 0;
 }
 
+/*
+ * Maintenance write to consecutive target RapidIO device registers
+ */
+int riomp_mgmt_rcfg_write_blk(riomp_mport_t mport_handle, did_val_t did_val,
+		hc_t hc, uint32_t offset, uint32_t size, const uint32_t *data)
+{
+	struct rio_mport_maint_io mt;
+	struct rapidio_mport_handle *hnd = mport_handle;
+
+	if ((NULL == hnd) || (NULL == data) || !size
+			|| (size % sizeof(uint32_t))) {
+		return -EINVAL;
+	}
+
+	if (RIOMP_MGMT_SIM_FD == hnd->fd) {
+		if (RIOMP_SIM_NO_OP(rcfg_write_blk)) {
+			return -ENOSYS;
+		}
+		return riomp_sim_ops->rcfg_write_blk(riomp_sim_ops->ctx,
+				hnd->mport_id, did_val, hc, offset, size, data);
+	}
+
+	mt.rioid = did_val;
+	mt.hopcount = hc;
+	memset(&mt.pad0, 0, sizeof(mt.pad0));
+	mt.offset = offset;
+	mt.length = size;
+	mt.buffer = (uintptr_t)data;
+
+	if (ioctl(hnd->fd, RIO_MPORT_MAINT_WRITE_REMOTE, &mt)) {
+		return -errno;
+	}
+	return 0;
+}
+
 /*
  * Enable (register) receiving range of RapidIO doorbell events
  */
@@ -1090,6 +1188,14 @@ int riomp_mgmt_destid_set(riomp_mport_t mport_handle, did_val_t did_val)
 		return -EINVAL;
 	}
 
+	if (RIOMP_MGMT_SIM_FD == hnd->fd) {
+		if (RIOMP_SIM_NO_OP(destid_set)) {
+			return -ENOSYS;
+		}
+		return riomp_sim_ops->destid_set(riomp_sim_ops->ctx,
+				hnd->mport_id, did_val);
+	}
+
 	if (ioctl(hnd->fd, RIO_MPORT_MAINT_HDID_SET, &did_val)) {
 		return -errno;
 	}
@@ -1109,6 +1215,14 @@ int riomp_mgmt_device_add(riomp_mport_t mport_handle, did_val_t did_val,
 		return -EINVAL;
 	}
 
+	if (RIOMP_MGMT_SIM_FD == hnd->fd) {
+		if (RIOMP_SIM_NO_OP(device_add)) {
+			return -ENOSYS;
+		}
+		return riomp_sim_ops->device_add(riomp_sim_ops->ctx,
+				hnd->mport_id, did_val, hc, ct, name);
+	}
+
 	memset(&dev, 0, sizeof(dev));
 	dev.destid = did_val;
 	dev.hopcount = hc;
@@ -1138,6 +1252,14 @@ int riomp_mgmt_device_del(riomp_mport_t mport_handle, did_val_t did_val,
 		return -EINVAL;
 	}
 
+	if (RIOMP_MGMT_SIM_FD == hnd->fd) {
+		if (RIOMP_SIM_NO_OP(device_del)) {
+			return -ENOSYS;
+		}
+		return riomp_sim_ops->device_del(riomp_sim_ops->ctx,
+				hnd->mport_id, did_val, hc, ct, name);
+	}
+
 	memset(&dev, 0, sizeof(dev));
 	dev.destid = did_val;
 	dev.hopcount = hc;
@@ -42,6 +42,7 @@
 #include <fcntl.h>
 
 #include "tok_parse.h"
+#include "tok_reader.h"
 #include "rrmap_config.h"
 #include "rapidio_mport_dma.h"
 #include "libcli.h"
@@ -50,90 +51,54 @@
 extern "C" {
 #endif
 
-int read_a_line(int fd, char *buff, int max)
-{
-	int pos = 0;
-	int bytes = 0;
-
-	memset((void *)buff, 0, max);
-
-	bytes = read(fd, (void *)buff, 1);
-	while ((1 == bytes) && (pos < (max - 2)) && (buff[pos] != '\n')) {
-		pos++;
-		bytes = read(fd, (void *)&buff[pos], 1);
-	}
-
-	if (!pos) {
-		return 0;
-	}
-	return pos + 1;
-}
-
-const char *delim = " \r\n";
+static const char *delim = " \r";
 
 int get_phys_mem(const char *filename, char *parm_name, uint64_t *sa,
 		uint64_t *sz)
 {
-	int fd;
-	char buff[MEM_CFG_MAX_LINE_LEN + 1];
-	int buff_bytes;
+	struct tok_rdr rdr;
+	struct tok_view tok;
 	bool done = false;
-	char *saveptr;
 
 	*sa = RIO_ANY_ADDR;
 	*sz = 0;
 	errno = 0;
 
-	fd = open(filename, O_RDONLY);
-	if (fd < 0) {
+	if (tok_rdr_open(&rdr, filename, delim, NULL)) {
 		return -1;
 	}
 
-	while (!done) {
-		char *token;
-
-		// Read until line termination character
-		buff_bytes = read_a_line(fd, &buff[0], MEM_CFG_MAX_LINE_LEN);
-
-		// No bytes returned means end of file.
-		if (buff_bytes <= 0) {
-			break;
-		}
-
-		if ((MEM_CFG_MAX_LINE_LEN - 1 == buff_bytes)
-				&& (buff[MEM_CFG_MAX_LINE_LEN - 1] != '\n')) {
-			errno = EFBIG;
-			goto fail;
-		}
+	while (!done && !tok_rdr_next_line(&rdr)) {
+		bool found = false;
 
 		/* Find parm_name on the line */
-		token = strtok_r(buff, delim, &saveptr);
-		while ((NULL != token) && parm_idx(token, parm_name)) {
-			token = strtok_r(NULL, delim, &saveptr);
+		while (!tok_rdr_next_in_line(&rdr, &tok)) {
+			if (!parm_idx(tok.str, parm_name)) {
+				found = true;
+				break;
+			}
 		}
 
-		if (NULL == token) {
+		if (!found) {
 			continue;
 		}
 
 		/* Next token must be address. */
-		token = strtok_r(NULL, delim, &saveptr);
-		if (NULL == token) {
+		if (tok_rdr_next_in_line(&rdr, &tok)) {
 			errno = EDOM;
 			goto fail;
 		}
-		if (tok_parse_ull(token, sa, 0)) {
+		if (tok_parse_ull(tok.str, sa, 0)) {
 			errno = EDOM;
 			goto fail;
 		}
 
-		token = strtok_r(NULL, delim, &saveptr);
-		if (NULL == token) {
+		if (tok_rdr_next_in_line(&rdr, &tok)) {
 			*sa = RIO_ANY_ADDR;
 			errno = EDOM;
 			goto fail;
 		}
-		if (tok_parse_ull(token, sz, 0)) {
+		if (tok_parse_ull(tok.str, sz, 0)) {
 			*sa = RIO_ANY_ADDR;
 			errno = EDOM;
 			goto fail;
@@ -147,11 +112,11 @@ int get_phys_mem(const char *filename, char *parm_name, uint64_t *sa,
 		done = true;
 	}
 
-	close(fd);
+	tok_rdr_close(&rdr);
 	return done ? 0 : -1;
 
 fail:
-	close(fd);
+	tok_rdr_close(&rdr);
 	return -1;
 
 }
@@ -0,0 +1,668 @@
+/* Buddy allocator for reserved physical memory, shared between processes */
+/*
+ ****************************************************************************
+ Copyright (c) 2016, Integrated Device Technology Inc.
+ Copyright (c) 2016, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ l of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this l of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "rrmap_config.h"
+#include "librsvdmem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RSVD_BUDDY_MAGIC	0x42554459 /* "BUDY" */
+#define RSVD_BUDDY_VERSION	2
+#define RSVD_BUDDY_NONE		0xFFFFFFFF
+
+/* Per minimum block state, only valid for the first block of a buddy */
+#define BLK_FREE	0x80
+#define BLK_ALLOC	0x40
+#define BLK_ORDER_MASK	0x3F
+
+/* Time to wait for another process to initialize the metadata */
+#define RSVD_BUDDY_ATTACH_WAIT_MS 1000
+
+/* Allocator metadata, shared between processes */
+struct rsvd_buddy_shm {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t start_addr;
+	uint64_t size;
+	uint32_t num_blocks; /* Number of 2^RSVD_BUDDY_MIN_ORDER blocks */
+	uint32_t max_order;
+	pthread_mutex_t lock; /* Robust, shared between processes */
+	uint32_t free_head[RSVD_BUDDY_MAX_ORDER + 1];
+	uint32_t free_cnt[RSVD_BUDDY_MAX_ORDER + 1];
+	uint64_t free_bytes;
+	uint64_t allocs;
+	uint64_t alloc_total;
+	uint64_t alloc_fails;
+	/* Followed by next[num_blocks], prev[num_blocks] free list links and
+	 * state[num_blocks]
+	 */
+};
+
+/* Process local handle */
+struct rsvd_buddy {
+	struct rsvd_buddy_shm *shm;
+	size_t shm_size;
+	uint32_t *next;
+	uint32_t *prev;
+	uint8_t *state;
+};
+
+static inline uint32_t order_of(uint64_t size)
+{
+	/* Smallest order such that 2^order >= size */
+	if (size <= 1) {
+		return 0;
+	}
+	return 64 - __builtin_clzll(size - 1);
+}
+
+static inline uint64_t blk_addr(struct rsvd_buddy *b, uint32_t idx)
+{
+	return b->shm->start_addr + ((uint64_t)idx << RSVD_BUDDY_MIN_ORDER);
+}
+
+static size_t shm_size_for(uint32_t num_blocks)
+{
+	return sizeof(struct rsvd_buddy_shm)
+			+ (size_t)num_blocks * (2 * sizeof(uint32_t) + 1);
+}
+
+static void set_ptrs(struct rsvd_buddy *b)
+{
+	uint32_t n = b->shm->num_blocks;
+
+	b->next = (uint32_t *)(b->shm + 1);
+	b->prev = b->next + n;
+	b->state = (uint8_t *)(b->prev + n);
+}
+
+static void list_add(struct rsvd_buddy *b, uint32_t idx, uint32_t order)
+{
+	struct rsvd_buddy_shm *shm = b->shm;
+	uint32_t head = shm->free_head[order];
+
+	b->state[idx] = BLK_FREE | order;
+	b->next[idx] = head;
+	b->prev[idx] = RSVD_BUDDY_NONE;
+	if (RSVD_BUDDY_NONE != head) {
+		b->prev[head] = idx;
+	}
+	shm->free_head[order] = idx;
+	shm->free_cnt[order]++;
+}
+
+static void list_del(struct rsvd_buddy *b, uint32_t idx, uint32_t order)
+{
+	struct rsvd_buddy_shm *shm = b->shm;
+
+	if (RSVD_BUDDY_NONE != b->prev[idx]) {
+		b->next[b->prev[idx]] = b->next[idx];
+	} else {
+		shm->free_head[order] = b->next[idx];
+	}
+	if (RSVD_BUDDY_NONE != b->next[idx]) {
+		b->prev[b->next[idx]] = b->prev[idx];
+	}
+	b->state[idx] = 0;
+	shm->free_cnt[order]--;
+}
+
+/* Carve the region into the largest naturally aligned free blocks */
+static int init_shm(struct rsvd_buddy *b, uint64_t start_addr, uint64_t size,
+		uint32_t num_blocks)
+{
+	struct rsvd_buddy_shm *shm = b->shm;
+	pthread_mutexattr_t attr;
+	uint64_t off = 0;
+	uint32_t order;
+	uint32_t i;
+	int rc;
+
+	shm->version = RSVD_BUDDY_VERSION;
+	shm->start_addr = start_addr;
+	shm->size = size;
+	shm->num_blocks = num_blocks;
+	shm->max_order = 63 - __builtin_clzll(size);
+	if (shm->max_order > RSVD_BUDDY_MAX_ORDER) {
+		shm->max_order = RSVD_BUDDY_MAX_ORDER;
+	}
+	for (i = 0; i <= RSVD_BUDDY_MAX_ORDER; i++) {
+		shm->free_head[i] = RSVD_BUDDY_NONE;
+		shm->free_cnt[i] = 0;
+	}
+	shm->free_bytes = 0;
+	shm->allocs = 0;
+	shm->alloc_total = 0;
+	shm->alloc_fails = 0;
+	set_ptrs(b);
+	memset(b->state, 0, num_blocks);
+
+	while ((off + (1ULL << RSVD_BUDDY_MIN_ORDER)) <= size) {
+		order = shm->max_order;
+		while ((off & ((1ULL << order) - 1))
+				|| ((off + (1ULL << order)) > size)) {
+			order--;
+		}
+		list_add(b, off >> RSVD_BUDDY_MIN_ORDER, order);
+		shm->free_bytes += 1ULL << order;
+		off += 1ULL << order;
+	}
+
+	rc = pthread_mutexattr_init(&attr);
+	if (rc) {
+		return rc;
+	}
+	rc = pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+	if (!rc) {
+		rc = pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+	}
+	if (!rc) {
+		rc = pthread_mutex_init(&shm->lock, &attr);
+	}
+	pthread_mutexattr_destroy(&attr);
+	return rc;
+}
+
+/* Return a free block to the free lists, merging it with free buddies */
+static void free_merge(struct rsvd_buddy *b, uint32_t idx, uint32_t order)
+{
+	struct rsvd_buddy_shm *shm = b->shm;
+	uint32_t bidx;
+
+	shm->free_bytes += 1ULL << order;
+	while (order < shm->max_order) {
+		bidx = idx ^ ((uint32_t)1 << (order - RSVD_BUDDY_MIN_ORDER));
+		if ((bidx >= shm->num_blocks)
+				|| (b->state[bidx] != (BLK_FREE | order))) {
+			break;
+		}
+		list_del(b, bidx, order);
+		if (bidx < idx) {
+			idx = bidx;
+		}
+		order++;
+	}
+	list_add(b, idx, order);
+}
+
+/* Rebuild the free lists after a process died holding the lock, possibly
+ * part way through an update.  Allocated blocks are kept, everything else
+ * is free.  Blocks which were being allocated or freed when the process
+ * died are therefore returned to the free lists.
+ */
+static void repair_shm(struct rsvd_buddy *b)
+{
+	struct rsvd_buddy_shm *shm = b->shm;
+	uint32_t idx, len, order, i;
+
+	for (i = 0; i <= RSVD_BUDDY_MAX_ORDER; i++) {
+		shm->free_head[i] = RSVD_BUDDY_NONE;
+		shm->free_cnt[i] = 0;
+	}
+
+	/* Keep valid allocated blocks, clear all other states */
+	shm->allocs = 0;
+	for (idx = 0; idx < shm->num_blocks; idx += len) {
+		order = b->state[idx] & BLK_ORDER_MASK;
+		len = 1;
+		if ((b->state[idx] & BLK_ALLOC)
+				&& (order >= RSVD_BUDDY_MIN_ORDER)
+				&& (order <= shm->max_order)) {
+			len = (uint32_t)1 << (order - RSVD_BUDDY_MIN_ORDER);
+			if (!(idx & (len - 1))
+					&& (len <= shm->num_blocks - idx)) {
+				shm->allocs++;
+				memset(&b->state[idx + 1], 0, len - 1);
+				continue;
+			}
+			len = 1;
+		}
+		b->state[idx] = 0;
+	}
+
+	shm->free_bytes = 0;
+	for (idx = 0; idx < shm->num_blocks; idx++) {
+		if (b->state[idx] & BLK_ALLOC) {
+			order = b->state[idx] & BLK_ORDER_MASK;
+			idx += ((uint32_t)1 << (order - RSVD_BUDDY_MIN_ORDER)) - 1;
+			continue;
+		}
+		free_merge(b, idx, RSVD_BUDDY_MIN_ORDER);
+	}
+}
+
+/* Lock the metadata, repairing it if the previous owner died */
+static int buddy_lock(struct rsvd_buddy *b)
+{
+	int rc;
+
+	rc = pthread_mutex_lock(&b->shm->lock);
+	if (EOWNERDEAD == rc) {
+		repair_shm(b);
+		rc = pthread_mutex_consistent(&b->shm->lock);
+		if (rc) {
+			pthread_mutex_unlock(&b->shm->lock);
+		}
+	}
+	if (rc) {
+		errno = rc;
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Attach to the buddy allocator for a reserved memory region,
+ *        creating and initializing the shared metadata if it does not
+ *        exist yet.
+ *
+ * @param[in] shm_name POSIX shared memory object name for the metadata
+ * @param[in] start_addr Physical start address of the region, page aligned
+ * @param[in] size Size of the region in bytes
+ * @param[out] buddy Allocator handle, release with rsvd_buddy_close()
+ * @return 0 for success, -1 for failure with errno set
+ * @retval EINVAL Invalid region, or the existing metadata is for a
+ *         different region
+ * @retval EACCES The existing metadata is not owned by this user, or is
+ *         accessible to other users
+ */
+int rsvd_buddy_attach(const char *shm_name, uint64_t start_addr,
+		uint64_t size, struct rsvd_buddy **buddy)
+{
+	struct rsvd_buddy *b;
+	struct timespec dly = {0, 1000000};
+	struct stat st;
+	uint64_t num_blocks;
+	bool creator = true;
+	int wait_ms;
+	int fd;
+
+	if ((NULL == shm_name) || (NULL == buddy)
+			|| (start_addr & ((1ULL << RSVD_BUDDY_MIN_ORDER) - 1))
+			|| (size < (1ULL << RSVD_BUDDY_MIN_ORDER))) {
+		errno = EINVAL;
+		return -1;
+	}
+	*buddy = NULL;
+
+	num_blocks = size >> RSVD_BUDDY_MIN_ORDER;
+	if (num_blocks >= RSVD_BUDDY_NONE) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	b = (struct rsvd_buddy *)calloc(1, sizeof(*b));
+	if (NULL == b) {
+		errno = ENOMEM;
+		return -1;
+	}
+	b->shm_size = shm_size_for(num_blocks);
+
+	/* The metadata decides which physical memory each process uses, so
+	 * only the owner may access it.
+	 */
+	fd = shm_open(shm_name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if ((fd < 0) && (EEXIST == errno)) {
+		creator = false;
+		fd = shm_open(shm_name, O_RDWR, 0);
+	}
+	if (fd < 0) {
+		goto fail;
+	}
+	if (!creator) {
+		if (fstat(fd, &st) < 0) {
+			goto fail_close;
+		}
+		if ((st.st_uid != geteuid())
+				|| (st.st_mode & (S_IRWXG | S_IRWXO))) {
+			errno = EACCES;
+			goto fail_close;
+		}
+	}
+
+	if (creator) {
+		if (ftruncate(fd, b->shm_size) < 0) {
+			goto fail_unlink;
+		}
+	} else {
+		/* Wait for the creator to size the object */
+		for (wait_ms = 0; wait_ms < RSVD_BUDDY_ATTACH_WAIT_MS;
+				wait_ms++) {
+			if (fstat(fd, &st) < 0) {
+				goto fail_close;
+			}
+			if ((size_t)st.st_size >= b->shm_size) {
+				break;
+			}
+			nanosleep(&dly, NULL);
+		}
+		if ((size_t)st.st_size != b->shm_size) {
+			errno = EINVAL;
+			goto fail_close;
+		}
+	}
+
+	b->shm = (struct rsvd_buddy_shm *)mmap(NULL, b->shm_size,
+			PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (MAP_FAILED == b->shm) {
+		b->shm = NULL;
+		goto fail_unlink;
+	}
+	close(fd);
+	fd = -1;
+
+	if (creator) {
+		errno = init_shm(b, start_addr, size, num_blocks);
+		if (errno) {
+			munmap(b->shm, b->shm_size);
+			b->shm = NULL;
+			goto fail_unlink;
+		}
+		__atomic_store_n(&b->shm->magic, RSVD_BUDDY_MAGIC,
+				__ATOMIC_RELEASE);
+	} else {
+		for (wait_ms = 0; (wait_ms < RSVD_BUDDY_ATTACH_WAIT_MS)
+				&& (RSVD_BUDDY_MAGIC != __atomic_load_n(
+					&b->shm->magic, __ATOMIC_ACQUIRE));
+				wait_ms++) {
+			nanosleep(&dly, NULL);
+		}
+		if ((RSVD_BUDDY_MAGIC != b->shm->magic)
+				|| (RSVD_BUDDY_VERSION != b->shm->version)
+				|| (start_addr != b->shm->start_addr)
+				|| (size != b->shm->size)) {
+			errno = EINVAL;
+			goto fail_unmap;
+		}
+		set_ptrs(b);
+	}
+
+	*buddy = b;
+	return 0;
+
+fail_unmap:
+	munmap(b->shm, b->shm_size);
+	goto fail;
+fail_unlink:
+	if (creator) {
+		shm_unlink(shm_name);
+	}
+fail_close:
+	if (fd >= 0) {
+		close(fd);
+	}
+fail:
+	free(b);
+	return -1;
+}
+
+/**
+ * @brief Attach to the buddy allocator for a region named in the reserved
+ *        memory configuration file.
+ *
+ * @param[in] parm_name Region keyword, for example RSVD_PHYS_MEM_RDMAD
+ * @param[out] buddy Allocator handle, release with rsvd_buddy_close()
+ * @return 0 for success, -1 for failure with errno set
+ */
+int rsvd_buddy_open(char *parm_name, struct rsvd_buddy **buddy)
+{
+	char shm_name[FMD_MAX_SHM_FN_LEN];
+	uint64_t start_addr;
+	uint64_t size;
+
+	if (get_rsvd_phys_mem(parm_name, &start_addr, &size)) {
+		if (!errno) {
+			errno = ENOENT;
+		}
+		return -1;
+	}
+	snprintf(shm_name, sizeof(shm_name), RSVD_BUDDY_SHM_FMT, parm_name);
+	return rsvd_buddy_attach(shm_name, start_addr, size, buddy);
+}
+
+void rsvd_buddy_close(struct rsvd_buddy *buddy)
+{
+	if (NULL == buddy) {
+		return;
+	}
+	munmap(buddy->shm, buddy->shm_size);
+	free(buddy);
+}
+
+/**
+ * @brief Remove the shared metadata.  Processes still attached keep their
+ *        view, the next rsvd_buddy_attach() starts with an empty region.
+ */
+int rsvd_buddy_unlink(const char *shm_name)
+{
+	return shm_unlink(shm_name);
+}
+
+/**
+ * @brief Allocate a physically contiguous block of reserved memory.
+ *
+ * @param[in] buddy Allocator handle
+ * @param[in] size Bytes required, rounded up to a power of two of at
+ *            least 2^RSVD_BUDDY_MIN_ORDER
+ * @param[in] align Required physical alignment, a power of two.  0 means
+ *            page alignment.
+ * @param[out] phys_addr Physical address of the block
+ * @return 0 for success, -1 for failure with errno set
+ * @retval EINVAL Invalid size or alignment, or the region start is not
+ *         aligned to align
+ * @retval ENOMEM No free block large enough
+ */
+int rsvd_buddy_alloc(struct rsvd_buddy *buddy, uint64_t size, uint64_t align,
+		uint64_t *phys_addr)
+{
+	struct rsvd_buddy_shm *shm;
+	uint32_t order;
+	uint32_t j;
+	uint32_t idx;
+
+	if ((NULL == buddy) || (NULL == phys_addr) || !size
+			|| (align & (align - 1))) {
+		errno = EINVAL;
+		return -1;
+	}
+	shm = buddy->shm;
+
+	/* Blocks are only aligned as well as the region start */
+	if (align && shm->start_addr && (shm->start_addr & (align - 1))) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	order = order_of(size);
+	if (order < order_of(align)) {
+		order = order_of(align);
+	}
+	if (order < RSVD_BUDDY_MIN_ORDER) {
+		order = RSVD_BUDDY_MIN_ORDER;
+	}
+
+	if (buddy_lock(buddy)) {
+		return -1;
+	}
+	for (j = order; (j <= shm->max_order)
+			&& (RSVD_BUDDY_NONE == shm->free_head[j]); j++) {
+	}
+	if (j > shm->max_order) {
+		shm->alloc_fails++;
+		pthread_mutex_unlock(&shm->lock);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	idx = shm->free_head[j];
+	list_del(buddy, idx, j);
+
+	/* Split, returning the upper halves to the free lists */
+	while (j > order) {
+		j--;
+		list_add(buddy, idx + ((uint32_t)1
+				<< (j - RSVD_BUDDY_MIN_ORDER)), j);
+	}
+	buddy->state[idx] = BLK_ALLOC | order;
+	shm->free_bytes -= 1ULL << order;
+	shm->allocs++;
+	shm->alloc_total++;
+	*phys_addr = blk_addr(buddy, idx);
+	pthread_mutex_unlock(&shm->lock);
+
+	return 0;
+}
+
+/**
+ * @brief Allocate a block suitable for an inbound window, which must be
+ *        a power of two in size and aligned to its size.
+ */
+int rsvd_buddy_alloc_ibwin(struct rsvd_buddy *buddy, uint64_t size,
+		uint64_t *phys_addr)
+{
+	if (!size || (size > (1ULL << RSVD_BUDDY_MAX_ORDER))) {
+		errno = EINVAL;
+		return -1;
+	}
+	return rsvd_buddy_alloc(buddy, size, 1ULL << order_of(size),
+			phys_addr);
+}
+
+/**
+ * @brief Return a block to the allocator, merging it with free buddies.
+ *
+ * @param[in] buddy Allocator handle
+ * @param[in] phys_addr Address returned by rsvd_buddy_alloc()
+ * @return 0 for success, -1 with errno EINVAL if phys_addr is not an
+ *         allocated block
+ */
+int rsvd_buddy_free(struct rsvd_buddy *buddy, uint64_t phys_addr)
+{
+	struct rsvd_buddy_shm *shm;
+	uint64_t off;
+	uint32_t idx;
+	uint32_t order;
+
+	if (NULL == buddy) {
+		errno = EINVAL;
+		return -1;
+	}
+	shm = buddy->shm;
+
+	off = phys_addr - shm->start_addr;
+	if ((phys_addr < shm->start_addr) || (off >= shm->size)
+			|| (off & ((1ULL << RSVD_BUDDY_MIN_ORDER) - 1))) {
+		errno = EINVAL;
+		return -1;
+	}
+	idx = off >> RSVD_BUDDY_MIN_ORDER;
+
+	if (buddy_lock(buddy)) {
+		return -1;
+	}
+	if (!(buddy->state[idx] & BLK_ALLOC)) {
+		pthread_mutex_unlock(&shm->lock);
+		errno = EINVAL;
+		return -1;
+	}
+	order = buddy->state[idx] & BLK_ORDER_MASK;
+	buddy->state[idx] = 0;
+	shm->allocs--;
+	free_merge(buddy, idx, order);
+	pthread_mutex_unlock(&shm->lock);
+
+	return 0;
+}
+
+/**
+ * @brief Report allocator usage and fragmentation.
+ *
+ * frag_pct is the percentage of free memory that is not part of the
+ * largest free block, 0 when all free memory is one block.
+ */
+int rsvd_buddy_get_stats(struct rsvd_buddy *buddy,
+		struct rsvd_buddy_stats *stats)
+{
+	struct rsvd_buddy_shm *shm;
+	uint32_t i;
+
+	if ((NULL == buddy) || (NULL == stats)) {
+		errno = EINVAL;
+		return -1;
+	}
+	shm = buddy->shm;
+
+	memset(stats, 0, sizeof(*stats));
+	if (buddy_lock(buddy)) {
+		return -1;
+	}
+	stats->start_addr = shm->start_addr;
+	stats->size = shm->size;
+	stats->free_bytes = shm->free_bytes;
+	for (i = 0; i <= RSVD_BUDDY_MAX_ORDER; i++) {
+		stats->free_blocks[i] = shm->free_cnt[i];
+		if (shm->free_cnt[i]) {
+			stats->largest_free = 1ULL << i;
+		}
+	}
+	stats->allocs = shm->allocs;
+	stats->alloc_total = shm->alloc_total;
+	stats->alloc_fails = shm->alloc_fails;
+	pthread_mutex_unlock(&shm->lock);
+
+	if (stats->free_bytes) {
+		stats->frag_pct = 100 - (uint32_t)((stats->largest_free * 100)
+				/ stats->free_bytes);
+	}
+	return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
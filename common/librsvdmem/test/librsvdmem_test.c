@@ -40,6 +40,11 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
 
 #include <stdarg.h>
 #include <setjmp.h>
@@ -420,6 +425,292 @@ static void illegal_address_characters_test(void **state)
 	(void)state; // unused
 }
 
+#define BUDDY_TEST_SHM "/RIO_RSVD_BUDDY_TEST"
+#define BUDDY_TEST_START 0x18000000
+#define BUDDY_TEST_SIZE 0x00100000
+
+static int buddy_setup(void **state)
+{
+	struct rsvd_buddy *buddy;
+
+	rsvd_buddy_unlink(BUDDY_TEST_SHM);
+	if (rsvd_buddy_attach(BUDDY_TEST_SHM, BUDDY_TEST_START,
+			BUDDY_TEST_SIZE, &buddy)) {
+		return -1;
+	}
+	*state = buddy;
+	return 0;
+}
+
+static int buddy_teardown(void **state)
+{
+	rsvd_buddy_close((struct rsvd_buddy *)*state);
+	rsvd_buddy_unlink(BUDDY_TEST_SHM);
+	return 0;
+}
+
+static void buddy_parms_test(void **state)
+{
+	struct rsvd_buddy *buddy;
+	uint64_t addr;
+
+	errno = 0;
+	assert_int_equal(-1, rsvd_buddy_attach(BUDDY_TEST_SHM, 0x18000100,
+			BUDDY_TEST_SIZE, &buddy));
+	assert_int_equal(EINVAL, errno);
+
+	errno = 0;
+	assert_int_equal(-1, rsvd_buddy_attach(BUDDY_TEST_SHM,
+			BUDDY_TEST_START, 0x100, &buddy));
+	assert_int_equal(EINVAL, errno);
+
+	// Metadata already exists for a different region
+	errno = 0;
+	assert_int_equal(-1, rsvd_buddy_attach(BUDDY_TEST_SHM,
+			BUDDY_TEST_START, 2 * BUDDY_TEST_SIZE, &buddy));
+	assert_int_equal(EINVAL, errno);
+
+	buddy = (struct rsvd_buddy *)*state;
+	errno = 0;
+	assert_int_equal(-1, rsvd_buddy_alloc(buddy, 0x1000, 0x3000, &addr));
+	assert_int_equal(EINVAL, errno);
+
+	// Region start is only 128M aligned
+	errno = 0;
+	assert_int_equal(-1, rsvd_buddy_alloc(buddy, 0x1000, 0x10000000,
+			&addr));
+	assert_int_equal(EINVAL, errno);
+
+	errno = 0;
+	assert_int_equal(-1, rsvd_buddy_free(buddy, BUDDY_TEST_START));
+	assert_int_equal(EINVAL, errno);
+}
+
+static void buddy_alloc_free_test(void **state)
+{
+	struct rsvd_buddy *buddy = (struct rsvd_buddy *)*state;
+	struct rsvd_buddy_stats stats;
+	uint64_t addr[256];
+	uint64_t extra;
+	int i;
+
+	assert_int_equal(0, rsvd_buddy_get_stats(buddy, &stats));
+	assert_int_equal(BUDDY_TEST_SIZE, stats.free_bytes);
+	assert_int_equal(BUDDY_TEST_SIZE, stats.largest_free);
+	assert_int_equal(1, stats.free_blocks[20]);
+	assert_int_equal(0, stats.frag_pct);
+
+	// Exhaust the region with minimum size blocks
+	for (i = 0; i < 256; i++) {
+		assert_int_equal(0, rsvd_buddy_alloc(buddy, 1, 0, &addr[i]));
+		assert_true(addr[i] >= BUDDY_TEST_START);
+		assert_true(addr[i] < BUDDY_TEST_START + BUDDY_TEST_SIZE);
+		assert_int_equal(0, addr[i] & 0xFFF);
+	}
+	errno = 0;
+	assert_int_equal(-1, rsvd_buddy_alloc(buddy, 1, 0, &extra));
+	assert_int_equal(ENOMEM, errno);
+
+	assert_int_equal(0, rsvd_buddy_get_stats(buddy, &stats));
+	assert_int_equal(0, stats.free_bytes);
+	assert_int_equal(256, stats.allocs);
+	assert_int_equal(1, stats.alloc_fails);
+
+	// Free every other block, memory is fragmented
+	for (i = 0; i < 256; i += 2) {
+		assert_int_equal(0, rsvd_buddy_free(buddy, addr[i]));
+	}
+	assert_int_equal(0, rsvd_buddy_get_stats(buddy, &stats));
+	assert_int_equal(BUDDY_TEST_SIZE / 2, stats.free_bytes);
+	assert_int_equal(0x1000, stats.largest_free);
+	assert_int_equal(128, stats.free_blocks[12]);
+	assert_true(stats.frag_pct > 90);
+	errno = 0;
+	assert_int_equal(-1, rsvd_buddy_alloc(buddy, 0x2000, 0, &extra));
+	assert_int_equal(ENOMEM, errno);
+
+	// Double free is rejected
+	errno = 0;
+	assert_int_equal(-1, rsvd_buddy_free(buddy, addr[0]));
+	assert_int_equal(EINVAL, errno);
+
+	// Freeing the rest coalesces back to a single block
+	for (i = 1; i < 256; i += 2) {
+		assert_int_equal(0, rsvd_buddy_free(buddy, addr[i]));
+	}
+	assert_int_equal(0, rsvd_buddy_get_stats(buddy, &stats));
+	assert_int_equal(BUDDY_TEST_SIZE, stats.free_bytes);
+	assert_int_equal(1, stats.free_blocks[20]);
+	assert_int_equal(0, stats.allocs);
+	assert_int_equal(0, stats.frag_pct);
+}
+
+static void buddy_align_test(void **state)
+{
+	struct rsvd_buddy *buddy = (struct rsvd_buddy *)*state;
+	struct rsvd_buddy_stats stats;
+	uint64_t small;
+	uint64_t addr;
+	uint64_t ibwin;
+
+	assert_int_equal(0, rsvd_buddy_alloc(buddy, 0x1000, 0, &small));
+	assert_int_equal(0, rsvd_buddy_alloc(buddy, 0x1000, 0x10000, &addr));
+	assert_int_equal(0, addr & 0xFFFF);
+
+	// Inbound windows are aligned to their size
+	assert_int_equal(0, rsvd_buddy_alloc_ibwin(buddy, 0x30000, &ibwin));
+	assert_int_equal(0, ibwin & 0x3FFFF);
+
+	assert_int_equal(0, rsvd_buddy_get_stats(buddy, &stats));
+	assert_int_equal(BUDDY_TEST_SIZE - 0x1000 - 0x10000 - 0x40000,
+			stats.free_bytes);
+
+	assert_int_equal(0, rsvd_buddy_free(buddy, ibwin));
+	assert_int_equal(0, rsvd_buddy_free(buddy, addr));
+	assert_int_equal(0, rsvd_buddy_free(buddy, small));
+	assert_int_equal(0, rsvd_buddy_get_stats(buddy, &stats));
+	assert_int_equal(BUDDY_TEST_SIZE, stats.largest_free);
+}
+
+static void buddy_odd_size_test(void **state)
+{
+	struct rsvd_buddy *buddy;
+	struct rsvd_buddy_stats stats;
+	uint64_t addr;
+
+	// 1M + 64K + 4K is carved into three naturally aligned blocks
+	rsvd_buddy_unlink(BUDDY_TEST_SHM "_ODD");
+	assert_int_equal(0, rsvd_buddy_attach(BUDDY_TEST_SHM "_ODD",
+			BUDDY_TEST_START, 0x111000, &buddy));
+	assert_int_equal(0, rsvd_buddy_get_stats(buddy, &stats));
+	assert_int_equal(0x111000, stats.free_bytes);
+	assert_int_equal(1, stats.free_blocks[20]);
+	assert_int_equal(1, stats.free_blocks[16]);
+	assert_int_equal(1, stats.free_blocks[12]);
+
+	assert_int_equal(0, rsvd_buddy_alloc(buddy, 0x10000, 0, &addr));
+	assert_int_equal(BUDDY_TEST_START + 0x100000, addr);
+	assert_int_equal(0, rsvd_buddy_free(buddy, addr));
+	assert_int_equal(0, rsvd_buddy_get_stats(buddy, &stats));
+	assert_int_equal(1, stats.free_blocks[16]);
+
+	rsvd_buddy_close(buddy);
+	rsvd_buddy_unlink(BUDDY_TEST_SHM "_ODD");
+	(void)state; // unused
+}
+
+static void buddy_shared_test(void **state)
+{
+	struct rsvd_buddy *buddy = (struct rsvd_buddy *)*state;
+	struct rsvd_buddy_stats stats;
+	uint64_t addr;
+	pid_t pid;
+	int status;
+
+	pid = fork();
+	assert_true(pid >= 0);
+	if (!pid) {
+		struct rsvd_buddy *child;
+
+		// Allocations by another process are visible to this one
+		if (rsvd_buddy_attach(BUDDY_TEST_SHM, BUDDY_TEST_START,
+				BUDDY_TEST_SIZE, &child)) {
+			_exit(1);
+		}
+		if (rsvd_buddy_alloc(child, BUDDY_TEST_SIZE / 2, 0, &addr)) {
+			_exit(2);
+		}
+		rsvd_buddy_close(child);
+		_exit(0);
+	}
+	assert_int_equal(pid, waitpid(pid, &status, 0));
+	assert_true(WIFEXITED(status));
+	assert_int_equal(0, WEXITSTATUS(status));
+
+	assert_int_equal(0, rsvd_buddy_get_stats(buddy, &stats));
+	assert_int_equal(BUDDY_TEST_SIZE / 2, stats.free_bytes);
+	assert_int_equal(1, stats.allocs);
+
+	assert_int_equal(0, rsvd_buddy_alloc(buddy, BUDDY_TEST_SIZE / 2, 0,
+			&addr));
+	errno = 0;
+	assert_int_equal(-1, rsvd_buddy_alloc(buddy, 0x1000, 0, &addr));
+	assert_int_equal(ENOMEM, errno);
+}
+
+static void buddy_perm_test(void **state)
+{
+	struct rsvd_buddy *buddy;
+	int fd;
+
+	// Metadata other users can change is not used
+	fd = shm_open(BUDDY_TEST_SHM, O_RDWR, 0);
+	assert_true(fd >= 0);
+	assert_int_equal(0, fchmod(fd, 0666));
+	errno = 0;
+	assert_int_equal(-1, rsvd_buddy_attach(BUDDY_TEST_SHM,
+			BUDDY_TEST_START, BUDDY_TEST_SIZE, &buddy));
+	assert_int_equal(EACCES, errno);
+
+	assert_int_equal(0, fchmod(fd, 0600));
+	assert_int_equal(0, rsvd_buddy_attach(BUDDY_TEST_SHM,
+			BUDDY_TEST_START, BUDDY_TEST_SIZE, &buddy));
+	rsvd_buddy_close(buddy);
+	close(fd);
+	(void)state; // unused
+}
+
+#define BUDDY_KILL_LOOPS 10
+
+static void buddy_owner_dead_test(void **state)
+{
+	struct rsvd_buddy *buddy = (struct rsvd_buddy *)*state;
+	struct rsvd_buddy_stats stats;
+	struct timespec dly = {0, 5000000};
+	uint64_t addr[2];
+	pid_t pid;
+	int status;
+	int i;
+
+	// Kill processes which are allocating and freeing, often while they
+	// hold the lock.  The allocator must remain usable and consistent,
+	// blocks held by the dead processes stay allocated.
+	for (i = 0; i < BUDDY_KILL_LOOPS; i++) {
+		pid = fork();
+		assert_true(pid >= 0);
+		if (!pid) {
+			struct rsvd_buddy *child;
+
+			if (rsvd_buddy_attach(BUDDY_TEST_SHM,
+					BUDDY_TEST_START, BUDDY_TEST_SIZE,
+					&child)) {
+				_exit(1);
+			}
+			while (true) {
+				if (!rsvd_buddy_alloc(child, 0x1000, 0,
+						&addr[0])) {
+					rsvd_buddy_free(child, addr[0]);
+				}
+			}
+		}
+		nanosleep(&dly, NULL);
+		assert_int_equal(0, kill(pid, SIGKILL));
+		assert_int_equal(pid, waitpid(pid, &status, 0));
+		assert_true(WIFSIGNALED(status));
+
+		assert_int_equal(0, rsvd_buddy_get_stats(buddy, &stats));
+		assert_true(stats.allocs <= (uint64_t)i + 1);
+		assert_int_equal(BUDDY_TEST_SIZE,
+				stats.free_bytes + (stats.allocs * 0x1000));
+	}
+
+	assert_int_equal(0, rsvd_buddy_alloc(buddy, 0x1000, 0, &addr[0]));
+	assert_int_equal(0, rsvd_buddy_alloc(buddy, 0x1000, 0, &addr[1]));
+	assert_true(addr[0] != addr[1]);
+	assert_int_equal(0, rsvd_buddy_free(buddy, addr[0]));
+	assert_int_equal(0, rsvd_buddy_free(buddy, addr[1]));
+}
+
 int main(int argc, char *argv[])
 {
 	(void)argv; // not used
@@ -443,7 +734,20 @@ int main(int argc, char *argv[])
 	cmocka_unit_test(missing_size_test),
 	cmocka_unit_test(invalid_line_format_test),
 	cmocka_unit_test(misaligned_address_test),
-	cmocka_unit_test(illegal_address_characters_test), };
+	cmocka_unit_test(illegal_address_characters_test),
+	cmocka_unit_test_setup_teardown(buddy_parms_test, buddy_setup,
+			buddy_teardown),
+	cmocka_unit_test_setup_teardown(buddy_alloc_free_test, buddy_setup,
+			buddy_teardown),
+	cmocka_unit_test_setup_teardown(buddy_align_test, buddy_setup,
+			buddy_teardown),
+	cmocka_unit_test(buddy_odd_size_test),
+	cmocka_unit_test_setup_teardown(buddy_shared_test, buddy_setup,
+			buddy_teardown),
+	cmocka_unit_test_setup_teardown(buddy_perm_test, buddy_setup,
+			buddy_teardown),
+	cmocka_unit_test_setup_teardown(buddy_owner_dead_test, buddy_setup,
+			buddy_teardown), };
 	return cmocka_run_group_tests(tests, NULL, NULL);
 }
 
@@ -35,6 +35,8 @@
 #include <sys/time.h>
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
+#include <math.h>
 
 #include "libtime_utils.h"
 
@@ -263,6 +265,211 @@ void time_sleep(const struct timespec *delay)
 		dly = rem;
 	} while (rc && (errno == EINTR));
 }
+
+/**
+ * @brief Initialize nanosecond statistics to contain no samples
+ *
+ * @param[out] st Statistics to initialize
+ */
+void time_ns_stats_init(struct time_ns_stats *st)
+{
+	st->count = 0;
+	st->total = 0;
+	st->min = INT64_MAX;
+	st->max = INT64_MIN;
+	st->mean = 0;
+	st->m2 = 0;
+}
+
+/**
+ * @brief Add one sample to nanosecond statistics
+ *
+ * @param[inout] st Statistics to update
+ * @param[in] sample Sample value, in nanoseconds
+ */
+void time_ns_stats_add(struct time_ns_stats *st, int64_t sample)
+{
+	double delta;
+
+	st->count++;
+	st->total += sample;
+	if (sample < st->min) {
+		st->min = sample;
+	}
+	if (sample > st->max) {
+		st->max = sample;
+	}
+
+	delta = (double)sample - st->mean;
+	st->mean += delta / (double)st->count;
+	st->m2 += delta * ((double)sample - st->mean);
+}
+
+/**
+ * @brief Combine two sets of nanosecond statistics
+ *
+ * @param[inout] st On return, statistics of the samples in st and other
+ * @param[in] other Statistics to combine into st
+ */
+void time_ns_stats_merge(struct time_ns_stats *st,
+		const struct time_ns_stats *other)
+{
+	double delta;
+	double count;
+
+	if (!other->count) {
+		return;
+	}
+	if (!st->count) {
+		*st = *other;
+		return;
+	}
+
+	count = (double)(st->count + other->count);
+	delta = other->mean - st->mean;
+	st->mean += delta * (double)other->count / count;
+	st->m2 += other->m2 + delta * delta * (double)st->count
+			* (double)other->count / count;
+	st->count += other->count;
+	st->total += other->total;
+	if (other->min < st->min) {
+		st->min = other->min;
+	}
+	if (other->max > st->max) {
+		st->max = other->max;
+	}
+}
+
+/**
+ * @brief Return the sample variance of the statistics, in nanoseconds^2
+ */
+double time_ns_stats_variance(const struct time_ns_stats *st)
+{
+	if (st->count < 2) {
+		return 0;
+	}
+	return st->m2 / (double)(st->count - 1);
+}
+
+/**
+ * @brief Return the sample standard deviation, in nanoseconds
+ */
+double time_ns_stats_stddev(const struct time_ns_stats *st)
+{
+	return sqrt(time_ns_stats_variance(st));
+}
+
+/**
+ * @brief Convert an array of timespecs to nanoseconds
+ *
+ * @param[in] ts Timespecs to convert
+ * @param[out] ns Nanosecond values, may not overlap ts
+ * @param[in] n Number of entries
+ */
+void time_ns_from_ts(const struct timespec *__restrict ts,
+		int64_t *__restrict ns, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		ns[i] = (int64_t)ts[i].tv_sec * TIME_NSEC_PER_SEC
+				+ ts[i].tv_nsec;
+	}
+}
+
+/**
+ * @brief Compute the differences between consecutive samples
+ *
+ * @param[in] ns n sample times, in nanoseconds
+ * @param[out] deltas n - 1 differences, deltas[i] = ns[i + 1] - ns[i]
+ * @param[in] n Number of sample times
+ */
+void time_ns_deltas(const int64_t *__restrict ns, int64_t *__restrict deltas,
+		int n)
+{
+	int i;
+
+	for (i = 0; i < n - 1; i++) {
+		deltas[i] = ns[i + 1] - ns[i];
+	}
+}
+
+/**
+ * @brief Add an array of samples to nanosecond statistics
+ *
+ * The sum, minimum and maximum are computed in one pass and the squared
+ * differences from the mean in a second pass.  Both loops are free of
+ * dependencies between iterations so the compiler can vectorize them.
+ * The result is combined with st as for time_ns_stats_merge().
+ *
+ * @param[in] samples Sample values, in nanoseconds
+ * @param[in] n Number of samples
+ * @param[inout] st Statistics to update
+ */
+void time_ns_reduce(const int64_t *__restrict samples, int n,
+		struct time_ns_stats *st)
+{
+	struct time_ns_stats part;
+	int64_t total = 0;
+	int64_t min = INT64_MAX;
+	int64_t max = INT64_MIN;
+	double mean;
+	double m2 = 0;
+	int i;
+
+	if (n <= 0) {
+		return;
+	}
+
+	for (i = 0; i < n; i++) {
+		total += samples[i];
+		min = (samples[i] < min) ? samples[i] : min;
+		max = (samples[i] > max) ? samples[i] : max;
+	}
+
+	mean = (double)total / (double)n;
+	for (i = 0; i < n; i++) {
+		double d = (double)samples[i] - mean;
+		m2 += d * d;
+	}
+
+	part.count = n;
+	part.total = total;
+	part.min = min;
+	part.max = max;
+	part.mean = mean;
+	part.m2 = m2;
+	time_ns_stats_merge(st, &part);
+}
+
+/**
+ * @brief Compute nanosecond differences between consecutive timestamps
+ *
+ * @param[in] ts Time stamp tracking structure
+ * @param[in] st_i Index of first timestamp
+ * @param[in] end_i Index of last timestamp
+ * @param[out] deltas end_i - st_i differences, deltas[i] is the time
+ *             between timestamps st_i + i and st_i + i + 1
+ * @return Number of differences written to deltas, or -1 for invalid
+ *         parameters
+ */
+int seq_ts_deltas_ns(const struct seq_ts *ts, int st_i, int end_i,
+		int64_t *deltas)
+{
+	int64_t ns[MAX_TIMESTAMPS];
+	int n;
+
+	if ((NULL == ts) || (NULL == deltas) || (st_i < 0)
+			|| (end_i >= MAX_TIMESTAMPS) || (end_i < st_i)) {
+		return -1;
+	}
+
+	n = end_i - st_i + 1;
+	time_ns_from_ts(&ts->ts_val[st_i], ns, n);
+	time_ns_deltas(ns, deltas, n);
+	return n - 1;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,6 +32,7 @@
 
 #include <stdarg.h>
 #include <setjmp.h>
+#include <math.h>
 #include "cmocka.h"
 
 #include "libtime_utils.h"
@@ -529,6 +530,134 @@ static void time_track_lim_test(void **state)
 	(void)state; // not used
 }
 
+static void time_ns_conv_test(void **state)
+{
+	struct timespec ts;
+
+	ts.tv_sec = 3;
+	ts.tv_nsec = 5;
+	assert_int_equal(3000000005LL, time_ts_to_ns(&ts));
+
+	ts = time_ns_to_ts(4000000007LL);
+	assert_int_equal(4, ts.tv_sec);
+	assert_int_equal(7, ts.tv_nsec);
+
+	ts = time_ns_to_ts(-1);
+	assert_int_equal(-1, ts.tv_sec);
+	assert_int_equal(999999999, ts.tv_nsec);
+
+	assert_int_equal(-10, time_ns_diff(20, 10));
+	assert_true(time_ns_now() > 0);
+
+	(void)state; // unused
+}
+
+static void time_ns_stats_test(void **state)
+{
+	struct time_ns_stats st;
+	int64_t samples[] = {2, 4, 4, 4, 5, 5, 7, 9};
+	unsigned i;
+
+	time_ns_stats_init(&st);
+	assert_int_equal(0, st.count);
+	assert_true(0 == time_ns_stats_variance(&st));
+
+	for (i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+		time_ns_stats_add(&st, samples[i]);
+	}
+	assert_int_equal(8, st.count);
+	assert_int_equal(40, st.total);
+	assert_int_equal(2, st.min);
+	assert_int_equal(9, st.max);
+	assert_true(fabs(st.mean - 5.0) < 1e-9);
+	/* Population variance 4, sample variance 32 / 7 */
+	assert_true(fabs(time_ns_stats_variance(&st) - 32.0 / 7.0) < 1e-9);
+	assert_true(fabs(time_ns_stats_stddev(&st) - sqrt(32.0 / 7.0)) < 1e-9);
+
+	(void)state; // unused
+}
+
+static void time_ns_reduce_test(void **state)
+{
+	const int n = 1000000;
+	int64_t *samples = (int64_t *)malloc(n * sizeof(int64_t));
+	struct time_ns_stats seq;
+	struct time_ns_stats bulk;
+	struct time_ns_stats split;
+	int i;
+
+	assert_non_null(samples);
+	for (i = 0; i < n; i++) {
+		samples[i] = 1000 + ((i * 7919) % 5003) - (i % 13) * 11;
+	}
+
+	time_ns_stats_init(&seq);
+	for (i = 0; i < n; i++) {
+		time_ns_stats_add(&seq, samples[i]);
+	}
+
+	time_ns_stats_init(&bulk);
+	time_ns_reduce(samples, n, &bulk);
+
+	/* Reduce in two parts, result must match a single reduction */
+	time_ns_stats_init(&split);
+	time_ns_reduce(samples, n / 3, &split);
+	time_ns_reduce(&samples[n / 3], n - n / 3, &split);
+
+	assert_int_equal(seq.count, bulk.count);
+	assert_int_equal(seq.total, bulk.total);
+	assert_int_equal(seq.min, bulk.min);
+	assert_int_equal(seq.max, bulk.max);
+	assert_true(fabs(seq.mean - bulk.mean) < 1e-6);
+	assert_true(fabs(time_ns_stats_variance(&seq)
+			- time_ns_stats_variance(&bulk))
+			< 1e-6 * time_ns_stats_variance(&seq));
+
+	assert_int_equal(bulk.count, split.count);
+	assert_int_equal(bulk.total, split.total);
+	assert_int_equal(bulk.min, split.min);
+	assert_int_equal(bulk.max, split.max);
+	assert_true(fabs(bulk.mean - split.mean) < 1e-6);
+	assert_true(fabs(time_ns_stats_variance(&bulk)
+			- time_ns_stats_variance(&split))
+			< 1e-6 * time_ns_stats_variance(&bulk));
+
+	/* Empty reduction changes nothing */
+	time_ns_reduce(samples, 0, &split);
+	assert_int_equal(bulk.count, split.count);
+
+	free(samples);
+	(void)state; // unused
+}
+
+static void seq_ts_deltas_ns_test(void **state)
+{
+	struct seq_ts ts;
+	int64_t deltas[MAX_TIMESTAMPS];
+	int i;
+
+	init_seq_ts(&ts, MAX_TIMESTAMPS);
+	for (i = 0; i < 10; i++) {
+		ts.ts_val[i].tv_sec = 1 + (i / 3);
+		ts.ts_val[i].tv_nsec = 999999000 + i;
+	}
+
+	assert_int_equal(-1, seq_ts_deltas_ns(NULL, 0, 1, deltas));
+	assert_int_equal(-1, seq_ts_deltas_ns(&ts, 0, 1, NULL));
+	assert_int_equal(-1, seq_ts_deltas_ns(&ts, 5, 4, deltas));
+	assert_int_equal(-1, seq_ts_deltas_ns(&ts, 0, MAX_TIMESTAMPS, deltas));
+	assert_int_equal(0, seq_ts_deltas_ns(&ts, 3, 3, deltas));
+
+	assert_int_equal(9, seq_ts_deltas_ns(&ts, 0, 9, deltas));
+	for (i = 0; i < 9; i++) {
+		struct timespec diff = time_difference(ts.ts_val[i],
+				ts.ts_val[i + 1]);
+		assert_int_equal(time_ts_to_ns(&diff), deltas[i]);
+	}
+
+	(void)state; // unused
+}
+
 int main(int argc, char *argv[])
 {
 	(void)argv; // not used
@@ -546,7 +675,11 @@ int main(int argc, char *argv[])
 	cmocka_unit_test(time_add_test),
 	cmocka_unit_test(time_div_test),
 	cmocka_unit_test(time_track_test),
-	cmocka_unit_test(time_track_lim_test), };
+	cmocka_unit_test(time_track_lim_test),
+	cmocka_unit_test(time_ns_conv_test),
+	cmocka_unit_test(time_ns_stats_test),
+	cmocka_unit_test(time_ns_reduce_test),
+	cmocka_unit_test(seq_ts_deltas_ns_test), };
 
 	return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -62,6 +62,7 @@ struct fmd_opt_vals {
 	int run_cons;		/* Run a console on this daemon. */
 	uint32_t log_level;	/* Starting log level */
 	uint32_t log_disp_level;	/* Starting log display level */
+	int log_bin;		/* If asserted, log binary records */
 	uint32_t mast_mode;	/* 0 - FMD slave, 1 - FMD master */
 	uint32_t mast_interval;	/* Master FMD location information */
 	did_t mast_did;		/* Master FMD location information */
@@ -69,6 +70,10 @@ struct fmd_opt_vals {
 	char *fmd_cfg; /* FMD configuration file */
 	char *dd_fn; /* Device directory file name */
 	char *dd_mtx_fn; /* Device directory mutex file name */
+	uint32_t init_workers; /* Deferred device init threads */
+	uint32_t sc_period; /* Statistics counter sampling period, msec */
+	uint32_t ps_period; /* Port status cache refresh period, msec */
+	int mt_acct; /* Count maintenance transactions from startup */
 };
 
 extern struct fmd_opt_vals *fmd_parse_options(int argc, char *argv[]);
@@ -0,0 +1,132 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#ifndef __FMD_REG_DUMP_H__
+#define __FMD_REG_DUMP_H__
+
+/**
+ * @file fmd_reg_dump.h
+ * Fabric Management Daemon register dumps
+ *
+ * A register dump is a list of ranges of consecutive registers.  Each range
+ * either holds the values of its registers, or the return code of the
+ * failed read of all of them.  Registers are read with block maintenance
+ * reads, falling back to one register at a time only for blocks which
+ * cannot be read.
+ *
+ * Dump files hold, in host byte order:
+ * - struct fmd_rdump_hdr
+ * - num_rngs range records of 3 words: offset, register count, rc
+ * - the register values of every range with rc 0, in range order
+ */
+
+#include <stdint.h>
+#include "rio_route.h"
+#include "riocp_pe.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FMD_RDUMP_MAGIC 0x504d4452
+#define FMD_RDUMP_VER 1
+
+// Registers read by one block maintenance read
+#define FMD_RDUMP_BLK 64
+
+// Largest register offset which can be dumped, plus 1
+#define FMD_RDUMP_MAX_OFS 0x01000000
+
+struct fmd_rdump_hdr {
+	uint32_t magic;
+	uint32_t version;
+	ct_t comptag;
+	uint32_t dev_id;	// Device identity CAR
+	uint64_t time;		// Seconds since the epoch
+	uint32_t num_rngs;
+	uint32_t num_regs;	// Register values in the file
+};
+
+struct fmd_rdump_rng {
+	uint32_t offset;
+	uint32_t cnt;
+	uint32_t rc;		// 0 if the values of cnt registers are present
+	uint32_t idx;		// Index of the first value in data, not saved
+};
+
+struct fmd_rdump {
+	struct fmd_rdump_hdr hdr;
+	struct fmd_rdump_rng *rngs;
+	uint32_t *data;
+	uint32_t rngs_max;
+	uint32_t data_max;
+};
+
+// Initializes an empty dump for device pe.  pe may be NULL.
+void fmd_rdump_init(struct fmd_rdump *d, riocp_pe_handle pe);
+void fmd_rdump_free(struct fmd_rdump *d);
+
+/* Adds bytes bytes of registers of device pe, starting at offset, to the
+ * dump.  Returns 0 if the registers were added, even if some could not be
+ * read, or -1 if the parameters are invalid or memory cannot be allocated.
+ */
+int fmd_rdump_read(struct fmd_rdump *d, riocp_pe_handle pe, uint32_t offset,
+		uint32_t bytes);
+
+/* Adds the registers of device pe which were read successfully in ref to
+ * the dump, so that the dump can be compared to ref.
+ */
+int fmd_rdump_read_as(struct fmd_rdump *d, riocp_pe_handle pe,
+		struct fmd_rdump *ref);
+
+// Returns 0 and the value of the register at offset, if it is in the dump.
+int fmd_rdump_get(struct fmd_rdump *d, uint32_t offset, uint32_t *val);
+
+// Saves the dump to, or loads a dump from, the file fn.  Returns 0 or errno.
+int fmd_rdump_save(struct fmd_rdump *d, const char *fn);
+int fmd_rdump_load(struct fmd_rdump *d, const char *fn);
+
+/* Calls diff_fn for each register which has different values in a and b,
+ * or which is present in only one of them.  The value of a missing register
+ * is passed as NULL.  Returns the number of differences.
+ */
+typedef void (*fmd_rdump_diff_fn)(void *ctx, uint32_t offset, uint32_t *a,
+		uint32_t *b);
+uint32_t fmd_rdump_diff(struct fmd_rdump *a, struct fmd_rdump *b,
+		fmd_rdump_diff_fn diff_fn, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FMD_REG_DUMP_H__ */
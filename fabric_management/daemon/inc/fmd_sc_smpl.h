@@ -0,0 +1,75 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#ifndef __FMD_SC_SMPL_H__
+#define __FMD_SC_SMPL_H__
+
+/**
+ * @file fmd_sc_smpl.h
+ * Fabric Management Daemon statistics counter sampler
+ */
+
+#include <stdint.h>
+#include "riocp_pe.h"
+#include "fmd_sc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FMD_SC_MAX_PERIOD 3600000
+
+/* Creates the statistics counter shared memory file sc_fn, and starts the
+ * thread which samples the counters of all switches every period_ms
+ * milliseconds.  Does nothing if period_ms is 0.
+ */
+int fmd_sc_smpl_start(char *sc_fn, uint32_t period_ms);
+
+/* Stops the sampler thread, and removes the shared memory file. */
+void fmd_sc_smpl_stop(void);
+
+/* Returns the shared memory file contents, or NULL if sampling is off. */
+struct fmd_sc *fmd_sc_smpl_get(void);
+
+/* Serializes reads of the statistics counters of devices, which may clear
+ * the hardware counters.  Each mport has its own lock, so devices behind
+ * different mports are read in parallel.
+ */
+void fmd_sc_lock(riocp_pe_handle pe);
+void fmd_sc_unlock(riocp_pe_handle pe);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FMD_SC_SMPL_H__ */
@@ -60,6 +60,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "riocp_pe_internal.h"
 #include "fmd_dd.h"
+#include "fmd_mt.h"
 #include "cfg.h"
 #include "fmd_opts.h"
 #include "rapidio_mport_mgmt.h"
@@ -88,6 +89,8 @@ struct fmd_state {
 	char *dd_mtx_fn;
 	int dd_mtx_fd;
 	struct fmd_dd_mtx *dd_mtx;
+	int mt_fd;
+	struct fmd_mt *mt;
 	struct app_state apps[FMD_MAX_APPS];
 };
 
@@ -74,6 +74,7 @@
 #include "fmd_app_msg.h"
 #include "liblist.h"
 #include "liblog.h"
+#include "liblog_bin.h"
 #include "ct.h"
 #include "did.h"
 #include "cfg.h"
@@ -85,6 +86,9 @@
 #include "fmd_cli.h"
 #include "fmd_dev_rw_cli.h"
 #include "fmd_sc_cli.h"
+#include "fmd_sc_smpl.h"
+#include "fmd_mt.h"
+#include "fmd_mt_cli.h"
 #include "fmd_dev_conf_cli.h"
 #include "fmd_rio_compliance_cli.h"
 #include "fmd_master.h"
@@ -113,6 +117,11 @@ void custom_quit(struct cli_env *env)
 {
 	(void)env;
 
+	fmd_sc_smpl_stop();
+	mpsw_ps_refresh_stop();
+	mpsw_mt_set(NULL);
+	fmd_mt_cleanup((char *)FMD_DFLT_MT_FN, &fmd->mt_fd, &fmd->mt,
+			fmd->fmd_rw);
 	fmd_dd_cleanup(fmd->dd_mtx_fn, &fmd->dd_mtx_fd, &fmd->dd_mtx,
 			fmd->dd_fn, &fmd->dd_fd, &fmd->dd, fmd->fmd_rw);
 	if (app_st.fd > 0) {
@@ -195,6 +204,7 @@ void spawn_threads(struct fmd_opt_vals *opts)
 	fmd_bind_mgmt_dbg_cmds();
 	fmd_bind_dev_rw_cmds();
 	fmd_bind_dev_sc_cmds();
+	fmd_bind_mt_cmds();
 	fmd_bind_dev_conf_cmds();
 	fmd_bind_compliance_cmds();
 
@@ -266,6 +276,20 @@ void spawn_threads(struct fmd_opt_vals *opts)
 	if (ret) {
 		WARN("fmd_enable_all_endpoints rc: %d\n", ret);
 	}
+
+	// The FMD can manage the fabric without statistics counter samples,
+	// so continue if the sampler cannot be started.
+	ret = fmd_sc_smpl_start((char *)FMD_DFLT_SC_FN, opts->sc_period);
+	if (ret) {
+		WARN("Statistics counter sampling not started\n");
+	}
+
+	// Without the refresh, cached port status is still updated by
+	// port-writes and by changes made through the driver.
+	if (opts->ps_period && mpsw_ps_refresh_start(mport_pe,
+							opts->ps_period)) {
+		WARN("Port status refresh not started\n");
+	}
 }
 
 // cleanup the /sys/bus/rapidio/devices directory
@@ -415,9 +439,11 @@ exit:
 
 int setup_mport_master(int mport)
 {
+	int rc;
+	uint32_t errs;
 	ct_t comptag;
 	struct cfg_mport_info mp;
-	struct cfg_dev cfg_dev;
+	const struct cfg_dev *cfg_dev = NULL;
 	did_t did;
 	char *name;
 	did_sz_t did_sz = cfg_did_sz();
@@ -464,12 +490,17 @@ int setup_mport_master(int mport)
 		}
 		snprintf(name, FMD_MAX_NAME + 1, "MPORT%d", mport);
 		name[sizeof(name) - 1] = '\0';
-	} else {
-		SAFE_STRNCPY(name, cfg_dev.name, FMD_MAX_NAME + 1);
+	} else if (NULL != cfg_dev) {
+		SAFE_STRNCPY(name, cfg_dev->name, FMD_MAX_NAME + 1);
+	}
+
+	if (mpsw_init_workers_start(fmd->opts->init_workers)) {
+		WARN("Init workers not started, initializing serially\n");
 	}
 
 	if (riocp_pe_create_host_handle(&mport_pe, mport, 0, &comptag, name)) {
 		CRIT("Cannot create host handle mport %d, exiting...", mport);
+		mpsw_init_workers_stop();
 		riocp_pe_destroy_handle(&mport_pe);
 		free(name);
 		return 1;
@@ -478,7 +509,19 @@ int setup_mport_master(int mport)
 	free(name);
 	delete_sysfs_devices(mport_pe, true);
 
-	return fmd_traverse_network(mport_pe, &cfg_dev);
+	rc = fmd_traverse_network(mport_pe, cfg_dev);
+	if (!rc && cfg_auto()) {
+		// Devices found by auto discovery have no configured routes
+		rc = mpsw_drv_compute_routes(mport_pe);
+	}
+
+	// Devices are ready once their deferred initialization completes
+	errs = mpsw_init_wait();
+	if (errs) {
+		ERR("Deferred init failed for %u devices\n", errs);
+	}
+	mpsw_init_workers_stop();
+	return rc;
 }
 
 int slave_get_ct_and_name(int mport, ct_t *comptag, char *dev_name)
@@ -487,7 +530,7 @@ int slave_get_ct_and_name(int mport, ct_t *comptag, char *dev_name)
 
 	uint32_t mp_num = 0;
 	struct cfg_mport_info mp;
-	struct cfg_dev cfg_dev;
+	const struct cfg_dev *cfg_dev;
 	struct mport_regs regs;
 	bool check;
 
@@ -495,7 +538,7 @@ int slave_get_ct_and_name(int mport, ct_t *comptag, char *dev_name)
 		mp_num = mp.num;
 		*comptag = mp.ct;
 		if (!cfg_find_dev_by_ct(*comptag, &cfg_dev)) {
-			SAFE_STRNCPY(dev_name, cfg_dev.name, FMD_MAX_DEV_FN);
+			SAFE_STRNCPY(dev_name, cfg_dev->name, FMD_MAX_DEV_FN);
 			return 0;
 		}
 	}
@@ -602,6 +645,18 @@ void setup_mport(struct fmd_state *fmd)
 		goto fail;
 	}
 
+	dsf_rc = DAR_blk_rd_proc_ptr_init(SRIO_API_ReadRegBlockFunc);
+	if (dsf_rc) {
+		CRIT(SOFTWARE_FAIL);
+		goto fail;
+	}
+
+	dsf_rc = DAR_blk_proc_ptr_init(SRIO_API_WriteRegBlockFunc);
+	if (dsf_rc) {
+		CRIT(SOFTWARE_FAIL);
+		goto fail;
+	}
+
 	fmd->mp_h = &mport_pe;
 
 	INFO("Master mode is %d\n", fmd->opts->mast_mode);
@@ -715,6 +770,13 @@ int main(int argc, char *argv[])
 	snprintf(log_file_name, FMD_MAX_LOG_FILE_NAME,
 			FMD_LOG_FILE_FMT, opts->app_port_num);
 	rdma_log_init(log_file_name, 1);
+	if (opts->log_bin) {
+		snprintf(log_file_name, FMD_MAX_LOG_FILE_NAME,
+				FMD_BIN_LOG_FILE_FMT, opts->app_port_num);
+		if (rdma_log_bin_init(log_file_name, 0)) {
+			printf("\nCannot start binary log, logging text.\n");
+		}
+	}
 
 	g_level = opts->log_level;
 	g_disp_level = opts->log_disp_level;
@@ -746,6 +808,15 @@ int main(int argc, char *argv[])
 		goto dd_cleanup;
 	}
 
+	// Without the shared memory file, transactions are counted by the
+	// driver and can still be displayed by the CLI.
+	if (fmd_mt_init((char *)FMD_DFLT_MT_FN, &fmd->mt_fd, &fmd->mt)) {
+		WARN("Maintenance statistics not shared\n");
+	} else {
+		mpsw_mt_set(fmd->mt);
+	}
+	mpsw_mt_enable(fmd->opts->mt_acct);
+
 	setup_mport(fmd);
 
 	if (!fmd->opts->simple_init
@@ -767,6 +838,9 @@ int main(int argc, char *argv[])
 	}
 
 dd_cleanup:
+	mpsw_mt_set(NULL);
+	fmd_mt_cleanup((char *)FMD_DFLT_MT_FN, &fmd->mt_fd, &fmd->mt,
+			fmd->fmd_rw);
 	fmd_dd_cleanup(fmd->dd_mtx_fn, &fmd->dd_mtx_fd,
 			&fmd->dd_mtx, fmd->dd_fn, &fmd->dd_fd, &fmd->dd,
 			fmd->fmd_rw);
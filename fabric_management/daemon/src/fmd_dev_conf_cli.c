@@ -61,6 +61,7 @@ int CLIConfigCmd(struct cli_env *env, int argc, char **argv)
 	riocp_pe_handle peer_pe;
 	bool printed_one = false;
 	char *blank_dev = (char *)"        ";
+	struct mpsw_ps_cache_stats ps_stats;
 	char *fmt_str;
 
 	memset((void *)pe_port_info, 0, sizeof(pe_port_info));
@@ -113,6 +114,18 @@ int CLIConfigCmd(struct cli_env *env, int argc, char **argv)
 		goto exit;
 	}
 
+	if (!mpsw_ps_cache_get_stats(pe_h, &ps_stats)) {
+		LOGMSG(env, "\nPort status age %llu msec, %u stale ports, "
+			"%llu hits, %llu misses\n"
+			"  %llu invalidations, %llu refreshed, %llu port-write events",
+			(unsigned long long)ps_stats.age_ns / 1000000,
+			ps_stats.stale_ports,
+			(unsigned long long)ps_stats.hits,
+			(unsigned long long)ps_stats.misses,
+			(unsigned long long)ps_stats.invalidations,
+			(unsigned long long)ps_stats.refreshes,
+			(unsigned long long)ps_stats.pw_events);
+	}
 	LOGMSG(env, "\nPhysLink TO: %8.1f microseconds..",
 			((float )(h->st.pc.lrto)) / 10.0);
 	LOGMSG(env, "\nLogResp  TO: %8.1f microseconds..",
@@ -37,6 +37,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
 
 #include "rio_route.h"
 #include "tok_parse.h"
@@ -44,6 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ct.h"
 #include "fmd.h"
 #include "fmd_dev_rw_cli.h"
+#include "fmd_reg_dump.h"
 #include "liblog.h"
 #include "libcli.h"
 #include "riocp_pe_internal.h"
@@ -64,7 +68,7 @@ void set_prompt(struct cli_env *e)
 	ct_t comptag = 0;
 	const char *name = NULL;
 	uint16_t pe_did = 0;
-	struct cfg_dev cfg_dev;
+	const struct cfg_dev *cfg_dev;
 
 	if (NULL == e) {
 		return;
@@ -85,7 +89,7 @@ void set_prompt(struct cli_env *e)
 	if (cfg_find_dev_by_ct(comptag, &cfg_dev)) {
 		name = riocp_pe_handle_get_device_str(pe_h);
 	} else {
-		name = (char *)cfg_dev.name;
+		name = cfg_dev->name;
 	}
 
 	snprintf(e->prompt, PROMPTLEN,  "%s.%03x >", name, pe_did);
@@ -811,6 +815,446 @@ CLIRegDumpCmd,
 ATTR_RPT
 };
 
+/* Register dumps
+ *
+ * Dumps are read with block maintenance reads, and several devices are
+ * dumped at once by a pool of threads.
+ */
+#define RDUMP_DFLT_BYTES 0x10000
+#define RDUMP_MAX_RNGS 8
+#define RDUMP_WORKERS 4
+
+struct rdump_job {
+	riocp_pe_handle pe;
+	char fn[FMD_MAX_NAME * 4];
+	uint32_t num_rngs;
+	uint32_t *rng;		// Pairs of address and number of bytes
+	uint32_t regs;
+	uint32_t fails;
+	int rc;
+	uint64_t ns;
+};
+
+struct rdump_pool {
+	struct rdump_job *jobs;
+	uint32_t cnt;
+	uint32_t next;
+};
+
+static uint64_t rdump_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+static void rdump_dev(struct rdump_job *job)
+{
+	struct fmd_rdump d;
+	uint64_t start = rdump_now_ns();
+	uint32_t i;
+
+	fmd_rdump_init(&d, job->pe);
+	job->rc = 0;
+	for (i = 0; (i < job->num_rngs) && !job->rc; i++) {
+		job->rc = fmd_rdump_read(&d, job->pe, job->rng[2 * i],
+							job->rng[(2 * i) + 1]);
+	}
+
+	if (!job->rc) {
+		job->rc = fmd_rdump_save(&d, job->fn);
+	}
+
+	job->regs = d.hdr.num_regs;
+	job->fails = 0;
+	for (i = 0; i < d.hdr.num_rngs; i++) {
+		if (d.rngs[i].rc) {
+			job->fails += d.rngs[i].cnt;
+		}
+	}
+	fmd_rdump_free(&d);
+	job->ns = rdump_now_ns() - start;
+}
+
+static void *rdump_worker(void *pool_p)
+{
+	struct rdump_pool *pool = (struct rdump_pool *)pool_p;
+	uint32_t i;
+
+	while (true) {
+		i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED);
+		if (i >= pool->cnt) {
+			break;
+		}
+		rdump_dev(&pool->jobs[i]);
+	}
+	return NULL;
+}
+
+// Returns true if pe is selected by tok, which is "all", "sw", a device
+// name or a component tag.
+static bool rdump_match(riocp_pe_handle pe, char *tok)
+{
+	ct_t comptag;
+
+	if (!strcmp(tok, "all")) {
+		return true;
+	}
+	if (!strcmp(tok, "sw")) {
+		return RIOCP_PE_IS_SWITCH(pe->cap);
+	}
+	if (!strcmp(pe->sysfs_name, tok)) {
+		return true;
+	}
+	return !tok_parse_ct(tok, &comptag, 0) && (comptag == pe->comptag);
+}
+
+static int rdump_save(struct cli_env *env, int argc, char **argv)
+{
+	riocp_pe_handle *pes = NULL;
+	struct rdump_job *jobs = NULL;
+	struct rdump_pool pool;
+	pthread_t thr[RDUMP_WORKERS];
+	bool thr_ok[RDUMP_WORKERS];
+	uint32_t rng[2 * RDUMP_MAX_RNGS];
+	uint32_t num_rngs, num_thr, i, t;
+	size_t pes_count = 0, p;
+	bool multi;
+	uint64_t start;
+	int rc;
+
+	if (argc < 2) {
+		LOGMSG(env, "\nEnter <dev> and <file>\n");
+		goto exit;
+	}
+
+	if ((argc - 2) % 2) {
+		LOGMSG(env, "\nEnter <address> and <numbytes> pairs\n");
+		goto exit;
+	}
+
+	num_rngs = (argc - 2) / 2;
+	if (num_rngs > RDUMP_MAX_RNGS) {
+		LOGMSG(env, "\nAt most %d ranges can be dumped\n",
+				RDUMP_MAX_RNGS);
+		goto exit;
+	}
+
+	for (i = 0; i < num_rngs; i++) {
+		if (tok_parse_ul(argv[2 + (2 * i)], &rng[2 * i], 0)) {
+			LOGMSG(env, "\n");
+			LOGMSG(env, TOK_ERR_UL_HEX_MSG_FMT, "<address>");
+			goto exit;
+		}
+		if (tok_parse_ul(argv[3 + (2 * i)], &rng[(2 * i) + 1], 0)) {
+			LOGMSG(env, "\n");
+			LOGMSG(env, TOK_ERR_UL_HEX_MSG_FMT, "<numbytes>");
+			goto exit;
+		}
+	}
+	if (!num_rngs) {
+		rng[0] = 0;
+		rng[1] = RDUMP_DFLT_BYTES;
+		num_rngs = 1;
+	}
+
+	rc = riocp_mport_get_pe_list(mport_pe, &pes_count, &pes);
+	if (rc) {
+		LOGMSG(env, "\nCould not get PE list\n");
+		goto exit;
+	}
+
+	jobs = (struct rdump_job *)calloc(pes_count ? pes_count : 1,
+						sizeof(struct rdump_job));
+	if (NULL == jobs) {
+		LOGMSG(env, "\nOut of memory\n");
+		goto exit;
+	}
+
+	// Several devices are dumped to <file>.<device name>
+	multi = !strcmp(argv[0], "all") || !strcmp(argv[0], "sw");
+	pool.jobs = jobs;
+	pool.cnt = 0;
+	pool.next = 0;
+	for (p = 0; p < pes_count; p++) {
+		if (!rdump_match(pes[p], argv[0])) {
+			continue;
+		}
+		jobs[pool.cnt].pe = pes[p];
+		jobs[pool.cnt].num_rngs = num_rngs;
+		jobs[pool.cnt].rng = rng;
+		if (multi) {
+			snprintf(jobs[pool.cnt].fn, sizeof(jobs[0].fn), "%s.%s",
+					argv[1], pes[p]->sysfs_name);
+		} else {
+			SAFE_STRNCPY(jobs[pool.cnt].fn, argv[1],
+							sizeof(jobs[0].fn));
+		}
+		pool.cnt++;
+		if (!multi) {
+			break;
+		}
+	}
+
+	if (!pool.cnt) {
+		LOGMSG(env, "\nNo device matches \"%s\"\n", argv[0]);
+		goto exit;
+	}
+
+	start = rdump_now_ns();
+	num_thr = (pool.cnt < RDUMP_WORKERS) ? pool.cnt : RDUMP_WORKERS;
+	for (t = 0; t < num_thr; t++) {
+		thr_ok[t] = !pthread_create(&thr[t], NULL, rdump_worker, &pool);
+	}
+	// Dump any devices the workers did not
+	rdump_worker(&pool);
+	for (t = 0; t < num_thr; t++) {
+		if (thr_ok[t]) {
+			pthread_join(thr[t], NULL);
+		}
+	}
+
+	LOGMSG(env, "\nDevice           Comptag    Registers Failed   msec File\n");
+	for (i = 0; i < pool.cnt; i++) {
+		LOGMSG(env, "%-16s 0x%08x %9u %6u %6llu %s",
+				jobs[i].pe->sysfs_name, jobs[i].pe->comptag,
+				jobs[i].regs, jobs[i].fails,
+				(unsigned long long)(jobs[i].ns / 1000000),
+				jobs[i].fn);
+		if (jobs[i].rc > 0) {
+			LOGMSG(env, " FAILED: %s", strerror(jobs[i].rc));
+		} else if (jobs[i].rc) {
+			LOGMSG(env, " FAILED: invalid range");
+		}
+		LOGMSG(env, "\n");
+	}
+	LOGMSG(env, "Elapsed %llu msec\n",
+		(unsigned long long)((rdump_now_ns() - start) / 1000000));
+
+exit:
+	free(jobs);
+	if (NULL != pes) {
+		rc = riocp_mport_free_pe_list(&pes);
+		if (rc) {
+			LOGMSG(env, "\nFailed freeing PE list %d\n", rc);
+		}
+	}
+	return 0;
+}
+
+// Runs of registers present in only one dump are displayed as one line
+struct rdump_diff_ctx {
+	struct cli_env *env;
+	uint32_t run_start;
+	uint32_t run_cnt;
+	bool run_a;
+};
+
+static void rdump_diff_flush(struct rdump_diff_ctx *ctx)
+{
+	if (ctx->run_cnt) {
+		LOGMSG(ctx->env, "0x%08x   %u registers only in %s\n",
+				ctx->run_start, ctx->run_cnt,
+				ctx->run_a ? "first" : "second");
+	}
+	ctx->run_cnt = 0;
+}
+
+static void rdump_diff_line(void *ctx_p, uint32_t offset, uint32_t *a,
+		uint32_t *b)
+{
+	struct rdump_diff_ctx *ctx = (struct rdump_diff_ctx *)ctx_p;
+
+	if ((NULL != a) && (NULL != b)) {
+		rdump_diff_flush(ctx);
+		LOGMSG(ctx->env, "0x%08x   0x%08x  0x%08x\n", offset, *a, *b);
+		return;
+	}
+
+	if (ctx->run_cnt && (ctx->run_a == (NULL != a)) && (offset ==
+				ctx->run_start + (4 * ctx->run_cnt))) {
+		ctx->run_cnt++;
+		return;
+	}
+	rdump_diff_flush(ctx);
+	ctx->run_start = offset;
+	ctx->run_cnt = 1;
+	ctx->run_a = (NULL != a);
+}
+
+static int rdump_diff(struct cli_env *env, int argc, char **argv)
+{
+	riocp_pe_handle *pes = NULL;
+	riocp_pe_handle pe = NULL;
+	struct fmd_rdump a, b;
+	struct rdump_diff_ctx ctx;
+	size_t pes_count = 0, p;
+	uint32_t diffs;
+	int rc;
+
+	fmd_rdump_init(&a, NULL);
+	fmd_rdump_init(&b, NULL);
+
+	if (argc < 1) {
+		LOGMSG(env, "\nEnter <file>\n");
+		goto exit;
+	}
+
+	rc = fmd_rdump_load(&a, argv[0]);
+	if (rc) {
+		LOGMSG(env, "\nCannot load %s: %s\n", argv[0], strerror(rc));
+		goto exit;
+	}
+
+	if (argc > 1) {
+		rc = fmd_rdump_load(&b, argv[1]);
+		if (rc) {
+			LOGMSG(env, "\nCannot load %s: %s\n", argv[1],
+					strerror(rc));
+			goto exit;
+		}
+	} else {
+		// Compare with the device which was dumped
+		rc = riocp_mport_get_pe_list(mport_pe, &pes_count, &pes);
+		if (rc) {
+			LOGMSG(env, "\nCould not get PE list\n");
+			goto exit;
+		}
+		for (p = 0; p < pes_count; p++) {
+			if (pes[p]->comptag == a.hdr.comptag) {
+				pe = pes[p];
+				break;
+			}
+		}
+		if (NULL == pe) {
+			LOGMSG(env, "\nNo device has CT 0x%08x\n",
+					a.hdr.comptag);
+			goto exit;
+		}
+		fmd_rdump_init(&b, pe);
+		if (fmd_rdump_read_as(&b, pe, &a)) {
+			LOGMSG(env, "\nCould not read %s\n", pe->sysfs_name);
+			goto exit;
+		}
+	}
+
+	if (a.hdr.dev_id != b.hdr.dev_id) {
+		LOGMSG(env, "\nWARNING: Device identity 0x%08x != 0x%08x\n",
+				a.hdr.dev_id, b.hdr.dev_id);
+	}
+
+	LOGMSG(env, "\nAddress     %-10s    %-10s\n", "First",
+			(NULL == pe) ? "Second" : pe->sysfs_name);
+	ctx.env = env;
+	ctx.run_cnt = 0;
+	diffs = fmd_rdump_diff(&a, &b, rdump_diff_line, &ctx);
+	rdump_diff_flush(&ctx);
+	LOGMSG(env, "%u registers differ\n", diffs);
+
+exit:
+	fmd_rdump_free(&a);
+	fmd_rdump_free(&b);
+	if (NULL != pes) {
+		rc = riocp_mport_free_pe_list(&pes);
+		if (rc) {
+			LOGMSG(env, "\nFailed freeing PE list %d\n", rc);
+		}
+	}
+	return 0;
+}
+
+static int rdump_show(struct cli_env *env, int argc, char **argv)
+{
+	struct fmd_rdump d;
+	struct fmd_rdump_rng *rng;
+	time_t when;
+	uint32_t r, i, offset, pad;
+	int rc;
+
+	fmd_rdump_init(&d, NULL);
+
+	if (argc < 1) {
+		LOGMSG(env, "\nEnter <file>\n");
+		goto exit;
+	}
+
+	rc = fmd_rdump_load(&d, argv[0]);
+	if (rc) {
+		LOGMSG(env, "\nCannot load %s: %s\n", argv[0], strerror(rc));
+		goto exit;
+	}
+
+	when = (time_t)d.hdr.time;
+	LOGMSG(env, "\nCT 0x%08x Device identity 0x%08x %s",
+			d.hdr.comptag, d.hdr.dev_id, ctime(&when));
+	LOGMSG(env, "Address  00____03 04____07 08____0B 0C____0F");
+
+	for (r = 0; r < d.hdr.num_rngs; r++) {
+		rng = &d.rngs[r];
+		if (rng->rc) {
+			LOGMSG(env, "\n%8x %u registers FAILED, rc 0x%08x",
+					rng->offset, rng->cnt, rng->rc);
+			continue;
+		}
+		for (i = 0; i < rng->cnt; i++) {
+			offset = rng->offset + (4 * i);
+			if (!i || !(offset & 0xF)) {
+				LOGMSG(env, "\n%8x", offset & 0xFFFFFFF0);
+			}
+			for (pad = 0; !i && (pad < (offset & 0xF)); pad += 4) {
+				LOGMSG(env, "         ");
+			}
+			LOGMSG(env, " %08x", d.data[rng->idx + i]);
+		}
+	}
+	LOGMSG(env, "\n");
+
+exit:
+	fmd_rdump_free(&d);
+	return 0;
+}
+
+int CLIRegDumpFileCmd(struct cli_env *env, int argc, char **argv)
+{
+	const char *ops = "save diff show";
+
+	switch (parm_idx(argv[0], (char *)ops)) {
+	case 0:
+		return rdump_save(env, argc - 1, &argv[1]);
+	case 1:
+		return rdump_diff(env, argc - 1, &argv[1]);
+	case 2:
+		return rdump_show(env, argc - 1, &argv[1]);
+	default:
+		LOGMSG(env, "\nUnknown operation \"%s\", use %s\n", argv[0],
+				ops);
+	}
+	return 0;
+}
+
+struct cli_cmd CLIRegDumpFile = {
+(char *)"rdump",
+2,
+1,
+(char *)"save, compare and display register dump files",
+(char *)"<op> <parms>\n"
+	"save <dev> <file> {<address> <numbytes>}...\n"
+	"     Dump registers of <dev> to <file> with block reads.\n"
+	"     <dev> is a device name or component tag, \"sw\" for all\n"
+	"     switches or \"all\" for all devices.  Several devices are\n"
+	"     dumped in parallel, each to <file>.<device name>.\n"
+	"     Up to 8 <address> <numbytes> ranges may be given.\n"
+	"     Default is address 0, numbytes 0x10000.\n"
+	"diff <file> {<file2>}\n"
+	"     Display registers which differ between <file> and <file2>,\n"
+	"     or between <file> and the device which was dumped.\n"
+	"show <file>\n"
+	"     Display the registers in <file>.\n",
+CLIRegDumpFileCmd,
+ATTR_NONE
+};
+
 int CLIMRegReadCmd(struct cli_env *env, int argc, char **argv)
 {
 	int errorStat = 0;
@@ -1132,6 +1576,7 @@ struct cli_cmd *reg_cmd_list[] = {
 &CLIRegExpect,
 &CLIRegExpectNot,
 &CLIRegDump,
+&CLIRegDumpFile,
 &CLIMRegRead,
 &CLIMRegWrite,
 &CLIDevSel,
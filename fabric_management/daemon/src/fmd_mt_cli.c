@@ -0,0 +1,321 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "liblog.h"
+#include "libcli.h"
+#include "tok_parse.h"
+#include "rio_route.h"
+#include "fmd_mt.h"
+#include "fmd_mt_cli.h"
+#include "pe_mpdrv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MT_OPS "on off clear dev hist"
+#define MT_OP_ON 0
+#define MT_OP_OFF 1
+#define MT_OP_CLR 2
+#define MT_OP_DEV 3
+#define MT_OP_HIST 4
+
+static const char *mt_dir_names[fmd_mt_dir_max] = {"Read", "Write"};
+
+static uint64_t mt_elapsed_ns(struct fmd_mt *mt)
+{
+	struct timespec ts;
+	uint64_t now;
+
+	if (!mt->on) {
+		return mt->run_ns;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	now = ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+	return mt->run_ns + now - mt->start_ns;
+}
+
+// Prints the average latency in usec with one decimal place.
+static void mt_print_avg(struct cli_env *env, struct fmd_mt_ctr *ctr)
+{
+	uint64_t avg;
+
+	if (!ctr->cnt) {
+		LOGMSG(env, "       -");
+		return;
+	}
+	avg = ctr->lat_ns / ctr->cnt;
+	LOGMSG(env, " %5llu.%1llu", (unsigned long long)avg / 1000,
+			(unsigned long long)(avg % 1000) / 100);
+}
+
+static void mt_print_ctr(struct cli_env *env, const char *label,
+		struct fmd_mt_ctr *ctr)
+{
+	LOGMSG(env, "%-6s %12llu %12llu %8llu %8llu", label,
+			(unsigned long long)ctr->cnt,
+			(unsigned long long)ctr->regs,
+			(unsigned long long)ctr->fails,
+			(unsigned long long)ctr->retries);
+	mt_print_avg(env, ctr);
+	LOGMSG(env, " %8llu\n", (unsigned long long)ctr->max_ns / 1000);
+}
+
+#define MT_CTR_HDR "       Transactions    Registers    Fails  Retries" \
+		"   Avg us   Max us\n"
+
+static void mt_show_totals(struct cli_env *env, struct fmd_mt *mt)
+{
+	struct fmd_mt_ctr tot[fmd_mt_dir_max];
+	char label[8];
+	uint64_t ns = mt_elapsed_ns(mt);
+	uint32_t hc, dir;
+
+	memset(tot, 0, sizeof(tot));
+	for (hc = 0; hc <= FMD_MT_MAX_HC; hc++) {
+		for (dir = 0; dir < fmd_mt_dir_max; dir++) {
+			fmd_mt_add(&tot[dir], &mt->hc[hc][dir]);
+		}
+	}
+
+	LOGMSG(env, "\nCounting %s, %llu.%03llu sec counted, %u devices\n\n",
+			mt->on ? "on" : "off",
+			(unsigned long long)ns / 1000000000,
+			(unsigned long long)(ns / 1000000) % 1000,
+			mt->num_devs);
+	LOGMSG(env, MT_CTR_HDR);
+	for (dir = 0; dir < fmd_mt_dir_max; dir++) {
+		mt_print_ctr(env, mt_dir_names[dir], &tot[dir]);
+	}
+
+	LOGMSG(env, "\nHops   Dir   Transactions    Registers    Fails  Retries"
+			"   Avg us   Max us\n");
+	for (hc = 0; hc <= FMD_MT_MAX_HC; hc++) {
+		if (FMD_MT_LCL == hc) {
+			snprintf(label, sizeof(label), "Local");
+		} else if ((FMD_MT_MAX_HC - 1) == hc) {
+			snprintf(label, sizeof(label), ">=%u", hc);
+		} else {
+			snprintf(label, sizeof(label), "%u", hc);
+		}
+		for (dir = 0; dir < fmd_mt_dir_max; dir++) {
+			if (!mt->hc[hc][dir].cnt) {
+				continue;
+			}
+			LOGMSG(env, "%-6s ", label);
+			mt_print_ctr(env, mt_dir_names[dir], &mt->hc[hc][dir]);
+		}
+	}
+}
+
+static void mt_show_devs(struct cli_env *env, struct fmd_mt *mt)
+{
+	struct fmd_mt_dev *dev;
+	uint32_t i;
+
+	LOGMSG(env, "\nDevice           CompTag    Hops       Reads  Fails"
+			"   Avg us      Writes  Fails   Avg us\n");
+	for (i = 0; (i < mt->num_devs) && (i < FMD_MAX_DEVS); i++) {
+		dev = &mt->devs[i];
+		LOGMSG(env, "%-16s 0x%08x ", dev->name, dev->ct);
+		if (HC_MP == dev->hc) {
+			LOGMSG(env, "Local");
+		} else {
+			LOGMSG(env, "%5u", dev->hc);
+		}
+		LOGMSG(env, " %11llu %6llu",
+			(unsigned long long)dev->ctr[fmd_mt_rd].cnt,
+			(unsigned long long)dev->ctr[fmd_mt_rd].fails);
+		mt_print_avg(env, &dev->ctr[fmd_mt_rd]);
+		LOGMSG(env, " %11llu %6llu",
+			(unsigned long long)dev->ctr[fmd_mt_wr].cnt,
+			(unsigned long long)dev->ctr[fmd_mt_wr].fails);
+		mt_print_avg(env, &dev->ctr[fmd_mt_wr]);
+		LOGMSG(env, "\n");
+	}
+	if (!mt->num_devs) {
+		LOGMSG(env, "No devices have been accessed while counting.\n");
+	}
+}
+
+// Finds a device by name or component tag.
+static struct fmd_mt_dev *mt_find_dev(struct fmd_mt *mt, char *tok)
+{
+	uint32_t ct;
+	uint32_t i;
+	bool by_ct;
+
+	by_ct = !tok_parse_ulong(tok, &ct, 0, 0xFFFFFFFF, 0);
+	for (i = 0; (i < mt->num_devs) && (i < FMD_MAX_DEVS); i++) {
+		if (!strncmp(mt->devs[i].name, tok, FMD_MAX_NAME)
+				|| (by_ct && (mt->devs[i].ct == ct))) {
+			return &mt->devs[i];
+		}
+	}
+	return NULL;
+}
+
+static void mt_show_hist(struct cli_env *env, struct fmd_mt *mt,
+		struct fmd_mt_dev *dev)
+{
+	struct fmd_mt_ctr tot[fmd_mt_dir_max];
+	struct fmd_mt_ctr *ctr;
+	char label[16];
+	uint32_t hc, dir, b;
+
+	if (NULL == dev) {
+		memset(tot, 0, sizeof(tot));
+		for (hc = 0; hc <= FMD_MT_MAX_HC; hc++) {
+			for (dir = 0; dir < fmd_mt_dir_max; dir++) {
+				fmd_mt_add(&tot[dir], &mt->hc[hc][dir]);
+			}
+		}
+		ctr = tot;
+		LOGMSG(env, "\nLatency of all transactions\n");
+	} else {
+		ctr = dev->ctr;
+		LOGMSG(env, "\nLatency of transactions to %s\n", dev->name);
+	}
+
+	LOGMSG(env, "\nLatency us        Reads       Writes\n");
+	for (b = 0; b < FMD_MT_HIST_BKTS; b++) {
+		if ((FMD_MT_HIST_BKTS - 1) == b) {
+			snprintf(label, sizeof(label), ">=%u", 1 << (b - 1));
+		} else {
+			snprintf(label, sizeof(label), "<%u", 1 << b);
+		}
+		LOGMSG(env, "%-10s %12llu %12llu\n", label,
+			(unsigned long long)ctr[fmd_mt_rd].hist[b],
+			(unsigned long long)ctr[fmd_mt_wr].hist[b]);
+	}
+}
+
+int CLIMtStatCmd(struct cli_env *env, int argc, char **argv)
+{
+	struct fmd_mt *mt = NULL;
+	struct fmd_mt_dev *dev = NULL;
+	uint32_t op = MT_OP_HIST + 1;
+
+	if (argc > 0) {
+		op = parm_idx(argv[0], (char *)MT_OPS);
+		switch (op) {
+		case MT_OP_ON:
+			mpsw_mt_enable(true);
+			break;
+		case MT_OP_OFF:
+			mpsw_mt_enable(false);
+			break;
+		case MT_OP_CLR:
+			mpsw_mt_clear();
+			break;
+		case MT_OP_DEV:
+		case MT_OP_HIST:
+			break;
+		default:
+			LOGMSG(env, "\nOperation must be one of %s\n", MT_OPS);
+			goto exit;
+		}
+	}
+
+	// Counters keep changing, so display a copy of them.
+	mt = (struct fmd_mt *)malloc(sizeof(*mt));
+	if (NULL == mt) {
+		LOGMSG(env, "\nOut of memory\n");
+		goto exit;
+	}
+	memcpy(mt, mpsw_mt_get(), sizeof(*mt));
+
+	switch (op) {
+	case MT_OP_DEV:
+		mt_show_devs(env, mt);
+		break;
+	case MT_OP_HIST:
+		if (argc > 1) {
+			dev = mt_find_dev(mt, argv[1]);
+			if (NULL == dev) {
+				LOGMSG(env, "\nNo transactions to %s counted\n",
+								argv[1]);
+				goto exit;
+			}
+		}
+		mt_show_hist(env, mt, dev);
+		break;
+	default:
+		mt_show_totals(env, mt);
+		break;
+	}
+exit:
+	free(mt);
+	return 0;
+}
+
+struct cli_cmd CLIMtStat = {
+(char *)"mtstat",
+3,
+0,
+(char *)"maintenance transaction counts and latency",
+(char *)"{<op> {<dev>}}\n"
+	"Display counts of the maintenance transactions performed by the FMD,\n"
+	"by hop count.  Local counts accesses to mport registers.\n"
+	"<op> optional, one of " MT_OPS ".\n"
+	"     on, off: start or stop counting, then display the counts.\n"
+	"     clear: zero all counts, then display them.\n"
+	"     dev: display the counts of each device accessed.\n"
+	"     hist: display the latency histogram of all transactions.\n"
+	"<dev> optional for hist, the name or component tag of a device.\n"
+	"     Display the latency histogram of that device only.\n"
+	"A retry is a transaction which repeats the last failed transaction of\n"
+	"the same thread.  Counting is started at startup by FMD option -e.\n",
+CLIMtStatCmd,
+ATTR_NONE
+};
+
+struct cli_cmd *mt_cmd_list[] = {
+&CLIMtStat
+};
+
+void fmd_bind_mt_cmds(void)
+{
+	add_commands_to_cmd_db(sizeof(mt_cmd_list)/
+			sizeof(struct cli_cmd *), mt_cmd_list);
+}
+
+#ifdef __cplusplus
+}
+#endif
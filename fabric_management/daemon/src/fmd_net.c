@@ -58,21 +58,21 @@ struct fmd_no_cfg {
 	rio_port_t pnum;
 };
 
-int fmd_traverse_network(riocp_pe_handle mport_pe, struct cfg_dev *c_dev)
+int fmd_traverse_network(riocp_pe_handle mport_pe, const struct cfg_dev *c_dev)
 {
 	return fmd_traverse_network_from_pe_port(mport_pe, RIO_ANY_PORT, c_dev);
 }
 
 int fmd_traverse_network_from_pe_port(riocp_pe_handle pe, rio_port_t port_num,
-		struct cfg_dev *c_dev)
+		const struct cfg_dev *c_dev)
 {
 	struct l_head_t sw_list;
 
 	riocp_pe_handle new_pe, curr_pe;
 	rio_port_t port_st, port_cnt, pnum;
 	int conn_pt, rc;
-	ct_t comptag;
-	struct cfg_dev curr_dev, conn_dev;
+	ct_t comptag, conn_ct;
+	const struct cfg_dev *curr_dev, *conn_dev;
 
 	struct l_head_t no_cfg_list;
 	struct fmd_no_cfg *no_cfg;
@@ -82,7 +82,7 @@ int fmd_traverse_network_from_pe_port(riocp_pe_handle pe, rio_port_t port_num,
 
 	/* Enumerated device connected to master port */
 	curr_pe = pe;
-	curr_dev = *c_dev;
+	curr_dev = c_dev;
 
 	if (RIO_ANY_PORT == port_num) {
 		port_st = 0;
@@ -117,8 +117,9 @@ int fmd_traverse_network_from_pe_port(riocp_pe_handle pe, rio_port_t port_num,
 				//@sonar:on
 			}
 
+			conn_ct = conn_dev->ct;
 			rc = riocp_pe_probe(curr_pe, pnum, &new_pe,
-					&conn_dev.ct, (char *)conn_dev.name,
+					&conn_ct, (char *)conn_dev->name,
 					true);
 
 			if (rc) {
@@ -130,7 +131,7 @@ int fmd_traverse_network_from_pe_port(riocp_pe_handle pe, rio_port_t port_num,
 				}
 				HIGH("PE 0x%x Port %d NO DEVICE, expected %x\n",
 						curr_pe->comptag, pnum,
-						conn_dev.ct);
+						conn_ct);
 				continue;
 			}
 
@@ -153,10 +154,10 @@ int fmd_traverse_network_from_pe_port(riocp_pe_handle pe, rio_port_t port_num,
 				goto fail;
 			}
 
-			if (comptag != conn_dev.ct) {
+			if (comptag != conn_ct) {
 				DBG(
 						"Probed ep ct 0x%x != 0x%x config ct port %d\n",
-						comptag, conn_dev.ct, pnum);
+						comptag, conn_ct, pnum);
 				goto fail;
 			}
 
@@ -57,6 +57,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "libcli.h"
 #include "liblog.h"
 #include "fmd_opts.h"
+#include "pe_mpdrv.h"
+#include "fmd_sc_smpl.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -69,10 +71,15 @@ void fmd_print_help(void)
 	printf("Options are:\n");
 	printf("-a, -A <port>: POSIX Ethernet socket for App connections.\n");
 	printf("       Default is %d\n", FMD_DFLT_APP_PORT_NUM);
+	printf("-b, -B: Log binary records instead of text, decode the\n");
+	printf("       log file with rdma_log_decode.\n");
 	printf("-c, -C <filename>: FMD configuration file name.\n");
 	printf("       Default is \"%s\"\n", FMD_DFLT_CFG_FN);
 	printf("-d, -D <filename>: Device directory Posix SM file name.\n");
 	printf("       Default is \"%s\"\n", FMD_DFLT_DD_FN);
+	printf("-e, -E: Count maintenance transactions from startup.\n");
+	printf("       Counts are published in \"%s\".\n", FMD_DFLT_MT_FN);
+	printf("       Default is %d\n", FMD_DFLT_MT_ACCT);
 	printf("-h, -H, -?: Print this message.\n");
 	printf("-i <interval>: Interval between Device Directory updates.\n");
 	printf("       Default is %d\n", FMD_DFLT_MAST_INTERVAL);
@@ -87,6 +94,20 @@ void fmd_print_help(void)
 	printf("       Default is %d\n", FMD_DFLT_CLI_SKT);
 	printf("-s, -S: Simple initialization, do not populate device dir.\n");
 	printf("       Default is %d\n", FMD_DFLT_INIT_DD);
+	printf("-t, -T <msec>: Statistics counter sampling period, 1 to %d.\n",
+			FMD_SC_MAX_PERIOD);
+	printf("       0 disables sampling.  Samples are published in \"%s\".\n",
+			FMD_DFLT_SC_FN);
+	printf("       Default is %d\n", FMD_DFLT_SC_PERIOD);
+	printf("-u, -U <msec>: Port status cache refresh period, 1 to %d.\n",
+			MPSW_PS_MAX_PERIOD);
+	printf("       0 disables the refresh, cached port status is then\n");
+	printf("       only updated by port-writes and port changes.\n");
+	printf("       Default is %d\n", FMD_DFLT_PS_PERIOD);
+	printf("-w, -W <workers>: Threads which initialize statistics counters\n");
+	printf("       and event reporting of devices during enumeration.\n");
+	printf("       0 initializes each device completely when found.\n");
+	printf("       Default is %d\n", FMD_DFLT_INIT_WORKERS);
 	printf("-x, -X: Initialize and then immediately exit.\n");
 }
 
@@ -111,16 +132,21 @@ struct fmd_opt_vals *fmd_parse_options(int argc, char *argv[])
 	opts->run_cons = 1;
 	opts->log_level = FMD_DFLT_LOG_LEVEL;
 	opts->log_disp_level = FMD_DFLT_LOG_LEVEL;
+	opts->log_bin = 0;
 	opts->mast_mode = 0;
 	opts->mast_interval = FMD_DFLT_MAST_INTERVAL;
 	opts->mast_did = (did_t){FMD_DFLT_MAST_DEVID, dev08_sz};
 	opts->mast_cm_port = FMD_DFLT_MAST_CM_PORT;
+	opts->init_workers = FMD_DFLT_INIT_WORKERS;
+	opts->sc_period = FMD_DFLT_SC_PERIOD;
+	opts->ps_period = FMD_DFLT_PS_PERIOD;
+	opts->mt_acct = FMD_DFLT_MT_ACCT;
 
 	if (update_string(&opts->fmd_cfg, dflt_fmd_cfg, strlen(dflt_fmd_cfg))) {
 		goto oom;
 	}
 
-	while (-1 != (c = getopt(argc, argv, "hH?nNsSxXa:A:c:C:d:D:i:I:l:L:m:M:p:P:"))) {
+	while (-1 != (c = getopt(argc, argv, "bBeEhH?nNsSxXa:A:c:C:d:D:i:I:l:L:m:M:p:P:t:T:u:U:w:W:"))) {
 		switch (c) {
 		case 'a':
 		case 'A':
@@ -129,6 +155,14 @@ struct fmd_opt_vals *fmd_parse_options(int argc, char *argv[])
 				exit(EXIT_FAILURE);
 			}
 			break;
+		case 'b':
+		case 'B':
+			opts->log_bin = 1;
+			break;
+		case 'e':
+		case 'E':
+			opts->mt_acct = 1;
+			break;
 		case 'c':
 		case 'C':
 			if (get_v_str(&opts->fmd_cfg, optarg, 0)) {
@@ -192,6 +226,33 @@ struct fmd_opt_vals *fmd_parse_options(int argc, char *argv[])
 		case 'S':
 			opts->simple_init = 1;
 			break;
+		case 't':
+		case 'T':
+			if (tok_parse_ulong(optarg, &opts->sc_period, 0,
+					FMD_SC_MAX_PERIOD, 0)) {
+				printf(TOK_ERR_ULONG_MSG_FMT, "Sampling period", 0,
+						FMD_SC_MAX_PERIOD);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'u':
+		case 'U':
+			if (tok_parse_ulong(optarg, &opts->ps_period, 0,
+					MPSW_PS_MAX_PERIOD, 0)) {
+				printf(TOK_ERR_ULONG_MSG_FMT, "Refresh period", 0,
+						MPSW_PS_MAX_PERIOD);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'w':
+		case 'W':
+			if (tok_parse_ulong(optarg, &opts->init_workers, 0,
+					MPSW_INIT_MAX_WORKERS, 0)) {
+				printf(TOK_ERR_ULONG_MSG_FMT, "Init workers", 0,
+						MPSW_INIT_MAX_WORKERS);
+				exit(EXIT_FAILURE);
+			}
+			break;
 		case 'x':
 		case 'X':
 			opts->init_and_quit = 1;
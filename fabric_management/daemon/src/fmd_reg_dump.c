@@ -0,0 +1,400 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "rio_standard.h"
+#include "RapidIO_Device_Access_Routines_API.h"
+#include "riocp_pe_internal.h"
+#include "pe_mpdrv_private.h"
+#include "fmd_reg_dump.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FMD_RDUMP_RNG_WORDS 3
+
+void fmd_rdump_init(struct fmd_rdump *d, riocp_pe_handle pe)
+{
+	memset(d, 0, sizeof(*d));
+	d->hdr.magic = FMD_RDUMP_MAGIC;
+	d->hdr.version = FMD_RDUMP_VER;
+	d->hdr.time = (uint64_t)time(NULL);
+	if (NULL != pe) {
+		d->hdr.comptag = pe->comptag;
+		d->hdr.dev_id = pe->cap.dev_id;
+	}
+}
+
+void fmd_rdump_free(struct fmd_rdump *d)
+{
+	free(d->rngs);
+	free(d->data);
+	d->rngs = NULL;
+	d->data = NULL;
+	d->rngs_max = 0;
+	d->data_max = 0;
+	d->hdr.num_rngs = 0;
+	d->hdr.num_regs = 0;
+}
+
+static int fmd_rdump_grow(struct fmd_rdump *d, uint32_t rngs, uint32_t regs)
+{
+	uint32_t max;
+	void *p;
+
+	if (d->hdr.num_rngs + rngs > d->rngs_max) {
+		max = d->rngs_max ? d->rngs_max * 2 : 16;
+		while (max < d->hdr.num_rngs + rngs) {
+			max *= 2;
+		}
+		p = realloc(d->rngs, max * sizeof(struct fmd_rdump_rng));
+		if (NULL == p) {
+			return -1;
+		}
+		d->rngs = (struct fmd_rdump_rng *)p;
+		d->rngs_max = max;
+	}
+
+	if (d->hdr.num_regs + regs > d->data_max) {
+		max = d->data_max ? d->data_max * 2 : 1024;
+		while (max < d->hdr.num_regs + regs) {
+			max *= 2;
+		}
+		p = realloc(d->data, max * sizeof(uint32_t));
+		if (NULL == p) {
+			return -1;
+		}
+		d->data = (uint32_t *)p;
+		d->data_max = max;
+	}
+	return 0;
+}
+
+/* Adds cnt registers at offset, with values vals if rc is 0.  Registers
+ * which follow the last range, with the same rc, extend that range.
+ */
+static int fmd_rdump_add(struct fmd_rdump *d, uint32_t offset, uint32_t cnt,
+		uint32_t rc, uint32_t *vals)
+{
+	struct fmd_rdump_rng *rng;
+
+	if (fmd_rdump_grow(d, 1, rc ? 0 : cnt)) {
+		return -1;
+	}
+
+	rng = d->hdr.num_rngs ? &d->rngs[d->hdr.num_rngs - 1] : NULL;
+	if ((NULL == rng) || (rng->rc != rc)
+			|| ((rng->offset + (4 * rng->cnt)) != offset)) {
+		rng = &d->rngs[d->hdr.num_rngs++];
+		rng->offset = offset;
+		rng->cnt = 0;
+		rng->rc = rc;
+		rng->idx = d->hdr.num_regs;
+	}
+
+	rng->cnt += cnt;
+	if (!rc) {
+		memcpy(&d->data[d->hdr.num_regs], vals, cnt * sizeof(uint32_t));
+		d->hdr.num_regs += cnt;
+	}
+	return 0;
+}
+
+int fmd_rdump_read(struct fmd_rdump *d, riocp_pe_handle pe, uint32_t offset,
+		uint32_t bytes)
+{
+	struct mpsw_drv_private_data *priv = NULL;
+	uint32_t buf[FMD_RDUMP_BLK];
+	uint32_t end, cnt, i, rc;
+
+	if ((NULL == pe) || !bytes || (bytes > FMD_RDUMP_MAX_OFS)) {
+		return -1;
+	}
+
+	offset &= ~3;
+	bytes = (bytes + 3) & ~3;
+	if ((offset >= FMD_RDUMP_MAX_OFS)
+			|| (bytes > (FMD_RDUMP_MAX_OFS - offset))) {
+		return -1;
+	}
+
+	if (riocp_pe_handle_get_private(pe, (void **)&priv)) {
+		return -1;
+	}
+	mpsw_init_sync(pe);
+
+	end = offset + bytes;
+	while (offset < end) {
+		cnt = (end - offset) / 4;
+		if (cnt > FMD_RDUMP_BLK) {
+			cnt = FMD_RDUMP_BLK;
+		}
+
+		rc = DARRegReadBlock(&priv->dev_h, offset, cnt, buf);
+		if (RIO_SUCCESS == rc) {
+			if (fmd_rdump_add(d, offset, cnt, 0, buf)) {
+				return -1;
+			}
+			offset += 4 * cnt;
+			continue;
+		}
+
+		// Find the registers in the block which cannot be read
+		for (i = 0; i < cnt; i++) {
+			rc = DARRegRead(&priv->dev_h, offset, &buf[0]);
+			if (fmd_rdump_add(d, offset, 1, rc, buf)) {
+				return -1;
+			}
+			offset += 4;
+		}
+	}
+	return 0;
+}
+
+int fmd_rdump_read_as(struct fmd_rdump *d, riocp_pe_handle pe,
+		struct fmd_rdump *ref)
+{
+	uint32_t i;
+
+	for (i = 0; i < ref->hdr.num_rngs; i++) {
+		if (ref->rngs[i].rc) {
+			continue;
+		}
+		if (fmd_rdump_read(d, pe, ref->rngs[i].offset,
+						4 * ref->rngs[i].cnt)) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/* Returns the range which holds offset, or NULL.  Ranges are usually
+ * searched in order, so the search starts from the last range found.
+ */
+static struct fmd_rdump_rng *fmd_rdump_find(struct fmd_rdump *d,
+		uint32_t offset, uint32_t *hint)
+{
+	struct fmd_rdump_rng *rng;
+	uint32_t i, n;
+
+	for (n = 0; n < d->hdr.num_rngs; n++) {
+		i = (*hint + n) % d->hdr.num_rngs;
+		rng = &d->rngs[i];
+		if ((offset >= rng->offset)
+				&& ((offset - rng->offset) < (4 * rng->cnt))) {
+			*hint = i;
+			return rng;
+		}
+	}
+	return NULL;
+}
+
+int fmd_rdump_get(struct fmd_rdump *d, uint32_t offset, uint32_t *val)
+{
+	struct fmd_rdump_rng *rng;
+	uint32_t hint = 0;
+
+	rng = fmd_rdump_find(d, offset, &hint);
+	if ((NULL == rng) || rng->rc) {
+		return -1;
+	}
+	*val = d->data[rng->idx + ((offset - rng->offset) / 4)];
+	return 0;
+}
+
+static uint32_t *fmd_rdump_val(struct fmd_rdump_rng *rng, uint32_t *data,
+		uint32_t offset)
+{
+	if ((NULL == rng) || rng->rc) {
+		return NULL;
+	}
+	return &data[rng->idx + ((offset - rng->offset) / 4)];
+}
+
+uint32_t fmd_rdump_diff(struct fmd_rdump *a, struct fmd_rdump *b,
+		fmd_rdump_diff_fn diff_fn, void *ctx)
+{
+	struct fmd_rdump_rng *rng;
+	uint32_t *va, *vb;
+	uint32_t i, r, offset;
+	uint32_t hint = 0;
+	uint32_t diffs = 0;
+
+	for (r = 0; r < a->hdr.num_rngs; r++) {
+		for (i = 0; i < a->rngs[r].cnt; i++) {
+			offset = a->rngs[r].offset + (4 * i);
+			va = fmd_rdump_val(&a->rngs[r], a->data, offset);
+			rng = fmd_rdump_find(b, offset, &hint);
+			vb = fmd_rdump_val(rng, b->data, offset);
+			if ((NULL == va) && (NULL == vb)) {
+				continue;
+			}
+			if ((NULL != va) && (NULL != vb) && (*va == *vb)) {
+				continue;
+			}
+			diff_fn(ctx, offset, va, vb);
+			diffs++;
+		}
+	}
+
+	// Registers read in b which are not in a at all
+	hint = 0;
+	for (r = 0; r < b->hdr.num_rngs; r++) {
+		if (b->rngs[r].rc) {
+			continue;
+		}
+		for (i = 0; i < b->rngs[r].cnt; i++) {
+			offset = b->rngs[r].offset + (4 * i);
+			if (NULL != fmd_rdump_find(a, offset, &hint)) {
+				continue;
+			}
+			diff_fn(ctx, offset, NULL,
+					&b->data[b->rngs[r].idx + i]);
+			diffs++;
+		}
+	}
+	return diffs;
+}
+
+int fmd_rdump_save(struct fmd_rdump *d, const char *fn)
+{
+	FILE *fp;
+	uint32_t rec[FMD_RDUMP_RNG_WORDS];
+	uint32_t i;
+	int rc = 0;
+
+	fp = fopen(fn, "wb");
+	if (NULL == fp) {
+		return errno;
+	}
+
+	if (1 != fwrite(&d->hdr, sizeof(d->hdr), 1, fp)) {
+		rc = errno;
+		goto close;
+	}
+
+	for (i = 0; i < d->hdr.num_rngs; i++) {
+		rec[0] = d->rngs[i].offset;
+		rec[1] = d->rngs[i].cnt;
+		rec[2] = d->rngs[i].rc;
+		if (1 != fwrite(rec, sizeof(rec), 1, fp)) {
+			rc = errno;
+			goto close;
+		}
+	}
+
+	if (d->hdr.num_regs && (d->hdr.num_regs != fwrite(d->data,
+				sizeof(uint32_t), d->hdr.num_regs, fp))) {
+		rc = errno;
+	}
+close:
+	if (fclose(fp) && !rc) {
+		rc = errno;
+	}
+	return rc;
+}
+
+int fmd_rdump_load(struct fmd_rdump *d, const char *fn)
+{
+	FILE *fp;
+	uint32_t rec[FMD_RDUMP_RNG_WORDS];
+	struct fmd_rdump_hdr hdr;
+	uint32_t i, regs = 0;
+	int rc = EINVAL;
+
+	fmd_rdump_init(d, NULL);
+
+	fp = fopen(fn, "rb");
+	if (NULL == fp) {
+		return errno;
+	}
+
+	if (1 != fread(&hdr, sizeof(hdr), 1, fp)) {
+		goto fail;
+	}
+	if ((FMD_RDUMP_MAGIC != hdr.magic) || (FMD_RDUMP_VER != hdr.version)
+			|| (hdr.num_rngs > (FMD_RDUMP_MAX_OFS / 4))
+			|| (hdr.num_regs > (FMD_RDUMP_MAX_OFS / 4))) {
+		goto fail;
+	}
+
+	if (fmd_rdump_grow(d, hdr.num_rngs, hdr.num_regs)) {
+		rc = ENOMEM;
+		goto fail;
+	}
+
+	for (i = 0; i < hdr.num_rngs; i++) {
+		if (1 != fread(rec, sizeof(rec), 1, fp)) {
+			goto fail;
+		}
+		if (!rec[1] || (rec[0] & 3) || (rec[0] >= FMD_RDUMP_MAX_OFS)
+				|| (rec[1] > ((FMD_RDUMP_MAX_OFS - rec[0]) / 4))) {
+			goto fail;
+		}
+		d->rngs[i].offset = rec[0];
+		d->rngs[i].cnt = rec[1];
+		d->rngs[i].rc = rec[2];
+		d->rngs[i].idx = regs;
+		if (!rec[2]) {
+			regs += rec[1];
+			if (regs > hdr.num_regs) {
+				goto fail;
+			}
+		}
+	}
+	if (regs != hdr.num_regs) {
+		goto fail;
+	}
+
+	if (regs && (regs != fread(d->data, sizeof(uint32_t), regs, fp))) {
+		goto fail;
+	}
+
+	d->hdr = hdr;
+	fclose(fp);
+	return 0;
+fail:
+	fclose(fp);
+	fmd_rdump_free(d);
+	return rc;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -37,6 +37,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
 
 #include "rio_route.h"
 #include "tok_parse.h"
@@ -193,8 +196,380 @@ CLIValidateCmd,
 ATTR_NONE
 };
 
+/* Fabric wide validation
+ *
+ * Devices are grouped by the mport which reaches them, and each group is
+ * validated by its own set of worker threads, so that maintenance
+ * transactions on one mport do not wait for another mport.  The CARs read
+ * at discovery are reused except for the device identity and component
+ * tag, which are always read to confirm that the device responding is the
+ * one discovered.
+ */
+#define VAL_MODE_CACHED 0
+#define VAL_MODE_LIVE 1
+#define VAL_MODE_FULL 2
+
+#define VAL_DFLT_WORKERS 4
+#define VAL_MAX_WORKERS 16
+
+// Device failure reasons
+#define VAL_FAIL_ACCESS 0x01
+#define VAL_FAIL_IDENT 0x02
+#define VAL_FAIL_CT 0x04
+#define VAL_FAIL_CARS 0x08
+#define VAL_FAIL_PORTS 0x10
+#define VAL_FAIL_EF 0x20
+#define VAL_FAIL_LINK 0x40
+
+struct val_dev {
+	riocp_pe_handle pe;
+	uint32_t fail;
+	uint32_t links;
+	uint32_t link_fails;
+	pe_port_t fail_port;
+	int link_rc;
+	uint64_t ns;
+};
+
+struct val_grp {
+	riocp_pe_handle mport;
+	uint32_t mode;
+	struct val_dev *devs;
+	uint32_t cnt;
+	uint32_t next;
+	uint32_t num_thr;
+	pthread_t thr[VAL_MAX_WORKERS];
+	bool thr_ok[VAL_MAX_WORKERS];
+};
+
+static uint64_t val_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+static void val_check_cars(struct val_dev *dev, uint32_t mode)
+{
+	riocp_pe_handle pe = dev->pe;
+	struct mpsw_drv_private_data *priv = NULL;
+	uint32_t ident[4], ops[4];
+	uint32_t ct, lut_size, sw_port, pe_feat, asbly_info;
+
+	if (riocp_pe_handle_get_private(pe, (void **)&priv)) {
+		dev->fail |= VAL_FAIL_ACCESS;
+		return;
+	}
+	mpsw_init_sync(pe);
+
+	if (DARRegReadBlock(&priv->dev_h, RIO_DEV_IDENT, 4, ident)
+			|| DARRegRead(&priv->dev_h, RIO_COMPTAG, &ct)) {
+		dev->fail |= VAL_FAIL_ACCESS;
+		return;
+	}
+
+	if ((ident[0] != pe->cap.dev_id) || (ident[1] != pe->cap.dev_info)
+			|| (ident[2] != pe->cap.asbly_id)
+			|| (ident[3] != pe->cap.asbly_info)) {
+		dev->fail |= VAL_FAIL_IDENT;
+	}
+	if (ct != pe->comptag) {
+		dev->fail |= VAL_FAIL_CT;
+	}
+
+	pe_feat = pe->cap.pe_feat;
+	sw_port = pe->cap.sw_port;
+	asbly_info = ident[3];
+
+	if (VAL_MODE_CACHED != mode) {
+		if (DARRegReadBlock(&priv->dev_h, RIO_PE_FEAT, 4, ops)
+				|| DARRegRead(&priv->dev_h, RIO_SW_RT_TBL_LIM,
+								&lut_size)) {
+			dev->fail |= VAL_FAIL_ACCESS;
+			return;
+		}
+		if ((ops[0] != pe->cap.pe_feat) || (ops[1] != pe->cap.sw_port)
+				|| (ops[2] != pe->cap.src_op)
+				|| (ops[3] != pe->cap.dst_op)
+				|| (RIOCP_PE_IS_SWITCH(pe->cap)
+					&& (lut_size != pe->cap.lut_size))) {
+			dev->fail |= VAL_FAIL_CARS;
+		}
+		pe_feat = ops[0];
+		sw_port = ops[1];
+	}
+
+	if ((pe_feat & RIOCP_PE_PEF_SWITCH) && (!RIO_AVAIL_PORTS(sw_port)
+			|| (RIO_AVAIL_PORTS(sw_port) > RIO_MAX_PORTS))) {
+		dev->fail |= VAL_FAIL_PORTS;
+	}
+	if ((pe_feat & RIO_PE_FEAT_EFB_VALID)
+			&& !(asbly_info & RIO_ASSY_INF_EFB_PTR)) {
+		dev->fail |= VAL_FAIL_EF;
+	}
+}
+
+static void val_check_dev(struct val_dev *dev, uint32_t mode)
+{
+	riocp_pe_handle pe = dev->pe;
+	uint64_t start = val_now_ns();
+	pe_port_t port;
+	int rc;
+
+	val_check_cars(dev, mode);
+
+	for (port = 0; port < RIOCP_PE_PORT_COUNT(pe->cap); port++) {
+		if ((NULL == pe->peers) || (NULL == pe->peers[port].peer)) {
+			continue;
+		}
+		// Test each link once, from the end with the lower comptag
+		if (pe->peers[port].peer->comptag < pe->comptag) {
+			continue;
+		}
+		dev->links++;
+		if (VAL_MODE_FULL == mode) {
+			rc = mpsw_verify_pe(pe, port);
+		} else {
+			rc = mpsw_check_link(pe, port);
+		}
+		if (rc) {
+			if (!dev->link_fails++) {
+				dev->fail_port = port;
+				dev->link_rc = rc;
+			}
+			dev->fail |= VAL_FAIL_LINK;
+		}
+	}
+	dev->ns = val_now_ns() - start;
+}
+
+static void *val_worker(void *grp_p)
+{
+	struct val_grp *grp = (struct val_grp *)grp_p;
+	uint32_t i;
+
+	while (true) {
+		i = __atomic_fetch_add(&grp->next, 1, __ATOMIC_RELAXED);
+		if (i >= grp->cnt) {
+			break;
+		}
+		val_check_dev(&grp->devs[i], grp->mode);
+	}
+	return NULL;
+}
+
+static const char *val_fail_str(uint32_t fail)
+{
+	if (fail & VAL_FAIL_ACCESS) {
+		return "ACCESS";
+	}
+	if (fail & VAL_FAIL_IDENT) {
+		return "IDENT";
+	}
+	if (fail & VAL_FAIL_CT) {
+		return "COMPTAG";
+	}
+	if (fail & VAL_FAIL_CARS) {
+		return "CARS";
+	}
+	if (fail & VAL_FAIL_PORTS) {
+		return "PORTS";
+	}
+	if (fail & VAL_FAIL_EF) {
+		return "EF_PTR";
+	}
+	if (fail & VAL_FAIL_LINK) {
+		return "LINK";
+	}
+	return "PASSED";
+}
+
+int CLIValidateAllCmd(struct cli_env *env, int argc, char **argv)
+{
+	const char *modes = "Cached Live Full";
+	riocp_pe_handle *pes = NULL;
+	struct val_dev *devs = NULL;
+	struct val_grp grps[RIO_MAX_MPORTS];
+	uint32_t num_grps = 0;
+	size_t pes_count = 0, i;
+	uint32_t mode = VAL_MODE_CACHED;
+	uint32_t workers = VAL_DFLT_WORKERS;
+	uint32_t g, t, n;
+	uint32_t num_fail = 0, links = 0, link_fails = 0;
+	uint64_t start, wall_ns, dev_ns = 0;
+	int rc;
+
+	if (argc > 0) {
+		mode = parm_idx(argv[0], (char *)modes);
+		if (mode > VAL_MODE_FULL) {
+			LOGMSG(env, "\nUnknown mode \"%s\", use %s\n", argv[0],
+					modes);
+			goto exit;
+		}
+	}
+
+	if (argc > 1) {
+		if (tok_parse_ulong(argv[1], &workers, 1, VAL_MAX_WORKERS, 0)) {
+			LOGMSG(env, "\n");
+			LOGMSG(env, TOK_ERR_ULONG_MSG_FMT, "<workers>", 1,
+					VAL_MAX_WORKERS);
+			goto exit;
+		}
+	}
+
+	// Link downgrades retrain links which carry maintenance transactions
+	// for other devices, so test one device at a time per mport.
+	if (VAL_MODE_FULL == mode) {
+		workers = 1;
+	}
+
+	rc = riocp_mport_get_pe_list(mport_pe, &pes_count, &pes);
+	if (rc) {
+		LOGMSG(env, "\nCould not get PE list\n");
+		goto exit;
+	}
+
+	if (!pes_count) {
+		LOGMSG(env, "\nNo PEs discovered!\n");
+		goto exit;
+	}
+
+	devs = (struct val_dev *)calloc(pes_count, sizeof(struct val_dev));
+	if (NULL == devs) {
+		LOGMSG(env, "\nOut of memory\n");
+		goto exit;
+	}
+
+	// Group devices by mport, keeping each group contiguous in devs
+	n = 0;
+	for (i = 0; i < pes_count; i++) {
+		for (g = 0; g < num_grps; g++) {
+			if (grps[g].mport == pes[i]->mport) {
+				break;
+			}
+		}
+		if (g < num_grps) {
+			continue;
+		}
+		if (RIO_MAX_MPORTS == num_grps) {
+			LOGMSG(env, "\nSkipping %s, too many mports\n",
+					pes[i]->sysfs_name);
+			continue;
+		}
+		grps[g].mport = pes[i]->mport;
+		grps[g].mode = mode;
+		grps[g].devs = &devs[n];
+		grps[g].cnt = 0;
+		grps[g].next = 0;
+		num_grps++;
+		for (t = i; t < pes_count; t++) {
+			if (pes[t]->mport == pes[i]->mport) {
+				devs[n++].pe = pes[t];
+				grps[g].cnt++;
+			}
+		}
+	}
+
+	LOGMSG(env, "\nValidating %u devices on %u mports, %u workers each\n",
+			n, num_grps, workers);
+
+	start = val_now_ns();
+	for (g = 0; g < num_grps; g++) {
+		grps[g].num_thr = workers;
+		if (grps[g].num_thr > grps[g].cnt) {
+			grps[g].num_thr = grps[g].cnt;
+		}
+		for (t = 0; t < grps[g].num_thr; t++) {
+			rc = pthread_create(&grps[g].thr[t], NULL,
+					val_worker, &grps[g]);
+			grps[g].thr_ok[t] = !rc;
+		}
+	}
+
+	// Validate groups whose threads could not be started here.
+	for (g = 0; g < num_grps; g++) {
+		for (t = 0; t < grps[g].num_thr; t++) {
+			if (grps[g].thr_ok[t]) {
+				break;
+			}
+		}
+		if (t == grps[g].num_thr) {
+			val_worker(&grps[g]);
+		}
+	}
+
+	for (g = 0; g < num_grps; g++) {
+		for (t = 0; t < grps[g].num_thr; t++) {
+			if (grps[g].thr_ok[t]) {
+				pthread_join(grps[g].thr[t], NULL);
+			}
+		}
+	}
+	wall_ns = val_now_ns() - start;
+
+	LOGMSG(env, "\nDevice           Comptag    Links Fail Result  Port  "
+			"rc   msec\n");
+	for (i = 0; i < n; i++) {
+		LOGMSG(env, "%-16s 0x%08x %5u %4u %-7s ", devs[i].pe->sysfs_name,
+				devs[i].pe->comptag, devs[i].links,
+				devs[i].link_fails, val_fail_str(devs[i].fail));
+		if (devs[i].link_fails) {
+			LOGMSG(env, "%4u 0x%02x", devs[i].fail_port,
+					devs[i].link_rc);
+		} else {
+			LOGMSG(env, "   -    -");
+		}
+		LOGMSG(env, " %6llu.%03llu\n",
+				(unsigned long long)(devs[i].ns / 1000000),
+				(unsigned long long)(devs[i].ns / 1000 % 1000));
+		links += devs[i].links;
+		link_fails += devs[i].link_fails;
+		dev_ns += devs[i].ns;
+		if (devs[i].fail) {
+			num_fail++;
+		}
+	}
+
+	LOGMSG(env, "\n%u of %u devices PASSED, %u of %u links PASSED\n",
+			n - num_fail, n, links - link_fails, links);
+	LOGMSG(env, "Elapsed %llu msec, device total %llu msec\n",
+			(unsigned long long)(wall_ns / 1000000),
+			(unsigned long long)(dev_ns / 1000000));
+
+exit:
+	free(devs);
+	if (NULL != pes) {
+		rc = riocp_mport_free_pe_list(&pes);
+		if (rc) {
+			LOGMSG(env, "\nFailed freeing PE list %d\n", rc);
+		}
+	}
+	return 0;
+}
+
+struct cli_cmd CLIValidateAll = {
+(char *)"valall",
+4,
+0,
+(char *)"validate RapidIO compliance of all devices in parallel.",
+(char *)"{<mode> {<workers>}}\n"
+	"<mode>    Cached: CARs read at discovery are reused, except for the\n"
+	"              device identity and component tag.  Default.\n"
+	"          Live  : all CARs are read and compared to those read at\n"
+	"              discovery.\n"
+	"          Full  : as Live, and each link is downgraded to 1x and\n"
+	"              restored.  One device at a time is tested per mport.\n"
+	"<workers> Threads validating devices on each mport, 1 to 16.\n"
+	"          Default is 4.\n"
+	"Links are tested once, from the end with the lower component tag.\n",
+CLIValidateAllCmd,
+ATTR_NONE
+};
+
 struct cli_cmd *val_cmd_list[] = {
 &CLIValidate,
+&CLIValidateAll,
 };
 
 void fmd_bind_compliance_cmds(void)
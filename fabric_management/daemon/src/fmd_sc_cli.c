@@ -33,6 +33,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
 
 #include "rio_misc.h"
 #include "rio_ecosystem.h"
@@ -43,6 +46,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "riocp_pe_internal.h"
 #include "pe_mpdrv_private.h"
 #include "string_util.h"
+#include "tok_parse.h"
+#include "fmd_sc.h"
+#include "fmd_sc_smpl.h"
 
 #include "rio_standard.h"
 #include "RXS2448.h"
@@ -80,7 +86,9 @@ int CLICountReadCmd(struct cli_env *env, int argc, char **argv)
 	dev_h = &priv->dev_h;
 	sc_in.ptl.num_ports = RIO_ALL_PORTS;
 	sc_in.dev_ctrs = &priv->st.sc_dev;
+	fmd_sc_lock(pe_h);
 	rc = rio_sc_read_ctrs(dev_h, &sc_in, &sc_out);
+	fmd_sc_unlock(pe_h);
 
 	if (RIO_SUCCESS == rc) {
 		LOGMSG(env,"\nCounters read successfully\n");
@@ -267,10 +275,287 @@ CLICountCfgCmd,
 ATTR_NONE
 };
 
+int CLICountRatesCmd(struct cli_env *env, int argc, char **argv)
+{
+	struct fmd_sc *sc = fmd_sc_smpl_get();
+	struct fmd_sc_dev *dev = NULL;
+	uint64_t rates[fmd_sc_stat_max];
+	uint32_t win = 1;
+	uint32_t idx, p;
+	bool got_one = false;
+
+	if (NULL == sc) {
+		LOGMSG(env, "\nStatistics counter sampling is off, "
+				"see FMD option -t\n");
+		goto exit;
+	}
+
+	if (argc && tok_parse_ulong(argv[0], &win, 1, FMD_SC_RING_SZ - 1,
+									0)) {
+		LOGMSG(env, TOK_ERR_ULONG_MSG_FMT, "Periods", 1,
+							FMD_SC_RING_SZ - 1);
+		goto exit;
+	}
+
+	dev = (struct fmd_sc_dev *)malloc(sizeof(struct fmd_sc_dev));
+	if (NULL == dev) {
+		LOGMSG(env, "\nOut of memory\n");
+		goto exit;
+	}
+
+	LOGMSG(env, "\nPeriod %u msec, %llu sweeps, last sweep %llu usec\n",
+			sc->period_ms, (unsigned long long)sc->sweeps,
+			(unsigned long long)sc->sweep_ns / 1000);
+
+	for (idx = 0; !fmd_sc_atomic_copy_dev(sc, idx, dev); idx++) {
+		for (p = 0; p < dev->num_ports; p++) {
+			if (!dev->ports[p].active || fmd_sc_get_rates(
+					&dev->ports[p], win, rates)) {
+				continue;
+			}
+			if (!got_one) {
+				got_one = true;
+				LOGMSG(env, "\nDevice           Pt W "
+					"   PktRx/s    PktTx/s   ByteRx/s "
+					"  ByteTx/s    Retry/s    Error/s\n");
+			}
+			LOGMSG(env, "%-16s %2u %1u %10llu %10llu %10llu "
+				"%10llu %10llu %10llu\n",
+				dev->name, p, dev->ports[p].lanes,
+				(unsigned long long)rates[fmd_sc_pkt_rx],
+				(unsigned long long)rates[fmd_sc_pkt_tx],
+				(unsigned long long)rates[fmd_sc_byte_rx],
+				(unsigned long long)rates[fmd_sc_byte_tx],
+				(unsigned long long)rates[fmd_sc_rty],
+				(unsigned long long)rates[fmd_sc_err]);
+		}
+	}
+	if (!got_one) {
+		LOGMSG(env, "\nNo active ports have been sampled.\n");
+	}
+exit:
+	free(dev);
+	return 0;
+}
+
+struct cli_cmd CLICountRates = {
+(char *)"scrates",
+4,
+0,
+(char *)"display statistics counter rates sampled by the FMD",
+(char *)"{<periods>}\n"
+	"Display the rates per second of the active ports of all switches,\n"
+	"from the samples published in shared memory.\n"
+	"<periods> optional, the number of sampling periods to average.\n"
+	"        Default is 1.\n",
+CLICountRatesCmd,
+ATTR_RPT
+};
+
+#define SC_TOP_SORT_NAMES "Util PktRx PktTx ByteRx ByteTx Retry Error"
+#define SC_TOP_SORT_UTIL 0
+#define SC_TOP_DFLT_ROWS 20
+#define SC_TOP_DFLT_MSEC 2000
+
+struct sc_top_ent {
+	uint64_t key;
+	uint32_t dev_idx;
+	uint32_t pnum;
+	uint32_t lanes;
+	int util;
+	uint64_t rates[fmd_sc_stat_max];
+};
+
+static int sc_top_cmp(const void *a, const void *b)
+{
+	const struct sc_top_ent *ea = (const struct sc_top_ent *)a;
+	const struct sc_top_ent *eb = (const struct sc_top_ent *)b;
+
+	if (ea->key != eb->key) {
+		return (ea->key < eb->key) ? 1 : -1;
+	}
+	if (ea->dev_idx != eb->dev_idx) {
+		return (ea->dev_idx > eb->dev_idx) ? 1 : -1;
+	}
+	return (int)ea->pnum - (int)eb->pnum;
+}
+
+/* Waits up to msec for input on the session, and discards the input.
+ * Returns true if the display should stop.
+ */
+static bool sc_top_wait(struct cli_env *env, uint32_t msec)
+{
+	struct pollfd pfd;
+	char buf[BUFLEN];
+	ssize_t rc;
+
+	pfd.fd = (env->sess_socket >= 0) ? env->sess_socket : STDIN_FILENO;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	if (poll(&pfd, 1, (int)msec) <= 0) {
+		return false;
+	}
+
+	// Any input, or the end of the input, stops the display.
+	rc = read(pfd.fd, buf, sizeof(buf));
+	return (rc >= 0) || (EINTR != errno);
+}
+
+int CLICountTopCmd(struct cli_env *env, int argc, char **argv)
+{
+	struct fmd_sc *sc = fmd_sc_smpl_get();
+	struct fmd_sc_dev *devs = NULL;
+	struct sc_top_ent *ents = NULL;
+	struct sc_top_ent *e;
+	const char *sort_names[] = FMD_SC_STAT_NAMES;
+	uint32_t sort = SC_TOP_SORT_UTIL;
+	uint32_t rows = SC_TOP_DFLT_ROWS;
+	uint32_t msec = SC_TOP_DFLT_MSEC;
+	uint32_t count = 0;
+	uint32_t num_devs, num_ents, iter, p, i;
+	uint64_t rates[fmd_sc_stat_max];
+
+	if (NULL == sc) {
+		LOGMSG(env, "\nStatistics counter sampling is off, "
+				"see FMD option -t\n");
+		goto exit;
+	}
+
+	if (argc > 0) {
+		sort = parm_idx(argv[0], (char *)SC_TOP_SORT_NAMES);
+		if (sort > fmd_sc_stat_max) {
+			LOGMSG(env, "\nSort must be one of %s\n",
+							SC_TOP_SORT_NAMES);
+			goto exit;
+		}
+	}
+	if ((argc > 1) && tok_parse_ulong(argv[1], &rows, 1,
+					FMD_MAX_DEVS * FMD_SC_MAX_PORTS, 0)) {
+		LOGMSG(env, TOK_ERR_ULONG_MSG_FMT, "Rows", 1,
+					FMD_MAX_DEVS * FMD_SC_MAX_PORTS);
+		goto exit;
+	}
+	if ((argc > 2) && tok_parse_ulong(argv[2], &msec, 100, 3600000, 0)) {
+		LOGMSG(env, TOK_ERR_ULONG_MSG_FMT, "Msec", 100, 3600000);
+		goto exit;
+	}
+	if ((argc > 3) && tok_parse_ulong(argv[3], &count, 0, 0xFFFFFFFF,
+									0)) {
+		LOGMSG(env, TOK_ERR_ULONG_MSG_FMT, "Count", 0, 0xFFFFFFFF);
+		goto exit;
+	}
+
+	devs = (struct fmd_sc_dev *)malloc(FMD_MAX_DEVS * sizeof(*devs));
+	ents = (struct sc_top_ent *)malloc(FMD_MAX_DEVS * FMD_SC_MAX_PORTS
+							* sizeof(*ents));
+	if ((NULL == devs) || (NULL == ents)) {
+		LOGMSG(env, "\nOut of memory\n");
+		goto exit;
+	}
+
+	for (iter = 0; !count || (iter < count); iter++) {
+		if (iter && sc_top_wait(env, msec)) {
+			break;
+		}
+
+		// Only the samples in shared memory are read, the display
+		// never accesses the hardware.
+		num_ents = 0;
+		for (num_devs = 0; (num_devs < FMD_MAX_DEVS)
+				&& !fmd_sc_atomic_copy_dev(sc, num_devs,
+						&devs[num_devs]); num_devs++) {
+			for (p = 0; p < devs[num_devs].num_ports; p++) {
+				if (!devs[num_devs].ports[p].active
+						|| fmd_sc_get_rates(
+						&devs[num_devs].ports[p], 1,
+						rates)) {
+					continue;
+				}
+				e = &ents[num_ents++];
+				e->dev_idx = num_devs;
+				e->pnum = p;
+				e->lanes = devs[num_devs].ports[p].lanes;
+				e->util = fmd_sc_get_util(
+					&devs[num_devs].ports[p], rates);
+				memcpy(e->rates, rates, sizeof(e->rates));
+				if (SC_TOP_SORT_UTIL == sort) {
+					e->key = (e->util < 0) ? 0 : e->util;
+				} else {
+					e->key = rates[sort - 1];
+				}
+			}
+		}
+		qsort(ents, num_ents, sizeof(*ents), sc_top_cmp);
+
+		if (count != 1) {
+			LOGMSG(env, "\033[H\033[2J");
+		}
+		LOGMSG(env, "\nPeriod %u msec, %llu sweeps, last sweep %llu usec"
+			"\n%u devices, %u active ports, sorted by %s",
+			sc->period_ms, (unsigned long long)sc->sweeps,
+			(unsigned long long)sc->sweep_ns / 1000, num_devs,
+			num_ents, sort ? sort_names[sort - 1] : "Util");
+		if (count != 1) {
+			LOGMSG(env, ", refresh %u msec, Enter to stop", msec);
+		}
+		LOGMSG(env, "\n\nDevice           Pt W  Util%%    PktRx/s    "
+			"PktTx/s   ByteRx/s   ByteTx/s    Retry/s    Error/s\n");
+		for (i = 0; (i < num_ents) && (i < rows); i++) {
+			e = &ents[i];
+			if (e->util < 0) {
+				LOGMSG(env, "%-16s %2u %1u      -",
+					devs[e->dev_idx].name, e->pnum,
+					e->lanes);
+			} else {
+				LOGMSG(env, "%-16s %2u %1u %4d.%1d",
+					devs[e->dev_idx].name, e->pnum,
+					e->lanes, e->util / 10, e->util % 10);
+			}
+			LOGMSG(env, " %10llu %10llu %10llu %10llu %10llu "
+				"%10llu\n",
+				(unsigned long long)e->rates[fmd_sc_pkt_rx],
+				(unsigned long long)e->rates[fmd_sc_pkt_tx],
+				(unsigned long long)e->rates[fmd_sc_byte_rx],
+				(unsigned long long)e->rates[fmd_sc_byte_tx],
+				(unsigned long long)e->rates[fmd_sc_rty],
+				(unsigned long long)e->rates[fmd_sc_err]);
+		}
+		if (!num_ents) {
+			LOGMSG(env, "No active ports have been sampled.\n");
+		}
+	}
+exit:
+	free(ents);
+	free(devs);
+	return 0;
+}
+
+struct cli_cmd CLICountTop = {
+(char *)"sctop",
+4,
+0,
+(char *)"display ports ranked by utilization, refreshed periodically",
+(char *)"{<sort> {<rows> {<msec> {<count>}}}}\n"
+	"Display the busiest active ports of all switches, from the samples\n"
+	"published in shared memory.  Press Enter to stop the display.\n"
+	"<sort> optional, one of " SC_TOP_SORT_NAMES ".\n"
+	"        Util is the larger of the receive and transmit data rates,\n"
+	"        as a percentage of the link data rate.  Default is Util.\n"
+	"<rows> optional, the number of ports to display.  Default is 20.\n"
+	"<msec> optional, the refresh interval.  Default is 2000.\n"
+	"<count> optional, the number of refreshes, 0 for no limit.\n"
+	"        Default is 0.\n",
+CLICountTopCmd,
+ATTR_NONE
+};
+
 struct cli_cmd *sc_cmd_list[] = {
 &CLICountRead,
 &CLICountDisplay,
-&CLICountCfg
+&CLICountCfg,
+&CLICountRates,
+&CLICountTop
 };
 
 void fmd_bind_dev_sc_cmds(void)
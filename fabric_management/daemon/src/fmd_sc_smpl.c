@@ -0,0 +1,507 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "rio_misc.h"
+#include "rio_ecosystem.h"
+#include "riocp_pe_internal.h"
+#include "pe_mpdrv_private.h"
+#include "liblog.h"
+#include "fmd.h"
+#include "fmd_sc.h"
+#include "fmd_sc_smpl.h"
+#include "fmd_errmsg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NSEC_PER_SEC 1000000000ULL
+
+// Devices behind one mport are read one at a time, with one lock and one
+// sweep queue per mport.  Devices behind different mports are swept in
+// parallel.
+struct fmd_sc_q {
+	riocp_pe_handle mport;
+	uint32_t cnt;
+	riocp_pe_handle pe[FMD_MAX_DEVS];
+	uint32_t idx[FMD_MAX_DEVS];
+	pthread_t thr;
+	bool thr_ok;
+};
+
+static pthread_mutex_t sc_mtx[RIO_MAX_MPORTS] = {
+	PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+	PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+	PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+	PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER
+};
+static struct fmd_sc_q sc_q[RIO_MAX_MPORTS];
+
+static pthread_mutex_t smpl_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t smpl_cond;
+static pthread_t smpl_thr;
+static bool smpl_stop;
+static bool smpl_alive;
+static uint32_t smpl_period_ms;
+
+static char *sc_fn;
+static int sc_fd;
+static struct fmd_sc *sc;
+
+static pthread_mutex_t *fmd_sc_mtx(riocp_pe_handle pe)
+{
+	uint8_t id = 0;
+
+	if ((NULL != pe) && (NULL != pe->mport) && (NULL != pe->mport->minfo)) {
+		id = pe->mport->minfo->id;
+	}
+	return &sc_mtx[id % RIO_MAX_MPORTS];
+}
+
+void fmd_sc_lock(riocp_pe_handle pe)
+{
+	pthread_mutex_lock(fmd_sc_mtx(pe));
+}
+
+void fmd_sc_unlock(riocp_pe_handle pe)
+{
+	pthread_mutex_unlock(fmd_sc_mtx(pe));
+}
+
+struct fmd_sc *fmd_sc_smpl_get(void)
+{
+	return sc;
+}
+
+// Data rate of one lane in Mbit/s for each rio_pc_ls_t, after 8b/10b or
+// 64b/67b encoding.
+static const uint32_t fmd_sc_lane_mbps[rio_pc_ls_last] = {
+	1000, 2000, 2500, 4000, 5000, 9850, 11940
+};
+
+static uint64_t fmd_sc_now_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+}
+
+/* Returns the statistic which counter ctr contributes to, and the number
+ * of bytes counted by each increment of the counter.
+ *
+ * Counters of subsets of packets, such as Tsi57x unicast requests, are
+ * ignored so that packets are not counted twice.
+ */
+static int fmd_sc_stat_of(rio_sc_ctr_val_t *ctr, uint32_t *mult)
+{
+	*mult = 1;
+
+	switch (ctr->sc) {
+	case rio_sc_uc_pkts:
+	case rio_sc_mc_pkts:
+	case rio_sc_pkt:
+	case rio_sc_fab_pkt:
+		return ctr->tx ? fmd_sc_pkt_tx : fmd_sc_pkt_rx;
+	case rio_sc_uc_4b_data:
+	case rio_sc_mc_4b_data:
+		*mult = 4;
+		return ctr->tx ? fmd_sc_byte_tx : fmd_sc_byte_rx;
+	case rio_sc_rio_pload:
+	case rio_sc_fab_pload:
+		*mult = 8;
+		return ctr->tx ? fmd_sc_byte_tx : fmd_sc_byte_rx;
+	default:
+		break;
+	}
+
+	if (SC_FLAG(ctr->sc) & SC_F_RTY) {
+		return fmd_sc_rty;
+	}
+	if (SC_FLAG(ctr->sc) & (SC_F_ERR | SC_F_DROP)) {
+		return fmd_sc_err;
+	}
+	return fmd_sc_stat_max;
+}
+
+/* Reads the counters of the active ports of pe, and adds a sample for
+ * each active port to dev.
+ */
+static void fmd_sc_smpl_dev(struct fmd_sc_dev *dev, riocp_pe_handle pe)
+{
+	struct mpsw_drv_private_data *priv;
+	rio_pc_get_status_out_t ps_out;
+	rio_pc_get_config_in_t pc_in;
+	rio_pc_get_config_out_t pc_out;
+	rio_sc_read_ctrs_in_t sc_in;
+	rio_sc_read_ctrs_out_t sc_out;
+	rio_sc_p_ctrs_val_t *p_ctrs;
+	rio_sc_ctr_val_t *ctr;
+	uint64_t val[FMD_SC_MAX_PORTS][fmd_sc_stat_max];
+	uint64_t oth[FMD_SC_MAX_PORTS][fmd_sc_stat_max];
+	bool got_srio[FMD_SC_MAX_PORTS][fmd_sc_stat_max];
+	uint32_t lanes[FMD_SC_MAX_PORTS];
+	uint32_t mbps[FMD_SC_MAX_PORTS];
+	bool active[FMD_SC_MAX_PORTS];
+	struct fmd_sc_port *port;
+	struct fmd_sc_sample *prev, *cur;
+	uint64_t now, dt;
+	uint32_t rc = RIO_SUCCESS;
+	uint32_t p, i, c, mult, seq;
+	int stat;
+
+	priv = (struct mpsw_drv_private_data *)pe->private_data;
+	if ((NULL == priv) || !priv->dev_h_valid) {
+		return;
+	}
+	mpsw_init_sync(pe);
+
+	memset(val, 0, sizeof(val));
+	memset(oth, 0, sizeof(oth));
+	memset(got_srio, 0, sizeof(got_srio));
+	memset(active, 0, sizeof(active));
+	memset(lanes, 0, sizeof(lanes));
+	memset(mbps, 0, sizeof(mbps));
+
+	// Idle ports are not sampled.  Port status comes from the driver's
+	// cache, so this adds no maintenance transactions.
+	if (mpsw_ps_cache_get(pe, RIO_ALL_PORTS, &ps_out)) {
+		rc = RIO_ERR_ACCESS;
+		goto update;
+	}
+
+	sc_in.ptl.num_ports = 0;
+	for (i = 0; i < ps_out.num_ports; i++) {
+		p = ps_out.ps[i].pnum;
+		if (!ps_out.ps[i].port_ok || (p >= FMD_SC_MAX_PORTS)) {
+			continue;
+		}
+		active[p] = true;
+		lanes[p] = PW_TO_LANES(ps_out.ps[i].pw);
+		sc_in.ptl.pnums[sc_in.ptl.num_ports++] = p;
+	}
+	if (!sc_in.ptl.num_ports) {
+		goto update;
+	}
+
+	// Lane speeds rarely change, so the configuration of a port is read
+	// only when the port becomes active or changes width.
+	pc_in.ptl.num_ports = 0;
+	for (i = 0; i < sc_in.ptl.num_ports; i++) {
+		p = sc_in.ptl.pnums[i];
+		port = &dev->ports[p];
+		if ((dev->ct == pe->comptag) && port->active && port->mbps
+						&& (port->lanes == lanes[p])) {
+			mbps[p] = port->mbps;
+			continue;
+		}
+		pc_in.ptl.pnums[pc_in.ptl.num_ports++] = p;
+	}
+	if (pc_in.ptl.num_ports && (RIO_SUCCESS == rio_pc_get_config(
+					&priv->dev_h, &pc_in, &pc_out))) {
+		for (i = 0; i < pc_out.num_ports; i++) {
+			p = pc_out.pc[i].pnum;
+			if ((p < FMD_SC_MAX_PORTS) && active[p]
+					&& (pc_out.pc[i].ls < rio_pc_ls_last)) {
+				mbps[p] = lanes[p]
+					* fmd_sc_lane_mbps[pc_out.pc[i].ls];
+			}
+		}
+	}
+
+	fmd_sc_lock(pe);
+	sc_in.dev_ctrs = &priv->st.sc_dev;
+	rc = rio_sc_read_ctrs(&priv->dev_h, &sc_in, &sc_out);
+	if (RIO_SUCCESS == rc) {
+		for (i = 0; i < priv->st.sc_dev.valid_p_ctrs; i++) {
+			p_ctrs = &priv->st.sc_dev.p_ctrs[i];
+			p = p_ctrs->pnum;
+			if (p >= FMD_SC_MAX_PORTS) {
+				continue;
+			}
+			for (c = 0; c < p_ctrs->ctrs_cnt; c++) {
+				ctr = &p_ctrs->ctrs[c];
+				stat = fmd_sc_stat_of(ctr, &mult);
+				if (fmd_sc_stat_max == stat) {
+					continue;
+				}
+				if (ctr->srio) {
+					got_srio[p][stat] = true;
+					val[p][stat] += (uint64_t)ctr->total * mult;
+				} else {
+					oth[p][stat] += (uint64_t)ctr->total * mult;
+				}
+			}
+		}
+	}
+	fmd_sc_unlock(pe);
+
+	// Counters of the RapidIO interface are preferred.  Otherwise use
+	// the counters of the other side of the port, such as the RXS
+	// fabric counters configured by the FMD.
+	for (p = 0; p < FMD_SC_MAX_PORTS; p++) {
+		for (i = 0; i < fmd_sc_stat_max; i++) {
+			if (!got_srio[p][i]) {
+				val[p][i] = oth[p][i];
+			}
+		}
+	}
+
+update:
+	now = fmd_sc_now_ns();
+
+	seq = dev->seq;
+	__atomic_store_n(&dev->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	// A different device now occupies this entry, discard the samples.
+	if (dev->ct != pe->comptag) {
+		memset(dev->ports, 0, sizeof(dev->ports));
+		dev->ct = pe->comptag;
+		dev->fails = 0;
+		memset(dev->name, 0, sizeof(dev->name));
+		strncpy(dev->name, riocp_pe_get_sysfs_name(pe), FMD_MAX_NAME);
+	}
+	dev->num_ports = RIOCP_PE_PORT_COUNT(pe->cap);
+	if (dev->num_ports > FMD_SC_MAX_PORTS) {
+		dev->num_ports = FMD_SC_MAX_PORTS;
+	}
+
+	if (RIO_SUCCESS != rc) {
+		dev->fails++;
+		memset(active, 0, sizeof(active));
+	}
+
+	for (p = 0; p < dev->num_ports; p++) {
+		port = &dev->ports[p];
+		port->active = active[p];
+		if (!active[p]) {
+			memset(port->rate, 0, sizeof(port->rate));
+			continue;
+		}
+		port->lanes = lanes[p];
+		port->mbps = mbps[p];
+		prev = &port->ring[port->head];
+		if (port->cnt) {
+			port->head = (port->head + 1) % FMD_SC_RING_SZ;
+		}
+		cur = &port->ring[port->head];
+		cur->ts_ns = now;
+		memcpy(cur->val, val[p], sizeof(cur->val));
+		if (port->cnt < FMD_SC_RING_SZ) {
+			port->cnt++;
+		}
+		if (port->cnt < 2) {
+			continue;
+		}
+		dt = cur->ts_ns - prev->ts_ns;
+		for (i = 0; i < fmd_sc_stat_max; i++) {
+			// Counters restart from 0 when they are reinitialized.
+			if (dt && (cur->val[i] >= prev->val[i])) {
+				port->rate[i] = (uint64_t)((double)(cur->val[i]
+					- prev->val[i]) * NSEC_PER_SEC / dt);
+			} else {
+				port->rate[i] = 0;
+			}
+		}
+	}
+
+	__atomic_store_n(&dev->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static void *fmd_sc_sweep_q(void *q_p)
+{
+	struct fmd_sc_q *q = (struct fmd_sc_q *)q_p;
+	uint32_t i;
+
+	for (i = 0; i < q->cnt; i++) {
+		fmd_sc_smpl_dev(&sc->devs[q->idx[i]], q->pe[i]);
+	}
+	return NULL;
+}
+
+/* Samples every switch.  Each switch keeps the shared memory entry given by
+ * its position in the PE list, so that readers see a stable layout.
+ */
+static void fmd_sc_sweep(void)
+{
+	riocp_pe_handle *pes = NULL;
+	size_t pes_count = 0, i;
+	uint32_t idx = 0, num_q = 0, q;
+	uint64_t start;
+	int rc;
+
+	start = fmd_sc_now_ns();
+	if (riocp_mport_get_pe_list(mport_pe, &pes_count, &pes)) {
+		WARN("Could not get PE list\n");
+		return;
+	}
+
+	for (i = 0; (i < pes_count) && (idx < FMD_MAX_DEVS); i++) {
+		if (!RIOCP_PE_IS_SWITCH(pes[i]->cap)) {
+			continue;
+		}
+		for (q = 0; q < num_q; q++) {
+			if (sc_q[q].mport == pes[i]->mport) {
+				break;
+			}
+		}
+		if (q == num_q) {
+			if (RIO_MAX_MPORTS == num_q) {
+				continue;
+			}
+			sc_q[num_q].mport = pes[i]->mport;
+			sc_q[num_q++].cnt = 0;
+		}
+		sc_q[q].pe[sc_q[q].cnt] = pes[i];
+		sc_q[q].idx[sc_q[q].cnt++] = idx++;
+	}
+
+	// The sampler thread sweeps the first mport itself.
+	for (q = 1; q < num_q; q++) {
+		rc = pthread_create(&sc_q[q].thr, NULL, fmd_sc_sweep_q,
+								&sc_q[q]);
+		sc_q[q].thr_ok = !rc;
+		if (rc) {
+			fmd_sc_sweep_q(&sc_q[q]);
+		}
+	}
+	if (num_q) {
+		fmd_sc_sweep_q(&sc_q[0]);
+	}
+	for (q = 1; q < num_q; q++) {
+		if (sc_q[q].thr_ok) {
+			pthread_join(sc_q[q].thr, NULL);
+		}
+	}
+	__atomic_store_n(&sc->num_devs, idx, __ATOMIC_RELEASE);
+
+	if (riocp_mport_free_pe_list(&pes)) {
+		WARN("Could not free PE list\n");
+	}
+
+	__atomic_store_n(&sc->sweep_ns, fmd_sc_now_ns() - start,
+							__ATOMIC_RELAXED);
+	__atomic_add_fetch(&sc->sweeps, 1, __ATOMIC_RELEASE);
+}
+
+static void *fmd_sc_smpl_loop(void *UNUSED(unused))
+{
+	struct timespec next;
+	uint64_t next_ns;
+
+	pthread_setname_np(smpl_thr, "FMD_SC_SMPL");
+	INFO("Statistics counter sampling period %u msec\n", smpl_period_ms);
+
+	next_ns = fmd_sc_now_ns();
+	pthread_mutex_lock(&smpl_mtx);
+	while (!smpl_stop) {
+		pthread_mutex_unlock(&smpl_mtx);
+		fmd_sc_sweep();
+		pthread_mutex_lock(&smpl_mtx);
+
+		// Sample at fixed times, unless a sweep overruns the period.
+		next_ns += (uint64_t)smpl_period_ms * 1000000;
+		if (next_ns < fmd_sc_now_ns()) {
+			next_ns = fmd_sc_now_ns();
+		}
+		next.tv_sec = next_ns / NSEC_PER_SEC;
+		next.tv_nsec = next_ns % NSEC_PER_SEC;
+		while (!smpl_stop && (ETIMEDOUT != pthread_cond_timedwait(
+					&smpl_cond, &smpl_mtx, &next))) {
+		}
+	}
+	pthread_mutex_unlock(&smpl_mtx);
+	return NULL;
+}
+
+int fmd_sc_smpl_start(char *fn, uint32_t period_ms)
+{
+	pthread_condattr_t attr;
+	int rc;
+
+	if (!period_ms || smpl_alive) {
+		return 0;
+	}
+
+	if (fmd_sc_init(fn, &sc_fd, &sc)) {
+		return -1;
+	}
+	sc_fn = fn;
+	sc->period_ms = period_ms;
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&smpl_cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	smpl_stop = false;
+	smpl_period_ms = period_ms;
+	rc = pthread_create(&smpl_thr, NULL, fmd_sc_smpl_loop, NULL);
+	if (rc) {
+		CRIT(THREAD_FAIL, rc);
+		pthread_cond_destroy(&smpl_cond);
+		fmd_sc_cleanup(sc_fn, &sc_fd, &sc, 1);
+		return -1;
+	}
+	smpl_alive = true;
+	return 0;
+}
+
+void fmd_sc_smpl_stop(void)
+{
+	if (!smpl_alive) {
+		return;
+	}
+
+	pthread_mutex_lock(&smpl_mtx);
+	smpl_stop = true;
+	pthread_cond_signal(&smpl_cond);
+	pthread_mutex_unlock(&smpl_mtx);
+	pthread_join(smpl_thr, NULL);
+	pthread_cond_destroy(&smpl_cond);
+	smpl_alive = false;
+
+	sc->period_ms = 0;
+	fmd_sc_cleanup(sc_fn, &sc_fd, &sc, 1);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,423 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2016, Integrated Device Technology Inc.
+ Copyright (c) 2016, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+/**
+ * \file fmd_fab_bench.c
+ * \brief Counts the maintenance transactions, and measures the time, of
+ * FMD enumeration and route computation run against emulated fabrics.
+ *
+ * Each fabric is enumerated in a separate process, as the component tag,
+ * device ID and configuration libraries keep their state in globals.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+
+#include "tok_parse.h"
+#include "liblog.h"
+#include "did.h"
+#include "ct.h"
+#include "cfg.h"
+#include "riocp_pe.h"
+#include "pe_mpdrv.h"
+#include "pe_mpsim.h"
+#include "DSF_DB_Private.h"
+#include "fmd_net.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BENCH_CFG "/tmp/fmd_fab_bench.cfg"
+#define BENCH_MPORT_DID 0xFD
+#define BENCH_MAX_SIZES 16
+
+// dev08 device IDs run out before 254 devices are enumerated
+#define BENCH_MAX_DEV08 250
+
+// Referenced by fmd_net.c, unused by the traversal
+struct fmd_state *fmd = NULL;
+
+struct bench_parms {
+	rio_emu_model_t sw_model;
+	rio_fab_lat_t lat;
+	const char *topo_fn;
+	uint32_t workers;
+};
+
+static void usage(char *program)
+{
+	printf("%s - count maintenance transactions of FMD enumeration\n",
+			program);
+	printf("Usage:\n");
+	printf("  %s [options]\n", program);
+	printf("Options are:\n");
+	printf("  -h\n");
+	printf("    display this message\n");
+	printf("  -n <nodes>[,<nodes>...]\n");
+	printf("    sizes of the generated fabrics (default 10,100,1000)\n");
+	printf("  -m <model>\n");
+	printf("    switch used in generated fabrics (default rxs2448):\n");
+	printf("    rxs2448, rxs1632, cps1848, cps1616, tsi578\n");
+	printf("  -f <file>\n");
+	printf("    enumerate the fabric described by file instead\n");
+	printf("  -p <ns>\n");
+	printf("    latency of each link crossed (default 100)\n");
+	printf("  -a <ns>\n");
+	printf("    latency of each maintenance access (default 2000)\n");
+	printf("  -r <ns>\n");
+	printf("    additional latency per register accessed (default 20)\n");
+	printf("  -w\n");
+	printf("    wait for the modeled latency on each transaction\n");
+	printf("  -s\n");
+	printf("    as -w, sleeping instead of spinning so threads overlap\n");
+	printf("  -j <workers>\n");
+	printf("    deferred device initialization threads (default 0)\n");
+	printf("  -l <level>\n");
+	printf("    log level, 1 (off) to 7 (debug) (default 1)\n");
+	printf("\n");
+}
+
+static int parse_sizes(char *arg, uint32_t *sizes, uint32_t *cnt)
+{
+	char *tok, *save = NULL;
+
+	*cnt = 0;
+	for (tok = strtok_r(arg, ",", &save); NULL != tok;
+				tok = strtok_r(NULL, ",", &save)) {
+		if ((BENCH_MAX_SIZES == *cnt)
+				|| tok_parse_ulong(tok, &sizes[*cnt], 2,
+						RIO_LAST_DEV16, 0)) {
+			printf(TOK_ERR_ULONG_MSG_FMT, "Nodes", 2,
+					RIO_LAST_DEV16);
+			return -1;
+		}
+		(*cnt)++;
+	}
+	return 0;
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+// Automatic enumeration configuration, with only the master port defined
+static int write_cfg(bool dev16)
+{
+	FILE *f = fopen(BENCH_CFG, "w");
+
+	if (NULL == f) {
+		return -1;
+	}
+	fprintf(f, "MPORT 0 master mem34 dev08 %x 255 dev16 %x 255 END\n",
+			BENCH_MPORT_DID, BENCH_MPORT_DID);
+	fprintf(f, "MASTER_INFO dev08 %x 3434\n", BENCH_MPORT_DID);
+	fprintf(f, "%s\n", dev16 ? "AUTO16" : "AUTO");
+	fprintf(f, "EOF\n");
+	return fclose(f);
+}
+
+// Creates the master port handle, enumerates and routes the way
+// setup_mport_master does.  Returns once all devices are initialized.
+static int enumerate(riocp_pe_handle *mport_pe, uint32_t workers)
+{
+	struct cfg_mport_info mp;
+	did_sz_t did_sz = cfg_did_sz();
+	int did_sz_idx = did_size_as_int(did_sz);
+	ct_t comptag;
+	did_t did;
+	char name[] = "MPORT0";
+	int rc;
+
+	if (cfg_find_mport(0, &mp) || (did_sz_idx < 0)
+			|| riocp_set_did_sz(did_sz)) {
+		return -1;
+	}
+
+	if (did_create_from_data(&did, mp.devids[did_sz_idx].did_val,
+			did_sz) || ct_create_from_did(&comptag, did)) {
+		return -1;
+	}
+
+	if (mpsw_init_workers_start(workers)) {
+		return -1;
+	}
+
+	if (riocp_pe_create_host_handle(mport_pe, 0, 0, &comptag, name)) {
+		mpsw_init_workers_stop();
+		return -1;
+	}
+
+	rc = fmd_traverse_network(*mport_pe, NULL);
+	if (!rc) {
+		rc = mpsw_drv_compute_routes(*mport_pe);
+	}
+	if (mpsw_init_wait()) {
+		rc = -1;
+	}
+	mpsw_init_workers_stop();
+	return rc;
+}
+
+static int run_fabric(struct bench_parms *parms, uint32_t nodes)
+{
+	rio_fab_t *fab;
+	rio_fab_stats_t stats;
+	riocp_pe_handle mport_pe = NULL;
+	riocp_pe_handle *pes = NULL;
+	size_t pe_cnt = 0;
+	char *dd_mtx_fn = NULL, *dd_fn = NULL;
+	did_t m_did;
+	uint32_t m_cm_port, m_mode;
+	uint64_t start, elapsed;
+	uint32_t line = 0;
+	uint32_t rc;
+
+	fab = rio_fab_create();
+	if (NULL == fab) {
+		fprintf(stderr, "Out of memory\n");
+		return -1;
+	}
+
+	if (NULL != parms->topo_fn) {
+		rc = rio_fab_load(fab, parms->topo_fn, &line);
+	} else {
+		rc = rio_fab_gen_tree(fab, parms->sw_model, rio_emu_tsi721,
+				nodes);
+	}
+	if (RIO_SUCCESS != rc) {
+		fprintf(stderr, "Cannot create fabric: 0x%x line %u\n", rc,
+				line);
+		goto fail;
+	}
+	rio_fab_set_lat(fab, &parms->lat);
+
+	if (write_cfg(rio_fab_num_devs(fab) > BENCH_MAX_DEV08)
+			|| cfg_parse_file((char *)BENCH_CFG, &dd_mtx_fn, &dd_fn,
+					&m_did, &m_cm_port, &m_mode)) {
+		fprintf(stderr, "Cannot parse %s\n", BENCH_CFG);
+		goto fail;
+	}
+
+	if (mpsw_sim_bind(fab)) {
+		fprintf(stderr, "Cannot bind fabric\n");
+		goto fail;
+	}
+	RIO_bind_procs(SRIO_API_ReadRegFunc, SRIO_API_WriteRegFunc,
+			SRIO_API_DelayFunc);
+	DAR_blk_rd_proc_ptr_init(SRIO_API_ReadRegBlockFunc);
+	DAR_blk_proc_ptr_init(SRIO_API_WriteRegBlockFunc);
+
+	rio_fab_clr_stats(fab);
+	start = now_ns();
+	if (enumerate(&mport_pe, parms->workers)) {
+		fprintf(stderr, "%u nodes: enumeration failed\n",
+				rio_fab_num_devs(fab));
+		goto fail;
+	}
+	elapsed = now_ns() - start;
+	rio_fab_get_stats(fab, &stats);
+
+	if (!riocp_mport_get_pe_list(mport_pe, &pe_cnt, &pes)) {
+		if (riocp_mport_free_pe_list(&pes)) {
+			pe_cnt = 0;
+		}
+	}
+
+	printf("%6u %6zu %6s %9" PRIu64 " %9" PRIu64 " %9" PRIu64
+			" %9" PRIu64 " %6" PRIu64 " %10.1f %10.1f\n",
+			rio_fab_num_devs(fab), pe_cnt,
+			rio_fab_get_dev16(fab) ? "dev16" : "dev08",
+			stats.rd_acc, stats.wr_acc,
+			stats.lcl_rd + stats.lcl_wr, stats.hops, stats.fails,
+			(double)stats.lat_ns / 1000000.0,
+			(double)elapsed / 1000000.0);
+
+	mpsw_sim_unbind();
+	rio_fab_destroy(fab);
+	return 0;
+
+fail:
+	mpsw_sim_unbind();
+	rio_fab_destroy(fab);
+	return -1;
+}
+
+// Runs the benchmark in a child process, so every fabric starts from
+// clean library state.
+static int run_child(struct bench_parms *parms, uint32_t nodes)
+{
+	pid_t pid;
+	int status;
+
+	fflush(stdout);
+	pid = fork();
+	if (pid < 0) {
+		perror("fork");
+		return -1;
+	}
+	if (!pid) {
+		status = run_fabric(parms, nodes);
+		fflush(stdout);
+		_exit(status ? EXIT_FAILURE : EXIT_SUCCESS);
+	}
+	if ((waitpid(pid, &status, 0) != pid) || !WIFEXITED(status)
+			|| (EXIT_SUCCESS != WEXITSTATUS(status))) {
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct bench_parms parms;
+	uint32_t sizes[BENCH_MAX_SIZES] = {10, 100, 1000};
+	uint32_t num_sizes = 3;
+	uint32_t idx;
+	int rc = EXIT_SUCCESS;
+	int c;
+
+	parms.sw_model = rio_emu_rxs2448;
+	parms.topo_fn = NULL;
+	parms.lat.hop_ns = 100;
+	parms.lat.acc_ns = 2000;
+	parms.lat.reg_ns = 20;
+	parms.lat.wait = false;
+	parms.lat.sleep = false;
+	parms.workers = 0;
+	g_level = RDMA_LL_OFF;
+	g_disp_level = RDMA_LL_OFF;
+
+	while (-1 != (c = getopt(argc, argv, "hn:m:f:p:a:r:wsj:l:"))) {
+		switch (c) {
+		case 'n':
+			if (parse_sizes(optarg, sizes, &num_sizes)) {
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'm':
+			parms.sw_model = rio_emu_model_by_name(optarg);
+			if ((rio_emu_model_last == parms.sw_model)
+					|| (rio_emu_tsi721 == parms.sw_model)) {
+				printf("Unknown switch \"%s\"\n", optarg);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'f':
+			parms.topo_fn = optarg;
+			num_sizes = 1;
+			break;
+		case 'p':
+		case 'a':
+		case 'r':
+			if (tok_parse_ulong(optarg, &idx, 0, 1000000000, 0)) {
+				printf(TOK_ERR_ULONG_MSG_FMT, "Latency", 0,
+						1000000000);
+				exit(EXIT_FAILURE);
+			}
+			if ('p' == c) {
+				parms.lat.hop_ns = idx;
+			} else if ('a' == c) {
+				parms.lat.acc_ns = idx;
+			} else {
+				parms.lat.reg_ns = idx;
+			}
+			break;
+		case 'w':
+			parms.lat.wait = true;
+			break;
+		case 's':
+			parms.lat.wait = true;
+			parms.lat.sleep = true;
+			break;
+		case 'j':
+			if (tok_parse_ulong(optarg, &parms.workers, 0,
+					MPSW_INIT_MAX_WORKERS, 0)) {
+				printf(TOK_ERR_ULONG_MSG_FMT, "Workers", 0,
+						MPSW_INIT_MAX_WORKERS);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'l':
+			if (tok_parse_ulong(optarg, &idx, RDMA_LL_OFF,
+					RDMA_LL_DBG, 0)) {
+				printf(TOK_ERR_ULONG_MSG_FMT, "Log level",
+						RDMA_LL_OFF, RDMA_LL_DBG);
+				exit(EXIT_FAILURE);
+			}
+			g_level = idx;
+			g_disp_level = idx;
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (rdma_log_init(NULL, 1)) {
+		exit(EXIT_FAILURE);
+	}
+
+	// Sleeps end as close to the modeled time as the kernel allows.
+	// Threads started later inherit the timer slack.
+	if (parms.lat.sleep) {
+		prctl(PR_SET_TIMERSLACK, 1);
+	}
+
+	printf("%6s %6s %6s %9s %9s %9s %9s %6s %10s %10s\n", "Nodes",
+			"Found", "DevID", "Maint rd", "Maint wr", "Local",
+			"Hops", "Fails", "Model ms", "Wall ms");
+	for (idx = 0; idx < num_sizes; idx++) {
+		if (run_child(&parms, sizes[idx])) {
+			rc = EXIT_FAILURE;
+		}
+	}
+	return rc;
+}
+
+#ifdef __cplusplus
+}
+#endif
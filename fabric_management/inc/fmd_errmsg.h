@@ -56,6 +56,8 @@ extern "C" {
 #define REM_SOCKET_FAIL "FMD: AF_TCP (remote) socket %d failed."
 #define CM_SOCKET_FAIL "FMD: RapidIO Socket %d failed."
 #define DEV_DB_FAIL "Device Database file %s failed. Multiple FMDs or no FMD"
+#define SC_SHM_FAIL "Statistics counter file %s failed. Multiple FMDs?"
+#define MT_SHM_FAIL "Maintenance statistics file %s failed. Multiple FMDs?"
 
 #ifdef __cplusplus
 }
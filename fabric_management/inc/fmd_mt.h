@@ -0,0 +1,118 @@
+/*
+****************************************************************************
+Copyright (c) 2017, Integrated Device Technology Inc.
+Copyright (c) 2017, RapidIO Trade Association
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+may be used to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************
+*/
+
+#ifndef __FMD_MT_H__
+#define __FMD_MT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fmd_dd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maintenance transaction statistics
+ *
+ * The FMD counts the maintenance reads and writes it performs, by target
+ * device and by hop count, and publishes the counts in a shared memory
+ * file.  Counting is switched on and off while the FMD runs.  When off,
+ * each transaction costs one extra test.
+ *
+ * Counters are updated atomically by the threads performing transactions.
+ * A reader may see a count and its latency total from slightly different
+ * moments.
+ */
+
+/* Latency histogram buckets.  Bucket 0 counts latencies below 1 usec,
+ * bucket i below 2^i usec, and the last bucket all longer latencies.
+ */
+#define FMD_MT_HIST_BKTS 16
+
+/* Hop count entries.  Entries 0 to FMD_MT_MAX_HC - 2 count their hop
+ * count, entry FMD_MT_MAX_HC - 1 counts larger hop counts, and entry
+ * FMD_MT_LCL counts accesses to mport local registers.
+ */
+#define FMD_MT_MAX_HC 16
+#define FMD_MT_LCL FMD_MT_MAX_HC
+
+enum fmd_mt_dir {
+	fmd_mt_rd,
+	fmd_mt_wr,
+	fmd_mt_dir_max
+};
+
+struct fmd_mt_ctr {
+	uint64_t cnt; /* Transactions */
+	uint64_t regs; /* Registers accessed, a block read accesses several */
+	uint64_t fails; /* Transactions which failed */
+	uint64_t retries; /* Repeats of the thread's last failed transaction */
+	uint64_t lat_ns; /* Total latency */
+	uint64_t max_ns; /* Largest latency */
+	uint64_t hist[FMD_MT_HIST_BKTS];
+};
+
+struct fmd_mt_dev {
+	ct_t ct;
+	uint32_t hc; /* Hop count when last accessed */
+	char name[FMD_MAX_NAME+1];
+	struct fmd_mt_ctr ctr[fmd_mt_dir_max];
+};
+
+struct fmd_mt {
+	uint32_t on; /* 1 while transactions are counted */
+	uint32_t num_devs;
+	uint64_t start_ns; /* CLOCK_MONOTONIC time counting last started */
+	uint64_t run_ns; /* Time counted before the last start */
+	struct fmd_mt_ctr hc[FMD_MT_MAX_HC + 1][fmd_mt_dir_max];
+	struct fmd_mt_dev devs[FMD_MAX_DEVS]; /* In order of first access */
+};
+
+/* Creates the shared memory file.  Used by the FMD only. */
+extern int fmd_mt_init(char *mt_fn, int *mt_fd, struct fmd_mt **mt);
+
+/* Maps the shared memory file created by the FMD read only. */
+extern int fmd_mt_open(char *mt_fn, int *mt_fd, struct fmd_mt **mt);
+
+extern void fmd_mt_cleanup(char *mt_fn, int *mt_fd, struct fmd_mt **mt_p,
+		int mt_rw);
+
+/* Sums the counters of src into dst. */
+extern void fmd_mt_add(struct fmd_mt_ctr *dst, struct fmd_mt_ctr *src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FMD_MT_H__ */
@@ -0,0 +1,138 @@
+/*
+****************************************************************************
+Copyright (c) 2017, Integrated Device Technology Inc.
+Copyright (c) 2017, RapidIO Trade Association
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+may be used to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************
+*/
+
+#ifndef __FMD_SC_H__
+#define __FMD_SC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fmd_dd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Statistics counter samples
+ *
+ * The FMD periodically reads the statistics counters of the active ports
+ * of every switch, and publishes the totals and rates in a shared memory
+ * file.  Applications map the file read only, and never access hardware.
+ *
+ * Each device entry is protected by a sequence count, which is odd while
+ * the FMD updates the entry.  Use fmd_sc_atomic_copy_dev to get a
+ * consistent copy of an entry.
+ */
+
+#define FMD_SC_MAX_PORTS 24
+#define FMD_SC_RING_SZ 32
+
+enum fmd_sc_stat {
+	fmd_sc_pkt_rx, /* Packets received */
+	fmd_sc_pkt_tx, /* Packets transmitted */
+	fmd_sc_byte_rx, /* Bytes of packet data received */
+	fmd_sc_byte_tx, /* Bytes of packet data transmitted */
+	fmd_sc_rty, /* Retries */
+	fmd_sc_err, /* Errors and dropped packets */
+	fmd_sc_stat_max
+};
+
+#define FMD_SC_STAT_NAMES {"PktRx", "PktTx", "ByteRx", "ByteTx", "Retry", "Error"}
+
+struct fmd_sc_sample {
+	uint64_t ts_ns; /* CLOCK_MONOTONIC time of the sample */
+	uint64_t val[fmd_sc_stat_max]; /* Totals since the counters were reset */
+};
+
+struct fmd_sc_port {
+	uint32_t active; /* 1 if the port was sampled by the last sweep */
+	uint32_t lanes; /* Link width when last active */
+	uint32_t mbps; /* Link data rate in Mbit/s, 0 if not known */
+	uint32_t head; /* Index of the most recent sample */
+	uint32_t cnt; /* Number of valid samples */
+	uint64_t rate[fmd_sc_stat_max]; /* Per second, over the last period */
+	struct fmd_sc_sample ring[FMD_SC_RING_SZ];
+};
+
+struct fmd_sc_dev {
+	uint32_t seq; /* Odd while the entry is being updated */
+	ct_t ct;
+	uint32_t num_ports; /* ports[] is indexed by port number */
+	uint32_t fails; /* Sweeps which could not read the counters */
+	char name[FMD_MAX_NAME+1];
+	struct fmd_sc_port ports[FMD_SC_MAX_PORTS];
+};
+
+struct fmd_sc {
+	uint32_t period_ms; /* Sampling period, 0 if sampling has stopped */
+	uint32_t num_devs;
+	uint64_t sweeps; /* Sweeps of all devices completed */
+	uint64_t sweep_ns; /* Duration of the last sweep */
+	struct fmd_sc_dev devs[FMD_MAX_DEVS];
+};
+
+/* Creates the shared memory file.  Used by the FMD only. */
+extern int fmd_sc_init(char *sc_fn, int *sc_fd, struct fmd_sc **sc);
+
+/* Maps the shared memory file created by the FMD read only. */
+extern int fmd_sc_open(char *sc_fn, int *sc_fd, struct fmd_sc **sc);
+
+extern void fmd_sc_cleanup(char *sc_fn, int *sc_fd, struct fmd_sc **sc_p,
+		int sc_rw);
+
+/* Copies device entry idx.  Returns -1 if idx is not a valid device, or
+ * if the FMD does not complete an update of the entry.
+ */
+extern int fmd_sc_atomic_copy_dev(struct fmd_sc *sc, uint32_t idx,
+		struct fmd_sc_dev *dev);
+
+/* Computes the rates per second of the port over the last win sampling
+ * periods, limited to the samples available.  Samples taken before a
+ * counter was reinitialized are not used for its rate, which is 0 until
+ * a second sample follows the restart.  Returns -1 if there are fewer
+ * than two samples.
+ */
+extern int fmd_sc_get_rates(struct fmd_sc_port *port, uint32_t win,
+		uint64_t *rates);
+
+/* Returns the utilization of the port in tenths of a percent, from the
+ * larger of the byte rates received and transmitted.  Returns -1 if the
+ * link data rate is not known.
+ */
+extern int fmd_sc_get_util(struct fmd_sc_port *port, uint64_t *rates);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FMD_SC_H__ */
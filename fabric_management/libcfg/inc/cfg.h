@@ -110,8 +110,10 @@ int cfg_parse_file(char *cfg_fn, char **dd_mtx_fn, char **dd_fn,
 		did_t *m_did, uint32_t *m_cm_port, uint32_t *m_mode);
 int cfg_find_mport(uint32_t mport, struct cfg_mport_info *mp);
 int cfg_get_mp_mem_sz(uint32_t mport, uint8_t *mem_sz );
-int cfg_find_dev_by_ct(ct_t ct, struct cfg_dev *dev);
-int cfg_get_conn_dev(ct_t ct, int pt, struct cfg_dev *dev, int *conn_pt);
+/* The device returned is owned by the configuration, do not modify it */
+int cfg_find_dev_by_ct(ct_t ct, const struct cfg_dev **dev);
+int cfg_get_conn_dev(ct_t ct, int pt, const struct cfg_dev **dev,
+		int *conn_pt);
 bool cfg_auto(void);
 did_sz_t cfg_did_sz(void);
 
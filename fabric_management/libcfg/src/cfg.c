@@ -53,6 +53,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "rio_route.h"
 #include "rio_standard.h"
 #include "tok_parse.h"
+#include "tok_reader.h"
 #include "did.h"
 #include "ct.h"
 #include "fmd_dd.h"
@@ -72,7 +73,6 @@ extern "C" {
 #endif
 
 struct int_cfg_parms *cfg = NULL;
-FILE *cfg_fd = NULL;
 const char *DEV_TYPE = "ENDPOINT";
 
 void init_rt(rio_rt_state_t *rt)
@@ -95,158 +95,306 @@ void init_rt(rio_rt_state_t *rt)
 
 static int init_cfg_ptr()
 {
-	int i, j;
-
 	cfg = (struct int_cfg_parms *)calloc(1, sizeof(struct int_cfg_parms));
 	if (NULL == cfg) {
 		return 1;
 	}
 
 	cfg->mast_idx = CFG_SLAVE;
-
-	for (i = 0; i < CFG_MAX_MPORTS; i++) {
-		cfg->mport_info[i].num = -1;
-		cfg->mport_info[i].op_mode = -1;
-		cfg->mport_info[i].mem_sz = CFG_MEM_SZ_DEFAULT;
-		for (j = 0; j < MAX_DEV_SZ_IDX; j++) {
-			cfg->mport_info[i].devids[j].hc = HC_MP;
-		}
-		cfg->mport_info[i].ep_pnum = -1;
-	}
 	cfg->mast_did_sz_idx = CFG_DFLT_MAST_DEVID_SZ;
 	cfg->mast_did_val = CFG_DFLT_MAST_DEVID;
 	cfg->mast_cm_port = FMD_DFLT_MAST_CM_PORT;
+	cfg->auto_config = false;
+	cfg->init_err = false;
 
-	for (i = 0; i < CFG_MAX_EP; i++) {
-		for (j = 0; j < CFG_MAX_EP_PORT; j++) {
-			int k;
-			cfg->eps[i].ports[j].rio.max_pw = rio_pc_pw_last;
-			cfg->eps[i].ports[j].rio.op_pw = rio_pc_pw_last;
-			cfg->eps[i].ports[j].rio.ls = rio_pc_ls_last;
-			cfg->eps[i].ports[j].rio.iseq = rio_pc_is_last;
-			for (k = 0; k < MAX_DEV_SZ_IDX; k++) {
-				cfg->eps[i].ports[j].devids[k].hc = HC_MP;
-			}
-			cfg->eps[i].ports[j].conn_end = -1;
-		}
+	return 0;
+}
+
+/* Make room for entry cnt in a list of elem_sz byte entries */
+static int cfg_list_grow(void **list, uint32_t *alloc, uint32_t cnt,
+		size_t elem_sz)
+{
+	uint32_t new_alloc;
+	void *tmp;
+
+	if (cnt < *alloc) {
+		return 0;
 	}
 
-	for (i = 0; i < CFG_MAX_SW; i++) {
-		for (j = 0; j < CFG_MAX_SW_PORT; j++) {
-			cfg->sws[i].ports[j].rio.max_pw = rio_pc_pw_last;
-			cfg->sws[i].ports[j].rio.op_pw = rio_pc_pw_last;
-			cfg->sws[i].ports[j].rio.ls = rio_pc_ls_last;
-			cfg->sws[i].ports[j].rio.iseq = rio_pc_is_last;
-			cfg->sws[i].ports[j].conn_end = -1;
-		}
-		for (j = 0; j < MAX_DEV_SZ_IDX; j++) {
-			init_rt(&cfg->sws[i].rt[j]);
-			for (int k = 0; k < CFG_MAX_SW_PORT; k++) {
-				init_rt(&cfg->sws[i].ports[k].rt[j]);
-			}
-		}
+	new_alloc = *alloc ? *alloc * 2 : CFG_INIT_ALLOC;
+	tmp = realloc(*list, new_alloc * elem_sz);
+	if (NULL == tmp) {
+		return 1;
 	}
+	memset((uint8_t *)tmp + (*alloc * elem_sz), 0,
+			(new_alloc - *alloc) * elem_sz);
+	*list = tmp;
+	*alloc = new_alloc;
+	return 0;
+}
 
-	for (i = 0; i < CFG_MAX_CONN; i++) {
-		int e;
-		cfg->cons[i].valid = 0;
-		for (e = 0; e < 2; e++) {
-			cfg->cons[i].ends[e].port_num = -1;
-			cfg->cons[i].ends[e].ep = -1;
-		}
+static void init_cfg_rapidio(struct int_cfg_rapidio *rio)
+{
+	rio->max_pw = rio_pc_pw_last;
+	rio->op_pw = rio_pc_pw_last;
+	rio->ls = rio_pc_ls_last;
+	rio->iseq = rio_pc_is_last;
+}
+
+struct int_mport_info *cfg_new_mport(struct int_cfg_parms *cfg)
+{
+	struct int_mport_info *mp;
+	int j;
+
+	if (cfg_list_grow((void **)&cfg->mport_info, &cfg->mport_alloc,
+			cfg->max_mport_info_idx, sizeof(*mp))) {
+		return NULL;
 	}
 
-	cfg->auto_config = false;
-	cfg->init_err = false;
+	mp = &cfg->mport_info[cfg->max_mport_info_idx];
+	memset(mp, 0, sizeof(*mp));
+	mp->num = -1;
+	mp->op_mode = -1;
+	mp->mem_sz = CFG_MEM_SZ_DEFAULT;
+	for (j = 0; j < MAX_DEV_SZ_IDX; j++) {
+		mp->devids[j].hc = HC_MP;
+	}
+	mp->ep_pnum = -1;
+	return mp;
+}
 
-	return 0;
+static void free_ep(struct int_cfg_ep *ep)
+{
+	if (NULL == ep) {
+		return;
+	}
+	free_string(&ep->name);
+	free(ep);
 }
 
-static void strip_crlf(char *tok)
+// Routing tables loaded from the binary cache belong to the cache mapping
+static void free_rt(struct int_cfg_parms *cfg, rio_rt_state_t *rt)
 {
-	char *temp = NULL;
+	uint8_t *p = (uint8_t *)rt;
+	uint8_t *map = (uint8_t *)cfg->cache_map;
 
-	if (NULL == tok) {
+	if ((NULL != map) && (p >= map) && (p < map + cfg->cache_size)) {
 		return;
 	}
+	free(rt);
+}
 
-	temp = strchr(tok, '\n');
-	if (NULL != temp) {
-		temp[0] = '\0';
-	}
+static void free_sw(struct int_cfg_parms *cfg, struct int_cfg_sw *sw)
+{
+	int i, j;
 
-	temp = strchr(tok, '\r');
-	if(NULL != temp) {
-		temp[0] = '\0';
+	if (NULL == sw) {
+		return;
 	}
+	for (i = 0; i < MAX_DEV_SZ_IDX; i++) {
+		free_rt(cfg, sw->rt[i]);
+		for (j = 0; j < CFG_MAX_SW_PORT; j++) {
+			free_rt(cfg, sw->ports[j].rt[i]);
+		}
+	}
+	free_string(&sw->name);
+	free_string(&sw->dev_type);
+	free(sw);
 }
 
-const char *delim = " 	";
-char *save_ptr = NULL;
+// The new entry is only counted once it has been parsed successfully.
+struct int_cfg_ep *cfg_new_ep(struct int_cfg_parms *cfg)
+{
+	struct int_cfg_ep *ep;
+	int j, k;
+
+	if (cfg_list_grow((void **)&cfg->eps, &cfg->ep_alloc, cfg->ep_cnt,
+			sizeof(*cfg->eps))) {
+		return NULL;
+	}
+
+	ep = (struct int_cfg_ep *)calloc(1, sizeof(*ep));
+	if (NULL == ep) {
+		return NULL;
+	}
+	for (j = 0; j < CFG_MAX_EP_PORT; j++) {
+		init_cfg_rapidio(&ep->ports[j].rio);
+		for (k = 0; k < MAX_DEV_SZ_IDX; k++) {
+			ep->ports[j].devids[k].hc = HC_MP;
+		}
+		ep->ports[j].conn_end = -1;
+	}
+	ep->idx = cfg->ep_cnt;
+	free_ep(cfg->eps[cfg->ep_cnt]);
+	cfg->eps[cfg->ep_cnt] = ep;
+	return ep;
+}
 
-static void flush_comment(char *tok)
+struct int_cfg_sw *cfg_new_sw(struct int_cfg_parms *cfg)
 {
-	while (NULL != tok) {
-		DBG("%s\n", tok);
-		tok = strtok_r(NULL, delim, &save_ptr);
-		strip_crlf(tok);
+	struct int_cfg_sw *sw;
+	int j;
+
+	if (cfg_list_grow((void **)&cfg->sws, &cfg->sw_alloc, cfg->sw_cnt,
+			sizeof(*cfg->sws))) {
+		return NULL;
 	}
+
+	sw = (struct int_cfg_sw *)calloc(1, sizeof(*sw));
+	if (NULL == sw) {
+		return NULL;
+	}
+	for (j = 0; j < CFG_MAX_SW_PORT; j++) {
+		init_cfg_rapidio(&sw->ports[j].rio);
+		sw->ports[j].conn_end = -1;
+	}
+	sw->idx = cfg->sw_cnt;
+	free_sw(cfg, cfg->sws[cfg->sw_cnt]);
+	cfg->sws[cfg->sw_cnt] = sw;
+	return sw;
 }
 
-#define LINE_SIZE 256
-char *line;
+struct int_cfg_conn *cfg_new_conn(struct int_cfg_parms *cfg)
+{
+	struct int_cfg_conn *conn;
+	int e;
 
-static char *try_get_next_token(struct int_cfg_parms *cfg)
+	if (cfg_list_grow((void **)&cfg->cons, &cfg->conn_alloc,
+			cfg->conn_cnt, sizeof(*cfg->cons))) {
+		return NULL;
+	}
+
+	conn = (struct int_cfg_conn *)calloc(1, sizeof(*conn));
+	if (NULL == conn) {
+		return NULL;
+	}
+	for (e = 0; e < 2; e++) {
+		conn->ends[e].port_num = -1;
+		conn->ends[e].ep = -1;
+	}
+	conn->idx = cfg->conn_cnt;
+	free(cfg->cons[cfg->conn_cnt]);
+	cfg->cons[cfg->conn_cnt] = conn;
+	return conn;
+}
+
+/* Counts the endpoint returned by cfg_new_ep() once it is complete.
+ * Returns 1 if the name or a comptag is already used by another device,
+ * or if no memory is available for the indexes.
+ */
+int cfg_add_ep(struct int_cfg_parms *cfg, struct int_cfg_ep *ep)
 {
-	char *rc = NULL;
-	size_t byte_cnt = 1;
-	int done = 0;
+	int p;
 
-	if (cfg->init_err)
+	if (cfg_idx_add_name(&cfg->ep_name_idx, ep->name, ep)) {
 		goto fail;
+	}
+	for (p = 0; p < ep->port_cnt; p++) {
+		if (!ep->ports[p].valid) {
+			continue;
+		}
+		if ((NULL != cfg_idx_find(&cfg->sw_ct_idx, ep->ports[p].ct,
+								NULL))
+				|| cfg_idx_add(&cfg->ep_ct_idx,
+						ep->ports[p].ct, NULL, ep)) {
+			goto fail;
+		}
+	}
 
-	if (NULL == line) {
-		line = (char *)calloc(1, LINE_SIZE);
-		rc = NULL;
-	} else {
-		rc = strtok_r(NULL, delim, &save_ptr);
+	ep->valid = 1;
+	cfg->ep_cnt++;
+	return 0;
+fail:
+	return 1;
+}
+
+int cfg_add_sw(struct int_cfg_parms *cfg, struct int_cfg_sw *sw)
+{
+	if (cfg_idx_add_name(&cfg->sw_name_idx, sw->name, sw)
+			|| (NULL != cfg_idx_find(&cfg->ep_ct_idx, sw->ct, NULL))
+			|| cfg_idx_add(&cfg->sw_ct_idx, sw->ct, NULL, sw)) {
+		return 1;
 	}
 
-	while (!done) {
-		while ((NULL == rc) && (byte_cnt > 0)) {
-			DBG("\n");
-			byte_cnt = LINE_SIZE;
-			byte_cnt = getline(&line, &byte_cnt, cfg_fd);
-			strip_crlf(line);
-			rc = strtok_r(line, delim, &save_ptr);
-		}
+	sw->valid = 1;
+	cfg->sw_cnt++;
+	return 0;
+}
 
-		if (byte_cnt <= 0) {
-			rc = NULL;
-			break;
+/* Routing tables are only allocated for switches and ports that use them */
+static rio_rt_state_t *get_rt(rio_rt_state_t **rt)
+{
+	if (NULL == *rt) {
+		*rt = (rio_rt_state_t *)malloc(sizeof(rio_rt_state_t));
+		if (NULL != *rt) {
+			init_rt(*rt);
 		}
+	}
+	return *rt;
+}
 
-		if (NULL != rc) {
-			done = strncmp(rc, "//", 2);
-			if (!done) {
-				flush_comment(rc);
-				rc = NULL;
-			}
-		}
+void cfg_free_parms(struct int_cfg_parms *cfg)
+{
+	uint32_t i;
+
+	if (NULL == cfg) {
+		return;
 	}
 
-	if (NULL != rc) {
-		DBG("%s\n", rc);
+	for (i = 0; i < cfg->ep_alloc; i++) {
+		free_ep(cfg->eps[i]);
+	}
+	for (i = 0; i < cfg->sw_alloc; i++) {
+		free_sw(cfg, cfg->sws[i]);
+	}
+	for (i = 0; i < cfg->conn_alloc; i++) {
+		free(cfg->cons[i]);
+	}
+	free(cfg->eps);
+	free(cfg->sws);
+	free(cfg->cons);
+	free(cfg->mport_info);
+	cfg_idx_free(&cfg->ep_ct_idx);
+	cfg_idx_free(&cfg->sw_ct_idx);
+	cfg_idx_free(&cfg->ep_name_idx);
+	cfg_idx_free(&cfg->sw_name_idx);
+	cfg_idx_free(&cfg->dev_ct_idx);
+	free(cfg->devs);
+	free(cfg->adj_base);
+	free(cfg->adj);
+	cfg_cache_unmap(cfg);
+	free_string(&cfg->dd_mtx_fn);
+	free_string(&cfg->dd_fn);
+	free(cfg);
+}
+
+#define CFG_DELIM " \t\r"
+#define CFG_COMMENT "//"
+
+static void flush_comment(struct int_cfg_parms *cfg)
+{
+	tok_rdr_next_line(&cfg->rdr);
+}
+
+static char *try_get_next_token(struct int_cfg_parms *cfg)
+{
+	struct tok_view tok;
+
+	if (cfg->init_err || tok_rdr_next(&cfg->rdr, &tok)) {
+		return NULL;
 	}
 
-fail:
-	return rc;
+	DBG("%s\n", tok.str);
+	return tok.str;
 }
 
 #define PARSE_ERR(cfg, format, ...)			\
 	if (NULL != cfg) {				\
 		if (!cfg->init_err) {			\
 			ERR(format, ## __VA_ARGS__);	\
+			ERR("CFG: line %u column %u\n",	\
+				cfg->rdr.last.line,	\
+				cfg->rdr.last.col);	\
 		}					\
 		cfg->init_err = 1;			\
 	}
@@ -403,32 +551,14 @@ fail:
 
 static int find_ep_name(struct int_cfg_parms *cfg, char *name, struct int_cfg_ep **ep)
 {
-	uint32_t i;
-
-	for (i = 0; i < cfg->ep_cnt; i++) {
-		if (!strcmp(name, cfg->eps[i].name) &&
-			(strlen(name) == strlen(cfg->eps[i].name))) {
-			*ep = &cfg->eps[i];
-			return 0;
-		}
-	}
-	*ep = NULL;
-	return 1;
+	*ep = (struct int_cfg_ep *)cfg_idx_find_name(&cfg->ep_name_idx, name);
+	return (NULL == *ep);
 }
 
 static int find_sw_name(struct int_cfg_parms *cfg, char *name, struct int_cfg_sw **sw)
 {
-	uint32_t i;
-
-	for (i = 0; i < cfg->sw_cnt; i++) {
-		if (!strcmp(name, cfg->sws[i].name) &&
-			(strlen(name) == strlen(cfg->sws[i].name))) {
-			*sw = &cfg->sws[i];
-			return 0;
-		}
-	}
-	*sw = NULL;
-	return 1;
+	*sw = (struct int_cfg_sw *)cfg_idx_find_name(&cfg->sw_name_idx, name);
+	return (NULL == *sw);
 }
 
 static int find_ep_and_port(struct int_cfg_parms *cfg, char *tok,
@@ -725,8 +855,8 @@ static int parse_mport_info(struct int_cfg_parms *cfg)
 {
 	int idx, i;
 
-	if (cfg->max_mport_info_idx >= CFG_MAX_MPORTS) {
-		PARSE_ERR(cfg, (char *)"Too many MPORTs.");
+	if (NULL == cfg_new_mport(cfg)) {
+		PARSE_ERR(cfg, (char *)"Out of memory for MPORTs.");
 		goto fail;
 	}
 
@@ -989,36 +1119,37 @@ fail:
 
 static int parse_endpoint(struct int_cfg_parms *cfg)
 {
-	int i = cfg->ep_cnt;
+	struct int_cfg_ep *ep;
 	int done = 0;
 
-	if (i >= CFG_MAX_EP) {
-		PARSE_ERR(cfg, (char *)"Too many endpoints.");
+	ep = cfg_new_ep(cfg);
+	if (NULL == ep) {
+		PARSE_ERR(cfg, (char *)"Out of memory for endpoints.");
 		goto fail;
 	}
 
-	if (get_string(cfg, &cfg->eps[i].name)) {
+	if (get_string(cfg, &ep->name)) {
 		goto fail;
 	}
 
-	cfg->eps[i].port_cnt = 0;
-	while (!done && (cfg->eps[i].port_cnt < CFG_MAX_EP_PORT + 1)) {
+	ep->port_cnt = 0;
+	while (!done && (ep->port_cnt < CFG_MAX_EP_PORT + 1)) {
 		int pt_i;
 		switch (get_parm_idx(cfg, (char *)"PORT PEND")) {
 		case 0: // "PORT"
-			pt_i = cfg->eps[i].port_cnt;
-			if (cfg->eps[i].port_cnt >= CFG_MAX_EP_PORT) {
+			pt_i = ep->port_cnt;
+			if (ep->port_cnt >= CFG_MAX_EP_PORT) {
 				PARSE_ERR(cfg, (char *)"Too many ports!");
 				goto fail;
 			}
 
-			if (parse_ep_port(cfg, &cfg->eps[i].ports[pt_i])) {
+			if (parse_ep_port(cfg, &ep->ports[pt_i])) {
 				goto fail;
 			}
 
-			cfg->eps[i].port_cnt++;
-			if (match_ep_to_mports(cfg, &cfg->eps[i].ports[pt_i],
-						pt_i, &cfg->eps[i])) {
+			ep->port_cnt++;
+			if (match_ep_to_mports(cfg, &ep->ports[pt_i],
+						pt_i, ep)) {
 				goto fail;
 			}
 			break;
@@ -1031,8 +1162,10 @@ static int parse_endpoint(struct int_cfg_parms *cfg)
 		}
 	}
 
-	cfg->eps[i].valid = 1;
-	cfg->ep_cnt++;
+	if (cfg_add_ep(cfg, ep)) {
+		PARSE_ERR(cfg, (char *)"Duplicate endpoint name or comptag.");
+		goto fail;
+	}
 	return 0;
 
 fail:
@@ -1163,19 +1296,24 @@ fail:
 
 static int parse_sw_port(struct int_cfg_parms *cfg)
 {
-	uint32_t idx = cfg->sw_cnt;
+	struct int_cfg_sw *sw = cfg->sws[cfg->sw_cnt];
 	uint32_t port;
 
 	if (get_dec_int(cfg, &port)) {
 		goto fail;
 	}
 
-	if (parse_rapidio(cfg, &cfg->sws[idx].ports[port].rio)) {
+	if (port >= CFG_MAX_SW_PORT) {
+		PARSE_ERR(cfg, (char *)"Illegal port %d.", port);
+		goto fail;
+	}
+
+	if (parse_rapidio(cfg, &sw->ports[port].rio)) {
 		goto fail;
 	}
 
-	cfg->sws[idx].ports[port].valid = 1;
-	cfg->sws[idx].ports[port].port  = port;
+	sw->ports[port].valid = 1;
+	sw->ports[port].port  = port;
 
 	return 0;
 
@@ -1185,7 +1323,8 @@ fail:
 
 static int parse_switch(struct int_cfg_parms *cfg)
 {
-	uint32_t i, done = 0;
+	struct int_cfg_sw *sw;
+	uint32_t done = 0;
 	uint32_t rt_sz = 0;
 	did_val_t st_did_val;
 	did_val_t end_did_val;
@@ -1193,27 +1332,27 @@ static int parse_switch(struct int_cfg_parms *cfg)
 	uint32_t tmp;
 	rio_rt_state_t *rt = NULL;
 
-	if (cfg->sw_cnt >= CFG_MAX_SW) {
-		PARSE_ERR(cfg, (char *)"Too many switches.");
+	sw = cfg_new_sw(cfg);
+	if (NULL == sw) {
+		PARSE_ERR(cfg, (char *)"Out of memory for switches.");
 		goto fail;
 	}
-	i = cfg->sw_cnt;
 
-	if (get_string(cfg, &cfg->sws[i].dev_type))
+	if (get_string(cfg, &sw->dev_type))
 		goto fail;
-	if (get_string(cfg, &cfg->sws[i].name))
+	if (get_string(cfg, &sw->name))
 		goto fail;
-	if (get_devid_sz(cfg, &cfg->sws[i].did_sz_idx))
+	if (get_devid_sz(cfg, &sw->did_sz_idx))
 		goto fail;
-	if (get_hex_int(cfg, &cfg->sws[i].did_val))
+	if (get_hex_int(cfg, &sw->did_val))
 		goto fail;
 	if (get_dec_int(cfg, &tmp))
 		goto fail;
 	if (tmp > HC_MP)
 		goto fail;
 
-	cfg->sws[i].hc = tmp;
-	if (get_hex_int(cfg, &cfg->sws[i].ct)) {
+	sw->hc = tmp;
+	if (get_hex_int(cfg, &sw->ct)) {
 		goto fail;
 	}
 
@@ -1240,23 +1379,30 @@ static int parse_switch(struct int_cfg_parms *cfg)
 
 			switch (parm_idx(token, (char *)"GLOBAL")) {
 			case 0:
-				rt = &cfg->sws[i].rt[rt_sz];
-				cfg->sws[i].rt_valid[rt_sz] = true;
+				rt = get_rt(&sw->rt[rt_sz]);
+				if (NULL == rt) {
+					PARSE_ERR(cfg, (char *)"Out of memory.");
+					goto fail;
+				}
 				break;
 			default:
 				uint32_t port;
-				if (tok_parse_port_num(token, &port, 0)) {
+				if (tok_parse_port_num(token, &port, 0)
+						|| (port >= CFG_MAX_SW_PORT)) {
 					PARSE_ERR(cfg, (char *)"Illegal port.");
 					goto fail;
 				}
 
-				rt = &cfg->sws[i].ports[port].rt[rt_sz];
-				cfg->sws[i].ports[port].rt_valid[rt_sz] = true;
+				rt = get_rt(&sw->ports[port].rt[rt_sz]);
+				if (NULL == rt) {
+					PARSE_ERR(cfg, (char *)"Out of memory.");
+					goto fail;
+				}
 				// If the global routing table is valid,
 				// copy the global routing table to the
 				// port routing table.
-				if (cfg->sws[i].rt_valid[rt_sz]) {
-					memcpy(rt, &cfg->sws[i].rt[rt_sz],
+				if (NULL != sw->rt[rt_sz]) {
+					memcpy(rt, sw->rt[rt_sz],
 							sizeof(rio_rt_state_t));
 				}
 				break;
@@ -1288,8 +1434,8 @@ static int parse_switch(struct int_cfg_parms *cfg)
 			// rt is set whenever ROUTING_TABLE option (above) is hit
 			//
 			// That option, if successfull, will set
-			// cfg->sws[i].rt_valid[rt_sz] = true; or
-			// cfg->sws[i].ports[port].rt_valid[rt_sz] = true;
+			// sw->rt[rt_sz] or
+			// sw->ports[port].rt[rt_sz]
 			//
 			if (NULL == rt) {
 				PARSE_ERR(cfg, (char *)"DESTID: rt not set.");
@@ -1345,8 +1491,10 @@ static int parse_switch(struct int_cfg_parms *cfg)
 		}
 	}
 
-	cfg->sws[i].valid = 1;
-	cfg->sw_cnt++;
+	if (cfg_add_sw(cfg, sw)) {
+		PARSE_ERR(cfg, (char *)"Duplicate switch name or comptag.");
+		goto fail;
+	}
 	return 0;
 
 fail:
@@ -1355,23 +1503,24 @@ fail:
 
 static int parse_connect(struct int_cfg_parms *cfg)
 {
-	int idx = cfg->conn_cnt;
+	struct int_cfg_conn *conn;
 
-	if (cfg->conn_cnt >= CFG_MAX_CONN) {
-		PARSE_ERR(cfg, (char *)"Too many connections.");
+	conn = cfg_new_conn(cfg);
+	if (NULL == conn) {
+		PARSE_ERR(cfg, (char *)"Out of memory for connections.");
 		goto fail;
 	}
 
-	if (get_ep_sw_and_port(cfg, &cfg->cons[idx], 0)) {
+	if (get_ep_sw_and_port(cfg, conn, 0)) {
 		goto fail;
 	}
 
-	if (get_ep_sw_and_port(cfg, &cfg->cons[idx], 1)) {
+	if (get_ep_sw_and_port(cfg, conn, 1)) {
 		goto fail;
 	}
 
 	cfg->conn_cnt++;
-	cfg->cons[idx].valid = 1;
+	conn->valid = 1;
 
 	return 0;
 fail:
@@ -1389,7 +1538,7 @@ static int fmd_parse_cfg(struct int_cfg_parms *cfg)
 		switch (parm_idx(tok, (char *)
 	"// DEV_DIR DEV_DIR_MTX MPORT MASTER_INFO ENDPOINT SWITCH CONNECT AUTO AUTO16 EOF")) {
 		case 0: // "//"
-			flush_comment(tok);
+			flush_comment(cfg);
 			break;
 		case 1: // "DEV_DIR"
 			if (get_next_token(cfg, &tok)) {
@@ -1443,8 +1592,6 @@ static int fmd_parse_cfg(struct int_cfg_parms *cfg)
 	}
 
 exit:
-	free(line);
-	line = NULL;
 	return cfg->init_err;
 }
 
@@ -1461,31 +1608,47 @@ int cfg_parse_file(char *cfg_fn, char **dd_mtx_fn, char **dd_fn,
 	did_val_t did_val;
 	did_sz_t did_sz;
 
-	struct int_cfg_ep ep;
-	struct int_cfg_ep_port port;
-	struct int_cfg_sw sw;
+	struct int_cfg_ep *ep;
+	struct int_cfg_ep_port *port;
+	struct int_cfg_sw *sw;
+
+	char cache_fn[PATH_MAX];
+	bool use_cache;
+	uint64_t src_hash;
+	int rc = 1;
 
 	if (init_cfg_ptr()) {
 		goto fail;
 	}
 
 	INFO("\nCFG: Opening configuration file \"%s\"...\n", cfg_fn);
-	cfg_fd = fopen(cfg_fn, "r");
-	if (NULL == cfg_fd) {
+	if (tok_rdr_open(&cfg->rdr, cfg_fn, CFG_DELIM, CFG_COMMENT)) {
 		WARN("CFG: Config file open failed, errno %d : %s\n",
 				errno, strerror(errno));
 		goto fail;
 	}
 
-	DBG("\nCFG: Config file contents:");
-	fmd_parse_cfg(cfg);
-
-	if (fclose(cfg_fd)) {
-		ERR("CFG: Config file close failed, errno %d : %s\n",
-				errno, strerror(errno));
+	// Use the binary cache if it was built from the same text,
+	// otherwise parse the file and rebuild the cache.
+	src_hash = cfg_cache_hash(cfg->rdr.buf, cfg->rdr.size);
+	use_cache = !cfg_cache_name(cfg_fn, cache_fn, sizeof(cache_fn));
+	if (use_cache) {
+		rc = cfg_cache_load(cfg, cache_fn, src_hash);
 	}
 
-	cfg_fd = NULL;
+	if (rc > 0) {
+		DBG("\nCFG: Config file contents:");
+		fmd_parse_cfg(cfg);
+		if (use_cache && !cfg->init_err) {
+			cfg_cache_save(cfg, cache_fn, src_hash);
+		}
+	} else if (rc < 0) {
+		ERR("CFG: Out of memory loading cache \"%s\"\n", cache_fn);
+		cfg->init_err = true;
+	} else {
+		INFO("CFG: Loaded cache \"%s\"\n", cache_fn);
+	}
+	tok_rdr_close(&cfg->rdr);
 
 	//@sonar:off - Collapsible "if" statements should be merged
 	if (cfg->dd_mtx_fn && strlen(cfg->dd_mtx_fn)) {
@@ -1505,16 +1668,21 @@ int cfg_parse_file(char *cfg_fn, char **dd_mtx_fn, char **dd_fn,
 		goto fail;
 	}
 
+	if (cfg_build_adj(cfg)) {
+		ERR("CFG: Out of memory for the device tables\n");
+		goto fail;
+	}
+
 	// mark the endpoint ct and devIds from the configuration as in use
 	for(i = 0; i < cfg->ep_cnt; i++) {
 		ep = cfg->eps[i];
-		if (ep.valid) {
-			for (j = 0; j < ep.port_cnt; j++) {
-				port = ep.ports[j];
-				if (port.valid) {
-					if (ct_get_nr(&nr, (ct_t)port.ct)) {
+		if (ep->valid) {
+			for (j = 0; j < ep->port_cnt; j++) {
+				port = &ep->ports[j];
+				if (port->valid) {
+					if (ct_get_nr(&nr, (ct_t)port->ct)) {
 						ERR("Get NR from CT 0x%x",
-								(ct_t)port.ct);
+								(ct_t)port->ct);
 						goto fail;
 					}
 					
@@ -1522,9 +1690,9 @@ int cfg_parse_file(char *cfg_fn, char **dd_mtx_fn, char **dd_fn,
 						continue;
 					}
 
-					did_val = port.devids[cfg->mast_did_sz_idx].did_val;
+					did_val = port->devids[cfg->mast_did_sz_idx].did_val;
 					if (did_val && ct_create_from_data(&ct, &did, nr, did_val, did_sz)) {
-						ERR("CT create CT 0x%x size %d", (ct_t)port.ct, did_sz);
+						ERR("CT create CT 0x%x size %d", (ct_t)port->ct, did_sz);
 						goto fail;
 					}
 				}
@@ -1535,18 +1703,18 @@ int cfg_parse_file(char *cfg_fn, char **dd_mtx_fn, char **dd_fn,
 	// mark the switch ct and devIds from the configuration as in use
 	for(i=0; i < cfg->sw_cnt; i++) {
 		sw = cfg->sws[i];
-		if (sw.valid) {
-			if (ct_get_nr(&nr, sw.ct)) {
+		if (sw->valid) {
+			if (ct_get_nr(&nr, sw->ct)) {
 				goto fail;
 			}
 
 			// Continue for unsupported sizes
-			if (did_size_from_int(&did_sz, sw.did_sz_idx)) {
+			if (did_size_from_int(&did_sz, sw->did_sz_idx)) {
 				continue;
 			}
 
-			if (ct_create_from_data(&ct, &did, nr, sw.did_val, did_sz)) {
-				ERR("SW CT create 0x%x", sw.ct);
+			if (ct_create_from_data(&ct, &did, nr, sw->did_val, did_sz)) {
+				ERR("SW CT create 0x%x", sw->ct);
 				goto fail;
 			}
 		}
@@ -1590,37 +1758,15 @@ fail:
 
 struct int_cfg_sw *find_cfg_sw_by_ct(ct_t ct, struct int_cfg_parms *cfg)
 {
-	struct int_cfg_sw *ret = NULL;
-	uint32_t i;
-
-	for (i = 0; i < cfg->sw_cnt; i++) {
-		if (cfg->sws[i].ct == ct) {
-			ret = &cfg->sws[i];
-			break;
-		}
-	}
-	return ret;
+	return (struct int_cfg_sw *)cfg_idx_find(&cfg->sw_ct_idx, ct, NULL);
 }
 
 struct int_cfg_ep *find_cfg_ep_by_ct(ct_t ct, struct int_cfg_parms *cfg)
 {
-	struct int_cfg_ep *ret = NULL;
-	uint32_t i, p;
+	struct int_cfg_ep *ret;
+	uint32_t i;
 
-	for (i = 0; (i < cfg->ep_cnt) && (NULL == ret); i++) {
-		if (!cfg->eps[i].valid) {
-			continue;
-		}
-		for (p = 0; (p < CFG_MAX_EP_PORT) && (NULL == ret); p++) {
-			if (!cfg->eps[i].ports[p].valid) {
-				continue;
-			}
-			if (cfg->eps[i].ports[p].ct == ct) {
-				ret = &cfg->eps[i];
-				break;
-			}
-		}
-	}
+	ret = (struct int_cfg_ep *)cfg_idx_find(&cfg->ep_ct_idx, ct, NULL);
 
 	for (i = 0; (i < cfg->max_mport_info_idx) && (NULL == ret); i++) {
 		if (cfg->mport_info[i].ct == ct) {
@@ -1706,101 +1852,173 @@ static int fill_in_dev_from_sw(struct cfg_dev *dev, struct int_cfg_sw *sw)
 		dev->sw_info.sw_pt[i].iseq = sw->ports[i].rio.iseq;
 
 		for (int sz = 0; sz < MAX_DEV_SZ_IDX; sz++) {
-			if (sw->ports[i].rt_valid[sz]) {
-				dev->sw_info.sw_pt[i].rt[sz] =
-					&sw->ports[i].rt[sz];
-			} else {
-				dev->sw_info.sw_pt[i].rt[sz] = NULL;
-			}
+			dev->sw_info.sw_pt[i].rt[sz] = sw->ports[i].rt[sz];
 		}
 	}
 
 	for (int sz = 0; sz < MAX_DEV_SZ_IDX; sz++) {
-		if (sw->rt_valid[sz]) {
-			dev->sw_info.rt[sz] = &sw->rt[sz];
-		} else {
-			dev->sw_info.rt[sz] = NULL;
-		}
+		dev->sw_info.rt[sz] = sw->rt[sz];
 	}
 
 	return 0;
 }
 
-int cfg_find_dev_by_ct(ct_t ct, struct cfg_dev *dev)
+static void set_adj(struct cfg_adj *adj, struct int_cfg_conn *conn,
+		int conn_end)
 {
-	struct int_cfg_ep *ep = NULL;
-	struct int_cfg_sw *sw = NULL;
+	struct int_cfg_conn_pe *end;
+	int oe;
 
-	ep = find_cfg_ep_by_ct(ct, cfg);
-	if (NULL != ep) {
-		return fill_in_dev_from_ep(dev, ep);
+	adj->peer_port = -1;
+	if ((NULL == conn) || !conn->valid) {
+		return;
 	}
 
-	sw = find_cfg_sw_by_ct(ct, cfg);
-	if (NULL != sw) {
-		return fill_in_dev_from_sw(dev, sw);
+	oe = OTHER_END(conn_end);
+	if ((conn_end > 1) || (oe > 1)) {
+		return;
 	}
 
-	return 1;
+	end = &conn->ends[oe];
+	adj->peer = end->ep ? end->ep_h->dev : end->sw_h->dev;
+	if (NULL == adj->peer) {
+		return;
+	}
+	adj->peer_ct = adj->peer->ct;
+	adj->peer_is_sw = adj->peer->is_sw;
+	adj->peer_port = end->port_num;
 }
 
-int cfg_get_conn_dev(ct_t ct, int pt,
-		struct cfg_dev *dev, int *conn_pt)
+/**
+ * @brief Builds the read only device and link tables used by
+ *        cfg_find_dev_by_ct() and cfg_get_conn_dev().
+ *
+ * @param[in] cfg Parsed configuration
+ * @retval 0 on success, 1 if no memory is available
+ */
+int cfg_build_adj(struct int_cfg_parms *cfg)
 {
-	struct int_cfg_conn *conn = NULL;
-	int conn_end = -1, oe;
-	struct int_cfg_ep *ep;
+	uint32_t max_devs = cfg->ep_cnt + cfg->sw_cnt;
+	uint32_t max_adj = (cfg->ep_cnt * CFG_MAX_EP_PORT)
+			+ (cfg->sw_cnt * CFG_MAX_SW_PORT);
+	uint32_t i, n = 0, adj_cnt = 0;
+	struct cfg_adj *adj;
+	int p;
 
-	ep = find_cfg_ep_by_ct(ct, cfg);
+	cfg->devs = (struct cfg_dev *)calloc(max_devs + 1,
+			sizeof(struct cfg_dev));
+	cfg->adj_base = (uint32_t *)calloc(max_devs + 1, sizeof(uint32_t));
+	cfg->adj = (struct cfg_adj *)calloc(max_adj + 1,
+			sizeof(struct cfg_adj));
+	if ((NULL == cfg->devs) || (NULL == cfg->adj_base)
+			|| (NULL == cfg->adj)) {
+		goto fail;
+	}
+
+	// Parsing rejects comptags used by more than one device, so adding
+	// a device to the comptag index only fails when memory runs out.
+	for (i = 0; i < cfg->ep_cnt; i++) {
+		struct int_cfg_ep *ep = cfg->eps[i];
 
-	if (NULL != ep) {
-		if (pt) {
+		if (!ep->valid || fill_in_dev_from_ep(&cfg->devs[n], ep)) {
+			continue;
+		}
+		ep->dev = &cfg->devs[n];
+		for (p = 0; p < ep->port_cnt; p++) {
+			if (ep->ports[p].valid) {
+				if (cfg_idx_add(&cfg->dev_ct_idx,
+						ep->ports[p].ct, NULL,
+						ep->dev)) {
+					goto fail;
+				}
+			}
+		}
+		cfg->adj_base[n++] = adj_cnt;
+		adj_cnt += CFG_MAX_EP_PORT;
+	}
+
+	for (i = 0; i < cfg->sw_cnt; i++) {
+		struct int_cfg_sw *sw = cfg->sws[i];
+
+		if (!sw->valid || fill_in_dev_from_sw(&cfg->devs[n], sw)) {
+			continue;
+		}
+		sw->dev = &cfg->devs[n];
+		if (cfg_idx_add(&cfg->dev_ct_idx, sw->ct, NULL, sw->dev)) {
 			goto fail;
 		}
-		conn = ep->ports[0].conn;
-		conn_end = ep->ports[0].conn_end;
+		cfg->adj_base[n++] = adj_cnt;
+		adj_cnt += CFG_MAX_SW_PORT;
 	}
+	cfg->dev_cnt = n;
 
-	if (NULL == ep) {
-		struct int_cfg_sw *sw;
+	// Every device now has an entry in devs, fill in the link partners
+	for (i = 0; i < cfg->ep_cnt; i++) {
+		struct int_cfg_ep *ep = cfg->eps[i];
 
-		sw = find_cfg_sw_by_ct(ct, cfg);
-		if (NULL != sw) {
-			if (pt >= CFG_MAX_SW_PORT) {
-				goto fail;
-			}
+		if (NULL == ep->dev) {
+			continue;
+		}
+		adj = &cfg->adj[cfg->adj_base[ep->dev - cfg->devs]];
+		for (p = 0; p < CFG_MAX_EP_PORT; p++) {
+			set_adj(&adj[p], ep->ports[p].conn,
+					ep->ports[p].conn_end);
+		}
+	}
 
-			if (!sw->ports[pt].valid) {
-				goto fail;
-			}
+	for (i = 0; i < cfg->sw_cnt; i++) {
+		struct int_cfg_sw *sw = cfg->sws[i];
 
-			if (sw->ports[pt].port != pt) {
-				goto fail;
+		if (NULL == sw->dev) {
+			continue;
+		}
+		adj = &cfg->adj[cfg->adj_base[sw->dev - cfg->devs]];
+		for (p = 0; p < CFG_MAX_SW_PORT; p++) {
+			adj[p].peer_port = -1;
+			if (sw->ports[p].valid && (sw->ports[p].port == p)) {
+				set_adj(&adj[p], sw->ports[p].conn,
+						sw->ports[p].conn_end);
 			}
-			conn = sw->ports[pt].conn;
-			conn_end = sw->ports[pt].conn_end;
 		}
 	}
 
-	if (NULL == conn) {
+	return 0;
+fail:
+	return 1;
+}
+
+int cfg_find_dev_by_ct(ct_t ct, const struct cfg_dev **dev)
+{
+	*dev = (const struct cfg_dev *)cfg_idx_find(&cfg->dev_ct_idx, ct,
+			NULL);
+	return (NULL == *dev);
+}
+
+int cfg_get_conn_dev(ct_t ct, int pt, const struct cfg_dev **dev,
+		int *conn_pt)
+{
+	const struct cfg_dev *curr;
+	const struct cfg_adj *adj;
+
+	curr = (const struct cfg_dev *)cfg_idx_find(&cfg->dev_ct_idx, ct,
+			NULL);
+	if (NULL == curr) {
 		goto fail;
 	}
 
-	if (!conn->valid) {
+	if ((pt < 0) || (pt >= (curr->is_sw ? CFG_MAX_SW_PORT
+						: CFG_MAX_EP_PORT))) {
 		goto fail;
 	}
 
-	oe = OTHER_END(conn_end);
-	if ((conn_end > 1) || (oe > 1)) {
+	adj = &cfg->adj[cfg->adj_base[curr - cfg->devs] + pt];
+	if (NULL == adj->peer) {
 		goto fail;
 	}
 
-	*conn_pt = conn->ends[oe].port_num;
-	if (conn->ends[oe].ep) {
-		return fill_in_dev_from_ep(dev, conn->ends[oe].ep_h);
-	} else {
-		return fill_in_dev_from_sw(dev, conn->ends[oe].sw_h);
-	}
+	*dev = adj->peer;
+	*conn_pt = adj->peer_port;
+	return 0;
 
 fail:
 	return 1;
@@ -0,0 +1,856 @@
+/* Binary cache of the parsed fabric configuration */
+/* Fabric Management Daemon Configuration file and options parsing support */
+/*
+****************************************************************************
+Copyright (c) 2014, Integrated Device Technology Inc.
+Copyright (c) 2014, RapidIO Trade Association
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+may be used to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************
+*/
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "libcli.h"
+#include "liblog.h"
+#include "string_util.h"
+#include "cfg_private.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CFG_CACHE_MAGIC 0x47464342 /* "BCFG" */
+#define CFG_CACHE_VERSION 1
+#define CFG_CACHE_ALIGN 64
+#define CFG_CACHE_NO_IDX -1
+#define CFG_CACHE_NO_STR UINT32_MAX
+
+/* Image layout, each section starts on a CFG_CACHE_ALIGN boundary:
+ *   struct cfg_cache_hdr
+ *   struct cfg_cache_mport[mport_cnt]
+ *   struct cfg_cache_ep[ep_cnt]
+ *   struct cfg_cache_sw[sw_cnt]
+ *   struct cfg_cache_conn[conn_cnt]
+ *   rio_rt_state_t[rt_cnt]
+ *   strings, each NUL terminated
+ *
+ * Records refer to each other by index and to strings by offset, so the
+ * image does not depend on where it is mapped.  The routing tables are
+ * used in place from a private mapping.
+ */
+struct cfg_cache_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t size; /* Bytes in the image, including this header */
+	uint64_t src_hash; /* cfg_cache_hash() of the configuration file */
+	uint64_t checksum; /* cfg_cache_hash() of everything after the header */
+	// Record sizes, an image written by a different build is rejected
+	uint32_t mport_sz;
+	uint32_t ep_sz;
+	uint32_t sw_sz;
+	uint32_t conn_sz;
+	uint32_t rt_sz;
+	uint32_t mport_cnt;
+	uint32_t ep_cnt;
+	uint32_t sw_cnt;
+	uint32_t conn_cnt;
+	uint32_t rt_cnt;
+	uint64_t mport_off;
+	uint64_t ep_off;
+	uint64_t sw_off;
+	uint64_t conn_off;
+	uint64_t rt_off;
+	uint64_t str_off;
+	uint64_t str_size;
+	int32_t mast_idx;
+	did_val_t mast_did_val;
+	uint32_t mast_did_sz_idx;
+	uint32_t mast_cm_port;
+	uint32_t auto_config;
+	uint32_t dd_mtx_fn; /* String offsets */
+	uint32_t dd_fn;
+};
+
+struct cfg_cache_mport {
+	uint32_t num;
+	ct_t ct;
+	int32_t op_mode;
+	uint32_t mem_sz;
+	struct dev_id devids[MAX_DEV_SZ_IDX];
+	int32_t ep; /* Index of the endpoint, CFG_CACHE_NO_IDX if none */
+	int32_t ep_pnum;
+};
+
+struct cfg_cache_ep_port {
+	int32_t valid;
+	uint32_t port;
+	ct_t ct;
+	struct int_cfg_rapidio rio;
+	struct dev_id devids[MAX_DEV_SZ_IDX];
+	int32_t conn; /* Index of the connection, CFG_CACHE_NO_IDX if none */
+	int32_t conn_end;
+};
+
+struct cfg_cache_ep {
+	uint32_t name;
+	int32_t port_cnt;
+	struct cfg_cache_ep_port ports[CFG_MAX_EP_PORT];
+};
+
+struct cfg_cache_sw_port {
+	int32_t valid;
+	int32_t port;
+	struct int_cfg_rapidio rio;
+	int32_t conn;
+	int32_t conn_end;
+	int32_t rt[MAX_DEV_SZ_IDX]; /* Routing table, CFG_CACHE_NO_IDX if none */
+};
+
+struct cfg_cache_sw {
+	uint32_t name;
+	uint32_t dev_type;
+	did_val_t did_val;
+	uint32_t did_sz_idx;
+	hc_t hc;
+	ct_t ct;
+	struct cfg_cache_sw_port ports[CFG_MAX_SW_PORT];
+	int32_t rt[MAX_DEV_SZ_IDX];
+};
+
+struct cfg_cache_conn {
+	int32_t port_num[2];
+	int32_t ep[2]; /* 1 - Endpoint, 0 - Switch */
+	int32_t idx[2]; /* Index of the endpoint or switch */
+};
+
+/* Word at a time multiplicative hash, used for change detection and as
+ * the image checksum.
+ */
+uint64_t cfg_cache_hash(const void *buf, size_t len)
+{
+	const uint8_t *p = (const uint8_t *)buf;
+	uint64_t h = 0xcbf29ce484222325ULL ^ len;
+	uint64_t w;
+
+	for (; len >= sizeof(w); p += sizeof(w), len -= sizeof(w)) {
+		memcpy(&w, p, sizeof(w));
+		h = (h ^ w) * 0x100000001b3ULL;
+		h ^= h >> 29;
+	}
+	if (len) {
+		w = 0;
+		memcpy(&w, p, len);
+		h = (h ^ w) * 0x100000001b3ULL;
+		h ^= h >> 29;
+	}
+	return h;
+}
+
+static char cfg_cache_dir[PATH_MAX] = CFG_CACHE_DIR;
+
+void cfg_cache_set_dir(const char *dir)
+{
+	SAFE_STRNCPY(cfg_cache_dir, (NULL == dir) ? CFG_CACHE_DIR : dir,
+			sizeof(cfg_cache_dir));
+}
+
+// The FMD runs as root, so a cache anyone else can write could set the
+// routing of the fabric.
+static bool cache_stat_ok(struct stat *st)
+{
+	return (st->st_uid == geteuid())
+			&& !(st->st_mode & (S_IWGRP | S_IWOTH));
+}
+
+// Checks the cache directory, creating it if create is true.
+static bool cache_dir_ok(bool create)
+{
+	struct stat st;
+
+	if (lstat(cfg_cache_dir, &st)) {
+		if (!create || (ENOENT != errno)
+				|| mkdir(cfg_cache_dir, 0700)
+				|| lstat(cfg_cache_dir, &st)) {
+			return false;
+		}
+	}
+	if (!S_ISDIR(st.st_mode) || !cache_stat_ok(&st)) {
+		WARN("CFG: Cache directory \"%s\" is not private, not used\n",
+				cfg_cache_dir);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Returns the name of the binary cache for a configuration file.
+ *        Each configuration file, identified by its absolute path, has
+ *        its own cache in the cache directory, see cfg_cache_set_dir().
+ *
+ * @param[in] cfg_fn Configuration file name
+ * @param[out] cache_fn Cache file name
+ * @param[in] len Size of cache_fn
+ * @retval 0 on success, 1 if cache_fn is too small
+ */
+int cfg_cache_name(const char *cfg_fn, char *cache_fn, size_t len)
+{
+	char path[PATH_MAX];
+	const char *fn = cfg_fn;
+	int rc;
+
+	if (NULL != realpath(cfg_fn, path)) {
+		fn = path;
+	}
+	rc = snprintf(cache_fn, len, "%s/fmd_cfg_%016llx.bin", cfg_cache_dir,
+			(unsigned long long)cfg_cache_hash(fn, strlen(fn)));
+	return (rc < 0) || ((size_t)rc >= len);
+}
+
+static uint64_t align_up(uint64_t x)
+{
+	return (x + CFG_CACHE_ALIGN - 1) & ~(uint64_t)(CFG_CACHE_ALIGN - 1);
+}
+
+static uint64_t str_sz(const char *str)
+{
+	return (NULL == str) ? 0 : strlen(str) + 1;
+}
+
+static uint32_t put_str(char *strs, uint64_t *used, const char *str)
+{
+	uint32_t off = (uint32_t)*used;
+
+	if (NULL == str) {
+		return CFG_CACHE_NO_STR;
+	}
+	memcpy(strs + off, str, strlen(str) + 1);
+	*used += strlen(str) + 1;
+	return off;
+}
+
+static int32_t conn_idx(struct int_cfg_conn *conn)
+{
+	return (NULL == conn) ? CFG_CACHE_NO_IDX : (int32_t)conn->idx;
+}
+
+static int32_t put_rt(rio_rt_state_t *rts, uint32_t *rt_cnt,
+		rio_rt_state_t *rt)
+{
+	if (NULL == rt) {
+		return CFG_CACHE_NO_IDX;
+	}
+	memcpy(&rts[*rt_cnt], rt, sizeof(*rt));
+	return (int32_t)(*rt_cnt)++;
+}
+
+static void fill_image(struct int_cfg_parms *cfg, uint8_t *img,
+		struct cfg_cache_hdr *hdr)
+{
+	struct cfg_cache_mport *mps;
+	struct cfg_cache_ep *eps;
+	struct cfg_cache_sw *sws;
+	struct cfg_cache_conn *cons;
+	rio_rt_state_t *rts;
+	char *strs;
+	uint64_t used = 0;
+	uint32_t i, rt_cnt = 0;
+	int p, sz, e;
+
+	mps = (struct cfg_cache_mport *)(img + hdr->mport_off);
+	eps = (struct cfg_cache_ep *)(img + hdr->ep_off);
+	sws = (struct cfg_cache_sw *)(img + hdr->sw_off);
+	cons = (struct cfg_cache_conn *)(img + hdr->conn_off);
+	rts = (rio_rt_state_t *)(img + hdr->rt_off);
+	strs = (char *)(img + hdr->str_off);
+
+	hdr->dd_mtx_fn = put_str(strs, &used, cfg->dd_mtx_fn);
+	hdr->dd_fn = put_str(strs, &used, cfg->dd_fn);
+
+	for (i = 0; i < cfg->max_mport_info_idx; i++) {
+		struct int_mport_info *mp = &cfg->mport_info[i];
+
+		mps[i].num = mp->num;
+		mps[i].ct = mp->ct;
+		mps[i].op_mode = mp->op_mode;
+		mps[i].mem_sz = mp->mem_sz;
+		memcpy(mps[i].devids, mp->devids, sizeof(mps[i].devids));
+		mps[i].ep = (NULL == mp->ep) ? CFG_CACHE_NO_IDX
+						: (int32_t)mp->ep->idx;
+		mps[i].ep_pnum = mp->ep_pnum;
+	}
+
+	for (i = 0; i < cfg->ep_cnt; i++) {
+		struct int_cfg_ep *ep = cfg->eps[i];
+
+		eps[i].name = put_str(strs, &used, ep->name);
+		eps[i].port_cnt = ep->port_cnt;
+		for (p = 0; p < CFG_MAX_EP_PORT; p++) {
+			struct cfg_cache_ep_port *pt = &eps[i].ports[p];
+
+			pt->valid = ep->ports[p].valid;
+			pt->port = ep->ports[p].port;
+			pt->ct = ep->ports[p].ct;
+			pt->rio = ep->ports[p].rio;
+			memcpy(pt->devids, ep->ports[p].devids,
+					sizeof(pt->devids));
+			pt->conn = conn_idx(ep->ports[p].conn);
+			pt->conn_end = ep->ports[p].conn_end;
+		}
+	}
+
+	for (i = 0; i < cfg->sw_cnt; i++) {
+		struct int_cfg_sw *sw = cfg->sws[i];
+
+		sws[i].name = put_str(strs, &used, sw->name);
+		sws[i].dev_type = put_str(strs, &used, sw->dev_type);
+		sws[i].did_val = sw->did_val;
+		sws[i].did_sz_idx = sw->did_sz_idx;
+		sws[i].hc = sw->hc;
+		sws[i].ct = sw->ct;
+		for (sz = 0; sz < MAX_DEV_SZ_IDX; sz++) {
+			sws[i].rt[sz] = put_rt(rts, &rt_cnt, sw->rt[sz]);
+		}
+		for (p = 0; p < CFG_MAX_SW_PORT; p++) {
+			struct cfg_cache_sw_port *pt = &sws[i].ports[p];
+
+			pt->valid = sw->ports[p].valid;
+			pt->port = sw->ports[p].port;
+			pt->rio = sw->ports[p].rio;
+			pt->conn = conn_idx(sw->ports[p].conn);
+			pt->conn_end = sw->ports[p].conn_end;
+			for (sz = 0; sz < MAX_DEV_SZ_IDX; sz++) {
+				pt->rt[sz] = put_rt(rts, &rt_cnt,
+						sw->ports[p].rt[sz]);
+			}
+		}
+	}
+
+	for (i = 0; i < cfg->conn_cnt; i++) {
+		struct int_cfg_conn *conn = cfg->cons[i];
+
+		for (e = 0; e < 2; e++) {
+			cons[i].port_num[e] = conn->ends[e].port_num;
+			cons[i].ep[e] = conn->ends[e].ep;
+			cons[i].idx[e] = conn->ends[e].ep ?
+					conn->ends[e].ep_h->idx :
+					conn->ends[e].sw_h->idx;
+		}
+	}
+}
+
+/**
+ * @brief Writes the parsed configuration to a binary cache.  The cache is
+ *        written to a temporary file and renamed, so readers never see a
+ *        partial image.
+ *
+ * @param[in] cfg Successfully parsed configuration
+ * @param[in] cache_fn Cache file name, see cfg_cache_name()
+ * @param[in] src_hash cfg_cache_hash() of the configuration file text
+ * @retval 0 on success, 1 on failure
+ */
+int cfg_cache_save(struct int_cfg_parms *cfg, const char *cache_fn,
+		uint64_t src_hash)
+{
+	struct cfg_cache_hdr hdr;
+	char tmp_fn[PATH_MAX];
+	uint8_t *img = NULL;
+	uint64_t done;
+	uint32_t i;
+	int p, sz;
+	int fd = -1;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = CFG_CACHE_MAGIC;
+	hdr.version = CFG_CACHE_VERSION;
+	hdr.src_hash = src_hash;
+	hdr.mport_sz = sizeof(struct cfg_cache_mport);
+	hdr.ep_sz = sizeof(struct cfg_cache_ep);
+	hdr.sw_sz = sizeof(struct cfg_cache_sw);
+	hdr.conn_sz = sizeof(struct cfg_cache_conn);
+	hdr.rt_sz = sizeof(rio_rt_state_t);
+	hdr.mport_cnt = cfg->max_mport_info_idx;
+	hdr.ep_cnt = cfg->ep_cnt;
+	hdr.sw_cnt = cfg->sw_cnt;
+	hdr.conn_cnt = cfg->conn_cnt;
+	hdr.mast_idx = cfg->mast_idx;
+	hdr.mast_did_val = cfg->mast_did_val;
+	hdr.mast_did_sz_idx = cfg->mast_did_sz_idx;
+	hdr.mast_cm_port = cfg->mast_cm_port;
+	hdr.auto_config = cfg->auto_config;
+
+	hdr.str_size = str_sz(cfg->dd_mtx_fn) + str_sz(cfg->dd_fn);
+	for (i = 0; i < cfg->ep_cnt; i++) {
+		hdr.str_size += str_sz(cfg->eps[i]->name);
+	}
+	for (i = 0; i < cfg->sw_cnt; i++) {
+		struct int_cfg_sw *sw = cfg->sws[i];
+
+		hdr.str_size += str_sz(sw->name) + str_sz(sw->dev_type);
+		for (sz = 0; sz < MAX_DEV_SZ_IDX; sz++) {
+			hdr.rt_cnt += (NULL != sw->rt[sz]);
+			for (p = 0; p < CFG_MAX_SW_PORT; p++) {
+				hdr.rt_cnt += (NULL != sw->ports[p].rt[sz]);
+			}
+		}
+	}
+
+	hdr.mport_off = align_up(sizeof(hdr));
+	hdr.ep_off = align_up(hdr.mport_off
+			+ (uint64_t)hdr.mport_cnt * hdr.mport_sz);
+	hdr.sw_off = align_up(hdr.ep_off + (uint64_t)hdr.ep_cnt * hdr.ep_sz);
+	hdr.conn_off = align_up(hdr.sw_off + (uint64_t)hdr.sw_cnt * hdr.sw_sz);
+	hdr.rt_off = align_up(hdr.conn_off
+			+ (uint64_t)hdr.conn_cnt * hdr.conn_sz);
+	hdr.str_off = align_up(hdr.rt_off + (uint64_t)hdr.rt_cnt * hdr.rt_sz);
+	hdr.size = hdr.str_off + hdr.str_size;
+
+	img = (uint8_t *)calloc(1, hdr.size);
+	if (NULL == img) {
+		goto fail;
+	}
+	fill_image(cfg, img, &hdr);
+	hdr.checksum = cfg_cache_hash(img + hdr.mport_off,
+			hdr.size - hdr.mport_off);
+	memcpy(img, &hdr, sizeof(hdr));
+
+	tmp_fn[0] = '\0';
+	if (!cache_dir_ok(true)) {
+		goto fail;
+	}
+
+	// mkstemp creates a new file, it never follows a planted link
+	snprintf(tmp_fn, sizeof(tmp_fn), "%s.XXXXXX", cache_fn);
+	fd = mkstemp(tmp_fn);
+	if (fd < 0) {
+		goto fail;
+	}
+	for (done = 0; done < hdr.size;) {
+		ssize_t rc = write(fd, img + done, hdr.size - done);
+
+		if (rc <= 0) {
+			goto fail;
+		}
+		done += rc;
+	}
+	if (close(fd)) {
+		fd = -1;
+		goto fail;
+	}
+	fd = -1;
+	if (rename(tmp_fn, cache_fn)) {
+		goto fail;
+	}
+
+	free(img);
+	return 0;
+
+fail:
+	WARN("CFG: Could not write cache \"%s\", errno %d : %s\n", cache_fn,
+			errno, strerror(errno));
+	if (fd >= 0) {
+		close(fd);
+	}
+	if (tmp_fn[0]) {
+		unlink(tmp_fn);
+	}
+	free(img);
+	return 1;
+}
+
+static bool section_ok(struct cfg_cache_hdr *hdr, uint64_t off, uint32_t cnt,
+		uint32_t rec_sz)
+{
+	return !(off % CFG_CACHE_ALIGN) && (off >= sizeof(*hdr))
+			&& (off <= hdr->size)
+			&& ((uint64_t)cnt * rec_sz <= hdr->size - off);
+}
+
+static bool str_ok(struct cfg_cache_hdr *hdr, uint32_t off, bool optional)
+{
+	if (CFG_CACHE_NO_STR == off) {
+		return optional;
+	}
+	return off < hdr->str_size;
+}
+
+static bool idx_ok(int32_t idx, uint32_t cnt)
+{
+	return (CFG_CACHE_NO_IDX == idx) || ((idx >= 0) && ((uint32_t)idx < cnt));
+}
+
+static bool link_ok(struct cfg_cache_hdr *hdr, int32_t conn, int32_t end)
+{
+	return idx_ok(conn, hdr->conn_cnt)
+		&& ((CFG_CACHE_NO_IDX == conn) || (0 == end) || (1 == end));
+}
+
+// Check every index and offset before the model is built from the image
+static bool image_ok(uint8_t *img, struct cfg_cache_hdr *hdr,
+		uint64_t src_hash)
+{
+	struct cfg_cache_mport *mps;
+	struct cfg_cache_ep *eps;
+	struct cfg_cache_sw *sws;
+	struct cfg_cache_conn *cons;
+	uint32_t i;
+	int p, sz, e;
+
+	if ((CFG_CACHE_MAGIC != hdr->magic)
+			|| (CFG_CACHE_VERSION != hdr->version)
+			|| (src_hash != hdr->src_hash)
+			|| (sizeof(struct cfg_cache_mport) != hdr->mport_sz)
+			|| (sizeof(struct cfg_cache_ep) != hdr->ep_sz)
+			|| (sizeof(struct cfg_cache_sw) != hdr->sw_sz)
+			|| (sizeof(struct cfg_cache_conn) != hdr->conn_sz)
+			|| (sizeof(rio_rt_state_t) != hdr->rt_sz)) {
+		return false;
+	}
+
+	if (!section_ok(hdr, hdr->mport_off, hdr->mport_cnt, hdr->mport_sz)
+		|| !section_ok(hdr, hdr->ep_off, hdr->ep_cnt, hdr->ep_sz)
+		|| !section_ok(hdr, hdr->sw_off, hdr->sw_cnt, hdr->sw_sz)
+		|| !section_ok(hdr, hdr->conn_off, hdr->conn_cnt, hdr->conn_sz)
+		|| !section_ok(hdr, hdr->rt_off, hdr->rt_cnt, hdr->rt_sz)
+		|| !section_ok(hdr, hdr->str_off, 1, hdr->str_size)) {
+		return false;
+	}
+
+	if (hdr->checksum != cfg_cache_hash(img + hdr->mport_off,
+					hdr->size - hdr->mport_off)) {
+		return false;
+	}
+
+	if (hdr->str_size && img[hdr->str_off + hdr->str_size - 1]) {
+		return false;
+	}
+	if (!str_ok(hdr, hdr->dd_mtx_fn, true) || !str_ok(hdr, hdr->dd_fn, true)
+			|| (hdr->mast_did_sz_idx >= MAX_DEV_SZ_IDX)) {
+		return false;
+	}
+
+	mps = (struct cfg_cache_mport *)(img + hdr->mport_off);
+	for (i = 0; i < hdr->mport_cnt; i++) {
+		if (!idx_ok(mps[i].ep, hdr->ep_cnt)) {
+			return false;
+		}
+	}
+
+	eps = (struct cfg_cache_ep *)(img + hdr->ep_off);
+	for (i = 0; i < hdr->ep_cnt; i++) {
+		if (!str_ok(hdr, eps[i].name, false) || (eps[i].port_cnt < 0)
+				|| (eps[i].port_cnt > CFG_MAX_EP_PORT)) {
+			return false;
+		}
+		for (p = 0; p < CFG_MAX_EP_PORT; p++) {
+			if (!link_ok(hdr, eps[i].ports[p].conn,
+						eps[i].ports[p].conn_end)) {
+				return false;
+			}
+		}
+	}
+
+	sws = (struct cfg_cache_sw *)(img + hdr->sw_off);
+	for (i = 0; i < hdr->sw_cnt; i++) {
+		if (!str_ok(hdr, sws[i].name, false)
+				|| !str_ok(hdr, sws[i].dev_type, false)) {
+			return false;
+		}
+		for (sz = 0; sz < MAX_DEV_SZ_IDX; sz++) {
+			if (!idx_ok(sws[i].rt[sz], hdr->rt_cnt)) {
+				return false;
+			}
+		}
+		for (p = 0; p < CFG_MAX_SW_PORT; p++) {
+			struct cfg_cache_sw_port *pt = &sws[i].ports[p];
+
+			if (!link_ok(hdr, pt->conn, pt->conn_end)) {
+				return false;
+			}
+			for (sz = 0; sz < MAX_DEV_SZ_IDX; sz++) {
+				if (!idx_ok(pt->rt[sz], hdr->rt_cnt)) {
+					return false;
+				}
+			}
+		}
+	}
+
+	cons = (struct cfg_cache_conn *)(img + hdr->conn_off);
+	for (i = 0; i < hdr->conn_cnt; i++) {
+		for (e = 0; e < 2; e++) {
+			int32_t idx = cons[i].idx[e];
+			int32_t pnum = cons[i].port_num[e];
+
+			if (cons[i].ep[e] ?
+				((idx < 0) || ((uint32_t)idx >= hdr->ep_cnt)
+				|| (pnum < 0) || (pnum >= CFG_MAX_EP_PORT)) :
+				((idx < 0) || ((uint32_t)idx >= hdr->sw_cnt)
+				|| (pnum < 0) || (pnum >= CFG_MAX_SW_PORT))) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static int load_str(char **target, const char *strs, uint32_t off)
+{
+	if (CFG_CACHE_NO_STR == off) {
+		return 0;
+	}
+	return update_string(target, (char *)strs + off, strlen(strs + off));
+}
+
+static rio_rt_state_t *load_rt(rio_rt_state_t *rts, int32_t idx)
+{
+	return (CFG_CACHE_NO_IDX == idx) ? NULL : &rts[idx];
+}
+
+static struct int_cfg_conn *load_conn(struct int_cfg_parms *cfg, int32_t idx)
+{
+	return (CFG_CACHE_NO_IDX == idx) ? NULL : cfg->cons[idx];
+}
+
+// Build the model from a validated image
+static int load_image(struct int_cfg_parms *cfg, uint8_t *img,
+		struct cfg_cache_hdr *hdr)
+{
+	struct cfg_cache_mport *mps;
+	struct cfg_cache_ep *eps;
+	struct cfg_cache_sw *sws;
+	struct cfg_cache_conn *cons;
+	rio_rt_state_t *rts;
+	const char *strs;
+	uint32_t i;
+	int p, sz, e;
+
+	mps = (struct cfg_cache_mport *)(img + hdr->mport_off);
+	eps = (struct cfg_cache_ep *)(img + hdr->ep_off);
+	sws = (struct cfg_cache_sw *)(img + hdr->sw_off);
+	cons = (struct cfg_cache_conn *)(img + hdr->conn_off);
+	rts = (rio_rt_state_t *)(img + hdr->rt_off);
+	strs = (const char *)(img + hdr->str_off);
+
+	cfg->mast_idx = hdr->mast_idx;
+	cfg->mast_did_val = hdr->mast_did_val;
+	cfg->mast_did_sz_idx = hdr->mast_did_sz_idx;
+	cfg->mast_cm_port = hdr->mast_cm_port;
+	cfg->auto_config = hdr->auto_config;
+	if (load_str(&cfg->dd_mtx_fn, strs, hdr->dd_mtx_fn)
+			|| load_str(&cfg->dd_fn, strs, hdr->dd_fn)) {
+		goto fail;
+	}
+
+	for (i = 0; i < hdr->ep_cnt; i++) {
+		struct int_cfg_ep *ep = cfg_new_ep(cfg);
+
+		if ((NULL == ep) || load_str(&ep->name, strs, eps[i].name)) {
+			goto fail;
+		}
+		ep->port_cnt = eps[i].port_cnt;
+		for (p = 0; p < CFG_MAX_EP_PORT; p++) {
+			struct cfg_cache_ep_port *pt = &eps[i].ports[p];
+
+			ep->ports[p].valid = pt->valid;
+			ep->ports[p].port = pt->port;
+			ep->ports[p].ct = pt->ct;
+			ep->ports[p].rio = pt->rio;
+			memcpy(ep->ports[p].devids, pt->devids,
+					sizeof(ep->ports[p].devids));
+			ep->ports[p].conn_end = pt->conn_end;
+		}
+		if (cfg_add_ep(cfg, ep)) {
+			goto fail;
+		}
+	}
+
+	for (i = 0; i < hdr->sw_cnt; i++) {
+		struct int_cfg_sw *sw = cfg_new_sw(cfg);
+
+		if ((NULL == sw) || load_str(&sw->name, strs, sws[i].name)
+			|| load_str(&sw->dev_type, strs, sws[i].dev_type)) {
+			goto fail;
+		}
+		sw->did_val = sws[i].did_val;
+		sw->did_sz_idx = sws[i].did_sz_idx;
+		sw->hc = sws[i].hc;
+		sw->ct = sws[i].ct;
+		for (sz = 0; sz < MAX_DEV_SZ_IDX; sz++) {
+			sw->rt[sz] = load_rt(rts, sws[i].rt[sz]);
+		}
+		for (p = 0; p < CFG_MAX_SW_PORT; p++) {
+			struct cfg_cache_sw_port *pt = &sws[i].ports[p];
+
+			sw->ports[p].valid = pt->valid;
+			sw->ports[p].port = pt->port;
+			sw->ports[p].rio = pt->rio;
+			sw->ports[p].conn_end = pt->conn_end;
+			for (sz = 0; sz < MAX_DEV_SZ_IDX; sz++) {
+				sw->ports[p].rt[sz] = load_rt(rts,
+							pt->rt[sz]);
+			}
+		}
+		if (cfg_add_sw(cfg, sw)) {
+			goto fail;
+		}
+	}
+
+	for (i = 0; i < hdr->conn_cnt; i++) {
+		struct int_cfg_conn *conn = cfg_new_conn(cfg);
+
+		if (NULL == conn) {
+			goto fail;
+		}
+		for (e = 0; e < 2; e++) {
+			conn->ends[e].port_num = cons[i].port_num[e];
+			conn->ends[e].ep = cons[i].ep[e];
+			if (cons[i].ep[e]) {
+				conn->ends[e].ep_h = cfg->eps[cons[i].idx[e]];
+			} else {
+				conn->ends[e].sw_h = cfg->sws[cons[i].idx[e]];
+			}
+		}
+		conn->valid = 1;
+		cfg->conn_cnt++;
+	}
+
+	// Connections exist now, link the device ports to them
+	for (i = 0; i < hdr->ep_cnt; i++) {
+		for (p = 0; p < CFG_MAX_EP_PORT; p++) {
+			cfg->eps[i]->ports[p].conn = load_conn(cfg,
+						eps[i].ports[p].conn);
+		}
+	}
+	for (i = 0; i < hdr->sw_cnt; i++) {
+		for (p = 0; p < CFG_MAX_SW_PORT; p++) {
+			cfg->sws[i]->ports[p].conn = load_conn(cfg,
+						sws[i].ports[p].conn);
+		}
+	}
+
+	for (i = 0; i < hdr->mport_cnt; i++) {
+		struct int_mport_info *mp = cfg_new_mport(cfg);
+
+		if (NULL == mp) {
+			goto fail;
+		}
+		mp->num = mps[i].num;
+		mp->ct = mps[i].ct;
+		mp->op_mode = mps[i].op_mode;
+		mp->mem_sz = mps[i].mem_sz;
+		memcpy(mp->devids, mps[i].devids, sizeof(mp->devids));
+		mp->ep = (CFG_CACHE_NO_IDX == mps[i].ep) ? NULL
+							: cfg->eps[mps[i].ep];
+		mp->ep_pnum = mps[i].ep_pnum;
+		cfg->max_mport_info_idx++;
+	}
+	return 0;
+fail:
+	return -1;
+}
+
+/**
+ * @brief Loads the configuration from a binary cache, if the cache is valid
+ *        and was built from a configuration file with the same text.
+ *        The cache stays mapped until cfg_cache_unmap().
+ *
+ * @param[in] cfg Empty configuration
+ * @param[in] cache_fn Cache file name, see cfg_cache_name()
+ * @param[in] src_hash cfg_cache_hash() of the configuration file text
+ * @retval 0 if the configuration was loaded
+ * @retval 1 if there is no usable cache, cfg is unchanged
+ * @retval -1 if memory ran out while loading, cfg is incomplete
+ */
+int cfg_cache_load(struct int_cfg_parms *cfg, const char *cache_fn,
+		uint64_t src_hash)
+{
+	struct cfg_cache_hdr *hdr;
+	struct stat st;
+	void *map;
+	int fd;
+
+	if (!cache_dir_ok(false)) {
+		return 1;
+	}
+	fd = open(cache_fn, O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+	if (fd < 0) {
+		return 1;
+	}
+	if (fstat(fd, &st) || (st.st_size < (off_t)sizeof(*hdr))) {
+		close(fd);
+		return 1;
+	}
+	if (!S_ISREG(st.st_mode) || !cache_stat_ok(&st)) {
+		WARN("CFG: Cache \"%s\" is not private, not used\n", cache_fn);
+		close(fd);
+		return 1;
+	}
+
+	// Private and writable, routing tables are used in place
+	map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+			0);
+	close(fd);
+	if (MAP_FAILED == map) {
+		return 1;
+	}
+
+	hdr = (struct cfg_cache_hdr *)map;
+	if ((hdr->size != (uint64_t)st.st_size)
+			|| !image_ok((uint8_t *)map, hdr, src_hash)) {
+		INFO("CFG: Cache \"%s\" is out of date\n", cache_fn);
+		munmap(map, st.st_size);
+		return 1;
+	}
+
+	cfg->cache_map = map;
+	cfg->cache_size = st.st_size;
+	return load_image(cfg, (uint8_t *)map, hdr);
+}
+
+void cfg_cache_unmap(struct int_cfg_parms *cfg)
+{
+	if (NULL != cfg->cache_map) {
+		munmap(cfg->cache_map, cfg->cache_size);
+		cfg->cache_map = NULL;
+		cfg->cache_size = 0;
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
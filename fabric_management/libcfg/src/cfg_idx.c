@@ -0,0 +1,161 @@
+/* Hash indexes for the fabric configuration model */
+/* Fabric Management Daemon Configuration file and options parsing support */
+/*
+****************************************************************************
+Copyright (c) 2014, Integrated Device Technology Inc.
+Copyright (c) 2014, RapidIO Trade Association
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+may be used to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cfg_private.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CFG_IDX_MIN_SIZE 64
+
+/* FNV-1a */
+uint32_t cfg_idx_hash_name(const char *name)
+{
+	uint32_t h = 2166136261u;
+
+	while (*name) {
+		h ^= (uint8_t)*name++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+static inline uint32_t slot_of(uint32_t key, uint32_t size)
+{
+	uint32_t h = key * 2654435761u;
+
+	return (h ^ (h >> 16)) & (size - 1);
+}
+
+static inline bool ent_match(struct cfg_idx_ent *ent, uint32_t key,
+		const char *name)
+{
+	if (ent->key != key) {
+		return false;
+	}
+	if ((NULL == name) || (NULL == ent->name)) {
+		return name == ent->name;
+	}
+	return !strcmp(name, ent->name);
+}
+
+static void put(struct cfg_idx_ent *ents, uint32_t size,
+		struct cfg_idx_ent *ent)
+{
+	uint32_t s = slot_of(ent->key, size);
+
+	while (NULL != ents[s].val) {
+		s = (s + 1) & (size - 1);
+	}
+	ents[s] = *ent;
+}
+
+static int grow(struct cfg_idx *idx)
+{
+	uint32_t size = idx->size ? idx->size * 2 : CFG_IDX_MIN_SIZE;
+	struct cfg_idx_ent *ents;
+	uint32_t i;
+
+	ents = (struct cfg_idx_ent *)calloc(size, sizeof(*ents));
+	if (NULL == ents) {
+		return 1;
+	}
+	for (i = 0; i < idx->size; i++) {
+		if (NULL != idx->ents[i].val) {
+			put(ents, size, &idx->ents[i]);
+		}
+	}
+	free(idx->ents);
+	idx->ents = ents;
+	idx->size = size;
+	return 0;
+}
+
+/**
+ * @brief Add a value to an index.  Comptag indexes pass the comptag as the
+ *        key and a NULL name, name indexes use cfg_idx_add_name().
+ *
+ * @retval 0 on success, or if the key already has this value
+ * @retval 1 if the key already has another value, or no memory.
+ *         The first value added for a key is kept.
+ */
+int cfg_idx_add(struct cfg_idx *idx, uint32_t key, const char *name,
+		void *val)
+{
+	struct cfg_idx_ent ent = {name, key, val};
+	void *cur;
+
+	cur = cfg_idx_find(idx, key, name);
+	if (NULL != cur) {
+		return (cur != val);
+	}
+	if (((idx->cnt + 1) * 2 > idx->size) && grow(idx)) {
+		return 1;
+	}
+	put(idx->ents, idx->size, &ent);
+	idx->cnt++;
+	return 0;
+}
+
+void *cfg_idx_find(struct cfg_idx *idx, uint32_t key, const char *name)
+{
+	uint32_t s;
+
+	if (!idx->size) {
+		return NULL;
+	}
+	for (s = slot_of(key, idx->size); NULL != idx->ents[s].val;
+			s = (s + 1) & (idx->size - 1)) {
+		if (ent_match(&idx->ents[s], key, name)) {
+			return idx->ents[s].val;
+		}
+	}
+	return NULL;
+}
+
+void cfg_idx_free(struct cfg_idx *idx)
+{
+	free(idx->ents);
+	memset(idx, 0, sizeof(*idx));
+}
+
+#ifdef __cplusplus
+}
+#endif
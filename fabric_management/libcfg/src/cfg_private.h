@@ -63,6 +63,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "riocp_pe.h"
 #include "fmd_dd.h"
 #include "cfg.h"
+#include "tok_reader.h"
+#include "rrmap_config.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -79,19 +81,14 @@ struct int_mport_info {
 	int ep_pnum; /* EP port number that matches this MPORT */
 };
 
-#define CFG_MAX_MPORTS 4
 #define CFG_DFLT_INIT_DD 0
 #define CFG_DFLT_RUN_CONS 1
 #define CFG_DFLT_MAST_DEVID_SZ DEV08_IDX
 #define CFG_DFLT_MAST_DEVID 1
 #define CFG_DFLT_MAST_INTERVAL 5
 #define CFG_INVALID_CT 0
-#define CFG_MAX_EP 70
 #define CFG_MAX_EP_PORT 1
-#define CFG_MAX_SW 20
-#define CFG_MAX_CONN_PORT 24
-#define CFG_MAX_CONN (CFG_MAX_SW*CFG_MAX_CONN_PORT)
-#define CFG_MAX_DEVS (CFG_MAX_SW+CFG_MAX_CONN)
+#define CFG_INIT_ALLOC 16 /* Initial size of the device and connection lists */
 
 #define OTHER_END(x) ((1 == x)?0:((0==x)?1:2))
 
@@ -117,9 +114,11 @@ struct int_cfg_ep_port {
 
 struct int_cfg_ep {
 	int valid;
+	uint32_t idx; /* Position in eps */
 	char *name;
 	int port_cnt;
 	struct int_cfg_ep_port ports[CFG_MAX_EP_PORT];
+	struct cfg_dev *dev; /* Entry in devs, NULL if port 0 is not valid */
 };
 
 struct int_cfg_sw_port {
@@ -128,13 +127,13 @@ struct int_cfg_sw_port {
 	struct int_cfg_rapidio rio;
 	struct int_cfg_conn *conn;
 	int conn_end; /* index of *conn for this switch */
-	// One routing table for each devID size
-	bool rt_valid[MAX_DEV_SZ_IDX];
-	rio_rt_state_t rt[MAX_DEV_SZ_IDX];
+	// One routing table for each devID size, NULL if not configured
+	rio_rt_state_t *rt[MAX_DEV_SZ_IDX];
 };
 
 struct int_cfg_sw {
 	int valid;
+	uint32_t idx; /* Position in sws */
 	char *name;
 	char *dev_type;
 	did_val_t did_val;
@@ -142,9 +141,9 @@ struct int_cfg_sw {
 	hc_t hc;
 	ct_t ct;
 	struct int_cfg_sw_port ports[CFG_MAX_SW_PORT];
-	// One routing table for each devID size
-	bool rt_valid[MAX_DEV_SZ_IDX];
-	rio_rt_state_t rt[MAX_DEV_SZ_IDX];
+	// One routing table for each devID size, NULL if not configured
+	rio_rt_state_t *rt[MAX_DEV_SZ_IDX];
+	struct cfg_dev *dev; /* Entry in devs */
 };
 
 struct int_cfg_conn_pe {
@@ -158,31 +157,120 @@ struct int_cfg_conn_pe {
 
 struct int_cfg_conn {
 	int valid;
+	uint32_t idx; /* Position in cons */
 	struct int_cfg_conn_pe ends[2];
 };
 
+/* Open addressing hash index, keyed by comptag or by name */
+struct cfg_idx_ent {
+	const char *name; /* NULL for comptag keys */
+	uint32_t key; /* Comptag, or hash of name */
+	void *val; /* NULL for an empty slot */
+};
+
+struct cfg_idx {
+	uint32_t cnt;
+	uint32_t size; /* Zero or a power of two */
+	struct cfg_idx_ent *ents;
+};
+
+/* Link partner of a device port, flattened from the connections */
+struct cfg_adj {
+	ct_t peer_ct;
+	int peer_port; /* -1 if the port is not connected */
+	uint32_t peer_is_sw;
+	const struct cfg_dev *peer;
+};
+
+/* Switches, endpoints and connections are allocated individually and
+ * never move, so the pointers between them stay valid as the lists grow.
+ */
 struct int_cfg_parms {
 	char *dd_mtx_fn;
 	char *dd_fn;
 	int init_err;
 	int mast_idx;	/* Idx of the mport_info that is master */
-	uint32_t max_mport_info_idx; /* Maximum number of mports */
-	struct int_mport_info mport_info[CFG_MAX_MPORTS];
+	uint32_t max_mport_info_idx; /* Number of mports */
+	uint32_t mport_alloc;
+	struct int_mport_info *mport_info;
 	did_val_t mast_did_val;	/* Master CFG location information */
 	uint32_t mast_did_sz_idx;
 	uint32_t mast_cm_port; 	/* Master CFG location information */
 	uint32_t ep_cnt;
-	struct int_cfg_ep eps[CFG_MAX_EP];
+	uint32_t ep_alloc;
+	struct int_cfg_ep **eps;
 	uint32_t sw_cnt;
-	struct int_cfg_sw sws[CFG_MAX_SW];
+	uint32_t sw_alloc;
+	struct int_cfg_sw **sws;
 	uint32_t conn_cnt;
-	struct int_cfg_conn cons[CFG_MAX_CONN];
+	uint32_t conn_alloc;
+	struct int_cfg_conn **cons;
+	struct cfg_idx ep_ct_idx; /* Endpoint port comptag to endpoint */
+	struct cfg_idx sw_ct_idx;
+	struct cfg_idx ep_name_idx;
+	struct cfg_idx sw_name_idx;
+	// Read only view of the devices and their links, built by
+	// cfg_build_adj() once the configuration file has been parsed.
+	// Endpoints have one entry in adj, switches CFG_MAX_SW_PORT.
+	uint32_t dev_cnt;
+	struct cfg_dev *devs;
+	uint32_t *adj_base; /* Index in adj of port 0 of each device */
+	struct cfg_adj *adj;
+	struct cfg_idx dev_ct_idx; /* Comptag to entry in devs */
+	void *cache_map; /* Binary cache the configuration was loaded from */
+	size_t cache_size;
 	bool auto_config;
+	struct tok_rdr rdr; /* Config file reader, valid while parsing */
 };
 
 extern struct int_cfg_parms *cfg;
 
 void init_rt(rio_rt_state_t *rt);
+
+uint32_t cfg_idx_hash_name(const char *name);
+int cfg_idx_add(struct cfg_idx *idx, uint32_t key, const char *name,
+		void *val);
+void *cfg_idx_find(struct cfg_idx *idx, uint32_t key, const char *name);
+void cfg_idx_free(struct cfg_idx *idx);
+
+static inline int cfg_idx_add_name(struct cfg_idx *idx, const char *name,
+		void *val)
+{
+	return cfg_idx_add(idx, cfg_idx_hash_name(name), name, val);
+}
+
+static inline void *cfg_idx_find_name(struct cfg_idx *idx, const char *name)
+{
+	return cfg_idx_find(idx, cfg_idx_hash_name(name), name);
+}
+
+struct int_cfg_sw *find_cfg_sw_by_ct(ct_t ct, struct int_cfg_parms *cfg);
+struct int_cfg_ep *find_cfg_ep_by_ct(ct_t ct, struct int_cfg_parms *cfg);
+struct int_mport_info *cfg_new_mport(struct int_cfg_parms *cfg);
+struct int_cfg_ep *cfg_new_ep(struct int_cfg_parms *cfg);
+struct int_cfg_sw *cfg_new_sw(struct int_cfg_parms *cfg);
+struct int_cfg_conn *cfg_new_conn(struct int_cfg_parms *cfg);
+int cfg_add_ep(struct int_cfg_parms *cfg, struct int_cfg_ep *ep);
+int cfg_add_sw(struct int_cfg_parms *cfg, struct int_cfg_sw *sw);
+int cfg_build_adj(struct int_cfg_parms *cfg);
+
+/* The binary cache holds the parsed configuration, including the routing
+ * tables, and is rebuilt whenever the configuration file text changes.
+ * Caches are only used from a directory which belongs to the effective
+ * user and cannot be written by anyone else.
+ */
+#define CFG_CACHE_DIR "/var/cache/rapidio"
+
+/* Selects the cache directory, NULL selects CFG_CACHE_DIR. */
+void cfg_cache_set_dir(const char *dir);
+uint64_t cfg_cache_hash(const void *buf, size_t len);
+int cfg_cache_name(const char *cfg_fn, char *cache_fn, size_t len);
+int cfg_cache_save(struct int_cfg_parms *cfg, const char *cache_fn,
+		uint64_t src_hash);
+int cfg_cache_load(struct int_cfg_parms *cfg, const char *cache_fn,
+		uint64_t src_hash);
+void cfg_cache_unmap(struct int_cfg_parms *cfg);
+void cfg_free_parms(struct int_cfg_parms *cfg);
 int assign_dev16_rt_v(did_val_t st_did_val, did_val_t end_did_val,
 			pe_rt_val rtv,
 			rio_rt_state_t *rt, struct int_cfg_parms *cfg);
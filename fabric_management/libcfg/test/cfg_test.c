@@ -47,6 +47,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <unistd.h>
 #include <dirent.h>
 #include <errno.h>
+#include <time.h>
+#include <limits.h>
 #include <sys/ioctl.h>
 #include <sys/types.h>
 
@@ -87,8 +89,37 @@ static void check_file_exists(const char *filename)
 	}
 }
 
+// Every parse writes a binary cache, keep them in a private directory
+static char cache_dir[] = "/tmp/cfg_test_XXXXXX";
+
+static void remove_cache_dir(void)
+{
+	char fn[PATH_MAX];
+	struct dirent *ent;
+	DIR *dir;
+
+	dir = opendir(cache_dir);
+	if (NULL == dir) {
+		return;
+	}
+	while (NULL != (ent = readdir(dir))) {
+		if ('.' != ent->d_name[0]) {
+			snprintf(fn, sizeof(fn), "%s/%s", cache_dir,
+					ent->d_name);
+			unlink(fn);
+		}
+	}
+	closedir(dir);
+	rmdir(cache_dir);
+}
+
 static int grp_setup(void **state)
 {
+	if (NULL == mkdtemp(cache_dir)) {
+		return -1;
+	}
+	cfg_cache_set_dir(cache_dir);
+
 	rdma_log_init("cfg_test.log", 7);
 	g_level = RDMA_LL_OFF;
 	// g_disp_level = RDMA_LL_OFF;
@@ -105,6 +136,9 @@ static int grp_teardown(void **state)
 	}
 	rdma_log_close();
 
+	remove_cache_dir();
+	cfg_cache_set_dir(NULL);
+
 	(void)state; // unused
 	return 0;
 }
@@ -156,7 +190,7 @@ static void cfg_parse_mport_size_test(void **state)
 	assert_int_equal (CFG_MEM_SZ_66, mem_sz);
 
 	count++;
-	free(cfg);
+	cfg_free_parms(cfg);
 	(void)state; // unused
 }
 
@@ -199,7 +233,7 @@ static void cfg_parse_mport_dev16_size_test(void **state)
 	assert_int_equal (CFG_MEM_SZ_50, mem_sz);
 
 	count++;
-	free(cfg);
+	cfg_free_parms(cfg);
 	(void)state; // unused
 }
 
@@ -213,7 +247,7 @@ static void cfg_parse_fail(const char *filename)
 
 	assert_int_not_equal(0, cfg_parse_file((char *)filename, &dd_mtx_fn, &dd_fn, &m_did,
 		&m_cm_port, &m_mode));
-	free(cfg);
+	cfg_free_parms(cfg);
 }
 
 static void cfg_parse_fail_no_file_test(void **state)
@@ -324,6 +358,30 @@ static void cfg_parse_fail_9_test(void **state)
 	(void)state; // unused
 }
 
+// Two endpoints with the same comptag
+static void cfg_parse_fail_10_test(void **state)
+{
+	const char *test_file = "test/parse_fail_10.cfg";
+
+	check_file_exists(test_file);
+	cfg_parse_fail(test_file);
+
+	count++;
+	(void)state; // unused
+}
+
+// A switch with the comptag of an endpoint
+static void cfg_parse_fail_11_test(void **state)
+{
+	const char *test_file = "test/parse_fail_11.cfg";
+
+	check_file_exists(test_file);
+	cfg_parse_fail(test_file);
+
+	count++;
+	(void)state; // unused
+}
+
 static void cfg_assign_dev16_rt_test(void **state)
 {
 	did_val_t start_did, end_did;
@@ -562,7 +620,7 @@ static void cfg_assign_dev16_rt_test(void **state)
 static void cfg_parse_master_test(void **state)
 {
 	struct cfg_mport_info mp;
-	struct cfg_dev dev;
+	const struct cfg_dev *dev;
 	int conn_pt;
 	char *dd_mtx_fn = NULL;
 	char *dd_fn = NULL;
@@ -590,120 +648,120 @@ static void cfg_parse_master_test(void **state)
 	assert_int_not_equal(0, cfg_find_mport(3, &mp));
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x10005, &dev));
-	assert_string_equal("GRYPHON_01", dev.name);
-	assert_int_equal(0x10005, dev.ct);
-	assert_int_equal(0, dev.is_sw);
-	assert_int_equal(rio_pc_pw_4x, dev.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_5p0, dev.ep_pt.ls);
-	assert_int_equal(rio_pc_is_two, dev.ep_pt.iseq);
-	assert_true(dev.ep_pt.devids[DEV08_IDX].valid);
-	assert_int_equal(5, dev.ep_pt.devids[DEV08_IDX].did_val);
-	assert_int_equal(0xFF, dev.ep_pt.devids[DEV08_IDX].hc);
-	assert_true(dev.ep_pt.devids[DEV16_IDX].valid);
-	assert_int_equal(0x5555, dev.ep_pt.devids[DEV16_IDX].did_val);
-	assert_int_equal(0xFF, dev.ep_pt.devids[DEV16_IDX].hc);
+	assert_string_equal("GRYPHON_01", dev->name);
+	assert_int_equal(0x10005, dev->ct);
+	assert_int_equal(0, dev->is_sw);
+	assert_int_equal(rio_pc_pw_4x, dev->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_5p0, dev->ep_pt.ls);
+	assert_int_equal(rio_pc_is_two, dev->ep_pt.iseq);
+	assert_true(dev->ep_pt.devids[DEV08_IDX].valid);
+	assert_int_equal(5, dev->ep_pt.devids[DEV08_IDX].did_val);
+	assert_int_equal(0xFF, dev->ep_pt.devids[DEV08_IDX].hc);
+	assert_true(dev->ep_pt.devids[DEV16_IDX].valid);
+	assert_int_equal(0x5555, dev->ep_pt.devids[DEV16_IDX].did_val);
+	assert_int_equal(0xFF, dev->ep_pt.devids[DEV16_IDX].hc);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x20006, &dev));
-	assert_int_equal(0x20006, dev.ct);
-	assert_string_equal("GRYPHON_02", dev.name);
-	assert_int_equal(0, dev.is_sw);
-	assert_int_equal(rio_pc_pw_2x, dev.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_6p25, dev.ep_pt.ls);
-	assert_int_equal(rio_pc_is_two, dev.ep_pt.iseq);
-	assert_true(dev.ep_pt.devids[DEV08_IDX].valid);
-	assert_int_equal(6, dev.ep_pt.devids[DEV08_IDX].did_val);
-	assert_int_equal(1, dev.ep_pt.devids[DEV08_IDX].hc);
-	assert_true(dev.ep_pt.devids[DEV16_IDX].valid);
-	assert_int_equal(0x6666, dev.ep_pt.devids[DEV16_IDX].did_val);
-	assert_int_equal(1, dev.ep_pt.devids[DEV16_IDX].hc);
+	assert_int_equal(0x20006, dev->ct);
+	assert_string_equal("GRYPHON_02", dev->name);
+	assert_int_equal(0, dev->is_sw);
+	assert_int_equal(rio_pc_pw_2x, dev->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_6p25, dev->ep_pt.ls);
+	assert_int_equal(rio_pc_is_two, dev->ep_pt.iseq);
+	assert_true(dev->ep_pt.devids[DEV08_IDX].valid);
+	assert_int_equal(6, dev->ep_pt.devids[DEV08_IDX].did_val);
+	assert_int_equal(1, dev->ep_pt.devids[DEV08_IDX].hc);
+	assert_true(dev->ep_pt.devids[DEV16_IDX].valid);
+	assert_int_equal(0x6666, dev->ep_pt.devids[DEV16_IDX].did_val);
+	assert_int_equal(1, dev->ep_pt.devids[DEV16_IDX].hc);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x30007, &dev));
-	assert_string_equal("GRYPHON_03", dev.name);
-	assert_int_equal(0, dev.is_sw);
-	assert_int_equal(0x30007, dev.ct);
-	assert_int_equal(rio_pc_pw_2x, dev.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_1p25, dev.ep_pt.ls);
-	assert_int_equal(rio_pc_is_one, dev.ep_pt.iseq);
-	assert_true(dev.ep_pt.devids[DEV08_IDX].valid);
-	assert_int_equal(7, dev.ep_pt.devids[DEV08_IDX].did_val);
-	assert_int_equal(1, dev.ep_pt.devids[DEV08_IDX].hc);
-	assert_true(dev.ep_pt.devids[DEV16_IDX].valid);
-	assert_int_equal(0x7777, dev.ep_pt.devids[DEV16_IDX].did_val);
-	assert_int_equal(1, dev.ep_pt.devids[DEV16_IDX].hc);
+	assert_string_equal("GRYPHON_03", dev->name);
+	assert_int_equal(0, dev->is_sw);
+	assert_int_equal(0x30007, dev->ct);
+	assert_int_equal(rio_pc_pw_2x, dev->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_1p25, dev->ep_pt.ls);
+	assert_int_equal(rio_pc_is_one, dev->ep_pt.iseq);
+	assert_true(dev->ep_pt.devids[DEV08_IDX].valid);
+	assert_int_equal(7, dev->ep_pt.devids[DEV08_IDX].did_val);
+	assert_int_equal(1, dev->ep_pt.devids[DEV08_IDX].hc);
+	assert_true(dev->ep_pt.devids[DEV16_IDX].valid);
+	assert_int_equal(0x7777, dev->ep_pt.devids[DEV16_IDX].did_val);
+	assert_int_equal(1, dev->ep_pt.devids[DEV16_IDX].hc);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x40008, &dev));
-	assert_string_equal("GRYPHON_04", dev.name);
-	assert_int_equal(0x40008, dev.ct);
-	assert_int_equal(0, dev.is_sw);
-	assert_int_equal(rio_pc_pw_4x, dev.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_2p5, dev.ep_pt.ls);
-	assert_int_equal(rio_pc_is_one, dev.ep_pt.iseq);
-	assert_int_equal(8, dev.ep_pt.devids[DEV08_IDX].did_val);
-	assert_int_equal(1, dev.ep_pt.devids[DEV08_IDX].hc);
-	assert_true(dev.ep_pt.devids[DEV16_IDX].valid);
-	assert_int_equal(0x8888, dev.ep_pt.devids[DEV16_IDX].did_val);
-	assert_int_equal(1, dev.ep_pt.devids[DEV16_IDX].hc);
+	assert_string_equal("GRYPHON_04", dev->name);
+	assert_int_equal(0x40008, dev->ct);
+	assert_int_equal(0, dev->is_sw);
+	assert_int_equal(rio_pc_pw_4x, dev->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_2p5, dev->ep_pt.ls);
+	assert_int_equal(rio_pc_is_one, dev->ep_pt.iseq);
+	assert_int_equal(8, dev->ep_pt.devids[DEV08_IDX].did_val);
+	assert_int_equal(1, dev->ep_pt.devids[DEV08_IDX].hc);
+	assert_true(dev->ep_pt.devids[DEV16_IDX].valid);
+	assert_int_equal(0x8888, dev->ep_pt.devids[DEV16_IDX].did_val);
+	assert_int_equal(1, dev->ep_pt.devids[DEV16_IDX].hc);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x70009, &dev));
-	assert_string_equal("MAIN_SWITCH", dev.name);
-	assert_int_equal(0x70009, dev.ct);
-	assert_int_equal(1, dev.is_sw);
-	assert_int_equal(24, dev.sw_info.num_ports);
-	for (rio_port_t pt = 0; pt < dev.sw_info.num_ports; pt++) {
+	assert_string_equal("MAIN_SWITCH", dev->name);
+	assert_int_equal(0x70009, dev->ct);
+	assert_int_equal(1, dev->is_sw);
+	assert_int_equal(24, dev->sw_info.num_ports);
+	for (rio_port_t pt = 0; pt < dev->sw_info.num_ports; pt++) {
 		// Per port routing tables are all invalid.
 		for (uint32_t idx = 0; idx < MAX_DEV_SZ_IDX; idx++) {
-			assert_null(dev.sw_info.sw_pt[pt].rt[idx]);
+			assert_null(dev->sw_info.sw_pt[pt].rt[idx]);
 		}
 		// Undefined ports
 		if (pt >= 18) {
-			assert_false(dev.sw_info.sw_pt[pt].valid);
-			assert_int_equal(rio_pc_pw_last, dev.sw_info.sw_pt[pt].op_pw);
-			assert_int_equal(rio_pc_is_last, dev.sw_info.sw_pt[pt].iseq);
+			assert_false(dev->sw_info.sw_pt[pt].valid);
+			assert_int_equal(rio_pc_pw_last, dev->sw_info.sw_pt[pt].op_pw);
+			assert_int_equal(rio_pc_is_last, dev->sw_info.sw_pt[pt].iseq);
 			continue;
 		}
-		assert_int_equal(pt, dev.sw_info.sw_pt[pt].port);
-		assert_int_equal(1, dev.sw_info.sw_pt[pt].valid);
+		assert_int_equal(pt, dev->sw_info.sw_pt[pt].port);
+		assert_int_equal(1, dev->sw_info.sw_pt[pt].valid);
 		switch (pt) {
 		case 1:
 		case 8:
 		case 11:
-			assert_int_equal(rio_pc_pw_2x, dev.sw_info.sw_pt[pt].op_pw);
+			assert_int_equal(rio_pc_pw_2x, dev->sw_info.sw_pt[pt].op_pw);
 			break;
 		case 2:
 		case 3:
 		case 9:
 		case 10:
-			assert_int_equal(rio_pc_pw_1x, dev.sw_info.sw_pt[pt].op_pw);
+			assert_int_equal(rio_pc_pw_1x, dev->sw_info.sw_pt[pt].op_pw);
 			break;
 		default:
-			assert_int_equal(rio_pc_pw_4x, dev.sw_info.sw_pt[pt].op_pw);
+			assert_int_equal(rio_pc_pw_4x, dev->sw_info.sw_pt[pt].op_pw);
 		}
 		switch (pt) {
 		case 0:
-			assert_int_equal(rio_pc_ls_6p25, dev.sw_info.sw_pt[0].ls);
+			assert_int_equal(rio_pc_ls_6p25, dev->sw_info.sw_pt[0].ls);
 			break;
 		case 2:
-			assert_int_equal(rio_pc_ls_3p125, dev.sw_info.sw_pt[2].ls);
+			assert_int_equal(rio_pc_ls_3p125, dev->sw_info.sw_pt[2].ls);
 			break;
 		case 3:
-			assert_int_equal(rio_pc_ls_2p5, dev.sw_info.sw_pt[3].ls);
+			assert_int_equal(rio_pc_ls_2p5, dev->sw_info.sw_pt[3].ls);
 			break;
 		case 4:
-			assert_int_equal(rio_pc_ls_1p25, dev.sw_info.sw_pt[4].ls);
+			assert_int_equal(rio_pc_ls_1p25, dev->sw_info.sw_pt[4].ls);
 			break;
 		default:
-			assert_int_equal(rio_pc_ls_5p0, dev.sw_info.sw_pt[pt].ls);
+			assert_int_equal(rio_pc_ls_5p0, dev->sw_info.sw_pt[pt].ls);
 		}
 		if (pt < 4) {
-			assert_int_equal(rio_pc_is_two, dev.sw_info.sw_pt[pt].iseq);
+			assert_int_equal(rio_pc_is_two, dev->sw_info.sw_pt[pt].iseq);
 		} else {
-			assert_int_equal(rio_pc_is_one, dev.sw_info.sw_pt[pt].iseq);
+			assert_int_equal(rio_pc_is_one, dev->sw_info.sw_pt[pt].iseq);
 		}
 	}
 	// Check all 256 entries of dev08 global routing domain
 	// and multicast group tables.
-	assert_non_null(dev.sw_info.rt[DEV08_IDX]);
-	rt = dev.sw_info.rt[DEV08_IDX];
+	assert_non_null(dev->sw_info.rt[DEV08_IDX]);
+	rt = dev->sw_info.rt[DEV08_IDX];
 	assert_int_equal(RT_VAL_DROP, rt->default_route);
 	for (uint16_t rti = 0; rti < RIO_RT_GRP_SZ; rti++) {
 		assert_false(rt->dom_table[rti].changed);
@@ -771,58 +829,58 @@ static void cfg_parse_master_test(void **state)
 
 	// Check connections were set up correctly
 	assert_int_equal(0, cfg_get_conn_dev(0x70009, 0, &dev, &conn_pt));
-	assert_string_equal("GRYPHON_01", dev.name);
-	assert_int_equal(0x10005, dev.ct);
-	assert_false(dev.is_sw);
+	assert_string_equal("GRYPHON_01", dev->name);
+	assert_int_equal(0x10005, dev->ct);
+	assert_false(dev->is_sw);
 	assert_int_equal(0, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x70009, 1, &dev, &conn_pt));
-	assert_string_equal("GRYPHON_03", dev.name);
-	assert_int_equal(0x30007, dev.ct);
-	assert_false(dev.is_sw);
+	assert_string_equal("GRYPHON_03", dev->name);
+	assert_int_equal(0x30007, dev->ct);
+	assert_false(dev->is_sw);
 	assert_int_equal(0, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x70009, 4, &dev, &conn_pt));
-	assert_string_equal("GRYPHON_02", dev.name);
-	assert_int_equal(0x20006, dev.ct);
-	assert_false(dev.is_sw);
+	assert_string_equal("GRYPHON_02", dev->name);
+	assert_int_equal(0x20006, dev->ct);
+	assert_false(dev->is_sw);
 	assert_int_equal(0, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x70009, 5, &dev, &conn_pt));
-	assert_string_equal("GRYPHON_04", dev.name);
-	assert_int_equal(0x40008, dev.ct);
-	assert_false(dev.is_sw);
+	assert_string_equal("GRYPHON_04", dev->name);
+	assert_int_equal(0x40008, dev->ct);
+	assert_false(dev->is_sw);
 	assert_int_equal(0, conn_pt);
 	assert_int_not_equal(0, cfg_get_conn_dev(0x70009, 7, &dev, &conn_pt));
 	assert_int_equal(0, cfg_get_conn_dev(0x10005, 0, &dev, &conn_pt));
-	assert_string_equal("MAIN_SWITCH", dev.name);
-	assert_int_equal(0x70009, dev.ct);
-	assert_true(dev.is_sw);
+	assert_string_equal("MAIN_SWITCH", dev->name);
+	assert_int_equal(0x70009, dev->ct);
+	assert_true(dev->is_sw);
 	assert_int_equal(0, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x20006, 0, &dev, &conn_pt));
-	assert_string_equal("MAIN_SWITCH", dev.name);
-	assert_int_equal(0x70009, dev.ct);
-	assert_true(dev.is_sw);
+	assert_string_equal("MAIN_SWITCH", dev->name);
+	assert_int_equal(0x70009, dev->ct);
+	assert_true(dev->is_sw);
 	assert_int_equal(4, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x30007, 0, &dev, &conn_pt));
-	assert_string_equal("MAIN_SWITCH", dev.name);
-	assert_int_equal(0x70009, dev.ct);
-	assert_true(dev.is_sw);
+	assert_string_equal("MAIN_SWITCH", dev->name);
+	assert_int_equal(0x70009, dev->ct);
+	assert_true(dev->is_sw);
 	assert_int_equal(1, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x40008, 0, &dev, &conn_pt));
-	assert_string_equal("MAIN_SWITCH", dev.name);
-	assert_int_equal(0x70009, dev.ct);
-	assert_true(dev.is_sw);
+	assert_string_equal("MAIN_SWITCH", dev->name);
+	assert_int_equal(0x70009, dev->ct);
+	assert_true(dev->is_sw);
 	assert_int_equal(5, conn_pt);
 	assert_int_not_equal(0, cfg_get_conn_dev(0x40008, 1, &dev, &conn_pt));
 	assert_int_not_equal(0,cfg_find_dev_by_ct(0x99999, &dev));
 
 	count++;
-	free(cfg);
+	cfg_free_parms(cfg);
 	(void)state; // unused
 }
 
 static void cfg_parse_master16_test(void **state)
 {
 	struct cfg_mport_info mp;
-	struct cfg_dev dev16;
+	const struct cfg_dev *dev16;
 	int conn_pt;
 	char *dd_mtx_fn = NULL;
 	char *dd_fn = NULL;
@@ -850,119 +908,119 @@ static void cfg_parse_master16_test(void **state)
 	assert_int_not_equal(0, cfg_find_mport(3, &mp));
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x10005, &dev16));
-	assert_string_equal("GRYPHON_01", dev16.name);
-	assert_int_equal(0x10005, dev16.ct);
-	assert_int_equal(0, dev16.is_sw);
-	assert_int_equal(rio_pc_pw_4x, dev16.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_5p0, dev16.ep_pt.ls);
-	assert_int_equal(rio_pc_is_two, dev16.ep_pt.iseq);
-	assert_true(dev16.ep_pt.devids[DEV08_IDX].valid);
-	assert_int_equal(5, dev16.ep_pt.devids[DEV08_IDX].did_val);
-	assert_int_equal(0xFF, dev16.ep_pt.devids[DEV08_IDX].hc);
-	assert_true(dev16.ep_pt.devids[DEV16_IDX].valid);
-	assert_int_equal(0x5555, dev16.ep_pt.devids[DEV16_IDX].did_val);
-	assert_int_equal(0xFF, dev16.ep_pt.devids[DEV16_IDX].hc);
+	assert_string_equal("GRYPHON_01", dev16->name);
+	assert_int_equal(0x10005, dev16->ct);
+	assert_int_equal(0, dev16->is_sw);
+	assert_int_equal(rio_pc_pw_4x, dev16->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_5p0, dev16->ep_pt.ls);
+	assert_int_equal(rio_pc_is_two, dev16->ep_pt.iseq);
+	assert_true(dev16->ep_pt.devids[DEV08_IDX].valid);
+	assert_int_equal(5, dev16->ep_pt.devids[DEV08_IDX].did_val);
+	assert_int_equal(0xFF, dev16->ep_pt.devids[DEV08_IDX].hc);
+	assert_true(dev16->ep_pt.devids[DEV16_IDX].valid);
+	assert_int_equal(0x5555, dev16->ep_pt.devids[DEV16_IDX].did_val);
+	assert_int_equal(0xFF, dev16->ep_pt.devids[DEV16_IDX].hc);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x20006, &dev16));
-	assert_int_equal(0x20006, dev16.ct);
-	assert_string_equal("GRYPHON_02", dev16.name);
-	assert_int_equal(0, dev16.is_sw);
-	assert_int_equal(rio_pc_pw_2x, dev16.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_6p25, dev16.ep_pt.ls);
-	assert_int_equal(rio_pc_is_two, dev16.ep_pt.iseq);
-	assert_true(dev16.ep_pt.devids[DEV08_IDX].valid);
-	assert_int_equal(6, dev16.ep_pt.devids[DEV08_IDX].did_val);
-	assert_int_equal(1, dev16.ep_pt.devids[DEV08_IDX].hc);
-	assert_true(dev16.ep_pt.devids[DEV16_IDX].valid);
-	assert_int_equal(0x6666, dev16.ep_pt.devids[DEV16_IDX].did_val);
-	assert_int_equal(1, dev16.ep_pt.devids[DEV16_IDX].hc);
+	assert_int_equal(0x20006, dev16->ct);
+	assert_string_equal("GRYPHON_02", dev16->name);
+	assert_int_equal(0, dev16->is_sw);
+	assert_int_equal(rio_pc_pw_2x, dev16->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_6p25, dev16->ep_pt.ls);
+	assert_int_equal(rio_pc_is_two, dev16->ep_pt.iseq);
+	assert_true(dev16->ep_pt.devids[DEV08_IDX].valid);
+	assert_int_equal(6, dev16->ep_pt.devids[DEV08_IDX].did_val);
+	assert_int_equal(1, dev16->ep_pt.devids[DEV08_IDX].hc);
+	assert_true(dev16->ep_pt.devids[DEV16_IDX].valid);
+	assert_int_equal(0x6666, dev16->ep_pt.devids[DEV16_IDX].did_val);
+	assert_int_equal(1, dev16->ep_pt.devids[DEV16_IDX].hc);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x30007, &dev16));
-	assert_string_equal("GRYPHON_03", dev16.name);
-	assert_int_equal(0, dev16.is_sw);
-	assert_int_equal(0x30007, dev16.ct);
-	assert_int_equal(rio_pc_pw_2x, dev16.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_1p25, dev16.ep_pt.ls);
-	assert_int_equal(rio_pc_is_one, dev16.ep_pt.iseq);
-	assert_true(dev16.ep_pt.devids[DEV08_IDX].valid);
-	assert_int_equal(7, dev16.ep_pt.devids[DEV08_IDX].did_val);
-	assert_int_equal(1, dev16.ep_pt.devids[DEV08_IDX].hc);
-	assert_true(dev16.ep_pt.devids[DEV16_IDX].valid);
-	assert_int_equal(0x7777, dev16.ep_pt.devids[DEV16_IDX].did_val);
-	assert_int_equal(1, dev16.ep_pt.devids[DEV16_IDX].hc);
+	assert_string_equal("GRYPHON_03", dev16->name);
+	assert_int_equal(0, dev16->is_sw);
+	assert_int_equal(0x30007, dev16->ct);
+	assert_int_equal(rio_pc_pw_2x, dev16->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_1p25, dev16->ep_pt.ls);
+	assert_int_equal(rio_pc_is_one, dev16->ep_pt.iseq);
+	assert_true(dev16->ep_pt.devids[DEV08_IDX].valid);
+	assert_int_equal(7, dev16->ep_pt.devids[DEV08_IDX].did_val);
+	assert_int_equal(1, dev16->ep_pt.devids[DEV08_IDX].hc);
+	assert_true(dev16->ep_pt.devids[DEV16_IDX].valid);
+	assert_int_equal(0x7777, dev16->ep_pt.devids[DEV16_IDX].did_val);
+	assert_int_equal(1, dev16->ep_pt.devids[DEV16_IDX].hc);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x40008, &dev16));
-	assert_string_equal("GRYPHON_04", dev16.name);
-	assert_int_equal(0x40008, dev16.ct);
-	assert_int_equal(0, dev16.is_sw);
-	assert_int_equal(rio_pc_pw_4x, dev16.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_2p5, dev16.ep_pt.ls);
-	assert_int_equal(rio_pc_is_one, dev16.ep_pt.iseq);
-	assert_int_equal(8, dev16.ep_pt.devids[DEV08_IDX].did_val);
-	assert_int_equal(1, dev16.ep_pt.devids[DEV08_IDX].hc);
-	assert_true(dev16.ep_pt.devids[DEV16_IDX].valid);
-	assert_int_equal(0x8888, dev16.ep_pt.devids[DEV16_IDX].did_val);
-	assert_int_equal(1, dev16.ep_pt.devids[DEV16_IDX].hc);
+	assert_string_equal("GRYPHON_04", dev16->name);
+	assert_int_equal(0x40008, dev16->ct);
+	assert_int_equal(0, dev16->is_sw);
+	assert_int_equal(rio_pc_pw_4x, dev16->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_2p5, dev16->ep_pt.ls);
+	assert_int_equal(rio_pc_is_one, dev16->ep_pt.iseq);
+	assert_int_equal(8, dev16->ep_pt.devids[DEV08_IDX].did_val);
+	assert_int_equal(1, dev16->ep_pt.devids[DEV08_IDX].hc);
+	assert_true(dev16->ep_pt.devids[DEV16_IDX].valid);
+	assert_int_equal(0x8888, dev16->ep_pt.devids[DEV16_IDX].did_val);
+	assert_int_equal(1, dev16->ep_pt.devids[DEV16_IDX].hc);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x70009, &dev16));
-	assert_string_equal("MAIN_SWITCH", dev16.name);
-	assert_int_equal(0x70009, dev16.ct);
-	assert_int_equal(1, dev16.is_sw);
-	assert_int_equal(24, dev16.sw_info.num_ports);
-	for (rio_port_t pt = 0; pt < dev16.sw_info.num_ports; pt++) {
+	assert_string_equal("MAIN_SWITCH", dev16->name);
+	assert_int_equal(0x70009, dev16->ct);
+	assert_int_equal(1, dev16->is_sw);
+	assert_int_equal(24, dev16->sw_info.num_ports);
+	for (rio_port_t pt = 0; pt < dev16->sw_info.num_ports; pt++) {
 		// Per port routing tables are all invalid.
 		for (uint32_t idx = 0; idx < MAX_DEV_SZ_IDX; idx++) {
-			assert_null(dev16.sw_info.sw_pt[pt].rt[idx]);
+			assert_null(dev16->sw_info.sw_pt[pt].rt[idx]);
 		}
 		// Undefined ports
 		if (pt >= 18) {
-			assert_false(dev16.sw_info.sw_pt[pt].valid);
-			assert_int_equal(rio_pc_pw_last, dev16.sw_info.sw_pt[pt].op_pw);
-			assert_int_equal(rio_pc_is_last, dev16.sw_info.sw_pt[pt].iseq);
+			assert_false(dev16->sw_info.sw_pt[pt].valid);
+			assert_int_equal(rio_pc_pw_last, dev16->sw_info.sw_pt[pt].op_pw);
+			assert_int_equal(rio_pc_is_last, dev16->sw_info.sw_pt[pt].iseq);
 			continue;
 		}
-		assert_int_equal(pt, dev16.sw_info.sw_pt[pt].port);
-		assert_int_equal(1, dev16.sw_info.sw_pt[pt].valid);
+		assert_int_equal(pt, dev16->sw_info.sw_pt[pt].port);
+		assert_int_equal(1, dev16->sw_info.sw_pt[pt].valid);
 		switch (pt) {
 		case 1:
 		case 8:
 		case 11:
-			assert_int_equal(rio_pc_pw_2x, dev16.sw_info.sw_pt[pt].op_pw);
+			assert_int_equal(rio_pc_pw_2x, dev16->sw_info.sw_pt[pt].op_pw);
 			break;
 		case 2:
 		case 3:
 		case 9:
 		case 10:
-			assert_int_equal(rio_pc_pw_1x, dev16.sw_info.sw_pt[pt].op_pw);
+			assert_int_equal(rio_pc_pw_1x, dev16->sw_info.sw_pt[pt].op_pw);
 			break;
 		default:
-			assert_int_equal(rio_pc_pw_4x, dev16.sw_info.sw_pt[pt].op_pw);
+			assert_int_equal(rio_pc_pw_4x, dev16->sw_info.sw_pt[pt].op_pw);
 		}
 		switch (pt) {
 		case 0:
-			assert_int_equal(rio_pc_ls_6p25, dev16.sw_info.sw_pt[0].ls);
+			assert_int_equal(rio_pc_ls_6p25, dev16->sw_info.sw_pt[0].ls);
 			break;
 		case 2:
-			assert_int_equal(rio_pc_ls_3p125, dev16.sw_info.sw_pt[2].ls);
+			assert_int_equal(rio_pc_ls_3p125, dev16->sw_info.sw_pt[2].ls);
 			break;
 		case 3:
-			assert_int_equal(rio_pc_ls_2p5, dev16.sw_info.sw_pt[3].ls);
+			assert_int_equal(rio_pc_ls_2p5, dev16->sw_info.sw_pt[3].ls);
 			break;
 		case 4:
-			assert_int_equal(rio_pc_ls_1p25, dev16.sw_info.sw_pt[4].ls);
+			assert_int_equal(rio_pc_ls_1p25, dev16->sw_info.sw_pt[4].ls);
 			break;
 		default:
-			assert_int_equal(rio_pc_ls_5p0, dev16.sw_info.sw_pt[pt].ls);
+			assert_int_equal(rio_pc_ls_5p0, dev16->sw_info.sw_pt[pt].ls);
 		}
 		if (pt < 4) {
-			assert_int_equal(rio_pc_is_two, dev16.sw_info.sw_pt[pt].iseq);
+			assert_int_equal(rio_pc_is_two, dev16->sw_info.sw_pt[pt].iseq);
 		} else {
-			assert_int_equal(rio_pc_is_one, dev16.sw_info.sw_pt[pt].iseq);
+			assert_int_equal(rio_pc_is_one, dev16->sw_info.sw_pt[pt].iseq);
 		}
 	}
-	assert_null(dev16.sw_info.rt[DEV08_IDX]);
-	assert_non_null(dev16.sw_info.rt[DEV16_IDX]);
-	rt = dev16.sw_info.rt[DEV16_IDX];
+	assert_null(dev16->sw_info.rt[DEV08_IDX]);
+	assert_non_null(dev16->sw_info.rt[DEV16_IDX]);
+	rt = dev16->sw_info.rt[DEV16_IDX];
 	assert_int_equal(RT_VAL_DROP, rt->default_route);
 	// Check all 256 entries of the dev16 multicast group tables.
 	for (uint16_t rti = 0; rti < RIO_RT_GRP_SZ; rti++) {
@@ -1061,58 +1119,58 @@ static void cfg_parse_master16_test(void **state)
 
 	// Check connections were set up correctly
 	assert_int_equal(0, cfg_get_conn_dev(0x70009, 0, &dev16, &conn_pt));
-	assert_string_equal("GRYPHON_01", dev16.name);
-	assert_int_equal(0x10005, dev16.ct);
-	assert_false(dev16.is_sw);
+	assert_string_equal("GRYPHON_01", dev16->name);
+	assert_int_equal(0x10005, dev16->ct);
+	assert_false(dev16->is_sw);
 	assert_int_equal(0, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x70009, 1, &dev16, &conn_pt));
-	assert_string_equal("GRYPHON_03", dev16.name);
-	assert_int_equal(0x30007, dev16.ct);
-	assert_false(dev16.is_sw);
+	assert_string_equal("GRYPHON_03", dev16->name);
+	assert_int_equal(0x30007, dev16->ct);
+	assert_false(dev16->is_sw);
 	assert_int_equal(0, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x70009, 4, &dev16, &conn_pt));
-	assert_string_equal("GRYPHON_02", dev16.name);
-	assert_int_equal(0x20006, dev16.ct);
-	assert_false(dev16.is_sw);
+	assert_string_equal("GRYPHON_02", dev16->name);
+	assert_int_equal(0x20006, dev16->ct);
+	assert_false(dev16->is_sw);
 	assert_int_equal(0, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x70009, 5, &dev16, &conn_pt));
-	assert_string_equal("GRYPHON_04", dev16.name);
-	assert_int_equal(0x40008, dev16.ct);
-	assert_false(dev16.is_sw);
+	assert_string_equal("GRYPHON_04", dev16->name);
+	assert_int_equal(0x40008, dev16->ct);
+	assert_false(dev16->is_sw);
 	assert_int_equal(0, conn_pt);
 	assert_int_not_equal(0, cfg_get_conn_dev(0x70009, 7, &dev16, &conn_pt));
 	assert_int_equal(0, cfg_get_conn_dev(0x10005, 0, &dev16, &conn_pt));
-	assert_string_equal("MAIN_SWITCH", dev16.name);
-	assert_int_equal(0x70009, dev16.ct);
-	assert_true(dev16.is_sw);
+	assert_string_equal("MAIN_SWITCH", dev16->name);
+	assert_int_equal(0x70009, dev16->ct);
+	assert_true(dev16->is_sw);
 	assert_int_equal(0, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x20006, 0, &dev16, &conn_pt));
-	assert_string_equal("MAIN_SWITCH", dev16.name);
-	assert_int_equal(0x70009, dev16.ct);
-	assert_true(dev16.is_sw);
+	assert_string_equal("MAIN_SWITCH", dev16->name);
+	assert_int_equal(0x70009, dev16->ct);
+	assert_true(dev16->is_sw);
 	assert_int_equal(4, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x30007, 0, &dev16, &conn_pt));
-	assert_string_equal("MAIN_SWITCH", dev16.name);
-	assert_int_equal(0x70009, dev16.ct);
-	assert_true(dev16.is_sw);
+	assert_string_equal("MAIN_SWITCH", dev16->name);
+	assert_int_equal(0x70009, dev16->ct);
+	assert_true(dev16->is_sw);
 	assert_int_equal(1, conn_pt);
 	assert_int_equal(0, cfg_get_conn_dev(0x40008, 0, &dev16, &conn_pt));
-	assert_string_equal("MAIN_SWITCH", dev16.name);
-	assert_int_equal(0x70009, dev16.ct);
-	assert_true(dev16.is_sw);
+	assert_string_equal("MAIN_SWITCH", dev16->name);
+	assert_int_equal(0x70009, dev16->ct);
+	assert_true(dev16->is_sw);
 	assert_int_equal(5, conn_pt);
 	assert_int_not_equal(0, cfg_get_conn_dev(0x40008, 1, &dev16, &conn_pt));
 	assert_int_not_equal(0,cfg_find_dev_by_ct(0x99999, &dev16));
 
 	count++;
-	free(cfg);
+	cfg_free_parms(cfg);
 	(void)state; // unused
 }
 
 static void cfg_parse_slave_test(void **state)
 {
 	struct cfg_mport_info mp;
-	struct cfg_dev dev;
+	const struct cfg_dev *dev;
 	char *dd_mtx_fn = NULL;
 	char *dd_fn = NULL;
 	char *test_dd_mtx_fn = (char *)FMD_DFLT_DD_MTX_FN;
@@ -1139,14 +1197,14 @@ static void cfg_parse_slave_test(void **state)
 	assert_int_not_equal(0, cfg_find_dev_by_ct(0x70000, &dev));
 
 	count++;
-	free(cfg);
+	cfg_free_parms(cfg);
 	(void)state; // unused
 }
 
 static void cfg_parse_tor_test(void **state)
 {
 	struct cfg_mport_info mp;
-	struct cfg_dev dev;
+	const struct cfg_dev *dev;
 	char *dd_mtx_fn = NULL;
 	char *dd_fn = NULL;
 	char *test_dd_mtx_fn = (char *)FMD_DFLT_DD_MTX_FN;
@@ -1179,19 +1237,19 @@ static void cfg_parse_tor_test(void **state)
 
 	/* Check out the switch routing table parsing in detail. */
 	assert_int_equal(0, cfg_find_dev_by_ct(0x100f1, &dev));
-	assert_int_equal(1, dev.is_sw);
-	assert_int_equal(RIO_RTE_DROP, dev.sw_info.rt[DEV08_IDX]->default_route);
-	assert_int_equal(2, dev.sw_info.rt[DEV08_IDX]->dev_table[0x12].rte_val);
-	assert_int_equal(3, dev.sw_info.rt[DEV08_IDX]->dev_table[0x13].rte_val);
-	assert_int_equal(5, dev.sw_info.rt[DEV08_IDX]->dev_table[0x15].rte_val);
-	assert_int_equal(6, dev.sw_info.rt[DEV08_IDX]->dev_table[0x16].rte_val);
-	assert_int_equal(10, dev.sw_info.rt[DEV08_IDX]->dev_table[0x1A].rte_val);
-	assert_int_equal(11, dev.sw_info.rt[DEV08_IDX]->dev_table[0x1B].rte_val);
+	assert_int_equal(1, dev->is_sw);
+	assert_int_equal(RIO_RTE_DROP, dev->sw_info.rt[DEV08_IDX]->default_route);
+	assert_int_equal(2, dev->sw_info.rt[DEV08_IDX]->dev_table[0x12].rte_val);
+	assert_int_equal(3, dev->sw_info.rt[DEV08_IDX]->dev_table[0x13].rte_val);
+	assert_int_equal(5, dev->sw_info.rt[DEV08_IDX]->dev_table[0x15].rte_val);
+	assert_int_equal(6, dev->sw_info.rt[DEV08_IDX]->dev_table[0x16].rte_val);
+	assert_int_equal(10, dev->sw_info.rt[DEV08_IDX]->dev_table[0x1A].rte_val);
+	assert_int_equal(11, dev->sw_info.rt[DEV08_IDX]->dev_table[0x1B].rte_val);
 
 	for (p_idx = 0; p_idx < 6; p_idx++) {
 		int pnum = pnums[p_idx];
 		for (idx = 0; idx <= RIO_LAST_DEV8; idx++) {
-			assert_int_equal(chk_pnum[p_idx], dev.sw_info.sw_pt[pnum].rt[DEV08_IDX]->dev_table[idx].rte_val);
+			assert_int_equal(chk_pnum[p_idx], dev->sw_info.sw_pt[pnum].rt[DEV08_IDX]->dev_table[idx].rte_val);
 		}
 	}
 
@@ -1199,19 +1257,19 @@ static void cfg_parse_tor_test(void **state)
 	* and between switches.
 	*/
 	for (int idx = 0; idx < 4; idx++) {
-		struct cfg_dev ep, sw, rev_ep;
+		const struct cfg_dev *ep, *sw, *rev_ep;
 		int sw_pt, rev_pt;
 		uint32_t ct[4] = { 0x21001A, 0x220015, 0x230012, 0x240013 };
 
 		assert_int_equal(0, cfg_find_dev_by_ct(ct[idx], &ep));
 		assert_int_equal(0, cfg_get_conn_dev(ct[idx], 0, &sw, &sw_pt));
-		assert_int_equal(0, cfg_get_conn_dev(sw.ct, sw_pt, &rev_ep, &rev_pt));
-		assert_int_equal(0, memcmp(&ep, &rev_ep, sizeof(ep)));
+		assert_int_equal(0, cfg_get_conn_dev(sw->ct, sw_pt, &rev_ep, &rev_pt));
+		assert_ptr_equal(ep, rev_ep);
 		assert_int_equal(0, rev_pt);
 	}
 
 	for (int sw = 1; sw < 7; sw++) {
-		struct cfg_dev l0_sw, l1_sw, rev_dev;
+		const struct cfg_dev *l0_sw, *l1_sw, *rev_dev;
 		uint32_t ct = 0x000f0 + (0x10001 * sw);
 		int port_list[6] = {0, 1, 4, 7, 8, 9};
 		int pt_idx;
@@ -1222,20 +1280,20 @@ static void cfg_parse_tor_test(void **state)
 			l0_pt = port_list[pt_idx];
 
 			assert_int_equal(0, cfg_get_conn_dev(ct, l0_pt, &l1_sw, &l1_pt));
-			assert_int_equal(0, cfg_get_conn_dev(l1_sw.ct, l1_pt, &rev_dev, &rev_pt));
-			assert_int_equal(0, memcmp(&l0_sw, &rev_dev, sizeof(l0_sw)));
+			assert_int_equal(0, cfg_get_conn_dev(l1_sw->ct, l1_pt, &rev_dev, &rev_pt));
+			assert_ptr_equal(l0_sw, rev_dev);
 			assert_int_equal(l0_pt, rev_pt);
 		}
 	}
 
 	count++;
-	free(cfg);
+	cfg_free_parms(cfg);
 	(void)state; // unused
 }
 
 static void cfg_parse_rxs_test(void **state)
 {
-	struct cfg_dev dev;
+	const struct cfg_dev *dev;
 	char *dd_mtx_fn = NULL;
 	char *dd_fn = NULL;
 	char *test_dd_mtx_fn = (char *)FMD_DFLT_DD_MTX_FN;
@@ -1257,81 +1315,334 @@ static void cfg_parse_rxs_test(void **state)
 	assert_int_equal(FMD_DFLT_MAST_CM_PORT, m_cm_port);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x10005, &dev));
-	assert_int_equal(rio_pc_pw_4x, dev.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_5p0, dev.ep_pt.ls);
-	assert_int_equal(rio_pc_is_two, dev.ep_pt.iseq);
+	assert_int_equal(rio_pc_pw_4x, dev->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_5p0, dev->ep_pt.ls);
+	assert_int_equal(rio_pc_is_two, dev->ep_pt.iseq);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x20006, &dev));
-	assert_int_equal(rio_pc_pw_2x, dev.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_6p25, dev.ep_pt.ls);
-	assert_int_equal(rio_pc_is_two, dev.ep_pt.iseq);
+	assert_int_equal(rio_pc_pw_2x, dev->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_6p25, dev->ep_pt.ls);
+	assert_int_equal(rio_pc_is_two, dev->ep_pt.iseq);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x30007, &dev));
-	assert_int_equal(rio_pc_pw_4x, dev.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_3p125, dev.ep_pt.ls);
-	assert_int_equal(rio_pc_is_one, dev.ep_pt.iseq);
+	assert_int_equal(rio_pc_pw_4x, dev->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_3p125, dev->ep_pt.ls);
+	assert_int_equal(rio_pc_is_one, dev->ep_pt.iseq);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x40008, &dev));
-	assert_int_equal(rio_pc_pw_4x, dev.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_2p5, dev.ep_pt.ls);
-	assert_int_equal(rio_pc_is_one, dev.ep_pt.iseq);
+	assert_int_equal(rio_pc_pw_4x, dev->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_2p5, dev->ep_pt.ls);
+	assert_int_equal(rio_pc_is_one, dev->ep_pt.iseq);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x50009, &dev));
-	assert_int_equal(rio_pc_pw_4x, dev.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_10p3, dev.ep_pt.ls);
-	assert_int_equal(rio_pc_is_three, dev.ep_pt.iseq);
+	assert_int_equal(rio_pc_pw_4x, dev->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_10p3, dev->ep_pt.ls);
+	assert_int_equal(rio_pc_is_three, dev->ep_pt.iseq);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x6000A, &dev));
-	assert_int_equal(rio_pc_pw_4x, dev.ep_pt.op_pw);
-	assert_int_equal(rio_pc_ls_12p5, dev.ep_pt.ls);
-	assert_int_equal(rio_pc_is_dflt, dev.ep_pt.iseq);
+	assert_int_equal(rio_pc_pw_4x, dev->ep_pt.op_pw);
+	assert_int_equal(rio_pc_ls_12p5, dev->ep_pt.ls);
+	assert_int_equal(rio_pc_is_dflt, dev->ep_pt.iseq);
 
 	assert_int_equal(0, cfg_find_dev_by_ct(0x7007b, &dev));
 
-	assert_int_equal(1, dev.sw_info.sw_pt[1].valid);
-	assert_int_equal(1, dev.sw_info.sw_pt[1].port);
-	assert_int_equal(rio_pc_pw_4x, dev.sw_info.sw_pt[1].op_pw);
-	assert_int_equal(rio_pc_ls_5p0, dev.sw_info.sw_pt[1].ls);
-	assert_int_equal(rio_pc_is_two, dev.sw_info.sw_pt[1].iseq);
-
-	assert_int_equal(1, dev.sw_info.sw_pt[2].valid);
-	assert_int_equal(2, dev.sw_info.sw_pt[2].port);
-	assert_int_equal(rio_pc_pw_2x, dev.sw_info.sw_pt[2].op_pw);
-	assert_int_equal(rio_pc_ls_6p25, dev.sw_info.sw_pt[2].ls);
-	assert_int_equal(rio_pc_is_two, dev.sw_info.sw_pt[2].iseq);
-
-	assert_int_equal(1, dev.sw_info.sw_pt[3].valid);
-	assert_int_equal(3, dev.sw_info.sw_pt[3].port);
-	assert_int_equal(rio_pc_pw_4x, dev.sw_info.sw_pt[3].op_pw);
-	assert_int_equal(rio_pc_ls_3p125, dev.sw_info.sw_pt[3].ls);
-	assert_int_equal(rio_pc_is_one, dev.sw_info.sw_pt[3].iseq);
-
-	assert_int_equal(1, dev.sw_info.sw_pt[4].valid);
-	assert_int_equal(4, dev.sw_info.sw_pt[4].port);
-	assert_int_equal(rio_pc_pw_4x, dev.sw_info.sw_pt[4].op_pw);
-	assert_int_equal(rio_pc_ls_2p5, dev.sw_info.sw_pt[4].ls);
-	assert_int_equal(rio_pc_is_one, dev.sw_info.sw_pt[4].iseq);
-
-	assert_int_equal(1, dev.sw_info.sw_pt[5].valid);
-	assert_int_equal(5, dev.sw_info.sw_pt[5].port);
-	assert_int_equal(rio_pc_pw_4x, dev.sw_info.sw_pt[5].op_pw);
-	assert_int_equal(rio_pc_ls_10p3, dev.sw_info.sw_pt[5].ls);
-	assert_int_equal(rio_pc_is_three, dev.sw_info.sw_pt[5].iseq);
-
-	assert_int_equal(1, dev.sw_info.sw_pt[6].valid);
-	assert_int_equal(6, dev.sw_info.sw_pt[6].port);
-	assert_int_equal(rio_pc_pw_4x, dev.sw_info.sw_pt[6].op_pw);
-	assert_int_equal(rio_pc_ls_12p5, dev.sw_info.sw_pt[6].ls);
-	assert_int_equal(rio_pc_is_dflt, dev.sw_info.sw_pt[6].iseq);
+	assert_int_equal(1, dev->sw_info.sw_pt[1].valid);
+	assert_int_equal(1, dev->sw_info.sw_pt[1].port);
+	assert_int_equal(rio_pc_pw_4x, dev->sw_info.sw_pt[1].op_pw);
+	assert_int_equal(rio_pc_ls_5p0, dev->sw_info.sw_pt[1].ls);
+	assert_int_equal(rio_pc_is_two, dev->sw_info.sw_pt[1].iseq);
+
+	assert_int_equal(1, dev->sw_info.sw_pt[2].valid);
+	assert_int_equal(2, dev->sw_info.sw_pt[2].port);
+	assert_int_equal(rio_pc_pw_2x, dev->sw_info.sw_pt[2].op_pw);
+	assert_int_equal(rio_pc_ls_6p25, dev->sw_info.sw_pt[2].ls);
+	assert_int_equal(rio_pc_is_two, dev->sw_info.sw_pt[2].iseq);
+
+	assert_int_equal(1, dev->sw_info.sw_pt[3].valid);
+	assert_int_equal(3, dev->sw_info.sw_pt[3].port);
+	assert_int_equal(rio_pc_pw_4x, dev->sw_info.sw_pt[3].op_pw);
+	assert_int_equal(rio_pc_ls_3p125, dev->sw_info.sw_pt[3].ls);
+	assert_int_equal(rio_pc_is_one, dev->sw_info.sw_pt[3].iseq);
+
+	assert_int_equal(1, dev->sw_info.sw_pt[4].valid);
+	assert_int_equal(4, dev->sw_info.sw_pt[4].port);
+	assert_int_equal(rio_pc_pw_4x, dev->sw_info.sw_pt[4].op_pw);
+	assert_int_equal(rio_pc_ls_2p5, dev->sw_info.sw_pt[4].ls);
+	assert_int_equal(rio_pc_is_one, dev->sw_info.sw_pt[4].iseq);
+
+	assert_int_equal(1, dev->sw_info.sw_pt[5].valid);
+	assert_int_equal(5, dev->sw_info.sw_pt[5].port);
+	assert_int_equal(rio_pc_pw_4x, dev->sw_info.sw_pt[5].op_pw);
+	assert_int_equal(rio_pc_ls_10p3, dev->sw_info.sw_pt[5].ls);
+	assert_int_equal(rio_pc_is_three, dev->sw_info.sw_pt[5].iseq);
+
+	assert_int_equal(1, dev->sw_info.sw_pt[6].valid);
+	assert_int_equal(6, dev->sw_info.sw_pt[6].port);
+	assert_int_equal(rio_pc_pw_4x, dev->sw_info.sw_pt[6].op_pw);
+	assert_int_equal(rio_pc_ls_12p5, dev->sw_info.sw_pt[6].ls);
+	assert_int_equal(rio_pc_is_dflt, dev->sw_info.sw_pt[6].iseq);
 
 	assert_int_equal(0,cfg_get_conn_dev(0x7007b, 0, &dev, &conn_pt));
 
 	count++;
-	free(cfg);
+	cfg_free_parms(cfg);
 	(void)state; // unused
 }
 
 
+#define CACHE_CFG "/tmp/cfg_cache_test.cfg"
+
+static void copy_file(const char *from, const char *to, const char *extra)
+{
+	char buf[4096];
+	size_t len;
+	FILE *in = fopen(from, "r");
+	FILE *out = fopen(to, "w");
+
+	assert_non_null(in);
+	assert_non_null(out);
+	while ((len = fread(buf, 1, sizeof(buf), in)) > 0) {
+		assert_int_equal(len, fwrite(buf, 1, len, out));
+	}
+	if (NULL != extra) {
+		fputs(extra, out);
+	}
+	fclose(in);
+	assert_int_equal(0, fclose(out));
+}
+
+// Parse CACHE_CFG and check the result, returns true if the binary cache
+// was used.
+static bool cache_parse(rio_rt_state_t *rt_copy)
+{
+	char *dd_mtx_fn = NULL;
+	char *dd_fn = NULL;
+	did_t m_did;
+	uint32_t m_cm_port;
+	uint32_t m_mode;
+	const struct cfg_dev *dev;
+	int conn_pt;
+	bool cached;
+
+	did_reset();
+	ct_reset();
+	assert_int_equal(0, cfg_parse_file((char *)CACHE_CFG, &dd_mtx_fn,
+			&dd_fn, &m_did, &m_cm_port, &m_mode));
+	cached = (NULL != cfg->cache_map);
+
+	assert_string_equal(FMD_DFLT_DD_MTX_FN, dd_mtx_fn);
+	assert_string_equal(FMD_DFLT_DD_FN, dd_fn);
+	assert_int_equal(5, did_get_value(m_did));
+	assert_int_equal(1, m_mode);
+	assert_int_equal(4, cfg->ep_cnt);
+	assert_int_equal(1, cfg->sw_cnt);
+	assert_int_equal(4, cfg->conn_cnt);
+	assert_int_equal(3, cfg->max_mport_info_idx);
+	assert_ptr_equal(cfg->eps[0], cfg->mport_info[0].ep);
+
+	assert_int_equal(0, cfg_find_dev_by_ct(0x20006, &dev));
+	assert_string_equal("GRYPHON_02", dev->name);
+	assert_int_equal(rio_pc_ls_6p25, dev->ep_pt.ls);
+	assert_int_equal(0, cfg_get_conn_dev(0x20006, 0, &dev, &conn_pt));
+	assert_string_equal("MAIN_SWITCH", dev->name);
+	assert_int_equal(4, conn_pt);
+	assert_non_null(dev->sw_info.rt[DEV08_IDX]);
+	assert_null(dev->sw_info.rt[DEV16_IDX]);
+	if (cached) {
+		assert_int_equal(0, memcmp(rt_copy, dev->sw_info.rt[DEV08_IDX],
+				sizeof(rio_rt_state_t)));
+	} else {
+		memcpy(rt_copy, dev->sw_info.rt[DEV08_IDX],
+				sizeof(rio_rt_state_t));
+	}
+
+	free_string(&dd_mtx_fn);
+	free_string(&dd_fn);
+	cfg_free_parms(cfg);
+	return cached;
+}
+
+static void cfg_cache_test(void **state)
+{
+	char cache_fn[PATH_MAX];
+	rio_rt_state_t rt_copy;
+	struct stat st;
+	int fd;
+	char byte;
+
+	check_file_exists(MASTER_SUCCESS);
+	copy_file(MASTER_SUCCESS, CACHE_CFG, NULL);
+	assert_int_equal(0, cfg_cache_name(CACHE_CFG, cache_fn,
+			sizeof(cache_fn)));
+	unlink(cache_fn);
+
+	// The first parse writes the cache, the second one uses it
+	assert_false(cache_parse(&rt_copy));
+	assert_int_equal(0, stat(cache_fn, &st));
+	assert_true(cache_parse(&rt_copy));
+
+	// A corrupted cache is rejected and rewritten
+	fd = open(cache_fn, O_RDWR);
+	assert_true(fd >= 0);
+	assert_int_equal(1, pread(fd, &byte, 1, st.st_size / 2));
+	byte ^= 0x10;
+	assert_int_equal(1, pwrite(fd, &byte, 1, st.st_size / 2));
+	close(fd);
+	assert_false(cache_parse(&rt_copy));
+	assert_true(cache_parse(&rt_copy));
+
+	// A cache others can write is not used, and is replaced
+	assert_int_equal(0, chmod(cache_fn, 0666));
+	assert_false(cache_parse(&rt_copy));
+	assert_true(cache_parse(&rt_copy));
+
+	// Any change to the configuration file text invalidates the cache
+	copy_file(MASTER_SUCCESS, CACHE_CFG, "// changed\n");
+	assert_false(cache_parse(&rt_copy));
+	assert_true(cache_parse(&rt_copy));
+
+	unlink(cache_fn);
+	unlink(CACHE_CFG);
+	(void)state; // unused
+}
+
+#define BENCH_CFG "/tmp/cfg_bench.cfg"
+#define BENCH_SW 500
+#define BENCH_EP_PER_SW 10
+#define BENCH_EP (BENCH_SW * BENCH_EP_PER_SW)
+#define BENCH_EP_DID(e) (0x100 + (e))
+#define BENCH_EP_CT(e) ((((e) + 1) << 16) | BENCH_EP_DID(e))
+#define BENCH_SW_DID(s) (0x8000 + (s))
+#define BENCH_SW_CT(s) (((0x4000 + (s)) << 16) | BENCH_SW_DID(s))
+
+static double elapsed(struct timespec *st, struct timespec *end)
+{
+	return (end->tv_sec - st->tv_sec)
+			+ (end->tv_nsec - st->tv_nsec) / 1000000000.0;
+}
+
+// A ring of switches with endpoints on ports 0-9, linked on ports 10 and 11
+static void write_bench_cfg(void)
+{
+	FILE *f = fopen(BENCH_CFG, "w");
+	int s, p, e;
+
+	assert_non_null(f);
+	fprintf(f, "MPORT 0 master mem34 dev16 %x 255 END\n",
+			BENCH_EP_DID(0));
+	fprintf(f, "MASTER_INFO dev16 %x 3434\n", BENCH_EP_DID(0));
+	for (e = 0; e < BENCH_EP; e++) {
+		fprintf(f, "ENDPOINT EP_%d PORT 0 %x 4x 4x 5p0 IDLE2 EM_OFF "
+				"dev16 %x %d END PEND\n", e,
+				BENCH_EP_CT(e), BENCH_EP_DID(e), e ? 1 : 255);
+	}
+	for (s = 0; s < BENCH_SW; s++) {
+		fprintf(f, "SWITCH CPS1848 SW_%d dev16 %x 0 %x\n", s,
+				BENCH_SW_DID(s), BENCH_SW_CT(s));
+		for (p = 0; p < BENCH_EP_PER_SW + 2; p++) {
+			fprintf(f, "PORT %d 4x 4x 5p0 IDLE2 EM_OFF\n", p);
+		}
+		fprintf(f, "ROUTING_TABLE dev16 GLOBAL\nDFLTPORT DROP\nEND\n");
+	}
+	for (s = 0; s < BENCH_SW; s++) {
+		for (p = 0; p < BENCH_EP_PER_SW; p++) {
+			fprintf(f, "CONNECT SW_%d.%d EP_%d.0\n", s, p,
+					s * BENCH_EP_PER_SW + p);
+		}
+		fprintf(f, "CONNECT SW_%d.%d SW_%d.%d\n", s, BENCH_EP_PER_SW,
+				(s + 1) % BENCH_SW, BENCH_EP_PER_SW + 1);
+	}
+	fprintf(f, "EOF\n");
+	assert_int_equal(0, fclose(f));
+}
+
+static void cfg_parse_bench_test(void **state)
+{
+	char *dd_mtx_fn = NULL;
+	char *dd_fn = NULL;
+	did_t m_did;
+	uint32_t m_cm_port;
+	uint32_t m_mode;
+	const struct cfg_dev *dev;
+	struct timespec st, end;
+	double parse_t, cache_t, find_t, conn_t;
+	char cache_fn[PATH_MAX];
+	int conn_pt;
+	int s, p, e;
+
+	write_bench_cfg();
+	assert_int_equal(0, cfg_cache_name(BENCH_CFG, cache_fn,
+			sizeof(cache_fn)));
+	unlink(cache_fn);
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	assert_int_equal(0, cfg_parse_file((char *)BENCH_CFG, &dd_mtx_fn,
+			&dd_fn, &m_did, &m_cm_port, &m_mode));
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	parse_t = elapsed(&st, &end);
+	assert_null(cfg->cache_map);
+	free_string(&dd_mtx_fn);
+	free_string(&dd_fn);
+	cfg_free_parms(cfg);
+
+	did_reset();
+	ct_reset();
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	assert_int_equal(0, cfg_parse_file((char *)BENCH_CFG, &dd_mtx_fn,
+			&dd_fn, &m_did, &m_cm_port, &m_mode));
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	cache_t = elapsed(&st, &end);
+	assert_non_null(cfg->cache_map);
+	assert_int_equal(BENCH_EP, cfg->ep_cnt);
+	assert_int_equal(BENCH_SW, cfg->sw_cnt);
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	for (e = 0; e < BENCH_EP; e++) {
+		assert_int_equal(0, cfg_find_dev_by_ct(BENCH_EP_CT(e), &dev));
+		assert_int_equal(0, dev->is_sw);
+	}
+	for (s = 0; s < BENCH_SW; s++) {
+		assert_int_equal(0, cfg_find_dev_by_ct(BENCH_SW_CT(s), &dev));
+		assert_int_equal(1, dev->is_sw);
+		assert_non_null(dev->sw_info.rt[DEV16_IDX]);
+		assert_null(dev->sw_info.rt[DEV08_IDX]);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	find_t = elapsed(&st, &end);
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	for (s = 0; s < BENCH_SW; s++) {
+		ct_t ct = BENCH_SW_CT(s);
+
+		for (p = 0; p < BENCH_EP_PER_SW; p++) {
+			e = s * BENCH_EP_PER_SW + p;
+			assert_int_equal(0, cfg_get_conn_dev(ct, p, &dev,
+					&conn_pt));
+			assert_int_equal(BENCH_EP_CT(e), dev->ct);
+			assert_int_equal(0, conn_pt);
+		}
+		assert_int_equal(0, cfg_get_conn_dev(ct, BENCH_EP_PER_SW, &dev,
+				&conn_pt));
+		assert_int_equal(1, dev->is_sw);
+		assert_int_equal(BENCH_EP_PER_SW + 1, conn_pt);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	conn_t = elapsed(&st, &end);
+
+	printf("%d switches, %d endpoints: parse %.2f ms, cached %.2f ms, "
+			"find %.2f us/dev, conn %.2f us/port\n",
+			BENCH_SW, BENCH_EP, parse_t * 1000, cache_t * 1000,
+			find_t * 1000000 / (BENCH_EP + BENCH_SW),
+			conn_t * 1000000 / (BENCH_SW * (BENCH_EP_PER_SW + 1)));
+
+	free_string(&dd_mtx_fn);
+	free_string(&dd_fn);
+	cfg_free_parms(cfg);
+	unlink(cache_fn);
+	unlink(BENCH_CFG);
+	(void)state; // unused
+}
+
 int main(int argc, char *argv[])
 {
 	(void)argv; // not used
@@ -1350,12 +1661,16 @@ int main(int argc, char *argv[])
 	cmocka_unit_test_setup(cfg_parse_fail_7_test, setup),
 	cmocka_unit_test_setup(cfg_parse_fail_8_test, setup),
 	cmocka_unit_test_setup(cfg_parse_fail_9_test, setup),
+	cmocka_unit_test_setup(cfg_parse_fail_10_test, setup),
+	cmocka_unit_test_setup(cfg_parse_fail_11_test, setup),
 	cmocka_unit_test_setup(cfg_assign_dev16_rt_test, setup),
 	cmocka_unit_test_setup(cfg_parse_master_test, setup),
 	cmocka_unit_test_setup(cfg_parse_master16_test, setup),
 	cmocka_unit_test_setup(cfg_parse_slave_test, setup),
 	cmocka_unit_test_setup(cfg_parse_tor_test, setup),
 	cmocka_unit_test_setup(cfg_parse_rxs_test, setup),
+	cmocka_unit_test_setup(cfg_cache_test, setup),
+	cmocka_unit_test_setup(cfg_parse_bench_test, setup),
 	};
 	return cmocka_run_group_tests(tests, grp_setup, grp_teardown);
 }
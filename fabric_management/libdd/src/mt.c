@@ -0,0 +1,141 @@
+/*
+****************************************************************************
+Copyright (c) 2017, Integrated Device Technology Inc.
+Copyright (c) 2017, RapidIO Trade Association
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+may be used to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "fmd_mt.h"
+#include "liblog.h"
+#include "fmd_errmsg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int fmd_mt_init(char *mt_fn, int *mt_fd, struct fmd_mt **mt)
+{
+	int rc;
+
+	*mt_fd = shm_open(mt_fn, O_RDWR | O_CREAT | O_EXCL,
+			S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (-1 == *mt_fd) {
+		CRIT(MT_SHM_FAIL, mt_fn);
+		goto fail;
+	}
+
+	rc = ftruncate(*mt_fd, sizeof(struct fmd_mt));
+	if (-1 == rc) {
+		CRIT(MT_SHM_FAIL, mt_fn);
+		goto unlink;
+	}
+
+	*mt = (struct fmd_mt *)mmap(NULL, sizeof(struct fmd_mt),
+			PROT_READ|PROT_WRITE, MAP_SHARED, *mt_fd, 0);
+	if (MAP_FAILED == *mt) {
+		CRIT(MT_SHM_FAIL, mt_fn);
+		*mt = NULL;
+		goto unlink;
+	}
+
+	// ftruncate zero fills the file, so counting is off.
+	return 0;
+unlink:
+	close(*mt_fd);
+	*mt_fd = 0;
+	shm_unlink(mt_fn);
+fail:
+	return -1;
+}
+
+int fmd_mt_open(char *mt_fn, int *mt_fd, struct fmd_mt **mt)
+{
+	*mt_fd = shm_open(mt_fn, O_RDONLY, 0);
+	if (-1 == *mt_fd) {
+		*mt_fd = 0;
+		goto fail;
+	}
+
+	*mt = (struct fmd_mt *)mmap(NULL, sizeof(struct fmd_mt), PROT_READ,
+			MAP_SHARED, *mt_fd, 0);
+	if (MAP_FAILED == *mt) {
+		*mt = NULL;
+		close(*mt_fd);
+		*mt_fd = 0;
+		goto fail;
+	}
+	return 0;
+fail:
+	return -1;
+}
+
+void fmd_mt_cleanup(char *mt_fn, int *mt_fd, struct fmd_mt **mt_p, int mt_rw)
+{
+	if ((NULL != mt_p) && (NULL != *mt_p)) {
+		munmap(*mt_p, sizeof(struct fmd_mt));
+		*mt_p = NULL;
+	}
+
+	if ((NULL != mt_fd) && *mt_fd) {
+		close(*mt_fd);
+		*mt_fd = 0;
+		if (mt_rw) {
+			shm_unlink(mt_fn);
+		}
+	}
+}
+
+void fmd_mt_add(struct fmd_mt_ctr *dst, struct fmd_mt_ctr *src)
+{
+	uint32_t i;
+
+	dst->cnt += src->cnt;
+	dst->regs += src->regs;
+	dst->fails += src->fails;
+	dst->retries += src->retries;
+	dst->lat_ns += src->lat_ns;
+	if (src->max_ns > dst->max_ns) {
+		dst->max_ns = src->max_ns;
+	}
+	for (i = 0; i < FMD_MT_HIST_BKTS; i++) {
+		dst->hist[i] += src->hist[i];
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
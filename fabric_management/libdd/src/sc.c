@@ -0,0 +1,205 @@
+/*
+****************************************************************************
+Copyright (c) 2017, Integrated Device Technology Inc.
+Copyright (c) 2017, RapidIO Trade Association
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+may be used to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************
+*/
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "fmd_sc.h"
+#include "liblog.h"
+#include "fmd_errmsg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FMD_SC_COPY_TRIES 1000
+
+int fmd_sc_init(char *sc_fn, int *sc_fd, struct fmd_sc **sc)
+{
+	int rc;
+
+	*sc_fd = shm_open(sc_fn, O_RDWR | O_CREAT | O_EXCL,
+			S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (-1 == *sc_fd) {
+		CRIT(SC_SHM_FAIL, sc_fn);
+		goto fail;
+	}
+
+	rc = ftruncate(*sc_fd, sizeof(struct fmd_sc));
+	if (-1 == rc) {
+		CRIT(SC_SHM_FAIL, sc_fn);
+		goto unlink;
+	}
+
+	*sc = (struct fmd_sc *)mmap(NULL, sizeof(struct fmd_sc),
+			PROT_READ|PROT_WRITE, MAP_SHARED, *sc_fd, 0);
+	if (MAP_FAILED == *sc) {
+		CRIT(SC_SHM_FAIL, sc_fn);
+		*sc = NULL;
+		goto unlink;
+	}
+
+	// ftruncate zero fills the file, so all devices are empty.
+	return 0;
+unlink:
+	close(*sc_fd);
+	*sc_fd = 0;
+	shm_unlink(sc_fn);
+fail:
+	return -1;
+}
+
+int fmd_sc_open(char *sc_fn, int *sc_fd, struct fmd_sc **sc)
+{
+	*sc_fd = shm_open(sc_fn, O_RDONLY, 0);
+	if (-1 == *sc_fd) {
+		*sc_fd = 0;
+		goto fail;
+	}
+
+	*sc = (struct fmd_sc *)mmap(NULL, sizeof(struct fmd_sc), PROT_READ,
+			MAP_SHARED, *sc_fd, 0);
+	if (MAP_FAILED == *sc) {
+		*sc = NULL;
+		close(*sc_fd);
+		*sc_fd = 0;
+		goto fail;
+	}
+	return 0;
+fail:
+	return -1;
+}
+
+void fmd_sc_cleanup(char *sc_fn, int *sc_fd, struct fmd_sc **sc_p, int sc_rw)
+{
+	if ((NULL != sc_p) && (NULL != *sc_p)) {
+		munmap(*sc_p, sizeof(struct fmd_sc));
+		*sc_p = NULL;
+	}
+
+	if ((NULL != sc_fd) && *sc_fd) {
+		close(*sc_fd);
+		*sc_fd = 0;
+		if (sc_rw) {
+			shm_unlink(sc_fn);
+		}
+	}
+}
+
+int fmd_sc_atomic_copy_dev(struct fmd_sc *sc, uint32_t idx,
+		struct fmd_sc_dev *dev)
+{
+	struct fmd_sc_dev *src;
+	uint32_t seq;
+	int tries;
+
+	if ((NULL == sc) || (NULL == dev) || (idx >= FMD_MAX_DEVS)
+			|| (idx >= __atomic_load_n(&sc->num_devs,
+							__ATOMIC_ACQUIRE))) {
+		return -1;
+	}
+
+	src = &sc->devs[idx];
+	for (tries = 0; tries < FMD_SC_COPY_TRIES; tries++) {
+		seq = __atomic_load_n(&src->seq, __ATOMIC_ACQUIRE);
+		if (seq & 1) {
+			sched_yield();
+			continue;
+		}
+		memcpy(dev, src, sizeof(*dev));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (seq == __atomic_load_n(&src->seq, __ATOMIC_RELAXED)) {
+			return 0;
+		}
+	}
+	return -1;
+}
+
+int fmd_sc_get_rates(struct fmd_sc_port *port, uint32_t win,
+		uint64_t *rates)
+{
+	struct fmd_sc_sample *new_s, *old_s, *s;
+	uint64_t dt;
+	uint32_t i, n;
+
+	if ((NULL == port) || (port->cnt < 2) || !win) {
+		return -1;
+	}
+
+	if (win > port->cnt - 1) {
+		win = port->cnt - 1;
+	}
+
+	new_s = &port->ring[port->head % FMD_SC_RING_SZ];
+	for (i = 0; i < fmd_sc_stat_max; i++) {
+		// Counters restart from 0 when they are reinitialized, so
+		// only use the samples taken since the last restart.
+		old_s = new_s;
+		for (n = 1; n <= win; n++) {
+			s = &port->ring[(port->head + FMD_SC_RING_SZ - n)
+							% FMD_SC_RING_SZ];
+			if (s->val[i] > old_s->val[i]) {
+				break;
+			}
+			old_s = s;
+		}
+		dt = new_s->ts_ns - old_s->ts_ns;
+		rates[i] = dt ? (uint64_t)((double)(new_s->val[i]
+				- old_s->val[i]) * 1000000000.0 / dt) : 0;
+	}
+	return 0;
+}
+
+int fmd_sc_get_util(struct fmd_sc_port *port, uint64_t *rates)
+{
+	uint64_t bytes;
+
+	if ((NULL == port) || !port->mbps) {
+		return -1;
+	}
+
+	bytes = rates[fmd_sc_byte_rx];
+	if (rates[fmd_sc_byte_tx] > bytes) {
+		bytes = rates[fmd_sc_byte_tx];
+	}
+	return (int)((double)bytes * 8.0 / ((double)port->mbps * 1000.0));
+}
+
+#ifdef __cplusplus
+}
+#endif
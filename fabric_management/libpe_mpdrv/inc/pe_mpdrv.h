@@ -39,6 +39,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "riocp_pe.h"
 #include "RapidIO_Device_Access_Routines_API.h"
+#include "RapidIO_Port_Config_API.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,8 +47,12 @@ extern "C" {
 
 uint32_t SRIO_API_ReadRegFunc(DAR_DEV_INFO_t *d_info, uint32_t offset,
 		uint32_t *readdata);
+uint32_t SRIO_API_ReadRegBlockFunc(DAR_DEV_INFO_t *d_info, uint32_t offset,
+		uint32_t cnt, uint32_t *readdata);
 uint32_t SRIO_API_WriteRegFunc(DAR_DEV_INFO_t *d_info, uint32_t offset,
 		uint32_t writedata);
+uint32_t SRIO_API_WriteRegBlockFunc(DAR_DEV_INFO_t *d_info, uint32_t offset,
+		uint32_t cnt, uint32_t *writedata);
 void SRIO_API_DelayFunc(uint32_t delay_nsec, uint32_t delay_sec);
 
 // See riocp_drv definitions for comments (driver.h)
@@ -70,6 +75,12 @@ int RIOCP_WU mpsw_enable_pe(struct riocp_pe *pe, pe_port_t port);
 
 int RIOCP_WU mpsw_verify_pe(struct riocp_pe *pe, pe_port_t port);
 
+/* Checks that the configuration and status of both ends of the link
+ * connected to port match, like the first steps of mpsw_verify_pe, without
+ * changing the link.  Returns 0 if the link passes.
+ */
+int RIOCP_WU mpsw_check_link(struct riocp_pe *pe, pe_port_t port);
+
 int RIOCP_WU mpsw_drv_reg_rd(struct riocp_pe *pe, uint32_t offset,
 		uint32_t *val);
 int RIOCP_WU mpsw_drv_reg_wr(struct riocp_pe *pe, uint32_t offset,
@@ -79,6 +90,110 @@ int RIOCP_WU mpsw_drv_raw_reg_wr(struct riocp_pe *pe, did_val_t did_val, hc_t hc
 int RIOCP_WU mpsw_drv_raw_reg_rd(struct riocp_pe *pe, did_val_t did_val, hc_t hc,
 		uint32_t addr, uint32_t *val);
 
+/* Computes shortest path routes for all discovered destIDs, balanced
+ * across parallel links, and programs the global routing table of
+ * every switch reachable from mport.
+ */
+int RIOCP_WU mpsw_drv_compute_routes(struct riocp_pe *mport);
+
+/* Device initialization is split into the configuration needed to explore
+ * the fabric through a device, and the configuration of statistics
+ * counters, reset handling and event notification, which can be deferred.
+ * While initialization workers are running, the deferred part is performed
+ * by the workers in parallel with enumeration.
+ *
+ * Register, routing table and port status accesses do not touch the
+ * deferred configuration, and proceed while it is pending.  Routines which
+ * change port configuration or state, or verify it, complete the deferred
+ * initialization of the device first.
+ */
+#define MPSW_INIT_MAX_WORKERS 32
+
+/* Starts workers initialization worker threads.  With 0 workers, deferred
+ * initialization is performed immediately, as before.
+ * Returns 0 on success, or a negative errno.
+ */
+int RIOCP_WU mpsw_init_workers_start(uint32_t workers);
+
+/* Waits until all deferred initialization is complete.  Returns the number
+ * of devices whose deferred initialization failed since the last call.
+ */
+uint32_t mpsw_init_wait(void);
+
+/* Waits for deferred initialization, then stops the workers. */
+void mpsw_init_workers_stop(void);
+
+/* Maintenance transaction accounting
+ *
+ * While counting is on, the maintenance reads and writes performed by the
+ * driver are counted by device and by hop count.  Counting is off at
+ * startup.
+ */
+struct fmd_mt;
+
+/* Counts transactions in mt, which must be zero filled, or in a block of
+ * the driver if mt is NULL.  Counting stays on or off.
+ */
+void mpsw_mt_set(struct fmd_mt *mt);
+struct fmd_mt *mpsw_mt_get(void);
+
+void mpsw_mt_enable(bool on);
+bool mpsw_mt_enabled(void);
+
+/* Zeroes all counters.  Devices keep their entries. */
+void mpsw_mt_clear(void);
+
+/* Port status cache
+ *
+ * The driver keeps the last status read for each port of a device, so
+ * that mpsw_drv_get_port_state() and other readers get port status without
+ * maintenance transactions.  The status of a port is read from the device
+ * again after it is invalidated, by a port-write reporting an event on the
+ * port or by a driver routine which changes the port, and by the
+ * background refresh once it is older than the refresh period.
+ */
+struct mpsw_ps_cache_stats {
+	uint64_t age_ns; /* Age of the oldest cached port status */
+	uint32_t stale_ports; /* Ports which are read on the next access */
+	uint64_t hits; /* Status requests answered from the cache */
+	uint64_t misses; /* Status requests which read the device */
+	uint64_t invalidations; /* Ports invalidated by events or changes */
+	uint64_t refreshes; /* Ports read by the background refresh */
+	uint64_t pw_events; /* Events reported by port-writes */
+};
+
+/* Copies the status of port, or of all ports for RIO_ALL_PORTS, to ps.
+ * Stale ports are read from the device first.
+ */
+int RIOCP_WU mpsw_ps_cache_get(struct riocp_pe *pe, pe_port_t port,
+		rio_pc_get_status_out_t *ps);
+
+/* Marks port, or all ports for RIO_ALL_PORTS, as stale. */
+void mpsw_ps_cache_invalidate(struct riocp_pe *pe, pe_port_t port);
+
+/* Reads the ports which are stale, or whose status is older than
+ * max_age_ms.  Returns the number of ports read, or -1 on failure.
+ */
+int RIOCP_WU mpsw_ps_cache_refresh(struct riocp_pe *pe, uint32_t max_age_ms);
+
+int RIOCP_WU mpsw_ps_cache_get_stats(struct riocp_pe *pe,
+		struct mpsw_ps_cache_stats *stats);
+
+/* Decodes a port-write sent by pe, and invalidates the ports with events
+ * which may change port status.
+ */
+int RIOCP_WU mpsw_drv_port_write(struct riocp_pe *pe, uint32_t *pw);
+
+#define MPSW_PS_MAX_PERIOD 3600000
+
+/* Starts a thread which receives the port-writes sent to mport, and
+ * refreshes the cached port status of the devices behind mport every
+ * period_ms.  mpsw_ps_refresh_stop() stops the thread.
+ */
+int RIOCP_WU mpsw_ps_refresh_start(struct riocp_pe *mport,
+		uint32_t period_ms);
+void mpsw_ps_refresh_stop(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef __PE_MPDRV_PRIVATE_H__
 #define __PE_MPDRV_PRIVATE_H__
 
+#include <pthread.h>
+
 #include "rio_ecosystem.h"
 #include "RapidIO_Port_Config_API.h"
 #include "RapidIO_Routing_Table_API.h"
@@ -41,6 +43,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "RapidIO_Error_Management_API.h"
 #include "rapidio_mport_mgmt.h"
 #include "pe_mpdrv.h"
+#include "fmd_mt.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -68,6 +71,23 @@ struct mpsw_drv_pe_acc_info {
 	struct riomp_mgmt_mport_properties props; /* Mport properties */
 };
 
+/** @brief Progress of the deferred initialization of a pe
+ */
+enum mpsw_drv_init_state {
+	mpsw_init_done, /* Nothing pending */
+	mpsw_init_queued, /* Waiting for an initialization worker */
+	mpsw_init_running, /* Being performed */
+};
+
+/** @brief Port status cache of a pe, kept in st.ps, see pe_mpps.c
+ */
+struct mpsw_drv_ps_cache {
+	pthread_mutex_t mtx; /* Protects st.ps and this structure */
+	uint32_t stale; /* Bit per port whose status must be read again */
+	uint64_t ts_ns[RIO_MAX_PORTS]; /* CLOCK_MONOTONIC time of each read */
+	struct mpsw_ps_cache_stats stats;
+};
+
 /** @brief Driver private information structure for pe
  */
 struct mpsw_drv_private_data {
@@ -75,8 +95,51 @@ struct mpsw_drv_private_data {
 	int	dev_h_valid;
 	DAR_DEV_INFO_t	dev_h; /* Device driver handle */
 	struct mpsw_drv_pe_state st; /* Device state */
+	enum mpsw_drv_init_state init_st; /* Deferred initialization */
+	int	init_rc; /* Return code of deferred initialization */
+	struct mpsw_drv_private_data *init_next; /* Deferred init queue */
+	struct mpsw_drv_ps_cache ps_c; /* Port status cache */
+	struct fmd_mt *mt; /* Statistics block holding mt_dev */
+	struct fmd_mt_dev *mt_dev; /* Maintenance transaction counters */
 };
 
+int generic_device_init_deferred(struct riocp_pe *pe);
+
+/* Performs generic_device_init_deferred for pe on an initialization
+ * worker, or immediately when no workers are running.  Returns the
+ * result of an immediate initialization, otherwise 0.
+ */
+int mpsw_init_defer(struct riocp_pe *pe);
+
+/* Completes the deferred initialization of pe before the caller uses the
+ * device.  A queued initialization is performed by the calling thread.
+ */
+void mpsw_init_sync(struct riocp_pe *pe);
+
+/* Drops a queued deferred initialization of pe, or waits for one which
+ * is being performed.
+ */
+void mpsw_init_cancel(struct riocp_pe *pe);
+
+/* Maintenance transaction accounting.  mpsw_mt_begin() returns 0 when
+ * counting is off, otherwise the start time to pass to mpsw_mt_end().
+ * pe is the device accessed, or NULL if it is not known.  Accesses to
+ * mport local registers use hop count HC_MP.
+ */
+#define MT_HC(pe) (RIOCP_PE_IS_MPORT(pe) ? HC_MP : (pe)->hopcount)
+
+uint64_t mpsw_mt_begin(void);
+void mpsw_mt_end(uint64_t start, struct riocp_pe *pe, did_val_t did_val,
+		hc_t hc, uint32_t offset, uint32_t regs, enum fmd_mt_dir dir,
+		int rc);
+
+/* Sets up the port status cache with every port stale, and releases it. */
+void mpsw_ps_cache_init(struct mpsw_drv_private_data *priv);
+void mpsw_ps_cache_destroy(struct mpsw_drv_private_data *priv);
+
+/* Records that st.ps was just read for all ports. */
+void mpsw_ps_cache_loaded(struct mpsw_drv_private_data *priv);
+
 #ifdef __cplusplus
 }
 #endif
@@ -63,6 +63,8 @@
 #include "RapidIO_Statistics_Counter_API.h"
 #include "RapidIO_Device_Access_Routines_API.h"
 #include "RapidIO_Routing_Table_API.h"
+#include "RapidIO_Route_Compute_API.h"
+#include "RapidIO_Route_Transaction_API.h"
 #include "RapidIO_Port_Config_API.h"
 #include "cfg.h"
 #include "Tsi578.h"
@@ -144,6 +146,7 @@ int RIOCP_WU mpsw_drv_raw_reg_wr(struct riocp_pe *pe, did_val_t did_val, hc_t hc
 {
 	int rc;
 	struct mpsw_drv_pe_acc_info *p_acc = NULL;
+	uint64_t mt;
 
 	if (!RIOCP_PE_IS_HOST(pe)) {
 		return -ENOSYS;
@@ -154,12 +157,17 @@ int RIOCP_WU mpsw_drv_raw_reg_wr(struct riocp_pe *pe, did_val_t did_val, hc_t hc
 		return -EINVAL;
 	}
 
+	// The target of a remote access is not known, so it is only counted
+	// by hop count.
+	mt = mpsw_mt_begin();
 	// if (RIOCP_PE_IS_MPORT(pe) && (did == pe->destid))
 	if (RIOCP_PE_IS_MPORT(pe)) {
 		rc = riomp_mgmt_lcfg_write(p_acc->maint, addr, 4, val);
+		mpsw_mt_end(mt, pe, did_val, HC_MP, addr, 1, fmd_mt_wr, rc);
 	} else {
 		rc = riomp_mgmt_rcfg_write(p_acc->maint, did_val, hc,
 				addr, 4, val);
+		mpsw_mt_end(mt, NULL, did_val, hc, addr, 1, fmd_mt_wr, rc);
 	}
 	return rc;
 }
@@ -169,17 +177,21 @@ int RIOCP_WU mpsw_drv_raw_reg_rd(struct riocp_pe *pe, did_val_t did_val, hc_t hc
 {
 	int rc;
 	struct mpsw_drv_pe_acc_info *p_acc = NULL;
+	uint64_t mt;
 
 	p_acc = (struct mpsw_drv_pe_acc_info *)pe->mport->minfo->private_data;
 	if (!p_acc->maint_valid) {
 		return -EINVAL;
 	}
 
+	mt = mpsw_mt_begin();
 	if (RIOCP_PE_IS_MPORT(pe)) {
 		rc = riomp_mgmt_lcfg_read(p_acc->maint, addr, 4, val);
+		mpsw_mt_end(mt, pe, did_val, HC_MP, addr, 1, fmd_mt_rd, rc);
 	} else {
 		rc = riomp_mgmt_rcfg_read(p_acc->maint, did_val, hc,
 				addr, 4, val);
+		mpsw_mt_end(mt, NULL, did_val, hc, addr, 1, fmd_mt_rd, rc);
 	}
 	return rc;
 }
@@ -255,6 +267,7 @@ int mpsw_alloc_priv_data(struct riocp_pe *pe, void **p_dat,
 	priv_ptr->dev_h_valid = 0;
 	priv_ptr->dev_h.privateData = (void *)pe;
 	priv_ptr->dev_h.accessInfo = NULL;
+	mpsw_ps_cache_init(priv_ptr);
 
 	if (priv_ptr->is_mport) {
 		struct mpsw_drv_pe_acc_info *acc_p;
@@ -317,6 +330,8 @@ int mpsw_destroy_priv_data(struct riocp_pe *pe)
 	if (NULL == pe->private_data)
 		return 0;
 
+	mpsw_init_cancel(pe);
+
 	priv_ptr = (struct mpsw_drv_private_data *)pe->private_data;
 	if (NULL != priv_ptr->dev_h.accessInfo) {
 		struct mpsw_drv_pe_acc_info *acc_p;
@@ -331,6 +346,7 @@ int mpsw_destroy_priv_data(struct riocp_pe *pe)
 		}
 		free(priv_ptr->dev_h.accessInfo);
 	}
+	mpsw_ps_cache_destroy(priv_ptr);
 	free(pe->private_data);
 
 	return 0;
@@ -397,7 +413,7 @@ fail:
 int mpdrv_init_rt(struct riocp_pe *pe, DAR_DEV_INFO_t *dh,
 		struct mpsw_drv_private_data *priv, pe_port_t acc_port)
 {
-	struct cfg_dev sw;
+	const struct cfg_dev *sw;
 	rio_rt_set_all_in_t set_in;
 	rio_rt_set_all_out_t set_out;
 	pe_port_t port;
@@ -415,24 +431,24 @@ int mpdrv_init_rt(struct riocp_pe *pe, DAR_DEV_INFO_t *dh,
 		return 0;
 	}
 
-	if (NULL != sw.sw_info.rt[did_sz_idx]) {
+	if (NULL != sw->sw_info.rt[did_sz_idx]) {
 		set_in.set_on_port = RIO_ALL_PORTS;
-		set_in.rt = sw.sw_info.rt[did_sz_idx];
+		set_in.rt = sw->sw_info.rt[did_sz_idx];
 
 		rc = rio_rt_set_all(dh, &set_in, &set_out);
 		if (RIO_SUCCESS != rc) {
 			ERR("Error programming global rt on ct 0x%x rc %d\n",
-					sw.ct, rc);
+					sw->ct, rc);
 			goto fail;
 		}
 	}
 
 	for (port = 0; port < NUM_PORTS(dh); port++) {
-		if (NULL == sw.sw_info.sw_pt[port].rt[did_sz_idx])
+		if (NULL == sw->sw_info.sw_pt[port].rt[did_sz_idx])
 			continue;
 
 		set_in.set_on_port = port;
-		set_in.rt = sw.sw_info.sw_pt[port].rt[did_sz_idx];
+		set_in.rt = sw->sw_info.sw_pt[port].rt[did_sz_idx];
 
 		rc = rio_rt_set_all(dh, &set_in, &set_out);
 		if (RIO_SUCCESS != rc) {
@@ -519,6 +535,7 @@ uint32_t rio_sc_config_dev_ctrs(DAR_DEV_INFO_t *dev_h,
 		tsi_in.prio_mask = SC_PRIO_MASK_G1_ALL;
 		tsi_in.dev_ctrs = &priv->st.sc_dev;
 		for (idx = 0; idx < TSI578_NUM_PERF_CTRS; idx++) {
+			tsi_in.ctr_idx = idx;
 			tsi_in.tx = tsi_sc_cfg[idx].tx;
 			tsi_in.ctr_type = tsi_sc_cfg[idx].ctr_t;
 			rc = rio_sc_cfg_tsi57x_ctr(dev_h, &tsi_in, &tsi_out);
@@ -578,16 +595,11 @@ int generic_device_init(struct riocp_pe *pe)
 	DAR_DEV_INFO_t *dev_h = NULL;
 	struct DAR_ptl ptl;
 	rio_pc_set_config_in_t set_pc_in;
-	rio_pc_dev_reset_config_in_t rst_in = {rio_pc_rst_port};
-	rio_pc_dev_reset_config_out_t rst_out;
 	rio_pc_get_status_in_t ps_in;
 	rio_pc_get_config_in_t pc_in;
-	rio_sc_init_dev_ctrs_in_t sc_in;
-	rio_sc_init_dev_ctrs_out_t sc_out;
-	rio_em_dev_rpt_ctl_in_t rpt_in;
 	did_t did;
 	rio_port_t port;
-	struct cfg_dev sw;
+	const struct cfg_dev *sw;
 	int rc = 1;
 
 	DBG("ENTRY\n");
@@ -716,31 +728,31 @@ int generic_device_init(struct riocp_pe *pe)
 	}
 
 	if (!cfg_find_dev_by_ct(pe->comptag, &sw)) {
-		if (sw.is_sw) {
-			for (port = 0; port < sw.sw_info.num_ports; port++) {
-				if (!sw.sw_info.sw_pt[port].valid) {
+		if (sw->is_sw) {
+			for (port = 0; port < sw->sw_info.num_ports; port++) {
+				if (!sw->sw_info.sw_pt[port].valid) {
 					set_pc_in.pc[port].port_available
 									= false;
 					set_pc_in.pc[port].powered_up = false;
 					continue;
 				}
-				if (sw.sw_info.sw_pt[port].port != port) {
+				if (sw->sw_info.sw_pt[port].port != port) {
 					ERR("Port numbers unequal %d %d\n",
 						port,
-						sw.sw_info.sw_pt[port].port);
+						sw->sw_info.sw_pt[port].port);
 					goto exit;
 				}
 				
 				set_pc_in.pc[port].ls =
-						sw.sw_info.sw_pt[port].ls;
+						sw->sw_info.sw_pt[port].ls;
 				set_pc_in.pc[port].pw =
-						sw.sw_info.sw_pt[port].op_pw;
+						sw->sw_info.sw_pt[port].op_pw;
 				set_pc_in.pc[port].iseq =
-						sw.sw_info.sw_pt[port].iseq;
+						sw->sw_info.sw_pt[port].iseq;
 			}
 		} else {
-			set_pc_in.pc[0].ls = sw.ep_pt.ls;
-			set_pc_in.pc[0].pw = sw.ep_pt.op_pw;
+			set_pc_in.pc[0].ls = sw->ep_pt.ls;
+			set_pc_in.pc[0].pw = sw->ep_pt.op_pw;
 		}
 	}
 
@@ -756,6 +768,7 @@ int generic_device_init(struct riocp_pe *pe)
 		ERR("rio_pc_get_status returned %d\n", rc);
 		goto exit;
 	}
+	mpsw_ps_cache_loaded(priv);
 
 	if (SWITCH(dev_h)) {
 		// initialize the status of the routing tables
@@ -781,6 +794,44 @@ int generic_device_init(struct riocp_pe *pe)
 		}
 	}
 
+	DBG("EXIT 0\n");
+	return 0;
+
+exit:
+	DBG("EXIT error %d\n", rc);
+	return rc;
+}
+
+// Configuration which is not needed to explore the fabric through the
+// device: statistics counters, reset handling and event notification.
+// May run on an initialization worker, see mpsw_init_defer().
+
+int generic_device_init_deferred(struct riocp_pe *pe)
+{
+	struct mpsw_drv_private_data *priv = NULL;
+	DAR_DEV_INFO_t *dev_h = NULL;
+	rio_pc_dev_reset_config_in_t rst_in = {rio_pc_rst_port};
+	rio_pc_dev_reset_config_out_t rst_out;
+	rio_sc_init_dev_ctrs_in_t sc_in;
+	rio_sc_init_dev_ctrs_out_t sc_out;
+	rio_em_dev_rpt_ctl_in_t rpt_in;
+	int rc = 1;
+
+	DBG("ENTRY\n");
+	priv = (struct mpsw_drv_private_data *)(pe->private_data);
+
+	if (NULL == priv) {
+		ERR("Private Data is NULL, exiting\n");
+		goto exit;
+	}
+
+	dev_h = &priv->dev_h;
+
+	if (!RIOCP_PE_IS_HOST(pe)) {
+		rc = 0;
+		goto exit;
+	}
+
 	// Initialize performance counter structure, and 
 	// set default hardware performance counter configuration
 	sc_in.ptl.num_ports = RIO_ALL_PORTS;
@@ -905,6 +956,12 @@ int RIOCP_WU mpsw_drv_init_pe(struct riocp_pe *pe, struct riocp_pe *peer,
 		goto exit;
 	}
 
+	ret = mpsw_init_defer(pe);
+	if (ret) {
+		ERR("Deferred device init failed: %d (0x%x)\n", ret, ret);
+		goto exit;
+	}
+
 exit:
 	DBG("EXIT %d\n", ret);
 	return ret;
@@ -933,6 +990,8 @@ int RIOCP_WU mpsw_drv_recover_port(struct riocp_pe *pe, pe_port_t port,
 		goto fail;
 	}
 
+	mpsw_init_sync(pe);
+
 	if (!p_dat->dev_h_valid) {
 		DBG("Device handle not valid EXITING!\n");
 		goto fail;
@@ -945,6 +1004,7 @@ int RIOCP_WU mpsw_drv_recover_port(struct riocp_pe *pe, pe_port_t port,
 	clr_errs_in.lp_port_list[0] = lp_port;
 
 	ret = rio_pc_clr_errs(&p_dat->dev_h, &clr_errs_in, &clr_errs_out);
+	mpsw_ps_cache_invalidate(pe, port);
 	if (ret) {
 		DBG("Failed clearing %s Port %d ret 0x%x imp_rc 0x%x\n",
 				pe->sysfs_name, port, ret, clr_errs_out.imp_rc);
@@ -981,7 +1041,7 @@ int RIOCP_WU mpsw_drv_get_route_entry(struct riocp_pe *pe, pe_port_t port,
 
 	destID = (did_reg_t)did_get_value(did);
 	probe_in.probe_on_port = port;
-	probe_in.tt = tt_dev8;
+	probe_in.tt = (dev16_sz == did_get_size(did)) ? tt_dev16 : tt_dev8;
 	probe_in.destID = destID;
 	probe_in.rt = &p_dat->st.g_rt;
 
@@ -1024,9 +1084,12 @@ int RIOCP_WU mpsw_drv_set_route_entry(struct riocp_pe *pe, pe_port_t port,
 		goto fail;
 	}
 
+	// dev16 destIDs outside of domain 0 are routed by the domain table
 	did_val = did_get_value(did);
-	chg_in.dom_entry = 0;
-	chg_in.idx = did_val;
+	chg_in.dom_entry = (dev16_sz == did_get_size(did))
+			&& DID_DOM_VAL(did_val);
+	chg_in.idx = chg_in.dom_entry ? DID_DOM_VAL(did_val)
+			: DID_DEV_VAL(did_val);
 	chg_in.rte_value = rt_val;
 	if (RIO_ALL_PORTS == port) {
 		chg_in.rt = &p_dat->st.g_rt;
@@ -1078,6 +1141,8 @@ bool reset_lp)
 		goto fail;
 	}
 
+	mpsw_init_sync(pe);
+
 	if (!p_dat->dev_h_valid) {
 		DBG("Device handle not valid EXITING!\n");
 		goto fail;
@@ -1095,6 +1160,7 @@ bool reset_lp)
 	reset_in.preserve_config = true;
 
 	ret = rio_pc_reset_port(&p_dat->dev_h, &reset_in, &reset_out);
+	mpsw_ps_cache_invalidate(pe, port);
 	if (ret) {
 		DBG("PC_reset_port %s port %d ret 0x%x imp_rc 0x%x\n",
 				pe->sysfs_name, port, ret, reset_out.imp_rc);
@@ -1113,7 +1179,7 @@ int RIOCP_WU mpsw_drv_get_port_state(struct riocp_pe *pe, pe_port_t port,
 {
 	struct mpsw_drv_private_data *p_dat = NULL;
 	int ret;
-	rio_pc_get_status_in_t st_in;
+	rio_pc_get_status_out_t st_out;
 
 	DBG("ENTRY\n");
 	if (riocp_pe_handle_get_private(pe, (void **)&p_dat)) {
@@ -1136,18 +1202,19 @@ int RIOCP_WU mpsw_drv_get_port_state(struct riocp_pe *pe, pe_port_t port,
 		goto fail;
 	}
 
-	st_in.ptl.num_ports = RIO_ALL_PORTS;
-	ret = rio_pc_get_status(&p_dat->dev_h, &st_in, &p_dat->st.ps);
+	// Port status comes from the cache, and is read from the device only
+	// when the port is stale.
+	ret = mpsw_ps_cache_get(pe, port, &st_out);
 	if (ret) {
 		DBG("PC_Status %s port %d ret 0x%x imp_rc 0x%x\n",
-				pe->sysfs_name, port, ret, p_dat->st.ps.imp_rc);
+				pe->sysfs_name, port, ret, st_out.imp_rc);
 		goto fail;
 	}
 
-	state->port_ok = p_dat->st.ps.ps[port].port_ok;
+	state->port_ok = st_out.ps[0].port_ok;
 	state->port_max_width = PW_TO_LANES(p_dat->st.pc.pc[port].pw);
 	if (state->port_ok) {
-		state->port_cur_width = PW_TO_LANES(p_dat->st.ps.ps[port].pw);
+		state->port_cur_width = PW_TO_LANES(st_out.ps[0].pw);
 	} else {
 		state->port_cur_width = 0;
 	}
@@ -1266,6 +1333,8 @@ int RIOCP_WU mpsw_enable_pe(struct riocp_pe *pe, pe_port_t port)
 		goto fail;
 	}
 
+	mpsw_init_sync(pe);
+
 	dev_h = &priv->dev_h;
 	if (!priv->dev_h.extFPtrForPort) {
 		ERR("DevID 0x%x extFPtrForPort is 0", priv->dev_h.devID);
@@ -1315,6 +1384,8 @@ int RIOCP_WU mpsw_enable_pe(struct riocp_pe *pe, pe_port_t port)
 	}
 
 	rc = rio_pc_set_config(dev_h, &set_pc_in, &priv->st.pc);
+	mpsw_ps_cache_invalidate(pe, (st_port == end_port) ? st_port
+							: RIO_ALL_PORTS);
 	if (RIO_SUCCESS != rc) {
 		goto fail;
 	}
@@ -1436,7 +1507,7 @@ fail:
 
 int check_stat_match(rio_pc_one_port_status_t *ps, rio_pc_one_port_status_t *lp)
 {
-	int rc = 0;
+	int rc = 1;
 	if (check_stat(ps) | check_stat(lp)) {
 		DBG("Check port status failed.");
 		goto fail;
@@ -1458,24 +1529,26 @@ fail:
 	return rc;
 }
 
-// Note that verify_pe performs a RapidIO compliance test.  This functionality
-// is not generally required for most systems.
+// Ends of a link, and their configuration, found by check_link.
+struct mpsw_link_chk {
+	riocp_pe_handle peer;
+	pe_port_t peer_port;
+	DAR_DEV_INFO_t *pe_dev_h;
+	DAR_DEV_INFO_t *peer_dev_h;
+	rio_pc_get_config_out_t pe_cfg;
+	rio_pc_get_config_out_t peer_cfg;
+};
 
-int RIOCP_WU mpsw_verify_pe(struct riocp_pe *pe, pe_port_t port)
+// Checks that the configuration and status of both ends of the link
+// connected to port match, without changing either end.
+static int check_link(struct riocp_pe *pe, pe_port_t port,
+		struct mpsw_link_chk *lc)
 {
 	int rc = -1;
 	uint32_t ret;
-	riocp_pe_handle peer;
-	pe_port_t peer_port;
 	struct mpsw_drv_private_data *pe_priv = NULL;
-	DAR_DEV_INFO_t *pe_dev_h;
 	struct mpsw_drv_private_data *peer_priv = NULL;
-	DAR_DEV_INFO_t *peer_dev_h;
 	rio_pc_get_config_in_t pe_get_cfg, peer_get_cfg;
-	rio_pc_get_config_out_t pe_cfg, peer_cfg;
-	rio_pc_get_config_out_t peer_saved_cfg;
-	rio_pc_set_config_in_t peer_set_cfg;
-	rio_pc_set_config_out_t peer_set_cfg_o;
 	rio_pc_get_status_in_t pe_get_stat, peer_get_stat;
 	rio_pc_get_status_out_t pe_stat, peer_stat;
 
@@ -1486,46 +1559,48 @@ int RIOCP_WU mpsw_verify_pe(struct riocp_pe *pe, pe_port_t port)
                 goto fail;
         }
 
-	peer = pe->peers[port].peer;
-	peer_port = pe->peers[port].remote_port;
+	lc->peer = pe->peers[port].peer;
+	lc->peer_port = pe->peers[port].remote_port;
 
 	if (riocp_pe_handle_get_private(pe, (void **)&pe_priv)) {
 		DBG("Private Data does not exist for PE... EXITING!\n");
 		rc = 0x10;
 		goto fail;
 	}
-	pe_dev_h = &pe_priv->dev_h;
+	mpsw_init_sync(pe);
+	lc->pe_dev_h = &pe_priv->dev_h;
 	
-	if (riocp_pe_handle_get_private(peer, (void **)&peer_priv)) {
+	if (riocp_pe_handle_get_private(lc->peer, (void **)&peer_priv)) {
 		DBG("Private Data does not exist for PEER... EXITING!\n");
 		rc = 0x11;
 		goto fail;
 	}
-	peer_dev_h = &peer_priv->dev_h;
+	mpsw_init_sync(lc->peer);
+	lc->peer_dev_h = &peer_priv->dev_h;
 
 	pe_get_cfg.ptl.num_ports = 1;
 	pe_get_cfg.ptl.pnums[0] = port;
 
 	peer_get_cfg.ptl.num_ports = 1;
-	peer_get_cfg.ptl.pnums[0] = peer_port;
+	peer_get_cfg.ptl.pnums[0] = lc->peer_port;
 
-	ret = rio_pc_get_config(pe_dev_h, &pe_get_cfg, &pe_cfg);
+	ret = rio_pc_get_config(lc->pe_dev_h, &pe_get_cfg, &lc->pe_cfg);
 	if (RIO_SUCCESS != ret) {
 		DBG("Could not get PE config, ret = 0x%x! 0x%x\n",
-			ret, pe_cfg.imp_rc);
+			ret, lc->pe_cfg.imp_rc);
 		rc = 0x21;
 		goto fail;
 	}
 
-	ret = rio_pc_get_config(peer_dev_h, &peer_get_cfg, &peer_cfg);
+	ret = rio_pc_get_config(lc->peer_dev_h, &peer_get_cfg, &lc->peer_cfg);
 	if (RIO_SUCCESS != ret) {
 		DBG("Could not get PEER config, ret = 0x%x 0x%x!\n",
-			ret, peer_cfg.imp_rc);
+			ret, lc->peer_cfg.imp_rc);
 		rc = 0x22;
 		goto fail;
 	}
 
-	if (check_cfg_match(&pe_cfg.pc[0], &peer_cfg.pc[0])) {
+	if (check_cfg_match(&lc->pe_cfg.pc[0], &lc->peer_cfg.pc[0])) {
 		DBG("Port configs do not match.");
 		rc = 0x23;
 		goto fail;
@@ -1535,9 +1610,9 @@ int RIOCP_WU mpsw_verify_pe(struct riocp_pe *pe, pe_port_t port)
 	pe_get_stat.ptl.pnums[0] = port;
 
 	peer_get_stat.ptl.num_ports = 1;
-	peer_get_stat.ptl.pnums[0] = peer_port;
+	peer_get_stat.ptl.pnums[0] = lc->peer_port;
 
-	ret = rio_pc_get_status(pe_dev_h, &pe_get_stat, &pe_stat);
+	ret = rio_pc_get_status(lc->pe_dev_h, &pe_get_stat, &pe_stat);
 	if (RIO_SUCCESS != ret) {
 		DBG("Could not get PE status, ret = 0x%x 0x%x!\n",
 			ret, pe_stat.imp_rc);
@@ -1545,7 +1620,7 @@ int RIOCP_WU mpsw_verify_pe(struct riocp_pe *pe, pe_port_t port)
 		goto fail;
 	}
 
-	ret = rio_pc_get_status(peer_dev_h, &peer_get_stat, &peer_stat);
+	ret = rio_pc_get_status(lc->peer_dev_h, &peer_get_stat, &peer_stat);
 	if (RIO_SUCCESS != ret) {
 		DBG("Could not get PEER status, ret = 0x%x 0x%x!\n",
 			ret, peer_stat.imp_rc);
@@ -1558,6 +1633,49 @@ int RIOCP_WU mpsw_verify_pe(struct riocp_pe *pe, pe_port_t port)
 		rc = 0x33;
 		goto fail;
 	}
+	rc = 0;
+fail:
+	return rc;
+}
+
+int RIOCP_WU mpsw_check_link(struct riocp_pe *pe, pe_port_t port)
+{
+	struct mpsw_link_chk lc;
+
+	return check_link(pe, port, &lc);
+}
+
+// Note that verify_pe performs a RapidIO compliance test.  This functionality
+// is not generally required for most systems.
+
+int RIOCP_WU mpsw_verify_pe(struct riocp_pe *pe, pe_port_t port)
+{
+	int rc = -1;
+	uint32_t ret;
+	struct mpsw_link_chk lc;
+	riocp_pe_handle peer;
+	pe_port_t peer_port;
+	DAR_DEV_INFO_t *pe_dev_h;
+	DAR_DEV_INFO_t *peer_dev_h;
+	rio_pc_get_config_out_t peer_cfg;
+	rio_pc_get_config_out_t peer_saved_cfg;
+	rio_pc_set_config_in_t peer_set_cfg;
+	rio_pc_set_config_out_t peer_set_cfg_o;
+	rio_pc_get_status_in_t pe_get_stat;
+	rio_pc_get_status_out_t pe_stat;
+
+	rc = check_link(pe, port, &lc);
+	if (rc) {
+		goto fail;
+	}
+	peer = lc.peer;
+	peer_port = lc.peer_port;
+	pe_dev_h = lc.pe_dev_h;
+	peer_dev_h = lc.peer_dev_h;
+	peer_cfg = lc.peer_cfg;
+
+	pe_get_stat.ptl.num_ports = 1;
+	pe_get_stat.ptl.pnums[0] = port;
 
 	// Try downgrading to a 1x port, then upgrading again.
 	peer_saved_cfg = peer_cfg;
@@ -1608,10 +1726,144 @@ restore:
 			ret, peer_set_cfg_o.imp_rc);
 		rc = 0x50;
 	}
+	mpsw_ps_cache_invalidate(pe, port);
+	mpsw_ps_cache_invalidate(peer, peer_port);
 fail:
 	return rc;
 }
 
+static uint32_t mpsw_pe_idx(struct riocp_pe **pes, size_t count,
+		struct riocp_pe *pe)
+{
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		if (pes[i] == pe) {
+			return (uint32_t)i;
+		}
+	}
+	return RIO_ROUTE_NO_NODE;
+}
+
+int RIOCP_WU mpsw_drv_compute_routes(struct riocp_pe *mport)
+{
+	struct riocp_pe **pes = NULL;
+	size_t count = 0, i;
+	rio_route_node_t *nodes = NULL;
+	rio_route_compute_in_t rc_in;
+	rio_route_compute_out_t rc_out;
+	rio_rt_txn_in_t txn_in;
+	rio_rt_txn_out_t txn_out;
+	struct mpsw_drv_private_data *priv;
+	uint32_t n, ret;
+	uint8_t port;
+	int rc = 1;
+
+	if (riocp_mport_get_pe_list(mport, &count, &pes)) {
+		ERR("Could not get PE list\n");
+		return 1;
+	}
+
+	nodes = (rio_route_node_t *)calloc(count, sizeof(rio_route_node_t));
+	if (NULL == nodes) {
+		goto exit;
+	}
+
+	for (i = 0; i < count; i++) {
+		struct riocp_pe *pe = pes[i];
+		bool is_sw = RIOCP_PE_IS_SWITCH(pe->cap);
+		uint8_t port_cnt = RIOCP_PE_PORT_COUNT(pe->cap);
+
+		if (port_cnt > RIO_MAX_PORTS) {
+			port_cnt = RIO_MAX_PORTS;
+		}
+		rio_route_node_init(&nodes[i], is_sw, port_cnt);
+		nodes[i].priv = pe;
+		if (!is_sw) {
+			nodes[i].destID = pe->did_reg_val;
+			continue;
+		}
+
+		if (riocp_pe_handle_get_private(pe, (void **)&priv)
+				|| !priv->dev_h_valid) {
+			ERR("No device handle for %s\n", pe->sysfs_name);
+			goto exit;
+		}
+		nodes[i].rt = &priv->st.g_rt;
+		nodes[i].dev_info = &priv->dev_h;
+	}
+
+	// Links are recorded by both PEs, only the link from the PE with the
+	// lower index is used.
+	for (i = 0; i < count; i++) {
+		for (port = 0; port < nodes[i].port_cnt; port++) {
+			struct riocp_pe_peer *peer = &pes[i]->peers[port];
+
+			if (NULL == peer->peer) {
+				continue;
+			}
+			n = mpsw_pe_idx(pes, count, peer->peer);
+			if ((RIO_ROUTE_NO_NODE == n) || (n < i)) {
+				continue;
+			}
+			if (rio_route_connect(nodes, count, i, port, n,
+					peer->remote_port)) {
+				ERR("Bad link %s port %d to %s port %d\n",
+						pes[i]->sysfs_name, port,
+						pes[n]->sysfs_name,
+						peer->remote_port);
+				goto exit;
+			}
+		}
+	}
+
+	memset(&rc_in, 0, sizeof(rc_in));
+	rc_in.tt = (dev08_sz == riocp_get_did_sz()) ? tt_dev8 : tt_dev16;
+	rc_in.node_cnt = count;
+	rc_in.nodes = nodes;
+	rc_in.clear_unused = false;
+
+	ret = rio_route_compute(&rc_in, &rc_out);
+	if (RIO_SUCCESS != ret) {
+		ERR("Route computation failed rc 0x%x imp_rc 0x%x\n", ret,
+				rc_out.imp_rc);
+		goto exit;
+	}
+	if (rc_out.unreachable || rc_out.conflicts) {
+		WARN("Routes: %u unreachable, %u conflicts\n",
+				rc_out.unreachable, rc_out.conflicts);
+	}
+	INFO("Routed %u destIDs on %u switches, %u entries changed\n",
+			rc_out.dest_cnt, rc_out.sw_cnt, rc_out.rte_chg);
+
+	// Switches are written in an order which avoids transient loops
+	// and black holes while routes change.  All maintenance transactions
+	// leave through one mport, so writing from more threads gains little.
+	memset(&txn_in, 0, sizeof(txn_in));
+	txn_in.tt = rc_in.tt;
+	txn_in.node_cnt = count;
+	txn_in.nodes = nodes;
+	txn_in.thread_cnt = 1;
+
+	ret = rio_rt_txn_commit(&txn_in, &txn_out);
+	if (RIO_SUCCESS != ret) {
+		ERR("RT_TXN %s ret 0x%x imp_rc 0x%x\n",
+				(RIO_ROUTE_NO_NODE == txn_out.fail_node) ?
+				"-" : pes[txn_out.fail_node]->sysfs_name,
+				ret, txn_out.imp_rc);
+		goto exit;
+	}
+	INFO("Wrote %u entries and %u masks in %u phases\n",
+			txn_out.rte_cnt, txn_out.mc_cnt, txn_out.phase_cnt);
+	rc = 0;
+exit:
+	free(nodes);
+	if (riocp_mport_free_pe_list(&pes)) {
+		ERR("Could not free PE list\n");
+	}
+	return rc;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,287 @@
+/* Deferred device initialization workers for the riocp_pe driver.        */
+/*
+****************************************************************************
+Copyright (c) 2017, Integrated Device Technology Inc.
+Copyright (c) 2017, RapidIO Trade Association
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+may be used to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************
+*/
+
+/* Initialization workers perform generic_device_init_deferred() for the
+ * devices queued by mpsw_drv_init_pe(), while enumeration continues with
+ * the next device.  Driver routines which must not overlap the deferred
+ * initialization call mpsw_init_sync(), which takes a queued device back
+ * from the workers, or waits for a running one.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "rio_misc.h"
+#include "liblog.h"
+#include "riocp_pe_internal.h"
+#include "pe_mpdrv_private.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static pthread_mutex_t init_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t init_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t init_done = PTHREAD_COND_INITIALIZER;
+
+// Queued devices, in the order they were found
+static struct mpsw_drv_private_data *init_head;
+static struct mpsw_drv_private_data *init_tail;
+
+// Devices queued or running, and failures since the last mpsw_init_wait
+static uint32_t init_busy;
+static uint32_t init_errs;
+
+static pthread_t init_thr[MPSW_INIT_MAX_WORKERS];
+static uint32_t init_num_thr;
+static bool init_stop;
+
+// Removes priv from the queue, with init_mtx held.
+static void init_unlink(struct mpsw_drv_private_data *priv)
+{
+	struct mpsw_drv_private_data **pp = &init_head;
+	struct mpsw_drv_private_data *prev = NULL;
+
+	while ((NULL != *pp) && (priv != *pp)) {
+		prev = *pp;
+		pp = &(*pp)->init_next;
+	}
+	if (NULL == *pp) {
+		return;
+	}
+	*pp = priv->init_next;
+	if (init_tail == priv) {
+		init_tail = prev;
+	}
+	priv->init_next = NULL;
+}
+
+// Performs the deferred initialization of a device in the running state.
+static void init_run(struct mpsw_drv_private_data *priv)
+{
+	struct riocp_pe *pe = (struct riocp_pe *)priv->dev_h.privateData;
+	int rc;
+
+	rc = generic_device_init_deferred(pe);
+	if (rc) {
+		ERR("Deferred init of ct 0x%08x failed: %d (0x%x)\n",
+				pe->comptag, rc, rc);
+	}
+
+	pthread_mutex_lock(&init_mtx);
+	priv->init_rc = rc;
+	priv->init_st = mpsw_init_done;
+	if (rc) {
+		init_errs++;
+	}
+	init_busy--;
+	pthread_cond_broadcast(&init_done);
+	pthread_mutex_unlock(&init_mtx);
+}
+
+static void *init_worker(void *UNUSED_PARM(unused))
+{
+	struct mpsw_drv_private_data *priv;
+
+	pthread_mutex_lock(&init_mtx);
+	while (true) {
+		while ((NULL == init_head) && !init_stop) {
+			pthread_cond_wait(&init_work, &init_mtx);
+		}
+		if (NULL == init_head) {
+			break;
+		}
+		priv = init_head;
+		init_unlink(priv);
+		priv->init_st = mpsw_init_running;
+		pthread_mutex_unlock(&init_mtx);
+
+		init_run(priv);
+
+		pthread_mutex_lock(&init_mtx);
+	}
+	pthread_mutex_unlock(&init_mtx);
+	return NULL;
+}
+
+int mpsw_init_defer(struct riocp_pe *pe)
+{
+	struct mpsw_drv_private_data *priv;
+
+	priv = (struct mpsw_drv_private_data *)pe->private_data;
+	if (NULL == priv) {
+		return -EINVAL;
+	}
+
+	pthread_mutex_lock(&init_mtx);
+	if (!init_num_thr) {
+		pthread_mutex_unlock(&init_mtx);
+		return generic_device_init_deferred(pe);
+	}
+
+	priv->init_st = mpsw_init_queued;
+	priv->init_rc = 0;
+	priv->init_next = NULL;
+	if (NULL == init_tail) {
+		init_head = priv;
+	} else {
+		init_tail->init_next = priv;
+	}
+	init_tail = priv;
+	init_busy++;
+	pthread_cond_signal(&init_work);
+	pthread_mutex_unlock(&init_mtx);
+	return 0;
+}
+
+void mpsw_init_sync(struct riocp_pe *pe)
+{
+	struct mpsw_drv_private_data *priv;
+
+	priv = (struct mpsw_drv_private_data *)pe->private_data;
+	if (NULL == priv) {
+		return;
+	}
+
+	pthread_mutex_lock(&init_mtx);
+	if (mpsw_init_queued == priv->init_st) {
+		init_unlink(priv);
+		priv->init_st = mpsw_init_running;
+		pthread_mutex_unlock(&init_mtx);
+		init_run(priv);
+		return;
+	}
+	while (mpsw_init_running == priv->init_st) {
+		pthread_cond_wait(&init_done, &init_mtx);
+	}
+	pthread_mutex_unlock(&init_mtx);
+}
+
+void mpsw_init_cancel(struct riocp_pe *pe)
+{
+	struct mpsw_drv_private_data *priv;
+
+	priv = (struct mpsw_drv_private_data *)pe->private_data;
+	if (NULL == priv) {
+		return;
+	}
+
+	pthread_mutex_lock(&init_mtx);
+	if (mpsw_init_queued == priv->init_st) {
+		init_unlink(priv);
+		priv->init_st = mpsw_init_done;
+		init_busy--;
+		pthread_cond_broadcast(&init_done);
+	}
+	while (mpsw_init_running == priv->init_st) {
+		pthread_cond_wait(&init_done, &init_mtx);
+	}
+	pthread_mutex_unlock(&init_mtx);
+}
+
+int mpsw_init_workers_start(uint32_t workers)
+{
+	int rc = 0;
+
+	if (workers > MPSW_INIT_MAX_WORKERS) {
+		return -EINVAL;
+	}
+
+	pthread_mutex_lock(&init_mtx);
+	if (init_num_thr) {
+		pthread_mutex_unlock(&init_mtx);
+		return -EBUSY;
+	}
+	init_stop = false;
+	while (init_num_thr < workers) {
+		rc = pthread_create(&init_thr[init_num_thr], NULL,
+				init_worker, NULL);
+		if (rc) {
+			ERR("Cannot start init worker %u: %d\n", init_num_thr,
+					rc);
+			break;
+		}
+		init_num_thr++;
+	}
+	pthread_mutex_unlock(&init_mtx);
+
+	if (rc) {
+		mpsw_init_workers_stop();
+		return -rc;
+	}
+	INFO("Started %u init workers\n", workers);
+	return 0;
+}
+
+uint32_t mpsw_init_wait(void)
+{
+	uint32_t errs;
+
+	pthread_mutex_lock(&init_mtx);
+	while (init_busy) {
+		pthread_cond_wait(&init_done, &init_mtx);
+	}
+	errs = init_errs;
+	init_errs = 0;
+	pthread_mutex_unlock(&init_mtx);
+	return errs;
+}
+
+void mpsw_init_workers_stop(void)
+{
+	uint32_t i, num_thr;
+
+	mpsw_init_wait();
+
+	pthread_mutex_lock(&init_mtx);
+	init_stop = true;
+	num_thr = init_num_thr;
+	pthread_cond_broadcast(&init_work);
+	pthread_mutex_unlock(&init_mtx);
+
+	for (i = 0; i < num_thr; i++) {
+		pthread_join(init_thr[i], NULL);
+	}
+
+	pthread_mutex_lock(&init_mtx);
+	init_num_thr = 0;
+	init_stop = false;
+	pthread_mutex_unlock(&init_mtx);
+}
+
+#ifdef __cplusplus
+}
+#endif
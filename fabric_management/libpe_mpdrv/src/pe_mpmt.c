@@ -0,0 +1,270 @@
+/* Port status cache and background refresh for the riocp_pe driver.     */
+/*
+****************************************************************************
+Copyright (c) 2017, Integrated Device Technology Inc.
+Copyright (c) 2017, RapidIO Trade Association
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+may be used to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************
+*/
+
+/* Maintenance transactions are counted by the routines which perform them,
+ * see sw_api_rw_drv.c and mpsw_drv_raw_reg_rd/wr.  Each device gets an
+ * entry in the statistics block the first time it is accessed while
+ * counting is on, and keeps it until the block is replaced.
+ *
+ * A transaction which repeats the last failed transaction of the same
+ * thread, to the same register of the same device, is counted as a retry.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "string_util.h"
+#include "rio_route.h"
+#include "riocp_pe_internal.h"
+#include "pe_mpdrv_private.h"
+#include "fmd_mt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NSEC_PER_SEC 1000000000ULL
+
+struct mpsw_mt_last {
+	bool valid;
+	enum fmd_mt_dir dir;
+	did_val_t did_val;
+	hc_t hc;
+	uint32_t offset;
+};
+
+static struct fmd_mt mpsw_mt_dflt;
+static struct fmd_mt *mpsw_mt = &mpsw_mt_dflt;
+static pthread_mutex_t mpsw_mt_mtx = PTHREAD_MUTEX_INITIALIZER;
+static __thread struct mpsw_mt_last mpsw_mt_last;
+
+static uint64_t mpsw_mt_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * NSEC_PER_SEC) + ts.tv_nsec;
+}
+
+static struct fmd_mt *mpsw_mt_cur(void)
+{
+	return __atomic_load_n(&mpsw_mt, __ATOMIC_ACQUIRE);
+}
+
+void mpsw_mt_set(struct fmd_mt *mt)
+{
+	struct fmd_mt *old;
+
+	if (NULL == mt) {
+		mt = &mpsw_mt_dflt;
+	}
+
+	pthread_mutex_lock(&mpsw_mt_mtx);
+	old = mpsw_mt;
+	if (mt != old) {
+		mt->start_ns = mpsw_mt_now();
+		mt->run_ns = 0;
+		mt->on = old->on;
+		__atomic_store_n(&mpsw_mt, mt, __ATOMIC_RELEASE);
+	}
+	pthread_mutex_unlock(&mpsw_mt_mtx);
+}
+
+struct fmd_mt *mpsw_mt_get(void)
+{
+	return mpsw_mt_cur();
+}
+
+void mpsw_mt_enable(bool on)
+{
+	struct fmd_mt *mt;
+
+	pthread_mutex_lock(&mpsw_mt_mtx);
+	mt = mpsw_mt;
+	if (on && !mt->on) {
+		mt->start_ns = mpsw_mt_now();
+	} else if (!on && mt->on) {
+		mt->run_ns += mpsw_mt_now() - mt->start_ns;
+	}
+	__atomic_store_n(&mt->on, on ? 1 : 0, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&mpsw_mt_mtx);
+}
+
+bool mpsw_mt_enabled(void)
+{
+	return __atomic_load_n(&mpsw_mt_cur()->on, __ATOMIC_RELAXED);
+}
+
+void mpsw_mt_clear(void)
+{
+	struct fmd_mt *mt;
+	uint32_t i;
+
+	pthread_mutex_lock(&mpsw_mt_mtx);
+	mt = mpsw_mt;
+	memset(mt->hc, 0, sizeof(mt->hc));
+	for (i = 0; i < FMD_MAX_DEVS; i++) {
+		memset(mt->devs[i].ctr, 0, sizeof(mt->devs[i].ctr));
+	}
+	mt->start_ns = mpsw_mt_now();
+	mt->run_ns = 0;
+	pthread_mutex_unlock(&mpsw_mt_mtx);
+}
+
+uint64_t mpsw_mt_begin(void)
+{
+	if (!__atomic_load_n(&mpsw_mt_cur()->on, __ATOMIC_RELAXED)) {
+		return 0;
+	}
+	return mpsw_mt_now();
+}
+
+static uint32_t mpsw_mt_bkt(uint64_t ns)
+{
+	uint64_t us = ns / 1000;
+	uint32_t bkt;
+
+	if (!us) {
+		return 0;
+	}
+	bkt = 64 - __builtin_clzll(us);
+	return (bkt < FMD_MT_HIST_BKTS) ? bkt : FMD_MT_HIST_BKTS - 1;
+}
+
+static void mpsw_mt_count(struct fmd_mt_ctr *ctr, uint32_t regs, int rc,
+		bool retry, uint64_t ns)
+{
+	uint64_t max;
+
+	__atomic_fetch_add(&ctr->cnt, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&ctr->regs, regs, __ATOMIC_RELAXED);
+	if (rc) {
+		__atomic_fetch_add(&ctr->fails, 1, __ATOMIC_RELAXED);
+	}
+	if (retry) {
+		__atomic_fetch_add(&ctr->retries, 1, __ATOMIC_RELAXED);
+	}
+	__atomic_fetch_add(&ctr->lat_ns, ns, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&ctr->hist[mpsw_mt_bkt(ns)], 1, __ATOMIC_RELAXED);
+
+	max = __atomic_load_n(&ctr->max_ns, __ATOMIC_RELAXED);
+	while ((ns > max) && !__atomic_compare_exchange_n(&ctr->max_ns, &max,
+			ns, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+	}
+}
+
+// Returns the entry of pe in mt, adding one if there is room.
+static struct fmd_mt_dev *mpsw_mt_dev(struct fmd_mt *mt, struct riocp_pe *pe)
+{
+	struct mpsw_drv_private_data *priv;
+	struct fmd_mt_dev *dev;
+
+	if ((NULL == pe) || (NULL == pe->private_data)) {
+		return NULL;
+	}
+	priv = (struct mpsw_drv_private_data *)pe->private_data;
+
+	if (__atomic_load_n(&priv->mt, __ATOMIC_ACQUIRE) != mt) {
+		pthread_mutex_lock(&mpsw_mt_mtx);
+		if (priv->mt != mt) {
+			dev = NULL;
+			if (mt->num_devs < FMD_MAX_DEVS) {
+				dev = &mt->devs[mt->num_devs];
+				__atomic_store_n(&mt->num_devs,
+						mt->num_devs + 1,
+						__ATOMIC_RELEASE);
+			}
+			priv->mt_dev = dev;
+			__atomic_store_n(&priv->mt, mt, __ATOMIC_RELEASE);
+		}
+		pthread_mutex_unlock(&mpsw_mt_mtx);
+	}
+
+	dev = priv->mt_dev;
+	if ((NULL != dev) && ((dev->ct != pe->comptag)
+			|| strncmp(dev->name, pe->sysfs_name, FMD_MAX_NAME))) {
+		dev->ct = pe->comptag;
+		SAFE_STRNCPY(dev->name, pe->sysfs_name, sizeof(dev->name));
+	}
+	if (NULL != dev) {
+		dev->hc = pe->hopcount;
+	}
+	return dev;
+}
+
+void mpsw_mt_end(uint64_t start, struct riocp_pe *pe, did_val_t did_val,
+		hc_t hc, uint32_t offset, uint32_t regs, enum fmd_mt_dir dir,
+		int rc)
+{
+	struct mpsw_mt_last *last = &mpsw_mt_last;
+	struct fmd_mt *mt;
+	struct fmd_mt_dev *dev;
+	uint64_t ns;
+	uint32_t idx;
+	bool retry;
+
+	if (!start) {
+		return;
+	}
+	ns = mpsw_mt_now() - start;
+	mt = mpsw_mt_cur();
+
+	retry = last->valid && (last->dir == dir) && (last->hc == hc)
+			&& (last->did_val == did_val)
+			&& (last->offset == offset);
+	last->valid = (0 != rc);
+	last->dir = dir;
+	last->did_val = did_val;
+	last->hc = hc;
+	last->offset = offset;
+
+	if (HC_MP == hc) {
+		idx = FMD_MT_LCL;
+	} else {
+		idx = (hc < FMD_MT_MAX_HC) ? hc : FMD_MT_MAX_HC - 1;
+	}
+	mpsw_mt_count(&mt->hc[idx][dir], regs, rc, retry, ns);
+
+	dev = mpsw_mt_dev(mt, pe);
+	if (NULL != dev) {
+		mpsw_mt_count(&dev->ctr[dir], regs, rc, retry, ns);
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,495 @@
+/* Port status cache and background refresh for the riocp_pe driver.     */
+/*
+****************************************************************************
+Copyright (c) 2017, Integrated Device Technology Inc.
+Copyright (c) 2017, RapidIO Trade Association
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+may be used to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************
+*/
+
+/* The port status of a device is kept in st.ps, indexed by port number.
+ * A stale bit per port records that the status must be read again before
+ * it is used.  All ports start stale, and are marked stale by port-writes
+ * and by driver routines which change the port.
+ *
+ * The refresh thread waits for port-writes on its own mport handle, and
+ * reads the ports of every device behind the mport whose status is older
+ * than the refresh period, so readers rarely wait for the device.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+
+#include "rio_misc.h"
+#include "liblog.h"
+#include "rapidio_mport_sim.h"
+#include "riocp_pe_internal.h"
+#include "pe_mpdrv_private.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PS_ALL_STALE ((uint32_t)0xFFFFFFFF)
+
+static pthread_t ps_thr;
+static bool ps_alive;
+static int ps_stop_fd[2] = {-1, -1};
+static riomp_mport_t ps_mp_h;
+static struct riocp_pe *ps_mport;
+static uint32_t ps_period_ms;
+
+static uint64_t ps_now_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+void mpsw_ps_cache_init(struct mpsw_drv_private_data *priv)
+{
+	pthread_mutex_init(&priv->ps_c.mtx, NULL);
+	priv->ps_c.stale = PS_ALL_STALE;
+	memset(priv->ps_c.ts_ns, 0, sizeof(priv->ps_c.ts_ns));
+	memset(&priv->ps_c.stats, 0, sizeof(priv->ps_c.stats));
+}
+
+void mpsw_ps_cache_destroy(struct mpsw_drv_private_data *priv)
+{
+	pthread_mutex_destroy(&priv->ps_c.mtx);
+}
+
+void mpsw_ps_cache_loaded(struct mpsw_drv_private_data *priv)
+{
+	uint64_t now = ps_now_ns();
+	uint32_t p;
+
+	pthread_mutex_lock(&priv->ps_c.mtx);
+	for (p = 0; p < RIO_MAX_PORTS; p++) {
+		priv->ps_c.ts_ns[p] = now;
+	}
+	priv->ps_c.stale = 0;
+	pthread_mutex_unlock(&priv->ps_c.mtx);
+}
+
+// Reads the status of the ports in mask into st.ps, with the cache mutex
+// held.  Returns the number of ports read, or -1 on failure.
+static int ps_read(struct mpsw_drv_private_data *priv, uint32_t mask)
+{
+	rio_pc_get_status_in_t ps_in;
+	rio_pc_get_status_out_t ps_out;
+	uint32_t num_ports = NUM_PORTS(&priv->dev_h);
+	uint64_t now;
+	uint32_t p, i;
+
+	if (num_ports > RIO_MAX_PORTS) {
+		num_ports = RIO_MAX_PORTS;
+	}
+
+	ps_in.ptl.num_ports = 0;
+	for (p = 0; p < num_ports; p++) {
+		if (mask & ((uint32_t)1 << p)) {
+			ps_in.ptl.pnums[ps_in.ptl.num_ports++] = p;
+		}
+	}
+	if (!ps_in.ptl.num_ports) {
+		return 0;
+	}
+
+	if (RIO_SUCCESS != rio_pc_get_status(&priv->dev_h, &ps_in, &ps_out)) {
+		priv->st.ps.imp_rc = ps_out.imp_rc;
+		return -1;
+	}
+
+	now = ps_now_ns();
+	for (i = 0; i < ps_out.num_ports; i++) {
+		p = ps_out.ps[i].pnum;
+		if (p >= num_ports) {
+			continue;
+		}
+		priv->st.ps.ps[p] = ps_out.ps[i];
+		priv->ps_c.ts_ns[p] = now;
+		priv->ps_c.stale &= ~((uint32_t)1 << p);
+	}
+	priv->st.ps.num_ports = num_ports;
+	priv->st.ps.imp_rc = ps_out.imp_rc;
+	return ps_out.num_ports;
+}
+
+static struct mpsw_drv_private_data *ps_priv(struct riocp_pe *pe)
+{
+	struct mpsw_drv_private_data *priv;
+
+	if ((NULL == pe) || (NULL == pe->private_data)) {
+		return NULL;
+	}
+	priv = (struct mpsw_drv_private_data *)pe->private_data;
+	if (!priv->dev_h_valid) {
+		return NULL;
+	}
+	return priv;
+}
+
+// Returns the stale bits of port, or of all ports for RIO_ALL_PORTS.
+static uint32_t ps_mask(struct mpsw_drv_private_data *priv, pe_port_t port)
+{
+	uint32_t num_ports = NUM_PORTS(&priv->dev_h);
+
+	if (num_ports > RIO_MAX_PORTS) {
+		num_ports = RIO_MAX_PORTS;
+	}
+	if (RIO_ALL_PORTS == port) {
+		return (num_ports >= 32) ? PS_ALL_STALE
+					: (((uint32_t)1 << num_ports) - 1);
+	}
+	if (port >= num_ports) {
+		return 0;
+	}
+	return (uint32_t)1 << port;
+}
+
+int mpsw_ps_cache_get(struct riocp_pe *pe, pe_port_t port,
+		rio_pc_get_status_out_t *ps)
+{
+	struct mpsw_drv_private_data *priv = ps_priv(pe);
+	uint32_t mask;
+	int rc = 0;
+
+	if ((NULL == priv) || (NULL == ps)) {
+		return -EINVAL;
+	}
+	mask = ps_mask(priv, port);
+	if (!mask) {
+		return -EINVAL;
+	}
+
+	pthread_mutex_lock(&priv->ps_c.mtx);
+	if (priv->ps_c.stale & mask) {
+		priv->ps_c.stats.misses++;
+		if (ps_read(priv, priv->ps_c.stale & mask) < 0) {
+			rc = -EIO;
+		}
+	} else {
+		priv->ps_c.stats.hits++;
+	}
+	if (!rc) {
+		ps->imp_rc = priv->st.ps.imp_rc;
+		if (RIO_ALL_PORTS == port) {
+			ps->num_ports = priv->st.ps.num_ports;
+			memcpy(ps->ps, priv->st.ps.ps,
+				ps->num_ports * sizeof(ps->ps[0]));
+		} else {
+			ps->num_ports = 1;
+			ps->ps[0] = priv->st.ps.ps[port];
+		}
+	}
+	pthread_mutex_unlock(&priv->ps_c.mtx);
+	return rc;
+}
+
+void mpsw_ps_cache_invalidate(struct riocp_pe *pe, pe_port_t port)
+{
+	struct mpsw_drv_private_data *priv = ps_priv(pe);
+	uint32_t mask, p;
+
+	if (NULL == priv) {
+		return;
+	}
+	mask = ps_mask(priv, port);
+
+	pthread_mutex_lock(&priv->ps_c.mtx);
+	for (p = 0; p < RIO_MAX_PORTS; p++) {
+		if ((mask & ~priv->ps_c.stale) & ((uint32_t)1 << p)) {
+			priv->ps_c.stats.invalidations++;
+		}
+	}
+	priv->ps_c.stale |= mask;
+	pthread_mutex_unlock(&priv->ps_c.mtx);
+}
+
+int mpsw_ps_cache_refresh(struct riocp_pe *pe, uint32_t max_age_ms)
+{
+	struct mpsw_drv_private_data *priv = ps_priv(pe);
+	uint64_t oldest;
+	uint32_t mask, p;
+	int rc;
+
+	if (NULL == priv) {
+		return -1;
+	}
+
+	pthread_mutex_lock(&priv->ps_c.mtx);
+	oldest = ps_now_ns() - ((uint64_t)max_age_ms * 1000000);
+	mask = priv->ps_c.stale;
+	for (p = 0; p < RIO_MAX_PORTS; p++) {
+		if (priv->ps_c.ts_ns[p] <= oldest) {
+			mask |= (uint32_t)1 << p;
+		}
+	}
+	rc = ps_read(priv, mask & ps_mask(priv, RIO_ALL_PORTS));
+	if (rc > 0) {
+		priv->ps_c.stats.refreshes += rc;
+	}
+	pthread_mutex_unlock(&priv->ps_c.mtx);
+	return rc;
+}
+
+int mpsw_ps_cache_get_stats(struct riocp_pe *pe,
+		struct mpsw_ps_cache_stats *stats)
+{
+	struct mpsw_drv_private_data *priv = ps_priv(pe);
+	uint32_t num_ports, p;
+	uint64_t now, oldest;
+
+	if ((NULL == priv) || (NULL == stats)) {
+		return -EINVAL;
+	}
+	num_ports = NUM_PORTS(&priv->dev_h);
+	if (num_ports > RIO_MAX_PORTS) {
+		num_ports = RIO_MAX_PORTS;
+	}
+
+	pthread_mutex_lock(&priv->ps_c.mtx);
+	*stats = priv->ps_c.stats;
+	now = ps_now_ns();
+	oldest = now;
+	stats->stale_ports = 0;
+	for (p = 0; p < num_ports; p++) {
+		if (priv->ps_c.stale & ((uint32_t)1 << p)) {
+			stats->stale_ports++;
+		} else if (priv->ps_c.ts_ns[p] < oldest) {
+			oldest = priv->ps_c.ts_ns[p];
+		}
+	}
+	stats->age_ns = now - oldest;
+	pthread_mutex_unlock(&priv->ps_c.mtx);
+	return 0;
+}
+
+int mpsw_drv_port_write(struct riocp_pe *pe, uint32_t *pw)
+{
+	struct mpsw_drv_private_data *priv = ps_priv(pe);
+	rio_em_event_n_loc_t events[rio_em_last];
+	rio_em_parse_pw_in_t in_parms;
+	rio_em_parse_pw_out_t out_parms;
+	uint32_t i;
+
+	if ((NULL == priv) || (NULL == pw)) {
+		return -EINVAL;
+	}
+
+	memcpy(in_parms.pw, pw, sizeof(in_parms.pw));
+	in_parms.num_events = rio_em_last;
+	in_parms.events = events;
+	if (RIO_SUCCESS != rio_em_parse_pw(&priv->dev_h, &in_parms,
+							&out_parms)) {
+		// The events are unknown, any port may have changed.
+		mpsw_ps_cache_invalidate(pe, RIO_ALL_PORTS);
+		return -EIO;
+	}
+
+	pthread_mutex_lock(&priv->ps_c.mtx);
+	priv->ps_c.stats.pw_events += out_parms.num_events;
+	pthread_mutex_unlock(&priv->ps_c.mtx);
+
+	if (out_parms.too_many) {
+		mpsw_ps_cache_invalidate(pe, RIO_ALL_PORTS);
+		return 0;
+	}
+
+	// Packet drops do not change port status.
+	for (i = 0; i < out_parms.num_events; i++) {
+		switch (events[i].event) {
+		case rio_em_d_ttl:
+		case rio_em_d_rte:
+		case rio_em_d_log:
+		case rio_em_a_clr_pwpnd:
+		case rio_em_a_no_event:
+			break;
+		default:
+			mpsw_ps_cache_invalidate(pe, events[i].port_num);
+		}
+	}
+	return 0;
+}
+
+// Refreshes the devices behind the mport, oldest ports first.
+static void ps_refresh_all(void)
+{
+	riocp_pe_handle *pes = NULL;
+	size_t pes_count = 0, i;
+
+	if (riocp_mport_get_pe_list(ps_mport, &pes_count, &pes)) {
+		return;
+	}
+	for (i = 0; i < pes_count; i++) {
+		if (mpsw_ps_cache_refresh(pes[i], ps_period_ms) < 0) {
+			DBG("Port status refresh of %s failed\n",
+							pes[i]->sysfs_name);
+		}
+	}
+	if (riocp_mport_free_pe_list(&pes)) {
+		DBG("Could not free PE list\n");
+	}
+}
+
+// Delivers a port-write to the device whose component tag it carries.
+static void ps_port_write(void)
+{
+	struct riomp_mgmt_event evt;
+	riocp_pe_handle pe;
+
+	if (riomp_mgmt_get_event(ps_mp_h, &evt)
+				|| !(evt.header & RIO_EVENT_PORTWRITE)) {
+		return;
+	}
+	if (riocp_pe_find_comptag(ps_mport, evt.u.portwrite.payload[0], &pe)) {
+		DBG("Port-write from unknown ct 0x%08x\n",
+					evt.u.portwrite.payload[0]);
+		return;
+	}
+	if (mpsw_drv_port_write(pe, evt.u.portwrite.payload)) {
+		DBG("Port-write from %s not decoded\n", pe->sysfs_name);
+	}
+}
+
+static void *ps_refresh_loop(void *UNUSED_PARM(unused))
+{
+	struct pollfd pfd[2];
+	uint64_t next_ns, now;
+	int rc;
+
+	pfd[0].fd = ps_stop_fd[0];
+	pfd[0].events = POLLIN;
+	pfd[1].fd = (NULL == ps_mp_h) ? -1 : ps_mp_h->fd;
+	pfd[1].events = POLLIN;
+
+	next_ns = ps_now_ns() + ((uint64_t)ps_period_ms * 1000000);
+	while (true) {
+		now = ps_now_ns();
+		if (now >= next_ns) {
+			ps_refresh_all();
+			next_ns = ps_now_ns()
+				+ ((uint64_t)ps_period_ms * 1000000);
+			continue;
+		}
+
+		pfd[0].revents = pfd[1].revents = 0;
+		rc = poll(pfd, 2, (int)((next_ns - now) / 1000000) + 1);
+		if ((rc < 0) && (EINTR != errno)) {
+			break;
+		}
+		if (pfd[0].revents) {
+			break;
+		}
+		if (pfd[1].revents & POLLIN) {
+			ps_port_write();
+		}
+	}
+	return NULL;
+}
+
+int mpsw_ps_refresh_start(struct riocp_pe *mport, uint32_t period_ms)
+{
+	int rc;
+
+	if (ps_alive || !period_ms || (NULL == mport)
+					|| (NULL == mport->minfo)) {
+		return -EINVAL;
+	}
+
+	if (pipe(ps_stop_fd)) {
+		return -errno;
+	}
+
+	// Port-writes are optional, the refresh runs without them.
+	ps_mp_h = NULL;
+	if (riomp_mgmt_mport_create_handle(mport->minfo->id, 0, &ps_mp_h)) {
+		ps_mp_h = NULL;
+	} else if ((RIOMP_MGMT_SIM_FD == ps_mp_h->fd)
+			|| riomp_mgmt_set_event_mask(ps_mp_h, RIO_EVENT_PORTWRITE)
+			|| riomp_mgmt_pwrange_enable(ps_mp_h, 0, 0, 0xFFFFFFFF)) {
+		INFO("Port-writes are not available, refresh only\n");
+		riomp_mgmt_mport_destroy_handle(&ps_mp_h);
+		ps_mp_h = NULL;
+	}
+
+	ps_mport = mport;
+	ps_period_ms = period_ms;
+	rc = pthread_create(&ps_thr, NULL, ps_refresh_loop, NULL);
+	if (rc) {
+		if (NULL != ps_mp_h) {
+			riomp_mgmt_mport_destroy_handle(&ps_mp_h);
+			ps_mp_h = NULL;
+		}
+		close(ps_stop_fd[0]);
+		close(ps_stop_fd[1]);
+		ps_stop_fd[0] = ps_stop_fd[1] = -1;
+		return -rc;
+	}
+	ps_alive = true;
+	return 0;
+}
+
+void mpsw_ps_refresh_stop(void)
+{
+	char stop = 1;
+
+	if (!ps_alive) {
+		return;
+	}
+
+	if (write(ps_stop_fd[1], &stop, 1) != 1) {
+		ERR("Could not stop port status refresh\n");
+		return;
+	}
+	pthread_join(ps_thr, NULL);
+	ps_alive = false;
+
+	if (NULL != ps_mp_h) {
+		if (riomp_mgmt_pwrange_disable(ps_mp_h, 0, 0, 0xFFFFFFFF)) {
+			DBG("Could not disable port-writes\n");
+		}
+		riomp_mgmt_mport_destroy_handle(&ps_mp_h);
+		ps_mp_h = NULL;
+	}
+	close(ps_stop_fd[0]);
+	close(ps_stop_fd[1]);
+	ps_stop_fd[0] = ps_stop_fd[1] = -1;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,194 @@
+/* Emulated fabric access routines for the riocp_pe driver.               */
+/*
+****************************************************************************
+Copyright (c) 2017, Integrated Device Technology Inc.
+Copyright (c) 2017, RapidIO Trade Association
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors
+may be used to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************
+*/
+
+/* The emulated fabric replaces the mport device driver below the mport
+ * management library, so the riocp_pe driver, the switch drivers and the
+ * FMD traversal run unmodified against emulated registers.
+ */
+
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+
+#include "rio_misc.h"
+#include "rio_standard.h"
+#include "rio_ecosystem.h"
+#include "rapidio_mport_mgmt.h"
+#include "rapidio_mport_sim.h"
+#include "pe_mpsim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static int mpsim_query(void *ctx, uint8_t mport_id,
+		struct riomp_mgmt_mport_properties *qresp)
+{
+	rio_fab_t *fab = (rio_fab_t *)ctx;
+	uint32_t devid;
+
+	if (rio_fab_local_read(fab, RIO_DEVID, 1, &devid)) {
+		return -EIO;
+	}
+
+	memset(qresp, 0, sizeof(*qresp));
+	qresp->id = mport_id;
+	qresp->port_ok = 1;
+	qresp->link_speed = RIO_LINK_625;
+	qresp->link_width = RIO_LINK_4X;
+	if (rio_fab_get_dev16(fab)) {
+		qresp->did_val = GET_DEV16_FROM_HW(devid);
+		qresp->sys_size = 1;
+	} else {
+		qresp->did_val = GET_DEV8_FROM_HW(devid);
+	}
+	return 0;
+}
+
+static int mpsim_destid_set(void *ctx, uint8_t UNUSED_PARM(mport_id),
+		did_val_t did_val)
+{
+	rio_fab_set_dev16((rio_fab_t *)ctx,
+			(did_val & RIOMP_MGMT_DEV16_FLAG) ? true : false);
+	return 0;
+}
+
+static int mpsim_lcfg_read(void *ctx, uint8_t UNUSED_PARM(mport_id),
+		uint32_t offset, uint32_t size, uint32_t *data)
+{
+	if (!size || (size % sizeof(uint32_t))) {
+		return -EINVAL;
+	}
+	if (rio_fab_local_read((rio_fab_t *)ctx, offset,
+			size / sizeof(uint32_t), data)) {
+		return -EIO;
+	}
+	return 0;
+}
+
+static int mpsim_lcfg_write(void *ctx, uint8_t UNUSED_PARM(mport_id),
+		uint32_t offset, uint32_t size, uint32_t data)
+{
+	if (sizeof(uint32_t) != size) {
+		return -EINVAL;
+	}
+	if (rio_fab_local_write((rio_fab_t *)ctx, offset, 1, &data)) {
+		return -EIO;
+	}
+	return 0;
+}
+
+static int mpsim_rcfg_read(void *ctx, uint8_t UNUSED_PARM(mport_id),
+		did_val_t did_val, hc_t hc, uint32_t offset, uint32_t size,
+		uint32_t *data)
+{
+	if (!size || (size % sizeof(uint32_t))) {
+		return -EINVAL;
+	}
+	if (rio_fab_maint_read((rio_fab_t *)ctx, did_val, hc, offset,
+			size / sizeof(uint32_t), data, NULL)) {
+		return -EIO;
+	}
+	return 0;
+}
+
+static int mpsim_rcfg_write(void *ctx, uint8_t UNUSED_PARM(mport_id),
+		did_val_t did_val, hc_t hc, uint32_t offset, uint32_t size,
+		uint32_t data)
+{
+	if (sizeof(uint32_t) != size) {
+		return -EINVAL;
+	}
+	if (rio_fab_maint_write((rio_fab_t *)ctx, did_val, hc, offset, 1,
+			&data, NULL)) {
+		return -EIO;
+	}
+	return 0;
+}
+
+static int mpsim_rcfg_write_blk(void *ctx, uint8_t UNUSED_PARM(mport_id),
+		did_val_t did_val, hc_t hc, uint32_t offset, uint32_t size,
+		const uint32_t *data)
+{
+	if (!size || (size % sizeof(uint32_t))) {
+		return -EINVAL;
+	}
+	if (rio_fab_maint_write((rio_fab_t *)ctx, did_val, hc, offset,
+			size / sizeof(uint32_t), (uint32_t *)data, NULL)) {
+		return -EIO;
+	}
+	return 0;
+}
+
+// There are no kernel devices to add or remove for emulated endpoints.
+static int mpsim_device_chg(void *UNUSED_PARM(ctx),
+		uint8_t UNUSED_PARM(mport_id), did_val_t UNUSED_PARM(did_val),
+		hc_t UNUSED_PARM(hc), ct_t UNUSED_PARM(ct),
+		const char *UNUSED_PARM(name))
+{
+	return 0;
+}
+
+static struct riomp_mgmt_sim_ops mpsim_ops;
+
+int mpsw_sim_bind(rio_fab_t *fab)
+{
+	if ((NULL == fab) || (RIO_FAB_NO_DEV == rio_fab_get_mport(fab))) {
+		return -EINVAL;
+	}
+
+	memset(&mpsim_ops, 0, sizeof(mpsim_ops));
+	mpsim_ops.ctx = fab;
+	mpsim_ops.query = mpsim_query;
+	mpsim_ops.destid_set = mpsim_destid_set;
+	mpsim_ops.lcfg_read = mpsim_lcfg_read;
+	mpsim_ops.lcfg_write = mpsim_lcfg_write;
+	mpsim_ops.rcfg_read = mpsim_rcfg_read;
+	mpsim_ops.rcfg_write = mpsim_rcfg_write;
+	mpsim_ops.rcfg_write_blk = mpsim_rcfg_write_blk;
+	mpsim_ops.device_add = mpsim_device_chg;
+	mpsim_ops.device_del = mpsim_device_chg;
+
+	return riomp_mgmt_set_sim_ops(&mpsim_ops);
+}
+
+void mpsw_sim_unbind(void)
+{
+	riomp_mgmt_set_sim_ops(NULL);
+	memset(&mpsim_ops, 0, sizeof(mpsim_ops));
+}
+
+#ifdef __cplusplus
+}
+#endif
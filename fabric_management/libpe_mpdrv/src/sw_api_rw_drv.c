@@ -84,11 +84,13 @@ uint32_t SRIO_API_ReadRegFunc(DAR_DEV_INFO_t *d_info, uint32_t offset,
 	uint32_t x;
 	struct mpsw_drv_pe_acc_info *acc_p;
 	riocp_pe_handle pe_h;
+	uint64_t mt;
 
 	if (get_acc_p(d_info, offset, &pe_h, &acc_p)) {
 		goto exit;
 	}
 
+	mt = mpsw_mt_begin();
 	if (RIOCP_PE_IS_MPORT(pe_h)) {
 		rc = riomp_mgmt_lcfg_read(acc_p->maint, offset, sizeof(x), &x) ?
 						RIO_ERR_ACCESS:RIO_SUCCESS;
@@ -97,6 +99,8 @@ uint32_t SRIO_API_ReadRegFunc(DAR_DEV_INFO_t *d_info, uint32_t offset,
 				pe_h->hopcount, offset, sizeof(x), &x) ?
 				RIO_ERR_ACCESS : RIO_SUCCESS;
 	}
+	mpsw_mt_end(mt, pe_h, pe_h->did_reg_val, MT_HC(pe_h), offset, 1,
+			fmd_mt_rd, rc);
 
 	if (RIO_SUCCESS == rc) {
 		*readdata = x;
@@ -106,17 +110,60 @@ exit:
 	return rc;
 }
 
+/* Reads cnt contiguous registers with a single maintenance request.
+ * The mport driver splits the request into individual maintenance
+ * transactions, avoiding one system call per register.
+ */
+uint32_t SRIO_API_ReadRegBlockFunc(DAR_DEV_INFO_t *d_info, uint32_t offset,
+		uint32_t cnt, uint32_t *readdata)
+{
+	uint32_t rc = RIO_ERR_INVALID_PARAMETER;
+	struct mpsw_drv_pe_acc_info *acc_p;
+	riocp_pe_handle pe_h;
+	uint64_t mt;
+
+	if ((NULL == readdata) || !cnt || (cnt > 0x00400000)) {
+		goto exit;
+	}
+
+	if ((offset + (4 * cnt)) > 0x01000000) {
+		goto exit;
+	}
+
+	if (get_acc_p(d_info, offset, &pe_h, &acc_p)) {
+		goto exit;
+	}
+
+	mt = mpsw_mt_begin();
+	if (RIOCP_PE_IS_MPORT(pe_h)) {
+		rc = riomp_mgmt_lcfg_read(acc_p->maint, offset,
+				cnt * sizeof(uint32_t), readdata) ?
+				RIO_ERR_ACCESS : RIO_SUCCESS;
+	} else {
+		rc = riomp_mgmt_rcfg_read(acc_p->maint, pe_h->did_reg_val,
+				pe_h->hopcount, offset, cnt * sizeof(uint32_t),
+				readdata) ? RIO_ERR_ACCESS : RIO_SUCCESS;
+	}
+	mpsw_mt_end(mt, pe_h, pe_h->did_reg_val, MT_HC(pe_h), offset, cnt,
+			fmd_mt_rd, rc);
+
+exit:
+	return rc;
+}
+
 uint32_t SRIO_API_WriteRegFunc(DAR_DEV_INFO_t *d_info, uint32_t offset,
 		uint32_t writedata)
 {
 	uint32_t rc = RIO_ERR_INVALID_PARAMETER;
 	struct mpsw_drv_pe_acc_info *acc_p;
 	riocp_pe_handle pe_h;
+	uint64_t mt;
 
 	if (get_acc_p(d_info, offset, &pe_h, &acc_p)) {
 		goto exit;
 	}
 
+	mt = mpsw_mt_begin();
 	if (RIOCP_PE_IS_MPORT(pe_h)) {
 		rc = riomp_mgmt_lcfg_write(acc_p->maint, offset,
 				sizeof(writedata), writedata) ?
@@ -126,6 +173,56 @@ uint32_t SRIO_API_WriteRegFunc(DAR_DEV_INFO_t *d_info, uint32_t offset,
 				pe_h->hopcount, offset, sizeof(writedata),
 				writedata) ? RIO_ERR_ACCESS : RIO_SUCCESS;
 	}
+	mpsw_mt_end(mt, pe_h, pe_h->did_reg_val, MT_HC(pe_h), offset, 1,
+			fmd_mt_wr, rc);
+
+exit:
+	return rc;
+}
+
+/* Writes cnt contiguous registers.  Remote devices are written with a
+ * single maintenance request, which the mport driver splits into
+ * individual maintenance transactions.  The mport only accepts 4 byte
+ * local writes, so its registers are written one at a time.
+ */
+uint32_t SRIO_API_WriteRegBlockFunc(DAR_DEV_INFO_t *d_info, uint32_t offset,
+		uint32_t cnt, uint32_t *writedata)
+{
+	uint32_t rc = RIO_ERR_INVALID_PARAMETER;
+	struct mpsw_drv_pe_acc_info *acc_p;
+	riocp_pe_handle pe_h;
+	uint64_t mt;
+	uint32_t i;
+
+	if ((NULL == writedata) || !cnt || (cnt > 0x00400000)) {
+		goto exit;
+	}
+
+	if ((offset + (4 * cnt)) > 0x01000000) {
+		goto exit;
+	}
+
+	if (get_acc_p(d_info, offset, &pe_h, &acc_p)) {
+		goto exit;
+	}
+
+	mt = mpsw_mt_begin();
+	if (RIOCP_PE_IS_MPORT(pe_h)) {
+		rc = RIO_SUCCESS;
+		for (i = 0; (i < cnt) && (RIO_SUCCESS == rc); i++) {
+			rc = riomp_mgmt_lcfg_write(acc_p->maint,
+					offset + (4 * i), sizeof(uint32_t),
+					writedata[i]) ?
+					RIO_ERR_ACCESS : RIO_SUCCESS;
+		}
+	} else {
+		rc = riomp_mgmt_rcfg_write_blk(acc_p->maint,
+				pe_h->did_reg_val, pe_h->hopcount, offset,
+				cnt * sizeof(uint32_t), writedata) ?
+				RIO_ERR_ACCESS : RIO_SUCCESS;
+	}
+	mpsw_mt_end(mt, pe_h, pe_h->did_reg_val, MT_HC(pe_h), offset, cnt,
+			fmd_mt_wr, rc);
 
 exit:
 	return rc;
@@ -66,6 +66,14 @@ uint32_t DARDB_ReadRegNoDriver(DAR_DEV_INFO_t *dev_info, uint32_t offset,
 uint32_t DARDB_WriteRegNoDriver(DAR_DEV_INFO_t *dev_info, uint32_t offset,
 		uint32_t writedata);
 
+/* DARDB_ReadRegBlock
+ * DARRegReadBlock, which also returns the number of registers at the
+ * start of the block which were read successfully in *done.  A failed
+ * block access returns no registers.
+ */
+uint32_t DARDB_ReadRegBlock(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *readdata, uint32_t *done);
+
 /* DARDB_rioGetPortList
  * Default implementation of rioGetPortList, intended to be called by
  * driver routines that support different devices which do and do not
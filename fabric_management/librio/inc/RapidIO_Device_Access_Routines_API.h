@@ -194,6 +194,11 @@ typedef struct DAR_DEV_INFO_t_TAG
 	uint32_t poregs_max;
 	uint32_t poreg_cnt;
 	rio_perf_opt_reg_t *poregs;
+
+	// Routing table generation, incremented by the rio_rt_* routines
+	// that change routing.  Routing table probe snapshots taken before
+	// the last change are no longer valid.
+	uint32_t rt_gen;
 } DAR_DEV_INFO_t;
 
 uint32_t DAR_add_poreg(DAR_DEV_INFO_t *dev_info, uint32_t oset, uint32_t data);
@@ -259,10 +264,83 @@ extern uint32_t (*WriteReg)(DAR_DEV_INFO_t *dev_info,
 
 extern void (*WaitSec)(uint32_t delay_nsec, uint32_t delay_sec);
 
+/* Optional routine to write cnt consecutive registers starting at offset
+*      with a single access.  When not bound, DARRegWriteBlock writes one
+*      register at a time.
+*/
+uint32_t DAR_blk_proc_ptr_init(
+		uint32_t (*WriteRegBlockCall)(DAR_DEV_INFO_t *dev_info,
+				uint32_t offset, uint32_t cnt,
+				uint32_t *writedata));
+
+extern uint32_t (*WriteRegBlock)(DAR_DEV_INFO_t *dev_info,
+				uint32_t offset, uint32_t cnt,
+				uint32_t *writedata);
+
+/* Optional routine to read cnt consecutive registers starting at offset
+*      with a single access.  When not bound, DARRegReadBlock reads one
+*      register at a time.
+*/
+uint32_t DAR_blk_rd_proc_ptr_init(
+		uint32_t (*ReadRegBlockCall)(DAR_DEV_INFO_t *dev_info,
+				uint32_t offset, uint32_t cnt,
+				uint32_t *readdata));
+
+extern uint32_t (*ReadRegBlock)(DAR_DEV_INFO_t *dev_info,
+				uint32_t offset, uint32_t cnt,
+				uint32_t *readdata);
+
 uint32_t DARRegRead ( DAR_DEV_INFO_t *dev_info, uint32_t offset, uint32_t *readdata );
 uint32_t DARRegWrite( DAR_DEV_INFO_t *dev_info, uint32_t offset, uint32_t writedata );
+uint32_t DARRegReadBlock(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *readdata);
+uint32_t DARRegWriteBlock(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *writedata);
 void DAR_WaitSec( uint32_t delay_nsec, uint32_t delay_sec);
 
+/* Register writes performed by the calling thread.
+*  reg_wr counts registers written, blk_wr counts register accesses.
+*  A block write counts as one access.
+*/
+typedef struct DAR_wr_stats_t_TAG {
+	uint64_t reg_wr;
+	uint64_t blk_wr;
+} DAR_wr_stats_t;
+
+void DAR_get_wr_stats(DAR_wr_stats_t *stats);
+
+/* Register reads performed by the calling thread.
+*  reg_rd counts registers read, blk_rd counts register accesses.
+*  A block read counts as one access.  Reads satisfied from poregs
+*  are not counted.
+*/
+typedef struct DAR_rd_stats_t_TAG {
+	uint64_t reg_rd;
+	uint64_t blk_rd;
+} DAR_rd_stats_t;
+
+void DAR_get_rd_stats(DAR_rd_stats_t *stats);
+
+/* Extended feature layout cache.
+*  The default driver caches the probe-time constant CARs and the extended
+*  feature block pointers of each device type, identified by the Device
+*  Identity, Device Information and Assembly Information CARs.  Later
+*  devices of the same type read only these CARs, the Switch Port
+*  Information CAR, and the first extended feature block header, which
+*  must match the cached header for the cached layout to be used.
+*
+*  hits counts devices whose layout was taken from the cache, misses counts
+*  devices whose extended feature blocks were read.
+*/
+typedef struct DAR_ef_cache_stats_t_TAG {
+	uint64_t hits;
+	uint64_t misses;
+} DAR_ef_cache_stats_t;
+
+void DAR_ef_cache_enable(bool enable);
+void DAR_ef_cache_clear(void);
+void DAR_get_ef_cache_stats(DAR_ef_cache_stats_t *stats);
+
 /* Routines which invoke the associated device driver function.
 * 
 *  All of these routines have default DAR implementations which rely on 
@@ -0,0 +1,214 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#ifndef __RAPIDIO_DEVICE_EMULATION_API_H__
+#define __RAPIDIO_DEVICE_EMULATION_API_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "RapidIO_Device_Access_Routines_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Register level device emulation
+ *
+ * An emulated device holds the register values of one RapidIO device, and
+ * models the register behavior which the librio device drivers depend on:
+ * - Capability registers and the extended features chain identify the
+ *   device, and are read only.
+ * - The host lock register behaves as defined by the RapidIO
+ *   specification.
+ * - Port error and status registers report the emulated link state, and
+ *   their error bits are write 1 to clear.
+ * - Link maintenance requests produce a valid link maintenance response.
+ * - Broadcast routing table and multicast mask registers update the
+ *   registers of every port.  RXS multicast masks are updated through
+ *   their set and clear registers.  Tsi57x routing tables are accessed
+ *   indirectly, with optional auto increment.
+ * All other registers read back the value last written, or their reset
+ * value.
+ *
+ * Every maintenance access is counted, and may be delayed to model the
+ * latency of maintenance transactions.  A block access is one maintenance
+ * access of several registers.
+ *
+ * Emulated devices are accessed directly with rio_emu_read/rio_emu_write,
+ * or through DARRegRead/DARRegWrite after rio_emu_bind.  When bound,
+ * dev_info->accessInfo selects the emulated device.
+ */
+
+typedef enum rio_emu_model_t_TAG {
+	rio_emu_rxs2448,
+	rio_emu_rxs1632,
+	rio_emu_cps1848,
+	rio_emu_cps1616,
+	rio_emu_tsi578,
+	rio_emu_tsi721,
+	rio_emu_model_last
+} rio_emu_model_t;
+
+// Maintenance access latency model.
+typedef struct rio_emu_lat_t_TAG {
+	// Time for each access, in nanoseconds
+	uint32_t acc_ns;
+
+	// Additional time for each register accessed, in nanoseconds
+	uint32_t reg_ns;
+
+	// true : wait for the modeled time on each access
+	// false: only accumulate the modeled time in lat_ns
+	bool wait;
+} rio_emu_lat_t;
+
+typedef struct rio_emu_stats_t_TAG {
+	// Maintenance read and write accesses
+	uint64_t rd_acc;
+	uint64_t wr_acc;
+
+	// Registers read and written
+	uint64_t regs_rd;
+	uint64_t regs_wr;
+
+	// Accesses which failed
+	uint64_t fails;
+
+	// Modeled maintenance access latency, in nanoseconds
+	uint64_t lat_ns;
+} rio_emu_stats_t;
+
+typedef struct rio_emu_dev_t_TAG rio_emu_dev_t;
+
+// Returns the name of the device emulated by a model, or NULL.
+const char *rio_emu_model_name(rio_emu_model_t model);
+
+// Returns the model whose name matches name, ignoring case, or
+// rio_emu_model_last.
+rio_emu_model_t rio_emu_model_by_name(const char *name);
+
+// Creates an emulated device in its reset state, with all links up.
+// Returns NULL if model is invalid, or memory cannot be allocated.
+rio_emu_dev_t *rio_emu_create(rio_emu_model_t model);
+void rio_emu_destroy(rio_emu_dev_t *emu);
+
+// Returns the emulated device to its reset state.  Statistics, latency
+// and link state are not changed.
+void rio_emu_reset(rio_emu_dev_t *emu);
+
+rio_emu_model_t rio_emu_get_model(rio_emu_dev_t *emu);
+uint8_t rio_emu_num_ports(rio_emu_dev_t *emu);
+
+void rio_emu_set_lat(rio_emu_dev_t *emu, rio_emu_lat_t *lat);
+void rio_emu_get_stats(rio_emu_dev_t *emu, rio_emu_stats_t *stats);
+void rio_emu_clr_stats(rio_emu_dev_t *emu);
+
+// Sets the state of the link connected to port.  Ports whose link is down
+// report "port uninitialized".
+uint32_t rio_emu_set_link(rio_emu_dev_t *emu, uint8_t port, bool up);
+
+// Sets the port reported by the switch port information CAR, which is the
+// port that received the maintenance request being performed.
+uint32_t rio_emu_set_acc_port(rio_emu_dev_t *emu, uint8_t port);
+
+// Accesses to offset fail with RIO_ERR_ACCESS until
+// rio_emu_set_fail(emu, RIO_EMU_NO_FAIL) is called.
+#define RIO_EMU_NO_FAIL 0xFFFFFFFF
+void rio_emu_set_fail(rio_emu_dev_t *emu, uint32_t offset);
+
+// Maintenance read and write of cnt consecutive registers starting at
+// offset.  Accesses are counted, and delayed according to the latency
+// model.  A failed access stops at the failed register.
+uint32_t rio_emu_read(rio_emu_dev_t *emu, uint32_t offset, uint32_t cnt,
+		uint32_t *data);
+uint32_t rio_emu_write(rio_emu_dev_t *emu, uint32_t offset, uint32_t cnt,
+		uint32_t *data);
+
+// Register access without side effects, counting or latency, for checking
+// and changing the emulated device state.
+uint32_t rio_emu_peek(rio_emu_dev_t *emu, uint32_t offset);
+void rio_emu_poke(rio_emu_dev_t *emu, uint32_t offset, uint32_t data);
+
+// Value of a Tsi57x routing table entry for port, selected by the value
+// written to the route configuration destID register.
+uint32_t rio_emu_peek_tsi57x_rte(rio_emu_dev_t *emu, uint8_t port,
+		uint32_t idx);
+
+// Returns the output port for a packet with destination ID did received
+// on port of an emulated switch, according to the emulated routing table
+// registers.  dev16 selects 16 bit destination IDs.  Returns
+// RIO_ERR_ROUTE_ERROR if the packet is dropped or multicast, and
+// RIO_ERR_NO_SWITCH if the device is not a switch.
+uint32_t rio_emu_route(rio_emu_dev_t *emu, uint8_t port, uint32_t did,
+		bool dev16, uint8_t *out_port);
+
+// Waits for delay_ns nanoseconds, as the latency model does.
+void rio_emu_wait_ns(uint64_t delay_ns);
+
+// Sleeps for delay_ns nanoseconds, letting other threads run.  Sleeps are
+// too coarse for single transactions, so the delays of each thread are
+// accumulated, and the thread sleeps once it is RIO_EMU_PACE_NS ahead of
+// the modeled time.
+#define RIO_EMU_PACE_NS 100000
+void rio_emu_sleep_ns(uint64_t delay_ns);
+
+// DAR register access routines for emulated devices.  dev_info->accessInfo
+// must point to the emulated device.
+uint32_t rio_emu_ReadReg(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t *readdata);
+uint32_t rio_emu_WriteReg(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t writedata);
+uint32_t rio_emu_ReadRegBlock(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *readdata);
+uint32_t rio_emu_WriteRegBlock(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *writedata);
+
+// Emulated devices respond immediately, so delays requested by the device
+// drivers return without waiting.
+void rio_emu_WaitSec(uint32_t delay_nsec, uint32_t delay_sec);
+
+// Binds the emulated device access routines with DAR_proc_ptr_init,
+// DAR_blk_proc_ptr_init and DAR_blk_rd_proc_ptr_init.  Block access is
+// bound only if blk is true.
+uint32_t rio_emu_bind(bool blk);
+
+// Initializes dev_info for the emulated device, and finds its driver
+// with DAR_Find_Driver_for_Device.  The access routines must be bound.
+uint32_t rio_emu_dev_info_init(rio_emu_dev_t *emu, DAR_DEV_INFO_t *dev_info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RAPIDIO_DEVICE_EMULATION_API_H__ */
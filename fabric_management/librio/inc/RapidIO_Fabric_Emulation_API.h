@@ -0,0 +1,200 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#ifndef __RAPIDIO_FABRIC_EMULATION_API_H__
+#define __RAPIDIO_FABRIC_EMULATION_API_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "RapidIO_Device_Emulation_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Fabric emulation
+ *
+ * An emulated fabric is a set of emulated devices connected by links, and
+ * one endpoint which acts as the master port.  Maintenance requests sent
+ * by the master port are routed through the fabric the way RapidIO
+ * switches route them:
+ * - A switch which receives a request with a hop count of 0 performs the
+ *   request itself.
+ * - Otherwise the switch decrements the hop count, and forwards the request
+ *   to the output port selected by the destination ID in the routing
+ *   table of the input port.
+ * - An endpoint performs every request which reaches it.
+ * Requests which are dropped by a routing table, or which must cross a
+ * link which is not connected, fail with RIO_ERR_ROUTE_ERROR.
+ *
+ * Each maintenance transaction is counted, and its latency modeled as the
+ * time for the request and response to cross each link, plus the access
+ * time of the target device.
+ *
+ * A fabric is described by a text file with one statement per line:
+ *   // comment
+ *   DEVICE <name> <model>
+ *   CONNECT <name>.<port> <name>.<port>
+ *   MPORT <name>
+ *   EOF
+ * where model is a rio_emu_model_name, ignoring case.
+ */
+
+#define RIO_FAB_NAME_SZ 31
+#define RIO_FAB_NO_DEV 0xFFFFFFFF
+
+typedef struct rio_fab_t_TAG rio_fab_t;
+
+// Maintenance transaction latency model.
+typedef struct rio_fab_lat_t_TAG {
+	// Time for a request or response to cross one link, in nanoseconds
+	uint32_t hop_ns;
+
+	// Time for the target device to perform an access, in nanoseconds
+	uint32_t acc_ns;
+
+	// Additional time for each register accessed, in nanoseconds
+	uint32_t reg_ns;
+
+	// true : wait for the modeled time on each transaction
+	// false: only accumulate the modeled time in lat_ns
+	bool wait;
+
+	// true : wait by sleeping, see rio_emu_sleep_ns, so that other
+	//        threads run while a thread waits for its transactions
+	// false: wait by spinning, which is accurate for each transaction
+	bool sleep;
+} rio_fab_lat_t;
+
+typedef struct rio_fab_stats_t_TAG {
+	// Maintenance read and write transactions sent to the fabric
+	uint64_t rd_acc;
+	uint64_t wr_acc;
+
+	// Master port local register reads and writes
+	uint64_t lcl_rd;
+	uint64_t lcl_wr;
+
+	// Links crossed by maintenance requests
+	uint64_t hops;
+
+	// Maintenance transactions which were dropped or failed
+	uint64_t fails;
+
+	// Modeled maintenance transaction latency, in nanoseconds
+	uint64_t lat_ns;
+} rio_fab_stats_t;
+
+// Creates an empty fabric.  Returns NULL if memory cannot be allocated.
+rio_fab_t *rio_fab_create(void);
+
+// Destroys the fabric, and all of its emulated devices.
+void rio_fab_destroy(rio_fab_t *fab);
+
+// Adds an emulated device in its reset state, with all links down.
+// Returns the device index, or RIO_FAB_NO_DEV if the name is in use or
+// the device cannot be created.
+uint32_t rio_fab_add_dev(rio_fab_t *fab, const char *name,
+		rio_emu_model_t model);
+
+// Connects port_a of device dev_a to port_b of device dev_b, and brings
+// up the links of both ports.
+uint32_t rio_fab_connect(rio_fab_t *fab, uint32_t dev_a, uint8_t port_a,
+		uint32_t dev_b, uint8_t port_b);
+
+// Selects the endpoint which sends maintenance requests.  Port 0 of the
+// master port must be connected.
+uint32_t rio_fab_set_mport(rio_fab_t *fab, uint32_t dev);
+
+uint32_t rio_fab_num_devs(rio_fab_t *fab);
+uint32_t rio_fab_get_mport(rio_fab_t *fab);
+
+// Returns the index of the device called name, or RIO_FAB_NO_DEV.
+uint32_t rio_fab_find_dev(rio_fab_t *fab, const char *name);
+
+// Returns the name or emulated device of device dev, or NULL.
+const char *rio_fab_dev_name(rio_fab_t *fab, uint32_t dev);
+rio_emu_dev_t *rio_fab_get_emu(rio_fab_t *fab, uint32_t dev);
+
+// Returns true if device dev is a switch.
+bool rio_fab_is_switch(rio_fab_t *fab, uint32_t dev);
+
+// Returns the device and port connected to port of device dev.
+// Returns RIO_ERR_INVALID_PARAMETER if the port is not connected.
+uint32_t rio_fab_get_lp(rio_fab_t *fab, uint32_t dev, uint8_t port,
+		uint32_t *lp_dev, uint8_t *lp_port);
+
+// Adds the devices, links and master port described by the text read from
+// fp, or from the file fn.  On a syntax error, *line is set to the line
+// number of the error.
+uint32_t rio_fab_parse(rio_fab_t *fab, FILE *fp, uint32_t *line);
+uint32_t rio_fab_load(rio_fab_t *fab, const char *fn, uint32_t *line);
+
+// Adds a tree of switches with nodes devices in total, including the
+// switches and the master port.  Switches are connected breadth first, and
+// the remaining switch ports connect endpoints.  The master port is
+// connected to port 0 of the first switch.
+uint32_t rio_fab_gen_tree(rio_fab_t *fab, rio_emu_model_t sw_model,
+		rio_emu_model_t ep_model, uint32_t nodes);
+
+// Selects 8 or 16 bit destination IDs for maintenance requests.
+void rio_fab_set_dev16(rio_fab_t *fab, bool dev16);
+bool rio_fab_get_dev16(rio_fab_t *fab);
+
+void rio_fab_set_lat(rio_fab_t *fab, rio_fab_lat_t *lat);
+void rio_fab_get_stats(rio_fab_t *fab, rio_fab_stats_t *stats);
+
+// Clears the fabric statistics, and the statistics of every device.
+void rio_fab_clr_stats(rio_fab_t *fab);
+
+// Access cnt consecutive registers of the master port, starting at offset.
+uint32_t rio_fab_local_read(rio_fab_t *fab, uint32_t offset, uint32_t cnt,
+		uint32_t *data);
+uint32_t rio_fab_local_write(rio_fab_t *fab, uint32_t offset, uint32_t cnt,
+		uint32_t *data);
+
+// Maintenance read and write of cnt consecutive registers starting at
+// offset, routed by destination ID did and hop count hc.  If dev is not
+// NULL, it is set to the device which performed the access.
+uint32_t rio_fab_maint_read(rio_fab_t *fab, uint32_t did, uint8_t hc,
+		uint32_t offset, uint32_t cnt, uint32_t *data, uint32_t *dev);
+uint32_t rio_fab_maint_write(rio_fab_t *fab, uint32_t did, uint8_t hc,
+		uint32_t offset, uint32_t cnt, uint32_t *data, uint32_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RAPIDIO_FABRIC_EMULATION_API_H__ */
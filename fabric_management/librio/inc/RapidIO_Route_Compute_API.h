@@ -0,0 +1,208 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#ifndef __RAPIDIO_ROUTE_COMPUTE_API_H__
+#define __RAPIDIO_ROUTE_COMPUTE_API_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "rio_standard.h"
+#include "rio_ecosystem.h"
+#include "RapidIO_Device_Access_Routines_API.h"
+#include "RapidIO_Routing_Table_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Fabric route computation
+ *
+ * Computes routing table state for every switch in a fabric from the
+ * fabric topology.  The topology is described as an array of nodes
+ * (switches and endpoints) and the connection of each node port.
+ *
+ * Unicast:
+ *   Every switch routes every endpoint destination ID along a shortest
+ *   path, measured in switch hops.  When several ports of a switch are on
+ *   a shortest path to a destination (parallel links, or several equal
+ *   cost paths through the fabric) the destination is assigned to the
+ *   port with the fewest destinations routed through it so far, which
+ *   spreads destination IDs evenly across equal cost links.
+ *
+ *   For 16 bit destination IDs, all destinations in a domain (upper 8 bits
+ *   of the destination ID) which share an output port are routed with
+ *   a single domain table entry.  Domains whose destinations need
+ *   different ports use the device table (RIO_RTE_LVL_G0).  Domain 0 always
+ *   uses the device table.  The cost of the computation depends on the
+ *   number of switches and endpoints, not on the size of the destination
+ *   ID space.
+ *
+ * Multicast:
+ *   Each multicast group is routed along a tree rooted at the switch
+ *   connected to the first member.  Switches on the tree get a multicast
+ *   mask selecting the tree links and the member endpoint ports.  All
+ *   other switches route the multicast destination ID towards the tree
+ *   so that non-member sources can reach the group.  Domains containing
+ *   a multicast destination ID always use the device table, so multicast
+ *   destination IDs are best placed in domains without endpoints.
+ *
+ * Results are written to the rio_rt_state_t of each switch and marked as
+ * changed, ready to be applied with rio_rt_set_changed().
+ */
+
+// Value of rio_route_link_t.peer for an unconnected port
+#define RIO_ROUTE_NO_NODE ((uint32_t)(0xFFFFFFFF))
+
+typedef struct rio_route_link_t_TAG {
+	// Index of the node connected to this port, or RIO_ROUTE_NO_NODE
+	uint32_t peer;
+
+	// Port number of the connected node
+	uint8_t peer_port;
+} rio_route_link_t;
+
+typedef struct rio_route_node_t_TAG {
+	// true for a switch, false for an endpoint
+	bool is_sw;
+
+	// Number of ports of the node, at most RIO_MAX_PORTS
+	uint8_t port_cnt;
+
+	// Endpoints only: destination ID of the endpoint
+	did_reg_t destID;
+
+	// Connection of each port
+	rio_route_link_t link[RIO_MAX_PORTS];
+
+	// Switches only: routing table state updated with the computed routes.
+	// Should be initialized, e.g. with rio_rt_initialize or
+	// rio_rt_probe_all, before computing routes.
+	rio_rt_state_t *rt;
+
+	// Switches only: device handle, may be NULL.
+	// When not NULL, rt is updated using rio_rt_change_rte,
+	// rio_rt_alloc_mc_mask and rio_rt_change_mc_mask so that device
+	// specific restrictions are applied.  When NULL, rt is updated directly.
+	DAR_DEV_INFO_t *dev_info;
+
+	// Caller data, not used by the route computation
+	void *priv;
+} rio_route_node_t;
+
+typedef struct rio_route_mc_grp_t_TAG {
+	// Multicast destination ID.  Must not be the destID of an endpoint.
+	did_reg_t mc_destID;
+
+	// Number of entries in mbr
+	uint32_t mbr_cnt;
+
+	// Node indexes of the endpoints which are members of the group
+	uint32_t *mbr;
+} rio_route_mc_grp_t;
+
+typedef struct rio_route_compute_in_t_TAG {
+	// Size of destination IDs routed by the fabric
+	tt_t tt;
+
+	// Number of entries in nodes
+	uint32_t node_cnt;
+
+	// Fabric topology.  Links must be symmetric: if port p of node n
+	// connects to port q of node m, port q of node m connects to port p
+	// of node n.
+	rio_route_node_t *nodes;
+
+	// Number of entries in mc, may be 0
+	uint32_t mc_cnt;
+
+	// Multicast groups
+	rio_route_mc_grp_t *mc;
+
+	// true : routing table entries which do not route an endpoint or
+	//        multicast destination ID are set to RIO_RTE_DROP.
+	// false: such entries are not changed.
+	// Entries selecting a multicast mask are never dropped.
+	bool clear_unused;
+} rio_route_compute_in_t;
+
+typedef struct rio_route_compute_out_t_TAG {
+	// Implementation specific failure information
+	uint32_t imp_rc;
+
+	// Number of switches routed
+	uint32_t sw_cnt;
+
+	// Number of endpoint destination IDs routed
+	uint32_t dest_cnt;
+
+	// Number of switch/destination pairs without a path
+	uint32_t unreachable;
+
+	// Number of switch/destination pairs which could not be routed
+	// as computed because the device table entry was already used by
+	// a destination in another domain.
+	uint32_t conflicts;
+
+	// Number of multicast masks programmed
+	uint32_t mc_masks;
+
+	// Number of routing table entries and multicast masks whose value
+	// was changed.
+	uint32_t rte_chg;
+} rio_route_compute_out_t;
+
+#define RT_COMPUTE_0 (RT_FIRST_SUBROUTINE_0+0x20000)
+#define RT_COMPUTE(x) (RT_COMPUTE_0+x)
+
+/* Computes unicast and multicast routes for every switch in the fabric
+ * and updates the routing table state of each switch.
+ *
+ * Hardware is not accessed.  Apply the results with rio_rt_set_changed().
+ */
+uint32_t rio_route_compute(rio_route_compute_in_t *in_parms,
+		rio_route_compute_out_t *out_parms);
+
+/* Initializes a node to have no connections. */
+void rio_route_node_init(rio_route_node_t *node, bool is_sw,
+		uint8_t port_cnt);
+
+/* Connects port p1 of node n1 to port p2 of node n2 in both directions. */
+uint32_t rio_route_connect(rio_route_node_t *nodes, uint32_t node_cnt,
+		uint32_t n1, uint8_t p1, uint32_t n2, uint8_t p2);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RAPIDIO_ROUTE_COMPUTE_API_H__ */
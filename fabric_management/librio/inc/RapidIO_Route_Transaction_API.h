@@ -0,0 +1,145 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+
+#ifndef __RAPIDIO_ROUTE_TRANSACTION_API_H__
+#define __RAPIDIO_ROUTE_TRANSACTION_API_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "rio_standard.h"
+#include "rio_ecosystem.h"
+#include "RapidIO_Device_Access_Routines_API.h"
+#include "RapidIO_Routing_Table_API.h"
+#include "RapidIO_Route_Compute_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Fabric route transactions
+ *
+ * Writes the routing table changes of every switch in a fabric to
+ * hardware.  The routing table state of each switch (rio_route_node_t.rt)
+ * holds the new routes, with the entries that differ from hardware marked
+ * as changed, as left by rio_route_compute or rio_rt_change_rte.  Only
+ * changed entries and multicast masks are written.
+ *
+ * Ordering:
+ *   Writes are grouped into phases, and each phase completes before the
+ *   next one starts.  Multicast masks are written first.  A unicast entry
+ *   is written after the entries of the switches on its new path towards
+ *   every endpoint it routes, so a switch only starts using a new route
+ *   once the rest of that route is in place.  Packets therefore never
+ *   loop or get dropped because part of a route was updated.  Domain
+ *   entries which select the device table are written after the device
+ *   table entries of the same phase.  Changed entries which do not route
+ *   to any endpoint are written last.
+ *
+ *   The guarantee is exact when each entry routes a single endpoint.
+ *   When an entry is shared by endpoints at different distances (domain
+ *   entries, or device entries used by several domains) it is written in
+ *   the phase of the most distant endpoint.
+ *
+ * Within a phase, switches are written concurrently by up to thread_cnt
+ * threads.  Runs of consecutive changed entries are written as register
+ * blocks when a block write routine is bound with DAR_blk_proc_ptr_init.
+ */
+
+#define RIO_RT_TXN_MAX_THREADS 32
+
+typedef struct rio_rt_txn_in_t_TAG {
+	// Size of destination IDs routed by the fabric
+	tt_t tt;
+
+	// Number of entries in nodes
+	uint32_t node_cnt;
+
+	// Fabric topology, as for rio_route_compute.
+	// Switches with changed entries must have rt and dev_info set.
+	rio_route_node_t *nodes;
+
+	// Maximum number of switches written concurrently, at most
+	// RIO_RT_TXN_MAX_THREADS.  0 and 1 write switches one at a time from
+	// the calling thread.
+	uint32_t thread_cnt;
+} rio_rt_txn_in_t;
+
+typedef struct rio_rt_txn_out_t_TAG {
+	// Implementation specific failure information
+	uint32_t imp_rc;
+
+	// Index of the node whose update failed, or RIO_ROUTE_NO_NODE
+	uint32_t fail_node;
+
+	// Number of switches with changes
+	uint32_t sw_cnt;
+
+	// Number of changed routing table entries
+	uint32_t rte_cnt;
+
+	// Number of changed multicast masks
+	uint32_t mc_cnt;
+
+	// Number of ordered write phases
+	uint32_t phase_cnt;
+
+	// Number of registers written, and number of register accesses used
+	// to write them.  Includes writes which are not routing table entries,
+	// such as multicast mask set/clear registers.
+	uint64_t reg_wr;
+	uint64_t blk_wr;
+
+	// Elapsed time of the transaction, in microseconds
+	uint64_t usecs;
+} rio_rt_txn_out_t;
+
+#define RT_TXN_0 (RT_FIRST_SUBROUTINE_0+0x21000)
+#define RT_TXN(x) (RT_TXN_0+x)
+
+/* Writes the changed routing table entries and multicast masks of every
+ * switch to hardware, ordered to avoid transient loops and black holes.
+ *
+ * On success no entries are marked as changed.  On failure, entries which
+ * were not written remain marked as changed and fail_node identifies the
+ * switch whose update failed.
+ */
+uint32_t rio_rt_txn_commit(rio_rt_txn_in_t *in_parms,
+		rio_rt_txn_out_t *out_parms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RAPIDIO_ROUTE_TRANSACTION_API_H__ */
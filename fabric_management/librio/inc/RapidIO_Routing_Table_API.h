@@ -495,6 +495,134 @@ void rio_rt_check_multicast_routing(DAR_DEV_INFO_t *dev_info,
 void rio_rt_check_unicast_routing(DAR_DEV_INFO_t *dev_info,
 		rio_rt_probe_in_t *in_parms, rio_rt_probe_out_t *out_parms);
 
+/* Cached routing table probes
+ *
+ * rio_rt_probe reads the port configuration and status registers of the
+ * selected port every time it is called.  A probe snapshot holds the
+ * routing table read by rio_rt_probe_all, and the result of probing a
+ * route to each port of the device.  rio_rt_probe_cached and
+ * rio_rt_probe_batch answer probes from the snapshot without reading
+ * any registers, and give the same results as rio_rt_probe.
+ *
+ * A snapshot is valid until routing is changed with rio_rt_initialize,
+ * rio_rt_set_all, rio_rt_set_changed, rio_rt_alloc_mc_mask,
+ * rio_rt_dealloc_mc_mask, rio_rt_change_rte or rio_rt_change_mc_mask,
+ * or rio_rt_probe_snap_invalidate is called.  A probe using a snapshot
+ * which is not valid takes a new snapshot first.
+ *
+ * Port status is sampled when the snapshot is taken.  Call
+ * rio_rt_probe_snap_invalidate when port status changes are detected.
+ */
+
+typedef struct rio_rt_probe_snap_t_TAG {
+	// true if the snapshot has been taken
+	bool valid;
+
+	// Device the snapshot was taken from, and its rt_gen value then
+	DAR_DEV_INFO_t *dev_info;
+	uint32_t rt_gen;
+
+	// Port whose routing table was read, or RIO_ALL_PORTS
+	uint8_t probe_on_port;
+
+	// Number of ports of the device
+	uint8_t num_ports;
+
+	// Routing table read using rio_rt_probe_all
+	rio_rt_state_t rt;
+
+	// Probe result for a route which drops packets, and for a route
+	// to each port.
+	rio_rt_probe_out_t base;
+	rio_rt_probe_out_t port[RIO_MAX_PORTS];
+} rio_rt_probe_snap_t;
+
+typedef struct rio_rt_probe_snap_in_t_TAG {
+	// Must be a valid port number, or RIO_ALL_PORTS
+	uint8_t probe_on_port;
+
+	// Snapshot to take
+	rio_rt_probe_snap_t *snap;
+} rio_rt_probe_snap_in_t;
+
+typedef struct rio_rt_probe_snap_out_t_TAG {
+	// Implementation specific failure information
+	uint32_t imp_rc;
+} rio_rt_probe_snap_out_t;
+
+typedef struct rio_rt_probe_cached_in_t_TAG {
+	// Snapshot used to answer the probe, taken if not valid
+	rio_rt_probe_snap_t *snap;
+
+	// Must be a valid port number, or RIO_ALL_PORTS
+	uint8_t probe_on_port;
+
+	// DestID size (8 bit or 16 bit)
+	tt_t tt;
+
+	// Check routing for specified device ID.
+	did_reg_t destID;
+} rio_rt_probe_cached_in_t;
+
+typedef struct rio_rt_probe_batch_in_t_TAG {
+	// Snapshot used to answer the probes, taken if not valid
+	rio_rt_probe_snap_t *snap;
+
+	// Must be a valid port number, or RIO_ALL_PORTS
+	uint8_t probe_on_port;
+
+	// DestID size (8 bit or 16 bit)
+	tt_t tt;
+
+	// Number of destIDs to probe
+	uint32_t destID_cnt;
+
+	// destIDs to probe
+	did_reg_t *destIDs;
+
+	// Array of destID_cnt entries for the probe result of each destID
+	rio_rt_probe_out_t *probe_out;
+} rio_rt_probe_batch_in_t;
+
+typedef struct rio_rt_probe_batch_out_t_TAG {
+	// Implementation specific failure information
+	uint32_t imp_rc;
+
+	// true if a new snapshot was taken
+	bool snap_taken;
+} rio_rt_probe_batch_out_t;
+
+#define RT_PROBE_SNAP_0   (DAR_FIRST_IMP_SPEC_ERROR+0x1900)
+#define RT_PROBE_BATCH_0  (DAR_FIRST_IMP_SPEC_ERROR+0x1A00)
+
+/* Reads the routing table of a port and the status of every port of
+ * the device into a probe snapshot.
+ */
+#define RT_PROBE_SNAP(x) (RT_PROBE_SNAP_0+x)
+uint32_t rio_rt_probe_snap(DAR_DEV_INFO_t *dev_info,
+		rio_rt_probe_snap_in_t *in_parms,
+		rio_rt_probe_snap_out_t *out_parms);
+
+/* Returns true if the snapshot was taken from dev_info for probe_on_port,
+ * and routing has not changed since.
+ */
+bool rio_rt_probe_snap_valid(DAR_DEV_INFO_t *dev_info,
+		rio_rt_probe_snap_t *snap, uint8_t probe_on_port);
+
+/* Invalidates all probe snapshots of the device */
+void rio_rt_probe_snap_invalidate(DAR_DEV_INFO_t *dev_info);
+
+/* Probes routing for a destination ID using a snapshot. */
+uint32_t rio_rt_probe_cached(DAR_DEV_INFO_t *dev_info,
+		rio_rt_probe_cached_in_t *in_parms,
+		rio_rt_probe_out_t *out_parms);
+
+/* Probes routing for a list of destination IDs using a snapshot. */
+#define RT_PROBE_BATCH(x) (RT_PROBE_BATCH_0+x)
+uint32_t rio_rt_probe_batch(DAR_DEV_INFO_t *dev_info,
+		rio_rt_probe_batch_in_t *in_parms,
+		rio_rt_probe_batch_out_t *out_parms);
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,6 +38,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdbool.h>
 
 #include "rio_route.h"
+#include "RapidIO_Utilities_API.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -444,6 +445,20 @@ uint32_t rio_sc_read_ctrs(DAR_DEV_INFO_t *dev_info,
 		rio_sc_read_ctrs_in_t *in_parms,
 		rio_sc_read_ctrs_out_t *out_parms);
 
+/* Adds the values read for cnt counters with DAR_multi_reg_read to the
+ * counter totals, in one pass over flat arrays: rd_out[i] holds the value
+ * read for ctrs[i].  Counters whose read failed are left unchanged.
+ *
+ * If wrap is false the counters clear when read, so the value read is the
+ * increment.  If wrap is true the counters are free running 32 bit
+ * counters, and the total is extended to 64 bits assuming the counter
+ * wrapped at most once since it was last read.
+ *
+ * Returns the index of the first failed read, or cnt if all succeeded.
+ */
+uint32_t rio_sc_accum_ctrs(rio_sc_ctr_val_t **ctrs,
+		DAR_read_entry_out_t *rd_out, uint32_t cnt, bool wrap);
+
 /* Configure counters on selected ports of a Tsi device. */
 #define SC_CFG_TSI57X_CTR(x) (SC_CFG_TSI57X_CTR_0+x)
 uint32_t rio_sc_cfg_tsi57x_ctr(DAR_DEV_INFO_t *dev_info,
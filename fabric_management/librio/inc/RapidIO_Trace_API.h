@@ -0,0 +1,355 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+
+#ifndef __RAPIDIO_TRACE_API_H__
+#define __RAPIDIO_TRACE_API_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "rio_standard.h"
+#include "RapidIO_Utilities_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Packet and control symbol trace captures
+ *
+ * A capture file starts with a rio_trace_file_hdr_t, and is divided into
+ * blocks of blk_size bytes.  The file header occupies the start of the
+ * first block.  Each block holds a sequence of records, each of which is
+ * a rio_trace_rec_hdr_t followed by len bytes of packet or control
+ * symbol, padded to a multiple of 8 bytes.  Records never span blocks.
+ * A record of kind rio_trace_rec_end, or the end of the block, ends the
+ * records in a block.  The last block may be shorter than blk_size.
+ *
+ * Because every block starts with a record, captures can be split at
+ * block boundaries and decoded in parallel.
+ *
+ * All values are stored in the byte order of the capturing host.
+ * Packet and control symbol bytes are stored in transmission order.
+ */
+
+#define RIO_TRACE_MAGIC "RIOTRACE"
+#define RIO_TRACE_MAGIC_LEN 8
+#define RIO_TRACE_VERSION 1
+
+#define RIO_TRACE_MIN_BLK_SIZE 0x1000
+#define RIO_TRACE_MAX_BLK_SIZE 0x1000000
+#define RIO_TRACE_DFLT_BLK_SIZE 0x10000
+
+typedef struct rio_trace_file_hdr_t_TAG {
+	char magic[RIO_TRACE_MAGIC_LEN];
+	uint32_t version;
+
+	// Size of each block, a power of 2
+	uint32_t blk_size;
+
+	// Address size of packets, a rio_addr_size value
+	uint32_t addr_size;
+	uint32_t rsvd[3];
+} rio_trace_file_hdr_t;
+
+typedef enum {
+	rio_trace_rec_end = 0,
+	rio_trace_rec_pkt = 1,
+	rio_trace_rec_cs = 2,
+} rio_trace_rec_kind_t;
+
+// Packet record flag, set when the packet bytes include the CRCs
+#define RIO_TRACE_PKT_HAS_CRC 0x01
+
+typedef struct rio_trace_rec_hdr_t_TAG {
+	// Capture time, in nanoseconds
+	uint64_t ts;
+
+	// Number of packet or control symbol bytes following the header
+	uint16_t len;
+
+	// rio_trace_rec_kind_t
+	uint8_t kind;
+
+	// Port or analyzer channel which captured the record
+	uint8_t port;
+
+	// Packets: RIO_TRACE_PKT_ flags
+	// Control symbols: rio_cs_size of the control symbol
+	uint8_t flags;
+	uint8_t rsvd[3];
+} rio_trace_rec_hdr_t;
+
+#define RIO_TRACE_REC_ALIGN 8
+#define RIO_TRACE_REC_SIZE(len) (sizeof(rio_trace_rec_hdr_t) \
+		+ (((len) + RIO_TRACE_REC_ALIGN - 1) \
+					& ~(RIO_TRACE_REC_ALIGN - 1)))
+
+/* Capture writer */
+
+typedef struct rio_trace_wr_t_TAG {
+	FILE *fp;
+	uint32_t blk_size;
+
+	// Bytes used in the current block
+	uint32_t blk_used;
+
+	// Number of records written
+	uint64_t rec_cnt;
+} rio_trace_wr_t;
+
+/* Creates a capture file.  blk_size of 0 selects RIO_TRACE_DFLT_BLK_SIZE.
+ */
+uint32_t rio_trace_wr_open(rio_trace_wr_t *wr, const char *path,
+		uint32_t blk_size, rio_addr_size addr_size);
+
+/* Appends a packet, or a control symbol, to the capture */
+uint32_t rio_trace_wr_pkt(rio_trace_wr_t *wr, uint64_t ts, uint8_t port,
+		DAR_pkt_bytes_t *pkt);
+uint32_t rio_trace_wr_cs(rio_trace_wr_t *wr, uint64_t ts, uint8_t port,
+		CS_bytes_t *cs);
+
+/* Flushes and closes the capture file */
+uint32_t rio_trace_wr_close(rio_trace_wr_t *wr);
+
+/* Capture reader, which maps the capture file into memory */
+
+typedef struct rio_trace_t_TAG {
+	int fd;
+	const uint8_t *base;
+	uint64_t size;
+	uint32_t blk_size;
+	uint64_t blk_cnt;
+	rio_addr_size addr_size;
+} rio_trace_t;
+
+uint32_t rio_trace_open(rio_trace_t *trace, const char *path);
+void rio_trace_close(rio_trace_t *trace);
+
+/* Decoded records
+ *
+ * Records are decoded in batches into columns, one array per field, so
+ * filters and aggregates only touch the fields they use.  Packets and
+ * control symbols have separate columns.
+ */
+
+#define RIO_TRACE_BATCH_SZ 1024
+
+// Packet and control symbol flags
+#define RIO_TRACE_F_CRC_OK 0x01
+#define RIO_TRACE_F_DECODE_OK 0x02
+
+typedef struct rio_trace_batch_t_TAG {
+	// Packets
+	uint32_t pkt_cnt;
+	uint64_t pkt_ts[RIO_TRACE_BATCH_SZ];
+
+	// File offset of the record
+	uint64_t pkt_off[RIO_TRACE_BATCH_SZ];
+
+	// DAR_pkt_summary_t fields
+	uint64_t addr[RIO_TRACE_BATCH_SZ];
+	did_reg_t dest[RIO_TRACE_BATCH_SZ];
+	did_reg_t src[RIO_TRACE_BATCH_SZ];
+	uint16_t bytes[RIO_TRACE_BATCH_SZ];
+	uint8_t ftype[RIO_TRACE_BATCH_SZ];
+	uint8_t pkt_type[RIO_TRACE_BATCH_SZ];
+	uint8_t tt[RIO_TRACE_BATCH_SZ];
+	uint8_t prio[RIO_TRACE_BATCH_SZ];
+	uint8_t tid[RIO_TRACE_BATCH_SZ];
+
+	// Number of bytes captured, including CRCs and padding
+	uint16_t len[RIO_TRACE_BATCH_SZ];
+	uint8_t pkt_port[RIO_TRACE_BATCH_SZ];
+	uint8_t pkt_flags[RIO_TRACE_BATCH_SZ];
+
+	// Control symbols
+	uint32_t cs_cnt;
+	uint64_t cs_ts[RIO_TRACE_BATCH_SZ];
+	uint8_t cs_port[RIO_TRACE_BATCH_SZ];
+	uint8_t cs_flags[RIO_TRACE_BATCH_SZ];
+	uint8_t stype0[RIO_TRACE_BATCH_SZ];
+	uint8_t parm0[RIO_TRACE_BATCH_SZ];
+	uint8_t parm1[RIO_TRACE_BATCH_SZ];
+	uint8_t stype1[RIO_TRACE_BATCH_SZ];
+	uint8_t cmd[RIO_TRACE_BATCH_SZ];
+
+	// Indexes of the packets and control symbols selected by the filter
+	uint32_t pkt_sel_cnt;
+	uint16_t pkt_sel[RIO_TRACE_BATCH_SZ];
+	uint32_t cs_sel_cnt;
+	uint16_t cs_sel[RIO_TRACE_BATCH_SZ];
+} rio_trace_batch_t;
+
+/* Filters.  Zero valued fields do not filter.
+ * Control symbols are selected only when no packet field filters are
+ * active.
+ */
+
+typedef enum {
+	rio_trace_crc_any = 0,
+	rio_trace_crc_ok = 1,
+	rio_trace_crc_bad = 2,
+} rio_trace_crc_filt_t;
+
+typedef struct rio_trace_filter_t_TAG {
+	// Bit n selects packets with FTYPE n
+	uint32_t ftype_mask;
+
+	bool dest_en;
+	did_reg_t dest;
+	bool src_en;
+	did_reg_t src;
+
+	rio_trace_crc_filt_t crc;
+
+	// Capture time range, inclusive.  ts_max of 0 is unlimited.
+	uint64_t ts_min;
+	uint64_t ts_max;
+
+	// Bit n selects records captured on port n
+	uint64_t port_mask;
+
+	// Exclude control symbols
+	bool no_cs;
+} rio_trace_filter_t;
+
+/* Aggregates of the selected records */
+
+typedef enum {
+	rio_trace_grp_none = 0,
+	rio_trace_grp_dest = 1,
+	rio_trace_grp_src = 2,
+	rio_trace_grp_ftype = 3,
+	rio_trace_grp_port = 4,
+} rio_trace_grp_t;
+
+// Number of keys of every group, enough for 16 bit destination IDs
+#define RIO_TRACE_GRP_KEYS 0x10000
+
+typedef struct rio_trace_agg_t_TAG {
+	// Number of records in the capture, selected or not
+	uint64_t recs;
+
+	// Number of records which could not be decoded
+	uint64_t decode_errs;
+
+	// Selected packets and control symbols
+	uint64_t pkts;
+	uint64_t cs;
+
+	// Bytes captured, and packet data bytes, of the selected packets
+	uint64_t wire_bytes;
+	uint64_t data_bytes;
+
+	// Selected records with CRC errors
+	uint64_t crc_errs;
+
+	// Capture time of the first and last selected records
+	uint64_t ts_first;
+	uint64_t ts_last;
+
+	uint64_t ftype[16];
+	uint64_t stype0[8];
+	uint64_t stype1[8];
+
+	// Per key packet count, captured bytes and data bytes of the
+	// selected packets.  Only allocated when grp is not
+	// rio_trace_grp_none.
+	rio_trace_grp_t grp;
+	uint64_t *grp_pkts;
+	uint64_t *grp_wire;
+	uint64_t *grp_data;
+} rio_trace_agg_t;
+
+void rio_trace_agg_free(rio_trace_agg_t *agg);
+
+/* Scans a capture, decoding and filtering every record, and aggregates
+ * the selected records.
+ *
+ * The capture is split into chunks of blocks, which are decoded
+ * concurrently by up to thread_cnt threads.  If batch_fn is not NULL it
+ * is called for every decoded batch, after filtering.  Calls are
+ * serialized, but batches are only passed in file order when thread_cnt
+ * is 1.
+ */
+
+#define RIO_TRACE_MAX_THREADS 64
+
+typedef void (*rio_trace_batch_fn_t)(rio_trace_batch_t *batch, void *arg);
+
+typedef struct rio_trace_scan_in_t_TAG {
+	rio_trace_t *trace;
+
+	// NULL selects all records
+	rio_trace_filter_t *filter;
+
+	rio_trace_grp_t grp;
+
+	// 0 selects the number of online processors
+	uint32_t thread_cnt;
+
+	rio_trace_batch_fn_t batch_fn;
+	void *batch_arg;
+} rio_trace_scan_in_t;
+
+typedef struct rio_trace_scan_out_t_TAG {
+	// Implementation specific failure information
+	uint32_t imp_rc;
+
+	// Release with rio_trace_agg_free
+	rio_trace_agg_t agg;
+
+	// Elapsed time of the scan, in microseconds
+	uint64_t usecs;
+} rio_trace_scan_out_t;
+
+// Implementation specific return codes, following the DAR_UTIL_ codes
+#define RIO_TRACE_0 (0x79000000)
+#define RIO_TRACE(x) (RIO_TRACE_0+x)
+
+uint32_t rio_trace_scan(rio_trace_scan_in_t *in_parms,
+		rio_trace_scan_out_t *out_parms);
+
+/* Sets pkt_sel and cs_sel to the records of the batch selected by filter.
+ * A NULL filter selects every record.
+ */
+void rio_trace_filter_batch(rio_trace_batch_t *batch,
+		rio_trace_filter_t *filter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RAPIDIO_TRACE_API_H__ */
@@ -83,6 +83,11 @@ void DAR_WaitSec(uint32_t delay_nsec, uint32_t delay_sec);
 
 /* Read num_entries worth of register offsets passed in as in_parms,
  * storing the values read and return code in out_parms.
+ *
+ * Registers are read in ascending offset order, and consecutive
+ * registers are read with DARRegReadBlock.  Entries with the same offset
+ * share one read.  Returns RIO_SUCCESS if every read succeeded, otherwise
+ * the return code of the first failed entry.
  */
 uint32_t DAR_multi_reg_read(DAR_DEV_INFO_t *dev_info,
 		DAR_read_entry_in_t *in_parms, DAR_read_entry_out_t *out_parms,
@@ -119,6 +124,13 @@ typedef struct DAR_read_write_entry_out_t_TAG {
 
 /* Perform num_entries read-modify-write operations as described in in_parms.
  * Store the results of the operations in out_parms.
+ *
+ * All registers are read before any register is written, in ascending
+ * offset order, using block accesses for consecutive registers.  If an
+ * offset appears more than once, the entries are processed one at a time
+ * in the order given.  When a read fails the register is not written,
+ * and write_rc is the read return code.  Returns RIO_SUCCESS if every
+ * access succeeded, otherwise the first failed return code.
  */
 uint32_t DAR_multi_reg_acc(DAR_DEV_INFO_t *dev_info,
 		DAR_read_write_entry_in_t *in_parms,
@@ -605,6 +617,53 @@ uint32_t DAR_update_pkt_CRC(DAR_pkt_bytes_t *bytes_in);
 uint32_t DAR_pkt_bytes_to_fields(DAR_pkt_bytes_t *bytes_in,
 		DAR_pkt_fields_t *fields_out);
 
+/* Summary of a packet, with the fields needed to filter and account for
+ * packets in traces.  All fields have the same values as the
+ * corresponding DAR_pkt_fields_t fields.
+ */
+typedef struct DAR_pkt_summary_t_TAG {
+	DAR_pkt_type pkt_type;
+	rio_TT_code tt_code;
+	uint8_t ftype;
+	uint8_t prio;
+
+	// Transaction ID, for packet types which have one
+	uint8_t tid;
+
+	// Bits 65 and 64 of 66 bit addresses, log_rw.addr[2]
+	uint8_t addr_msbs;
+
+	did_reg_t destID;
+	did_reg_t srcID;
+
+	// Least significant 64 bits of the address, including the offset of
+	// the first valid byte: log_rw.addr[1] << 32 | log_rw.addr[0].
+	// 0 for packet types without an address.
+	uint64_t addr;
+
+	// Number of bytes read, written or carried by the packet
+	uint32_t pkt_bytes;
+
+	// True if the packet's CRCs are correct, or the packet has no CRC
+	bool crc_ok;
+} DAR_pkt_summary_t;
+
+/* Parses the header of a packet without copying it or its data.
+ * pkt points to num_chars bytes of the packet, in transmission order.
+ * addr_size and has_crc have the meaning of the DAR_pkt_bytes_t fields.
+ *
+ * Returns the same error codes as DAR_pkt_bytes_to_fields for the same
+ * packet.
+ */
+uint32_t DAR_pkt_bytes_to_summary(const uint8_t *pkt, uint32_t num_chars,
+		rio_addr_size addr_size, bool has_crc,
+		DAR_pkt_summary_t *summ_out);
+
+/* Returns true if the intermediate and final CRCs of the packet are
+ * correct.  Padding after the final CRC is allowed.
+ */
+bool DAR_pkt_CRC_ok(const uint8_t *pkt, uint32_t num_chars);
+
 /* Routines to return strings describing field values
  * Returns string naming packet FTYPE.
  */
@@ -455,27 +455,113 @@ exit:
 	return rc;
 }
 
+// Checks that a routing table value can be programmed
+static bool cps_rte_valid(DAR_DEV_INFO_t *dev_info, uint32_t rte_val,
+		bool dev_table)
+{
+	if (rte_val < NUM_CPS_PORTS(dev_info)) {
+		return true;
+	}
+	if ((RIO_RTE_DFLT_PORT == rte_val) || (RIO_RTE_DROP == rte_val)) {
+		return true;
+	}
+	// Domain table can also use the device table,
+	// device table can also select a multicast mask.
+	if (dev_table) {
+		return RIO_RTV_GET_MC_MSK(rte_val) != RIO_RTE_BAD;
+	}
+	return RIO_RTE_LVL_G0 == rte_val;
+}
+
+// Writes the changed entries of one routing table, combining runs of
+// consecutive changed entries into block writes.
+static uint32_t cps_program_rte_table(DAR_DEV_INFO_t *dev_info,
+		rio_rt_uc_info_t *table, uint32_t base, bool dev_table,
+		bool set_all, uint32_t *imp_rc)
+{
+	uint32_t rc = RIO_SUCCESS;
+	uint32_t vals[RIO_RT_GRP_SZ];
+	uint16_t rte_num, first, cnt;
+
+	rte_num = 0;
+	while (rte_num < RIO_RT_GRP_SZ) {
+		if (!(table[rte_num].changed || set_all)) {
+			rte_num++;
+			continue;
+		}
+
+		first = rte_num;
+		while ((rte_num < RIO_RT_GRP_SZ)
+				&& (table[rte_num].changed || set_all)) {
+			if (!cps_rte_valid(dev_info, table[rte_num].rte_val,
+					dev_table)) {
+				rc = RIO_ERR_INVALID_PARAMETER;
+				*imp_rc = PROGRAM_RTE_ENTRIES(dev_table ? 3 : 1);
+				goto exit;
+			}
+			rc = cps_rte_translate_std_to_CPS(dev_info,
+					table[rte_num].rte_val,
+					&vals[rte_num - first]);
+			if (RIO_SUCCESS != rc) {
+				*imp_rc = PROGRAM_RTE_ENTRIES(
+						dev_table ? 0x08 : 0x07);
+				goto exit;
+			}
+			rte_num++;
+		}
+		cnt = rte_num - first;
+
+		rc = DARRegWriteBlock(dev_info, DEV_RTE_ADDR(base, first), cnt,
+				vals);
+		if (RIO_SUCCESS != rc) {
+			*imp_rc = PROGRAM_RTE_ENTRIES(dev_table ? 4 : 2);
+			goto exit;
+		}
+		while (first < rte_num) {
+			table[first++].changed = false;
+		}
+	}
+
+exit:
+	return rc;
+}
+
 static uint32_t cps_program_rte_entries(DAR_DEV_INFO_t *dev_info,
 		rio_rt_set_all_in_t *in_parms,
 		bool set_all, // true if all entries should be set
+		bool set_dflt, // true if the default route should be set
 		uint32_t *imp_rc)
 {
 	uint32_t rc = RIO_SUCCESS;
 	// Note that the base address for CPS1848, CPS1432, CPS1616, SPS1616
 	// are all the same.
-	uint16_t rte_num;
 	uint32_t dev_rte_base, dom_rte_base, cps_val;
 
-	rc = cps_rte_translate_std_to_CPS(dev_info, in_parms->rt->default_route,
-			&cps_val);
-	if (RIO_SUCCESS != rc) {
-		*imp_rc = PROGRAM_RTE_ENTRIES(0x06);
-		goto exit;
-	}
-	rc = DARRegWrite(dev_info, CPS1848_RTE_DEFAULT_PORT_CSR, cps_val);
-	if (RIO_SUCCESS != rc) {
-		*imp_rc = PROGRAM_RTE_ENTRIES(0x10);
-		goto exit;
+	// The default route and domain register are only changed by
+	// rio_rt_initialize and rio_rt_set_all.
+	if (set_all || set_dflt) {
+		rc = cps_rte_translate_std_to_CPS(dev_info,
+				in_parms->rt->default_route, &cps_val);
+		if (RIO_SUCCESS != rc) {
+			*imp_rc = PROGRAM_RTE_ENTRIES(0x06);
+			goto exit;
+		}
+		rc = DARRegWrite(dev_info, CPS1848_RTE_DEFAULT_PORT_CSR,
+				cps_val);
+		if (RIO_SUCCESS != rc) {
+			*imp_rc = PROGRAM_RTE_ENTRIES(0x10);
+			goto exit;
+		}
+
+		// DOMAIN REGISTER MUST ALWAYS BE 0
+		// THIS MAKES 16 BIT DESTIDS OF THE FORM 0x00YY
+		// EQUIVALENT TO 8 BIT DESTID ROUTING
+
+		rc = DARRegWrite(dev_info, CPS1848_RIO_DOMAIN, 0);
+		if (RIO_SUCCESS != rc) {
+			*imp_rc = PROGRAM_RTE_ENTRIES(0);
+			goto exit;
+		}
 	}
 
 	if (RIO_ALL_PORTS == in_parms->set_on_port) {
@@ -488,102 +574,22 @@ static uint32_t cps_program_rte_entries(DAR_DEV_INFO_t *dev_info,
 				in_parms->set_on_port, 0);
 	}
 
-	// DOMAIN REGISTER MUST ALWAYS BE 0
-	// THIS MAKES 16 BIT DESTIDS OF THE FORM 0x00YY
-	// EQUIVALENT TO 8 BIT DESTID ROUTING
-
-	rc = DARRegWrite(dev_info, CPS1848_RIO_DOMAIN, 0);
+	rc = cps_program_rte_table(dev_info, in_parms->rt->dom_table,
+			dom_rte_base, false, set_all, imp_rc);
 	if (RIO_SUCCESS != rc) {
-		*imp_rc = PROGRAM_RTE_ENTRIES(0);
 		goto exit;
 	}
 
-	for (rte_num = 0; rte_num < RIO_RT_GRP_SZ; rte_num++) {
-		if (in_parms->rt->dom_table[rte_num].changed || set_all) {
-			//@sonar:off - Collapsible "if" statements should be merged
-			// Validate value to be programmed.
-			if (in_parms->rt->dom_table[rte_num].rte_val
-					>= NUM_CPS_PORTS(dev_info)) {
-				// Domain table can be a port number, use device table, use default route, or drop.
-				if ((in_parms->rt->dom_table[rte_num].rte_val
-						!= RIO_RTE_LVL_G0)
-						&& (in_parms->rt->dom_table[rte_num].rte_val
-								!= RIO_RTE_DFLT_PORT)
-						&& (in_parms->rt->dom_table[rte_num].rte_val
-								!= RIO_RTE_DROP)) {
-					rc = RIO_ERR_INVALID_PARAMETER;
-					*imp_rc = PROGRAM_RTE_ENTRIES(1);
-					goto exit;
-				}
-			}
-			//@sonar:on
-			rc =
-					cps_rte_translate_std_to_CPS(dev_info,
-							in_parms->rt->dom_table[rte_num].rte_val,
-							&cps_val);
-			if (RIO_SUCCESS != rc) {
-				*imp_rc = PROGRAM_RTE_ENTRIES(0x07);
-				goto exit;
-			}
-
-			rc = DARRegWrite(dev_info,
-					DOM_RTE_ADDR(dom_rte_base, rte_num),
-					cps_val);
-			if (RIO_SUCCESS != rc) {
-				*imp_rc = PROGRAM_RTE_ENTRIES(2);
-				goto exit;
-			}
-			in_parms->rt->dom_table[rte_num].changed = false;
-		}
-	}
-
-	for (rte_num = 0; rte_num < RIO_RT_GRP_SZ; rte_num++) {
-		if (in_parms->rt->dev_table[rte_num].changed || set_all) {
-			//@sonar:off - Collapsible "if" statements should be merged
-			// Validate value to be programmed.
-			if (in_parms->rt->dev_table[rte_num].rte_val
-					>= NUM_CPS_PORTS(dev_info)) {
-				// Device table can be a port number, a multicast mask, use default route, or drop.
-				if ((RIO_RTV_GET_MC_MSK(
-						in_parms->rt->dev_table[rte_num].rte_val)
-						== RIO_RTE_BAD)
-						&& (in_parms->rt->dev_table[rte_num].rte_val
-								!= RIO_RTE_DFLT_PORT)
-						&& (in_parms->rt->dev_table[rte_num].rte_val
-								!= RIO_RTE_DROP)) {
-					rc = RIO_ERR_INVALID_PARAMETER;
-					*imp_rc = PROGRAM_RTE_ENTRIES(3);
-					goto exit;
-				}
-			}
-			//@sonar:on
-			rc =
-					cps_rte_translate_std_to_CPS(dev_info,
-							in_parms->rt->dev_table[rte_num].rte_val,
-							&cps_val);
-			if (RIO_SUCCESS != rc) {
-				*imp_rc = PROGRAM_RTE_ENTRIES(0x08);
-				goto exit;
-			}
-
-			rc = DARRegWrite(dev_info,
-					DEV_RTE_ADDR(dev_rte_base, rte_num),
-					cps_val);
-			if (RIO_SUCCESS != rc) {
-				*imp_rc = PROGRAM_RTE_ENTRIES(4);
-				goto exit;
-			}
-			in_parms->rt->dev_table[rte_num].changed = false;
-		}
-	}
-
+	rc = cps_program_rte_table(dev_info, in_parms->rt->dev_table,
+			dev_rte_base, true, set_all, imp_rc);
 exit:
 	return rc;
 }
 
 static uint32_t cps_rt_set_common(DAR_DEV_INFO_t *dev_info,
 		rio_rt_set_all_in_t *in_parms, rio_rt_set_all_out_t *out_parms,
-		bool set_all) // true if all entries should be set
+		bool set_all, // true if all entries should be set
+		bool set_dflt) // true if the default route should be set
 {
 	uint32_t rc = RIO_ERR_INVALID_PARAMETER;
 
@@ -609,7 +615,7 @@ static uint32_t cps_rt_set_common(DAR_DEV_INFO_t *dev_info,
 		goto exit;
 	}
 
-	rc = cps_program_rte_entries(dev_info, in_parms, set_all,
+	rc = cps_program_rte_entries(dev_info, in_parms, set_all, set_dflt,
 			&out_parms->imp_rc);
 	if (RIO_SUCCESS != rc) {
 		goto exit;
@@ -760,7 +766,8 @@ uint32_t CPS_rio_rt_initialize(DAR_DEV_INFO_t *dev_info,
 				goto exit;
 			}
 		}
-		rc = CPS_rio_rt_set_changed(dev_info, &all_in, &all_out);
+		rc = cps_rt_set_common(dev_info, &all_in, &all_out,
+				SET_CHANGED, true);
 	} else {
 		rc = RIO_SUCCESS;
 	}
@@ -905,7 +912,7 @@ exit:
 uint32_t CPS_rio_rt_set_all(DAR_DEV_INFO_t *dev_info,
 		rio_rt_set_all_in_t *in_parms, rio_rt_set_all_out_t *out_parms)
 {
-	return cps_rt_set_common(dev_info, in_parms, out_parms, SET_ALL);
+	return cps_rt_set_common(dev_info, in_parms, out_parms, SET_ALL, true);
 }
 
 /* This function sets the the routing table hardware to match every entry
@@ -919,7 +926,8 @@ uint32_t CPS_rio_rt_set_changed(DAR_DEV_INFO_t *dev_info,
 		rio_rt_set_changed_in_t *in_parms,
 		rio_rt_set_changed_out_t *out_parms)
 {
-	return cps_rt_set_common(dev_info, in_parms, out_parms, SET_CHANGED);
+	return cps_rt_set_common(dev_info, in_parms, out_parms, SET_CHANGED,
+			false);
 }
 
 /* This function updates an rio_rt_state_t structure to
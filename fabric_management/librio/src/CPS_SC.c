@@ -38,6 +38,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "DAR_DB_Private.h"
 #include "DSF_DB_Private.h"
 #include "RapidIO_Statistics_Counter_API.h"
+#include "RapidIO_Utilities_API.h"
 #include "CPS1848.h"
 #include "CPS1616.h"
 
@@ -278,6 +279,10 @@ exit:
 	return rc;
 }
 
+// Largest number of registers read by one call to CPS_rio_sc_read_ctrs:
+// the port operations register and the counters of each port.
+#define CPS_SC_MAX_RD (RIO_MAX_PORTS * (NUM_CPS_SC + 1))
+
 /* Reads enabled counters on selected ports
  */
 
@@ -288,8 +293,17 @@ uint32_t CPS_rio_sc_read_ctrs(DAR_DEV_INFO_t *dev_info,
 	uint32_t rc = RIO_ERR_INVALID_PARAMETER;
 	uint8_t srch_i, srch_p, port_num, cntr;
 	bool found;
-	uint32_t ctl_reg;
 	struct DAR_ptl good_ptl;
+	rio_sc_ctr_val_t *counter;
+	DAR_read_entry_in_t rd_in[CPS_SC_MAX_RD];
+	DAR_read_entry_out_t rd_out[CPS_SC_MAX_RD];
+	rio_sc_ctr_val_t *rd_ctr[CPS_SC_MAX_RD];
+	uint8_t rd_cntr[CPS_SC_MAX_RD];
+	uint32_t rd_ops[CPS_SC_MAX_RD];
+	uint32_t rd_cnt = 0;
+	uint32_t ops_idx = 0;
+	uint32_t ops_rc = RIO_SUCCESS;
+	uint32_t i, acc_cnt, fail;
 
 	out_parms->imp_rc = RIO_SUCCESS;
 
@@ -327,53 +341,44 @@ uint32_t CPS_rio_sc_read_ctrs(DAR_DEV_INFO_t *dev_info,
 
 	// For generality, must establish a list of ports.
 	// Do not assume that the port number equals the index in the structure...
-
+	//
+	// The control register and the counters of all ports are read with
+	// one DAR_multi_reg_read.  Counters are accumulated only if the
+	// control register shows that they are enabled.
 	for (srch_p = 0; srch_p < good_ptl.num_ports; srch_p++) {
 		found = false;
 		port_num = good_ptl.pnums[srch_p];
 		for (srch_i = 0; srch_i < in_parms->dev_ctrs->valid_p_ctrs;
 				srch_i++) {
-			if (in_parms->dev_ctrs->p_ctrs[srch_i].pnum
-					== port_num) {
-				found = true;
-
-				// Read the control value to determine if any counters are enabled
-				rc = DARRegRead(dev_info,
-						CPS1848_PORT_X_OPS(port_num),
-						&ctl_reg);
-				if (RIO_SUCCESS != rc) {
-					out_parms->imp_rc = SC_READ_CTRS(0x40);
-					goto exit;
-				}
-
-				// Read the port performance counters...
-				for (cntr = 0;
-						cntr
-								< in_parms->dev_ctrs->p_ctrs[srch_i].ctrs_cnt;
-						cntr++) {
-					if ((rio_sc_disabled
-							!= in_parms->dev_ctrs->p_ctrs[srch_i].ctrs[cntr].sc)
-							&& (ctl_reg
-									& cps_sc_info[cntr].mask)) {
-						rc =
-								DARRegRead(
-										dev_info,
-										CPS_SC_ADDR(
-												port_num,
-												cntr),
-										&in_parms->dev_ctrs->p_ctrs[srch_i].ctrs[cntr].last_inc);
-						if (RIO_SUCCESS != rc) {
-							out_parms->imp_rc =
-									SC_READ_CTRS(
-											0x70 + cntr);
-							goto exit;
-						}
-						in_parms->dev_ctrs->p_ctrs[srch_i].ctrs[cntr].total +=
-								in_parms->dev_ctrs->p_ctrs[srch_i].ctrs[cntr].last_inc;
-					}
+			if ((in_parms->dev_ctrs->p_ctrs[srch_i].pnum
+					!= port_num)
+					|| (rd_cnt + NUM_CPS_SC + 1
+							> CPS_SC_MAX_RD)) {
+				continue;
+			}
+			found = true;
+
+			ops_idx = rd_cnt;
+			rd_in[rd_cnt].offset = CPS1848_PORT_X_OPS(port_num);
+			rd_ctr[rd_cnt] = NULL;
+			rd_cnt++;
+
+			for (cntr = 0; (cntr < in_parms->dev_ctrs->p_ctrs[srch_i]
+					.ctrs_cnt) && (cntr < NUM_CPS_SC);
+					cntr++) {
+				counter = &in_parms->dev_ctrs->p_ctrs[srch_i]
+								.ctrs[cntr];
+				if (rio_sc_disabled == counter->sc) {
+					continue;
 				}
-				break;
+				rd_in[rd_cnt].offset = CPS_SC_ADDR(port_num,
+									cntr);
+				rd_ctr[rd_cnt] = counter;
+				rd_cntr[rd_cnt] = cntr;
+				rd_ops[rd_cnt] = ops_idx;
+				rd_cnt++;
 			}
+			break;
 		}
 
 		if (!found) {
@@ -383,6 +388,44 @@ uint32_t CPS_rio_sc_read_ctrs(DAR_DEV_INFO_t *dev_info,
 		}
 	}
 
+	DAR_multi_reg_read(dev_info, rd_in, rd_out, rd_cnt);
+
+	// Keep the counters which are enabled, in place.  The counters
+	// clear when read, so the counters of other ports are still
+	// accumulated when a control register cannot be read.
+	acc_cnt = 0;
+	for (i = 0; i < rd_cnt; i++) {
+		if (NULL == rd_ctr[i]) {
+			if ((RIO_SUCCESS != rd_out[i].rc)
+					&& (RIO_SUCCESS == ops_rc)) {
+				ops_rc = rd_out[i].rc;
+			}
+			continue;
+		}
+		if ((RIO_SUCCESS != rd_out[rd_ops[i]].rc)
+				|| !(rd_out[rd_ops[i]].value_read
+					& cps_sc_info[rd_cntr[i]].mask)) {
+			continue;
+		}
+		rd_ctr[acc_cnt] = rd_ctr[i];
+		rd_cntr[acc_cnt] = rd_cntr[i];
+		rd_out[acc_cnt] = rd_out[i];
+		acc_cnt++;
+	}
+
+	fail = rio_sc_accum_ctrs(rd_ctr, rd_out, acc_cnt, false);
+	if (RIO_SUCCESS != ops_rc) {
+		rc = ops_rc;
+		out_parms->imp_rc = SC_READ_CTRS(0x40);
+		goto exit;
+	}
+	if (fail < acc_cnt) {
+		rc = rd_out[fail].rc;
+		out_parms->imp_rc = SC_READ_CTRS(0x70 + rd_cntr[fail]);
+		goto exit;
+	}
+	rc = RIO_SUCCESS;
+
 exit:
 	return rc;
 }
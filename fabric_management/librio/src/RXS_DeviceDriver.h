@@ -146,6 +146,13 @@ uint32_t rxs_rio_rt_probe(DAR_DEV_INFO_t *dev_info,
 		rio_rt_probe_in_t *in_parms,
 		rio_rt_probe_out_t *out_parms);
 
+// Determines the route for a destination ID from the routing table state
+// structure, without reading registers or checking ports for discards.
+// out_parms->default_route must be set to the default route.
+void rxs_rio_rt_check_routing(DAR_DEV_INFO_t *dev_info,
+		rio_rt_probe_in_t *in_parms,
+		rio_rt_probe_out_t *out_parms);
+
 uint32_t rxs_rio_rt_probe_all(DAR_DEV_INFO_t *dev_info,
 		rio_rt_probe_all_in_t *in_parms,
 		rio_rt_probe_all_out_t *out_parms);
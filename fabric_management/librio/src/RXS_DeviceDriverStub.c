@@ -202,6 +202,16 @@ uint32_t rxs_rio_rt_probe(DAR_DEV_INFO_t *dev_info,
 	return DSF_rio_rt_probe(dev_info, in_parms, out_parms);
 }
 
+void rxs_rio_rt_check_routing(DAR_DEV_INFO_t *dev_info,
+		rio_rt_probe_in_t *in_parms,
+		rio_rt_probe_out_t *out_parms)
+{
+	rio_rt_check_multicast_routing(dev_info, in_parms, out_parms);
+	if (RIO_ALL_PORTS == out_parms->routing_table_value) {
+		rio_rt_check_unicast_routing(dev_info, in_parms, out_parms);
+	}
+}
+
 uint32_t rxs_rio_rt_probe_all(DAR_DEV_INFO_t *dev_info,
 		rio_rt_probe_all_in_t *in_parms,
 		rio_rt_probe_all_out_t *out_parms)
@@ -41,6 +41,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "DSF_DB_Private.h"
 #include "RapidIO_Error_Management_API.h"
 #include "RapidIO_Device_Access_Routines_API.h"
+#include "RapidIO_Utilities_API.h"
 #include "RXS_DeviceDriver.h"
 #include "string_util.h"
 
@@ -1846,13 +1847,37 @@ fail:
 	return rc;
 }
 
+/* Reads the status registers of one port with one DAR_multi_reg_read
+ * call.  If a read fails, returns its return code and the index of the
+ * failed entry in fail_idx.
+ */
+static uint32_t rxs_em_read_regs(DAR_DEV_INFO_t *dev_info,
+		DAR_read_entry_in_t *rd_in, DAR_read_entry_out_t *rd_out,
+		uint32_t cnt, uint32_t *fail_idx)
+{
+	uint32_t i;
+
+	DAR_multi_reg_read(dev_info, rd_in, rd_out, cnt);
+	for (i = 0; i < cnt; i++) {
+		if (RIO_SUCCESS != rd_out[i].rc) {
+			*fail_idx = i;
+			return rd_out[i].rc;
+		}
+	}
+	return RIO_SUCCESS;
+}
+
+// Registers read by rxs_rio_em_get_int_stat_port, and the implementation
+// specific return code for a failure to read each of them.
+#define RXS_EM_INT_STAT_REGS 9
+static const uint8_t rxs_em_int_stat_imp_rc[RXS_EM_INT_STAT_REGS] = {
+	0x10, 0x10, 0x11, 0x12, 0x10, 0x12, 0x10, 0x12, 0x14};
+
 uint32_t rxs_rio_em_get_int_stat_port(DAR_DEV_INFO_t *dev_info,
 		rio_em_get_int_stat_in_t *in_parms,
 		rio_em_get_int_stat_out_t *out_parms, rio_port_t port)
 {
 	uint32_t plm_denial_ctl;
-	uint32_t spx_err_det;
-	uint32_t spx_rate_en;
 	uint32_t plm_ints;
 	uint32_t plm_int_en;
 	uint32_t plm_int_stat;
@@ -1862,63 +1887,35 @@ uint32_t rxs_rio_em_get_int_stat_port(DAR_DEV_INFO_t *dev_info,
 	uint32_t pbm_ints;
 	uint32_t pbm_int_en;
 	uint32_t pbm_int_stat;
-	uint32_t rst_int_en;
 	uint32_t pna_cap;
 	uint32_t rc;
-
-	rc = DARRegRead(dev_info, RXS_SPX_ERR_DET(port), &spx_err_det);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_INT_STAT(0x10);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_SPX_RATE_EN(port), &spx_rate_en);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_INT_STAT(0x10);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_PLM_SPX_STAT(port), &plm_ints);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_INT_STAT(0x11);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_PLM_SPX_INT_EN(port), &plm_int_en);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_INT_STAT(0x12);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_TLM_SPX_STAT(port), &tlm_ints);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_INT_STAT(0x10);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_TLM_SPX_INT_EN(port), &tlm_int_en);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_INT_STAT(0x12);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_PBM_SPX_STAT(port), &pbm_ints);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_INT_STAT(0x10);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_PBM_SPX_INT_EN(port), &pbm_int_en);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_INT_STAT(0x12);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_EM_RST_INT_EN, &rst_int_en);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_INT_STAT(0x14);
-		goto fail;
-	}
+	DAR_read_entry_in_t rd_in[RXS_EM_INT_STAT_REGS];
+	DAR_read_entry_out_t rd_out[RXS_EM_INT_STAT_REGS];
+	uint32_t fail_idx = 0;
+
+	rd_in[0].offset = RXS_SPX_ERR_DET(port);
+	rd_in[1].offset = RXS_SPX_RATE_EN(port);
+	rd_in[2].offset = RXS_PLM_SPX_STAT(port);
+	rd_in[3].offset = RXS_PLM_SPX_INT_EN(port);
+	rd_in[4].offset = RXS_TLM_SPX_STAT(port);
+	rd_in[5].offset = RXS_TLM_SPX_INT_EN(port);
+	rd_in[6].offset = RXS_PBM_SPX_STAT(port);
+	rd_in[7].offset = RXS_PBM_SPX_INT_EN(port);
+	rd_in[8].offset = RXS_EM_RST_INT_EN;
+
+	rc = rxs_em_read_regs(dev_info, rd_in, rd_out, RXS_EM_INT_STAT_REGS,
+								&fail_idx);
+	if (RIO_SUCCESS != rc) {
+		out_parms->imp_rc =
+			EM_GET_INT_STAT(rxs_em_int_stat_imp_rc[fail_idx]);
+		goto fail;
+	}
+	plm_ints = rd_out[2].value_read;
+	plm_int_en = rd_out[3].value_read;
+	tlm_ints = rd_out[4].value_read;
+	tlm_int_en = rd_out[5].value_read;
+	pbm_ints = rd_out[6].value_read;
+	pbm_int_en = rd_out[7].value_read;
 
 	plm_int_stat = plm_ints & (plm_int_en | RXS_PLM_SPX_UNMASKABLE_MASK);
 
@@ -2086,13 +2083,17 @@ fail:
 	return rc;
 }
 
+// Registers read by rxs_rio_em_get_pw_stat_port, and the implementation
+// specific return code for a failure to read each of them.
+#define RXS_EM_PW_STAT_REGS 11
+static const uint8_t rxs_em_pw_stat_imp_rc[RXS_EM_PW_STAT_REGS] = {
+	0x10, 0x10, 0x10, 0x12, 0x10, 0x12, 0x10, 0x12, 0x14, 0x16, 0x18};
+
 uint32_t rxs_rio_em_get_pw_stat_port(DAR_DEV_INFO_t *dev_info,
 		rio_em_get_pw_stat_in_t *in_parms,
 		rio_em_get_pw_stat_out_t *out_parms, rio_port_t port)
 {
 	uint32_t rc;
-	uint32_t spx_err_det;
-	uint32_t spx_rate_en;
 	uint32_t plm_pws;
 	uint32_t plm_pw_en;
 	uint32_t plm_pw_stat;
@@ -2102,77 +2103,44 @@ uint32_t rxs_rio_em_get_pw_stat_port(DAR_DEV_INFO_t *dev_info,
 	uint32_t pbm_pws;
 	uint32_t pbm_pw_en;
 	uint32_t pbm_pw_stat;
-	uint32_t em_pws;
-	uint32_t em_pw_en;
-	uint32_t rst_pw_en;
 	uint32_t plm_denial_ctl;
 	uint32_t pna_cap;
-
-	rc = DARRegRead(dev_info, RXS_SPX_ERR_DET(port), &spx_err_det);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_INT_STAT(0x10);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_SPX_RATE_EN(port), &spx_rate_en);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_INT_STAT(0x10);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_PLM_SPX_STAT(port), &plm_pws);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_PW_STAT(0x10);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_PLM_SPX_PW_EN(port), &plm_pw_en);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_PW_STAT(0x12);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_TLM_SPX_STAT(port), &tlm_pws);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_PW_STAT(0x10);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_TLM_SPX_PW_EN(port), &tlm_pw_en);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_PW_STAT(0x12);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_PBM_SPX_STAT(port), &pbm_pws);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_PW_STAT(0x10);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_PBM_SPX_PW_EN(port), &pbm_pw_en);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_PW_STAT(0x12);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_EM_RST_PW_EN, &rst_pw_en);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_PW_STAT(0x14);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_EM_PW_STAT, &em_pws);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_PW_STAT(0x16);
-		goto fail;
-	}
-
-	rc = DARRegRead(dev_info, RXS_EM_PW_EN, &em_pw_en);
-	if (RIO_SUCCESS != rc) {
-		out_parms->imp_rc = EM_GET_PW_STAT(0x18);
+	DAR_read_entry_in_t rd_in[RXS_EM_PW_STAT_REGS];
+	DAR_read_entry_out_t rd_out[RXS_EM_PW_STAT_REGS];
+	uint32_t fail_idx = 0;
+
+	rd_in[0].offset = RXS_SPX_ERR_DET(port);
+	rd_in[1].offset = RXS_SPX_RATE_EN(port);
+	rd_in[2].offset = RXS_PLM_SPX_STAT(port);
+	rd_in[3].offset = RXS_PLM_SPX_PW_EN(port);
+	rd_in[4].offset = RXS_TLM_SPX_STAT(port);
+	rd_in[5].offset = RXS_TLM_SPX_PW_EN(port);
+	rd_in[6].offset = RXS_PBM_SPX_STAT(port);
+	rd_in[7].offset = RXS_PBM_SPX_PW_EN(port);
+	rd_in[8].offset = RXS_EM_RST_PW_EN;
+	rd_in[9].offset = RXS_EM_PW_STAT;
+	rd_in[10].offset = RXS_EM_PW_EN;
+
+	rc = rxs_em_read_regs(dev_info, rd_in, rd_out, RXS_EM_PW_STAT_REGS,
+								&fail_idx);
+	if (RIO_SUCCESS != rc) {
+		// Failures to read the port error registers have always
+		// reported interrupt status return codes.
+		if (fail_idx < 2) {
+			out_parms->imp_rc = EM_GET_INT_STAT(
+					rxs_em_pw_stat_imp_rc[fail_idx]);
+		} else {
+			out_parms->imp_rc = EM_GET_PW_STAT(
+					rxs_em_pw_stat_imp_rc[fail_idx]);
+		}
 		goto fail;
 	}
+	plm_pws = rd_out[2].value_read;
+	plm_pw_en = rd_out[3].value_read;
+	tlm_pws = rd_out[4].value_read;
+	tlm_pw_en = rd_out[5].value_read;
+	pbm_pws = rd_out[6].value_read;
+	pbm_pw_en = rd_out[7].value_read;
 
 	plm_pw_stat = plm_pws & (plm_pw_en| RXS_PLM_SPX_UNMASKABLE_MASK);
 	if (plm_pw_stat & RXS_LOS_EVENT_MASK) {
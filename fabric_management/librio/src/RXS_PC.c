@@ -37,6 +37,7 @@
 
 #include "RapidIO_Device_Access_Routines_API.h"
 #include "RapidIO_Port_Config_API.h"
+#include "RapidIO_Utilities_API.h"
 #include "RXS_DeviceDriver.h"
 #include "RXS2448.h"
 
@@ -1520,6 +1521,13 @@ fail:
 	return rc;
 }
 
+// Status registers read for each port by rxs_rio_pc_get_status
+#define RXS_PC_STAT_ERR_STAT 0
+#define RXS_PC_STAT_CTL 1
+#define RXS_PC_STAT_CTL2 2
+#define RXS_PC_STAT_P_CTL 3
+#define RXS_PC_STAT_REGS 4
+
 uint32_t rxs_rio_pc_get_status(DAR_DEV_INFO_t *dev_info,
 		rio_pc_get_status_in_t *in_parms,
 		rio_pc_get_status_out_t *out_parms)
@@ -1531,20 +1539,40 @@ uint32_t rxs_rio_pc_get_status(DAR_DEV_INFO_t *dev_info,
 	rio_pc_one_port_status_t *ps;
 	rio_pc_ls_t ls;
 	bool idle_err = false;
+	DAR_read_entry_in_t rd_in[RXS2448_MAX_PORTS * RXS_PC_STAT_REGS];
+	DAR_read_entry_out_t rd_out[RXS2448_MAX_PORTS * RXS_PC_STAT_REGS];
+	DAR_read_entry_in_t *in;
+	DAR_read_entry_out_t *regs;
+	rio_port_t port;
 
 	out_parms->num_ports = 0;
 	out_parms->imp_rc = RIO_SUCCESS;
 
 	rc = DARrioGetPortList(dev_info, &in_parms->ptl, &good_ptl);
-	if (RIO_SUCCESS != rc) {
+	if ((RIO_SUCCESS != rc) || (good_ptl.num_ports > RXS2448_MAX_PORTS)) {
 		out_parms->imp_rc = PC_GET_STATUS(1);
 		goto exit;
 	}
 
 	out_parms->num_ports = good_ptl.num_ports;
 
+	// Read the status registers of all ports at once.  Return codes
+	// are checked when the values are used.
+	for (port_idx = 0; port_idx < out_parms->num_ports; port_idx++) {
+		port = good_ptl.pnums[port_idx];
+		in = &rd_in[port_idx * RXS_PC_STAT_REGS];
+
+		in[RXS_PC_STAT_ERR_STAT].offset = RXS_SPX_ERR_STAT(port);
+		in[RXS_PC_STAT_CTL].offset = RXS_SPX_CTL(port);
+		in[RXS_PC_STAT_CTL2].offset = RXS_SPX_CTL2(port);
+		in[RXS_PC_STAT_P_CTL].offset = RXS_PLM_SPX_IMP_SPEC_CTL(port);
+	}
+	DAR_multi_reg_read(dev_info, rd_in, rd_out,
+			out_parms->num_ports * RXS_PC_STAT_REGS);
+
 	for (port_idx = 0; port_idx < out_parms->num_ports; port_idx++) {
 		ps = &out_parms->ps[port_idx];
+		regs = &rd_out[port_idx * RXS_PC_STAT_REGS];
 
 		ps->pnum = good_ptl.pnums[port_idx];
 		ps->pw = rio_pc_pw_last;
@@ -1558,18 +1586,19 @@ uint32_t rxs_rio_pc_get_status(DAR_DEV_INFO_t *dev_info,
 
 		// Port is available and powered up,
 		// so let's figure out the status...
-		rc = DARRegRead(dev_info, RXS_SPX_ERR_STAT(ps->pnum),
-								&err_stat);
+		rc = regs[RXS_PC_STAT_ERR_STAT].rc;
 		if (RIO_SUCCESS != rc) {
 			out_parms->imp_rc = PC_GET_STATUS(0x30);
 			goto exit;
 		}
+		err_stat = regs[RXS_PC_STAT_ERR_STAT].value_read;
 
-		rc = DARRegRead(dev_info, RXS_SPX_CTL(ps->pnum), &ctl);
+		rc = regs[RXS_PC_STAT_CTL].rc;
 		if (RIO_SUCCESS != rc) {
 			out_parms->imp_rc = PC_GET_STATUS(0x40);
 			goto exit;
 		}
+		ctl = regs[RXS_PC_STAT_CTL].value_read;
 
 		ps->port_ok = (err_stat & RXS_SPX_ERR_STAT_PORT_OK);
 		ps->input_stopped = (err_stat &
@@ -1589,11 +1618,12 @@ uint32_t rxs_rio_pc_get_status(DAR_DEV_INFO_t *dev_info,
 			continue;
 		}
 
-		rc = DARRegRead(dev_info, RXS_SPX_CTL2(ps->pnum), &ctl2);
+		rc = regs[RXS_PC_STAT_CTL2].rc;
 		if (RIO_SUCCESS != rc) {
 			out_parms->imp_rc = PC_GET_STATUS(0x50);
 			goto exit;
 		}
+		ctl2 = regs[RXS_PC_STAT_CTL2].value_read;
 
 		// Only support RX flow control
 		ps->fc = rio_pc_fc_rx;
@@ -1602,12 +1632,12 @@ uint32_t rxs_rio_pc_get_status(DAR_DEV_INFO_t *dev_info,
 		determine_ls(&ls, ctl2);
 
 		// Determine idle sequence
-		rc = DARRegRead(dev_info, RXS_PLM_SPX_IMP_SPEC_CTL(ps->pnum),
-									&p_ctl);
+		rc = regs[RXS_PC_STAT_P_CTL].rc;
 		if (RIO_SUCCESS != rc) {
 			out_parms->imp_rc = PC_GET_STATUS(0x60);
 			goto exit;
 		}
+		p_ctl = regs[RXS_PC_STAT_P_CTL].value_read;
 
 		idle_err = determine_iseq(&ps->iseq, ls, p_ctl);
 
@@ -66,6 +66,13 @@ extern "C" {
 #define RXS_READ_MC_MASKS(x)                  (RXS_READ_MC_MASKS_0+x)
 #define RXS_READ_RTE_ENTRIES(x)               (RXS_READ_RTE_ENTRIES_0+x)
 
+#define RXS_SET_ALL     true
+#define RXS_SET_CHANGED false
+
+static uint32_t rxs_rt_set_common(DAR_DEV_INFO_t *dev_info,
+		rio_rt_set_all_in_t *in_parms, rio_rt_set_all_out_t *out_parms,
+		bool set_all, bool set_dflt);
+
 void rxs_chk_and_corr_rtv(DAR_DEV_INFO_t *dev_info, rio_rt_uc_info_t *rtv,
 					bool dom_value, bool dflt_port)
 {
@@ -226,7 +233,8 @@ uint32_t rxs_rio_rt_initialize(DAR_DEV_INFO_t *dev_info,
 	}
 
 	if (in_parms->update_hw) {
-		rc = rxs_rio_rt_set_changed(dev_info, &all_in, &all_out);
+		rc = rxs_rt_set_common(dev_info, &all_in, &all_out,
+				RXS_SET_CHANGED, true);
 	} else {
 		rc = RIO_SUCCESS;
 	}
@@ -331,22 +339,73 @@ exit:
 	return rc;
 }
 
+// Writes the changed entries of one routing table, combining runs of
+// consecutive changed entries into block writes.
+static uint32_t rxs_program_rte_table(DAR_DEV_INFO_t *dev_info,
+		rio_rt_uc_info_t *table, uint32_t base, bool dev_table,
+		bool set_all, uint32_t *imp_rc)
+{
+	uint32_t rc = RIO_SUCCESS;
+	uint32_t vals[RIO_RT_GRP_SZ];
+	uint16_t rte_num, first, cnt;
+
+	rte_num = 0;
+	while (rte_num < RIO_RT_GRP_SZ) {
+		if (!(table[rte_num].changed || set_all)) {
+			rte_num++;
+			continue;
+		}
+
+		first = rte_num;
+		while ((rte_num < RIO_RT_GRP_SZ)
+				&& (table[rte_num].changed || set_all)) {
+			// Validate value to be programmed.
+			if (dev_table
+				&& RIO_RTV_IS_LVL_GRP(table[rte_num].rte_val)) {
+				rc = RIO_ERR_INVALID_PARAMETER;
+				*imp_rc = RXS_PROGRAM_RTE_ENTRIES(3);
+				goto exit;
+			}
+			vals[rte_num - first] = table[rte_num].rte_val;
+			rte_num++;
+		}
+		cnt = rte_num - first;
+
+		rc = DARRegWriteBlock(dev_info, DEV_RTE_ADDR(base, first), cnt,
+				vals);
+		if (RIO_SUCCESS != rc) {
+			*imp_rc = RXS_PROGRAM_RTE_ENTRIES(dev_table ? 4 : 2);
+			goto exit;
+		}
+		while (first < rte_num) {
+			table[first++].changed = false;
+		}
+	}
+
+exit:
+	return rc;
+}
+
 static uint32_t rxs_program_rte_entries(DAR_DEV_INFO_t *dev_info,
 		rio_rt_set_all_in_t *in_parms,
 		bool set_all, // true if all entries should be set
+		bool set_dflt, // true if the default route should be set
 		uint32_t *imp_rc)
 {
 	uint32_t rc = RIO_SUCCESS;
 	// Note that the base address for RXS2448 and RXS1632
 	// are all the same.
-	uint16_t rte_num;
 	uint32_t dev_rte_base, dom_rte_base;
 
-	rc = DARRegWrite(dev_info, RXS_ROUTE_DFLT_PORT,
-			in_parms->rt->default_route);
-	if (RIO_SUCCESS != rc) {
-		*imp_rc = RXS_PROGRAM_RTE_ENTRIES(0x10);
-		goto exit;
+	// The default route can only change through rio_rt_initialize,
+	// which sets it.  Do not rewrite it for every set_changed call.
+	if (set_all || set_dflt) {
+		rc = DARRegWrite(dev_info, RXS_ROUTE_DFLT_PORT,
+				in_parms->rt->default_route);
+		if (RIO_SUCCESS != rc) {
+			*imp_rc = RXS_PROGRAM_RTE_ENTRIES(0x10);
+			goto exit;
+		}
 	}
 
 	if (RIO_ALL_PORTS == in_parms->set_on_port) {
@@ -359,50 +418,22 @@ static uint32_t rxs_program_rte_entries(DAR_DEV_INFO_t *dev_info,
 				in_parms->set_on_port, 0, 0);
 	}
 
-	for (rte_num = 0; rte_num < RIO_RT_GRP_SZ; rte_num++) {
-		if (in_parms->rt->dom_table[rte_num].changed || set_all) {
-			rc = DARRegWrite(dev_info,
-				DOM_RTE_ADDR( dom_rte_base, rte_num),
-				in_parms->rt->dom_table[rte_num].rte_val);
-			if (RIO_SUCCESS != rc) {
-				*imp_rc = RXS_PROGRAM_RTE_ENTRIES(2);
-				goto exit;
-			}
-			in_parms->rt->dom_table[rte_num].changed = false;
-		}
-	}
-
-	for (rte_num = 0; rte_num < RIO_RT_GRP_SZ; rte_num++) {
-		if (in_parms->rt->dev_table[rte_num].changed || set_all) {
-			// Validate value to be programmed.
-			if (RIO_RTV_IS_LVL_GRP(
-				in_parms->rt->dev_table[rte_num].rte_val)) {
-				rc = RIO_ERR_INVALID_PARAMETER;
-				*imp_rc = RXS_PROGRAM_RTE_ENTRIES(3);
-				goto exit;
-			}
-
-			rc = DARRegWrite(dev_info,
-				DEV_RTE_ADDR( dev_rte_base, rte_num),
-				in_parms->rt->dev_table[rte_num].rte_val);
-			if (RIO_SUCCESS != rc) {
-				*imp_rc = RXS_PROGRAM_RTE_ENTRIES(4);
-				goto exit;
-			}
-			in_parms->rt->dev_table[rte_num].changed = false;
-		}
+	rc = rxs_program_rte_table(dev_info, in_parms->rt->dom_table,
+			dom_rte_base, false, set_all, imp_rc);
+	if (RIO_SUCCESS != rc) {
+		goto exit;
 	}
 
+	rc = rxs_program_rte_table(dev_info, in_parms->rt->dev_table,
+			dev_rte_base, true, set_all, imp_rc);
 exit:
 	return rc;
 }
 
-#define RXS_SET_ALL     true
-#define RXS_SET_CHANGED false
-
 static uint32_t rxs_rt_set_common(DAR_DEV_INFO_t *dev_info,
 		rio_rt_set_all_in_t *in_parms, rio_rt_set_all_out_t *out_parms,
-		bool set_all) // true if all entries should be set
+		bool set_all, // true if all entries should be set
+		bool set_dflt) // true if the default route should be set
 {
 	uint32_t rc = RIO_ERR_INVALID_PARAMETER;
 
@@ -431,7 +462,7 @@ static uint32_t rxs_rt_set_common(DAR_DEV_INFO_t *dev_info,
 		goto exit;
 	}
 
-	rc = rxs_program_rte_entries(dev_info, in_parms, set_all,
+	rc = rxs_program_rte_entries(dev_info, in_parms, set_all, set_dflt,
 			&out_parms->imp_rc);
 exit:
 	return rc;
@@ -440,14 +471,16 @@ exit:
 uint32_t rxs_rio_rt_set_all(DAR_DEV_INFO_t *dev_info,
 		rio_rt_set_all_in_t *in_parms, rio_rt_set_all_out_t *out_parms)
 {
-	return rxs_rt_set_common(dev_info, in_parms, out_parms, RXS_SET_ALL);
+	return rxs_rt_set_common(dev_info, in_parms, out_parms, RXS_SET_ALL,
+			true);
 }
 
 uint32_t rxs_rio_rt_set_changed(DAR_DEV_INFO_t *dev_info,
 		rio_rt_set_changed_in_t *in_parms,
 		rio_rt_set_changed_out_t *out_parms)
 {
-	return rxs_rt_set_common(dev_info, in_parms, out_parms, RXS_SET_CHANGED);
+	return rxs_rt_set_common(dev_info, in_parms, out_parms,
+			RXS_SET_CHANGED, false);
 }
 
 static void rxs_check_multicast_routing(DAR_DEV_INFO_t *dev_info,
@@ -502,7 +535,7 @@ static void rxs_check_multicast_routing(DAR_DEV_INFO_t *dev_info,
 	}
 }
 
-static void rxs_check_routing(DAR_DEV_INFO_t *dev_info,
+void rxs_rio_rt_check_routing(DAR_DEV_INFO_t *dev_info,
 		rio_rt_probe_in_t *in_parms,
 		rio_rt_probe_out_t *out_parms)
 {
@@ -726,6 +759,7 @@ static uint32_t rxs_check_for_discard(DAR_DEV_INFO_t *dev_info,
 	rio_port_t port;
 	pe_rt_val rte = out_parms->routing_table_value;
 	bool dflt_port = false;
+	rio_rt_disc_reason_t reason = rio_rt_disc_not;
 
 	if (RIO_RTE_DFLT_PORT == rte) {
 		rte = out_parms->default_route;
@@ -747,7 +781,9 @@ static uint32_t rxs_check_for_discard(DAR_DEV_INFO_t *dev_info,
 			continue;
 		}
 
+		// Each port is checked independently of the ports before it
 		out_parms->valid_route = true;
+		out_parms->reason_for_discard = rio_rt_disc_not;
 		rc = rxs_check_port_for_discard(dev_info, out_parms,
 						port, false);
 		if (rc) {
@@ -755,6 +791,7 @@ static uint32_t rxs_check_for_discard(DAR_DEV_INFO_t *dev_info,
 		}
 		if (!out_parms->valid_route) {
 			out_parms->mcast_ports[port] = false;
+			reason = out_parms->reason_for_discard;
 		}
 	}
 
@@ -767,6 +804,13 @@ static uint32_t rxs_check_for_discard(DAR_DEV_INFO_t *dev_info,
 		out_parms->valid_route = true;
 		break;
 	}
+
+	// Report the reason the last port was removed from the mask
+	// when no ports remain.
+	if (!rc) {
+		out_parms->reason_for_discard = (out_parms->valid_route) ?
+						rio_rt_disc_not : reason;
+	}
 	return rc;
 }
 
@@ -823,7 +867,7 @@ uint32_t rxs_rio_rt_probe(DAR_DEV_INFO_t *dev_info,
 	rc = RIO_SUCCESS;
 	out_parms->default_route = in_parms->rt->default_route;
 
-	rxs_check_routing(dev_info, in_parms, out_parms);
+	rxs_rio_rt_check_routing(dev_info, in_parms, out_parms);
 
 	if (out_parms->valid_route) {
 		rc = rxs_check_for_discard(dev_info, in_parms, out_parms);
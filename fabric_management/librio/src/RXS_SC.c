@@ -36,6 +36,7 @@
 
 #include "RapidIO_Device_Access_Routines_API.h"
 #include "RapidIO_Statistics_Counter_API.h"
+#include "RapidIO_Utilities_API.h"
 #include "RXS2448.h"
 #include "src/RXS_DeviceDriver.h"
 
@@ -45,53 +46,8 @@ extern "C" {
 
 #ifdef RXS_DAR_WANTED
 
-static uint32_t rxs_read_ctrs(DAR_DEV_INFO_t *dev_info,
-		rio_sc_read_ctrs_in_t *in_parms,
-		rio_sc_read_ctrs_out_t *out_parms, int srch_i,
-		rio_port_t port_num)
-{
-	int cntr;
-	uint32_t count;
-	uint64_t l_c; // last counter value
-	uint64_t c_c; // current counter value
-	uint64_t tot; // new total counter value
-	rio_sc_ctr_val_t *counter;
-	uint32_t rc;
-
-	for (cntr = 0; cntr < RXS2448_MAX_SC; cntr++) {
-		counter = &in_parms->dev_ctrs->p_ctrs[srch_i].ctrs[cntr];
-		if (rio_sc_disabled == counter->sc) {
-			continue;
-		}
-
-		rc = DARRegRead(dev_info, RXS_SPX_PCNTR_CNT(port_num, cntr),
-				&count);
-		if (RIO_SUCCESS != rc) {
-			out_parms->imp_rc = SC_READ_RXS_CTRS(0x71 + cntr);
-			goto exit;
-		}
-		c_c = count;
-		l_c = counter->total & (uint64_t)0x00000000FFFFFFFF;
-		tot = counter->total & (uint64_t)0xFFFFFFFF00000000;
-		tot |= c_c;
-
-		// If the counter has wrapped, increment tot by 1.
-		//
-		// Note: if c_c and l_c are equal, assume that the
-		// counter has not changed since it was last read.
-		if (l_c > c_c) {
-			tot += (uint64_t)0x0000000100000000;
-			c_c |= (uint64_t)0x0000000100000000;
-		}
-		counter->last_inc = c_c - l_c;
-		counter->total = tot;
-	}
-	rc = RIO_SUCCESS;
-
-exit:
-	return rc;
-}
-
+// Largest number of counters read by one call to rxs_rio_sc_read_ctrs
+#define RXS_SC_MAX_RD (RIO_MAX_PORTS * RXS2448_MAX_SC)
 
 /* Configure counters on selected ports of a
  * RXS device.
@@ -364,9 +320,16 @@ uint32_t rxs_rio_sc_read_ctrs(DAR_DEV_INFO_t *dev_info,
 		rio_sc_read_ctrs_out_t *out_parms)
 {
 	uint32_t rc = RIO_ERR_INVALID_PARAMETER;
-	uint8_t srch_i, srch_p, port_num;
+	uint8_t srch_i, srch_p, port_num, cntr;
 	bool found;
 	struct DAR_ptl good_ptl;
+	rio_sc_ctr_val_t *counter;
+	DAR_read_entry_in_t rd_in[RXS_SC_MAX_RD];
+	DAR_read_entry_out_t rd_out[RXS_SC_MAX_RD];
+	rio_sc_ctr_val_t *rd_ctr[RXS_SC_MAX_RD];
+	uint8_t rd_cntr[RXS_SC_MAX_RD];
+	uint32_t rd_cnt = 0;
+	uint32_t fail;
 
 	out_parms->imp_rc = RIO_SUCCESS;
 
@@ -404,19 +367,31 @@ uint32_t rxs_rio_sc_read_ctrs(DAR_DEV_INFO_t *dev_info,
 		goto exit;
 	}
 
+	// Collect the enabled counters of all ports, so that they are read
+	// with one DAR_multi_reg_read.  The counters of a port are
+	// contiguous, so each port is read with one block read.
 	for (srch_p = 0; srch_p < good_ptl.num_ports; srch_p++) {
 		port_num = good_ptl.pnums[srch_p];
 		found = false;
 		for (srch_i = 0; srch_i < in_parms->dev_ctrs->valid_p_ctrs;
 				srch_i++) {
 			if (in_parms->dev_ctrs->p_ctrs[srch_i].pnum
-					== port_num) {
-				found = true;
-				rc = rxs_read_ctrs(dev_info, in_parms,
-						out_parms, srch_i, port_num);
-				if (RIO_SUCCESS != rc) {
-					goto exit;
+					!= port_num) {
+				continue;
+			}
+			found = true;
+			for (cntr = 0; cntr < RXS2448_MAX_SC; cntr++) {
+				counter = &in_parms->dev_ctrs->p_ctrs[srch_i]
+								.ctrs[cntr];
+				if ((rio_sc_disabled == counter->sc)
+						|| (RXS_SC_MAX_RD == rd_cnt)) {
+					continue;
 				}
+				rd_in[rd_cnt].offset = RXS_SPX_PCNTR_CNT(
+							port_num, cntr);
+				rd_ctr[rd_cnt] = counter;
+				rd_cntr[rd_cnt] = cntr;
+				rd_cnt++;
 			}
 		}
 		if (!found) {
@@ -425,6 +400,14 @@ uint32_t rxs_rio_sc_read_ctrs(DAR_DEV_INFO_t *dev_info,
 			goto exit;
 		}
 	}
+
+	DAR_multi_reg_read(dev_info, rd_in, rd_out, rd_cnt);
+	fail = rio_sc_accum_ctrs(rd_ctr, rd_out, rd_cnt, true);
+	if (fail < rd_cnt) {
+		rc = rd_out[fail].rc;
+		out_parms->imp_rc = SC_READ_RXS_CTRS(0x71 + rd_cntr[fail]);
+		goto exit;
+	}
 	rc = RIO_SUCCESS;
 
 exit:
@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdint.h>
 #include <stddef.h>
+#include <pthread.h>
 
 #include "Tsi57x_API.h"
 #include "Tsi721_API.h"
@@ -65,6 +66,14 @@ uint32_t (*ReadReg) (DAR_DEV_INFO_t *dev_info, uint32_t offset,
 uint32_t (*WriteReg) (DAR_DEV_INFO_t *dev_info, uint32_t  offset,
 						uint32_t  writedata );
 void (*WaitSec)(uint32_t delay_nsec, uint32_t delay_sec);
+uint32_t (*WriteRegBlock)(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+						uint32_t cnt, uint32_t *writedata);
+uint32_t (*ReadRegBlock)(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+						uint32_t cnt, uint32_t *readdata);
+
+// Register writes and reads performed by the calling thread
+static __thread DAR_wr_stats_t dar_wr_stats;
+static __thread DAR_rd_stats_t dar_rd_stats;
 
 rio_driver_family_t rio_get_driver_family(uint32_t devID);
 
@@ -120,6 +129,10 @@ uint32_t DARRegRead(DAR_DEV_INFO_t *dev_info, uint32_t offset,
 	}
 	//@sonar:on
 
+	if (RIO_SUCCESS == rc) {
+		dar_rd_stats.reg_rd++;
+		dar_rd_stats.blk_rd++;
+	}
 	return rc;
 }
 
@@ -171,6 +184,8 @@ uint32_t DARRegWrite(DAR_DEV_INFO_t *dev_info, uint32_t offset,
 	if (RIO_SUCCESS != rc) {
 		return rc;
 	}
+	dar_wr_stats.reg_wr++;
+	dar_wr_stats.blk_wr++;
 
 	// If this is a performance optimization register,
 	// update the cached value.
@@ -182,6 +197,116 @@ uint32_t DARRegWrite(DAR_DEV_INFO_t *dev_info, uint32_t offset,
 	return rc;
 }
 
+uint32_t DARDB_ReadRegBlock(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *readdata, uint32_t *done)
+{
+	uint32_t rc = RIO_SUCCESS;
+	uint32_t i, idx;
+
+	*done = 0;
+	if (!VALIDATE_DEV_INFO(dev_info)) {
+		return DAR_DB_INVALID_HANDLE;
+	}
+
+	if (RIO_UNITIALIZED_DEVICE == dev_info->driver_family) {
+		dev_info->driver_family = rio_get_driver_family(dev_info->devID);
+	}
+
+	// As for writes, only devices accessed directly through ReadReg
+	// use blocks.
+	if ((NULL == ReadRegBlock) || (cnt < 2)
+			|| ((RIO_RXS_DEVICE != dev_info->driver_family)
+				&& (RIO_CPS_DEVICE != dev_info->driver_family))) {
+		for (i = 0; i < cnt; i++) {
+			rc = DARRegRead(dev_info, offset + (4 * i),
+					&readdata[i]);
+			if (RIO_SUCCESS != rc) {
+				break;
+			}
+		}
+		*done = i;
+		return rc;
+	}
+
+	rc = ReadRegBlock(dev_info, offset, cnt, readdata);
+	if (RIO_SUCCESS != rc) {
+		return rc;
+	}
+	*done = cnt;
+	dar_rd_stats.reg_rd += cnt;
+	dar_rd_stats.blk_rd++;
+
+	// Performance optimization registers return their cached values,
+	// as DARRegRead does.
+	for (i = 0; i < cnt; i++) {
+		idx = DAR_get_poreg_idx(dev_info, offset + (4 * i));
+		if (DAR_POREG_BAD_IDX != idx) {
+			readdata[i] = dev_info->poregs[idx].data;
+		}
+	}
+	return rc;
+}
+
+uint32_t DARRegReadBlock(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *readdata)
+{
+	uint32_t done;
+
+	return DARDB_ReadRegBlock(dev_info, offset, cnt, readdata, &done);
+}
+
+uint32_t DARRegWriteBlock(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *writedata)
+{
+	uint32_t rc = RIO_SUCCESS;
+	uint32_t i, idx;
+
+	if (!VALIDATE_DEV_INFO(dev_info)) {
+		return DAR_DB_INVALID_HANDLE;
+	}
+
+	if (RIO_UNITIALIZED_DEVICE == dev_info->driver_family) {
+		dev_info->driver_family = rio_get_driver_family(dev_info->devID);
+	}
+
+	// Tsi57x and Tsi721 register writes need device specific handling,
+	// so only devices accessed directly through WriteReg use blocks.
+	if ((NULL == WriteRegBlock) || (cnt < 2)
+			|| ((RIO_RXS_DEVICE != dev_info->driver_family)
+				&& (RIO_CPS_DEVICE != dev_info->driver_family))) {
+		for (i = 0; (i < cnt) && (RIO_SUCCESS == rc); i++) {
+			rc = DARRegWrite(dev_info, offset + (4 * i),
+					writedata[i]);
+		}
+		return rc;
+	}
+
+	rc = WriteRegBlock(dev_info, offset, cnt, writedata);
+	if (RIO_SUCCESS != rc) {
+		return rc;
+	}
+	dar_wr_stats.reg_wr += cnt;
+	dar_wr_stats.blk_wr++;
+
+	for (i = 0; i < cnt; i++) {
+		idx = DAR_get_poreg_idx(dev_info, offset + (4 * i));
+		if (DAR_POREG_BAD_IDX != idx) {
+			dev_info->poregs[idx].data = writedata[i];
+		}
+	}
+	return rc;
+}
+
+void DAR_get_wr_stats(DAR_wr_stats_t *stats)
+{
+	*stats = dar_wr_stats;
+}
+
+void DAR_get_rd_stats(DAR_rd_stats_t *stats)
+{
+	*stats = dar_rd_stats;
+}
+
 uint32_t DAR_add_poreg(DAR_DEV_INFO_t *dev_info, uint32_t oset, uint32_t data)
 {
 	if (NULL == dev_info) {
@@ -236,6 +361,26 @@ uint32_t DAR_proc_ptr_init(
 	return RIO_SUCCESS;
 }
 
+uint32_t DAR_blk_proc_ptr_init(
+		uint32_t (*WriteRegBlockCall)(DAR_DEV_INFO_t *dev_info,
+				uint32_t offset, uint32_t cnt,
+				uint32_t *writedata))
+{
+	WriteRegBlock = WriteRegBlockCall;
+
+	return RIO_SUCCESS;
+}
+
+uint32_t DAR_blk_rd_proc_ptr_init(
+		uint32_t (*ReadRegBlockCall)(DAR_DEV_INFO_t *dev_info,
+				uint32_t offset, uint32_t cnt,
+				uint32_t *readdata))
+{
+	ReadRegBlock = ReadRegBlockCall;
+
+	return RIO_SUCCESS;
+}
+
 rio_driver_family_t rio_get_driver_family(uint32_t devID)
 {
 	uint16_t vend_code = (uint16_t)(devID & RIO_DEV_IDENT_VEND);
@@ -1049,6 +1194,194 @@ exit:
 }
 
 
+// Extended feature layout cache, see DAR_ef_cache_enable.
+#define DAR_EF_CACHE_SIZE 16
+
+typedef struct DAR_ef_cache_entry_t_TAG {
+	// Identity of the device type
+	uint32_t devID;
+	uint32_t devInfo;
+	uint32_t assyInfo;
+
+	// First extended feature block header, used to validate the entry
+	uint32_t efb_hdr;
+
+	uint32_t features;
+	uint32_t swRtInfo;
+	uint32_t srcOps;
+	uint32_t dstOps;
+	uint32_t swMcastInfo;
+
+	uint32_t extFPtrForPort;
+	uint32_t extFPtrPortType;
+	uint32_t extFPtrForLane;
+	uint32_t extFPtrForErr;
+	uint32_t extFPtrForVC;
+	uint32_t extFPtrForVOQ;
+	uint32_t extFPtrForRT;
+	uint32_t extFPtrForTS;
+	uint32_t extFPtrForMISC;
+	uint32_t extFPtrForHS;
+} DAR_ef_cache_entry_t;
+
+static pthread_mutex_t dar_ef_mtx = PTHREAD_MUTEX_INITIALIZER;
+static bool dar_ef_enable = true;
+static DAR_ef_cache_entry_t dar_ef_cache[DAR_EF_CACHE_SIZE];
+static uint32_t dar_ef_cnt;
+static uint32_t dar_ef_next;
+static DAR_ef_cache_stats_t dar_ef_stats;
+
+void DAR_ef_cache_enable(bool enable)
+{
+	pthread_mutex_lock(&dar_ef_mtx);
+	dar_ef_enable = enable;
+	pthread_mutex_unlock(&dar_ef_mtx);
+}
+
+void DAR_ef_cache_clear(void)
+{
+	pthread_mutex_lock(&dar_ef_mtx);
+	dar_ef_cnt = 0;
+	dar_ef_next = 0;
+	dar_ef_stats.hits = 0;
+	dar_ef_stats.misses = 0;
+	pthread_mutex_unlock(&dar_ef_mtx);
+}
+
+void DAR_get_ef_cache_stats(DAR_ef_cache_stats_t *stats)
+{
+	pthread_mutex_lock(&dar_ef_mtx);
+	*stats = dar_ef_stats;
+	pthread_mutex_unlock(&dar_ef_mtx);
+}
+
+// Copies the cache entry for the device type of dev_info to entry.
+// Returns false if there is no entry, or the cache is disabled.
+static bool DAR_ef_cache_find(DAR_DEV_INFO_t *dev_info,
+		DAR_ef_cache_entry_t *entry)
+{
+	bool found = false;
+	uint32_t idx;
+
+	pthread_mutex_lock(&dar_ef_mtx);
+	for (idx = 0; dar_ef_enable && (idx < dar_ef_cnt); idx++) {
+		if ((dar_ef_cache[idx].devID == dev_info->devID)
+				&& (dar_ef_cache[idx].devInfo
+						== dev_info->devInfo)
+				&& (dar_ef_cache[idx].assyInfo
+						== dev_info->assyInfo)) {
+			*entry = dar_ef_cache[idx];
+			found = true;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&dar_ef_mtx);
+	return found;
+}
+
+static void DAR_ef_cache_get(DAR_DEV_INFO_t *dev_info,
+		DAR_ef_cache_entry_t *entry)
+{
+	dev_info->features = entry->features;
+	dev_info->swRtInfo = entry->swRtInfo;
+	dev_info->srcOps = entry->srcOps;
+	dev_info->dstOps = entry->dstOps;
+	dev_info->swMcastInfo = entry->swMcastInfo;
+	dev_info->extFPtrForPort = entry->extFPtrForPort;
+	dev_info->extFPtrPortType = entry->extFPtrPortType;
+	dev_info->extFPtrForLane = entry->extFPtrForLane;
+	dev_info->extFPtrForErr = entry->extFPtrForErr;
+	dev_info->extFPtrForVC = entry->extFPtrForVC;
+	dev_info->extFPtrForVOQ = entry->extFPtrForVOQ;
+	dev_info->extFPtrForRT = entry->extFPtrForRT;
+	dev_info->extFPtrForTS = entry->extFPtrForTS;
+	dev_info->extFPtrForMISC = entry->extFPtrForMISC;
+	dev_info->extFPtrForHS = entry->extFPtrForHS;
+}
+
+// Adds or replaces the cache entry for the device type of dev_info.
+// When the cache is full, the oldest entry is replaced.
+static void DAR_ef_cache_put(DAR_DEV_INFO_t *dev_info, uint32_t efb_hdr)
+{
+	DAR_ef_cache_entry_t *entry = NULL;
+	uint32_t idx;
+
+	pthread_mutex_lock(&dar_ef_mtx);
+	if (!dar_ef_enable) {
+		goto unlock;
+	}
+	dar_ef_stats.misses++;
+
+	for (idx = 0; idx < dar_ef_cnt; idx++) {
+		if ((dar_ef_cache[idx].devID == dev_info->devID)
+				&& (dar_ef_cache[idx].devInfo
+						== dev_info->devInfo)
+				&& (dar_ef_cache[idx].assyInfo
+						== dev_info->assyInfo)) {
+			entry = &dar_ef_cache[idx];
+			break;
+		}
+	}
+	if (NULL == entry) {
+		if (dar_ef_cnt < DAR_EF_CACHE_SIZE) {
+			entry = &dar_ef_cache[dar_ef_cnt++];
+		} else {
+			entry = &dar_ef_cache[dar_ef_next];
+			dar_ef_next = (dar_ef_next + 1) % DAR_EF_CACHE_SIZE;
+		}
+	}
+
+	entry->devID = dev_info->devID;
+	entry->devInfo = dev_info->devInfo;
+	entry->assyInfo = dev_info->assyInfo;
+	entry->efb_hdr = efb_hdr;
+	entry->features = dev_info->features;
+	entry->swRtInfo = dev_info->swRtInfo;
+	entry->srcOps = dev_info->srcOps;
+	entry->dstOps = dev_info->dstOps;
+	entry->swMcastInfo = dev_info->swMcastInfo;
+	entry->extFPtrForPort = dev_info->extFPtrForPort;
+	entry->extFPtrPortType = dev_info->extFPtrPortType;
+	entry->extFPtrForLane = dev_info->extFPtrForLane;
+	entry->extFPtrForErr = dev_info->extFPtrForErr;
+	entry->extFPtrForVC = dev_info->extFPtrForVC;
+	entry->extFPtrForVOQ = dev_info->extFPtrForVOQ;
+	entry->extFPtrForRT = dev_info->extFPtrForRT;
+	entry->extFPtrForTS = dev_info->extFPtrForTS;
+	entry->extFPtrForMISC = dev_info->extFPtrForMISC;
+	entry->extFPtrForHS = dev_info->extFPtrForHS;
+unlock:
+	pthread_mutex_unlock(&dar_ef_mtx);
+}
+
+// Reads the first extended feature block header of the device, and uses
+// the cached layout if the header matches the cached header.
+static bool DAR_ef_cache_use(DAR_DEV_INFO_t *dev_info)
+{
+	DAR_ef_cache_entry_t entry;
+	uint32_t efb_ptr = dev_info->assyInfo & RIO_ASSY_INF_EFB_PTR;
+	uint32_t efb_hdr = 0;
+
+	if (!DAR_ef_cache_find(dev_info, &entry)) {
+		return false;
+	}
+
+	if ((entry.features & RIO_PE_FEAT_EFB_VALID) && efb_ptr) {
+		if (RIO_SUCCESS != ReadReg(dev_info, efb_ptr, &efb_hdr)) {
+			return false;
+		}
+		if (efb_hdr != entry.efb_hdr) {
+			return false;
+		}
+	}
+
+	DAR_ef_cache_get(dev_info, &entry);
+	pthread_mutex_lock(&dar_ef_mtx);
+	dar_ef_stats.hits++;
+	pthread_mutex_unlock(&dar_ef_mtx);
+	return true;
+}
+
 /* The dev_info->devID field must be valid when this routine is called.
 
    Default driver for a device is the DARDB_ routines defined above.
@@ -1062,6 +1395,7 @@ exit:
 uint32_t DARDB_rioDeviceSupported(DAR_DEV_INFO_t *dev_info)
 {
 	uint32_t rc;
+	uint32_t efb_hdr = 0;
 
 	/* The reading devID should be unnecessary,
 	 but it should not hurt to do so here.
@@ -1081,6 +1415,13 @@ uint32_t DARDB_rioDeviceSupported(DAR_DEV_INFO_t *dev_info)
 	if (RIO_SUCCESS != rc)
 		return rc;
 
+	if (DAR_ef_cache_use(dev_info)) {
+		rc = ReadReg(dev_info, RIO_SW_PORT_INF, &dev_info->swPortInfo);
+		if (!dev_info->swPortInfo)
+			dev_info->swPortInfo = 0x00000100;
+		return rc;
+	}
+
 	rc = ReadReg(dev_info, RIO_PE_FEAT, &dev_info->features);
 	if (RIO_SUCCESS != rc) {
 		return rc;
@@ -1132,6 +1473,10 @@ uint32_t DARDB_rioDeviceSupported(DAR_DEV_INFO_t *dev_info)
 			if (RIO_SUCCESS != rc) {
 				return rc;
 			}
+			if (prev_addr == (dev_info->assyInfo
+						& RIO_ASSY_INF_EFB_PTR)) {
+				efb_hdr = curr_ext_feat;
+			}
 
 			switch (curr_ext_feat & RIO_EFB_T) {
 			case RIO_EFB_T_SP_EP:
@@ -1189,6 +1534,10 @@ uint32_t DARDB_rioDeviceSupported(DAR_DEV_INFO_t *dev_info)
 			prev_addr = curr_ext_feat >> 16;
 		}
 	}
+
+	if (RIO_SUCCESS == rc) {
+		DAR_ef_cache_put(dev_info, efb_hdr);
+	}
 	return rc;
 }
 
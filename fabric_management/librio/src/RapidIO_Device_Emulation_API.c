@@ -0,0 +1,1051 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+/* Register level device emulation
+ *
+ * Register values are kept in an open addressing hash table indexed by
+ * register offset, so only registers which differ from zero use memory.
+ * Offsets are always 4 byte aligned, which leaves odd keys free for state
+ * which is not visible at a register offset, such as the Tsi57x routing
+ * table entries.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+#include "RapidIO_Device_Access_Routines_API.h"
+#include "RapidIO_Device_Emulation_API.h"
+#include "RXS2448.h"
+#include "CPS1848.h"
+#include "Tsi578.h"
+#include "Tsi721.h"
+#include "rio_standard.h"
+#include "rio_ecosystem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EMU_MAX_PORTS 24
+#define EMU_NO_KEY 0xFFFFFFFF
+#define EMU_MIN_SLOTS 1024
+#define EMU_CAR_END 0x40
+
+#define EMU_TSI57X_RTE_KEY(p, idx) \
+	((((uint32_t)(p)) << 20) | (((idx) & 0xFFFF) << 2) | 1)
+#define EMU_TSI57X_RTE_DFLT 0xFF
+#define EMU_TSI57X_DESTID_IDX (TSI578_SPX_ROUTE_CFG_DESTID_CFG_DEST_ID \
+			| TSI578_SPX_ROUTE_CFG_DESTID_LRG_CFG_DEST_ID)
+
+#define EMU_SPX_CTL_RST (RIO_SPX_CTL_PTW_MAX_4X | RIO_SPX_CTL_PTW_INIT_4X \
+			| RIO_SPX_CTL_INP_EN | RIO_SPX_CTL_OTP_EN)
+#define EMU_SPX_CTL_RST_2X (RIO_SPX_CTL_PTW_MAX_2X | RIO_SPX_CTL_PTW_INIT_2X \
+			| RIO_SPX_CTL_INP_EN | RIO_SPX_CTL_OTP_EN)
+
+typedef struct emu_reg_t_TAG {
+	uint32_t offset;
+	uint32_t val;
+} emu_reg_t;
+
+// A write to a broadcast register at bc + X writes port_base + X for
+// every port.
+typedef struct emu_bcast_t_TAG {
+	uint32_t bc;
+	uint32_t size;
+	uint32_t port_base;
+	uint32_t port_step;
+} emu_bcast_t;
+
+typedef struct emu_model_info_t_TAG {
+	const char *name;
+	uint8_t ports;
+
+	// Capability registers
+	uint32_t dev_ident;
+	uint32_t assy_inf;
+	uint32_t pe_feat;
+	uint32_t sw_port_inf;
+	uint32_t src_ops;
+	uint32_t dst_ops;
+	uint32_t sw_rt_tbl_lim;
+	uint32_t sw_mc_inf;
+
+	// Extended features blocks, in chain order.  Unused blocks are 0.
+	uint32_t ef_port;
+	uint32_t ef_port_type;
+	uint32_t ef_err;
+	uint32_t ef_lane;
+	uint32_t ef_rt;
+
+	// Reset value of each port's control 2 register, which selects the
+	// lane speed
+	uint32_t spx_ctl2;
+
+	// Ports have 2 lanes after reset, rather than 4
+	bool ports_2x;
+
+	const emu_reg_t *rst_regs;
+	uint32_t rst_cnt;
+	const emu_bcast_t *bcast;
+	uint32_t bcast_cnt;
+
+	// Multicast mask set/clear registers
+	bool rxs_mc;
+
+	// Indirect routing table access
+	bool tsi57x_rt;
+} emu_model_info_t;
+
+static const emu_reg_t rxs_rst_regs[] = {
+	{RXS_PRESCALAR_SRV_CLK, 38},
+	{RXS_MPM_CFGSIG0, RXS_MPM_CFGSIG0_CORECLK_SELECT_LO_PWR_12G
+			| RXS_MPM_CFGSIG0_REFCLK_SELECT_156P25MHZ},
+};
+
+static const emu_bcast_t rxs_bcast[] = {
+	{RXS_BC_L0_G0_ENTRYX_CSR(0), 0x400, RXS_SPX_L0_G0_ENTRYY_CSR(0, 0),
+			0x2000},
+	{RXS_BC_L1_GX_ENTRYY_CSR(0, 0), 0x400, RXS_SPX_L1_GY_ENTRYZ_CSR(0, 0,
+			0), 0x2000},
+	{RXS_BC_L2_GX_ENTRYY_CSR(0, 0), 0x400, RXS_SPX_L2_GY_ENTRYZ_CSR(0, 0,
+			0), 0x2000},
+};
+
+// All MACs are strapped for four 1x ports
+#define EMU_TSI578_1X_MODE(mac) {TSI578_SMACX_DLOOP_CLK_SEL((mac) * 2), \
+			TSI578_SMACX_DLOOP_CLK_SEL_MAC_MODE}
+
+static const emu_reg_t tsi578_rst_regs[] = {
+	{TSI578_RIO_LUT_ATTR, EMU_TSI57X_RTE_DFLT},
+	EMU_TSI578_1X_MODE(0), EMU_TSI578_1X_MODE(1),
+	EMU_TSI578_1X_MODE(2), EMU_TSI578_1X_MODE(3),
+	EMU_TSI578_1X_MODE(4), EMU_TSI578_1X_MODE(5),
+	EMU_TSI578_1X_MODE(6), EMU_TSI578_1X_MODE(7),
+};
+
+// Quadrants are strapped so that every port is available: CPS1848 ports
+// 12 to 17 take lanes from quadrants 0 and 1, and CPS1616 ports are 1x.
+static const emu_reg_t cps1848_rst_regs[] = {
+	{CPS1848_QUAD_CFG, 0x0000005F},
+};
+
+static const emu_reg_t cps1616_rst_regs[] = {
+	{CPS1848_QUAD_CFG, 0x000000FF},
+};
+
+static const emu_bcast_t cps_bcast[] = {
+	{CPS1848_BCAST_DEV_RTE_TABLE_X(0), 0x400,
+			CPS1848_PORT_X_DEV_RTE_TABLE_Y(0, 0), 0x1000},
+	{CPS1848_BCAST_DOM_RTE_TABLE_X(0), 0x400,
+			CPS1848_PORT_X_DOM_RTE_TABLE_Y(0, 0), 0x1000},
+	{CPS1848_BCAST_MCAST_MASK_X(0), 0x100,
+			CPS1848_PORT_X_MCAST_MASK_Y(0, 0), 0x100},
+};
+
+static const emu_bcast_t tsi578_bcast[] = {
+	{TSI578_RIO_ROUTE_CFG_DESTID, 8, TSI578_SPX_ROUTE_CFG_DESTID(0),
+			0x100},
+	{TSI578_SPBC_MODE & ~0xFF, 0x100, TSI578_SPX_MODE(0) & ~0xFF, 0x100},
+};
+
+#define EMU_CNT(x) (sizeof(x) / sizeof(x[0]))
+
+#define EMU_CTL2_12P5 (RIO_SPX_CTL2_GB_12P5_EN | RIO_SPX_CTL2_GB_12P5 \
+			| RIO_SPX_CTL2_BAUD_SEL_12P5_BR)
+#define EMU_CTL2_6P25 (RIO_SPX_CTL2_GB_6P25_EN | RIO_SPX_CTL2_GB_6P25 \
+			| RIO_SPX_CTL2_BAUD_SEL_6P25_BR)
+#define EMU_CTL2_5P0 (RIO_SPX_CTL2_GB_5P0_EN | RIO_SPX_CTL2_GB_5P0 \
+			| RIO_SPX_CTL2_BAUD_SEL_5P0_BR)
+#define EMU_CTL2_3P125 (RIO_SPX_CTL2_GB_3P125_EN | RIO_SPX_CTL2_GB_3P125 \
+			| RIO_SPX_CTL2_BAUD_SEL_3P125_BR)
+
+static const emu_model_info_t emu_models[rio_emu_model_last] = {
+	{"RXS2448", 24, 0x80E60038, 0x100, 0x1800063F, 0x1800, 0x4, 0,
+		0xFF, 0xFF,
+		0x100, RIO_EFB_T_SP_NOEP3_SAER, 0x1000, 0x3000, 0x5000,
+		EMU_CTL2_12P5, true,
+		rxs_rst_regs, EMU_CNT(rxs_rst_regs),
+		rxs_bcast, EMU_CNT(rxs_bcast), true, false},
+	{"RXS1632", 16, 0x80E50038, 0x100, 0x1800063F, 0x1000, 0x4, 0,
+		0xFF, 0xFF,
+		0x100, RIO_EFB_T_SP_NOEP3_SAER, 0x1000, 0x3000, 0x5000,
+		EMU_CTL2_12P5, true,
+		rxs_rst_regs, EMU_CNT(rxs_rst_regs),
+		rxs_bcast, EMU_CNT(rxs_bcast), true, false},
+	{"CPS1848", 18, 0x03740038, 0x100, 0x18000779, 0x1200, 0x4, 0,
+		0xFF, 0x00FF0028,
+		0x100, RIO_EFB_T_SP_NOEP_SAER, 0x1000, 0x2000, 0,
+		EMU_CTL2_6P25, false,
+		cps1848_rst_regs, EMU_CNT(cps1848_rst_regs),
+		cps_bcast, EMU_CNT(cps_bcast), false, false},
+	{"CPS1616", 16, 0x03790038, 0x100, 0x18000779, 0x1000, 0x4, 0,
+		0xFF, 0x00FF0028,
+		0x100, RIO_EFB_T_SP_NOEP_SAER, 0x1000, 0x2000, 0,
+		EMU_CTL2_6P25, false,
+		cps1616_rst_regs, EMU_CNT(cps1616_rst_regs),
+		cps_bcast, EMU_CNT(cps_bcast), false, false},
+	{"Tsi578", 16, 0x0578000D, 0x100, 0x10000518, 0x1000, 0x4, 0,
+		0xFF, 0x00080008,
+		TSI578_RIO_SW_MB_HEAD, RIO_EFB_T_SP_NOEP_SAER,
+		TSI578_RIO_ERR_RPT_BH, 0, 0, EMU_CTL2_3P125, false,
+		tsi578_rst_regs, EMU_CNT(tsi578_rst_regs),
+		tsi578_bcast, EMU_CNT(tsi578_bcast), false, true},
+	{"Tsi721", 1, 0x80AB0038, 0x100, 0xC000003F, 0x0100, 0x0000FCF4,
+		0x0000FCF4, 0, 0,
+		TSI721_SP_MB_HEAD, RIO_EFB_T_SP_EP_SAER, TSI721_ERR_RPT_BH,
+		TSI721_PER_LANE_BH, 0, EMU_CTL2_5P0, false,
+		NULL, 0, NULL, 0, false, false},
+};
+
+struct rio_emu_dev_t_TAG {
+	const emu_model_info_t *info;
+	pthread_mutex_t mtx;
+
+	// Register values, indexed by offset
+	uint32_t *keys;
+	uint32_t *vals;
+	uint32_t slots;
+	uint32_t used;
+
+	bool link_up[EMU_MAX_PORTS];
+	uint32_t fail_oset;
+	rio_emu_lat_t lat;
+	rio_emu_stats_t stats;
+};
+
+const char *rio_emu_model_name(rio_emu_model_t model)
+{
+	if (model >= rio_emu_model_last) {
+		return NULL;
+	}
+	return emu_models[model].name;
+}
+
+rio_emu_model_t rio_emu_model_by_name(const char *name)
+{
+	uint32_t idx;
+
+	if (NULL == name) {
+		return rio_emu_model_last;
+	}
+
+	for (idx = 0; idx < rio_emu_model_last; idx++) {
+		if (!strcasecmp(name, emu_models[idx].name)) {
+			return (rio_emu_model_t)idx;
+		}
+	}
+	return rio_emu_model_last;
+}
+
+static inline uint32_t emu_hash(uint32_t key, uint32_t slots)
+{
+	// Multiplicative hash, slots is a power of 2
+	return (key * 0x9E3779B1) & (slots - 1);
+}
+
+static uint32_t emu_get(rio_emu_dev_t *emu, uint32_t key)
+{
+	uint32_t idx = emu_hash(key, emu->slots);
+
+	while (EMU_NO_KEY != emu->keys[idx]) {
+		if (key == emu->keys[idx]) {
+			return emu->vals[idx];
+		}
+		idx = (idx + 1) & (emu->slots - 1);
+	}
+	return 0;
+}
+
+static bool emu_alloc(rio_emu_dev_t *emu, uint32_t slots)
+{
+	emu->keys = (uint32_t *)malloc(slots * sizeof(uint32_t));
+	emu->vals = (uint32_t *)malloc(slots * sizeof(uint32_t));
+	if ((NULL == emu->keys) || (NULL == emu->vals)) {
+		free(emu->keys);
+		free(emu->vals);
+		emu->keys = emu->vals = NULL;
+		return false;
+	}
+	memset(emu->keys, 0xFF, slots * sizeof(uint32_t));
+	emu->slots = slots;
+	emu->used = 0;
+	return true;
+}
+
+static void emu_set(rio_emu_dev_t *emu, uint32_t key, uint32_t val)
+{
+	uint32_t idx;
+
+	// Keep the table at most half full.  If it cannot grow, the table
+	// is filled further, which only makes it slower.
+	if ((emu->used + 1) * 2 > emu->slots) {
+		uint32_t *keys = emu->keys;
+		uint32_t *vals = emu->vals;
+		uint32_t slots = emu->slots;
+
+		if (emu_alloc(emu, slots * 2)) {
+			for (idx = 0; idx < slots; idx++) {
+				if (EMU_NO_KEY != keys[idx]) {
+					emu_set(emu, keys[idx], vals[idx]);
+				}
+			}
+			free(keys);
+			free(vals);
+		} else {
+			emu->keys = keys;
+			emu->vals = vals;
+			emu->slots = slots;
+		}
+	}
+
+	idx = emu_hash(key, emu->slots);
+	while (EMU_NO_KEY != emu->keys[idx]) {
+		if (key == emu->keys[idx]) {
+			emu->vals[idx] = val;
+			return;
+		}
+		idx = (idx + 1) & (emu->slots - 1);
+	}
+	emu->keys[idx] = key;
+	emu->vals[idx] = val;
+	emu->used++;
+}
+
+// Returns true if offset is a register of a port in the standard port
+// register block.  *port and *reg are the port, and the offset of the
+// register for port 0.
+static bool emu_std_port_reg(rio_emu_dev_t *emu, uint32_t offset,
+		uint8_t *port, uint32_t *reg)
+{
+	const emu_model_info_t *info = emu->info;
+	uint32_t step = RIO_SP_STEP(info->ef_port_type);
+	uint32_t base = info->ef_port + 0x40;
+
+	if ((offset < base) || (offset >= base + (step * info->ports))) {
+		return false;
+	}
+	*port = (uint8_t)((offset - base) / step);
+	*reg = info->ef_port + 0x40 + ((offset - base) % step);
+	return true;
+}
+
+static const emu_bcast_t *emu_bcast_reg(rio_emu_dev_t *emu, uint32_t offset)
+{
+	uint32_t idx;
+
+	for (idx = 0; idx < emu->info->bcast_cnt; idx++) {
+		const emu_bcast_t *bc = &emu->info->bcast[idx];
+		if ((offset >= bc->bc) && (offset < bc->bc + bc->size)) {
+			return bc;
+		}
+	}
+	return NULL;
+}
+
+// Returns true if offset is an RXS multicast mask set or clear register.
+// *set is the set register offset, which holds the mask value, and
+// *bc is true for broadcast registers.
+static bool emu_rxs_mc_reg(rio_emu_dev_t *emu, uint32_t offset, uint32_t *set,
+		bool *bc)
+{
+	uint32_t base;
+
+	if (!emu->info->rxs_mc) {
+		return false;
+	}
+
+	if ((offset >= RXS_BC_MC_X_S_CSR(0))
+			&& (offset < RXS_BC_MC_X_S_CSR(RXS2448_MC_MASK_CNT))) {
+		*bc = true;
+		*set = offset & ~4;
+		return true;
+	}
+
+	base = RXS_SPX_MC_Y_S_CSR(0, 0);
+	if ((offset >= base) && (offset < RXS_SPX_MC_Y_S_CSR(emu->info->ports, 0))
+			&& (((offset - base) & 0xFFF)
+				< RXS_SPX_MC_Y_S_CSR(0, RXS2448_MC_MASK_CNT)
+					- base)) {
+		*bc = false;
+		*set = offset & ~4;
+		return true;
+	}
+	return false;
+}
+
+// Returns true if offset is a Tsi57x route configuration port register,
+// and sets *port.
+static bool emu_tsi57x_rte_reg(rio_emu_dev_t *emu, uint32_t offset,
+		uint8_t *port)
+{
+	if (!emu->info->tsi57x_rt) {
+		return false;
+	}
+
+	if ((offset >= TSI578_SPX_ROUTE_CFG_PORT(0))
+			&& (offset < TSI578_SPX_ROUTE_CFG_PORT(emu->info->ports))
+			&& !((offset - TSI578_SPX_ROUTE_CFG_PORT(0)) & 0xFF)) {
+		*port = (uint8_t)((offset - TSI578_SPX_ROUTE_CFG_PORT(0))
+				/ 0x100);
+		return true;
+	}
+	return false;
+}
+
+// Returns the Tsi57x routing table entry index selected for port, and
+// advances the index if auto increment is enabled.
+static uint32_t emu_tsi57x_rte_idx(rio_emu_dev_t *emu, uint8_t port)
+{
+	uint32_t destid_oset = TSI578_SPX_ROUTE_CFG_DESTID(port);
+	uint32_t destid = emu_get(emu, destid_oset);
+	uint32_t idx = destid & EMU_TSI57X_DESTID_IDX;
+
+	if (destid & TSI578_SPX_ROUTE_CFG_DESTID_AUTO_INC) {
+		destid = (destid & ~EMU_TSI57X_DESTID_IDX)
+				| ((idx + 1) & EMU_TSI57X_DESTID_IDX);
+		emu_set(emu, destid_oset, destid);
+	}
+	return idx;
+}
+
+static void emu_reset(rio_emu_dev_t *emu)
+{
+	const emu_model_info_t *info = emu->info;
+	uint32_t ef[4], ef_type[4];
+	uint32_t ef_cnt = 0;
+	uint32_t idx;
+	uint8_t port;
+
+	memset(emu->keys, 0xFF, emu->slots * sizeof(uint32_t));
+	emu->used = 0;
+
+	emu_set(emu, RIO_DEV_IDENT, info->dev_ident);
+	emu_set(emu, RIO_ASSY_INF, info->assy_inf);
+	emu_set(emu, RIO_PE_FEAT, info->pe_feat);
+	emu_set(emu, RIO_SW_PORT_INF, info->sw_port_inf);
+	emu_set(emu, RIO_SRC_OPS, info->src_ops);
+	emu_set(emu, RIO_DST_OPS, info->dst_ops);
+	emu_set(emu, RIO_SW_RT_TBL_LIM, info->sw_rt_tbl_lim);
+	emu_set(emu, RIO_SW_MC_INF, info->sw_mc_inf);
+	emu_set(emu, RIO_HOST_LOCK, RIO_HOST_LOCK_DEVID);
+
+	// Link the extended features blocks.  The first block is found
+	// through the assembly information register.
+	if (info->ef_port) {
+		ef[ef_cnt] = info->ef_port;
+		ef_type[ef_cnt++] = info->ef_port_type;
+	}
+	if (info->ef_err) {
+		ef[ef_cnt] = info->ef_err;
+		ef_type[ef_cnt++] = RIO_EFB_T_EMHS;
+	}
+	if (info->ef_lane) {
+		ef[ef_cnt] = info->ef_lane;
+		ef_type[ef_cnt++] = RIO_EFB_T_LANE;
+	}
+	if (info->ef_rt) {
+		ef[ef_cnt] = info->ef_rt;
+		ef_type[ef_cnt++] = RIO_EFB_T_RT;
+	}
+	for (idx = 0; idx < ef_cnt; idx++) {
+		uint32_t next = (idx + 1 < ef_cnt) ? ef[idx + 1] : 0;
+		emu_set(emu, ef[idx], (next << 16) | ef_type[idx]);
+	}
+
+	for (port = 0; info->ef_port && (port < info->ports); port++) {
+		emu_set(emu, RIO_SPX_CTL(info->ef_port, info->ef_port_type,
+				port), info->ports_2x ?
+				EMU_SPX_CTL_RST_2X : EMU_SPX_CTL_RST);
+		emu_set(emu, RIO_SPX_CTL2(info->ef_port, info->ef_port_type,
+				port), info->spx_ctl2);
+	}
+
+	for (idx = 0; idx < info->rst_cnt; idx++) {
+		emu_set(emu, info->rst_regs[idx].offset,
+				info->rst_regs[idx].val);
+	}
+}
+
+static bool emu_read_only(rio_emu_dev_t *emu, uint32_t offset)
+{
+	const emu_model_info_t *info = emu->info;
+
+	return (offset < EMU_CAR_END) || (offset == info->ef_port)
+			|| (offset == info->ef_err)
+			|| (offset == info->ef_lane)
+			|| (offset == info->ef_rt);
+}
+
+static uint32_t emu_rd_one(rio_emu_dev_t *emu, uint32_t offset)
+{
+	uint32_t reg, set;
+	uint32_t val;
+	uint8_t port;
+	bool bc;
+
+	if (emu_std_port_reg(emu, offset, &port, &reg)) {
+		val = emu_get(emu, offset);
+		if (RIO_SPX_ERR_STAT(emu->info->ef_port,
+				emu->info->ef_port_type, 0) == reg) {
+			val &= ~(RIO_SPX_ERR_STAT_UNINIT | RIO_SPX_ERR_STAT_OK);
+			val |= emu->link_up[port] ?
+					RIO_SPX_ERR_STAT_OK :
+					RIO_SPX_ERR_STAT_UNINIT;
+		} else if (RIO_SPX_LM_RESP(emu->info->ef_port,
+				emu->info->ef_port_type, 0) == reg) {
+			// Reading the response clears the valid indication.
+			emu_set(emu, offset, val & ~RIO_SPX_LM_RESP_VLD);
+		}
+		return val;
+	}
+
+	if (emu_rxs_mc_reg(emu, offset, &set, &bc)) {
+		return emu_get(emu, set);
+	}
+
+	if (emu_tsi57x_rte_reg(emu, offset, &port)) {
+		return emu_get(emu, EMU_TSI57X_RTE_KEY(port,
+				emu_tsi57x_rte_idx(emu, port)))
+				^ EMU_TSI57X_RTE_DFLT;
+	}
+
+	if (emu->info->tsi57x_rt && ((TSI578_RIO_ROUTE_CFG_PORT == offset)
+			|| (TSI578_SPBC_ROUTE_CFG_PORT == offset))) {
+		return emu_rd_one(emu, TSI578_SPX_ROUTE_CFG_PORT(0));
+	}
+
+	return emu_get(emu, offset);
+}
+
+static void emu_wr_one(rio_emu_dev_t *emu, uint32_t offset, uint32_t data)
+{
+	const emu_bcast_t *bc_reg;
+	uint32_t reg, set, val;
+	uint8_t port;
+	bool bc;
+
+	if (emu_read_only(emu, offset)) {
+		return;
+	}
+
+	if (RIO_HOST_LOCK == offset) {
+		val = emu_get(emu, offset);
+		data &= RIO_HOST_LOCK_DEVID;
+		if (RIO_HOST_LOCK_DEVID == val) {
+			emu_set(emu, offset, data);
+		} else if (val == data) {
+			emu_set(emu, offset, RIO_HOST_LOCK_DEVID);
+		}
+		return;
+	}
+
+	if (emu_std_port_reg(emu, offset, &port, &reg)) {
+		const emu_model_info_t *info = emu->info;
+
+		if (RIO_SPX_ERR_STAT(info->ef_port, info->ef_port_type, 0)
+				== reg) {
+			val = emu_get(emu, offset);
+			emu_set(emu, offset,
+					val & ~(data & RIO_SPX_ERR_STAT_MASK));
+			return;
+		}
+		if (RIO_SPX_LM_REQ(info->ef_port, info->ef_port_type, 0)
+				== reg) {
+			emu_set(emu, RIO_SPX_LM_RESP(info->ef_port,
+					info->ef_port_type, port),
+					emu->link_up[port] ?
+					RIO_SPX_LM_RESP_VLD
+					| RIO_SPX_LM_RESP_STAT12_NOERR :
+					0);
+		}
+		emu_set(emu, offset, data);
+		return;
+	}
+
+	if (emu_rxs_mc_reg(emu, offset, &set, &bc)) {
+		if (bc) {
+			// Write the set or clear register of every port
+			for (port = 0; port < emu->info->ports; port++) {
+				emu_wr_one(emu, RXS_SPX_MC_Y_S_CSR(port, 0)
+						+ (offset
+						- RXS_BC_MC_X_S_CSR(0)), data);
+			}
+			return;
+		}
+		val = emu_get(emu, set);
+		val = (offset & 4) ? (val & ~data) : (val | data);
+		emu_set(emu, set, val);
+		return;
+	}
+
+	if (emu_tsi57x_rte_reg(emu, offset, &port)) {
+		emu_set(emu, EMU_TSI57X_RTE_KEY(port,
+				emu_tsi57x_rte_idx(emu, port)),
+				(data & TSI578_SPX_ROUTE_CFG_PORT_PORT)
+				^ EMU_TSI57X_RTE_DFLT);
+		return;
+	}
+
+	bc_reg = emu_bcast_reg(emu, offset);
+	if (NULL != bc_reg) {
+		for (port = 0; port < emu->info->ports; port++) {
+			emu_wr_one(emu, bc_reg->port_base
+					+ (bc_reg->port_step * port)
+					+ (offset - bc_reg->bc), data);
+		}
+	}
+	emu_set(emu, offset, data);
+}
+
+void rio_emu_wait_ns(uint64_t delay_ns)
+{
+	struct timespec start, now;
+	uint64_t elapsed;
+
+	if (!delay_ns) {
+		return;
+	}
+
+	// Maintenance transactions take microseconds, which is too short
+	// for nanosleep to be accurate.
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		elapsed = ((uint64_t)(now.tv_sec - start.tv_sec) * 1000000000)
+				+ now.tv_nsec - start.tv_nsec;
+	} while (elapsed < delay_ns);
+}
+
+void rio_emu_sleep_ns(uint64_t delay_ns)
+{
+	// Time at which the modeled delays of this thread end
+	static __thread uint64_t deadline;
+	struct timespec now, ts;
+	uint64_t now_ns;
+
+	if (!delay_ns) {
+		return;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	now_ns = ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+	if (deadline < now_ns) {
+		deadline = now_ns;
+	}
+	deadline += delay_ns;
+	if (deadline - now_ns < RIO_EMU_PACE_NS) {
+		return;
+	}
+
+	ts.tv_sec = deadline / 1000000000;
+	ts.tv_nsec = deadline % 1000000000;
+	// The deadline is absolute, so an interrupted sleep is restarted
+	while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts,
+			NULL)) {
+		continue;
+	}
+}
+
+static void emu_delay(rio_emu_dev_t *emu, uint32_t cnt)
+{
+	uint64_t lat = emu->lat.acc_ns + ((uint64_t)emu->lat.reg_ns * cnt);
+
+	emu->stats.lat_ns += lat;
+	if (emu->lat.wait) {
+		rio_emu_wait_ns(lat);
+	}
+}
+
+rio_emu_dev_t *rio_emu_create(rio_emu_model_t model)
+{
+	rio_emu_dev_t *emu;
+	uint8_t port;
+
+	if (model >= rio_emu_model_last) {
+		return NULL;
+	}
+
+	emu = (rio_emu_dev_t *)calloc(1, sizeof(rio_emu_dev_t));
+	if (NULL == emu) {
+		return NULL;
+	}
+
+	if (!emu_alloc(emu, EMU_MIN_SLOTS)) {
+		free(emu);
+		return NULL;
+	}
+
+	emu->info = &emu_models[model];
+	pthread_mutex_init(&emu->mtx, NULL);
+	for (port = 0; port < EMU_MAX_PORTS; port++) {
+		emu->link_up[port] = true;
+	}
+	emu->fail_oset = RIO_EMU_NO_FAIL;
+	emu_reset(emu);
+
+	return emu;
+}
+
+void rio_emu_destroy(rio_emu_dev_t *emu)
+{
+	if (NULL == emu) {
+		return;
+	}
+	pthread_mutex_destroy(&emu->mtx);
+	free(emu->keys);
+	free(emu->vals);
+	free(emu);
+}
+
+void rio_emu_reset(rio_emu_dev_t *emu)
+{
+	pthread_mutex_lock(&emu->mtx);
+	emu_reset(emu);
+	pthread_mutex_unlock(&emu->mtx);
+}
+
+rio_emu_model_t rio_emu_get_model(rio_emu_dev_t *emu)
+{
+	return (rio_emu_model_t)(emu->info - emu_models);
+}
+
+uint8_t rio_emu_num_ports(rio_emu_dev_t *emu)
+{
+	return emu->info->ports;
+}
+
+void rio_emu_set_lat(rio_emu_dev_t *emu, rio_emu_lat_t *lat)
+{
+	pthread_mutex_lock(&emu->mtx);
+	emu->lat = *lat;
+	pthread_mutex_unlock(&emu->mtx);
+}
+
+void rio_emu_get_stats(rio_emu_dev_t *emu, rio_emu_stats_t *stats)
+{
+	pthread_mutex_lock(&emu->mtx);
+	*stats = emu->stats;
+	pthread_mutex_unlock(&emu->mtx);
+}
+
+void rio_emu_clr_stats(rio_emu_dev_t *emu)
+{
+	pthread_mutex_lock(&emu->mtx);
+	memset(&emu->stats, 0, sizeof(emu->stats));
+	pthread_mutex_unlock(&emu->mtx);
+}
+
+uint32_t rio_emu_set_link(rio_emu_dev_t *emu, uint8_t port, bool up)
+{
+	if (port >= emu->info->ports) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	pthread_mutex_lock(&emu->mtx);
+	emu->link_up[port] = up;
+	pthread_mutex_unlock(&emu->mtx);
+	return RIO_SUCCESS;
+}
+
+uint32_t rio_emu_set_acc_port(rio_emu_dev_t *emu, uint8_t port)
+{
+	if (port >= emu->info->ports) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	pthread_mutex_lock(&emu->mtx);
+	emu_set(emu, RIO_SW_PORT_INF, (emu->info->sw_port_inf
+			& ~RIO_SW_PORT_INF_PORT) | port);
+	pthread_mutex_unlock(&emu->mtx);
+	return RIO_SUCCESS;
+}
+
+void rio_emu_set_fail(rio_emu_dev_t *emu, uint32_t offset)
+{
+	pthread_mutex_lock(&emu->mtx);
+	emu->fail_oset = offset;
+	pthread_mutex_unlock(&emu->mtx);
+}
+
+uint32_t rio_emu_read(rio_emu_dev_t *emu, uint32_t offset, uint32_t cnt,
+		uint32_t *data)
+{
+	uint32_t rc = RIO_SUCCESS;
+	uint32_t idx;
+
+	if ((NULL == emu) || (NULL == data) || !cnt || (offset & 3)) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	pthread_mutex_lock(&emu->mtx);
+	emu->stats.rd_acc++;
+	for (idx = 0; idx < cnt; idx++) {
+		if ((offset + (4 * idx)) == emu->fail_oset) {
+			emu->stats.fails++;
+			rc = RIO_ERR_ACCESS;
+			break;
+		}
+		data[idx] = emu_rd_one(emu, offset + (4 * idx));
+	}
+	emu->stats.regs_rd += idx;
+	emu_delay(emu, cnt);
+	pthread_mutex_unlock(&emu->mtx);
+
+	return rc;
+}
+
+uint32_t rio_emu_write(rio_emu_dev_t *emu, uint32_t offset, uint32_t cnt,
+		uint32_t *data)
+{
+	uint32_t rc = RIO_SUCCESS;
+	uint32_t idx;
+
+	if ((NULL == emu) || (NULL == data) || !cnt || (offset & 3)) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	pthread_mutex_lock(&emu->mtx);
+	emu->stats.wr_acc++;
+	for (idx = 0; idx < cnt; idx++) {
+		if ((offset + (4 * idx)) == emu->fail_oset) {
+			emu->stats.fails++;
+			rc = RIO_ERR_ACCESS;
+			break;
+		}
+		emu_wr_one(emu, offset + (4 * idx), data[idx]);
+	}
+	emu->stats.regs_wr += idx;
+	emu_delay(emu, cnt);
+	pthread_mutex_unlock(&emu->mtx);
+
+	return rc;
+}
+
+uint32_t rio_emu_peek(rio_emu_dev_t *emu, uint32_t offset)
+{
+	uint32_t val;
+
+	pthread_mutex_lock(&emu->mtx);
+	val = emu_get(emu, offset);
+	pthread_mutex_unlock(&emu->mtx);
+	return val;
+}
+
+void rio_emu_poke(rio_emu_dev_t *emu, uint32_t offset, uint32_t data)
+{
+	pthread_mutex_lock(&emu->mtx);
+	emu_set(emu, offset, data);
+	pthread_mutex_unlock(&emu->mtx);
+}
+
+uint32_t rio_emu_peek_tsi57x_rte(rio_emu_dev_t *emu, uint8_t port,
+		uint32_t idx)
+{
+	return rio_emu_peek(emu, EMU_TSI57X_RTE_KEY(port, idx))
+			^ EMU_TSI57X_RTE_DFLT;
+}
+
+// CPS routing tables hold a port number, or one of the values below.
+static uint32_t emu_cps_route(rio_emu_dev_t *emu, uint8_t port, uint32_t did,
+		bool dev16)
+{
+	uint32_t rte = 0xDD;
+
+	if (dev16) {
+		rte = emu_get(emu, CPS1848_PORT_X_DOM_RTE_TABLE_Y(port,
+				(did >> 8) & 0xFF));
+	}
+	if (0xDD == rte) { // Use device table
+		rte = emu_get(emu, CPS1848_PORT_X_DEV_RTE_TABLE_Y(port,
+				did & 0xFF));
+	}
+	if (0xDE == rte) { // Use default route
+		rte = emu_get(emu, CPS1848_RTE_DEFAULT_PORT_CSR)
+				& CPS1848_RTE_DEFAULT_PORT_CSR_DEFAULT_PORT;
+	}
+	return rte;
+}
+
+// RXS routing tables hold standard routing table values.
+static uint32_t emu_rxs_route(rio_emu_dev_t *emu, uint8_t port, uint32_t did,
+		bool dev16)
+{
+	uint32_t rte = RIO_RTE_LVL_G0;
+
+	if (dev16) {
+		rte = emu_get(emu, RXS_SPX_L1_GY_ENTRYZ_CSR(port, 0,
+				(did >> 8) & 0xFF)) & RIO_RTE_VAL;
+	}
+	if (RIO_RTE_LVL_G0 == rte) {
+		rte = emu_get(emu, RXS_SPX_L2_GY_ENTRYZ_CSR(port, 0,
+				did & 0xFF)) & RIO_RTE_VAL;
+	}
+	if (RIO_RTE_DFLT_PORT == rte) {
+		rte = emu_get(emu, RXS_ROUTE_DFLT_PORT) & RIO_RTE_VAL;
+	}
+	return RIO_RTV_IS_PORT(rte) ? RIO_RTV_GET_PORT(rte) : RIO_RTE_DROP;
+}
+
+// Tsi57x routing tables have one entry for each domain, and one entry for
+// each device in the domain selected by the port's route base register.
+static uint32_t emu_tsi57x_route(rio_emu_dev_t *emu, uint8_t port,
+		uint32_t did, bool dev16)
+{
+	uint32_t base = (emu_get(emu, TSI578_SPX_ROUTE_BASE(port))
+			& TSI578_SPX_ROUTE_BASE_BASE) >> 24;
+	uint32_t idx = did & 0xFF;
+	uint32_t rte;
+
+	if (dev16) {
+		idx = did & 0xFFFF;
+		if ((idx >> 8) != base) {
+			idx &= 0xFF00;
+		}
+	}
+	rte = emu_get(emu, EMU_TSI57X_RTE_KEY(port, idx)) ^ EMU_TSI57X_RTE_DFLT;
+	if (EMU_TSI57X_RTE_DFLT == rte) {
+		rte = emu_get(emu, TSI578_RIO_LUT_ATTR)
+				& TSI578_RIO_LUT_ATTR_DEFAULT_PORT;
+	}
+	return rte;
+}
+
+uint32_t rio_emu_route(rio_emu_dev_t *emu, uint8_t port, uint32_t did,
+		bool dev16, uint8_t *out_port)
+{
+	uint32_t rte;
+
+	if (port >= emu->info->ports) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	pthread_mutex_lock(&emu->mtx);
+	switch (rio_emu_get_model(emu)) {
+	case rio_emu_rxs2448:
+	case rio_emu_rxs1632:
+		rte = emu_rxs_route(emu, port, did, dev16);
+		break;
+	case rio_emu_cps1848:
+	case rio_emu_cps1616:
+		rte = emu_cps_route(emu, port, did, dev16);
+		break;
+	case rio_emu_tsi578:
+		rte = emu_tsi57x_route(emu, port, did, dev16);
+		break;
+	default:
+		pthread_mutex_unlock(&emu->mtx);
+		return RIO_ERR_NO_SWITCH;
+	}
+	pthread_mutex_unlock(&emu->mtx);
+
+	if (rte >= emu->info->ports) {
+		return RIO_ERR_ROUTE_ERROR;
+	}
+	*out_port = (uint8_t)rte;
+	return RIO_SUCCESS;
+}
+
+uint32_t rio_emu_ReadReg(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t *readdata)
+{
+	return rio_emu_read((rio_emu_dev_t *)dev_info->accessInfo, offset, 1,
+			readdata);
+}
+
+uint32_t rio_emu_WriteReg(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t writedata)
+{
+	return rio_emu_write((rio_emu_dev_t *)dev_info->accessInfo, offset, 1,
+			&writedata);
+}
+
+uint32_t rio_emu_ReadRegBlock(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *readdata)
+{
+	return rio_emu_read((rio_emu_dev_t *)dev_info->accessInfo, offset, cnt,
+			readdata);
+}
+
+uint32_t rio_emu_WriteRegBlock(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *writedata)
+{
+	return rio_emu_write((rio_emu_dev_t *)dev_info->accessInfo, offset,
+			cnt, writedata);
+}
+
+void rio_emu_WaitSec(uint32_t delay_nsec, uint32_t delay_sec)
+{
+	if (delay_nsec || delay_sec) {
+		return;
+	}
+}
+
+uint32_t rio_emu_bind(bool blk)
+{
+	uint32_t rc;
+
+	rc = DAR_proc_ptr_init(rio_emu_ReadReg, rio_emu_WriteReg,
+			rio_emu_WaitSec);
+	if (RIO_SUCCESS != rc) {
+		return rc;
+	}
+
+	rc = DAR_blk_proc_ptr_init(blk ? rio_emu_WriteRegBlock : NULL);
+	if (RIO_SUCCESS != rc) {
+		return rc;
+	}
+
+	return DAR_blk_rd_proc_ptr_init(blk ? rio_emu_ReadRegBlock : NULL);
+}
+
+uint32_t rio_emu_dev_info_init(rio_emu_dev_t *emu, DAR_DEV_INFO_t *dev_info)
+{
+	if ((NULL == emu) || (NULL == dev_info)) {
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+
+	memset(dev_info, 0, sizeof(DAR_DEV_INFO_t));
+	dev_info->accessInfo = emu;
+
+	return DAR_Find_Driver_for_Device(false, dev_info);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,613 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+/* Fabric emulation
+ *
+ * Devices are kept in an array in the order they were added, so a device
+ * index never changes.  Each device records the device and port connected
+ * to each of its ports.  Requests are routed by following these links,
+ * using rio_emu_route to select the output port of each switch.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <pthread.h>
+
+#include "RapidIO_Device_Access_Routines_API.h"
+#include "RapidIO_Device_Emulation_API.h"
+#include "RapidIO_Fabric_Emulation_API.h"
+#include "rio_standard.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FAB_MAX_PORTS 24
+#define FAB_MIN_DEVS 16
+#define FAB_LINE_SZ 256
+#define FAB_DELIM " \t\r\n"
+
+typedef struct fab_lp_t_TAG {
+	uint32_t dev;
+	uint8_t port;
+} fab_lp_t;
+
+typedef struct fab_dev_t_TAG {
+	char name[RIO_FAB_NAME_SZ + 1];
+	rio_emu_dev_t *emu;
+	bool sw;
+	uint8_t ports;
+	fab_lp_t lp[FAB_MAX_PORTS];
+} fab_dev_t;
+
+struct rio_fab_t_TAG {
+	pthread_mutex_t mtx;
+	fab_dev_t *devs;
+	uint32_t cnt;
+	uint32_t alloc;
+	uint32_t mport;
+	bool dev16;
+	rio_fab_lat_t lat;
+	rio_fab_stats_t stats;
+};
+
+rio_fab_t *rio_fab_create(void)
+{
+	rio_fab_t *fab;
+
+	fab = (rio_fab_t *)calloc(1, sizeof(rio_fab_t));
+	if (NULL == fab) {
+		return NULL;
+	}
+
+	fab->devs = (fab_dev_t *)calloc(FAB_MIN_DEVS, sizeof(fab_dev_t));
+	if (NULL == fab->devs) {
+		free(fab);
+		return NULL;
+	}
+	fab->alloc = FAB_MIN_DEVS;
+	fab->mport = RIO_FAB_NO_DEV;
+	pthread_mutex_init(&fab->mtx, NULL);
+
+	return fab;
+}
+
+void rio_fab_destroy(rio_fab_t *fab)
+{
+	uint32_t dev;
+
+	if (NULL == fab) {
+		return;
+	}
+
+	for (dev = 0; dev < fab->cnt; dev++) {
+		rio_emu_destroy(fab->devs[dev].emu);
+	}
+	pthread_mutex_destroy(&fab->mtx);
+	free(fab->devs);
+	free(fab);
+}
+
+uint32_t rio_fab_find_dev(rio_fab_t *fab, const char *name)
+{
+	uint32_t dev;
+
+	for (dev = 0; dev < fab->cnt; dev++) {
+		if (!strcmp(fab->devs[dev].name, name)) {
+			return dev;
+		}
+	}
+	return RIO_FAB_NO_DEV;
+}
+
+uint32_t rio_fab_add_dev(rio_fab_t *fab, const char *name,
+		rio_emu_model_t model)
+{
+	fab_dev_t *devs, *dev;
+	rio_emu_dev_t *emu;
+	uint8_t port;
+
+	if ((NULL == name) || !*name || (strlen(name) > RIO_FAB_NAME_SZ)
+			|| (RIO_FAB_NO_DEV != rio_fab_find_dev(fab, name))) {
+		return RIO_FAB_NO_DEV;
+	}
+
+	if (fab->cnt == fab->alloc) {
+		devs = (fab_dev_t *)realloc(fab->devs,
+				2 * fab->alloc * sizeof(fab_dev_t));
+		if (NULL == devs) {
+			return RIO_FAB_NO_DEV;
+		}
+		fab->devs = devs;
+		fab->alloc *= 2;
+	}
+
+	emu = rio_emu_create(model);
+	if (NULL == emu) {
+		return RIO_FAB_NO_DEV;
+	}
+
+	dev = &fab->devs[fab->cnt];
+	memset(dev, 0, sizeof(fab_dev_t));
+	strncpy(dev->name, name, RIO_FAB_NAME_SZ);
+	dev->emu = emu;
+	dev->sw = !!(rio_emu_peek(emu, RIO_PE_FEAT) & RIO_PE_FEAT_SW);
+	dev->ports = rio_emu_num_ports(emu);
+	for (port = 0; port < FAB_MAX_PORTS; port++) {
+		dev->lp[port].dev = RIO_FAB_NO_DEV;
+		if (port < dev->ports) {
+			rio_emu_set_link(emu, port, false);
+		}
+	}
+
+	return fab->cnt++;
+}
+
+uint32_t rio_fab_connect(rio_fab_t *fab, uint32_t dev_a, uint8_t port_a,
+		uint32_t dev_b, uint8_t port_b)
+{
+	fab_dev_t *a, *b;
+
+	if ((dev_a >= fab->cnt) || (dev_b >= fab->cnt)) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	a = &fab->devs[dev_a];
+	b = &fab->devs[dev_b];
+	if ((port_a >= a->ports) || (port_b >= b->ports)
+			|| ((dev_a == dev_b) && (port_a == port_b))) {
+		return RIO_ERR_BAD_PORT;
+	}
+	if ((RIO_FAB_NO_DEV != a->lp[port_a].dev)
+			|| (RIO_FAB_NO_DEV != b->lp[port_b].dev)) {
+		return RIO_ERR_BAD_PORT;
+	}
+
+	a->lp[port_a].dev = dev_b;
+	a->lp[port_a].port = port_b;
+	b->lp[port_b].dev = dev_a;
+	b->lp[port_b].port = port_a;
+	rio_emu_set_link(a->emu, port_a, true);
+	rio_emu_set_link(b->emu, port_b, true);
+
+	return RIO_SUCCESS;
+}
+
+uint32_t rio_fab_set_mport(rio_fab_t *fab, uint32_t dev)
+{
+	if ((dev >= fab->cnt) || fab->devs[dev].sw) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+	if (RIO_FAB_NO_DEV == fab->devs[dev].lp[0].dev) {
+		return RIO_ERR_BAD_PORT;
+	}
+	fab->mport = dev;
+	return RIO_SUCCESS;
+}
+
+uint32_t rio_fab_num_devs(rio_fab_t *fab)
+{
+	return fab->cnt;
+}
+
+uint32_t rio_fab_get_mport(rio_fab_t *fab)
+{
+	return fab->mport;
+}
+
+const char *rio_fab_dev_name(rio_fab_t *fab, uint32_t dev)
+{
+	return (dev < fab->cnt) ? fab->devs[dev].name : NULL;
+}
+
+rio_emu_dev_t *rio_fab_get_emu(rio_fab_t *fab, uint32_t dev)
+{
+	return (dev < fab->cnt) ? fab->devs[dev].emu : NULL;
+}
+
+bool rio_fab_is_switch(rio_fab_t *fab, uint32_t dev)
+{
+	return (dev < fab->cnt) && fab->devs[dev].sw;
+}
+
+uint32_t rio_fab_get_lp(rio_fab_t *fab, uint32_t dev, uint8_t port,
+		uint32_t *lp_dev, uint8_t *lp_port)
+{
+	if ((dev >= fab->cnt) || (port >= fab->devs[dev].ports)
+			|| (RIO_FAB_NO_DEV == fab->devs[dev].lp[port].dev)) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+	*lp_dev = fab->devs[dev].lp[port].dev;
+	*lp_port = fab->devs[dev].lp[port].port;
+	return RIO_SUCCESS;
+}
+
+// Parses "<name>.<port>", and returns the device index and port.
+static bool fab_parse_dev_port(rio_fab_t *fab, char *tok, uint32_t *dev,
+		uint8_t *port)
+{
+	char *dot, *end;
+	unsigned long val;
+
+	if (NULL == tok) {
+		return false;
+	}
+
+	dot = strrchr(tok, '.');
+	if (NULL == dot) {
+		return false;
+	}
+	*dot = '\0';
+
+	val = strtoul(dot + 1, &end, 0);
+	if ((end == dot + 1) || *end || (val >= FAB_MAX_PORTS)) {
+		return false;
+	}
+
+	*dev = rio_fab_find_dev(fab, tok);
+	*port = (uint8_t)val;
+	return RIO_FAB_NO_DEV != *dev;
+}
+
+uint32_t rio_fab_parse(rio_fab_t *fab, FILE *fp, uint32_t *line)
+{
+	char buf[FAB_LINE_SZ];
+	char *tok, *save;
+	char *name;
+	rio_emu_model_t model;
+	uint32_t dev_a, dev_b;
+	uint8_t port_a, port_b;
+	uint32_t rc;
+
+	*line = 0;
+	while (NULL != fgets(buf, sizeof(buf), fp)) {
+		(*line)++;
+		tok = strtok_r(buf, FAB_DELIM, &save);
+		if ((NULL == tok) || !strncmp(tok, "//", 2)) {
+			continue;
+		}
+
+		if (!strcasecmp(tok, "DEVICE")) {
+			name = strtok_r(NULL, FAB_DELIM, &save);
+			tok = strtok_r(NULL, FAB_DELIM, &save);
+			if ((NULL == name) || (NULL == tok)) {
+				return RIO_ERR_INVALID_PARAMETER;
+			}
+			model = rio_emu_model_by_name(tok);
+			if (rio_emu_model_last == model) {
+				return RIO_ERR_NO_DEVICE_SUPPORT;
+			}
+			if (RIO_FAB_NO_DEV == rio_fab_add_dev(fab, name,
+					model)) {
+				return RIO_ERR_INVALID_PARAMETER;
+			}
+		} else if (!strcasecmp(tok, "CONNECT")) {
+			tok = strtok_r(NULL, FAB_DELIM, &save);
+			if (!fab_parse_dev_port(fab, tok, &dev_a, &port_a)) {
+				return RIO_ERR_INVALID_PARAMETER;
+			}
+			tok = strtok_r(NULL, FAB_DELIM, &save);
+			if (!fab_parse_dev_port(fab, tok, &dev_b, &port_b)) {
+				return RIO_ERR_INVALID_PARAMETER;
+			}
+			rc = rio_fab_connect(fab, dev_a, port_a, dev_b, port_b);
+			if (RIO_SUCCESS != rc) {
+				return rc;
+			}
+		} else if (!strcasecmp(tok, "MPORT")) {
+			tok = strtok_r(NULL, FAB_DELIM, &save);
+			if (NULL == tok) {
+				return RIO_ERR_INVALID_PARAMETER;
+			}
+			rc = rio_fab_set_mport(fab, rio_fab_find_dev(fab, tok));
+			if (RIO_SUCCESS != rc) {
+				return rc;
+			}
+		} else if (!strcasecmp(tok, "EOF")) {
+			break;
+		} else {
+			return RIO_ERR_INVALID_PARAMETER;
+		}
+	}
+
+	*line = 0;
+	return RIO_SUCCESS;
+}
+
+uint32_t rio_fab_load(rio_fab_t *fab, const char *fn, uint32_t *line)
+{
+	FILE *fp;
+	uint32_t rc;
+
+	*line = 0;
+	fp = fopen(fn, "r");
+	if (NULL == fp) {
+		return RIO_ERR_ACCESS;
+	}
+	rc = rio_fab_parse(fab, fp, line);
+	fclose(fp);
+	return rc;
+}
+
+uint32_t rio_fab_gen_tree(rio_fab_t *fab, rio_emu_model_t sw_model,
+		rio_emu_model_t ep_model, uint32_t nodes)
+{
+	char name[RIO_FAB_NAME_SZ + 1];
+	uint32_t sw_cnt, ep_cnt, first, i;
+	uint32_t mport, dev;
+	uint32_t sw, port;
+	uint8_t ports;
+	rio_emu_dev_t *emu;
+
+	emu = rio_emu_create(sw_model);
+	if (NULL == emu) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+	ports = rio_emu_num_ports(emu);
+	rio_emu_destroy(emu);
+
+	if ((nodes < 2) || (ports < 3)) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	// The switches have sw_cnt * (ports - 2) + 1 free ports, after
+	// connecting the switches to each other and to the master port.
+	sw_cnt = 1;
+	while ((nodes - sw_cnt - 1) > (sw_cnt * (ports - 2) + 1)) {
+		sw_cnt++;
+	}
+	ep_cnt = nodes - sw_cnt - 1;
+
+	mport = rio_fab_add_dev(fab, "mport", ep_model);
+	if ((RIO_FAB_NO_DEV == mport) || fab->devs[mport].sw) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	first = fab->cnt;
+	for (i = 0; i < sw_cnt; i++) {
+		snprintf(name, sizeof(name), "sw%u", i);
+		if (RIO_FAB_NO_DEV == rio_fab_add_dev(fab, name, sw_model)) {
+			return RIO_ERR_INSUFFICIENT_RESOURCES;
+		}
+	}
+
+	rio_fab_connect(fab, mport, 0, first, 0);
+
+	// Connect each switch, then each endpoint, to the next free port.
+	// Port 0 of each switch connects to its parent.
+	sw = first;
+	port = 1;
+	for (i = 1; i < sw_cnt + ep_cnt; i++) {
+		if (i < sw_cnt) {
+			dev = first + i;
+		} else {
+			snprintf(name, sizeof(name), "ep%u", i - sw_cnt);
+			dev = rio_fab_add_dev(fab, name, ep_model);
+			if ((RIO_FAB_NO_DEV == dev) || fab->devs[dev].sw) {
+				return RIO_ERR_INVALID_PARAMETER;
+			}
+		}
+		rio_fab_connect(fab, sw, (uint8_t)port, dev, 0);
+		if (++port == ports) {
+			sw++;
+			port = 1;
+		}
+	}
+
+	return rio_fab_set_mport(fab, mport);
+}
+
+void rio_fab_set_dev16(rio_fab_t *fab, bool dev16)
+{
+	pthread_mutex_lock(&fab->mtx);
+	fab->dev16 = dev16;
+	pthread_mutex_unlock(&fab->mtx);
+}
+
+bool rio_fab_get_dev16(rio_fab_t *fab)
+{
+	return fab->dev16;
+}
+
+void rio_fab_set_lat(rio_fab_t *fab, rio_fab_lat_t *lat)
+{
+	pthread_mutex_lock(&fab->mtx);
+	fab->lat = *lat;
+	pthread_mutex_unlock(&fab->mtx);
+}
+
+void rio_fab_get_stats(rio_fab_t *fab, rio_fab_stats_t *stats)
+{
+	pthread_mutex_lock(&fab->mtx);
+	*stats = fab->stats;
+	pthread_mutex_unlock(&fab->mtx);
+}
+
+void rio_fab_clr_stats(rio_fab_t *fab)
+{
+	uint32_t dev;
+
+	pthread_mutex_lock(&fab->mtx);
+	memset(&fab->stats, 0, sizeof(fab->stats));
+	for (dev = 0; dev < fab->cnt; dev++) {
+		rio_emu_clr_stats(fab->devs[dev].emu);
+	}
+	pthread_mutex_unlock(&fab->mtx);
+}
+
+uint32_t rio_fab_local_read(rio_fab_t *fab, uint32_t offset, uint32_t cnt,
+		uint32_t *data)
+{
+	if (RIO_FAB_NO_DEV == fab->mport) {
+		return RIO_ERR_ACCESS;
+	}
+
+	pthread_mutex_lock(&fab->mtx);
+	fab->stats.lcl_rd++;
+	pthread_mutex_unlock(&fab->mtx);
+
+	return rio_emu_read(fab->devs[fab->mport].emu, offset, cnt, data);
+}
+
+uint32_t rio_fab_local_write(rio_fab_t *fab, uint32_t offset, uint32_t cnt,
+		uint32_t *data)
+{
+	if (RIO_FAB_NO_DEV == fab->mport) {
+		return RIO_ERR_ACCESS;
+	}
+
+	pthread_mutex_lock(&fab->mtx);
+	fab->stats.lcl_wr++;
+	pthread_mutex_unlock(&fab->mtx);
+
+	return rio_emu_write(fab->devs[fab->mport].emu, offset, cnt, data);
+}
+
+// Follows the path of a maintenance request from the master port.  Returns
+// the target device, or RIO_FAB_NO_DEV if the request is dropped.  *hops
+// is the number of links crossed, and *port the port of the target device
+// which received the request.
+static uint32_t fab_route(rio_fab_t *fab, uint32_t did, uint8_t hc,
+		uint32_t *hops, uint8_t *port)
+{
+	fab_lp_t at = fab->devs[fab->mport].lp[0];
+	fab_dev_t *dev;
+	uint8_t out_port;
+
+	*hops = 0;
+	while (RIO_FAB_NO_DEV != at.dev) {
+		(*hops)++;
+		dev = &fab->devs[at.dev];
+		if (!dev->sw || !hc) {
+			*port = at.port;
+			return at.dev;
+		}
+		hc--;
+		if (RIO_SUCCESS != rio_emu_route(dev->emu, at.port, did,
+				fab->dev16, &out_port)) {
+			break;
+		}
+		at = dev->lp[out_port];
+	}
+	return RIO_FAB_NO_DEV;
+}
+
+static uint32_t fab_maint(rio_fab_t *fab, bool wr, uint32_t did, uint8_t hc,
+		uint32_t offset, uint32_t cnt, uint32_t *data, uint32_t *dev)
+{
+	uint32_t target, hops;
+	uint8_t port = 0;
+	uint64_t lat;
+	bool wait, sleep;
+	uint32_t rc;
+
+	if ((NULL == data) || !cnt) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+	if (RIO_FAB_NO_DEV == fab->mport) {
+		return RIO_ERR_ACCESS;
+	}
+
+	pthread_mutex_lock(&fab->mtx);
+	target = fab_route(fab, did, hc, &hops, &port);
+	if (wr) {
+		fab->stats.wr_acc++;
+	} else {
+		fab->stats.rd_acc++;
+	}
+	fab->stats.hops += hops;
+
+	// A dropped request has no response, so only the request is timed.
+	if (RIO_FAB_NO_DEV == target) {
+		lat = (uint64_t)fab->lat.hop_ns * hops;
+		fab->stats.fails++;
+	} else {
+		lat = (2 * (uint64_t)fab->lat.hop_ns * hops) + fab->lat.acc_ns
+				+ ((uint64_t)fab->lat.reg_ns * cnt);
+	}
+	fab->stats.lat_ns += lat;
+	wait = fab->lat.wait;
+	sleep = fab->lat.sleep;
+	pthread_mutex_unlock(&fab->mtx);
+
+	if (wait && sleep) {
+		rio_emu_sleep_ns(lat);
+	} else if (wait) {
+		rio_emu_wait_ns(lat);
+	}
+
+	if (RIO_FAB_NO_DEV == target) {
+		return RIO_ERR_ROUTE_ERROR;
+	}
+
+	if (NULL != dev) {
+		*dev = target;
+	}
+
+	// The access port and the access must not be split by a request
+	// from another thread.
+	pthread_mutex_lock(&fab->mtx);
+	if (fab->devs[target].sw) {
+		rio_emu_set_acc_port(fab->devs[target].emu, port);
+	}
+	if (wr) {
+		rc = rio_emu_write(fab->devs[target].emu, offset, cnt, data);
+	} else {
+		rc = rio_emu_read(fab->devs[target].emu, offset, cnt, data);
+	}
+	if (RIO_SUCCESS != rc) {
+		fab->stats.fails++;
+	}
+	pthread_mutex_unlock(&fab->mtx);
+	return rc;
+}
+
+uint32_t rio_fab_maint_read(rio_fab_t *fab, uint32_t did, uint8_t hc,
+		uint32_t offset, uint32_t cnt, uint32_t *data, uint32_t *dev)
+{
+	return fab_maint(fab, false, did, hc, offset, cnt, data, dev);
+}
+
+uint32_t rio_fab_maint_write(rio_fab_t *fab, uint32_t did, uint8_t hc,
+		uint32_t offset, uint32_t cnt, uint32_t *data, uint32_t *dev)
+{
+	return fab_maint(fab, true, did, hc, offset, cnt, data, dev);
+}
+
+#ifdef __cplusplus
+}
+#endif
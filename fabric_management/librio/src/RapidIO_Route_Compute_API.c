@@ -0,0 +1,1092 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+/* Fabric route computation
+ *
+ * See RapidIO_Route_Compute_API.h for a description of the routes
+ * computed.
+ *
+ * Endpoints are grouped by the switch(es) they connect to.  A breadth
+ * first search from each group gives the hop count from every switch to
+ * the group.  The ports of a switch on a shortest path to a group are the
+ * ports leading to a neighbour one hop closer to the group, so the
+ * candidate ports are found by comparing hop counts of neighbours.
+ * Hop counts are stored per switch (dist[sw * grp_cnt + grp]) so that
+ * the hop counts of a switch and its neighbours are contiguous.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "RapidIO_Route_Compute_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RR_NONE RIO_ROUTE_NO_NODE
+#define RR_INF ((uint16_t)(0xFFFF))
+#define RR_DIST_BATCH 32
+
+// Values of rr_ctx.dev_port entries which are not port numbers
+#define RR_DEV_UNSET (-1)
+#define RR_DEV_MC (-2)
+
+#define RR_BIT(p) ((uint32_t)(1) << (p))
+
+#define RR_DID_EP 1
+#define RR_DID_MC 2
+
+struct rr_ctx {
+	rio_route_compute_in_t *in;
+	rio_route_compute_out_t *out;
+	uint32_t did_cnt;	// Size of the destination ID space
+
+	uint32_t sw_cnt;
+	uint32_t *sw_node;	// Switch index to node index
+	uint32_t *sw_idx;	// Node index to switch index, or RR_NONE
+	uint32_t *nbr;		// Neighbour switch index of each switch port
+
+	uint32_t ep_cnt;
+	uint32_t *ep;		// Endpoint node indexes, sorted by destID
+	uint32_t *ep_grp;	// Destination group of each entry in ep
+	uint32_t dom_ep_st[RIO_RT_GRP_SZ + 1]; // Range of ep for each domain
+
+	uint32_t grp_cnt;
+	uint32_t *grp_src_st;	// Range of grp_src for each group
+	uint32_t *grp_src;	// Switches connected to each group
+
+	// Distinct groups of each domain, and endpoint count per group
+	uint32_t dom_grp_st[RIO_RT_GRP_SZ + 1];
+	uint32_t *dom_grp;
+	uint32_t *dom_grp_cnt;
+
+	uint16_t *dist;		// Hop count from each switch to each group
+	uint32_t *queue;
+
+	bool mc_dom[RIO_RT_GRP_SZ]; // Domain contains a multicast destID
+
+	// Per switch working storage
+	uint32_t *gmask;	// Candidate ports for each group
+	uint32_t load[RIO_MAX_PORTS]; // Destinations routed out of each port
+	int dev_port[RIO_RT_GRP_SZ];
+	pe_rt_val dom_val[RIO_RT_GRP_SZ];
+	uint32_t dom_cand[RIO_RT_GRP_SZ]; // Ports usable for the whole domain
+	uint32_t dom_weight[RIO_RT_GRP_SZ]; // Destinations in the domain
+};
+
+void rio_route_node_init(rio_route_node_t *node, bool is_sw, uint8_t port_cnt)
+{
+	uint8_t p;
+
+	memset(node, 0, sizeof(*node));
+	node->is_sw = is_sw;
+	node->port_cnt = port_cnt;
+	for (p = 0; p < RIO_MAX_PORTS; p++) {
+		node->link[p].peer = RR_NONE;
+	}
+}
+
+uint32_t rio_route_connect(rio_route_node_t *nodes, uint32_t node_cnt,
+		uint32_t n1, uint8_t p1, uint32_t n2, uint8_t p2)
+{
+	if ((NULL == nodes) || (n1 >= node_cnt) || (n2 >= node_cnt)
+			|| (p1 >= nodes[n1].port_cnt)
+			|| (p2 >= nodes[n2].port_cnt)) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	nodes[n1].link[p1].peer = n2;
+	nodes[n1].link[p1].peer_port = p2;
+	nodes[n2].link[p2].peer = n1;
+	nodes[n2].link[p2].peer_port = p1;
+	return RIO_SUCCESS;
+}
+
+static uint32_t rr_fail(struct rr_ctx *ctx, uint32_t rc, uint32_t imp_rc)
+{
+	ctx->out->imp_rc = imp_rc;
+	return rc;
+}
+
+static uint32_t rr_check_parms(struct rr_ctx *ctx, uint8_t *did_use)
+{
+	rio_route_compute_in_t *in = ctx->in;
+	uint32_t n, m, i;
+	uint8_t p;
+
+	for (n = 0; n < in->node_cnt; n++) {
+		rio_route_node_t *node = &in->nodes[n];
+
+		if (node->port_cnt > RIO_MAX_PORTS) {
+			return rr_fail(ctx, RIO_ERR_INVALID_PARAMETER,
+					RT_COMPUTE(3));
+		}
+
+		for (p = 0; p < node->port_cnt; p++) {
+			const rio_route_link_t *link = &node->link[p];
+
+			if (RR_NONE == link->peer) {
+				continue;
+			}
+			if ((link->peer >= in->node_cnt)
+					|| (link->peer_port
+					>= in->nodes[link->peer].port_cnt)
+					|| (in->nodes[link->peer].link[link->peer_port].peer
+							!= n)
+					|| (in->nodes[link->peer].link[link->peer_port].peer_port
+							!= p)) {
+				return rr_fail(ctx, RIO_ERR_INVALID_PARAMETER,
+						RT_COMPUTE(4));
+			}
+		}
+
+		if (node->is_sw) {
+			if (NULL == node->rt) {
+				return rr_fail(ctx, RIO_ERR_NULL_PARM_PTR,
+						RT_COMPUTE(5));
+			}
+			continue;
+		}
+
+		if (node->destID >= ctx->did_cnt) {
+			return rr_fail(ctx, RIO_ERR_INVALID_PARAMETER,
+					RT_COMPUTE(6));
+		}
+		if (did_use[node->destID]) {
+			return rr_fail(ctx, RIO_ERR_INVALID_PARAMETER,
+					RT_COMPUTE(7));
+		}
+		did_use[node->destID] = RR_DID_EP;
+	}
+
+	for (m = 0; m < in->mc_cnt; m++) {
+		rio_route_mc_grp_t *mc = &in->mc[m];
+
+		if ((mc->mc_destID >= ctx->did_cnt)
+				|| did_use[mc->mc_destID]) {
+			return rr_fail(ctx, RIO_ERR_INVALID_PARAMETER,
+					RT_COMPUTE(8));
+		}
+		did_use[mc->mc_destID] = RR_DID_MC;
+
+		if (mc->mbr_cnt && (NULL == mc->mbr)) {
+			return rr_fail(ctx, RIO_ERR_NULL_PARM_PTR,
+					RT_COMPUTE(9));
+		}
+		for (i = 0; i < mc->mbr_cnt; i++) {
+			if ((mc->mbr[i] >= in->node_cnt)
+					|| in->nodes[mc->mbr[i]].is_sw) {
+				return rr_fail(ctx, RIO_ERR_INVALID_PARAMETER,
+						RT_COMPUTE(0xA));
+			}
+		}
+		if (tt_dev16 == in->tt) {
+			ctx->mc_dom[mc->mc_destID >> 8] = true;
+		}
+	}
+	return RIO_SUCCESS;
+}
+
+// Numbers the switches and records the neighbour switch of each port
+static uint32_t rr_build_switches(struct rr_ctx *ctx)
+{
+	rio_route_compute_in_t *in = ctx->in;
+	uint32_t n, s;
+	uint8_t p;
+
+	ctx->sw_idx = (uint32_t *)malloc(in->node_cnt * sizeof(uint32_t));
+	if (NULL == ctx->sw_idx) {
+		return RIO_ERR_INSUFFICIENT_RESOURCES;
+	}
+
+	ctx->sw_cnt = 0;
+	for (n = 0; n < in->node_cnt; n++) {
+		ctx->sw_idx[n] = in->nodes[n].is_sw ? ctx->sw_cnt++ : RR_NONE;
+	}
+
+	ctx->ep_cnt = in->node_cnt - ctx->sw_cnt;
+	if (!ctx->sw_cnt) {
+		return RIO_SUCCESS;
+	}
+
+	ctx->sw_node = (uint32_t *)malloc(ctx->sw_cnt * sizeof(uint32_t));
+	ctx->nbr = (uint32_t *)malloc(
+			ctx->sw_cnt * RIO_MAX_PORTS * sizeof(uint32_t));
+	ctx->queue = (uint32_t *)malloc(ctx->sw_cnt * sizeof(uint32_t));
+	if ((NULL == ctx->sw_node) || (NULL == ctx->nbr)
+			|| (NULL == ctx->queue)) {
+		return RIO_ERR_INSUFFICIENT_RESOURCES;
+	}
+
+	for (n = 0; n < in->node_cnt; n++) {
+		rio_route_node_t *node = &in->nodes[n];
+		uint32_t *nbr;
+
+		if (!node->is_sw) {
+			continue;
+		}
+		s = ctx->sw_idx[n];
+		ctx->sw_node[s] = n;
+		nbr = &ctx->nbr[s * RIO_MAX_PORTS];
+		for (p = 0; p < RIO_MAX_PORTS; p++) {
+			nbr[p] = RR_NONE;
+			if ((p < node->port_cnt) && (RR_NONE != node->link[p].peer)) {
+				nbr[p] = ctx->sw_idx[node->link[p].peer];
+			}
+		}
+	}
+	return RIO_SUCCESS;
+}
+
+// Sorts endpoints by destID and assigns each endpoint to a destination group.
+// Endpoints connected to a single switch share the group of that switch,
+// endpoints connected to several switches get their own group.
+static uint32_t rr_build_groups(struct rr_ctx *ctx)
+{
+	rio_route_compute_in_t *in = ctx->in;
+	uint32_t *did_node = NULL;
+	uint32_t *sw_grp = NULL;
+	uint32_t *grp_mark = NULL;
+	uint32_t src_max = 0;
+	uint32_t did, n, i, g, d, s;
+	uint8_t p;
+	uint32_t rc = RIO_ERR_INSUFFICIENT_RESOURCES;
+
+	did_node = (uint32_t *)malloc(ctx->did_cnt * sizeof(uint32_t));
+	ctx->ep = (uint32_t *)malloc((ctx->ep_cnt + 1) * sizeof(uint32_t));
+	ctx->ep_grp = (uint32_t *)malloc((ctx->ep_cnt + 1) * sizeof(uint32_t));
+	if ((NULL == did_node) || (NULL == ctx->ep) || (NULL == ctx->ep_grp)) {
+		goto exit;
+	}
+
+	for (did = 0; did < ctx->did_cnt; did++) {
+		did_node[did] = RR_NONE;
+	}
+	for (n = 0; n < in->node_cnt; n++) {
+		if (in->nodes[n].is_sw) {
+			continue;
+		}
+		did_node[in->nodes[n].destID] = n;
+		for (p = 0; p < in->nodes[n].port_cnt; p++) {
+			uint32_t peer = in->nodes[n].link[p].peer;
+
+			if ((RR_NONE != peer) && in->nodes[peer].is_sw) {
+				src_max++;
+			}
+		}
+	}
+
+	i = 0;
+	memset(ctx->dom_ep_st, 0, sizeof(ctx->dom_ep_st));
+	for (did = 0; did < ctx->did_cnt; did++) {
+		if (RR_NONE != did_node[did]) {
+			ctx->ep[i++] = did_node[did];
+			ctx->dom_ep_st[(did >> 8) + 1] = i;
+		}
+	}
+	for (d = 1; d <= RIO_RT_GRP_SZ; d++) {
+		if (ctx->dom_ep_st[d] < ctx->dom_ep_st[d - 1]) {
+			ctx->dom_ep_st[d] = ctx->dom_ep_st[d - 1];
+		}
+	}
+
+	sw_grp = (uint32_t *)malloc((ctx->sw_cnt + 1) * sizeof(uint32_t));
+	ctx->grp_src_st = (uint32_t *)malloc(
+			(ctx->ep_cnt + 1) * sizeof(uint32_t));
+	ctx->grp_src = (uint32_t *)malloc((src_max + 1) * sizeof(uint32_t));
+	if ((NULL == sw_grp) || (NULL == ctx->grp_src_st)
+			|| (NULL == ctx->grp_src)) {
+		goto exit;
+	}
+	for (s = 0; s < ctx->sw_cnt; s++) {
+		sw_grp[s] = RR_NONE;
+	}
+
+	ctx->grp_cnt = 0;
+	ctx->grp_src_st[0] = 0;
+	for (i = 0; i < ctx->ep_cnt; i++) {
+		rio_route_node_t *node = &in->nodes[ctx->ep[i]];
+		uint32_t src_st = ctx->grp_src_st[ctx->grp_cnt];
+		uint32_t src_cnt = 0;
+
+		for (p = 0; p < node->port_cnt; p++) {
+			uint32_t peer = node->link[p].peer;
+			uint32_t j;
+
+			if ((RR_NONE == peer) || !in->nodes[peer].is_sw) {
+				continue;
+			}
+			s = ctx->sw_idx[peer];
+			for (j = 0; j < src_cnt; j++) {
+				if (ctx->grp_src[src_st + j] == s) {
+					break;
+				}
+			}
+			if (j == src_cnt) {
+				ctx->grp_src[src_st + src_cnt++] = s;
+			}
+		}
+
+		if (!src_cnt) {
+			ctx->ep_grp[i] = RR_NONE;
+			continue;
+		}
+
+		if (1 == src_cnt) {
+			s = ctx->grp_src[src_st];
+			if (RR_NONE != sw_grp[s]) {
+				ctx->ep_grp[i] = sw_grp[s];
+				continue;
+			}
+			sw_grp[s] = ctx->grp_cnt;
+		}
+		ctx->ep_grp[i] = ctx->grp_cnt++;
+		ctx->grp_src_st[ctx->grp_cnt] = src_st + src_cnt;
+	}
+
+	// Distinct groups of each domain
+	ctx->dom_grp = (uint32_t *)malloc((ctx->ep_cnt + 1) * sizeof(uint32_t));
+	ctx->dom_grp_cnt = (uint32_t *)calloc(ctx->ep_cnt + 1,
+			sizeof(uint32_t));
+	grp_mark = (uint32_t *)malloc((ctx->grp_cnt + 1) * sizeof(uint32_t));
+	if ((NULL == ctx->dom_grp) || (NULL == ctx->dom_grp_cnt)
+			|| (NULL == grp_mark)) {
+		goto exit;
+	}
+	for (g = 0; g < ctx->grp_cnt; g++) {
+		grp_mark[g] = RR_NONE;
+	}
+
+	ctx->dom_grp_st[0] = 0;
+	for (d = 0; d < RIO_RT_GRP_SZ; d++) {
+		uint32_t st = ctx->dom_grp_st[d];
+		uint32_t cnt = 0;
+
+		for (i = ctx->dom_ep_st[d]; i < ctx->dom_ep_st[d + 1]; i++) {
+			g = ctx->ep_grp[i];
+			if (RR_NONE == g) {
+				continue;
+			}
+			if (grp_mark[g] == RR_NONE || grp_mark[g] < st) {
+				grp_mark[g] = st + cnt;
+				ctx->dom_grp[st + cnt++] = g;
+			}
+			ctx->dom_grp_cnt[grp_mark[g]]++;
+		}
+		ctx->dom_grp_st[d + 1] = st + cnt;
+	}
+	rc = RIO_SUCCESS;
+exit:
+	free(did_node);
+	free(sw_grp);
+	free(grp_mark);
+	return rc;
+}
+
+// Breadth first search from every group to find the hop count of every
+// switch to every group.
+static uint32_t rr_compute_dist(struct rr_ctx *ctx)
+{
+	uint32_t g, g0, b, b_cnt, s, i, head, tail;
+	uint16_t *row, *tmp;
+	uint8_t p;
+
+	ctx->dist = (uint16_t *)malloc(
+			(size_t)ctx->sw_cnt * ctx->grp_cnt * sizeof(uint16_t));
+	tmp = (uint16_t *)malloc(
+			(size_t)RR_DIST_BATCH * ctx->sw_cnt * sizeof(uint16_t));
+	if ((NULL == ctx->dist) || (NULL == tmp)) {
+		free(tmp);
+		return RIO_ERR_INSUFFICIENT_RESOURCES;
+	}
+
+	// Each breadth first search runs over a contiguous row, rows are
+	// then copied into the switch major dist table a batch at a time.
+	for (g0 = 0; g0 < ctx->grp_cnt; g0 += RR_DIST_BATCH) {
+		b_cnt = ctx->grp_cnt - g0;
+		if (b_cnt > RR_DIST_BATCH) {
+			b_cnt = RR_DIST_BATCH;
+		}
+		memset(tmp, 0xFF, (size_t)b_cnt * ctx->sw_cnt * sizeof(uint16_t));
+
+		for (b = 0; b < b_cnt; b++) {
+			g = g0 + b;
+			row = &tmp[(size_t)b * ctx->sw_cnt];
+			head = tail = 0;
+			for (i = ctx->grp_src_st[g]; i < ctx->grp_src_st[g + 1];
+					i++) {
+				s = ctx->grp_src[i];
+				row[s] = 0;
+				ctx->queue[tail++] = s;
+			}
+
+			while (head < tail) {
+				uint32_t u = ctx->queue[head++];
+				uint16_t hops = row[u] + 1;
+				uint32_t *nbr = &ctx->nbr[u * RIO_MAX_PORTS];
+
+				for (p = 0; p < RIO_MAX_PORTS; p++) {
+					if (RR_NONE == nbr[p]) {
+						continue;
+					}
+					if (RR_INF == row[nbr[p]]) {
+						row[nbr[p]] = hops;
+						ctx->queue[tail++] = nbr[p];
+					}
+				}
+			}
+		}
+
+		for (s = 0; s < ctx->sw_cnt; s++) {
+			uint16_t *dst = &ctx->dist[(size_t)s * ctx->grp_cnt + g0];
+
+			for (b = 0; b < b_cnt; b++) {
+				dst[b] = tmp[(size_t)b * ctx->sw_cnt + s];
+			}
+		}
+	}
+	free(tmp);
+	return RIO_SUCCESS;
+}
+
+// Selects the least loaded port from cand, lowest port number wins ties
+static uint8_t rr_pick(struct rr_ctx *ctx, uint32_t cand, uint32_t weight)
+{
+	uint8_t best, p;
+
+	best = (uint8_t)__builtin_ctz(cand);
+	cand &= cand - 1;
+	while (cand) {
+		p = (uint8_t)__builtin_ctz(cand);
+		cand &= cand - 1;
+		if (ctx->load[p] < ctx->load[best]) {
+			best = p;
+		}
+	}
+	ctx->load[best] += weight;
+	return best;
+}
+
+// Returns the candidate ports of switch s for sorted endpoint i
+static uint32_t rr_ep_cand(struct rr_ctx *ctx, uint32_t s, uint32_t i)
+{
+	const rio_route_node_t *ep = &ctx->in->nodes[ctx->ep[i]];
+	uint32_t g = ctx->ep_grp[i];
+	uint32_t cand = 0;
+	uint8_t p;
+
+	if (RR_NONE == g) {
+		return 0;
+	}
+
+	switch (ctx->dist[(size_t)s * ctx->grp_cnt + g]) {
+	case RR_INF:
+		return 0;
+	case 0:
+		// Directly connected: the ports connected to the endpoint
+		for (p = 0; p < ep->port_cnt; p++) {
+			if (ep->link[p].peer == ctx->sw_node[s]) {
+				cand |= RR_BIT(ep->link[p].peer_port);
+			}
+		}
+		return cand;
+	default:
+		return ctx->gmask[g];
+	}
+}
+
+// Routes sorted endpoints first to last-1 using device table entries.
+// Destinations with a single candidate port are routed first (multi false)
+// so that the choice for destinations with several candidates sees the
+// load of the fixed routes.
+static void rr_route_dev(struct rr_ctx *ctx, uint32_t s, uint32_t first,
+		uint32_t last, bool multi)
+{
+	uint32_t i, cand;
+	int *dev_port;
+
+	for (i = first; i < last; i++) {
+		cand = rr_ep_cand(ctx, s, i);
+		if (!cand) {
+			if (!multi) {
+				ctx->out->unreachable++;
+			}
+			continue;
+		}
+		if (multi != !!(cand & (cand - 1))) {
+			continue;
+		}
+
+		dev_port = &ctx->dev_port[ctx->in->nodes[ctx->ep[i]].destID & 0xFF];
+		if (RR_DEV_UNSET == *dev_port) {
+			*dev_port = rr_pick(ctx, cand, 1);
+		} else if ((*dev_port >= 0) && (cand & RR_BIT(*dev_port))) {
+			ctx->load[*dev_port]++;
+		} else {
+			ctx->out->conflicts++;
+		}
+	}
+}
+
+// Finds the ports which are on a shortest path to every destination in
+// domain d.  Marks the domain as using the device table if there are none.
+static void rr_dom_cand(struct rr_ctx *ctx, uint32_t s, uint32_t d)
+{
+	const uint16_t *s_dist = &ctx->dist[(size_t)s * ctx->grp_cnt];
+	uint32_t cand = ~(uint32_t)0;
+	uint32_t weight = 0;
+	uint32_t unreachable = 0;
+	uint32_t i;
+
+	ctx->dom_cand[d] = 0;
+	for (i = ctx->dom_grp_st[d]; i < ctx->dom_grp_st[d + 1]; i++) {
+		uint32_t g = ctx->dom_grp[i];
+
+		if (RR_INF == s_dist[g]) {
+			unreachable += ctx->dom_grp_cnt[i];
+			continue;
+		}
+		if (!s_dist[g]) {
+			ctx->dom_val[d] = RIO_RTE_LVL_G0;
+			return;
+		}
+		cand &= ctx->gmask[g];
+		weight += ctx->dom_grp_cnt[i];
+	}
+
+	if (weight && !cand) {
+		ctx->dom_val[d] = RIO_RTE_LVL_G0;
+		return;
+	}
+
+	ctx->out->unreachable += unreachable;
+	if (weight) {
+		ctx->dom_cand[d] = cand;
+		ctx->dom_weight[d] = weight;
+	}
+}
+
+static uint32_t rr_set_rte(struct rr_ctx *ctx, rio_route_node_t *sw,
+		bool dom, uint32_t idx, pe_rt_val val)
+{
+	rio_rt_uc_info_t *rte;
+	rio_rt_change_rte_in_t chg_in;
+	rio_rt_change_rte_out_t chg_out;
+	uint32_t rc;
+
+	rte = dom ? &sw->rt->dom_table[idx] : &sw->rt->dev_table[idx];
+	if (rte->rte_val == val) {
+		return RIO_SUCCESS;
+	}
+	ctx->out->rte_chg++;
+
+	if (NULL == sw->dev_info) {
+		rte->rte_val = val;
+		rte->changed = true;
+		return RIO_SUCCESS;
+	}
+
+	chg_in.dom_entry = dom;
+	chg_in.idx = (uint8_t)idx;
+	chg_in.rte_value = val;
+	chg_in.rt = sw->rt;
+	rc = rio_rt_change_rte(sw->dev_info, &chg_in, &chg_out);
+	if (RIO_SUCCESS != rc) {
+		ctx->out->imp_rc = chg_out.imp_rc;
+	}
+	return rc;
+}
+
+// Writes the routes computed for switch s to its routing table state
+static uint32_t rr_apply_sw(struct rr_ctx *ctx, rio_route_node_t *sw)
+{
+	bool clear = ctx->in->clear_unused;
+	uint32_t idx;
+	uint32_t rc;
+
+	if (tt_dev16 == ctx->in->tt) {
+		for (idx = 0; idx < RIO_RT_GRP_SZ; idx++) {
+			pe_rt_val val = ctx->dom_val[idx];
+
+			if (RIO_RTE_BAD == val) {
+				if (!clear || RIO_RTV_IS_MC_MSK(
+						sw->rt->dom_table[idx].rte_val)) {
+					continue;
+				}
+				val = RIO_RTE_DROP;
+			}
+			rc = rr_set_rte(ctx, sw, true, idx, val);
+			if (RIO_SUCCESS != rc) {
+				return rc;
+			}
+		}
+	}
+
+	for (idx = 0; idx < RIO_RT_GRP_SZ; idx++) {
+		pe_rt_val val;
+
+		if (ctx->dev_port[idx] >= 0) {
+			val = (pe_rt_val)ctx->dev_port[idx];
+		} else if ((RR_DEV_UNSET == ctx->dev_port[idx]) && clear
+				&& !RIO_RTV_IS_MC_MSK(
+						sw->rt->dev_table[idx].rte_val)) {
+			val = RIO_RTE_DROP;
+		} else {
+			continue;
+		}
+		rc = rr_set_rte(ctx, sw, false, idx, val);
+		if (RIO_SUCCESS != rc) {
+			return rc;
+		}
+	}
+	return RIO_SUCCESS;
+}
+
+static uint32_t rr_route_sw(struct rr_ctx *ctx, uint32_t s)
+{
+	rio_route_node_t *sw = &ctx->in->nodes[ctx->sw_node[s]];
+	const uint16_t *s_dist = &ctx->dist[(size_t)s * ctx->grp_cnt];
+	const uint32_t *nbr = &ctx->nbr[s * RIO_MAX_PORTS];
+	uint32_t g, d, m, pass;
+	uint8_t p;
+
+	// Candidate ports towards each group not connected to this switch
+	memset(ctx->gmask, 0, ctx->grp_cnt * sizeof(uint32_t));
+	for (p = 0; p < RIO_MAX_PORTS; p++) {
+		const uint16_t *n_dist;
+
+		if (RR_NONE == nbr[p]) {
+			continue;
+		}
+		n_dist = &ctx->dist[(size_t)nbr[p] * ctx->grp_cnt];
+		for (g = 0; g < ctx->grp_cnt; g++) {
+			if ((RR_INF != n_dist[g]) && (n_dist[g] + 1 == s_dist[g])) {
+				ctx->gmask[g] |= RR_BIT(p);
+			}
+		}
+	}
+
+	memset(ctx->load, 0, sizeof(ctx->load));
+	for (d = 0; d < RIO_RT_GRP_SZ; d++) {
+		ctx->dev_port[d] = RR_DEV_UNSET;
+		ctx->dom_val[d] = RIO_RTE_BAD;
+		ctx->dom_cand[d] = 0;
+	}
+	for (m = 0; m < ctx->in->mc_cnt; m++) {
+		ctx->dev_port[ctx->in->mc[m].mc_destID & 0xFF] = RR_DEV_MC;
+	}
+
+	if (tt_dev8 == ctx->in->tt) {
+		rr_route_dev(ctx, s, 0, ctx->ep_cnt, false);
+		rr_route_dev(ctx, s, 0, ctx->ep_cnt, true);
+		return rr_apply_sw(ctx, sw);
+	}
+
+	// Domain 0 always uses the device table
+	ctx->dom_val[0] = RIO_RTE_LVL_G0;
+	for (d = 1; d < RIO_RT_GRP_SZ; d++) {
+		if (ctx->mc_dom[d]) {
+			ctx->dom_val[d] = RIO_RTE_LVL_G0;
+		} else if (ctx->dom_ep_st[d] != ctx->dom_ep_st[d + 1]) {
+			rr_dom_cand(ctx, s, d);
+		}
+	}
+
+	for (pass = 0; pass < 2; pass++) {
+		bool multi = pass ? true : false;
+
+		for (d = 0; d < RIO_RT_GRP_SZ; d++) {
+			uint32_t cand = ctx->dom_cand[d];
+
+			if (ctx->dom_ep_st[d] == ctx->dom_ep_st[d + 1]) {
+				continue;
+			}
+			if (RIO_RTE_LVL_G0 == ctx->dom_val[d]) {
+				rr_route_dev(ctx, s, ctx->dom_ep_st[d],
+						ctx->dom_ep_st[d + 1], multi);
+			} else if (cand && (multi == !!(cand & (cand - 1)))) {
+				ctx->dom_val[d] = rr_pick(ctx, cand,
+						ctx->dom_weight[d]);
+			}
+		}
+	}
+	return rr_apply_sw(ctx, sw);
+}
+
+static uint32_t rr_set_mc_mask(struct rr_ctx *ctx, rio_route_node_t *sw,
+		did_reg_t did, uint32_t mask)
+{
+	rio_rt_state_t *rt = sw->rt;
+	pe_rt_val mc_rte = RIO_RTE_BAD;
+	rio_rt_mc_info_t *info;
+	uint32_t idx;
+	uint32_t rc;
+
+	for (idx = 0; idx < RIO_MAX_MC_MASKS; idx++) {
+		if (rt->mc_masks[idx].in_use
+				&& (rt->mc_masks[idx].mc_destID == did)
+				&& (rt->mc_masks[idx].tt == ctx->in->tt)) {
+			mc_rte = RIO_RTV_MC_MSK(idx);
+			break;
+		}
+	}
+
+	ctx->out->mc_masks++;
+
+	if (NULL != sw->dev_info) {
+		rio_rt_alloc_mc_mask_in_t alloc_in;
+		rio_rt_alloc_mc_mask_out_t alloc_out;
+		rio_rt_change_mc_mask_in_t chg_in;
+		rio_rt_change_mc_mask_out_t chg_out;
+
+		if (RIO_RTE_BAD == mc_rte) {
+			alloc_in.rt = rt;
+			rc = rio_rt_alloc_mc_mask(sw->dev_info, &alloc_in,
+					&alloc_out);
+			if (RIO_SUCCESS != rc) {
+				ctx->out->imp_rc = alloc_out.imp_rc;
+				return rc;
+			}
+			mc_rte = alloc_out.mc_mask_rte;
+		} else if (rt->mc_masks[idx].mc_mask == mask) {
+			return rr_set_rte(ctx, sw, false, did & 0xFF, mc_rte);
+		}
+
+		chg_in.mc_mask_rte = mc_rte;
+		chg_in.mc_info.mc_destID = did;
+		chg_in.mc_info.tt = ctx->in->tt;
+		chg_in.mc_info.mc_mask = mask;
+		chg_in.mc_info.in_use = true;
+		chg_in.mc_info.allocd = true;
+		chg_in.mc_info.changed = true;
+		chg_in.rt = rt;
+		ctx->out->rte_chg++;
+		rc = rio_rt_change_mc_mask(sw->dev_info, &chg_in, &chg_out);
+		if (RIO_SUCCESS != rc) {
+			ctx->out->imp_rc = chg_out.imp_rc;
+			return rc;
+		}
+		return rr_set_rte(ctx, sw, false, did & 0xFF, mc_rte);
+	}
+
+	if (RIO_RTE_BAD == mc_rte) {
+		for (idx = 0; idx < RIO_MAX_MC_MASKS; idx++) {
+			if (!rt->mc_masks[idx].in_use
+					&& !rt->mc_masks[idx].allocd) {
+				break;
+			}
+		}
+		if (RIO_MAX_MC_MASKS == idx) {
+			return rr_fail(ctx, RIO_ERR_INSUFFICIENT_RESOURCES,
+					RT_COMPUTE(0x10));
+		}
+		mc_rte = RIO_RTV_MC_MSK(idx);
+	}
+
+	info = &rt->mc_masks[idx];
+	if (!info->in_use || (info->mc_mask != mask)) {
+		info->mc_destID = did;
+		info->tt = ctx->in->tt;
+		info->mc_mask = mask;
+		info->in_use = true;
+		info->allocd = true;
+		info->changed = true;
+		ctx->out->rte_chg++;
+	}
+	return rr_set_rte(ctx, sw, false, did & 0xFF, mc_rte);
+}
+
+// Routes a multicast destID on a switch which is not part of the tree
+static uint32_t rr_set_mc_port(struct rr_ctx *ctx, rio_route_node_t *sw,
+		did_reg_t did, uint8_t port)
+{
+	rio_rt_state_t *rt = sw->rt;
+	uint32_t idx;
+	uint32_t rc;
+
+	rc = rr_set_rte(ctx, sw, false, did & 0xFF, port);
+	if ((RIO_SUCCESS != rc) || (NULL != sw->dev_info)) {
+		return rc;
+	}
+
+	// Release a mask left over from a previous computation
+	for (idx = 0; idx < RIO_MAX_MC_MASKS; idx++) {
+		rio_rt_mc_info_t *info = &rt->mc_masks[idx];
+
+		if (info->in_use && (info->mc_destID == did)
+				&& (info->tt == ctx->in->tt)) {
+			info->mc_destID = 0;
+			info->mc_mask = 0;
+			info->in_use = false;
+			info->allocd = false;
+			info->changed = true;
+			ctx->out->rte_chg++;
+		}
+	}
+	return RIO_SUCCESS;
+}
+
+static uint32_t rr_route_mc(struct rr_ctx *ctx, uint32_t m, uint32_t *parent,
+		uint8_t *up_port, uint32_t *mask)
+{
+	rio_route_compute_in_t *in = ctx->in;
+	rio_route_mc_grp_t *mc = &in->mc[m];
+	uint32_t root = RR_NONE;
+	uint32_t head, tail, i, s, t;
+	uint8_t p, q;
+	uint32_t rc;
+
+	// The tree is rooted at the first member connected to a switch
+	for (i = 0; (i < mc->mbr_cnt) && (RR_NONE == root); i++) {
+		rio_route_node_t *ep = &in->nodes[mc->mbr[i]];
+
+		for (p = 0; p < ep->port_cnt; p++) {
+			if ((RR_NONE != ep->link[p].peer)
+					&& in->nodes[ep->link[p].peer].is_sw) {
+				root = ctx->sw_idx[ep->link[p].peer];
+				break;
+			}
+		}
+	}
+	if (RR_NONE == root) {
+		return RIO_SUCCESS;
+	}
+
+	for (s = 0; s < ctx->sw_cnt; s++) {
+		parent[s] = RR_NONE;
+		mask[s] = 0;
+	}
+
+	// Shortest path tree from the root.  The starting port is rotated
+	// for each group to spread groups across parallel links.
+	parent[root] = root;
+	head = tail = 0;
+	ctx->queue[tail++] = root;
+	while (head < tail) {
+		uint32_t u = ctx->queue[head++];
+		rio_route_node_t *node = &in->nodes[ctx->sw_node[u]];
+
+		for (q = 0; q < node->port_cnt; q++) {
+			uint32_t v;
+
+			p = (uint8_t)((q + m) % node->port_cnt);
+			v = ctx->nbr[u * RIO_MAX_PORTS + p];
+			if ((RR_NONE == v) || (RR_NONE != parent[v])) {
+				continue;
+			}
+			parent[v] = u;
+			up_port[v] = node->link[p].peer_port;
+			ctx->queue[tail++] = v;
+		}
+	}
+
+	// Add the branch from each member to the tree
+	for (i = 0; i < mc->mbr_cnt; i++) {
+		rio_route_node_t *ep = &in->nodes[mc->mbr[i]];
+
+		for (p = 0; p < ep->port_cnt; p++) {
+			if ((RR_NONE != ep->link[p].peer)
+					&& in->nodes[ep->link[p].peer].is_sw
+					&& (RR_NONE != parent[ctx->sw_idx[ep->link[p].peer]])) {
+				break;
+			}
+		}
+		if (p == ep->port_cnt) {
+			ctx->out->unreachable++;
+			continue;
+		}
+
+		t = ctx->sw_idx[ep->link[p].peer];
+		mask[t] |= RR_BIT(ep->link[p].peer_port);
+		while ((t != root) && !(mask[t] & RR_BIT(up_port[t]))) {
+			rio_route_node_t *node = &in->nodes[ctx->sw_node[t]];
+
+			mask[t] |= RR_BIT(up_port[t]);
+			q = node->link[up_port[t]].peer_port;
+			t = parent[t];
+			mask[t] |= RR_BIT(q);
+		}
+	}
+
+	for (s = 0; s < ctx->sw_cnt; s++) {
+		rio_route_node_t *sw = &in->nodes[ctx->sw_node[s]];
+
+		if (RR_NONE == parent[s]) {
+			ctx->out->unreachable++;
+			continue;
+		}
+		if (mask[s]) {
+			rc = rr_set_mc_mask(ctx, sw, mc->mc_destID, mask[s]);
+		} else {
+			rc = rr_set_mc_port(ctx, sw, mc->mc_destID, up_port[s]);
+		}
+		if (RIO_SUCCESS != rc) {
+			return rc;
+		}
+	}
+	return RIO_SUCCESS;
+}
+
+static uint32_t rr_route_all_mc(struct rr_ctx *ctx)
+{
+	uint32_t *parent;
+	uint8_t *up_port;
+	uint32_t *mask;
+	uint32_t m;
+	uint32_t rc = RIO_SUCCESS;
+
+	parent = (uint32_t *)malloc(ctx->sw_cnt * sizeof(uint32_t));
+	up_port = (uint8_t *)malloc(ctx->sw_cnt * sizeof(uint8_t));
+	mask = (uint32_t *)malloc(ctx->sw_cnt * sizeof(uint32_t));
+	if ((NULL == parent) || (NULL == up_port) || (NULL == mask)) {
+		rc = rr_fail(ctx, RIO_ERR_INSUFFICIENT_RESOURCES,
+				RT_COMPUTE(0x11));
+		goto exit;
+	}
+
+	for (m = 0; (m < ctx->in->mc_cnt) && (RIO_SUCCESS == rc); m++) {
+		rc = rr_route_mc(ctx, m, parent, up_port, mask);
+	}
+exit:
+	free(parent);
+	free(up_port);
+	free(mask);
+	return rc;
+}
+
+uint32_t rio_route_compute(rio_route_compute_in_t *in_parms,
+		rio_route_compute_out_t *out_parms)
+{
+	struct rr_ctx ctx;
+	uint8_t *did_use = NULL;
+	uint32_t s;
+	uint32_t rc;
+
+	if ((NULL == in_parms) || (NULL == out_parms)) {
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+
+	memset(out_parms, 0, sizeof(*out_parms));
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.in = in_parms;
+	ctx.out = out_parms;
+
+	if (!in_parms->node_cnt || (NULL == in_parms->nodes)
+			|| (in_parms->mc_cnt && (NULL == in_parms->mc))) {
+		return rr_fail(&ctx, RIO_ERR_NULL_PARM_PTR, RT_COMPUTE(1));
+	}
+
+	switch (in_parms->tt) {
+	case tt_dev8:
+		ctx.did_cnt = RIO_LAST_DEV8 + 1;
+		break;
+	case tt_dev16:
+		ctx.did_cnt = RIO_LAST_DEV16 + 1;
+		break;
+	default:
+		return rr_fail(&ctx, RIO_ERR_INVALID_PARAMETER, RT_COMPUTE(2));
+	}
+
+	did_use = (uint8_t *)calloc(ctx.did_cnt, sizeof(uint8_t));
+	if (NULL == did_use) {
+		return rr_fail(&ctx, RIO_ERR_INSUFFICIENT_RESOURCES,
+				RT_COMPUTE(0x12));
+	}
+
+	rc = rr_check_parms(&ctx, did_use);
+	free(did_use);
+	if (RIO_SUCCESS != rc) {
+		return rc;
+	}
+
+	rc = rr_build_switches(&ctx);
+	if ((RIO_SUCCESS != rc) || !ctx.sw_cnt) {
+		goto exit;
+	}
+
+	rc = rr_build_groups(&ctx);
+	if (RIO_SUCCESS != rc) {
+		goto exit;
+	}
+
+	rc = rr_compute_dist(&ctx);
+	if (RIO_SUCCESS != rc) {
+		goto exit;
+	}
+
+	ctx.gmask = (uint32_t *)malloc((ctx.grp_cnt + 1) * sizeof(uint32_t));
+	if (NULL == ctx.gmask) {
+		rc = RIO_ERR_INSUFFICIENT_RESOURCES;
+		goto exit;
+	}
+
+	for (s = 0; s < ctx.sw_cnt; s++) {
+		rc = rr_route_sw(&ctx, s);
+		if (RIO_SUCCESS != rc) {
+			goto exit;
+		}
+	}
+
+	rc = rr_route_all_mc(&ctx);
+	if (RIO_SUCCESS != rc) {
+		goto exit;
+	}
+
+	out_parms->sw_cnt = ctx.sw_cnt;
+	out_parms->dest_cnt = ctx.ep_cnt;
+exit:
+	if ((RIO_ERR_INSUFFICIENT_RESOURCES == rc)
+			&& (RIO_SUCCESS == out_parms->imp_rc)) {
+		out_parms->imp_rc = RT_COMPUTE(0x13);
+	}
+	free(ctx.sw_idx);
+	free(ctx.sw_node);
+	free(ctx.nbr);
+	free(ctx.queue);
+	free(ctx.ep);
+	free(ctx.ep_grp);
+	free(ctx.grp_src_st);
+	free(ctx.grp_src);
+	free(ctx.dom_grp);
+	free(ctx.dom_grp_cnt);
+	free(ctx.dist);
+	free(ctx.gmask);
+	return rc;
+}
+
+#ifdef __cplusplus
+}
+#endif
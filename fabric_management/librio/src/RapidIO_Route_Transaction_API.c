@@ -0,0 +1,593 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+/* Fabric route transactions
+ *
+ * See RapidIO_Route_Transaction_API.h for the write ordering.
+ *
+ * For each endpoint destination ID, the new routes are followed from every
+ * switch to find the number of switch hops to the endpoint.  Results are
+ * memoized per switch, so each destination costs one pass over the
+ * switches.  A changed entry used by a switch at distance d is written in
+ * phase 2*d, or 2*d+1 for a domain entry selecting the device table.
+ * Multicast masks are written in phase 0.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "RapidIO_Route_Transaction_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hop counts while following routes
+#define RT_TXN_UNKNOWN ((uint16_t)(0))
+#define RT_TXN_VISITING ((uint16_t)(0xFFFE))
+#define RT_TXN_INF ((uint16_t)(0xFFFF))
+
+// Entry phase values which are not phases
+#define RT_TXN_PH_NONE ((uint32_t)(0xFFFFFFFF)) // Not changed, or written
+#define RT_TXN_PH_UNSET ((uint32_t)(0xFFFFFFFE)) // Changed, routes nothing
+
+#define RT_TXN_PH_MC 0
+
+struct rt_txn_sw {
+	uint32_t node;
+	rio_route_node_t *n;
+	uint32_t dom_ph[RIO_RT_GRP_SZ];
+	uint32_t dev_ph[RIO_RT_GRP_SZ];
+	bool mc_chg[RIO_MAX_MC_MASKS];
+
+	// Sorted distinct phases with writes for this switch
+	uint32_t *ph_list;
+	uint32_t ph_cnt;
+	uint32_t ph_cur;
+};
+
+struct rt_txn_ctx {
+	rio_rt_txn_in_t *in;
+	rio_rt_txn_out_t *out;
+	uint32_t sw_cnt;
+	struct rt_txn_sw *sw;
+	uint32_t *sw_idx; // Node index to switch index
+	uint16_t *dist;
+	uint32_t *path;
+	uint32_t max_dist;
+
+	// Current phase
+	uint32_t ph;
+	uint32_t *job;
+	uint32_t job_cnt;
+	uint32_t next_job;
+	pthread_mutex_t lock;
+	uint32_t rc;
+};
+
+static uint32_t rt_txn_rte(rio_rt_state_t *rt, tt_t tt, did_reg_t did,
+		bool *dom_entry, uint8_t *idx)
+{
+	if (tt_dev16 == tt) {
+		*idx = (uint8_t)((did >> 8) & 0xFF);
+		if (RIO_RTE_LVL_G0 != rt->dom_table[*idx].rte_val) {
+			*dom_entry = true;
+			return rt->dom_table[*idx].rte_val;
+		}
+	}
+	*dom_entry = false;
+	*idx = (uint8_t)(did & 0xFF);
+	return rt->dev_table[*idx].rte_val;
+}
+
+// Returns the number of switch hops from switch s to the endpoint with
+// destination ID did following the new routes, or RT_TXN_INF.
+static uint16_t rt_txn_dist(struct rt_txn_ctx *ctx, uint32_t s, did_reg_t did)
+{
+	uint16_t next = RT_TXN_INF;
+	uint32_t path_len = 0;
+	uint32_t cur = s;
+
+	while (true) {
+		rio_route_node_t *n = ctx->sw[cur].n;
+		rio_route_link_t *link;
+		uint32_t rte;
+		bool dom_entry;
+		uint8_t idx;
+
+		if (RT_TXN_UNKNOWN != ctx->dist[cur]) {
+			if (RT_TXN_VISITING != ctx->dist[cur]) {
+				next = ctx->dist[cur];
+			}
+			break;
+		}
+		ctx->dist[cur] = RT_TXN_VISITING;
+		ctx->path[path_len++] = cur;
+
+		if (NULL == n->rt) {
+			break;
+		}
+		rte = rt_txn_rte(n->rt, ctx->in->tt, did, &dom_entry, &idx);
+		if (!RIO_RTV_IS_PORT(rte) || (rte >= n->port_cnt)) {
+			break;
+		}
+		link = &n->link[rte];
+		if (RIO_ROUTE_NO_NODE == link->peer) {
+			break;
+		}
+		if (!ctx->in->nodes[link->peer].is_sw) {
+			next = 0;
+			break;
+		}
+		cur = ctx->sw_idx[link->peer];
+	}
+
+	while (path_len) {
+		if (RT_TXN_INF != next) {
+			next++;
+		}
+		ctx->dist[ctx->path[--path_len]] = next;
+	}
+	return ctx->dist[s];
+}
+
+static void rt_txn_set_ph(uint32_t *ph, uint32_t val)
+{
+	if (RT_TXN_PH_NONE == *ph) {
+		return;
+	}
+	if ((RT_TXN_PH_UNSET == *ph) || (val > *ph)) {
+		*ph = val;
+	}
+}
+
+// Finds the phase of every changed entry
+static void rt_txn_order(struct rt_txn_ctx *ctx)
+{
+	rio_rt_txn_in_t *in = ctx->in;
+	uint32_t n, s;
+
+	for (n = 0; n < in->node_cnt; n++) {
+		did_reg_t did = in->nodes[n].destID;
+
+		if (in->nodes[n].is_sw) {
+			continue;
+		}
+
+		memset(ctx->dist, 0, ctx->sw_cnt * sizeof(ctx->dist[0]));
+		for (s = 0; s < ctx->sw_cnt; s++) {
+			struct rt_txn_sw *sw = &ctx->sw[s];
+			uint16_t d = rt_txn_dist(ctx, s, did);
+			bool dom_entry;
+			uint8_t idx;
+
+			if (RT_TXN_INF == d) {
+				continue;
+			}
+			if (d > ctx->max_dist) {
+				ctx->max_dist = d;
+			}
+
+			rt_txn_rte(sw->n->rt, in->tt, did, &dom_entry, &idx);
+			if (dom_entry) {
+				rt_txn_set_ph(&sw->dom_ph[idx], 2 * d);
+				continue;
+			}
+			rt_txn_set_ph(&sw->dev_ph[idx], 2 * d);
+			if (tt_dev16 == in->tt) {
+				rt_txn_set_ph(&sw->dom_ph[(did >> 8) & 0xFF],
+						(2 * d) + 1);
+			}
+		}
+	}
+}
+
+static int rt_txn_cmp(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+// Builds the sorted list of phases with writes for a switch
+static uint32_t rt_txn_sw_phases(struct rt_txn_sw *sw, uint32_t last)
+{
+	uint32_t tmp[(2 * RIO_RT_GRP_SZ) + 1];
+	uint32_t cnt = 0, i;
+
+	for (i = 0; i < RIO_RT_GRP_SZ; i++) {
+		if (RT_TXN_PH_UNSET == sw->dom_ph[i]) {
+			sw->dom_ph[i] = last;
+		}
+		if (RT_TXN_PH_UNSET == sw->dev_ph[i]) {
+			sw->dev_ph[i] = last;
+		}
+		if (RT_TXN_PH_NONE != sw->dom_ph[i]) {
+			tmp[cnt++] = sw->dom_ph[i];
+		}
+		if (RT_TXN_PH_NONE != sw->dev_ph[i]) {
+			tmp[cnt++] = sw->dev_ph[i];
+		}
+	}
+	for (i = 0; i < RIO_MAX_MC_MASKS; i++) {
+		if (sw->mc_chg[i]) {
+			tmp[cnt++] = RT_TXN_PH_MC;
+			break;
+		}
+	}
+	if (!cnt) {
+		return RIO_SUCCESS;
+	}
+
+	qsort(tmp, cnt, sizeof(tmp[0]), rt_txn_cmp);
+	sw->ph_list = (uint32_t *)malloc(cnt * sizeof(tmp[0]));
+	if (NULL == sw->ph_list) {
+		return RIO_ERR_INSUFFICIENT_RESOURCES;
+	}
+	for (i = 0; i < cnt; i++) {
+		if (!sw->ph_cnt || (sw->ph_list[sw->ph_cnt - 1] != tmp[i])) {
+			sw->ph_list[sw->ph_cnt++] = tmp[i];
+		}
+	}
+	return RIO_SUCCESS;
+}
+
+// Writes the entries of one switch for the current phase
+static uint32_t rt_txn_write_sw(struct rt_txn_ctx *ctx, struct rt_txn_sw *sw,
+		uint32_t *imp_rc)
+{
+	rio_rt_state_t *rt = sw->n->rt;
+	rio_rt_set_changed_in_t set_in;
+	rio_rt_set_changed_out_t set_out;
+	uint32_t ph = ctx->ph;
+	uint32_t rc, i;
+
+	// Only entries of this phase are marked as changed while writing
+	for (i = 0; i < RIO_MAX_MC_MASKS; i++) {
+		rt->mc_masks[i].changed = (RT_TXN_PH_MC == ph) && sw->mc_chg[i];
+	}
+	for (i = 0; i < RIO_RT_GRP_SZ; i++) {
+		rt->dom_table[i].changed = (sw->dom_ph[i] == ph);
+		rt->dev_table[i].changed = (sw->dev_ph[i] == ph);
+	}
+
+	set_in.set_on_port = RIO_ALL_PORTS;
+	set_in.rt = rt;
+	set_out.imp_rc = RIO_SUCCESS;
+	rc = rio_rt_set_changed(sw->n->dev_info, &set_in, &set_out);
+	*imp_rc = set_out.imp_rc;
+
+	// Restore changes of later phases, forget changes that were written
+	for (i = 0; i < RIO_MAX_MC_MASKS; i++) {
+		if (sw->mc_chg[i]) {
+			if (rt->mc_masks[i].changed || (RT_TXN_PH_MC != ph)) {
+				rt->mc_masks[i].changed = true;
+			} else {
+				sw->mc_chg[i] = false;
+			}
+		}
+	}
+	for (i = 0; i < RIO_RT_GRP_SZ; i++) {
+		if (RT_TXN_PH_NONE != sw->dom_ph[i]) {
+			if ((sw->dom_ph[i] == ph) && !rt->dom_table[i].changed) {
+				sw->dom_ph[i] = RT_TXN_PH_NONE;
+			} else {
+				rt->dom_table[i].changed = true;
+			}
+		}
+		if (RT_TXN_PH_NONE != sw->dev_ph[i]) {
+			if ((sw->dev_ph[i] == ph) && !rt->dev_table[i].changed) {
+				sw->dev_ph[i] = RT_TXN_PH_NONE;
+			} else {
+				rt->dev_table[i].changed = true;
+			}
+		}
+	}
+	return rc;
+}
+
+static void *rt_txn_worker(void *arg)
+{
+	struct rt_txn_ctx *ctx = (struct rt_txn_ctx *)arg;
+	DAR_wr_stats_t st0, st1;
+	uint32_t j, rc, imp_rc;
+
+	DAR_get_wr_stats(&st0);
+	while (true) {
+		j = __atomic_fetch_add(&ctx->next_job, 1, __ATOMIC_RELAXED);
+		if (j >= ctx->job_cnt) {
+			break;
+		}
+		rc = rt_txn_write_sw(ctx, &ctx->sw[ctx->job[j]], &imp_rc);
+		if (RIO_SUCCESS != rc) {
+			pthread_mutex_lock(&ctx->lock);
+			if (RIO_SUCCESS == ctx->rc) {
+				ctx->rc = rc;
+				ctx->out->imp_rc = imp_rc;
+				ctx->out->fail_node = ctx->sw[ctx->job[j]].node;
+			}
+			pthread_mutex_unlock(&ctx->lock);
+		}
+	}
+	DAR_get_wr_stats(&st1);
+
+	pthread_mutex_lock(&ctx->lock);
+	ctx->out->reg_wr += st1.reg_wr - st0.reg_wr;
+	ctx->out->blk_wr += st1.blk_wr - st0.blk_wr;
+	pthread_mutex_unlock(&ctx->lock);
+	return NULL;
+}
+
+// Writes all switches with changes in the current phase
+static void rt_txn_run_phase(struct rt_txn_ctx *ctx)
+{
+	pthread_t thr[RIO_RT_TXN_MAX_THREADS];
+	uint32_t thr_cnt, t, s;
+
+	ctx->job_cnt = 0;
+	ctx->next_job = 0;
+	for (s = 0; s < ctx->sw_cnt; s++) {
+		struct rt_txn_sw *sw = &ctx->sw[s];
+
+		if ((sw->ph_cur < sw->ph_cnt)
+				&& (sw->ph_list[sw->ph_cur] == ctx->ph)) {
+			ctx->job[ctx->job_cnt++] = s;
+			sw->ph_cur++;
+		}
+	}
+
+	thr_cnt = ctx->in->thread_cnt;
+	if (thr_cnt > ctx->job_cnt) {
+		thr_cnt = ctx->job_cnt;
+	}
+	if (thr_cnt > RIO_RT_TXN_MAX_THREADS) {
+		thr_cnt = RIO_RT_TXN_MAX_THREADS;
+	}
+
+	for (t = 0; (thr_cnt > 1) && (t < thr_cnt); t++) {
+		if (pthread_create(&thr[t], NULL, rt_txn_worker, ctx)) {
+			break;
+		}
+	}
+	// The calling thread always works too, and finishes the phase
+	// if threads could not be created.
+	rt_txn_worker(ctx);
+	while ((thr_cnt > 1) && t) {
+		pthread_join(thr[--t], NULL);
+	}
+}
+
+static uint32_t rt_txn_fail(struct rt_txn_ctx *ctx, uint32_t rc,
+		uint32_t imp_rc)
+{
+	ctx->out->imp_rc = imp_rc;
+	return rc;
+}
+
+// Records the changes of each switch, and checks parameters
+static uint32_t rt_txn_setup(struct rt_txn_ctx *ctx)
+{
+	rio_rt_txn_in_t *in = ctx->in;
+	uint32_t n, s, i;
+	uint8_t p;
+
+	for (n = 0; n < in->node_cnt; n++) {
+		rio_route_node_t *node = &in->nodes[n];
+
+		if (node->port_cnt > RIO_MAX_PORTS) {
+			ctx->out->fail_node = n;
+			return rt_txn_fail(ctx, RIO_ERR_INVALID_PARAMETER,
+					RT_TXN(4));
+		}
+		for (p = 0; p < node->port_cnt; p++) {
+			if ((RIO_ROUTE_NO_NODE != node->link[p].peer)
+				&& (node->link[p].peer >= in->node_cnt)) {
+				ctx->out->fail_node = n;
+				return rt_txn_fail(ctx,
+						RIO_ERR_INVALID_PARAMETER,
+						RT_TXN(5));
+			}
+		}
+		ctx->sw_idx[n] = RIO_ROUTE_NO_NODE;
+		if (node->is_sw) {
+			ctx->sw_idx[n] = ctx->sw_cnt++;
+		}
+	}
+
+	for (n = 0; n < in->node_cnt; n++) {
+		rio_route_node_t *node = &in->nodes[n];
+		struct rt_txn_sw *sw;
+		bool chg = false;
+
+		if (!node->is_sw) {
+			continue;
+		}
+		s = ctx->sw_idx[n];
+		sw = &ctx->sw[s];
+		sw->node = n;
+		sw->n = node;
+		for (i = 0; i < RIO_RT_GRP_SZ; i++) {
+			sw->dom_ph[i] = RT_TXN_PH_NONE;
+			sw->dev_ph[i] = RT_TXN_PH_NONE;
+		}
+		if (NULL == node->rt) {
+			continue;
+		}
+
+		for (i = 0; i < RIO_RT_GRP_SZ; i++) {
+			if (node->rt->dom_table[i].changed) {
+				sw->dom_ph[i] = RT_TXN_PH_UNSET;
+				ctx->out->rte_cnt++;
+				chg = true;
+			}
+			if (node->rt->dev_table[i].changed) {
+				sw->dev_ph[i] = RT_TXN_PH_UNSET;
+				ctx->out->rte_cnt++;
+				chg = true;
+			}
+		}
+		for (i = 0; i < RIO_MAX_MC_MASKS; i++) {
+			sw->mc_chg[i] = node->rt->mc_masks[i].changed;
+			if (sw->mc_chg[i]) {
+				ctx->out->mc_cnt++;
+				chg = true;
+			}
+		}
+		if (!chg) {
+			continue;
+		}
+		if (NULL == node->dev_info) {
+			ctx->out->fail_node = n;
+			return rt_txn_fail(ctx, RIO_ERR_INVALID_PARAMETER,
+					RT_TXN(6));
+		}
+		ctx->out->sw_cnt++;
+	}
+	return RIO_SUCCESS;
+}
+
+uint32_t rio_rt_txn_commit(rio_rt_txn_in_t *in_parms,
+		rio_rt_txn_out_t *out_parms)
+{
+	struct rt_txn_ctx ctx;
+	struct timespec st, end;
+	bool *used = NULL;
+	uint32_t rc, s, ph, last;
+
+	if (NULL == out_parms) {
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+	memset(out_parms, 0, sizeof(*out_parms));
+	out_parms->fail_node = RIO_ROUTE_NO_NODE;
+	if (NULL == in_parms) {
+		out_parms->imp_rc = RT_TXN(1);
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+	if ((tt_dev8 != in_parms->tt) && (tt_dev16 != in_parms->tt)) {
+		out_parms->imp_rc = RT_TXN(2);
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+	if (in_parms->node_cnt && (NULL == in_parms->nodes)) {
+		out_parms->imp_rc = RT_TXN(3);
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.in = in_parms;
+	ctx.out = out_parms;
+	pthread_mutex_init(&ctx.lock, NULL);
+
+	rc = RIO_ERR_INSUFFICIENT_RESOURCES;
+	out_parms->imp_rc = RT_TXN(0x10);
+	ctx.sw_idx = (uint32_t *)malloc(
+			(in_parms->node_cnt + 1) * sizeof(ctx.sw_idx[0]));
+	ctx.sw = (struct rt_txn_sw *)calloc(in_parms->node_cnt + 1,
+			sizeof(ctx.sw[0]));
+	ctx.dist = (uint16_t *)malloc(
+			(in_parms->node_cnt + 1) * sizeof(ctx.dist[0]));
+	ctx.path = (uint32_t *)malloc(
+			(in_parms->node_cnt + 1) * sizeof(ctx.path[0]));
+	ctx.job = (uint32_t *)malloc(
+			(in_parms->node_cnt + 1) * sizeof(ctx.job[0]));
+	if ((NULL == ctx.sw_idx) || (NULL == ctx.sw) || (NULL == ctx.dist)
+			|| (NULL == ctx.path) || (NULL == ctx.job)) {
+		goto exit;
+	}
+	out_parms->imp_rc = RIO_SUCCESS;
+
+	rc = rt_txn_setup(&ctx);
+	if ((RIO_SUCCESS != rc) || !out_parms->sw_cnt) {
+		goto exit;
+	}
+
+	rt_txn_order(&ctx);
+
+	last = (2 * ctx.max_dist) + 2;
+	used = (bool *)calloc(last + 1, sizeof(bool));
+	if (NULL == used) {
+		rc = rt_txn_fail(&ctx, RIO_ERR_INSUFFICIENT_RESOURCES,
+				RT_TXN(0x11));
+		goto exit;
+	}
+	for (s = 0; s < ctx.sw_cnt; s++) {
+		rc = rt_txn_sw_phases(&ctx.sw[s], last);
+		if (RIO_SUCCESS != rc) {
+			rc = rt_txn_fail(&ctx, rc, RT_TXN(0x12));
+			goto exit;
+		}
+		for (ph = 0; ph < ctx.sw[s].ph_cnt; ph++) {
+			used[ctx.sw[s].ph_list[ph]] = true;
+		}
+	}
+
+	for (ph = 0; (ph <= last) && (RIO_SUCCESS == ctx.rc); ph++) {
+		if (!used[ph]) {
+			continue;
+		}
+		ctx.ph = ph;
+		out_parms->phase_cnt++;
+		rt_txn_run_phase(&ctx);
+	}
+	rc = ctx.rc;
+
+exit:
+	if (ctx.sw) {
+		for (s = 0; s < ctx.sw_cnt; s++) {
+			free(ctx.sw[s].ph_list);
+		}
+	}
+	free(used);
+	free(ctx.sw_idx);
+	free(ctx.sw);
+	free(ctx.dist);
+	free(ctx.path);
+	free(ctx.job);
+	pthread_mutex_destroy(&ctx.lock);
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	out_parms->usecs = ((uint64_t)(end.tv_sec - st.tv_sec) * 1000000)
+			+ (end.tv_nsec / 1000) - (st.tv_nsec / 1000);
+	return rc;
+}
+
+#ifdef __cplusplus
+}
+#endif
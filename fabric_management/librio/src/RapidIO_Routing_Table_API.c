@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "CPS_DeviceDriver.h"
 #include "RXS_DeviceDriver.h"
@@ -178,6 +179,7 @@ uint32_t rio_rt_initialize(DAR_DEV_INFO_t *dev_info,
 	NULL_CHECK
 
 	if (VALIDATE_DEV_INFO(dev_info)) {
+		rio_rt_probe_snap_invalidate(dev_info);
 		//@sonar:off - c:S1871, c:S3458
 		switch (dev_info->driver_family) {
 		case RIO_CPS_DEVICE:
@@ -271,6 +273,7 @@ uint32_t rio_rt_set_all(DAR_DEV_INFO_t *dev_info, rio_rt_set_all_in_t *in_parms,
 	NULL_CHECK
 
 	if (VALIDATE_DEV_INFO(dev_info)) {
+		rio_rt_probe_snap_invalidate(dev_info);
 		//@sonar:off - c:S1871, c:S3458
 		switch (dev_info->driver_family) {
 		case RIO_CPS_DEVICE:
@@ -300,6 +303,7 @@ uint32_t rio_rt_set_changed(DAR_DEV_INFO_t *dev_info,
 	NULL_CHECK
 
 	if (VALIDATE_DEV_INFO(dev_info)) {
+		rio_rt_probe_snap_invalidate(dev_info);
 		//@sonar:off - c:S1871, c:S3458
 		switch (dev_info->driver_family) {
 		case RIO_CPS_DEVICE:
@@ -333,6 +337,7 @@ uint32_t rio_rt_alloc_mc_mask(DAR_DEV_INFO_t *dev_info,
 	NULL_CHECK
 
 	if (VALIDATE_DEV_INFO(dev_info)) {
+		rio_rt_probe_snap_invalidate(dev_info);
 		//@sonar:off - c:S1871, c:S3458
 		switch (dev_info->driver_family) {
 		case RIO_CPS_DEVICE:
@@ -367,6 +372,7 @@ uint32_t rio_rt_dealloc_mc_mask(DAR_DEV_INFO_t *dev_info,
 	NULL_CHECK
 
 	if (VALIDATE_DEV_INFO(dev_info)) {
+		rio_rt_probe_snap_invalidate(dev_info);
 		//@sonar:off - c:S1871, c:S3458
 		switch (dev_info->driver_family) {
 		case RIO_CPS_DEVICE:
@@ -400,6 +406,7 @@ uint32_t rio_rt_change_rte(DAR_DEV_INFO_t *dev_info,
 	NULL_CHECK
 
 	if (VALIDATE_DEV_INFO(dev_info)) {
+		rio_rt_probe_snap_invalidate(dev_info);
 		//@sonar:off - c:S1871, c:S3458
 		switch (dev_info->driver_family) {
 		case RIO_CPS_DEVICE:
@@ -433,6 +440,7 @@ uint32_t rio_rt_change_mc_mask(DAR_DEV_INFO_t *dev_info,
 	NULL_CHECK
 
 	if (VALIDATE_DEV_INFO(dev_info)) {
+		rio_rt_probe_snap_invalidate(dev_info);
 		//@sonar:off - c:S1871, c:S3458
 		switch (dev_info->driver_family) {
 		case RIO_CPS_DEVICE:
@@ -459,6 +467,308 @@ uint32_t rio_rt_change_mc_mask(DAR_DEV_INFO_t *dev_info,
 	return DAR_DB_INVALID_HANDLE;
 }
 
+void rio_rt_probe_snap_invalidate(DAR_DEV_INFO_t *dev_info)
+{
+	dev_info->rt_gen++;
+}
+
+bool rio_rt_probe_snap_valid(DAR_DEV_INFO_t *dev_info,
+		rio_rt_probe_snap_t *snap, uint8_t probe_on_port)
+{
+	return (NULL != dev_info) && (NULL != snap) && snap->valid
+			&& (snap->dev_info == dev_info)
+			&& (snap->rt_gen == dev_info->rt_gen)
+			&& (snap->probe_on_port == probe_on_port);
+}
+
+uint32_t rio_rt_probe_snap(DAR_DEV_INFO_t *dev_info,
+		rio_rt_probe_snap_in_t *in_parms,
+		rio_rt_probe_snap_out_t *out_parms)
+{
+	uint32_t rc;
+	uint32_t idx;
+	uint8_t port;
+	rio_rt_probe_snap_t *snap;
+	rio_rt_probe_all_in_t all_in;
+	rio_rt_probe_all_out_t all_out;
+	rio_rt_probe_in_t pr_in;
+	rio_rt_state_t rt;
+
+	NULL_CHECK
+
+	if (!VALIDATE_DEV_INFO(dev_info)) {
+		return DAR_DB_INVALID_HANDLE;
+	}
+
+	out_parms->imp_rc = RIO_SUCCESS;
+	snap = in_parms->snap;
+	if (NULL == snap) {
+		out_parms->imp_rc = RT_PROBE_SNAP(1);
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+
+	snap->valid = false;
+	snap->num_ports = NUM_PORTS(dev_info);
+	if (snap->num_ports > RIO_MAX_PORTS) {
+		snap->num_ports = RIO_MAX_PORTS;
+	}
+	if ((in_parms->probe_on_port >= snap->num_ports)
+			&& (RIO_ALL_PORTS != in_parms->probe_on_port)) {
+		out_parms->imp_rc = RT_PROBE_SNAP(2);
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	// Routing changes made while the snapshot is taken invalidate it
+	snap->dev_info = dev_info;
+	snap->rt_gen = dev_info->rt_gen;
+	snap->probe_on_port = in_parms->probe_on_port;
+
+	all_in.probe_on_port = in_parms->probe_on_port;
+	all_in.rt = &snap->rt;
+	rc = rio_rt_probe_all(dev_info, &all_in, &all_out);
+	if (RIO_SUCCESS != rc) {
+		out_parms->imp_rc = all_out.imp_rc;
+		return rc;
+	}
+
+	// Probe destID 0 using a routing table which drops it, then routes
+	// it to each port in turn.
+	memset(&rt, 0, sizeof(rt));
+	rt.default_route = RIO_RTE_DROP;
+	for (idx = 0; idx < RIO_RT_GRP_SZ; idx++) {
+		rt.dev_table[idx].rte_val = RIO_RTE_DROP;
+		rt.dom_table[idx].rte_val = RIO_RTE_DROP;
+	}
+	rt.dom_table[0].rte_val = RIO_RTE_LVL_G0;
+
+	pr_in.probe_on_port = in_parms->probe_on_port;
+	pr_in.tt = tt_dev8;
+	pr_in.destID = 0;
+	pr_in.rt = &rt;
+
+	memset(&snap->base, 0, sizeof(snap->base));
+	rc = rio_rt_probe(dev_info, &pr_in, &snap->base);
+	if (RIO_SUCCESS != rc) {
+		out_parms->imp_rc = snap->base.imp_rc;
+		return rc;
+	}
+
+	for (port = 0; port < snap->num_ports; port++) {
+		rt.dev_table[0].rte_val = RIO_RTV_PORT(port);
+		memset(&snap->port[port], 0, sizeof(snap->port[port]));
+		rc = rio_rt_probe(dev_info, &pr_in, &snap->port[port]);
+		if (RIO_SUCCESS != rc) {
+			out_parms->imp_rc = snap->port[port].imp_rc;
+			return rc;
+		}
+	}
+
+	snap->valid = true;
+	return RIO_SUCCESS;
+}
+
+// Default route discard reasons are the port discard reasons, offset
+static rio_rt_disc_reason_t rio_rt_snap_dflt_reason(rio_rt_disc_reason_t r)
+{
+	if ((r >= rio_rt_disc_port_unavail)
+			&& (r <= rio_rt_disc_port_in_out_dis)) {
+		return (rio_rt_disc_reason_t)(r - rio_rt_disc_port_unavail
+				+ rio_rt_disc_dflt_pt_unavail);
+	}
+	return r;
+}
+
+// Applies the cached status of a port used by a route
+static void rio_rt_snap_port(rio_rt_probe_snap_t *snap, rio_port_t port,
+		bool dflt_port, rio_rt_probe_out_t *out_parms)
+{
+	rio_rt_probe_out_t *pt;
+
+	if (port >= snap->num_ports) {
+		out_parms->valid_route = false;
+		out_parms->reason_for_discard = rio_rt_disc_probe_abort;
+		out_parms->imp_rc = RT_PROBE_BATCH(0x10);
+		return;
+	}
+
+	pt = &snap->port[port];
+	out_parms->filter_function_active |= pt->filter_function_active;
+	if (rio_rt_disc_not != pt->reason_for_discard) {
+		out_parms->valid_route = false;
+		out_parms->reason_for_discard = (dflt_port) ?
+				rio_rt_snap_dflt_reason(pt->reason_for_discard) :
+				pt->reason_for_discard;
+	}
+}
+
+// Determines the route for a destination ID, as rio_rt_probe would,
+// from the snapshot.
+static void rio_rt_snap_eval(DAR_DEV_INFO_t *dev_info,
+		rio_rt_probe_snap_t *snap, tt_t tt, did_reg_t destID,
+		rio_rt_probe_out_t *out_parms)
+{
+	rio_rt_probe_in_t pr_in;
+	pe_rt_val rte;
+	rio_port_t port;
+	bool dflt_port;
+	rio_rt_disc_reason_t reason = rio_rt_disc_not;
+
+	out_parms->imp_rc = RIO_SUCCESS;
+	out_parms->valid_route = false;
+	out_parms->routing_table_value = RIO_ALL_PORTS;
+	out_parms->default_route = snap->rt.default_route;
+	out_parms->filter_function_active =
+			snap->base.filter_function_active;
+	out_parms->trace_function_active = snap->base.trace_function_active;
+	out_parms->time_to_live_active = snap->base.time_to_live_active;
+	for (port = 0; port < snap->num_ports; port++) {
+		out_parms->mcast_ports[port] = false;
+	}
+	out_parms->reason_for_discard = rio_rt_disc_probe_abort;
+
+	pr_in.probe_on_port = snap->probe_on_port;
+	pr_in.tt = tt;
+	pr_in.destID = destID;
+	pr_in.rt = &snap->rt;
+
+	if (RIO_RXS_DEVICE == dev_info->driver_family) {
+		rxs_rio_rt_check_routing(dev_info, &pr_in, out_parms);
+	} else {
+		// Multicast routes are not checked for discards
+		rio_rt_check_multicast_routing(dev_info, &pr_in, out_parms);
+		if (RIO_ALL_PORTS != out_parms->routing_table_value) {
+			return;
+		}
+		rio_rt_check_unicast_routing(dev_info, &pr_in, out_parms);
+	}
+
+	if (!out_parms->valid_route) {
+		return;
+	}
+
+	rte = out_parms->routing_table_value;
+	dflt_port = (RIO_RTE_DFLT_PORT == rte);
+	if (dflt_port) {
+		rte = out_parms->default_route;
+	}
+
+	if (RIO_RTV_IS_PORT(rte)) {
+		rio_rt_snap_port(snap, (rio_port_t)RIO_RTV_GET_PORT(rte),
+				dflt_port, out_parms);
+		return;
+	}
+
+	// Multicast mask, remove ports which discard packets
+	for (port = 0; port < snap->num_ports; port++) {
+		if ((port == snap->probe_on_port)
+				|| !out_parms->mcast_ports[port]) {
+			continue;
+		}
+		out_parms->valid_route = true;
+		out_parms->reason_for_discard = rio_rt_disc_not;
+		rio_rt_snap_port(snap, port, false, out_parms);
+		if (!out_parms->valid_route) {
+			out_parms->mcast_ports[port] = false;
+			reason = out_parms->reason_for_discard;
+		}
+	}
+
+	out_parms->valid_route = false;
+	for (port = 0; port < snap->num_ports; port++) {
+		if (out_parms->mcast_ports[port]) {
+			out_parms->valid_route = true;
+			break;
+		}
+	}
+	out_parms->reason_for_discard = (out_parms->valid_route) ?
+						rio_rt_disc_not : reason;
+}
+
+uint32_t rio_rt_probe_batch(DAR_DEV_INFO_t *dev_info,
+		rio_rt_probe_batch_in_t *in_parms,
+		rio_rt_probe_batch_out_t *out_parms)
+{
+	uint32_t rc;
+	uint32_t i;
+	rio_rt_probe_snap_in_t snap_in;
+	rio_rt_probe_snap_out_t snap_out;
+
+	NULL_CHECK
+
+	if (!VALIDATE_DEV_INFO(dev_info)) {
+		return DAR_DB_INVALID_HANDLE;
+	}
+
+	out_parms->imp_rc = RIO_SUCCESS;
+	out_parms->snap_taken = false;
+
+	if ((NULL == in_parms->snap) || (in_parms->destID_cnt
+			&& ((NULL == in_parms->destIDs)
+				|| (NULL == in_parms->probe_out)))) {
+		out_parms->imp_rc = RT_PROBE_BATCH(1);
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+
+	switch (in_parms->tt) {
+	case tt_dev8:
+		for (i = 0; i < in_parms->destID_cnt; i++) {
+			if (in_parms->destIDs[i] > RIO_LAST_DEV8) {
+				out_parms->imp_rc = RT_PROBE_BATCH(2);
+				return RIO_ERR_INVALID_PARAMETER;
+			}
+		}
+		break;
+	case tt_dev16:
+		break;
+	default:
+		out_parms->imp_rc = RT_PROBE_BATCH(3);
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	if (!rio_rt_probe_snap_valid(dev_info, in_parms->snap,
+			in_parms->probe_on_port)) {
+		snap_in.probe_on_port = in_parms->probe_on_port;
+		snap_in.snap = in_parms->snap;
+		rc = rio_rt_probe_snap(dev_info, &snap_in, &snap_out);
+		if (RIO_SUCCESS != rc) {
+			out_parms->imp_rc = snap_out.imp_rc;
+			return rc;
+		}
+		out_parms->snap_taken = true;
+	}
+
+	for (i = 0; i < in_parms->destID_cnt; i++) {
+		rio_rt_snap_eval(dev_info, in_parms->snap, in_parms->tt,
+				in_parms->destIDs[i], &in_parms->probe_out[i]);
+	}
+	return RIO_SUCCESS;
+}
+
+uint32_t rio_rt_probe_cached(DAR_DEV_INFO_t *dev_info,
+		rio_rt_probe_cached_in_t *in_parms,
+		rio_rt_probe_out_t *out_parms)
+{
+	uint32_t rc;
+	rio_rt_probe_batch_in_t b_in;
+	rio_rt_probe_batch_out_t b_out;
+
+	NULL_CHECK
+
+	b_out.imp_rc = RIO_SUCCESS;
+	b_in.snap = in_parms->snap;
+	b_in.probe_on_port = in_parms->probe_on_port;
+	b_in.tt = in_parms->tt;
+	b_in.destID_cnt = 1;
+	b_in.destIDs = &in_parms->destID;
+	b_in.probe_out = out_parms;
+
+	rc = rio_rt_probe_batch(dev_info, &b_in, &b_out);
+	if (RIO_SUCCESS != rc) {
+		out_parms->imp_rc = b_out.imp_rc;
+	}
+	return rc;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "RapidIO_Device_Access_Routines_API.h"
 #include "RapidIO_Statistics_Counter_API.h"
+#include "RapidIO_Utilities_API.h"
 #include "rio_standard.h"
 #include "rio_ecosystem.h"
 
@@ -213,6 +214,43 @@ uint32_t rio_sc_read_ctrs(DAR_DEV_INFO_t *dev_info,
 	return DAR_DB_INVALID_HANDLE;
 }
 
+uint32_t rio_sc_accum_ctrs(rio_sc_ctr_val_t **ctrs,
+		DAR_read_entry_out_t *rd_out, uint32_t cnt, bool wrap)
+{
+	uint32_t first_fail = cnt;
+	uint64_t tot, l_c, c_c;
+	uint32_t i;
+
+	for (i = 0; i < cnt; i++) {
+		if (RIO_SUCCESS != rd_out[i].rc) {
+			if (cnt == first_fail) {
+				first_fail = i;
+			}
+			continue;
+		}
+
+		if (!wrap) {
+			ctrs[i]->last_inc = rd_out[i].value_read;
+			ctrs[i]->total += rd_out[i].value_read;
+			continue;
+		}
+
+		// Keep the upper 32 bits of the total, and add one to them
+		// if the counter is below the value last read.
+		tot = (uint64_t)ctrs[i]->total;
+		l_c = tot & (uint64_t)0x00000000FFFFFFFF;
+		c_c = rd_out[i].value_read;
+		tot = (tot & (uint64_t)0xFFFFFFFF00000000) | c_c;
+		if (l_c > c_c) {
+			tot += (uint64_t)0x0000000100000000;
+			c_c |= (uint64_t)0x0000000100000000;
+		}
+		ctrs[i]->last_inc = (uint32_t)(c_c - l_c);
+		ctrs[i]->total = (long long)tot;
+	}
+	return first_fail;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,792 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+/* Packet and control symbol trace captures
+ *
+ * See RapidIO_Trace_API.h for the capture file format.
+ *
+ * Scans map the capture and hand out chunks of blocks to worker threads.
+ * Each worker decodes records into its own batch, filters the batch and
+ * adds the selected records to its own aggregates.  The aggregates of
+ * the workers are summed when the scan completes.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "RapidIO_Device_Access_Routines_API.h"
+#include "RapidIO_Trace_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of blocks handed to a worker at a time
+#define RIO_TRACE_CHUNK_BLKS 16
+
+static bool rio_trace_blk_size_ok(uint32_t blk_size)
+{
+	return (blk_size >= RIO_TRACE_MIN_BLK_SIZE)
+			&& (blk_size <= RIO_TRACE_MAX_BLK_SIZE)
+			&& !(blk_size & (blk_size - 1));
+}
+
+/* Capture writer */
+
+static uint32_t rio_trace_wr_zero(rio_trace_wr_t *wr, uint32_t len)
+{
+	static const uint8_t zero[RIO_TRACE_REC_ALIGN * 4] = {0};
+	uint32_t cnt;
+
+	while (len) {
+		cnt = (len > sizeof(zero)) ? sizeof(zero) : len;
+		if (fwrite(zero, 1, cnt, wr->fp) != cnt) {
+			return RIO_ERR_ACCESS;
+		}
+		wr->blk_used += cnt;
+		len -= cnt;
+	}
+	return RIO_SUCCESS;
+}
+
+static uint32_t rio_trace_wr_rec(rio_trace_wr_t *wr, uint64_t ts,
+		uint8_t port, rio_trace_rec_kind_t kind, uint8_t flags,
+		const uint8_t *data, uint16_t len)
+{
+	rio_trace_rec_hdr_t hdr;
+	uint32_t rec_size = RIO_TRACE_REC_SIZE(len);
+	uint32_t rc;
+
+	if (NULL == wr->fp) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	// Records never span blocks.  The rest of the block is zero, which
+	// reads as a rio_trace_rec_end record.
+	if (wr->blk_used + rec_size > wr->blk_size) {
+		rc = rio_trace_wr_zero(wr, wr->blk_size - wr->blk_used);
+		if (RIO_SUCCESS != rc) {
+			return rc;
+		}
+		wr->blk_used = 0;
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.ts = ts;
+	hdr.len = len;
+	hdr.kind = (uint8_t)kind;
+	hdr.port = port;
+	hdr.flags = flags;
+
+	if ((fwrite(&hdr, 1, sizeof(hdr), wr->fp) != sizeof(hdr))
+			|| (fwrite(data, 1, len, wr->fp) != len)) {
+		return RIO_ERR_ACCESS;
+	}
+	wr->blk_used += sizeof(hdr) + len;
+	wr->rec_cnt++;
+
+	return rio_trace_wr_zero(wr, rec_size - sizeof(hdr) - len);
+}
+
+uint32_t rio_trace_wr_open(rio_trace_wr_t *wr, const char *path,
+		uint32_t blk_size, rio_addr_size addr_size)
+{
+	rio_trace_file_hdr_t hdr;
+
+	if ((NULL == wr) || (NULL == path)) {
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+
+	wr->fp = NULL;
+	if (!blk_size) {
+		blk_size = RIO_TRACE_DFLT_BLK_SIZE;
+	}
+	if (!rio_trace_blk_size_ok(blk_size) || (addr_size > rio_addr_66)) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	wr->fp = fopen(path, "wb");
+	if (NULL == wr->fp) {
+		return RIO_ERR_ACCESS;
+	}
+	wr->blk_size = blk_size;
+	wr->blk_used = 0;
+	wr->rec_cnt = 0;
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, RIO_TRACE_MAGIC, RIO_TRACE_MAGIC_LEN);
+	hdr.version = RIO_TRACE_VERSION;
+	hdr.blk_size = blk_size;
+	hdr.addr_size = (uint32_t)addr_size;
+
+	if (fwrite(&hdr, 1, sizeof(hdr), wr->fp) != sizeof(hdr)) {
+		fclose(wr->fp);
+		wr->fp = NULL;
+		return RIO_ERR_ACCESS;
+	}
+	wr->blk_used = sizeof(hdr);
+	return RIO_SUCCESS;
+}
+
+uint32_t rio_trace_wr_pkt(rio_trace_wr_t *wr, uint64_t ts, uint8_t port,
+		DAR_pkt_bytes_t *pkt)
+{
+	if ((NULL == wr) || (NULL == pkt)) {
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+	if (!pkt->num_chars || (pkt->num_chars > RIO_MAX_PKT_BYTES)) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	return rio_trace_wr_rec(wr, ts, port, rio_trace_rec_pkt,
+			pkt->pkt_has_crc ? RIO_TRACE_PKT_HAS_CRC : 0,
+			pkt->pkt_data, (uint16_t)pkt->num_chars);
+}
+
+uint32_t rio_trace_wr_cs(rio_trace_wr_t *wr, uint64_t ts, uint8_t port,
+		CS_bytes_t *cs)
+{
+	if ((NULL == wr) || (NULL == cs)) {
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+	if ((cs_small != cs->cs_type_valid)
+				&& (cs_large != cs->cs_type_valid)) {
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	return rio_trace_wr_rec(wr, ts, port, rio_trace_rec_cs,
+			(uint8_t)cs->cs_type_valid, cs->cs_bytes,
+			sizeof(cs->cs_bytes));
+}
+
+uint32_t rio_trace_wr_close(rio_trace_wr_t *wr)
+{
+	uint32_t rc = RIO_SUCCESS;
+
+	if (NULL == wr) {
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+	if (NULL == wr->fp) {
+		return RIO_SUCCESS;
+	}
+	if (fclose(wr->fp)) {
+		rc = RIO_ERR_ACCESS;
+	}
+	wr->fp = NULL;
+	return rc;
+}
+
+/* Capture reader */
+
+uint32_t rio_trace_open(rio_trace_t *trace, const char *path)
+{
+	rio_trace_file_hdr_t hdr;
+	struct stat st;
+	void *base;
+
+	if ((NULL == trace) || (NULL == path)) {
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+
+	trace->base = NULL;
+	trace->fd = open(path, O_RDONLY);
+	if (trace->fd < 0) {
+		return RIO_ERR_ACCESS;
+	}
+
+	if (fstat(trace->fd, &st) || (st.st_size < (off_t)sizeof(hdr))) {
+		goto fail;
+	}
+
+	base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, trace->fd, 0);
+	if (MAP_FAILED == base) {
+		goto fail;
+	}
+	madvise(base, st.st_size, MADV_SEQUENTIAL);
+
+	memcpy(&hdr, base, sizeof(hdr));
+	if (memcmp(hdr.magic, RIO_TRACE_MAGIC, RIO_TRACE_MAGIC_LEN)
+			|| (RIO_TRACE_VERSION != hdr.version)
+			|| !rio_trace_blk_size_ok(hdr.blk_size)
+			|| (hdr.addr_size > rio_addr_66)) {
+		munmap(base, st.st_size);
+		goto fail;
+	}
+
+	trace->base = (const uint8_t *)base;
+	trace->size = st.st_size;
+	trace->blk_size = hdr.blk_size;
+	trace->blk_cnt = (trace->size + hdr.blk_size - 1) / hdr.blk_size;
+	trace->addr_size = (rio_addr_size)hdr.addr_size;
+	return RIO_SUCCESS;
+
+fail:
+	close(trace->fd);
+	trace->fd = -1;
+	return RIO_ERR_INVALID_PARAMETER;
+}
+
+void rio_trace_close(rio_trace_t *trace)
+{
+	if ((NULL == trace) || (NULL == trace->base)) {
+		return;
+	}
+	munmap((void *)trace->base, trace->size);
+	close(trace->fd);
+	trace->base = NULL;
+	trace->fd = -1;
+}
+
+/* Filters and aggregates */
+
+void rio_trace_filter_batch(rio_trace_batch_t *batch,
+		rio_trace_filter_t *filter)
+{
+	uint32_t i, n;
+	bool pkt_filt;
+
+	if (NULL == filter) {
+		for (i = 0; i < batch->pkt_cnt; i++) {
+			batch->pkt_sel[i] = (uint16_t)i;
+		}
+		batch->pkt_sel_cnt = batch->pkt_cnt;
+		for (i = 0; i < batch->cs_cnt; i++) {
+			batch->cs_sel[i] = (uint16_t)i;
+		}
+		batch->cs_sel_cnt = batch->cs_cnt;
+		return;
+	}
+
+	// Each filter is a pass over one column of the selected records
+	n = 0;
+	for (i = 0; i < batch->pkt_cnt; i++) {
+		if ((batch->pkt_ts[i] >= filter->ts_min)
+				&& (!filter->ts_max
+					|| (batch->pkt_ts[i] <= filter->ts_max))) {
+			batch->pkt_sel[n++] = (uint16_t)i;
+		}
+	}
+	batch->pkt_sel_cnt = n;
+
+#define RIO_TRACE_FILT(cond) { \
+	uint32_t f_i, f_n = 0; \
+	for (f_i = 0; f_i < batch->pkt_sel_cnt; f_i++) { \
+		uint16_t r = batch->pkt_sel[f_i]; \
+		if (cond) { \
+			batch->pkt_sel[f_n++] = r; \
+		} \
+	} \
+	batch->pkt_sel_cnt = f_n; \
+}
+
+	if (filter->ftype_mask) {
+		RIO_TRACE_FILT((1 << batch->ftype[r]) & filter->ftype_mask);
+	}
+	if (filter->dest_en) {
+		RIO_TRACE_FILT(batch->dest[r] == filter->dest);
+	}
+	if (filter->src_en) {
+		RIO_TRACE_FILT(batch->src[r] == filter->src);
+	}
+	if (filter->port_mask) {
+		RIO_TRACE_FILT(((uint64_t)1 << (batch->pkt_port[r] & 63))
+				& filter->port_mask);
+	}
+	if (rio_trace_crc_ok == filter->crc) {
+		RIO_TRACE_FILT(batch->pkt_flags[r] & RIO_TRACE_F_CRC_OK);
+	} else if (rio_trace_crc_bad == filter->crc) {
+		RIO_TRACE_FILT(!(batch->pkt_flags[r] & RIO_TRACE_F_CRC_OK));
+	}
+#undef RIO_TRACE_FILT
+
+	pkt_filt = filter->ftype_mask || filter->dest_en || filter->src_en;
+	n = 0;
+	if (!pkt_filt && !filter->no_cs) {
+		for (i = 0; i < batch->cs_cnt; i++) {
+			if ((batch->cs_ts[i] < filter->ts_min)
+					|| (filter->ts_max
+					&& (batch->cs_ts[i] > filter->ts_max))) {
+				continue;
+			}
+			if (filter->port_mask
+				&& !(((uint64_t)1 << (batch->cs_port[i] & 63))
+						& filter->port_mask)) {
+				continue;
+			}
+			if ((rio_trace_crc_ok == filter->crc)
+				&& !(batch->cs_flags[i] & RIO_TRACE_F_CRC_OK)) {
+				continue;
+			}
+			if ((rio_trace_crc_bad == filter->crc)
+				&& (batch->cs_flags[i] & RIO_TRACE_F_CRC_OK)) {
+				continue;
+			}
+			batch->cs_sel[n++] = (uint16_t)i;
+		}
+	}
+	batch->cs_sel_cnt = n;
+}
+
+static uint32_t rio_trace_agg_init(rio_trace_agg_t *agg, rio_trace_grp_t grp)
+{
+	memset(agg, 0, sizeof(*agg));
+	agg->ts_first = UINT64_MAX;
+	agg->grp = grp;
+	if (rio_trace_grp_none == grp) {
+		return RIO_SUCCESS;
+	}
+
+	agg->grp_pkts = (uint64_t *)calloc(RIO_TRACE_GRP_KEYS,
+							sizeof(uint64_t));
+	agg->grp_wire = (uint64_t *)calloc(RIO_TRACE_GRP_KEYS,
+							sizeof(uint64_t));
+	agg->grp_data = (uint64_t *)calloc(RIO_TRACE_GRP_KEYS,
+							sizeof(uint64_t));
+	if ((NULL == agg->grp_pkts) || (NULL == agg->grp_wire)
+						|| (NULL == agg->grp_data)) {
+		rio_trace_agg_free(agg);
+		return RIO_ERR_INSUFFICIENT_RESOURCES;
+	}
+	return RIO_SUCCESS;
+}
+
+void rio_trace_agg_free(rio_trace_agg_t *agg)
+{
+	if (NULL == agg) {
+		return;
+	}
+	free(agg->grp_pkts);
+	free(agg->grp_wire);
+	free(agg->grp_data);
+	agg->grp_pkts = NULL;
+	agg->grp_wire = NULL;
+	agg->grp_data = NULL;
+}
+
+static void rio_trace_agg_batch(rio_trace_agg_t *agg,
+		rio_trace_batch_t *batch)
+{
+	uint32_t i, key;
+	uint16_t r;
+
+	for (i = 0; i < batch->pkt_sel_cnt; i++) {
+		r = batch->pkt_sel[i];
+		agg->wire_bytes += batch->len[r];
+		agg->data_bytes += batch->bytes[r];
+		agg->ftype[batch->ftype[r]]++;
+		if (!(batch->pkt_flags[r] & RIO_TRACE_F_CRC_OK)) {
+			agg->crc_errs++;
+		}
+		if (batch->pkt_ts[r] < agg->ts_first) {
+			agg->ts_first = batch->pkt_ts[r];
+		}
+		if (batch->pkt_ts[r] > agg->ts_last) {
+			agg->ts_last = batch->pkt_ts[r];
+		}
+	}
+	agg->pkts += batch->pkt_sel_cnt;
+
+	if (rio_trace_grp_none != agg->grp) {
+		for (i = 0; i < batch->pkt_sel_cnt; i++) {
+			r = batch->pkt_sel[i];
+			switch (agg->grp) {
+			case rio_trace_grp_dest:
+				key = batch->dest[r];
+				break;
+			case rio_trace_grp_src:
+				key = batch->src[r];
+				break;
+			case rio_trace_grp_ftype:
+				key = batch->ftype[r];
+				break;
+			default:
+				key = batch->pkt_port[r];
+				break;
+			}
+			key &= RIO_TRACE_GRP_KEYS - 1;
+			agg->grp_pkts[key]++;
+			agg->grp_wire[key] += batch->len[r];
+			agg->grp_data[key] += batch->bytes[r];
+		}
+	}
+
+	for (i = 0; i < batch->cs_sel_cnt; i++) {
+		r = batch->cs_sel[i];
+		agg->stype0[batch->stype0[r] & 7]++;
+		agg->stype1[batch->stype1[r] & 7]++;
+		if (!(batch->cs_flags[r] & RIO_TRACE_F_CRC_OK)) {
+			agg->crc_errs++;
+		}
+		if (batch->cs_ts[r] < agg->ts_first) {
+			agg->ts_first = batch->cs_ts[r];
+		}
+		if (batch->cs_ts[r] > agg->ts_last) {
+			agg->ts_last = batch->cs_ts[r];
+		}
+	}
+	agg->cs += batch->cs_sel_cnt;
+}
+
+static void rio_trace_agg_sum(rio_trace_agg_t *agg, rio_trace_agg_t *add)
+{
+	uint32_t i;
+
+	agg->recs += add->recs;
+	agg->decode_errs += add->decode_errs;
+	agg->pkts += add->pkts;
+	agg->cs += add->cs;
+	agg->wire_bytes += add->wire_bytes;
+	agg->data_bytes += add->data_bytes;
+	agg->crc_errs += add->crc_errs;
+	if (add->ts_first < agg->ts_first) {
+		agg->ts_first = add->ts_first;
+	}
+	if (add->ts_last > agg->ts_last) {
+		agg->ts_last = add->ts_last;
+	}
+	for (i = 0; i < 16; i++) {
+		agg->ftype[i] += add->ftype[i];
+	}
+	for (i = 0; i < 8; i++) {
+		agg->stype0[i] += add->stype0[i];
+		agg->stype1[i] += add->stype1[i];
+	}
+	if (rio_trace_grp_none != agg->grp) {
+		for (i = 0; i < RIO_TRACE_GRP_KEYS; i++) {
+			agg->grp_pkts[i] += add->grp_pkts[i];
+			agg->grp_wire[i] += add->grp_wire[i];
+			agg->grp_data[i] += add->grp_data[i];
+		}
+	}
+}
+
+/* Scans */
+
+typedef struct rio_trace_scan_ctx_t_TAG {
+	rio_trace_scan_in_t *in_parms;
+	pthread_mutex_t lock;
+
+	// Next block to hand out
+	uint64_t next_blk;
+} rio_trace_scan_ctx_t;
+
+typedef struct rio_trace_worker_t_TAG {
+	rio_trace_scan_ctx_t *ctx;
+	rio_trace_batch_t *batch;
+	rio_trace_agg_t agg;
+} rio_trace_worker_t;
+
+static void rio_trace_flush(rio_trace_worker_t *wk)
+{
+	rio_trace_scan_in_t *in_parms = wk->ctx->in_parms;
+	rio_trace_batch_t *batch = wk->batch;
+
+	if (!batch->pkt_cnt && !batch->cs_cnt) {
+		return;
+	}
+
+	rio_trace_filter_batch(batch, in_parms->filter);
+	rio_trace_agg_batch(&wk->agg, batch);
+	if (NULL != in_parms->batch_fn) {
+		pthread_mutex_lock(&wk->ctx->lock);
+		in_parms->batch_fn(batch, in_parms->batch_arg);
+		pthread_mutex_unlock(&wk->ctx->lock);
+	}
+	batch->pkt_cnt = 0;
+	batch->cs_cnt = 0;
+}
+
+static void rio_trace_decode_pkt(rio_trace_worker_t *wk,
+		rio_trace_rec_hdr_t *hdr, const uint8_t *data, uint64_t off)
+{
+	rio_trace_batch_t *batch = wk->batch;
+	uint32_t i = batch->pkt_cnt;
+	DAR_pkt_summary_t summ;
+	uint32_t rc;
+
+	rc = DAR_pkt_bytes_to_summary(data, hdr->len,
+			wk->ctx->in_parms->trace->addr_size,
+			hdr->flags & RIO_TRACE_PKT_HAS_CRC, &summ);
+	if (RIO_SUCCESS != rc) {
+		wk->agg.decode_errs++;
+	}
+
+	batch->pkt_ts[i] = hdr->ts;
+	batch->pkt_off[i] = off;
+	batch->addr[i] = summ.addr;
+	batch->dest[i] = summ.destID;
+	batch->src[i] = summ.srcID;
+	batch->bytes[i] = (uint16_t)summ.pkt_bytes;
+	batch->ftype[i] = summ.ftype;
+	batch->pkt_type[i] = (uint8_t)summ.pkt_type;
+	batch->tt[i] = (uint8_t)summ.tt_code;
+	batch->prio[i] = summ.prio;
+	batch->tid[i] = summ.tid;
+	batch->len[i] = hdr->len;
+	batch->pkt_port[i] = hdr->port;
+	batch->pkt_flags[i] = (summ.crc_ok ? RIO_TRACE_F_CRC_OK : 0)
+			| ((RIO_SUCCESS == rc) ? RIO_TRACE_F_DECODE_OK : 0);
+	batch->pkt_cnt = i + 1;
+}
+
+static void rio_trace_decode_cs(rio_trace_worker_t *wk,
+		rio_trace_rec_hdr_t *hdr, const uint8_t *data)
+{
+	rio_trace_batch_t *batch = wk->batch;
+	uint32_t i = batch->cs_cnt;
+	CS_bytes_t cs;
+	CS_field_t fields;
+	uint32_t rc;
+
+	memset(&cs, 0, sizeof(cs));
+	cs.cs_type_valid = (rio_cs_size)hdr->flags;
+	memcpy(cs.cs_bytes, data, (hdr->len > sizeof(cs.cs_bytes)) ?
+					sizeof(cs.cs_bytes) : hdr->len);
+	memset(&fields, 0, sizeof(fields));
+	rc = CS_bytes_to_fields(&cs, &fields);
+	if ((RIO_SUCCESS != rc) || ((cs_small != cs.cs_type_valid)
+				&& (cs_large != cs.cs_type_valid))) {
+		wk->agg.decode_errs++;
+		rc = RIO_ERR_INVALID_PARAMETER;
+	}
+
+	batch->cs_ts[i] = hdr->ts;
+	batch->cs_port[i] = hdr->port;
+	batch->stype0[i] = (uint8_t)fields.cs_t0;
+	batch->parm0[i] = (uint8_t)fields.parm_0;
+	batch->parm1[i] = (uint8_t)fields.parm_1;
+	batch->stype1[i] = (uint8_t)fields.cs_t1;
+	batch->cmd[i] = (uint8_t)fields.cs_t1_cmd;
+	batch->cs_flags[i] = (fields.cs_crc_correct ? RIO_TRACE_F_CRC_OK : 0)
+			| ((RIO_SUCCESS == rc) ? RIO_TRACE_F_DECODE_OK : 0);
+	batch->cs_cnt = i + 1;
+}
+
+static void rio_trace_decode_blk(rio_trace_worker_t *wk, uint64_t blk)
+{
+	rio_trace_t *trace = wk->ctx->in_parms->trace;
+	uint64_t off = blk * trace->blk_size;
+	uint64_t end = off + trace->blk_size;
+	rio_trace_rec_hdr_t hdr;
+	uint64_t rec_size;
+
+	if (!blk) {
+		off += sizeof(rio_trace_file_hdr_t);
+	}
+	if (end > trace->size) {
+		end = trace->size;
+	}
+
+	while (off + sizeof(hdr) <= end) {
+		memcpy(&hdr, trace->base + off, sizeof(hdr));
+		if (rio_trace_rec_end == hdr.kind) {
+			break;
+		}
+
+		rec_size = RIO_TRACE_REC_SIZE(hdr.len);
+		if (off + rec_size > end) {
+			// Truncated record, the rest of the block is lost
+			wk->agg.recs++;
+			wk->agg.decode_errs++;
+			break;
+		}
+		wk->agg.recs++;
+
+		switch (hdr.kind) {
+		case rio_trace_rec_pkt:
+			if (RIO_TRACE_BATCH_SZ == wk->batch->pkt_cnt) {
+				rio_trace_flush(wk);
+			}
+			rio_trace_decode_pkt(wk, &hdr,
+					trace->base + off + sizeof(hdr), off);
+			break;
+		case rio_trace_rec_cs:
+			if (RIO_TRACE_BATCH_SZ == wk->batch->cs_cnt) {
+				rio_trace_flush(wk);
+			}
+			rio_trace_decode_cs(wk, &hdr,
+					trace->base + off + sizeof(hdr));
+			break;
+		default:
+			wk->agg.decode_errs++;
+			break;
+		}
+		off += rec_size;
+	}
+}
+
+static void *rio_trace_worker(void *arg)
+{
+	rio_trace_worker_t *wk = (rio_trace_worker_t *)arg;
+	rio_trace_scan_ctx_t *ctx = wk->ctx;
+	uint64_t blk_cnt = ctx->in_parms->trace->blk_cnt;
+	uint64_t blk, last;
+
+	while (true) {
+		pthread_mutex_lock(&ctx->lock);
+		blk = ctx->next_blk;
+		ctx->next_blk += RIO_TRACE_CHUNK_BLKS;
+		pthread_mutex_unlock(&ctx->lock);
+
+		if (blk >= blk_cnt) {
+			break;
+		}
+		last = blk + RIO_TRACE_CHUNK_BLKS;
+		if (last > blk_cnt) {
+			last = blk_cnt;
+		}
+		for (; blk < last; blk++) {
+			rio_trace_decode_blk(wk, blk);
+		}
+	}
+	rio_trace_flush(wk);
+	return NULL;
+}
+
+uint32_t rio_trace_scan(rio_trace_scan_in_t *in_parms,
+		rio_trace_scan_out_t *out_parms)
+{
+	rio_trace_scan_ctx_t ctx;
+	rio_trace_worker_t *wk = NULL;
+	pthread_t thr[RIO_TRACE_MAX_THREADS];
+	struct timespec st, end;
+	uint32_t threads, started = 0, t;
+	uint32_t rc;
+	long cpus;
+
+	if ((NULL == in_parms) || (NULL == out_parms)) {
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+
+	memset(&out_parms->agg, 0, sizeof(out_parms->agg));
+	out_parms->imp_rc = RIO_SUCCESS;
+	out_parms->usecs = 0;
+
+	if ((NULL == in_parms->trace) || (NULL == in_parms->trace->base)
+			|| (in_parms->grp > rio_trace_grp_port)) {
+		out_parms->imp_rc = RIO_TRACE(1);
+		return RIO_ERR_INVALID_PARAMETER;
+	}
+
+	threads = in_parms->thread_cnt;
+	if (!threads) {
+		cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (cpus > 0) ? (uint32_t)cpus : 1;
+	}
+	if (threads > RIO_TRACE_MAX_THREADS) {
+		threads = RIO_TRACE_MAX_THREADS;
+	}
+	if (threads > in_parms->trace->blk_cnt / RIO_TRACE_CHUNK_BLKS + 1) {
+		threads = in_parms->trace->blk_cnt / RIO_TRACE_CHUNK_BLKS + 1;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+
+	rc = rio_trace_agg_init(&out_parms->agg, in_parms->grp);
+	if (RIO_SUCCESS != rc) {
+		out_parms->imp_rc = RIO_TRACE(2);
+		return rc;
+	}
+
+	wk = (rio_trace_worker_t *)calloc(threads, sizeof(*wk));
+	if (NULL == wk) {
+		out_parms->imp_rc = RIO_TRACE(3);
+		rc = RIO_ERR_INSUFFICIENT_RESOURCES;
+		goto exit;
+	}
+
+	ctx.in_parms = in_parms;
+	ctx.next_blk = 0;
+	pthread_mutex_init(&ctx.lock, NULL);
+
+	for (t = 0; t < threads; t++) {
+		wk[t].ctx = &ctx;
+		wk[t].batch = (rio_trace_batch_t *)calloc(1,
+						sizeof(rio_trace_batch_t));
+		if ((NULL == wk[t].batch) || (RIO_SUCCESS
+			!= rio_trace_agg_init(&wk[t].agg, in_parms->grp))) {
+			out_parms->imp_rc = RIO_TRACE(4);
+			rc = RIO_ERR_INSUFFICIENT_RESOURCES;
+			goto cleanup;
+		}
+	}
+
+	// The calling thread is the first worker
+	for (started = 1; started < threads; started++) {
+		if (pthread_create(&thr[started], NULL, rio_trace_worker,
+							&wk[started])) {
+			break;
+		}
+	}
+	rio_trace_worker(&wk[0]);
+	for (t = 1; t < started; t++) {
+		pthread_join(thr[t], NULL);
+	}
+
+	for (t = 0; t < threads; t++) {
+		rio_trace_agg_sum(&out_parms->agg, &wk[t].agg);
+	}
+	if (!out_parms->agg.pkts && !out_parms->agg.cs) {
+		out_parms->agg.ts_first = 0;
+	}
+
+cleanup:
+	for (t = 0; t < threads; t++) {
+		free(wk[t].batch);
+		rio_trace_agg_free(&wk[t].agg);
+	}
+	pthread_mutex_destroy(&ctx.lock);
+	free(wk);
+exit:
+	if (RIO_SUCCESS != rc) {
+		rio_trace_agg_free(&out_parms->agg);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	out_parms->usecs = ((uint64_t)(end.tv_sec - st.tv_sec) * 1000000)
+			+ ((end.tv_nsec - st.tv_nsec) / 1000);
+	return rc;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -45,15 +45,341 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <pthread.h>
 
 #include "RapidIO_Utilities_API.h"
+#include "DAR_DB_Private.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Multiple register read and read/modify/write utilities
+ *
+ * Entries are sorted by offset, and runs of consecutive registers are
+ * accessed with DARRegReadBlock/DARRegWriteBlock.  When a block access
+ * fails, the registers of the block are accessed one at a time so that
+ * every entry gets its own return code.  Registers which were read
+ * before a block read failed are not read again, as reading a clear on
+ * read register, such as a counter, a second time would lose its value.
+ */
+
+// Largest number of registers accessed by one block access
+#define DAR_MULTI_REG_MAX_BLK 64
+
+// Number of entries which can be sorted without allocating memory
+#define DAR_MULTI_REG_STACK_ENTRIES 128
+
+typedef struct DAR_multi_reg_ord_t_TAG {
+	uint32_t offset;
+	uint32_t idx;
+} DAR_multi_reg_ord_t;
+
+static int DAR_multi_reg_cmp(const void *p1, const void *p2)
+{
+	const DAR_multi_reg_ord_t *o1 = (const DAR_multi_reg_ord_t *)p1;
+	const DAR_multi_reg_ord_t *o2 = (const DAR_multi_reg_ord_t *)p2;
+
+	if (o1->offset != o2->offset) {
+		return (o1->offset < o2->offset) ? -1 : 1;
+	}
+	return (o1->idx < o2->idx) ? -1 : (o1->idx > o2->idx);
+}
+
+/* Returns the number of sorted entries, starting at ord[start], which
+ * can be read or written with one block access, and the number of
+ * registers in the block.  Entries with the same offset share a
+ * register.
+ */
+static uint32_t DAR_multi_reg_run(DAR_multi_reg_ord_t *ord, uint32_t start,
+		uint32_t n, uint32_t *regs)
+{
+	uint32_t end = start + 1;
+
+	*regs = 1;
+	while (end < n) {
+		if (ord[end].offset == ord[end - 1].offset) {
+			end++;
+			continue;
+		}
+		if ((ord[end].offset != ord[end - 1].offset + 4)
+				|| (DAR_MULTI_REG_MAX_BLK == *regs)) {
+			break;
+		}
+		(*regs)++;
+		end++;
+	}
+	return end - start;
+}
+
+/* Reads the registers of the n sorted entries in ord.  The value and
+ * return code of entry ord[i].idx are stored in vals[ord[i].idx] and
+ * rcs[ord[i].idx].
+ */
+static void DAR_multi_reg_rd_ord(DAR_DEV_INFO_t *dev_info,
+		DAR_multi_reg_ord_t *ord, uint32_t n, uint32_t *vals,
+		uint32_t *rcs)
+{
+	uint32_t buf[DAR_MULTI_REG_MAX_BLK];
+	uint32_t blk_rc[DAR_MULTI_REG_MAX_BLK];
+	uint32_t i, j, cnt, regs, reg, rc, done;
+
+	for (i = 0; i < n; i += cnt) {
+		cnt = DAR_multi_reg_run(ord, i, n, &regs);
+
+		rc = DARDB_ReadRegBlock(dev_info, ord[i].offset, regs, buf,
+				&done);
+		for (reg = 0; reg < regs; reg++) {
+			blk_rc[reg] = (reg < done) ? RIO_SUCCESS : rc;
+			if ((reg >= done) && (regs > 1)) {
+				blk_rc[reg] = DARRegRead(dev_info,
+						ord[i].offset + (4 * reg),
+						&buf[reg]);
+			}
+		}
+
+		for (j = i; j < i + cnt; j++) {
+			reg = (ord[j].offset - ord[i].offset) / 4;
+			vals[ord[j].idx] = (RIO_SUCCESS == blk_rc[reg]) ?
+								buf[reg] : 0;
+			rcs[ord[j].idx] = blk_rc[reg];
+		}
+	}
+}
+
+/* Writes the registers of the n sorted entries in ord, which must have
+ * distinct offsets.  The value written to ord[i].offset is
+ * vals[ord[i].idx], and the return code is stored in rcs[ord[i].idx].
+ */
+static void DAR_multi_reg_wr_ord(DAR_DEV_INFO_t *dev_info,
+		DAR_multi_reg_ord_t *ord, uint32_t n, uint32_t *vals,
+		uint32_t *rcs)
+{
+	uint32_t buf[DAR_MULTI_REG_MAX_BLK];
+	uint32_t i, j, cnt, regs, rc;
+
+	for (i = 0; i < n; i += cnt) {
+		cnt = DAR_multi_reg_run(ord, i, n, &regs);
+
+		for (j = 0; j < cnt; j++) {
+			buf[j] = vals[ord[i + j].idx];
+		}
+		rc = DARRegWriteBlock(dev_info, ord[i].offset, cnt, buf);
+		for (j = i; j < i + cnt; j++) {
+			rcs[ord[j].idx] = rc;
+			if ((RIO_SUCCESS != rc) && (cnt > 1)) {
+				rcs[ord[j].idx] = DARRegWrite(dev_info,
+						ord[j].offset, vals[ord[j].idx]);
+			}
+		}
+	}
+}
+
+static DAR_multi_reg_ord_t *DAR_multi_reg_ord_alloc(uint32_t num_entries,
+		DAR_multi_reg_ord_t *stack_ord)
+{
+	if (num_entries <= DAR_MULTI_REG_STACK_ENTRIES) {
+		return stack_ord;
+	}
+	return (DAR_multi_reg_ord_t *)malloc(
+			num_entries * sizeof(DAR_multi_reg_ord_t));
+}
+
+static void DAR_multi_reg_ord_free(DAR_multi_reg_ord_t *ord,
+		DAR_multi_reg_ord_t *stack_ord)
+{
+	if (ord != stack_ord) {
+		free(ord);
+	}
+}
+
+uint32_t DAR_multi_reg_read(DAR_DEV_INFO_t *dev_info,
+		DAR_read_entry_in_t *in_parms, DAR_read_entry_out_t *out_parms,
+		uint32_t num_entries)
+{
+	DAR_multi_reg_ord_t stack_ord[DAR_MULTI_REG_STACK_ENTRIES];
+	DAR_multi_reg_ord_t *ord;
+	uint32_t *vals, *rcs;
+	uint32_t i;
+
+	if ((NULL == dev_info) || (NULL == in_parms) || (NULL == out_parms)) {
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+	if (!num_entries) {
+		return RIO_SUCCESS;
+	}
+
+	ord = DAR_multi_reg_ord_alloc(num_entries, stack_ord);
+	vals = (uint32_t *)malloc(2 * num_entries * sizeof(uint32_t));
+	if ((NULL == ord) || (NULL == vals)) {
+		// Read one register at a time
+		for (i = 0; i < num_entries; i++) {
+			out_parms[i].rc = DARRegRead(dev_info,
+					in_parms[i].offset,
+					&out_parms[i].value_read);
+		}
+		goto exit;
+	}
+	rcs = &vals[num_entries];
+
+	for (i = 0; i < num_entries; i++) {
+		ord[i].offset = in_parms[i].offset;
+		ord[i].idx = i;
+	}
+	qsort(ord, num_entries, sizeof(ord[0]), DAR_multi_reg_cmp);
+
+	DAR_multi_reg_rd_ord(dev_info, ord, num_entries, vals, rcs);
+	for (i = 0; i < num_entries; i++) {
+		out_parms[i].value_read = vals[i];
+		out_parms[i].rc = rcs[i];
+	}
+
+exit:
+	DAR_multi_reg_ord_free(ord, stack_ord);
+	free(vals);
+
+	for (i = 0; i < num_entries; i++) {
+		if (RIO_SUCCESS != out_parms[i].rc) {
+			return out_parms[i].rc;
+		}
+	}
+	return RIO_SUCCESS;
+}
+
+static void DAR_multi_reg_acc_one(DAR_DEV_INFO_t *dev_info,
+		DAR_read_write_entry_in_t *in_parms,
+		DAR_read_write_entry_out_t *out_parms)
+{
+	out_parms->read_value = 0;
+	out_parms->read_rc = RIO_SUCCESS;
+	out_parms->write_value = in_parms->value_delta;
+	out_parms->write_rc = RIO_SUCCESS;
+
+	if (in_parms->mask) {
+		out_parms->read_rc = DARRegRead(dev_info, in_parms->offset,
+						&out_parms->read_value);
+		if (RIO_SUCCESS != out_parms->read_rc) {
+			out_parms->write_rc = out_parms->read_rc;
+			return;
+		}
+		out_parms->write_value = (out_parms->read_value
+				& in_parms->mask)
+				| (in_parms->value_delta & ~in_parms->mask);
+	}
+
+	if (0xFFFFFFFF != in_parms->mask) {
+		out_parms->write_rc = DARRegWrite(dev_info, in_parms->offset,
+						out_parms->write_value);
+	}
+}
+
+uint32_t DAR_multi_reg_acc(DAR_DEV_INFO_t *dev_info,
+		DAR_read_write_entry_in_t *in_parms,
+		DAR_read_write_entry_out_t *out_parms, uint32_t num_entries)
+{
+	DAR_multi_reg_ord_t stack_ord[DAR_MULTI_REG_STACK_ENTRIES];
+	DAR_multi_reg_ord_t *ord;
+	uint32_t *vals, *rcs;
+	uint32_t i, n;
+	DAR_read_write_entry_in_t *in;
+	DAR_read_write_entry_out_t *out;
+
+	if ((NULL == dev_info) || (NULL == in_parms) || (NULL == out_parms)) {
+		return RIO_ERR_NULL_PARM_PTR;
+	}
+	if (!num_entries) {
+		return RIO_SUCCESS;
+	}
+
+	ord = DAR_multi_reg_ord_alloc(num_entries, stack_ord);
+	vals = (uint32_t *)malloc(2 * num_entries * sizeof(uint32_t));
+	if ((NULL == ord) || (NULL == vals)) {
+		goto one_at_a_time;
+	}
+	rcs = &vals[num_entries];
+
+	for (i = 0; i < num_entries; i++) {
+		ord[i].offset = in_parms[i].offset;
+		ord[i].idx = i;
+	}
+	qsort(ord, num_entries, sizeof(ord[0]), DAR_multi_reg_cmp);
+
+	// A register accessed more than once may depend on an earlier
+	// write, so process the entries in order.
+	for (i = 1; i < num_entries; i++) {
+		if (ord[i].offset == ord[i - 1].offset) {
+			goto one_at_a_time;
+		}
+	}
+
+	// Read all registers which are not completely overwritten
+	for (i = n = 0; i < num_entries; i++) {
+		if (in_parms[ord[i].idx].mask) {
+			ord[n++] = ord[i];
+		}
+	}
+	DAR_multi_reg_rd_ord(dev_info, ord, n, vals, rcs);
+
+	// Compute the values to write, and write them
+	for (i = 0; i < num_entries; i++) {
+		in = &in_parms[i];
+		out = &out_parms[i];
+
+		out->read_value = 0;
+		out->read_rc = RIO_SUCCESS;
+		out->write_value = in->value_delta;
+		out->write_rc = RIO_SUCCESS;
+		if (in->mask) {
+			out->read_value = vals[i];
+			out->read_rc = rcs[i];
+			if (RIO_SUCCESS != out->read_rc) {
+				out->write_rc = out->read_rc;
+				continue;
+			}
+			out->write_value = (out->read_value & in->mask)
+					| (in->value_delta & ~in->mask);
+		}
+		vals[i] = out->write_value;
+	}
+
+	for (i = n = 0; i < num_entries; i++) {
+		in = &in_parms[i];
+		if ((0xFFFFFFFF != in->mask)
+				&& (RIO_SUCCESS == out_parms[i].read_rc)) {
+			ord[n].offset = in->offset;
+			ord[n++].idx = i;
+		}
+	}
+	qsort(ord, n, sizeof(ord[0]), DAR_multi_reg_cmp);
+	DAR_multi_reg_wr_ord(dev_info, ord, n, vals, rcs);
+	for (i = 0; i < n; i++) {
+		out_parms[ord[i].idx].write_rc = rcs[ord[i].idx];
+	}
+	goto exit;
+
+one_at_a_time:
+	for (i = 0; i < num_entries; i++) {
+		DAR_multi_reg_acc_one(dev_info, &in_parms[i], &out_parms[i]);
+	}
+
+exit:
+	DAR_multi_reg_ord_free(ord, stack_ord);
+	free(vals);
+
+	for (i = 0; i < num_entries; i++) {
+		if (RIO_SUCCESS != out_parms[i].read_rc) {
+			return out_parms[i].read_rc;
+		}
+		if (RIO_SUCCESS != out_parms[i].write_rc) {
+			return out_parms[i].write_rc;
+		}
+	}
+	return RIO_SUCCESS;
+}
+
 /******************************************************************************
  *  FUNCTION: DAR_util_get_ftype()
  *
@@ -768,8 +1094,11 @@ int CS_13bit_crc_bit_mask[NUM_CRC13_VECTORS] = {
 /* Compute_13bit_crc expects the first 32 bits of the control symbol data to be
  in msbits, and the least 3 bits of the control symbol payload to be in the
  most significant bits of lsbits.
+
+ This is the reference implementation.  compute_13bit_crc uses tables
+ derived from it.
  */
-static int compute_13bit_crc(uint32_t msbits, uint32_t lsbits)
+static int compute_13bit_crc_bitwise(uint32_t msbits, uint32_t lsbits)
 {
 	uint32_t crc = 0x1FFF, i;
 	uint32_t bit = 0x80000000;
@@ -823,8 +1152,11 @@ static int count_bits(int val)
  The 23 bits of Control Symbol data must be left shifted by 1 to create
  a 24 bit quantity.  This is consistent with the algorithm presented in
  the RapidIO specification.
+
+ This is the reference implementation.  compute_5bit_crc uses tables
+ derived from it.
  */
-static int compute_5bit_crc(uint32_t small_cs_data)
+static int compute_5bit_crc_bitwise(uint32_t small_cs_data)
 {
 	int i, crc = 0;
 
@@ -837,6 +1169,73 @@ static int compute_5bit_crc(uint32_t small_cs_data)
 	return crc;
 }
 
+/* Both control symbol CRCs are affine functions of the control symbol
+ bits: the CRC of a value is the CRC of zero XORed with the contribution
+ of each byte of the value.  The contribution of every possible byte
+ value is computed once using the reference routines, so the table
+ driven routines are bit exact with them by construction.
+ */
+
+#define CS_CRC13_MS_BYTES 4
+#define CS_CRC5_BYTES 3
+
+static int CS_13bit_crc_zero;
+static uint16_t CS_13bit_crc_ms_tbl[CS_CRC13_MS_BYTES][256];
+static uint16_t CS_13bit_crc_ls_tbl[8];
+static int CS_5bit_crc_zero;
+static uint8_t CS_5bit_crc_tbl[CS_CRC5_BYTES][256];
+static pthread_once_t CS_crc_tbl_once = PTHREAD_ONCE_INIT;
+
+static void CS_crc_tbl_init(void)
+{
+	uint32_t i, b;
+
+	CS_13bit_crc_zero = compute_13bit_crc_bitwise(0, 0);
+	CS_5bit_crc_zero = compute_5bit_crc_bitwise(0);
+
+	for (i = 0; i < 256; i++) {
+		for (b = 0; b < CS_CRC13_MS_BYTES; b++) {
+			CS_13bit_crc_ms_tbl[b][i] = (uint16_t)(CS_13bit_crc_zero
+				^ compute_13bit_crc_bitwise(i << (24 - (8 * b)),
+									0));
+		}
+		for (b = 0; b < CS_CRC5_BYTES; b++) {
+			CS_5bit_crc_tbl[b][i] = (uint8_t)(CS_5bit_crc_zero
+				^ compute_5bit_crc_bitwise(i << (8 * b)));
+		}
+	}
+
+	for (i = 0; i < 8; i++) {
+		CS_13bit_crc_ls_tbl[i] = (uint16_t)(CS_13bit_crc_zero
+				^ compute_13bit_crc_bitwise(0, i << 29));
+	}
+}
+
+static int compute_13bit_crc(uint32_t msbits, uint32_t lsbits)
+{
+	pthread_once(&CS_crc_tbl_once, CS_crc_tbl_init);
+
+	return CS_13bit_crc_zero
+		^ CS_13bit_crc_ms_tbl[0][(msbits >> 24) & 0xFF]
+		^ CS_13bit_crc_ms_tbl[1][(msbits >> 16) & 0xFF]
+		^ CS_13bit_crc_ms_tbl[2][(msbits >> 8) & 0xFF]
+		^ CS_13bit_crc_ms_tbl[3][msbits & 0xFF]
+		^ CS_13bit_crc_ls_tbl[lsbits >> 29];
+}
+
+/* The CRC masks do not include bits above bit 23, so they do not
+ contribute to the CRC.
+ */
+static int compute_5bit_crc(uint32_t small_cs_data)
+{
+	pthread_once(&CS_crc_tbl_once, CS_crc_tbl_init);
+
+	return CS_5bit_crc_zero
+		^ CS_5bit_crc_tbl[0][small_cs_data & 0xFF]
+		^ CS_5bit_crc_tbl[1][(small_cs_data >> 8) & 0xFF]
+		^ CS_5bit_crc_tbl[2][(small_cs_data >> 16) & 0xFF];
+}
+
 /****************************************************************************
  *
  *  Control symbol composition and parsing routines
@@ -1205,9 +1604,12 @@ int bytewise_CRC_bits[16] = {
 		0x8880, // 15
 };
 
-static int crc_comp_bytewise(uint8_t *val, int num_bytes)
+/* Continues the CRC old_crc over num_bytes of val.  This is the reference
+ implementation.  crc_comp_bytewise uses tables derived from it.
+ */
+static int crc_comp_bitwise(int old_crc, uint8_t *val, int num_bytes)
 {
-	int old_crc = 0xFFFF, new_crc = 0, i, j, temp;
+	int new_crc = 0, i, j, temp;
 
 	for (i = 0; i < num_bytes; i++) {
 		for (j = 0; j < 16; j++) {
@@ -1222,6 +1624,56 @@ static int crc_comp_bytewise(uint8_t *val, int num_bytes)
 	return old_crc;
 }
 
+/* Slicing by 4 tables for the packet CRC.  pkt_crc_tbl[0] is the CRC of
+ each byte value with a starting CRC of 0.  pkt_crc_tbl[n] is the CRC of
+ each byte value followed by n zero bytes.
+ */
+#define PKT_CRC_SLICES 4
+
+static uint16_t pkt_crc_tbl[PKT_CRC_SLICES][256];
+static pthread_once_t pkt_crc_tbl_once = PTHREAD_ONCE_INIT;
+
+static void pkt_crc_tbl_init(void)
+{
+	uint32_t i, n;
+	uint8_t byte;
+	uint16_t crc;
+
+	for (i = 0; i < 256; i++) {
+		byte = (uint8_t)i;
+		pkt_crc_tbl[0][i] = (uint16_t)crc_comp_bitwise(0, &byte, 1);
+	}
+
+	for (n = 1; n < PKT_CRC_SLICES; n++) {
+		for (i = 0; i < 256; i++) {
+			crc = pkt_crc_tbl[n - 1][i];
+			pkt_crc_tbl[n][i] = (uint16_t)(crc << 8)
+					^ pkt_crc_tbl[0][crc >> 8];
+		}
+	}
+}
+
+static int crc_comp_bytewise(uint8_t *val, int num_bytes)
+{
+	uint16_t crc = 0xFFFF;
+	int i = 0;
+
+	pthread_once(&pkt_crc_tbl_once, pkt_crc_tbl_init);
+
+	for (; i + PKT_CRC_SLICES <= num_bytes; i += PKT_CRC_SLICES) {
+		crc = pkt_crc_tbl[3][(crc >> 8) ^ val[i]]
+			^ pkt_crc_tbl[2][(crc & 0xFF) ^ val[i + 1]]
+			^ pkt_crc_tbl[1][val[i + 2]]
+			^ pkt_crc_tbl[0][val[i + 3]];
+	}
+
+	for (; i < num_bytes; i++) {
+		crc = (uint16_t)(crc << 8) ^ pkt_crc_tbl[0][(crc >> 8) ^ val[i]];
+	}
+
+	return crc;
+}
+
 static int compute_pkt_crc(uint8_t *pkt, int num_bytes)
 {
 	int temp, i;
@@ -2502,6 +2954,416 @@ uint32_t DAR_pkt_bytes_to_fields(DAR_pkt_bytes_t *bytes_in,
 	return rc;
 }
 
+bool DAR_pkt_CRC_ok(const uint8_t *pkt, uint32_t num_chars)
+{
+	/* The CRC of a packet including its CRC is 0.  Zero padding after
+	 the CRC leaves the CRC at 0.  Packets longer than 84 bytes include an
+	 intermediate CRC after the first 80 bytes.
+	 */
+	if (crc_comp_bytewise((uint8_t *)pkt, (int)num_chars)) {
+		return false;
+	}
+	if ((num_chars > 84) && crc_comp_bytewise((uint8_t *)pkt, 82)) {
+		return false;
+	}
+	return true;
+}
+
+/* Largest number of bytes read from the header of a packet by
+ * DAR_pkt_bytes_to_summary: physical, transport, FTYPE 5 transaction
+ * type, TID and a 66 bit address.
+ */
+#define DAR_PKT_MAX_HDR_BYTES (2 + 4 + 2 + 8)
+
+/* Extracts an address, as DAR_get_rw_addr does, from the packet bytes
+ * starting at index.  Returns the index of the first byte after the
+ * address, or DAR_UTIL_BAD_ADDRSIZE.
+ */
+static uint32_t DAR_get_rw_addr_summary(const uint8_t *pkt,
+		rio_addr_size addr_size, uint32_t index,
+		DAR_pkt_summary_t *summ_out)
+{
+	uint32_t num_bytes, i;
+	uint64_t addr = 0;
+	uint8_t msbs;
+
+	switch (addr_size) {
+	case rio_addr_21:
+		num_bytes = 3;
+		break;
+	case rio_addr_32:
+	case rio_addr_34:
+		num_bytes = 4;
+		break;
+	case rio_addr_50:
+		num_bytes = 6;
+		break;
+	case rio_addr_66:
+		num_bytes = 8;
+		break;
+	default:
+		return DAR_UTIL_BAD_ADDRSIZE;
+	}
+
+	for (i = 0; i < num_bytes; i++) {
+		addr = (addr << 8) | pkt[index + i];
+	}
+	msbs = pkt[index + num_bytes - 1] & 3;
+	addr &= ~(uint64_t)7;
+
+	switch (addr_size) {
+	case rio_addr_34:
+		addr |= (uint64_t)msbs << 32;
+		break;
+	case rio_addr_50:
+		addr |= (uint64_t)msbs << 48;
+		break;
+	case rio_addr_66:
+		summ_out->addr_msbs = msbs;
+		break;
+	default:
+		break;
+	}
+	summ_out->addr = addr;
+
+	return index + num_bytes;
+}
+
+uint32_t DAR_pkt_bytes_to_summary(const uint8_t *pkt, uint32_t num_chars,
+		rio_addr_size addr_size, bool has_crc,
+		DAR_pkt_summary_t *summ_out)
+{
+	bool get_data = true;
+	bool get_exact_data = false;
+	bool dstm_end_seg = false;
+	bool dstm_odd_data_amt = false;
+	bool dstm_pad_data_amt = false;
+	uint32_t size_rc, align = 0, max_bytes, data_end;
+	uint32_t pkt_index = 2;
+	uint8_t msg_len, msgseg;
+	uint8_t hdr[DAR_PKT_MAX_HDR_BYTES];
+
+	summ_out->pkt_type = pkt_raw;
+	summ_out->tid = 0;
+	summ_out->addr_msbs = 0;
+	summ_out->addr = 0;
+	summ_out->pkt_bytes = 0;
+	summ_out->crc_ok = true;
+
+	if ((num_chars < 8) || (num_chars > RIO_MAX_PKT_BYTES)) {
+		return DAR_UTIL_BAD_DATA_SIZE;
+	}
+
+	if (has_crc) {
+		summ_out->crc_ok = DAR_pkt_CRC_ok(pkt, num_chars);
+	}
+
+	/* Never read past the end of short packets */
+	if (num_chars < DAR_PKT_MAX_HDR_BYTES) {
+		memset(hdr, 0, sizeof(hdr));
+		memcpy(hdr, pkt, num_chars);
+		pkt = hdr;
+	}
+
+	summ_out->prio = (pkt[1] & 0xC0) >> 6;
+	summ_out->tt_code = (rio_TT_code)((pkt[1] & 0x30) >> 4);
+	summ_out->ftype = pkt[1] & 0x0F;
+
+	switch (summ_out->tt_code) {
+	case tt_small:
+		summ_out->destID = pkt[pkt_index++];
+		summ_out->srcID = pkt[pkt_index++];
+		break;
+	case tt_large:
+		summ_out->destID = ((did_reg_t)pkt[2] << 8) + pkt[3];
+		summ_out->srcID = ((did_reg_t)pkt[4] << 8) + pkt[5];
+		pkt_index += 4;
+		break;
+	default:
+		return DAR_UTIL_INVALID_TT;
+	}
+
+	switch (summ_out->ftype) {
+	case 2: /* NREAD and ATOMIC transactions */
+		switch ((pkt[pkt_index] & 0xF0) >> 4) {
+		case 4:
+			summ_out->pkt_type = pkt_nr;
+			break;
+		case 0xC:
+			summ_out->pkt_type = pkt_nr_inc;
+			break;
+		case 0xD:
+			summ_out->pkt_type = pkt_nr_dec;
+			break;
+		case 0xE:
+			summ_out->pkt_type = pkt_nr_set;
+			break;
+		case 0xF:
+			summ_out->pkt_type = pkt_nr_clr;
+			break;
+		default:
+			return DAR_UTIL_UNKNOWN_TRANS;
+		}
+		size_rc = pkt[pkt_index++] & 0xF;
+		summ_out->tid = pkt[pkt_index++];
+
+		pkt_index = DAR_get_rw_addr_summary(pkt, addr_size, pkt_index,
+								summ_out);
+		if (RIO_MAX_PKT_BYTES < pkt_index) {
+			return pkt_index;
+		}
+
+		size_rc = DAR_util_compute_rd_bytes_n_align(size_rc,
+				(pkt[pkt_index - 1] & 4) >> 2,
+				&summ_out->pkt_bytes, &align);
+		if (SIZE_RC_FAIL == size_rc) {
+			return DAR_UTIL_INVALID_RDSIZE;
+		}
+		summ_out->addr |= align;
+		get_data = false;
+		break;
+
+	case 5: /* NWRITE, NWRITE_R, and ATOMIC swap transactions */
+		size_rc = pkt[pkt_index] & 0xF;
+		switch ((pkt[pkt_index++] & 0xF0) >> 4) {
+		case 4:
+			summ_out->pkt_type = pkt_nw;
+			break;
+		case 5:
+			summ_out->pkt_type = pkt_nwr;
+			break;
+		case 0xC:
+			summ_out->pkt_type = pkt_nw_swap;
+			break;
+		case 0xD:
+			summ_out->pkt_type = pkt_nw_cmp_swap;
+			break;
+		case 0xE:
+			summ_out->pkt_type = pkt_nw_tst_swap;
+			break;
+		default:
+			return DAR_UTIL_UNKNOWN_TRANS;
+		}
+		summ_out->tid = pkt[pkt_index++];
+
+		pkt_index = DAR_get_rw_addr_summary(pkt, addr_size, pkt_index,
+								summ_out);
+		if (RIO_MAX_PKT_BYTES < pkt_index) {
+			return pkt_index;
+		}
+
+		size_rc = DAR_util_compute_wr_bytes_n_align(size_rc,
+				(pkt[pkt_index - 1] & 4) >> 2,
+				&summ_out->pkt_bytes, &align);
+		if (SIZE_RC_FAIL == size_rc) {
+			return DAR_UTIL_INVALID_RDSIZE;
+		}
+		summ_out->addr |= align;
+		break;
+
+	case 6: /* SWRITE */
+		summ_out->pkt_type = pkt_sw;
+		pkt_index = DAR_get_rw_addr_summary(pkt, addr_size, pkt_index,
+								summ_out);
+		summ_out->pkt_bytes = 256;
+		break;
+
+	case 7: /* Flow Control */
+		summ_out->pkt_type = pkt_fc;
+		get_data = false;
+		break;
+
+	case 8: /* Maintenance Transaction */
+		if (((pkt[pkt_index] & 0xF0) >> 4) > 4) {
+			return DAR_UTIL_UNKNOWN_TRANS;
+		}
+		size_rc = pkt[pkt_index] & 0xF;
+		summ_out->pkt_type = (DAR_pkt_type)((int)(pkt_mr)
+				+ ((pkt[pkt_index++] & 0xF0) >> 4));
+		summ_out->tid = pkt[pkt_index++];
+
+		/* Skip hopcount, maintenance offsets are always 3 bytes */
+		pkt_index = DAR_get_rw_addr_summary(pkt, rio_addr_21,
+						pkt_index + 1, summ_out);
+
+		switch (summ_out->pkt_type) {
+		case pkt_mr:
+			size_rc = DAR_util_compute_rd_bytes_n_align(size_rc,
+					(pkt[pkt_index - 1] & 4) >> 2,
+					&summ_out->pkt_bytes, &align);
+			if (SIZE_RC_FAIL == size_rc) {
+				return DAR_UTIL_INVALID_RDSIZE;
+			}
+			get_data = false;
+			break;
+		case pkt_pw:
+		case pkt_mw:
+			size_rc = DAR_util_compute_wr_bytes_n_align(size_rc,
+					(pkt[pkt_index - 1] & 4) >> 2,
+					&summ_out->pkt_bytes, &align);
+			if (SIZE_RC_FAIL == size_rc) {
+				return DAR_UTIL_INVALID_RDSIZE;
+			}
+			break;
+		case pkt_mwr:
+			summ_out->pkt_bytes = 0;
+			get_data = false;
+			break;
+		case pkt_mrr:
+			summ_out->pkt_bytes = 64;
+			break;
+		default:
+			return DAR_UTIL_UNKNOWN_TRANS;
+		}
+		summ_out->addr |= align;
+		break;
+
+	case 9: /* Data Streaming packet */
+		summ_out->pkt_type = pkt_dstm;
+		pkt_index++;
+		if (pkt[pkt_index] & 4) {
+			/* Extended header */
+			summ_out->pkt_bytes = 0;
+			get_data = false;
+		} else {
+			summ_out->pkt_bytes = 256;
+			dstm_end_seg = (pkt[pkt_index] & 0x40) ? true : false;
+			dstm_odd_data_amt = (pkt[pkt_index] & 0x02) ?
+								true : false;
+			dstm_pad_data_amt = (pkt[pkt_index] & 0x01) ?
+								true : false;
+			if ((pkt[pkt_index++] & 0x80) || dstm_end_seg) {
+				/* Stream ID or PDU length */
+				pkt_index += 2;
+			}
+		}
+		break;
+
+	case 10: /* Doorbell */
+		summ_out->pkt_type = pkt_db;
+		summ_out->tid = pkt[pkt_index + 1];
+		summ_out->pkt_bytes = 2;
+		get_data = false;
+		break;
+
+	case 11: /* Message */
+		summ_out->pkt_type = pkt_msg;
+		msg_len = (pkt[pkt_index] & 0xF0) >> 4;
+		size_rc = pkt[pkt_index++] & 0xF;
+		if (size_rc < 9) {
+			return DAR_UTIL_BAD_MSG_DSIZE;
+		}
+		summ_out->pkt_bytes = 8 << (size_rc - 9);
+		msgseg = pkt[pkt_index++] & 0x0F;
+		get_exact_data = msg_len && (msgseg != msg_len);
+		break;
+
+	case 13: /* Response */
+		get_data = false;
+		switch ((pkt[pkt_index] & 0xF0) >> 4) {
+		case 8:
+			summ_out->pkt_type = pkt_resp_data;
+			get_data = true;
+			summ_out->pkt_bytes = 256;
+			break;
+		case 0:
+			summ_out->pkt_type = pkt_resp;
+			break;
+		case 1:
+			summ_out->pkt_type = pkt_msg_resp;
+			break;
+		default:
+			return DAR_UTIL_UNKNOWN_TRANS;
+		}
+
+		switch (pkt[pkt_index++] & 0x0F) {
+		case 0:
+		case 7:
+			break;
+		case 3:
+			get_data = false;
+			summ_out->pkt_bytes = 0;
+			break;
+		default:
+			return DAR_UTIL_UNKNOWN_STATUS;
+		}
+
+		if (pkt_msg_resp != summ_out->pkt_type) {
+			summ_out->tid = pkt[pkt_index];
+		}
+		pkt_index++;
+		break;
+
+	default:
+		summ_out->pkt_type = pkt_raw;
+		pkt_index = 0;
+		summ_out->pkt_bytes = 276;
+		break;
+	}
+
+	/* Data larger than 8 bytes is counted as DAR_pkt_bytes_to_fields
+	 does, skipping the intermediate and final CRCs and padding.
+	 */
+	if (!get_data || (summ_out->pkt_bytes <= 8)) {
+		return RIO_SUCCESS;
+	}
+
+	max_bytes = summ_out->pkt_bytes;
+	data_end = num_chars - (has_crc ? 2 : 0);
+	summ_out->pkt_bytes = 0;
+	if (data_end > pkt_index) {
+		summ_out->pkt_bytes = data_end - pkt_index;
+		if ((pkt_index <= 80) && (data_end > 80)) {
+			summ_out->pkt_bytes--;
+		}
+		if ((pkt_index <= 81) && (data_end > 81)) {
+			summ_out->pkt_bytes--;
+		}
+	}
+
+	if (summ_out->pkt_bytes & 1) {
+		return DAR_UTIL_BAD_DATA_SIZE;
+	}
+
+	if (has_crc && (num_chars != 84) && !pkt[num_chars - 1]
+			&& !pkt[num_chars - 2]) {
+		summ_out->pkt_bytes -= 2;
+	}
+
+	if (pkt_dstm == summ_out->pkt_type) {
+		if (dstm_end_seg) {
+			switch (summ_out->pkt_bytes & 3) {
+			case 0:
+				if (dstm_odd_data_amt) {
+					return DAR_UTIL_BAD_DS_DSIZE;
+				}
+				break;
+			case 2:
+				if (!dstm_odd_data_amt) {
+					return DAR_UTIL_BAD_DS_DSIZE;
+				}
+				break;
+			default:
+				return DAR_UTIL_BAD_DS_DSIZE;
+			}
+			if (dstm_pad_data_amt) {
+				summ_out->pkt_bytes--;
+			}
+		} else if (summ_out->pkt_bytes & 7) {
+			return DAR_UTIL_BAD_DS_DSIZE;
+		}
+	}
+
+	if (summ_out->pkt_bytes > max_bytes) {
+		return DAR_UTIL_BAD_DATA_SIZE;
+	}
+	if ((summ_out->pkt_bytes != max_bytes) && get_exact_data) {
+		return DAR_UTIL_BAD_DATA_SIZE;
+	}
+
+	return RIO_SUCCESS;
+}
+
 /* Returns string naming packet FTYPE. */
 char *pkt_ftype_strings[17] = {
 		(char *)"Implementation Specific",
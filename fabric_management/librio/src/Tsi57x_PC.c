@@ -287,7 +287,7 @@ uint32_t tsi57x_init_scratchpad(DAR_DEV_INFO_t *DAR_info)
 
 	for (idx = SCRPAD_FIRST_IDX; idx < MAX_DAR_SCRPAD_IDX; idx++) {
 		if (SCRPAD_EOF_OFFSET == scratchpad_const[idx].offset) {
-			rc = RIO_ERR_REG_ACCESS_FAIL;
+			rc = RIO_SUCCESS;
 			break;
 		}
 
@@ -906,7 +906,7 @@ static uint32_t tsi57x_set_config_init_parms_check_conflict(
 	// NOT ALL PORTS
 	rc = RIO_ERR_INVALID_PARAMETER;
 
-	if (in_parms->num_ports >= TSI57X_NUM_PORTS(dev_info)) {
+	if (in_parms->num_ports > TSI57X_NUM_PORTS(dev_info)) {
 		out_parms->imp_rc = PC_SET_CONFIG(0x99);
 		goto exit;
 	}
@@ -64,6 +64,11 @@ extern "C" {
 
 #define ALL_ENTRIES true
 #define CHG_ENTRIES false
+
+static uint32_t tsi57x_rt_set_changed_common(DAR_DEV_INFO_t *dev_info,
+		rio_rt_set_changed_in_t *in_parms,
+		rio_rt_set_changed_out_t *out_parms,
+		bool set_dflt);
 #define PROGRAM_RTE_ENTRIES(x) (PROGRAM_RTE_ENTRIES_0+x)
 
 #define ALL_MASKS true
@@ -294,6 +299,7 @@ exit:
 static uint32_t program_rte_entries(DAR_DEV_INFO_t *dev_info,
 		rio_rt_state_t *rt, uint8_t pnum,
 		bool prog_all, // Use ALL_ENTRIES/CHG_ENTRIES
+		bool set_dflt, // true if the default route should be set
 		uint32_t *imp_rc)
 {
 
@@ -301,6 +307,7 @@ static uint32_t program_rte_entries(DAR_DEV_INFO_t *dev_info,
 	uint32_t destID, baseID = 0;
 	uint32_t rte_val, idx_val;
 	bool set_base = false;
+	bool dom_chg = prog_all;
 	uint8_t port, start_port, end_port;
 
 	if (RIO_ALL_PORTS == pnum) {
@@ -310,24 +317,29 @@ static uint32_t program_rte_entries(DAR_DEV_INFO_t *dev_info,
 		start_port = end_port = pnum;
 	}
 
-	// Set the default route output port
+	// Set the default route output port.  The default route is only
+	// changed by rio_rt_initialize and rio_rt_set_all.
 
-	if ( RIO_RTE_DROP == rt->default_route) {
-		rte_val = HW_DFLT_RT & TSI578_RIO_LUT_ATTR_DEFAULT_PORT;
-	} else {
-		rte_val = rt->default_route & TSI578_RIO_LUT_ATTR_DEFAULT_PORT;
-	}
+	if (prog_all || set_dflt) {
+		if ( RIO_RTE_DROP == rt->default_route) {
+			rte_val = HW_DFLT_RT & TSI578_RIO_LUT_ATTR_DEFAULT_PORT;
+		} else {
+			rte_val = rt->default_route
+					& TSI578_RIO_LUT_ATTR_DEFAULT_PORT;
+		}
 
-	rc = DARRegWrite(dev_info, TSI578_RIO_LUT_ATTR, rte_val);
-	if (RIO_SUCCESS != rc) {
-		*imp_rc = PROGRAM_RTE_ENTRIES(1);
-		goto exit;
+		rc = DARRegWrite(dev_info, TSI578_RIO_LUT_ATTR, rte_val);
+		if (RIO_SUCCESS != rc) {
+			*imp_rc = PROGRAM_RTE_ENTRIES(1);
+			goto exit;
+		}
 	}
 
 	// Find base ID, and set it.
 	for (destID = 0; destID < RIO_RT_GRP_SZ; destID++) {
 		idx_val = destID << 8;
 		rte_val = rt->dom_table[destID].rte_val;
+		dom_chg |= rt->dom_table[destID].changed;
 		if (RIO_RTE_LVL_G0 == rte_val) {
 			if (set_base) {
 				rc = RIO_ERR_INVALID_PARAMETER;
@@ -340,7 +352,8 @@ static uint32_t program_rte_entries(DAR_DEV_INFO_t *dev_info,
 		}
 	}
 
-	for (port = start_port; port <= end_port; port++) {
+	// The base ID only changes when the domain table changes
+	for (port = start_port; dom_chg && (port <= end_port); port++) {
 		rc = DARRegWrite(dev_info, TSI578_SPX_ROUTE_BASE(port),
 				baseID << 16);
 		if (RIO_SUCCESS != rc) {
@@ -671,7 +684,8 @@ uint32_t tsi57x_rio_rt_initialize(DAR_DEV_INFO_t *dev_info,
 	}
 
 	if (in_parms->update_hw) {
-		rc = tsi57x_rio_rt_set_changed(dev_info, &all_in, &all_out);
+		rc = tsi57x_rt_set_changed_common(dev_info, &all_in, &all_out,
+				true);
 	} else {
 		rc = RIO_SUCCESS;
 	}
@@ -791,7 +805,7 @@ uint32_t tsi57x_rio_rt_set_all(DAR_DEV_INFO_t *dev_info,
 	}
 
 	rc = program_rte_entries(dev_info, in_parms->rt, in_parms->set_on_port,
-			ALL_ENTRIES, &out_parms->imp_rc);
+			ALL_ENTRIES, true, &out_parms->imp_rc);
 	if (RIO_SUCCESS != rc) {
 		goto exit;
 	}
@@ -800,9 +814,10 @@ exit:
 	return rc;
 }
 
-uint32_t tsi57x_rio_rt_set_changed(DAR_DEV_INFO_t *dev_info,
+static uint32_t tsi57x_rt_set_changed_common(DAR_DEV_INFO_t *dev_info,
 		rio_rt_set_changed_in_t *in_parms,
-		rio_rt_set_changed_out_t *out_parms)
+		rio_rt_set_changed_out_t *out_parms,
+		bool set_dflt) // true if the default route should be set
 {
 	uint32_t rc = RIO_ERR_INVALID_PARAMETER;
 
@@ -827,7 +842,7 @@ uint32_t tsi57x_rio_rt_set_changed(DAR_DEV_INFO_t *dev_info,
 	}
 
 	rc = program_rte_entries(dev_info, in_parms->rt, in_parms->set_on_port,
-			CHG_ENTRIES, &out_parms->imp_rc);
+			CHG_ENTRIES, set_dflt, &out_parms->imp_rc);
 	if (RIO_SUCCESS != rc) {
 		goto exit;
 	}
@@ -836,6 +851,14 @@ exit:
 	return rc;
 }
 
+uint32_t tsi57x_rio_rt_set_changed(DAR_DEV_INFO_t *dev_info,
+		rio_rt_set_changed_in_t *in_parms,
+		rio_rt_set_changed_out_t *out_parms)
+{
+	return tsi57x_rt_set_changed_common(dev_info, in_parms, out_parms,
+			false);
+}
+
 uint32_t tsi57x_rio_rt_change_rte(DAR_DEV_INFO_t *dev_info,
 		rio_rt_change_rte_in_t *in_parms,
 		rio_rt_change_rte_out_t *out_parms)
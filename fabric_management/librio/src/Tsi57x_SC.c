@@ -34,9 +34,11 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "RapidIO_Device_Access_Routines_API.h"
 #include "RapidIO_Statistics_Counter_API.h"
+#include "RapidIO_Utilities_API.h"
 #include "Tsi57x_DeviceDriver.h"
 #include "Tsi578.h"
 
@@ -57,13 +59,14 @@ uint32_t rio_sc_cfg_tsi57x_ctr(DAR_DEV_INFO_t *dev_info,
 {
 	uint32_t rc = RIO_ERR_INVALID_PARAMETER;
 	uint32_t new_ctl = 0, ctl_reg, new_ctl_reg, reg_mask;
-	uint8_t p_to_i[TSI578_MAX_PORTS] = {TSI578_MAX_PORTS};
+	uint8_t p_to_i[TSI578_MAX_PORTS];
 	uint8_t srch_i, srch_p, port_num;
 	bool found;
 	bool check;
 	struct DAR_ptl good_ptl;
 
 	out_parms->imp_rc = RIO_SUCCESS;
+	memset(p_to_i, TSI578_MAX_PORTS, sizeof(p_to_i));
 
 	if (NULL == in_parms->dev_ctrs) {
 		out_parms->imp_rc = SC_CFG_TSI57X_CTR(0x01);
@@ -312,12 +315,20 @@ uint32_t tsi57x_rio_sc_read_ctrs(DAR_DEV_INFO_t *dev_info,
 		rio_sc_read_ctrs_out_t *out_parms)
 {
 	uint32_t rc = RIO_ERR_INVALID_PARAMETER;
-	uint8_t p_to_i[TSI578_MAX_PORTS] = {TSI578_MAX_PORTS};
+	uint8_t p_to_i[TSI578_MAX_PORTS];
 	uint8_t srch_i, srch_p, port_num, cntr;
 	bool found;
 	struct DAR_ptl good_ptl;
+	rio_sc_ctr_val_t *counter;
+	DAR_read_entry_in_t rd_in[TSI578_MAX_PORTS * TSI578_NUM_PERF_CTRS];
+	DAR_read_entry_out_t rd_out[TSI578_MAX_PORTS * TSI578_NUM_PERF_CTRS];
+	rio_sc_ctr_val_t *rd_ctr[TSI578_MAX_PORTS * TSI578_NUM_PERF_CTRS];
+	uint8_t rd_cntr[TSI578_MAX_PORTS * TSI578_NUM_PERF_CTRS];
+	uint32_t rd_cnt = 0;
+	uint32_t fail;
 
 	out_parms->imp_rc = RIO_SUCCESS;
+	memset(p_to_i, TSI578_MAX_PORTS, sizeof(p_to_i));
 
 	if (NULL == in_parms->dev_ctrs) {
 		out_parms->imp_rc = SC_READ_CTRS(0x01);
@@ -377,29 +388,18 @@ uint32_t tsi57x_rio_sc_read_ctrs(DAR_DEV_INFO_t *dev_info,
 					goto exit;
 				}
 
-				// Read the port performance counters...
+				// Collect the port performance counters...
 				for (cntr = 0; cntr < TSI578_NUM_PERF_CTRS;
 						cntr++) {
-					if (rio_sc_disabled
-							!= in_parms->dev_ctrs->p_ctrs[srch_i].ctrs[cntr].sc) {
-						rc =
-								DARRegRead(
-										dev_info,
-										TSI578_SPX_PSCY(
-												port_num,
-												cntr),
-										&in_parms->dev_ctrs->p_ctrs[srch_i].ctrs[cntr].last_inc);
-						if (RIO_SUCCESS != rc) {
-							rc =
-									RIO_ERR_INVALID_PARAMETER;
-							out_parms->imp_rc =
-									SC_READ_CTRS(
-											0x70 + cntr);
-							goto exit;
-						}
-						in_parms->dev_ctrs->p_ctrs[srch_i].ctrs[cntr].total +=
-								in_parms->dev_ctrs->p_ctrs[srch_i].ctrs[cntr].last_inc;
+					counter = &in_parms->dev_ctrs->p_ctrs[srch_i].ctrs[cntr];
+					if (rio_sc_disabled == counter->sc) {
+						continue;
 					}
+					rd_in[rd_cnt].offset = TSI578_SPX_PSCY(
+							port_num, cntr);
+					rd_ctr[rd_cnt] = counter;
+					rd_cntr[rd_cnt] = cntr;
+					rd_cnt++;
 				}
 			}
 		}
@@ -410,6 +410,17 @@ uint32_t tsi57x_rio_sc_read_ctrs(DAR_DEV_INFO_t *dev_info,
 		}
 	}
 
+	// The counters of a port are contiguous, so the counters of all
+	// ports are read with one block read per port.
+	DAR_multi_reg_read(dev_info, rd_in, rd_out, rd_cnt);
+	fail = rio_sc_accum_ctrs(rd_ctr, rd_out, rd_cnt, false);
+	if (fail < rd_cnt) {
+		rc = RIO_ERR_INVALID_PARAMETER;
+		out_parms->imp_rc = SC_READ_CTRS(0x70 + rd_cntr[fail]);
+		goto exit;
+	}
+	rc = RIO_SUCCESS;
+
 exit:
 	return rc;
 }
@@ -3080,6 +3080,279 @@ static void rxs_rio_rt_probe_discard_mc_fail_test(void **state)
 	(void)state;
 }
 
+static uint32_t rxs_rd_cnt;
+
+static uint32_t rxs_count_read(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t *readdata)
+{
+	rxs_rd_cnt++;
+	return RXSReadReg(dev_info, offset, readdata);
+}
+
+static void rxs_rio_rt_probe_cached_chk(rio_rt_probe_out_t *exp,
+		rio_rt_probe_out_t *act)
+{
+	rio_port_t pt;
+
+	assert_int_equal(exp->imp_rc, act->imp_rc);
+	assert_int_equal(exp->valid_route, act->valid_route);
+	assert_int_equal(exp->routing_table_value, act->routing_table_value);
+	assert_int_equal(exp->default_route, act->default_route);
+	assert_int_equal(exp->filter_function_active,
+					act->filter_function_active);
+	assert_int_equal(exp->trace_function_active,
+					act->trace_function_active);
+	assert_int_equal(exp->time_to_live_active, act->time_to_live_active);
+	assert_int_equal(exp->reason_for_discard, act->reason_for_discard);
+	for (pt = 0; pt < NUM_RXS_PORTS(&mock_dev_info); pt++) {
+		assert_int_equal(exp->mcast_ports[pt], act->mcast_ports[pt]);
+	}
+}
+
+// Probes every destID in the list using the snapshot and using
+// rio_rt_probe, and confirms the results match.  Returns the number of
+// registers read by the batch probe.
+static uint32_t rxs_rio_rt_probe_cached_cmp(rio_rt_probe_snap_t *snap,
+		uint8_t probe_on_port, tt_t tt, did_reg_t *dids, uint32_t cnt,
+		bool exp_taken)
+{
+	rio_rt_probe_batch_in_t b_in;
+	rio_rt_probe_batch_out_t b_out;
+	rio_rt_probe_in_t pr_in;
+	rio_rt_probe_out_t pr_out;
+	rio_rt_probe_out_t *res;
+	uint32_t i, rd_cnt;
+
+	res = (rio_rt_probe_out_t *)calloc(cnt, sizeof(rio_rt_probe_out_t));
+	assert_non_null(res);
+
+	b_in.snap = snap;
+	b_in.probe_on_port = probe_on_port;
+	b_in.tt = tt;
+	b_in.destID_cnt = cnt;
+	b_in.destIDs = dids;
+	b_in.probe_out = res;
+
+	rxs_rd_cnt = 0;
+	assert_int_equal(RIO_SUCCESS,
+			rio_rt_probe_batch(&mock_dev_info, &b_in, &b_out));
+	assert_int_equal(RIO_SUCCESS, b_out.imp_rc);
+	assert_int_equal(exp_taken, b_out.snap_taken);
+	assert_true(rio_rt_probe_snap_valid(&mock_dev_info, snap,
+							probe_on_port));
+	rd_cnt = rxs_rd_cnt;
+
+	for (i = 0; i < cnt; i++) {
+		pr_in.probe_on_port = probe_on_port;
+		pr_in.tt = tt;
+		pr_in.destID = dids[i];
+		pr_in.rt = &snap->rt;
+		memset(&pr_out, 0, sizeof(pr_out));
+		assert_int_equal(RIO_SUCCESS,
+			rio_rt_probe(&mock_dev_info, &pr_in, &pr_out));
+		rxs_rio_rt_probe_cached_chk(&pr_out, &res[i]);
+	}
+	free(res);
+	return rd_cnt;
+}
+
+static void rxs_rio_rt_probe_cached_test(void **state)
+{
+	rio_rt_initialize_in_t init_in;
+	rio_rt_initialize_out_t init_out;
+	rio_rt_alloc_mc_mask_in_t alloc_in;
+	rio_rt_alloc_mc_mask_out_t alloc_out;
+	rio_rt_change_mc_mask_in_t mc_chg_in;
+	rio_rt_change_mc_mask_out_t mc_chg_out;
+	rio_rt_change_rte_in_t chg_in;
+	rio_rt_change_rte_out_t chg_out;
+	rio_rt_set_all_in_t set_in;
+	rio_rt_set_all_out_t set_out;
+	rio_rt_probe_cached_in_t c_in;
+	rio_rt_probe_out_t c_out;
+	rio_rt_probe_batch_in_t b_in;
+	rio_rt_probe_batch_out_t b_out;
+	rio_rt_state_t rt;
+	rio_rt_probe_snap_t snap;
+	did_reg_t dids[0x800];
+	uint32_t i;
+
+	// Multicast masks: ports 1, 2, 4 and 9, and ports 2 and 9
+	const uint32_t mc_masks[2] = {0x216, 0x204};
+	pe_rt_val mc_rte[2];
+
+	RXS_test_state_t *l_st = *(RXS_test_state_t **)state;
+
+	if (l_st->real_hw) {
+		return;
+	}
+
+	// Port 2 is unavailable, port 5 has no link partner, port 9 is in
+	// loopback with a filter active.
+	set_all_port_config(cfg_perfect, NO_TTL, NO_FILT, RIO_ALL_PORTS);
+	set_all_port_config(cfg_unavl, NO_TTL, NO_FILT, 2);
+	set_all_port_config(cfg_txen_no_lp, NO_TTL, NO_FILT, 5);
+	set_all_port_config(cfg_lp_lpbk, NO_TTL, YES_FILT, 9);
+
+	init_in.set_on_port = 0;
+	init_in.default_route = RIO_RTV_PORT(5);
+	init_in.default_route_table_port = RIO_RTV_PORT(1);
+	init_in.update_hw = false;
+	init_in.rt = &rt;
+	memset(&rt, 0, sizeof(rt));
+	assert_int_equal(RIO_SUCCESS,
+		rxs_rio_rt_initialize(&mock_dev_info, &init_in, &init_out));
+
+	for (i = 0; i < 2; i++) {
+		alloc_in.rt = &rt;
+		assert_int_equal(RIO_SUCCESS, rio_rt_alloc_mc_mask(
+				&mock_dev_info, &alloc_in, &alloc_out));
+		mc_rte[i] = alloc_out.mc_mask_rte;
+
+		mc_chg_in.mc_mask_rte = mc_rte[i];
+		mc_chg_in.mc_info.in_use = true;
+		mc_chg_in.mc_info.tt = tt_dev8;
+		mc_chg_in.mc_info.mc_destID = 7 + i;
+		mc_chg_in.mc_info.mc_mask = mc_masks[i];
+		mc_chg_in.rt = &rt;
+		assert_int_equal(RIO_SUCCESS, rio_rt_change_mc_mask(
+				&mock_dev_info, &mc_chg_in, &mc_chg_out));
+	}
+
+	const struct {
+		bool dom;
+		uint32_t idx;
+		pe_rt_val rte;
+	} rtes[] = {
+		{false, 3, RIO_RTE_DFLT_PORT},
+		{false, 4, RIO_RTV_PORT(2)},
+		{false, 6, RIO_RTV_PORT(9)},
+		{false, 10, RIO_RTE_DROP},
+		{false, 11, RIO_RTV_PORT(0)},
+		{true, 2, mc_rte[0]},
+		{true, 4, RIO_RTV_LVL_GRP(0)},
+		{true, 6, RIO_RTV_PORT(9)},
+	};
+
+	for (i = 0; i < sizeof(rtes) / sizeof(rtes[0]); i++) {
+		chg_in.dom_entry = rtes[i].dom;
+		chg_in.idx = rtes[i].idx;
+		chg_in.rte_value = rtes[i].rte;
+		chg_in.rt = &rt;
+		assert_int_equal(RIO_SUCCESS, rio_rt_change_rte(&mock_dev_info,
+						&chg_in, &chg_out));
+	}
+
+	set_in.set_on_port = 0;
+	set_in.rt = &rt;
+	assert_int_equal(RIO_SUCCESS,
+			rio_rt_set_all(&mock_dev_info, &set_in, &set_out));
+
+	DAR_proc_ptr_init(rxs_count_read, RXSWriteReg, RXSWaitSec);
+
+	// The first cached probe takes the snapshot
+	memset(&snap, 0, sizeof(snap));
+	assert_false(rio_rt_probe_snap_valid(&mock_dev_info, &snap, 0));
+	c_in.snap = &snap;
+	c_in.probe_on_port = 0;
+	c_in.tt = tt_dev8;
+	c_in.destID = 7;
+	rxs_rd_cnt = 0;
+	assert_int_equal(RIO_SUCCESS,
+			rio_rt_probe_cached(&mock_dev_info, &c_in, &c_out));
+	assert_true(rxs_rd_cnt > 0);
+	assert_true(c_out.valid_route);
+	assert_int_equal(mc_rte[0], c_out.routing_table_value);
+	assert_true(c_out.mcast_ports[1]);
+	assert_false(c_out.mcast_ports[2]);
+	assert_true(c_out.mcast_ports[4]);
+	assert_false(c_out.mcast_ports[9]);
+	assert_true(c_out.filter_function_active);
+
+	// All further probes are answered without register reads
+	for (i = 0; i <= RIO_LAST_DEV8; i++) {
+		dids[i] = (did_reg_t)i;
+	}
+	assert_int_equal(0, rxs_rio_rt_probe_cached_cmp(&snap, 0, tt_dev8,
+					dids, RIO_LAST_DEV8 + 1, false));
+	for (i = 0; i < 0x800; i++) {
+		dids[i] = (did_reg_t)i;
+	}
+	assert_int_equal(0, rxs_rio_rt_probe_cached_cmp(&snap, 0, tt_dev16,
+					dids, 0x800, false));
+
+	// Spot check discard reasons
+	c_in.destID = 3;
+	assert_int_equal(RIO_SUCCESS,
+			rio_rt_probe_cached(&mock_dev_info, &c_in, &c_out));
+	assert_false(c_out.valid_route);
+	assert_int_equal(rio_rt_disc_dflt_pt_no_lp, c_out.reason_for_discard);
+	c_in.destID = 4;
+	assert_int_equal(RIO_SUCCESS,
+			rio_rt_probe_cached(&mock_dev_info, &c_in, &c_out));
+	assert_false(c_out.valid_route);
+	assert_int_equal(rio_rt_disc_port_unavail, c_out.reason_for_discard);
+
+	// Changing the routing table invalidates the snapshot, even before
+	// hardware is updated.
+	chg_in.dom_entry = false;
+	chg_in.idx = 4;
+	chg_in.rte_value = RIO_RTV_PORT(1);
+	chg_in.rt = &rt;
+	assert_int_equal(RIO_SUCCESS,
+		rio_rt_change_rte(&mock_dev_info, &chg_in, &chg_out));
+	assert_false(rio_rt_probe_snap_valid(&mock_dev_info, &snap, 0));
+	assert_true(rxs_rio_rt_probe_cached_cmp(&snap, 0, tt_dev8,
+					dids, RIO_LAST_DEV8 + 1, true) > 0);
+
+	assert_int_equal(RIO_SUCCESS,
+		rio_rt_set_changed(&mock_dev_info, &set_in, &set_out));
+	assert_false(rio_rt_probe_snap_valid(&mock_dev_info, &snap, 0));
+	rxs_rio_rt_probe_cached_cmp(&snap, 0, tt_dev8, dids, 16, true);
+	assert_int_equal(RIO_SUCCESS,
+			rio_rt_probe_cached(&mock_dev_info, &c_in, &c_out));
+	assert_true(c_out.valid_route);
+	assert_int_equal(RIO_RTV_PORT(1), c_out.routing_table_value);
+
+	// Explicit invalidation, and probes on a different port
+	rio_rt_probe_snap_invalidate(&mock_dev_info);
+	assert_false(rio_rt_probe_snap_valid(&mock_dev_info, &snap, 0));
+	rxs_rio_rt_probe_cached_cmp(&snap, 0, tt_dev8, dids, 16, true);
+	assert_false(rio_rt_probe_snap_valid(&mock_dev_info, &snap, 4));
+	rxs_rio_rt_probe_cached_cmp(&snap, 4, tt_dev8, dids, 16, true);
+
+	// Bad parameters
+	b_in.snap = NULL;
+	b_in.probe_on_port = 0;
+	b_in.tt = tt_dev8;
+	b_in.destID_cnt = 1;
+	b_in.destIDs = dids;
+	b_in.probe_out = &c_out;
+	assert_int_not_equal(RIO_SUCCESS,
+			rio_rt_probe_batch(&mock_dev_info, &b_in, &b_out));
+	assert_int_equal(RT_PROBE_BATCH(1), b_out.imp_rc);
+
+	b_in.snap = &snap;
+	dids[0] = 0x100;
+	assert_int_not_equal(RIO_SUCCESS,
+			rio_rt_probe_batch(&mock_dev_info, &b_in, &b_out));
+	assert_int_equal(RT_PROBE_BATCH(2), b_out.imp_rc);
+
+	b_in.tt = (tt_t)3;
+	assert_int_not_equal(RIO_SUCCESS,
+			rio_rt_probe_batch(&mock_dev_info, &b_in, &b_out));
+	assert_int_equal(RT_PROBE_BATCH(3), b_out.imp_rc);
+
+	b_in.tt = tt_dev16;
+	b_in.probe_on_port = NUM_RXS_PORTS(&mock_dev_info);
+	assert_int_not_equal(RIO_SUCCESS,
+			rio_rt_probe_batch(&mock_dev_info, &b_in, &b_out));
+	assert_int_equal(RT_PROBE_SNAP(2), b_out.imp_rc);
+
+	DAR_proc_ptr_init(RXSReadReg, RXSWriteReg, RXSWaitSec);
+	(void)state;
+}
+
 int main(int argc, char** argv)
 {
 	const struct CMUnitTest tests[] = {
@@ -3247,6 +3520,10 @@ int main(int argc, char** argv)
 			cmocka_unit_test_setup_teardown(
 					rxs_rio_rt_probe_bad_parms_test,
 					setup,
+					NULL),
+			cmocka_unit_test_setup_teardown(
+					rxs_rio_rt_probe_cached_test,
+					setup,
 					NULL)
 	};
 
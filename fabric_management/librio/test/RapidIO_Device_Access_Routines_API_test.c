@@ -41,6 +41,7 @@
 #include "cmocka.h"
 
 #include "RapidIO_Device_Access_Routines_API.h"
+#include "RapidIO_Device_Emulation_API.h"
 #include "rio_ecosystem.h"
 
 #ifdef __cplusplus
@@ -256,6 +257,126 @@ static void DAR_add_poreg_limit_test(void **state)
 	(void)state; // unused
 }
 
+// Compares the fields of dev_info filled in by the default driver.
+static void DAR_ef_cache_cmp(DAR_DEV_INFO_t *a, DAR_DEV_INFO_t *b)
+{
+	assert_int_equal(a->devID, b->devID);
+	assert_int_equal(a->devInfo, b->devInfo);
+	assert_int_equal(a->assyInfo, b->assyInfo);
+	assert_int_equal(a->features, b->features);
+	assert_int_equal(a->swPortInfo, b->swPortInfo);
+	assert_int_equal(a->swRtInfo, b->swRtInfo);
+	assert_int_equal(a->srcOps, b->srcOps);
+	assert_int_equal(a->dstOps, b->dstOps);
+	assert_int_equal(a->swMcastInfo, b->swMcastInfo);
+	assert_int_equal(a->extFPtrForPort, b->extFPtrForPort);
+	assert_int_equal(a->extFPtrPortType, b->extFPtrPortType);
+	assert_int_equal(a->extFPtrForLane, b->extFPtrForLane);
+	assert_int_equal(a->extFPtrForErr, b->extFPtrForErr);
+	assert_int_equal(a->extFPtrForVC, b->extFPtrForVC);
+	assert_int_equal(a->extFPtrForVOQ, b->extFPtrForVOQ);
+	assert_int_equal(a->extFPtrForRT, b->extFPtrForRT);
+	assert_int_equal(a->extFPtrForTS, b->extFPtrForTS);
+	assert_int_equal(a->extFPtrForMISC, b->extFPtrForMISC);
+	assert_int_equal(a->extFPtrForHS, b->extFPtrForHS);
+}
+
+// The second device of each type is probed with fewer register reads, and
+// gets the same device information as the first.  CPS drivers do not probe
+// the extended features, so they are not tested.
+static void DAR_ef_cache_hit_test(void **state)
+{
+	const rio_emu_model_t models[] = {rio_emu_rxs2448, rio_emu_rxs1632,
+			rio_emu_tsi578, rio_emu_tsi721};
+	const uint32_t num_models = sizeof(models) / sizeof(models[0]);
+	rio_emu_dev_t *emu[2];
+	DAR_DEV_INFO_t dev_info[2];
+	rio_emu_stats_t stats[2];
+	DAR_ef_cache_stats_t ef_stats;
+	uint32_t idx, dev;
+
+	assert_int_equal(RIO_SUCCESS, rio_emu_bind(false));
+	DAR_ef_cache_enable(true);
+	DAR_ef_cache_clear();
+
+	for (idx = 0; idx < num_models; idx++) {
+		for (dev = 0; dev < 2; dev++) {
+			emu[dev] = rio_emu_create(models[idx]);
+			assert_non_null(emu[dev]);
+			assert_int_equal(RIO_SUCCESS, rio_emu_dev_info_init(
+					emu[dev], &dev_info[dev]));
+			rio_emu_get_stats(emu[dev], &stats[dev]);
+		}
+		DAR_ef_cache_cmp(&dev_info[0], &dev_info[1]);
+		assert_true(stats[1].rd_acc < stats[0].rd_acc);
+		rio_emu_destroy(emu[0]);
+		rio_emu_destroy(emu[1]);
+	}
+
+	DAR_get_ef_cache_stats(&ef_stats);
+	assert_int_equal(num_models, ef_stats.hits);
+	assert_int_equal(num_models, ef_stats.misses);
+
+	DAR_ef_cache_clear();
+	DAR_get_ef_cache_stats(&ef_stats);
+	assert_int_equal(0, ef_stats.hits);
+	assert_int_equal(0, ef_stats.misses);
+
+	(void)state; // unused
+}
+
+// A device whose first extended feature block header differs from the
+// cached header has its extended features read again.
+static void DAR_ef_cache_check_test(void **state)
+{
+	rio_emu_dev_t *emu[2];
+	DAR_DEV_INFO_t dev_info[2];
+	DAR_ef_cache_stats_t ef_stats;
+	uint32_t efb_ptr, efb_hdr;
+	uint32_t dev;
+
+	assert_int_equal(RIO_SUCCESS, rio_emu_bind(false));
+	DAR_ef_cache_enable(true);
+	DAR_ef_cache_clear();
+
+	for (dev = 0; dev < 2; dev++) {
+		emu[dev] = rio_emu_create(rio_emu_rxs2448);
+		assert_non_null(emu[dev]);
+	}
+
+	// Unlink the first extended feature block from the rest of the list
+	efb_ptr = rio_emu_peek(emu[1], RIO_ASSY_INF) & RIO_ASSY_INF_EFB_PTR;
+	assert_int_not_equal(0, efb_ptr);
+	efb_hdr = rio_emu_peek(emu[1], efb_ptr);
+	rio_emu_poke(emu[1], efb_ptr, efb_hdr & RIO_EFB_T);
+
+	for (dev = 0; dev < 2; dev++) {
+		assert_int_equal(RIO_SUCCESS,
+			rio_emu_dev_info_init(emu[dev], &dev_info[dev]));
+	}
+	DAR_get_ef_cache_stats(&ef_stats);
+	assert_int_equal(0, ef_stats.hits);
+	assert_int_equal(2, ef_stats.misses);
+	assert_int_equal(efb_ptr, dev_info[1].extFPtrForPort);
+	assert_int_equal(0, dev_info[1].extFPtrForLane);
+	assert_int_not_equal(0, dev_info[0].extFPtrForLane);
+
+	// Disabled cache is neither used nor updated
+	DAR_ef_cache_enable(false);
+	assert_int_equal(RIO_SUCCESS,
+			rio_emu_dev_info_init(emu[0], &dev_info[0]));
+	DAR_get_ef_cache_stats(&ef_stats);
+	assert_int_equal(0, ef_stats.hits);
+	assert_int_equal(2, ef_stats.misses);
+	DAR_ef_cache_enable(true);
+
+	rio_emu_destroy(emu[0]);
+	rio_emu_destroy(emu[1]);
+	DAR_ef_cache_clear();
+
+	(void)state; // unused
+}
+
 int main(int argc, char** argv)
 {
 	(void)argv; // not used
@@ -268,6 +389,8 @@ int main(int argc, char** argv)
 	cmocka_unit_test(DAR_add_poreg_bad_parms_test),
 	cmocka_unit_test(DAR_add_poreg_success_test),
 	cmocka_unit_test(DAR_add_poreg_limit_test),
+	cmocka_unit_test(DAR_ef_cache_hit_test),
+	cmocka_unit_test(DAR_ef_cache_check_test),
 	};
 	return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -0,0 +1,614 @@
+/*
+ ************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ l of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this l of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <stdarg.h>
+#include <setjmp.h>
+#include "cmocka.h"
+
+#include "RapidIO_Device_Emulation_API.h"
+#include "src/RapidIO_Device_Emulation_API.c"
+#include "RapidIO_Routing_Table_API.h"
+#include "RapidIO_Error_Management_API.h"
+#include "RapidIO_Port_Config_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct emu_test_dev_t_TAG {
+	rio_emu_model_t model;
+	rio_driver_family_t family;
+	uint32_t dev_ident;
+	uint8_t ports;
+	bool sw;
+} emu_test_dev_t;
+
+static const emu_test_dev_t test_devs[] = {
+	{rio_emu_rxs2448, RIO_RXS_DEVICE, 0x80E60038, 24, true},
+	{rio_emu_rxs1632, RIO_RXS_DEVICE, 0x80E50038, 16, true},
+	{rio_emu_cps1848, RIO_CPS_DEVICE, 0x03740038, 18, true},
+	{rio_emu_cps1616, RIO_CPS_DEVICE, 0x03790038, 16, true},
+	{rio_emu_tsi578, RIO_TSI57X_DEVICE, 0x0578000D, 16, true},
+	{rio_emu_tsi721, RIO_TSI721_DEVICE, 0x80AB0038, 1, false},
+};
+
+#define NUM_TEST_DEVS (sizeof(test_devs) / sizeof(test_devs[0]))
+
+static void assumptions(void **state)
+{
+	assert_int_equal(NUM_TEST_DEVS, rio_emu_model_last);
+	assert_true(EMU_MAX_PORTS <= RIO_MAX_PORTS);
+
+	(void)state; // unused
+}
+
+static void rio_emu_model_test(void **state)
+{
+	rio_emu_dev_t *emu;
+	uint32_t idx;
+
+	for (idx = 0; idx < NUM_TEST_DEVS; idx++) {
+		const char *name = rio_emu_model_name(test_devs[idx].model);
+
+		assert_non_null(name);
+		assert_int_equal(test_devs[idx].model,
+				rio_emu_model_by_name(name));
+
+		emu = rio_emu_create(test_devs[idx].model);
+		assert_non_null(emu);
+		assert_int_equal(test_devs[idx].model, rio_emu_get_model(emu));
+		assert_int_equal(test_devs[idx].ports, rio_emu_num_ports(emu));
+		rio_emu_destroy(emu);
+	}
+
+	assert_int_equal(rio_emu_rxs2448, rio_emu_model_by_name("rxs2448"));
+	assert_int_equal(rio_emu_model_last, rio_emu_model_by_name("Tsi999"));
+	assert_int_equal(rio_emu_model_last, rio_emu_model_by_name(NULL));
+	assert_null(rio_emu_model_name(rio_emu_model_last));
+	assert_null(rio_emu_create(rio_emu_model_last));
+
+	(void)state; // unused
+}
+
+// Each model must be found, and bound to its driver, by the device access
+// routines.
+static void rio_emu_probe_test(void **state)
+{
+	DAR_DEV_INFO_t dev_info;
+	rio_emu_dev_t *emu;
+	uint32_t idx;
+
+	assert_int_equal(RIO_SUCCESS, rio_emu_bind(true));
+	for (idx = 0; idx < NUM_TEST_DEVS; idx++) {
+		emu = rio_emu_create(test_devs[idx].model);
+		assert_non_null(emu);
+		assert_int_equal(RIO_SUCCESS,
+				rio_emu_dev_info_init(emu, &dev_info));
+		assert_ptr_equal(emu, dev_info.accessInfo);
+		assert_int_equal(test_devs[idx].dev_ident, dev_info.devID);
+		assert_int_equal(test_devs[idx].family,
+				dev_info.driver_family);
+		assert_int_equal(test_devs[idx].ports, NUM_PORTS(&dev_info));
+		assert_int_equal(test_devs[idx].sw, SWITCH(&dev_info));
+		rio_emu_destroy(emu);
+	}
+
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			rio_emu_dev_info_init(NULL, &dev_info));
+
+	(void)state; // unused
+}
+
+static void rio_emu_read_only_test(void **state)
+{
+	rio_emu_dev_t *emu = rio_emu_create(rio_emu_cps1848);
+	uint32_t data = 0x12345678;
+	uint32_t chk;
+
+	assert_non_null(emu);
+	assert_int_equal(RIO_SUCCESS,
+			rio_emu_write(emu, RIO_DEV_IDENT, 1, &data));
+	assert_int_equal(0x03740038, rio_emu_peek(emu, RIO_DEV_IDENT));
+
+	// Extended features headers are read only
+	chk = rio_emu_peek(emu, 0x100);
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu, 0x100, 1, &data));
+	assert_int_equal(chk, rio_emu_peek(emu, 0x100));
+
+	// Other registers read back the value written
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu, 0xF20000, 1, &data));
+	assert_int_equal(RIO_SUCCESS, rio_emu_read(emu, 0xF20000, 1, &chk));
+	assert_int_equal(data, chk);
+
+	// Unaligned and empty accesses are rejected
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_emu_read(emu, 0xF20002, 1, &chk));
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_emu_write(emu, 0xF20000, 0, &data));
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_emu_read(emu, 0xF20000, 1, NULL));
+
+	rio_emu_destroy(emu);
+
+	(void)state; // unused
+}
+
+static void rio_emu_host_lock_test(void **state)
+{
+	rio_emu_dev_t *emu = rio_emu_create(rio_emu_rxs2448);
+	uint32_t data;
+
+	assert_non_null(emu);
+	assert_int_equal(RIO_HOST_LOCK_DEVID,
+			rio_emu_peek(emu, RIO_HOST_LOCK));
+
+	// Unlocked, the first write takes the lock
+	data = 0x12;
+	assert_int_equal(RIO_SUCCESS,
+			rio_emu_write(emu, RIO_HOST_LOCK, 1, &data));
+	assert_int_equal(0x12, rio_emu_peek(emu, RIO_HOST_LOCK));
+
+	// Another host cannot take or release the lock
+	data = 0x34;
+	assert_int_equal(RIO_SUCCESS,
+			rio_emu_write(emu, RIO_HOST_LOCK, 1, &data));
+	assert_int_equal(0x12, rio_emu_peek(emu, RIO_HOST_LOCK));
+
+	// The owner releases the lock
+	data = 0x12;
+	assert_int_equal(RIO_SUCCESS,
+			rio_emu_write(emu, RIO_HOST_LOCK, 1, &data));
+	assert_int_equal(RIO_HOST_LOCK_DEVID,
+			rio_emu_peek(emu, RIO_HOST_LOCK));
+
+	// Reset releases the lock
+	data = 0x34;
+	assert_int_equal(RIO_SUCCESS,
+			rio_emu_write(emu, RIO_HOST_LOCK, 1, &data));
+	rio_emu_reset(emu);
+	assert_int_equal(RIO_HOST_LOCK_DEVID,
+			rio_emu_peek(emu, RIO_HOST_LOCK));
+
+	rio_emu_destroy(emu);
+
+	(void)state; // unused
+}
+
+static void rio_emu_link_test(void **state)
+{
+	rio_emu_dev_t *emu = rio_emu_create(rio_emu_cps1848);
+	uint32_t err_stat = RIO_SPX_ERR_STAT(0x100, RIO_EFB_T_SP_NOEP_SAER, 3);
+	uint32_t lm_req = RIO_SPX_LM_REQ(0x100, RIO_EFB_T_SP_NOEP_SAER, 3);
+	uint32_t lm_resp = RIO_SPX_LM_RESP(0x100, RIO_EFB_T_SP_NOEP_SAER, 3);
+	uint32_t data;
+
+	assert_non_null(emu);
+
+	// Links are up after reset
+	assert_int_equal(RIO_SUCCESS, rio_emu_read(emu, err_stat, 1, &data));
+	assert_int_equal(RIO_SPX_ERR_STAT_OK, data);
+
+	assert_int_equal(RIO_SUCCESS, rio_emu_set_link(emu, 3, false));
+	assert_int_equal(RIO_SUCCESS, rio_emu_read(emu, err_stat, 1, &data));
+	assert_int_equal(RIO_SPX_ERR_STAT_UNINIT, data);
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_emu_set_link(emu, 18, false));
+
+	// Error bits are write 1 to clear
+	rio_emu_poke(emu, err_stat, RIO_SPX_ERR_STAT_IE
+			| RIO_SPX_ERR_STAT_OE);
+	data = RIO_SPX_ERR_STAT_IE;
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu, err_stat, 1, &data));
+	assert_int_equal(RIO_SUCCESS, rio_emu_read(emu, err_stat, 1, &data));
+	assert_int_equal(RIO_SPX_ERR_STAT_OE
+			| RIO_SPX_ERR_STAT_UNINIT, data);
+
+	// No link maintenance response while the link is down
+	data = RIO_SPX_LM_REQ_CMD_LR_IS;
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu, lm_req, 1, &data));
+	assert_int_equal(RIO_SUCCESS, rio_emu_read(emu, lm_resp, 1, &data));
+	assert_int_equal(0, data);
+
+	// Response is valid once, after a request on a link which is up
+	assert_int_equal(RIO_SUCCESS, rio_emu_set_link(emu, 3, true));
+	data = RIO_SPX_LM_REQ_CMD_LR_IS;
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu, lm_req, 1, &data));
+	assert_int_equal(RIO_SUCCESS, rio_emu_read(emu, lm_resp, 1, &data));
+	assert_int_equal(RIO_SPX_LM_RESP_VLD | RIO_SPX_LM_RESP_STAT12_NOERR,
+			data);
+	assert_int_equal(RIO_SUCCESS, rio_emu_read(emu, lm_resp, 1, &data));
+	assert_int_equal(RIO_SPX_LM_RESP_STAT12_NOERR, data);
+
+	rio_emu_destroy(emu);
+
+	(void)state; // unused
+}
+
+static void rio_emu_bcast_test(void **state)
+{
+	rio_emu_dev_t *emu = rio_emu_create(rio_emu_cps1848);
+	uint32_t data = 5;
+	uint8_t port;
+
+	assert_non_null(emu);
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu,
+			CPS1848_BCAST_DEV_RTE_TABLE_X(0x20), 1, &data));
+	for (port = 0; port < 18; port++) {
+		assert_int_equal(5, rio_emu_peek(emu,
+				CPS1848_PORT_X_DEV_RTE_TABLE_Y(port, 0x20)));
+		assert_int_equal(0, rio_emu_peek(emu,
+				CPS1848_PORT_X_DEV_RTE_TABLE_Y(port, 0x21)));
+	}
+	assert_int_equal(5, rio_emu_peek(emu,
+			CPS1848_BCAST_DEV_RTE_TABLE_X(0x20)));
+
+	rio_emu_destroy(emu);
+
+	(void)state; // unused
+}
+
+static void rio_emu_rxs_mc_test(void **state)
+{
+	rio_emu_dev_t *emu = rio_emu_create(rio_emu_rxs2448);
+	uint32_t data;
+	uint8_t port;
+
+	assert_non_null(emu);
+
+	// Broadcast set, then clear on one port
+	data = 0x0F0F;
+	assert_int_equal(RIO_SUCCESS,
+			rio_emu_write(emu, RXS_BC_MC_X_S_CSR(2), 1, &data));
+	data = 0x0003;
+	assert_int_equal(RIO_SUCCESS,
+			rio_emu_write(emu, RXS_SPX_MC_Y_C_CSR(7, 2), 1, &data));
+
+	for (port = 0; port < 24; port++) {
+		uint32_t exp = (7 == port) ? 0x0F0C : 0x0F0F;
+
+		assert_int_equal(RIO_SUCCESS, rio_emu_read(emu,
+				RXS_SPX_MC_Y_S_CSR(port, 2), 1, &data));
+		assert_int_equal(exp, data);
+		assert_int_equal(RIO_SUCCESS, rio_emu_read(emu,
+				RXS_SPX_MC_Y_C_CSR(port, 2), 1, &data));
+		assert_int_equal(exp, data);
+		assert_int_equal(0, rio_emu_peek(emu,
+				RXS_SPX_MC_Y_S_CSR(port, 3)));
+	}
+
+	rio_emu_destroy(emu);
+
+	(void)state; // unused
+}
+
+static void rio_emu_tsi57x_rt_test(void **state)
+{
+	rio_emu_dev_t *emu = rio_emu_create(rio_emu_tsi578);
+	uint32_t data;
+	uint32_t idx;
+
+	assert_non_null(emu);
+
+	// Entries are unrouted after reset
+	assert_int_equal(0xFF, rio_emu_peek_tsi57x_rte(emu, 4, 0x10));
+
+	// Write three entries of port 4 with auto increment
+	data = TSI578_SPX_ROUTE_CFG_DESTID_AUTO_INC | 0x10;
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu,
+			TSI578_SPX_ROUTE_CFG_DESTID(4), 1, &data));
+	for (idx = 0; idx < 3; idx++) {
+		data = idx + 1;
+		assert_int_equal(RIO_SUCCESS, rio_emu_write(emu,
+				TSI578_SPX_ROUTE_CFG_PORT(4), 1, &data));
+	}
+	for (idx = 0; idx < 3; idx++) {
+		assert_int_equal(idx + 1,
+				rio_emu_peek_tsi57x_rte(emu, 4, 0x10 + idx));
+		assert_int_equal(0xFF,
+				rio_emu_peek_tsi57x_rte(emu, 5, 0x10 + idx));
+	}
+	assert_int_equal(0xFF, rio_emu_peek_tsi57x_rte(emu, 4, 0x13));
+
+	// Read back without auto increment
+	data = 0x11;
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu,
+			TSI578_SPX_ROUTE_CFG_DESTID(4), 1, &data));
+	assert_int_equal(RIO_SUCCESS, rio_emu_read(emu,
+			TSI578_SPX_ROUTE_CFG_PORT(4), 1, &data));
+	assert_int_equal(2, data);
+	assert_int_equal(RIO_SUCCESS, rio_emu_read(emu,
+			TSI578_SPX_ROUTE_CFG_PORT(4), 1, &data));
+	assert_int_equal(2, data);
+
+	// Broadcast writes update every port
+	data = 0x20;
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu,
+			TSI578_RIO_ROUTE_CFG_DESTID, 1, &data));
+	data = 7;
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu,
+			TSI578_RIO_ROUTE_CFG_PORT, 1, &data));
+	for (idx = 0; idx < 16; idx++) {
+		assert_int_equal(7, rio_emu_peek_tsi57x_rte(emu,
+				(uint8_t)idx, 0x20));
+	}
+
+	// Reset clears the routing tables
+	rio_emu_reset(emu);
+	assert_int_equal(0xFF, rio_emu_peek_tsi57x_rte(emu, 4, 0x10));
+	assert_int_equal(0xFF, rio_emu_peek_tsi57x_rte(emu, 9, 0x20));
+
+	rio_emu_destroy(emu);
+
+	(void)state; // unused
+}
+
+static void rio_emu_stats_test(void **state)
+{
+	rio_emu_dev_t *emu = rio_emu_create(rio_emu_rxs2448);
+	rio_emu_lat_t lat = {1000, 10, false};
+	rio_emu_stats_t stats;
+	uint32_t data[8];
+
+	assert_non_null(emu);
+	memset(data, 0, sizeof(data));
+	rio_emu_set_lat(emu, &lat);
+
+	assert_int_equal(RIO_SUCCESS, rio_emu_read(emu, 0, 8, data));
+	assert_int_equal(0x80E60038, data[0]);
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu, 0x20000, 8, data));
+	assert_int_equal(RIO_SUCCESS, rio_emu_write(emu, 0x20000, 1, data));
+
+	rio_emu_get_stats(emu, &stats);
+	assert_int_equal(1, stats.rd_acc);
+	assert_int_equal(8, stats.regs_rd);
+	assert_int_equal(2, stats.wr_acc);
+	assert_int_equal(9, stats.regs_wr);
+	assert_int_equal(0, stats.fails);
+	assert_int_equal(3000 + (17 * 10), stats.lat_ns);
+
+	// Peek and poke are not counted
+	rio_emu_poke(emu, 0x20000, 1);
+	assert_int_equal(1, rio_emu_peek(emu, 0x20000));
+
+	// Failed accesses stop at the failing register
+	rio_emu_clr_stats(emu);
+	rio_emu_set_fail(emu, 0x20008);
+	assert_int_equal(RIO_ERR_ACCESS, rio_emu_read(emu, 0x20000, 8, data));
+	assert_int_equal(RIO_ERR_ACCESS, rio_emu_write(emu, 0x20008, 1, data));
+	rio_emu_get_stats(emu, &stats);
+	assert_int_equal(1, stats.rd_acc);
+	assert_int_equal(2, stats.regs_rd);
+	assert_int_equal(1, stats.wr_acc);
+	assert_int_equal(0, stats.regs_wr);
+	assert_int_equal(2, stats.fails);
+
+	rio_emu_set_fail(emu, RIO_EMU_NO_FAIL);
+	assert_int_equal(RIO_SUCCESS, rio_emu_read(emu, 0x20000, 8, data));
+
+	rio_emu_clr_stats(emu);
+	rio_emu_get_stats(emu, &stats);
+	assert_int_equal(0, stats.rd_acc + stats.wr_acc + stats.lat_ns);
+
+	rio_emu_destroy(emu);
+
+	(void)state; // unused
+}
+
+// Routing tables written by each switch driver read back the same, with
+// and without block accesses.  Block accesses must use fewer maintenance
+// transactions for the same registers.
+static void rio_emu_rt_roundtrip_test(void **state)
+{
+	DAR_DEV_INFO_t dev_info;
+	rio_rt_state_t *rt, *chk;
+	rio_rt_initialize_in_t init_in;
+	rio_rt_initialize_out_t init_out;
+	rio_rt_set_all_in_t set_in;
+	rio_rt_set_all_out_t set_out;
+	rio_rt_probe_all_in_t probe_in;
+	rio_rt_probe_all_out_t probe_out;
+	rio_emu_stats_t stats[2];
+	rio_emu_dev_t *emu;
+	uint32_t idx, i;
+	uint32_t blk;
+
+	rt = (rio_rt_state_t *)malloc(sizeof(rio_rt_state_t));
+	chk = (rio_rt_state_t *)malloc(sizeof(rio_rt_state_t));
+	assert_non_null(rt);
+	assert_non_null(chk);
+
+	for (idx = 0; idx < NUM_TEST_DEVS; idx++) {
+		if (!test_devs[idx].sw) {
+			continue;
+		}
+		for (blk = 0; blk < 2; blk++) {
+			assert_int_equal(RIO_SUCCESS, rio_emu_bind(blk));
+			emu = rio_emu_create(test_devs[idx].model);
+			assert_non_null(emu);
+			assert_int_equal(RIO_SUCCESS,
+					rio_emu_dev_info_init(emu, &dev_info));
+
+			init_in.set_on_port = RIO_ALL_PORTS;
+			init_in.default_route = RIO_RTE_DROP;
+			init_in.default_route_table_port = RIO_RTE_DROP;
+			init_in.update_hw = false;
+			init_in.rt = rt;
+			assert_int_equal(RIO_SUCCESS, rio_rt_initialize(
+					&dev_info, &init_in, &init_out));
+			for (i = 0; i < RIO_RT_GRP_SZ; i++) {
+				rt->dev_table[i].rte_val =
+						i % test_devs[idx].ports;
+			}
+
+			rio_emu_clr_stats(emu);
+			set_in.set_on_port = RIO_ALL_PORTS;
+			set_in.rt = rt;
+			assert_int_equal(RIO_SUCCESS, rio_rt_set_all(
+					&dev_info, &set_in, &set_out));
+			rio_emu_get_stats(emu, &stats[blk]);
+
+			probe_in.probe_on_port = 1;
+			probe_in.rt = chk;
+			assert_int_equal(RIO_SUCCESS, rio_rt_probe_all(
+					&dev_info, &probe_in, &probe_out));
+			for (i = 0; i < RIO_RT_GRP_SZ; i++) {
+				assert_int_equal(i % test_devs[idx].ports,
+						chk->dev_table[i].rte_val);
+			}
+			rio_emu_destroy(emu);
+		}
+		assert_int_equal(stats[0].regs_wr, stats[1].regs_wr);
+		assert_true(stats[1].wr_acc <= stats[0].wr_acc);
+	}
+
+	free(rt);
+	free(chk);
+
+	(void)state; // unused
+}
+
+// Port configuration and event management configuration succeed for every
+// model, which requires the emulated reset values to be consistent.
+static void rio_emu_cfg_test(void **state)
+{
+	DAR_DEV_INFO_t dev_info;
+	rio_pc_get_config_in_t pc_in;
+	rio_pc_get_config_out_t *pc_out;
+	rio_pc_set_config_in_t set_in;
+	rio_em_cfg_t event = {rio_em_d_ttl, rio_em_detect_on, 1000000};
+	rio_em_cfg_set_in_t em_in;
+	rio_em_cfg_set_out_t em_out;
+	rio_emu_dev_t *emu;
+	uint32_t idx;
+
+	pc_out = (rio_pc_get_config_out_t *)malloc(sizeof(*pc_out));
+	assert_non_null(pc_out);
+	assert_int_equal(RIO_SUCCESS, rio_emu_bind(true));
+
+	for (idx = 0; idx < NUM_TEST_DEVS; idx++) {
+		emu = rio_emu_create(test_devs[idx].model);
+		assert_non_null(emu);
+		assert_int_equal(RIO_SUCCESS,
+				rio_emu_dev_info_init(emu, &dev_info));
+
+		pc_in.ptl.num_ports = RIO_ALL_PORTS;
+		assert_int_equal(RIO_SUCCESS,
+				rio_pc_get_config(&dev_info, &pc_in, pc_out));
+		assert_int_equal(test_devs[idx].ports, pc_out->num_ports);
+
+		memset(&set_in, 0, sizeof(set_in));
+		set_in.lrto = 50;
+		set_in.log_rto = 500;
+		set_in.oob_reg_acc = false;
+		set_in.reg_acc_port = 0;
+		set_in.num_ports = pc_out->num_ports;
+		memcpy(set_in.pc, pc_out->pc, sizeof(set_in.pc));
+		assert_int_equal(RIO_SUCCESS,
+				rio_pc_set_config(&dev_info, &set_in, pc_out));
+
+		em_in.ptl.num_ports = RIO_ALL_PORTS;
+		em_in.notfn = rio_em_notfn_none;
+		em_in.num_events = 1;
+		em_in.events = &event;
+		assert_int_equal(RIO_SUCCESS,
+				rio_em_cfg_set(&dev_info, &em_in, &em_out));
+
+		rio_emu_destroy(emu);
+	}
+	free(pc_out);
+
+	(void)state; // unused
+}
+
+static uint64_t test_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+// Sleeps are paced: the thread never runs further ahead of the sum of the
+// delays than RIO_EMU_PACE_NS.
+static void rio_emu_sleep_test(void **state)
+{
+	const uint64_t delay = 10000;
+	uint64_t start, elapsed;
+	uint32_t i;
+
+	start = test_now_ns();
+	for (i = 1; i <= 50; i++) {
+		rio_emu_sleep_ns(delay);
+		elapsed = test_now_ns() - start;
+		assert_true(elapsed + RIO_EMU_PACE_NS >= delay * i);
+	}
+
+	// Sleeping for nothing returns immediately
+	start = test_now_ns();
+	rio_emu_sleep_ns(0);
+	assert_true(test_now_ns() - start < RIO_EMU_PACE_NS);
+
+	(void)state; // unused
+}
+
+int main(int argc, char** argv)
+{
+	(void)argv; // not used
+	argc++; // not used
+
+	const struct CMUnitTest tests[] = {
+	cmocka_unit_test(assumptions),
+	cmocka_unit_test(rio_emu_model_test),
+	cmocka_unit_test(rio_emu_probe_test),
+	cmocka_unit_test(rio_emu_read_only_test),
+	cmocka_unit_test(rio_emu_host_lock_test),
+	cmocka_unit_test(rio_emu_link_test),
+	cmocka_unit_test(rio_emu_bcast_test),
+	cmocka_unit_test(rio_emu_rxs_mc_test),
+	cmocka_unit_test(rio_emu_tsi57x_rt_test),
+	cmocka_unit_test(rio_emu_stats_test),
+	cmocka_unit_test(rio_emu_rt_roundtrip_test),
+	cmocka_unit_test(rio_emu_cfg_test),
+	cmocka_unit_test(rio_emu_sleep_test),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,499 @@
+/*
+ ************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ l of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this l of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <stdarg.h>
+#include <setjmp.h>
+#include "cmocka.h"
+
+#include "RapidIO_Fabric_Emulation_API.h"
+#include "src/RapidIO_Fabric_Emulation_API.c"
+#include "RapidIO_Routing_Table_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const rio_emu_model_t test_sws[] = {
+	rio_emu_rxs2448,
+	rio_emu_rxs1632,
+	rio_emu_cps1848,
+	rio_emu_cps1616,
+	rio_emu_tsi578,
+};
+
+#define NUM_TEST_SWS (sizeof(test_sws) / sizeof(test_sws[0]))
+
+// Master port mp on port 3 of switch sw, endpoints ep0 and ep1 on ports 5
+// and 7.
+static const char *test_topo =
+	"// test fabric\n"
+	"DEVICE mp tsi721\n"
+	"DEVICE sw cps1848 // comment\n"
+	"DEVICE ep0 Tsi721\n"
+	"DEVICE ep1 TSI721\n"
+	"\n"
+	"CONNECT mp.0 sw.3\n"
+	"CONNECT sw.5 ep0.0\n"
+	"CONNECT ep1.0 sw.7\n"
+	"MPORT mp\n"
+	"EOF\n"
+	"DEVICE ignored tsi721\n";
+
+static FILE *test_file(const char *text)
+{
+	FILE *fp = tmpfile();
+
+	assert_non_null(fp);
+	assert_int_equal(strlen(text), fwrite(text, 1, strlen(text), fp));
+	rewind(fp);
+	return fp;
+}
+
+static rio_fab_t *test_fab(void)
+{
+	rio_fab_t *fab = rio_fab_create();
+	FILE *fp = test_file(test_topo);
+	uint32_t line = 0;
+
+	assert_non_null(fab);
+	assert_int_equal(RIO_SUCCESS, rio_fab_parse(fab, fp, &line));
+	fclose(fp);
+	return fab;
+}
+
+// Drops every destination ID on every port of the switch.  Domain 0 of
+// dev16 destination IDs is routed by the device table.
+static void test_init_rt(rio_emu_dev_t *emu)
+{
+	DAR_DEV_INFO_t dev_info;
+	rio_rt_initialize_in_t init_in;
+	rio_rt_initialize_out_t init_out;
+
+	assert_int_equal(RIO_SUCCESS, rio_emu_bind(true));
+	assert_int_equal(RIO_SUCCESS, rio_emu_dev_info_init(emu, &dev_info));
+
+	init_in.set_on_port = RIO_ALL_PORTS;
+	init_in.default_route = RIO_RTE_DROP;
+	init_in.default_route_table_port = RIO_RTE_DROP;
+	init_in.update_hw = true;
+	init_in.rt = NULL;
+	assert_int_equal(RIO_SUCCESS,
+			rio_rt_initialize(&dev_info, &init_in, &init_out));
+}
+
+// Programs the route for did on every port of the switch, using the device
+// routing table or, for dev16 destination IDs outside of domain 0, the
+// domain routing table.
+static void test_set_route(rio_emu_dev_t *emu, uint32_t did, bool dev16,
+		uint32_t port)
+{
+	DAR_DEV_INFO_t dev_info;
+	rio_rt_state_t *rt;
+	rio_rt_probe_all_in_t probe_in;
+	rio_rt_probe_all_out_t probe_out;
+	rio_rt_change_rte_in_t chg_in;
+	rio_rt_change_rte_out_t chg_out;
+	rio_rt_set_changed_in_t set_in;
+	rio_rt_set_changed_out_t set_out;
+
+	rt = (rio_rt_state_t *)calloc(1, sizeof(rio_rt_state_t));
+	assert_non_null(rt);
+	assert_int_equal(RIO_SUCCESS, rio_emu_bind(true));
+	assert_int_equal(RIO_SUCCESS, rio_emu_dev_info_init(emu, &dev_info));
+
+	probe_in.probe_on_port = RIO_ALL_PORTS;
+	probe_in.rt = rt;
+	assert_int_equal(RIO_SUCCESS,
+			rio_rt_probe_all(&dev_info, &probe_in, &probe_out));
+
+	chg_in.dom_entry = dev16 && (did >> 8);
+	chg_in.idx = (uint8_t)(chg_in.dom_entry ? (did >> 8) : did);
+	chg_in.rte_value = port;
+	chg_in.rt = rt;
+	assert_int_equal(RIO_SUCCESS,
+			rio_rt_change_rte(&dev_info, &chg_in, &chg_out));
+
+	set_in.set_on_port = RIO_ALL_PORTS;
+	set_in.rt = rt;
+	assert_int_equal(RIO_SUCCESS,
+			rio_rt_set_changed(&dev_info, &set_in, &set_out));
+	free(rt);
+}
+
+static void assumptions(void **state)
+{
+	assert_int_equal(NUM_TEST_SWS + 1, rio_emu_model_last);
+
+	(void)state; // unused
+}
+
+static void rio_fab_parse_test(void **state)
+{
+	rio_fab_t *fab = test_fab();
+	uint32_t mp, sw, ep0, ep1;
+	uint32_t lp_dev = RIO_FAB_NO_DEV;
+	uint8_t lp_port = 0;
+
+	assert_int_equal(4, rio_fab_num_devs(fab));
+	mp = rio_fab_find_dev(fab, "mp");
+	sw = rio_fab_find_dev(fab, "sw");
+	ep0 = rio_fab_find_dev(fab, "ep0");
+	ep1 = rio_fab_find_dev(fab, "ep1");
+	assert_int_equal(RIO_FAB_NO_DEV, rio_fab_find_dev(fab, "ignored"));
+	assert_int_equal(mp, rio_fab_get_mport(fab));
+	assert_string_equal("sw", rio_fab_dev_name(fab, sw));
+	assert_true(rio_fab_is_switch(fab, sw));
+	assert_false(rio_fab_is_switch(fab, ep1));
+	assert_int_equal(rio_emu_cps1848,
+			rio_emu_get_model(rio_fab_get_emu(fab, sw)));
+
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_get_lp(fab, mp, 0, &lp_dev, &lp_port));
+	assert_int_equal(sw, lp_dev);
+	assert_int_equal(3, lp_port);
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_get_lp(fab, sw, 7, &lp_dev, &lp_port));
+	assert_int_equal(ep1, lp_dev);
+	assert_int_equal(0, lp_port);
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_get_lp(fab, ep0, 0, &lp_dev, &lp_port));
+	assert_int_equal(sw, lp_dev);
+	assert_int_equal(5, lp_port);
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_fab_get_lp(fab, sw, 4, &lp_dev, &lp_port));
+
+	rio_fab_destroy(fab);
+	(void)state; // unused
+}
+
+static void rio_fab_parse_fail_test(void **state)
+{
+	const char *bad[] = {
+		"DEVICE mp tsi999\n",
+		"DEVICE mp tsi721\nDEVICE mp tsi721\n",
+		"DEVICE mp tsi721\nCONNECT mp.0 sw.3\n",
+		"DEVICE mp tsi721\nDEVICE sw rxs2448\nCONNECT mp.1 sw.3\n",
+		"DEVICE mp tsi721\nDEVICE sw rxs2448\nCONNECT mp.0 sw.24\n",
+		"DEVICE mp tsi721\nDEVICE sw rxs2448\nCONNECT mp.0 sw\n",
+		"DEVICE mp tsi721\n\n// comment\nMPORT mp\n",
+		"DEVICE mp tsi721\nDEVICE sw rxs2448\nCONNECT mp.0 sw.3\n"
+				"CONNECT mp.0 sw.4\n",
+		"DEVICE mp tsi721\nLINK mp.0 sw.3\n",
+	};
+	const uint32_t bad_line[] = {1, 2, 2, 3, 3, 3, 4, 4, 2};
+	rio_fab_t *fab;
+	FILE *fp;
+	uint32_t idx, line;
+
+	for (idx = 0; idx < sizeof(bad) / sizeof(bad[0]); idx++) {
+		fab = rio_fab_create();
+		assert_non_null(fab);
+		fp = test_file(bad[idx]);
+		line = 0;
+		assert_int_not_equal(RIO_SUCCESS,
+				rio_fab_parse(fab, fp, &line));
+		assert_int_equal(bad_line[idx], line);
+		fclose(fp);
+		rio_fab_destroy(fab);
+	}
+
+	fab = rio_fab_create();
+	assert_int_not_equal(RIO_SUCCESS,
+			rio_fab_load(fab, "/no/such/fabric", &line));
+	rio_fab_destroy(fab);
+
+	(void)state; // unused
+}
+
+// Requests are performed by the switch at hop count 0, and routed by
+// destination ID past it.  The switch reports the port which received the
+// request.
+static void rio_fab_route_test(void **state)
+{
+	rio_fab_t *fab = test_fab();
+	rio_fab_stats_t stats;
+	uint32_t sw = rio_fab_find_dev(fab, "sw");
+	uint32_t ep1 = rio_fab_find_dev(fab, "ep1");
+	uint32_t data, dev;
+
+	dev = RIO_FAB_NO_DEV;
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_maint_read(fab, 0xFF, 0, RIO_DEV_IDENT, 1,
+					&data, &dev));
+	assert_int_equal(sw, dev);
+	assert_int_equal(0x03740038, data);
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_maint_read(fab, 0xFF, 0, RIO_SW_PORT_INF, 1,
+					&data, NULL));
+	assert_int_equal(3, RIO_ACCESS_PORT(data));
+
+	// No route to the endpoint yet
+	assert_int_equal(RIO_ERR_ROUTE_ERROR,
+			rio_fab_maint_read(fab, 0x10, 1, RIO_DEV_IDENT, 1,
+					&data, &dev));
+
+	test_set_route(rio_fab_get_emu(fab, sw), 0x10, false, 7);
+	dev = RIO_FAB_NO_DEV;
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_maint_read(fab, 0x10, 1, RIO_DEV_IDENT, 1,
+					&data, &dev));
+	assert_int_equal(ep1, dev);
+	assert_int_equal(0x80AB0038, data);
+
+	// Endpoints perform every request which reaches them
+	data = 0x00100010;
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_maint_write(fab, 0x10, 5, RIO_DEVID, 1,
+					&data, &dev));
+	assert_int_equal(ep1, dev);
+	data = 0;
+	assert_int_equal(RIO_SUCCESS,
+			rio_emu_read(rio_fab_get_emu(fab, ep1), RIO_DEVID, 1,
+					&data));
+	assert_int_equal(0x00100010, data);
+
+	// Other destination IDs are still dropped
+	assert_int_equal(RIO_ERR_ROUTE_ERROR,
+			rio_fab_maint_read(fab, 0x11, 1, RIO_DEV_IDENT, 1,
+					&data, &dev));
+
+	rio_fab_get_stats(fab, &stats);
+	assert_int_equal(5, stats.rd_acc);
+	assert_int_equal(1, stats.wr_acc);
+	assert_int_equal(2, stats.fails);
+	assert_int_equal(1 + 1 + 1 + 2 + 2 + 1, stats.hops);
+
+	rio_fab_clr_stats(fab);
+	rio_fab_get_stats(fab, &stats);
+	assert_int_equal(0, stats.rd_acc + stats.wr_acc + stats.fails
+			+ stats.hops + stats.lat_ns);
+
+	rio_fab_destroy(fab);
+	(void)state; // unused
+}
+
+// Every switch family routes 8 bit destination IDs through the device
+// table, and 16 bit destination IDs outside of domain 0 through the domain
+// table.
+static void rio_emu_route_test(void **state)
+{
+	rio_emu_dev_t *emu;
+	uint8_t port;
+	uint32_t idx;
+
+	for (idx = 0; idx < NUM_TEST_SWS; idx++) {
+		emu = rio_emu_create(test_sws[idx]);
+		assert_non_null(emu);
+
+		test_init_rt(emu);
+		test_set_route(emu, 0x05, false, 3);
+		test_set_route(emu, 0x0205, true, 2);
+
+		port = 0xFF;
+		assert_int_equal(RIO_SUCCESS,
+				rio_emu_route(emu, 0, 0x05, false, &port));
+		assert_int_equal(3, port);
+		assert_int_equal(RIO_SUCCESS,
+				rio_emu_route(emu, 1, 0x0005, true, &port));
+		assert_int_equal(3, port);
+		assert_int_equal(RIO_SUCCESS,
+				rio_emu_route(emu, 2, 0x0205, true, &port));
+		assert_int_equal(2, port);
+		assert_int_equal(RIO_SUCCESS,
+				rio_emu_route(emu, 2, 0x02FE, true, &port));
+		assert_int_equal(2, port);
+
+		assert_int_equal(RIO_ERR_ROUTE_ERROR,
+				rio_emu_route(emu, 0, 0x06, false, &port));
+		assert_int_equal(RIO_ERR_ROUTE_ERROR,
+				rio_emu_route(emu, 0, 0x0305, true, &port));
+		assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+				rio_emu_route(emu, rio_emu_num_ports(emu),
+						0x05, false, &port));
+		rio_emu_destroy(emu);
+	}
+
+	emu = rio_emu_create(rio_emu_tsi721);
+	assert_int_equal(RIO_ERR_NO_SWITCH,
+			rio_emu_route(emu, 0, 0x05, false, &port));
+	rio_emu_destroy(emu);
+
+	(void)state; // unused
+}
+
+// A delivered request takes each link twice, a dropped request once.
+static void rio_fab_lat_test(void **state)
+{
+	rio_fab_t *fab = test_fab();
+	rio_fab_lat_t lat = {100, 1000, 10, false, false};
+	rio_fab_stats_t stats;
+	uint32_t data[4];
+
+	rio_fab_set_lat(fab, &lat);
+	test_set_route(rio_fab_get_emu(fab, rio_fab_find_dev(fab, "sw")),
+			0x10, false, 5);
+
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_maint_read(fab, 0x10, 0, RIO_DEV_IDENT, 2,
+					data, NULL));
+	rio_fab_get_stats(fab, &stats);
+	assert_int_equal(200 + 1000 + 20, stats.lat_ns);
+
+	rio_fab_clr_stats(fab);
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_maint_read(fab, 0x10, 1, RIO_DEV_IDENT, 4,
+					data, NULL));
+	rio_fab_get_stats(fab, &stats);
+	assert_int_equal(400 + 1000 + 40, stats.lat_ns);
+
+	rio_fab_clr_stats(fab);
+	assert_int_equal(RIO_ERR_ROUTE_ERROR,
+			rio_fab_maint_read(fab, 0x11, 1, RIO_DEV_IDENT, 1,
+					data, NULL));
+	rio_fab_get_stats(fab, &stats);
+	assert_int_equal(100, stats.lat_ns);
+
+	// Local accesses do not cross a link
+	rio_fab_clr_stats(fab);
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_local_read(fab, RIO_DEV_IDENT, 1, data));
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_local_write(fab, RIO_COMPTAG, 1, data));
+	rio_fab_get_stats(fab, &stats);
+	assert_int_equal(1, stats.lcl_rd);
+	assert_int_equal(1, stats.lcl_wr);
+	assert_int_equal(0, stats.rd_acc + stats.wr_acc + stats.hops);
+
+	rio_fab_destroy(fab);
+	(void)state; // unused
+}
+
+// Generated trees hold the requested number of devices, and every device
+// other than the first switch is connected to its parent through port 0.
+static void rio_fab_gen_tree_test(void **state)
+{
+	const uint32_t nodes[] = {2, 10, 100, 1000};
+	rio_fab_t *fab;
+	uint32_t lp_dev = RIO_FAB_NO_DEV;
+	uint8_t lp_port = 0;
+	uint32_t idx, n, dev, sw_cnt;
+
+	for (idx = 0; idx < NUM_TEST_SWS; idx++) {
+		for (n = 0; n < sizeof(nodes) / sizeof(nodes[0]); n++) {
+			fab = rio_fab_create();
+			assert_non_null(fab);
+			assert_int_equal(RIO_SUCCESS, rio_fab_gen_tree(fab,
+					test_sws[idx], rio_emu_tsi721,
+					nodes[n]));
+			assert_int_equal(nodes[n], rio_fab_num_devs(fab));
+			assert_int_equal(rio_fab_find_dev(fab, "mport"),
+					rio_fab_get_mport(fab));
+
+			sw_cnt = 0;
+			for (dev = 0; dev < nodes[n]; dev++) {
+				if (rio_fab_is_switch(fab, dev)) {
+					sw_cnt++;
+				}
+				assert_int_equal(RIO_SUCCESS,
+						rio_fab_get_lp(fab, dev, 0,
+						&lp_dev, &lp_port));
+			}
+			assert_true(sw_cnt >= 1);
+			assert_true(sw_cnt < nodes[n]);
+			rio_fab_destroy(fab);
+		}
+	}
+
+	fab = rio_fab_create();
+	assert_int_not_equal(RIO_SUCCESS, rio_fab_gen_tree(fab,
+			rio_emu_tsi721, rio_emu_tsi721, 10));
+	rio_fab_destroy(fab);
+
+	(void)state; // unused
+}
+
+static void rio_fab_dev16_test(void **state)
+{
+	rio_fab_t *fab = test_fab();
+	uint32_t sw = rio_fab_find_dev(fab, "sw");
+	uint32_t data, dev;
+
+	assert_false(rio_fab_get_dev16(fab));
+	rio_fab_set_dev16(fab, true);
+	assert_true(rio_fab_get_dev16(fab));
+
+	test_init_rt(rio_fab_get_emu(fab, sw));
+	test_set_route(rio_fab_get_emu(fab, sw), 0x0410, true, 5);
+	dev = RIO_FAB_NO_DEV;
+	assert_int_equal(RIO_SUCCESS,
+			rio_fab_maint_read(fab, 0x0410, 1, RIO_DEV_IDENT, 1,
+					&data, &dev));
+	assert_int_equal(rio_fab_find_dev(fab, "ep0"), dev);
+
+	// The same destination ID is dropped as an 8 bit destination ID
+	rio_fab_set_dev16(fab, false);
+	assert_int_equal(RIO_ERR_ROUTE_ERROR,
+			rio_fab_maint_read(fab, 0x10, 1, RIO_DEV_IDENT, 1,
+					&data, &dev));
+
+	rio_fab_destroy(fab);
+	(void)state; // unused
+}
+
+int main(int argc, char** argv)
+{
+	(void)argv; // not used
+	argc++; // not used
+
+	const struct CMUnitTest tests[] = {
+	cmocka_unit_test(assumptions),
+	cmocka_unit_test(rio_fab_parse_test),
+	cmocka_unit_test(rio_fab_parse_fail_test),
+	cmocka_unit_test(rio_fab_route_test),
+	cmocka_unit_test(rio_emu_route_test),
+	cmocka_unit_test(rio_fab_lat_test),
+	cmocka_unit_test(rio_fab_gen_tree_test),
+	cmocka_unit_test(rio_fab_dev16_test),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
+
+#ifdef __cplusplus
+}
+#endif
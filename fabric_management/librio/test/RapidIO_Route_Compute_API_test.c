@@ -0,0 +1,717 @@
+/*
+ ************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ l of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this l of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#include <stdarg.h>
+#include <setjmp.h>
+#include "cmocka.h"
+
+#include "RapidIO_Route_Compute_API.h"
+#include "src/RapidIO_Route_Compute_API.c"
+#include "rio_ecosystem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Synthetic fabric.  Switches are nodes 0 to sw_cnt - 1, endpoints follow.
+// Every endpoint has a single port.
+struct rc_topo {
+	uint32_t sw_cnt;
+	uint32_t ep_cnt;
+	rio_route_node_t *nodes;
+	rio_rt_state_t *rt;
+	rio_route_compute_in_t in;
+	rio_route_compute_out_t out;
+};
+
+#define RC_EP(t, e) ((t)->sw_cnt + (e))
+
+static void rc_init_rt(rio_rt_state_t *rt)
+{
+	uint32_t i;
+
+	memset(rt, 0, sizeof(*rt));
+	rt->default_route = RIO_RTE_DROP;
+	for (i = 0; i < RIO_RT_GRP_SZ; i++) {
+		rt->dev_table[i].rte_val = RIO_RTE_DROP;
+		rt->dom_table[i].rte_val = RIO_RTE_DROP;
+	}
+	rt->dom_table[0].rte_val = RIO_RTE_LVL_G0;
+}
+
+static void rc_topo_alloc(struct rc_topo *t, uint32_t sw_cnt, uint32_t ep_cnt,
+		uint8_t sw_ports, tt_t tt)
+{
+	uint32_t n;
+
+	memset(t, 0, sizeof(*t));
+	t->sw_cnt = sw_cnt;
+	t->ep_cnt = ep_cnt;
+	t->nodes = (rio_route_node_t *)calloc(sw_cnt + ep_cnt,
+			sizeof(rio_route_node_t));
+	t->rt = (rio_rt_state_t *)calloc(sw_cnt, sizeof(rio_rt_state_t));
+	assert_non_null(t->nodes);
+	assert_non_null(t->rt);
+
+	for (n = 0; n < sw_cnt; n++) {
+		rio_route_node_init(&t->nodes[n], true, sw_ports);
+		rc_init_rt(&t->rt[n]);
+		t->nodes[n].rt = &t->rt[n];
+	}
+	for (n = 0; n < ep_cnt; n++) {
+		rio_route_node_init(&t->nodes[RC_EP(t, n)], false, 1);
+	}
+
+	t->in.tt = tt;
+	t->in.node_cnt = sw_cnt + ep_cnt;
+	t->in.nodes = t->nodes;
+}
+
+static void rc_topo_free(struct rc_topo *t)
+{
+	free(t->nodes);
+	free(t->rt);
+	memset(t, 0, sizeof(*t));
+}
+
+static void rc_connect(struct rc_topo *t, uint32_t n1, uint8_t p1, uint32_t n2,
+		uint8_t p2)
+{
+	assert_int_equal(RIO_SUCCESS,
+			rio_route_connect(t->nodes, t->in.node_cnt, n1, p1, n2, p2));
+}
+
+// Connects eps endpoints to each switch starting at port first_port.
+// dev8 destIDs are numbered from 1.  For dev16 each switch is a domain,
+// numbered from 1 as domain 0 always uses the device table.
+static void rc_add_eps(struct rc_topo *t, uint32_t eps, uint8_t first_port)
+{
+	uint32_t s, i, e;
+
+	for (s = 0; s < t->sw_cnt; s++) {
+		for (i = 0; i < eps; i++) {
+			e = s * eps + i;
+			rc_connect(t, s, (uint8_t)(first_port + i), RC_EP(t, e), 0);
+			if (tt_dev8 == t->in.tt) {
+				t->nodes[RC_EP(t, e)].destID = e + 1;
+			} else {
+				t->nodes[RC_EP(t, e)].destID =
+					((s + 1) << 8) | (i + 1);
+			}
+		}
+	}
+}
+
+// Ring: port 0 to the next switch, port 1 to the previous switch
+static void rc_ring(struct rc_topo *t, uint32_t sw_cnt, uint32_t eps, tt_t tt)
+{
+	uint32_t s;
+
+	rc_topo_alloc(t, sw_cnt, sw_cnt * eps, (uint8_t)(2 + eps), tt);
+	for (s = 0; s < sw_cnt; s++) {
+		rc_connect(t, s, 0, (s + 1) % sw_cnt, 1);
+	}
+	rc_add_eps(t, eps, 2);
+}
+
+// Mesh: ports 0/1/2/3 connect north/south/west/east, endpoints from port 4.
+// For dev16, each blk x blk block of switches is a domain, numbered from 1.
+static void rc_mesh(struct rc_topo *t, uint32_t rows, uint32_t cols,
+		uint32_t eps, tt_t tt, uint32_t blk)
+{
+	uint32_t r, c, i, s, e;
+
+	rc_topo_alloc(t, rows * cols, rows * cols * eps, (uint8_t)(4 + eps), tt);
+	for (r = 0; r < rows; r++) {
+		for (c = 0; c < cols; c++) {
+			s = r * cols + c;
+			if (r + 1 < rows) {
+				rc_connect(t, s, 1, s + cols, 0);
+			}
+			if (c + 1 < cols) {
+				rc_connect(t, s, 3, s + 1, 2);
+			}
+			for (i = 0; i < eps; i++) {
+				e = s * eps + i;
+				rc_connect(t, s, (uint8_t)(4 + i), RC_EP(t, e), 0);
+				t->nodes[RC_EP(t, e)].destID = (tt_dev8 == tt) ?
+					e + 1 :
+					((((r / blk) * (cols / blk) + c / blk + 1) << 8)
+					| ((((r % blk) * blk + c % blk) * eps) + i + 1));
+			}
+		}
+	}
+}
+
+// Two level fat tree: leaves are switches 0 to leaves - 1, spines follow.
+// Each leaf connects to each spine with links parallel links, leaf ports
+// 0 to spines * links - 1 are uplinks.  Endpoints connect to leaves only.
+static void rc_fat_tree(struct rc_topo *t, uint32_t leaves, uint32_t spines,
+		uint32_t links, uint32_t eps, tt_t tt)
+{
+	uint32_t l, s, k, e;
+	uint8_t up = (uint8_t)(spines * links);
+
+	rc_topo_alloc(t, leaves + spines, leaves * eps,
+			(uint8_t)(up + eps > leaves * links ?
+					up + eps : leaves * links), tt);
+	for (l = 0; l < leaves; l++) {
+		for (s = 0; s < spines; s++) {
+			for (k = 0; k < links; k++) {
+				rc_connect(t, l, (uint8_t)(s * links + k),
+					leaves + s, (uint8_t)(l * links + k));
+			}
+		}
+		for (k = 0; k < eps; k++) {
+			e = l * eps + k;
+			rc_connect(t, l, (uint8_t)(up + k), RC_EP(t, e), 0);
+			t->nodes[RC_EP(t, e)].destID = (tt_dev8 == tt) ?
+					e + 1 : ((l + 1) << 8) | (k + 1);
+		}
+	}
+}
+
+static pe_rt_val rc_lookup(rio_rt_state_t *rt, tt_t tt, did_reg_t did)
+{
+	if (tt_dev16 == tt) {
+		pe_rt_val val = rt->dom_table[did >> 8].rte_val;
+
+		if (RIO_RTE_LVL_G0 != val) {
+			return val;
+		}
+	}
+	return rt->dev_table[did & 0xFF].rte_val;
+}
+
+// Follows the routing tables from endpoint src to did.
+// Returns the node reached and the number of switches traversed.
+static uint32_t rc_walk(struct rc_topo *t, uint32_t src, did_reg_t did,
+		uint32_t *hops)
+{
+	rio_route_link_t *link = &t->nodes[src].link[0];
+	uint32_t n = link->peer;
+
+	*hops = 0;
+	while ((RR_NONE != n) && t->nodes[n].is_sw) {
+		pe_rt_val val = rc_lookup(t->nodes[n].rt, t->in.tt, did);
+
+		if ((++*hops > t->sw_cnt) || !RIO_RTV_IS_PORT(val)
+				|| (val >= t->nodes[n].port_cnt)) {
+			return RR_NONE;
+		}
+		n = t->nodes[n].link[val].peer;
+	}
+	return n;
+}
+
+// Checks that every endpoint reaches every other endpoint, and returns
+// the total number of switch hops.
+static uint64_t rc_check_all_pairs(struct rc_topo *t)
+{
+	uint64_t total = 0;
+	uint32_t src, dst, hops;
+
+	for (src = 0; src < t->ep_cnt; src++) {
+		for (dst = 0; dst < t->ep_cnt; dst++) {
+			did_reg_t did = t->nodes[RC_EP(t, dst)].destID;
+
+			assert_int_equal(RC_EP(t, dst),
+					rc_walk(t, RC_EP(t, src), did, &hops));
+			total += hops;
+		}
+	}
+	return total;
+}
+
+static void rc_compute(struct rc_topo *t)
+{
+	assert_int_equal(RIO_SUCCESS, rio_route_compute(&t->in, &t->out));
+	assert_int_equal(t->sw_cnt, t->out.sw_cnt);
+	assert_int_equal(t->ep_cnt, t->out.dest_cnt);
+	assert_int_equal(0, t->out.unreachable);
+	assert_int_equal(0, t->out.conflicts);
+}
+
+static void assumptions_test(void **state)
+{
+	assert_true(RIO_MAX_PORTS <= 32);
+	assert_int_equal(0xFFFFFFFF, RIO_ROUTE_NO_NODE);
+	(void)state; // unused
+}
+
+static void rc_parms_test(void **state)
+{
+	struct rc_topo t;
+	uint32_t mbr = 0;
+	rio_route_mc_grp_t mc;
+
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR, rio_route_compute(NULL, &t.out));
+
+	rc_ring(&t, 3, 1, tt_dev8);
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR, rio_route_compute(&t.in, NULL));
+
+	t.in.tt = (tt_t)3;
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_route_compute(&t.in, &t.out));
+	assert_int_equal(RT_COMPUTE(2), t.out.imp_rc);
+	t.in.tt = tt_dev8;
+
+	// Duplicate destID
+	t.nodes[RC_EP(&t, 1)].destID = t.nodes[RC_EP(&t, 0)].destID;
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_route_compute(&t.in, &t.out));
+	assert_int_equal(RT_COMPUTE(7), t.out.imp_rc);
+	t.nodes[RC_EP(&t, 1)].destID = 0x10;
+
+	// dev16 destID in a dev8 fabric
+	t.nodes[RC_EP(&t, 1)].destID = 0x100;
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_route_compute(&t.in, &t.out));
+	assert_int_equal(RT_COMPUTE(6), t.out.imp_rc);
+	t.nodes[RC_EP(&t, 1)].destID = 0x10;
+
+	// Asymmetric link
+	t.nodes[0].link[0].peer_port = 2;
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_route_compute(&t.in, &t.out));
+	assert_int_equal(RT_COMPUTE(4), t.out.imp_rc);
+	t.nodes[0].link[0].peer_port = 1;
+
+	// Missing routing table
+	t.nodes[1].rt = NULL;
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			rio_route_compute(&t.in, &t.out));
+	assert_int_equal(RT_COMPUTE(5), t.out.imp_rc);
+	t.nodes[1].rt = &t.rt[1];
+
+	// Multicast destID used by an endpoint, member which is a switch
+	mc.mc_destID = t.nodes[RC_EP(&t, 0)].destID;
+	mc.mbr_cnt = 1;
+	mc.mbr = &mbr;
+	t.in.mc_cnt = 1;
+	t.in.mc = &mc;
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_route_compute(&t.in, &t.out));
+	assert_int_equal(RT_COMPUTE(8), t.out.imp_rc);
+	mc.mc_destID = 0x80;
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_route_compute(&t.in, &t.out));
+	assert_int_equal(RT_COMPUTE(0xA), t.out.imp_rc);
+	t.in.mc_cnt = 0;
+
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_route_connect(t.nodes, t.in.node_cnt, 0, 5, 1, 0));
+
+	rc_compute(&t);
+	rc_topo_free(&t);
+	(void)state; // unused
+}
+
+static void rc_ring_test(void **state)
+{
+	struct rc_topo t;
+	uint32_t src, dst, hops, dist;
+	uint32_t cw = 0, ccw = 0;
+
+	rc_ring(&t, 6, 2, tt_dev8);
+	rc_compute(&t);
+	rc_check_all_pairs(&t);
+
+	for (src = 0; src < t.ep_cnt; src++) {
+		for (dst = 0; dst < t.ep_cnt; dst++) {
+			uint32_t s1 = src / 2, s2 = dst / 2;
+
+			dist = (s1 > s2) ? s1 - s2 : s2 - s1;
+			if (dist > 3) {
+				dist = 6 - dist;
+			}
+			rc_walk(&t, RC_EP(&t, src),
+					t.nodes[RC_EP(&t, dst)].destID, &hops);
+			assert_int_equal(dist + 1, hops);
+		}
+	}
+
+	// Switch 3 is opposite switch 0, its endpoints are at equal cost
+	// in both directions.  They must be split between both directions.
+	for (dst = 6; dst < 8; dst++) {
+		pe_rt_val val = t.rt[0].dev_table[dst + 1].rte_val;
+
+		cw += (0 == val);
+		ccw += (1 == val);
+	}
+	assert_int_equal(1, cw);
+	assert_int_equal(1, ccw);
+
+	// Computing again does not change anything
+	assert_int_equal(RIO_SUCCESS, rio_route_compute(&t.in, &t.out));
+	assert_int_equal(0, t.out.rte_chg);
+
+	rc_topo_free(&t);
+	(void)state; // unused
+}
+
+static void rc_parallel_links_test(void **state)
+{
+	struct rc_topo t;
+	uint32_t load[4] = {0, 0, 0, 0};
+	uint32_t e, p;
+
+	// Two switches joined by 4 parallel links, 16 endpoints per switch
+	rc_topo_alloc(&t, 2, 32, 20, tt_dev8);
+	for (p = 0; p < 4; p++) {
+		rc_connect(&t, 0, (uint8_t)p, 1, (uint8_t)p);
+	}
+	rc_add_eps(&t, 16, 4);
+	rc_compute(&t);
+	rc_check_all_pairs(&t);
+
+	for (e = 16; e < 32; e++) {
+		pe_rt_val val = t.rt[0].dev_table[e + 1].rte_val;
+
+		assert_true(val < 4);
+		load[val]++;
+	}
+	for (p = 0; p < 4; p++) {
+		assert_int_equal(4, load[p]);
+	}
+
+	rc_topo_free(&t);
+	(void)state; // unused
+}
+
+static void rc_fat_tree_test(void **state)
+{
+	struct rc_topo t;
+	uint32_t load[4] = {0, 0, 0, 0};
+	uint32_t l, p;
+
+	// dev8: every leaf spreads remote destinations over 4 spines
+	rc_fat_tree(&t, 4, 4, 1, 8, tt_dev8);
+	rc_compute(&t);
+	assert_int_equal(4 * 8 * 4 * 8 * 3 - 4 * 8 * 8 * 2,
+			rc_check_all_pairs(&t));
+	for (l = 8; l < 32; l++) {
+		pe_rt_val val = t.rt[0].dev_table[l + 1].rte_val;
+
+		assert_true(val < 4);
+		load[val]++;
+	}
+	for (p = 0; p < 4; p++) {
+		assert_int_equal(6, load[p]);
+	}
+	rc_topo_free(&t);
+
+	// dev16: one domain per leaf.  Remote leaves use domain table
+	// entries spread over the spines, the local domain uses the device
+	// table.  Spines route every domain with a domain table entry.
+	memset(load, 0, sizeof(load));
+	rc_fat_tree(&t, 9, 4, 1, 4, tt_dev16);
+	rc_compute(&t);
+	rc_check_all_pairs(&t);
+	assert_int_equal(RIO_RTE_LVL_G0, t.rt[0].dom_table[1].rte_val);
+	for (l = 1; l < 9; l++) {
+		pe_rt_val val = t.rt[0].dom_table[l + 1].rte_val;
+
+		assert_true(val < 4);
+		load[val]++;
+	}
+	for (p = 0; p < 4; p++) {
+		assert_int_equal(2, load[p]);
+	}
+	for (l = 0; l < 9; l++) {
+		assert_int_equal(l, t.rt[9].dom_table[l + 1].rte_val);
+	}
+	rc_topo_free(&t);
+	(void)state; // unused
+}
+
+static void rc_mesh_test(void **state)
+{
+	struct rc_topo t;
+	uint32_t src, dst, hops;
+
+	rc_mesh(&t, 4, 5, 3, tt_dev16, 1);
+	rc_compute(&t);
+	rc_check_all_pairs(&t);
+
+	for (src = 0; src < t.ep_cnt; src++) {
+		for (dst = 0; dst < t.ep_cnt; dst++) {
+			uint32_t s1 = src / 3, s2 = dst / 3;
+			uint32_t r1 = s1 / 5, c1 = s1 % 5;
+			uint32_t r2 = s2 / 5, c2 = s2 % 5;
+			uint32_t dist = (r1 > r2 ? r1 - r2 : r2 - r1)
+					+ (c1 > c2 ? c1 - c2 : c2 - c1);
+
+			rc_walk(&t, RC_EP(&t, src),
+					t.nodes[RC_EP(&t, dst)].destID, &hops);
+			assert_int_equal(dist + 1, hops);
+		}
+	}
+
+	// Domains spanning several switches
+	rc_topo_free(&t);
+	rc_mesh(&t, 4, 4, 3, tt_dev16, 2);
+	rc_compute(&t);
+	rc_check_all_pairs(&t);
+	rc_topo_free(&t);
+	(void)state; // unused
+}
+
+static void rc_clear_unused_test(void **state)
+{
+	struct rc_topo t;
+
+	rc_ring(&t, 4, 1, tt_dev16);
+	t.rt[0].dev_table[0x55].rte_val = 1;
+	t.rt[0].dom_table[0x55].rte_val = 1;
+	rc_compute(&t);
+	assert_int_equal(1, t.rt[0].dev_table[0x55].rte_val);
+	assert_int_equal(1, t.rt[0].dom_table[0x55].rte_val);
+
+	t.in.clear_unused = true;
+	rc_compute(&t);
+	assert_int_equal(RIO_RTE_DROP, t.rt[0].dev_table[0x55].rte_val);
+	assert_true(t.rt[0].dev_table[0x55].changed);
+	assert_int_equal(RIO_RTE_DROP, t.rt[0].dom_table[0x55].rte_val);
+	assert_int_equal(RIO_RTE_LVL_G0, t.rt[0].dom_table[0].rte_val);
+	rc_check_all_pairs(&t);
+	rc_topo_free(&t);
+	(void)state; // unused
+}
+
+// Floods a multicast packet from endpoint src and counts the copies
+// received by each endpoint.
+static void rc_flood(struct rc_topo *t, uint32_t src, did_reg_t did,
+		uint32_t *rx)
+{
+	uint32_t q_node[1024], q_port[1024];
+	uint32_t head = 0, tail = 0, steps = 0;
+
+	memset(rx, 0, t->ep_cnt * sizeof(uint32_t));
+	q_node[tail] = t->nodes[src].link[0].peer;
+	q_port[tail++] = t->nodes[src].link[0].peer_port;
+
+	while (head < tail) {
+		uint32_t n = q_node[head];
+		uint32_t in_port = q_port[head++];
+		pe_rt_val val;
+		uint32_t mask;
+		uint8_t p;
+
+		assert_true(++steps < 1000);
+		if (!t->nodes[n].is_sw) {
+			rx[n - t->sw_cnt]++;
+			continue;
+		}
+
+		val = rc_lookup(t->nodes[n].rt, t->in.tt, did);
+		if (RIO_RTV_IS_MC_MSK(val)) {
+			mask = t->nodes[n].rt->mc_masks[RIO_RTV_GET_MC_MSK(val)].mc_mask;
+			assert_true(t->nodes[n].rt->mc_masks[RIO_RTV_GET_MC_MSK(val)].in_use);
+			mask &= ~RR_BIT(in_port);
+		} else {
+			assert_true(RIO_RTV_IS_PORT(val));
+			mask = RR_BIT(val);
+		}
+
+		for (p = 0; p < t->nodes[n].port_cnt; p++) {
+			if (!(mask & RR_BIT(p))) {
+				continue;
+			}
+			assert_true(tail < 1024);
+			q_node[tail] = t->nodes[n].link[p].peer;
+			q_port[tail++] = t->nodes[n].link[p].peer_port;
+		}
+	}
+}
+
+static void rc_multicast_test_tt(tt_t tt, did_reg_t mc_did)
+{
+	struct rc_topo t;
+	rio_route_mc_grp_t mc;
+	uint32_t mbr[4] = {1, 4, 7, 12};
+	uint32_t rx[32];
+	uint32_t src, i, e;
+
+	// Mesh has many equal cost paths, a union of unicast routes would
+	// deliver duplicates.
+	rc_mesh(&t, 3, 3, 2, tt, 1);
+	for (i = 0; i < 4; i++) {
+		mbr[i] += t.sw_cnt;
+	}
+	mc.mc_destID = mc_did;
+	mc.mbr_cnt = 4;
+	mc.mbr = mbr;
+	t.in.mc_cnt = 1;
+	t.in.mc = &mc;
+	rc_compute(&t);
+	assert_true(t.out.mc_masks > 0);
+	rc_check_all_pairs(&t);
+
+	for (src = 0; src < t.ep_cnt; src++) {
+		rc_flood(&t, RC_EP(&t, src), mc_did, rx);
+		for (e = 0; e < t.ep_cnt; e++) {
+			bool member = false;
+
+			for (i = 0; i < 4; i++) {
+				member |= (RC_EP(&t, e) == mbr[i]);
+			}
+			assert_int_equal((member && (e != src)) ? 1 : 0, rx[e]);
+		}
+	}
+
+	// Recomputing with fewer members reuses the multicast masks
+	mc.mbr_cnt = 2;
+	rc_compute(&t);
+	rc_flood(&t, RC_EP(&t, 0), mc_did, rx);
+	for (e = 0; e < t.ep_cnt; e++) {
+		assert_int_equal((RC_EP(&t, e) == mbr[0] || RC_EP(&t, e) == mbr[1])
+				? 1 : 0, rx[e]);
+	}
+	for (i = 0; i < t.sw_cnt; i++) {
+		uint32_t m, used = 0;
+
+		for (m = 0; m < RIO_MAX_MC_MASKS; m++) {
+			used += t.rt[i].mc_masks[m].in_use;
+		}
+		assert_true(used <= 1);
+	}
+	rc_topo_free(&t);
+}
+
+static void rc_multicast_test(void **state)
+{
+	rc_multicast_test_tt(tt_dev8, 0xF0);
+	rc_multicast_test_tt(tt_dev16, 0xE012);
+	(void)state; // unused
+}
+
+static double rc_elapsed(struct timespec *st, struct timespec *end)
+{
+	return (double)(end->tv_sec - st->tv_sec)
+			+ (double)(end->tv_nsec - st->tv_nsec) / 1e9;
+}
+
+static void rc_bench(const char *name, struct rc_topo *t, bool check)
+{
+	struct timespec st, end;
+	double comp_t, recomp_t;
+	uint32_t rte_chg;
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	assert_int_equal(RIO_SUCCESS, rio_route_compute(&t->in, &t->out));
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	comp_t = rc_elapsed(&st, &end);
+	rte_chg = t->out.rte_chg;
+	assert_int_equal(0, t->out.unreachable);
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	assert_int_equal(RIO_SUCCESS, rio_route_compute(&t->in, &t->out));
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	recomp_t = rc_elapsed(&st, &end);
+	assert_int_equal(0, t->out.rte_chg);
+
+	if (check) {
+		uint32_t src, dst, hops;
+
+		// Routes from a sample of sources reach every destination
+		assert_int_equal(0, t->out.conflicts);
+		for (src = 0; src < t->ep_cnt; src += t->ep_cnt / 8 + 1) {
+			for (dst = 0; dst < t->ep_cnt; dst++) {
+				assert_int_equal(RC_EP(t, dst), rc_walk(t,
+					RC_EP(t, src),
+					t->nodes[RC_EP(t, dst)].destID, &hops));
+			}
+		}
+	}
+
+	printf("%-22s %5u switches %6u dests: compute %8.2f ms, "
+			"recompute %8.2f ms, %7u entries, %u conflicts\n",
+			name, t->sw_cnt, t->ep_cnt, comp_t * 1000,
+			recomp_t * 1000, rte_chg, t->out.conflicts);
+	rc_topo_free(t);
+}
+
+static void rc_bench_test(void **state)
+{
+	struct rc_topo t;
+
+	rc_fat_tree(&t, 24, 8, 1, 16, tt_dev16);
+	rc_bench("fat tree dev16", &t, true);
+
+	rc_fat_tree(&t, 6, 4, 2, 16, tt_dev8);
+	rc_bench("fat tree 2x links dev8", &t, true);
+
+	rc_mesh(&t, 15, 16, 20, tt_dev16, 1);
+	rc_bench("mesh dev16", &t, true);
+
+	rc_ring(&t, 64, 3, tt_dev8);
+	rc_bench("ring dev8", &t, true);
+
+	rc_ring(&t, 255, 20, tt_dev16);
+	rc_bench("ring dev16", &t, true);
+
+	// 57600 dev16 destIDs, each 4x4 block of switches is a domain
+	rc_mesh(&t, 64, 60, 15, tt_dev16, 4);
+	rc_bench("mesh 64K dev16", &t, true);
+	(void)state; // unused
+}
+
+int main(int argc, char** argv)
+{
+	(void)argv; // not used
+	argc++; // not used
+
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(assumptions_test),
+		cmocka_unit_test(rc_parms_test),
+		cmocka_unit_test(rc_ring_test),
+		cmocka_unit_test(rc_parallel_links_test),
+		cmocka_unit_test(rc_fat_tree_test),
+		cmocka_unit_test(rc_mesh_test),
+		cmocka_unit_test(rc_clear_unused_test),
+		cmocka_unit_test(rc_multicast_test),
+		cmocka_unit_test(rc_bench_test),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
+
+#ifdef __cplusplus
+}
+#endif
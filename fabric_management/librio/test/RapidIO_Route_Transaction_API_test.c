@@ -0,0 +1,651 @@
+/*
+ ************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ l of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this l of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <stdarg.h>
+#include <setjmp.h>
+#include "cmocka.h"
+
+#include "RapidIO_Device_Access_Routines_API.h"
+#include "RapidIO_Route_Transaction_API.h"
+#include "RXS2448.h"
+#include "src/RapidIO_Route_Transaction_API.c"
+#include "rio_ecosystem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef RXS_DAR_WANTED
+
+static void rt_txn_not_supported_test(void **state)
+{
+	(void)state; // not used
+}
+
+int main(int argc, char** argv)
+{
+	(void)argv; // not used
+	argc++;// not used
+
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(rt_txn_not_supported_test)};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
+
+#endif /* RXS_DAR_WANTED */
+
+#ifdef RXS_DAR_WANTED
+
+// Emulated RXS2448 switch, holding the routing table registers.
+struct tx_sw {
+	DAR_DEV_INFO_t dev;
+	uint32_t dom[RIO_RT_GRP_SZ];
+	uint32_t dev_tbl[RIO_RT_GRP_SZ];
+	uint32_t dflt_wr;
+	uint32_t other_wr;
+};
+
+// Synthetic fabric, as for the route compute tests.  Switches are nodes
+// 0 to sw_cnt - 1, endpoints follow.
+//
+// nodes holds the topology used to compute the new routes, phys holds
+// every link which carries traffic while the transaction runs.  Links
+// which are being removed are present in phys but not in nodes.
+struct tx_topo {
+	uint32_t sw_cnt;
+	uint32_t ep_cnt;
+	rio_route_node_t *nodes;
+	rio_route_node_t *phys;
+	rio_rt_state_t *rt;
+	struct tx_sw *sw;
+	tt_t tt;
+};
+
+#define TX_EP(t, e) ((t)->sw_cnt + (e))
+
+// Emulated register access state.  When tx_chk is set, every register
+// write is followed by a check that all endpoints are reachable from
+// every switch using the hardware routing tables.
+static pthread_mutex_t tx_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct tx_topo *tx_cur;
+static bool tx_chk;
+static uint32_t tx_bad;
+static uint32_t tx_blk_calls;
+static uint32_t tx_wr_delay_ns;
+
+// Maintenance transactions block waiting for the response, model that
+// latency by sleeping.
+static void tx_delay(void)
+{
+	struct timespec dly;
+
+	if (!tx_wr_delay_ns) {
+		return;
+	}
+	dly.tv_sec = 0;
+	dly.tv_nsec = tx_wr_delay_ns;
+	nanosleep(&dly, NULL);
+}
+
+static uint32_t tx_hw_lookup(struct tx_sw *sw, tt_t tt, did_reg_t did)
+{
+	if (tt_dev16 == tt) {
+		uint32_t val = sw->dom[(did >> 8) & 0xFF];
+
+		if (RIO_RTE_LVL_G0 != val) {
+			return val;
+		}
+	}
+	return sw->dev_tbl[did & 0xFF];
+}
+
+// Follows the hardware routing tables from switch src to did over the
+// physical links.  Returns the node reached, or RIO_ROUTE_NO_NODE when
+// the packet loops or is dropped.
+static uint32_t tx_hw_walk(struct tx_topo *t, uint32_t src, did_reg_t did)
+{
+	uint32_t n = src;
+	uint32_t hops = 0;
+
+	while ((RIO_ROUTE_NO_NODE != n) && t->phys[n].is_sw) {
+		uint32_t val = tx_hw_lookup(&t->sw[n], t->tt, did);
+
+		if ((++hops > t->sw_cnt) || !RIO_RTV_IS_PORT(val)
+				|| (val >= t->phys[n].port_cnt)) {
+			return RIO_ROUTE_NO_NODE;
+		}
+		n = t->phys[n].link[val].peer;
+	}
+	return n;
+}
+
+static uint32_t tx_hw_check(struct tx_topo *t)
+{
+	uint32_t s, e, bad = 0;
+
+	for (s = 0; s < t->sw_cnt; s++) {
+		for (e = 0; e < t->ep_cnt; e++) {
+			if (TX_EP(t, e) != tx_hw_walk(t, s,
+					t->phys[TX_EP(t, e)].destID)) {
+				bad++;
+			}
+		}
+	}
+	return bad;
+}
+
+static void tx_store(struct tx_sw *sw, uint32_t offset, uint32_t data)
+{
+	if ((offset >= RXS_BC_L1_GX_ENTRYY_CSR(0, 0))
+			&& (offset <= RXS_BC_L1_GX_ENTRYY_CSR(0, 0xFF))) {
+		sw->dom[(offset - RXS_BC_L1_GX_ENTRYY_CSR(0, 0)) / 4] = data;
+	} else if ((offset >= RXS_BC_L2_GX_ENTRYY_CSR(0, 0))
+			&& (offset <= RXS_BC_L2_GX_ENTRYY_CSR(0, 0xFF))) {
+		sw->dev_tbl[(offset - RXS_BC_L2_GX_ENTRYY_CSR(0, 0)) / 4] = data;
+	} else if (RXS_ROUTE_DFLT_PORT == offset) {
+		sw->dflt_wr++;
+	} else {
+		sw->other_wr++;
+	}
+}
+
+static uint32_t tx_rd(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t *readdata)
+{
+	(void)dev_info;
+	(void)offset;
+	*readdata = 0;
+	return RIO_SUCCESS;
+}
+
+static uint32_t tx_wr_blk(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *writedata)
+{
+	struct tx_sw *sw = (struct tx_sw *)dev_info->accessInfo;
+	uint32_t i;
+
+	tx_delay();
+	pthread_mutex_lock(&tx_lock);
+	tx_blk_calls++;
+	for (i = 0; i < cnt; i++) {
+		tx_store(sw, offset + (4 * i), writedata[i]);
+	}
+	if (tx_chk) {
+		tx_bad += tx_hw_check(tx_cur);
+	}
+	pthread_mutex_unlock(&tx_lock);
+	return RIO_SUCCESS;
+}
+
+static uint32_t tx_wr(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t writedata)
+{
+	return tx_wr_blk(dev_info, offset, 1, &writedata);
+}
+
+static void tx_wait(uint32_t delay_nsec, uint32_t delay_sec)
+{
+	(void)delay_nsec;
+	(void)delay_sec;
+}
+
+static void tx_init_rt(rio_rt_state_t *rt)
+{
+	uint32_t i;
+
+	memset(rt, 0, sizeof(*rt));
+	rt->default_route = RIO_RTE_DROP;
+	for (i = 0; i < RIO_RT_GRP_SZ; i++) {
+		rt->dev_table[i].rte_val = RIO_RTE_DROP;
+		rt->dom_table[i].rte_val = RIO_RTE_DROP;
+	}
+	rt->dom_table[0].rte_val = RIO_RTE_LVL_G0;
+}
+
+static void tx_init_sw(struct tx_sw *sw)
+{
+	uint32_t i;
+
+	memset(sw, 0, sizeof(*sw));
+	strcpy(sw->dev.name, "RXS2448");
+	sw->dev.accessInfo = sw;
+	sw->dev.devID = 0x80E60038;
+	sw->dev.dsf_h = 0x00380000;
+	sw->dev.driver_family = RIO_RXS_DEVICE;
+	sw->dev.swPortInfo = 0x1805;
+	sw->dev.swRtInfo = 255;
+	for (i = 0; i < RIO_RT_GRP_SZ; i++) {
+		sw->dom[i] = RIO_RTE_DROP;
+		sw->dev_tbl[i] = RIO_RTE_DROP;
+	}
+	sw->dom[0] = RIO_RTE_LVL_G0;
+}
+
+static void tx_topo_alloc(struct tx_topo *t, uint32_t sw_cnt, uint32_t ep_cnt,
+		uint8_t sw_ports, tt_t tt)
+{
+	uint32_t n;
+
+	memset(t, 0, sizeof(*t));
+	t->sw_cnt = sw_cnt;
+	t->ep_cnt = ep_cnt;
+	t->tt = tt;
+	t->nodes = (rio_route_node_t *)calloc(sw_cnt + ep_cnt,
+			sizeof(rio_route_node_t));
+	t->phys = (rio_route_node_t *)calloc(sw_cnt + ep_cnt,
+			sizeof(rio_route_node_t));
+	t->rt = (rio_rt_state_t *)calloc(sw_cnt, sizeof(rio_rt_state_t));
+	t->sw = (struct tx_sw *)calloc(sw_cnt, sizeof(struct tx_sw));
+	assert_non_null(t->nodes);
+	assert_non_null(t->phys);
+	assert_non_null(t->rt);
+	assert_non_null(t->sw);
+
+	for (n = 0; n < sw_cnt; n++) {
+		rio_route_node_init(&t->nodes[n], true, sw_ports);
+		rio_route_node_init(&t->phys[n], true, sw_ports);
+		tx_init_rt(&t->rt[n]);
+		tx_init_sw(&t->sw[n]);
+		t->nodes[n].rt = &t->rt[n];
+		t->nodes[n].dev_info = &t->sw[n].dev;
+	}
+	for (n = 0; n < ep_cnt; n++) {
+		rio_route_node_init(&t->nodes[TX_EP(t, n)], false, 1);
+		rio_route_node_init(&t->phys[TX_EP(t, n)], false, 1);
+	}
+}
+
+static void tx_topo_free(struct tx_topo *t)
+{
+	free(t->nodes);
+	free(t->phys);
+	free(t->rt);
+	free(t->sw);
+	memset(t, 0, sizeof(*t));
+}
+
+// Connects two nodes physically, and in the routing topology if route is
+// true.
+static void tx_connect(struct tx_topo *t, uint32_t n1, uint8_t p1,
+		uint32_t n2, uint8_t p2, bool route)
+{
+	uint32_t cnt = t->sw_cnt + t->ep_cnt;
+
+	assert_int_equal(RIO_SUCCESS,
+			rio_route_connect(t->phys, cnt, n1, p1, n2, p2));
+	if (route) {
+		assert_int_equal(RIO_SUCCESS,
+			rio_route_connect(t->nodes, cnt, n1, p1, n2, p2));
+	}
+}
+
+static void tx_disconnect(struct tx_topo *t, uint32_t n1, uint8_t p1)
+{
+	rio_route_link_t *l1 = &t->nodes[n1].link[p1];
+
+	t->nodes[l1->peer].link[l1->peer_port].peer = RIO_ROUTE_NO_NODE;
+	l1->peer = RIO_ROUTE_NO_NODE;
+}
+
+// Ring of switches: port 0 to the next switch, port 1 to the previous
+// switch, port 2 to the switch opposite on the ring if chords is set.
+// Endpoints connect from port 3.  For dev16 each switch is a domain,
+// numbered from 1.
+static void tx_ring(struct tx_topo *t, uint32_t sw_cnt, uint32_t eps,
+		tt_t tt, bool chords)
+{
+	uint32_t s, i, e;
+
+	tx_topo_alloc(t, sw_cnt, sw_cnt * eps, (uint8_t)(3 + eps), tt);
+	for (s = 0; s < sw_cnt; s++) {
+		tx_connect(t, s, 0, (s + 1) % sw_cnt, 1, true);
+	}
+	for (s = 0; s < sw_cnt / 2; s++) {
+		tx_connect(t, s, 2, s + sw_cnt / 2, 2, chords);
+	}
+	for (s = 0; s < sw_cnt; s++) {
+		for (i = 0; i < eps; i++) {
+			e = s * eps + i;
+			tx_connect(t, s, (uint8_t)(3 + i), TX_EP(t, e), 0, true);
+			t->nodes[TX_EP(t, e)].destID = (tt_dev8 == tt) ?
+					e + 1 : ((s + 1) << 8) | (i + 1);
+			t->phys[TX_EP(t, e)].destID =
+					t->nodes[TX_EP(t, e)].destID;
+		}
+	}
+}
+
+static void tx_compute(struct tx_topo *t)
+{
+	rio_route_compute_in_t in;
+	rio_route_compute_out_t out;
+
+	memset(&in, 0, sizeof(in));
+	in.tt = t->tt;
+	in.node_cnt = t->sw_cnt + t->ep_cnt;
+	in.nodes = t->nodes;
+	assert_int_equal(RIO_SUCCESS, rio_route_compute(&in, &out));
+	assert_int_equal(0, out.unreachable);
+}
+
+static void tx_commit(struct tx_topo *t, uint32_t threads, bool chk,
+		rio_rt_txn_out_t *out)
+{
+	rio_rt_txn_in_t in;
+
+	memset(&in, 0, sizeof(in));
+	in.tt = t->tt;
+	in.node_cnt = t->sw_cnt + t->ep_cnt;
+	in.nodes = t->nodes;
+	in.thread_cnt = threads;
+
+	tx_cur = t;
+	tx_chk = chk;
+	tx_bad = 0;
+	assert_int_equal(RIO_SUCCESS, rio_rt_txn_commit(&in, out));
+	tx_chk = false;
+	assert_int_equal(RIO_ROUTE_NO_NODE, out->fail_node);
+}
+
+// Hardware matches the routing table state, and nothing is left to write.
+static void tx_check_done(struct tx_topo *t)
+{
+	uint32_t s, i;
+
+	for (s = 0; s < t->sw_cnt; s++) {
+		for (i = 0; i < RIO_RT_GRP_SZ; i++) {
+			assert_int_equal(t->rt[s].dom_table[i].rte_val,
+					t->sw[s].dom[i]);
+			assert_int_equal(t->rt[s].dev_table[i].rte_val,
+					t->sw[s].dev_tbl[i]);
+			assert_false(t->rt[s].dom_table[i].changed);
+			assert_false(t->rt[s].dev_table[i].changed);
+		}
+		assert_int_equal(0, t->sw[s].dflt_wr);
+	}
+	assert_int_equal(0, tx_hw_check(t));
+}
+
+static void tx_setup(bool blk)
+{
+	assert_int_equal(RIO_SUCCESS, DAR_proc_ptr_init(tx_rd, tx_wr, tx_wait));
+	assert_int_equal(RIO_SUCCESS,
+			DAR_blk_proc_ptr_init(blk ? tx_wr_blk : NULL));
+	tx_blk_calls = 0;
+	tx_wr_delay_ns = 0;
+}
+
+static void assumptions_test(void **state)
+{
+	assert_int_equal(0xFFFFFFFF, RIO_ROUTE_NO_NODE);
+	assert_true(RIO_RT_TXN_MAX_THREADS >= 1);
+	(void)state; // unused
+}
+
+static void rt_txn_parms_test(void **state)
+{
+	struct tx_topo t;
+	rio_rt_txn_in_t in;
+	rio_rt_txn_out_t out;
+
+	tx_setup(false);
+	tx_ring(&t, 4, 1, tt_dev8, false);
+	memset(&in, 0, sizeof(in));
+	in.tt = tt_dev8;
+	in.node_cnt = t.sw_cnt + t.ep_cnt;
+	in.nodes = t.nodes;
+
+	assert_int_not_equal(RIO_SUCCESS, rio_rt_txn_commit(NULL, &out));
+	assert_int_not_equal(RIO_SUCCESS, rio_rt_txn_commit(&in, NULL));
+
+	in.tt = (tt_t)5;
+	assert_int_not_equal(RIO_SUCCESS, rio_rt_txn_commit(&in, &out));
+	assert_int_equal(RT_TXN(2), out.imp_rc);
+	in.tt = tt_dev8;
+
+	in.nodes = NULL;
+	assert_int_not_equal(RIO_SUCCESS, rio_rt_txn_commit(&in, &out));
+	assert_int_equal(RT_TXN(3), out.imp_rc);
+	in.nodes = t.nodes;
+
+	// A switch with changes must have a device to write
+	tx_compute(&t);
+	t.nodes[1].dev_info = NULL;
+	assert_int_not_equal(RIO_SUCCESS, rio_rt_txn_commit(&in, &out));
+	assert_int_equal(RT_TXN(6), out.imp_rc);
+	assert_int_equal(1, out.fail_node);
+	assert_int_equal(0, out.reg_wr);
+
+	// Nothing was written, so the transaction can be retried
+	t.nodes[1].dev_info = &t.sw[1].dev;
+	tx_commit(&t, 1, false, &out);
+	tx_check_done(&t);
+
+	tx_topo_free(&t);
+	(void)state; // unused
+}
+
+// Initial programming, then adding and removing links, with the hardware
+// routes checked after every register write.
+static void rt_txn_order_test_x(tt_t tt, uint32_t threads)
+{
+	struct tx_topo t;
+	rio_rt_txn_out_t out;
+	uint32_t s;
+
+	tx_setup(false);
+	tx_ring(&t, 8, 2, tt, false);
+
+	tx_compute(&t);
+	tx_commit(&t, threads, false, &out);
+	tx_check_done(&t);
+	assert_int_equal(t.sw_cnt, out.sw_cnt);
+	assert_true(out.rte_cnt > 0);
+	assert_int_equal(out.reg_wr, out.blk_wr);
+	assert_true(out.reg_wr >= out.rte_cnt);
+
+	// Nothing changed, nothing written
+	tx_commit(&t, threads, false, &out);
+	assert_int_equal(0, out.sw_cnt);
+	assert_int_equal(0, out.rte_cnt);
+	assert_int_equal(0, out.phase_cnt);
+	assert_int_equal(0, out.reg_wr);
+
+	// Add the chords.  Routes shorten, and must stay intact throughout.
+	for (s = 0; s < t.sw_cnt / 2; s++) {
+		assert_int_equal(RIO_SUCCESS, rio_route_connect(t.nodes,
+				t.sw_cnt + t.ep_cnt, s, 2, s + t.sw_cnt / 2, 2));
+	}
+	tx_compute(&t);
+	tx_commit(&t, threads, true, &out);
+	assert_int_equal(0, tx_bad);
+	assert_true(out.rte_cnt > 0);
+	assert_true(out.phase_cnt > 1);
+	tx_check_done(&t);
+
+	// Drain the chords before removing them.  Routes lengthen, and
+	// switches must not send packets back the way they came.
+	for (s = 0; s < t.sw_cnt / 2; s++) {
+		tx_disconnect(&t, s, 2);
+	}
+	tx_compute(&t);
+	tx_commit(&t, threads, true, &out);
+	assert_int_equal(0, tx_bad);
+	assert_true(out.rte_cnt > 0);
+	assert_true(out.phase_cnt > 1);
+	tx_check_done(&t);
+
+	tx_topo_free(&t);
+}
+
+static void rt_txn_order_test(void **state)
+{
+	rt_txn_order_test_x(tt_dev8, 1);
+	rt_txn_order_test_x(tt_dev8, 4);
+	rt_txn_order_test_x(tt_dev16, 1);
+	rt_txn_order_test_x(tt_dev16, 4);
+	(void)state; // unused
+}
+
+// Writing every switch in node order, as rio_rt_set_changed on each
+// switch would, drops or loops packets while the chords are drained.
+static void rt_txn_unordered_test(void **state)
+{
+	struct tx_topo t;
+	rio_rt_txn_out_t out;
+	rio_rt_set_changed_in_t chg_in;
+	rio_rt_set_changed_out_t chg_out;
+	uint32_t s;
+
+	tx_setup(false);
+	tx_ring(&t, 8, 2, tt_dev8, true);
+	tx_compute(&t);
+	tx_commit(&t, 1, false, &out);
+	tx_check_done(&t);
+
+	for (s = 0; s < t.sw_cnt / 2; s++) {
+		tx_disconnect(&t, s, 2);
+	}
+	tx_compute(&t);
+
+	tx_cur = &t;
+	tx_chk = true;
+	tx_bad = 0;
+	for (s = 0; s < t.sw_cnt; s++) {
+		chg_in.set_on_port = RIO_ALL_PORTS;
+		chg_in.rt = &t.rt[s];
+		assert_int_equal(RIO_SUCCESS, rio_rt_set_changed(
+				&t.sw[s].dev, &chg_in, &chg_out));
+	}
+	tx_chk = false;
+	assert_true(tx_bad > 0);
+	tx_check_done(&t);
+
+	tx_topo_free(&t);
+	(void)state; // unused
+}
+
+// Consecutive changed entries are written as blocks when a block write
+// routine is bound.
+static void rt_txn_blk_test(void **state)
+{
+	struct tx_topo t;
+	rio_rt_txn_out_t out;
+
+	tx_setup(true);
+	tx_ring(&t, 8, 4, tt_dev8, true);
+	tx_compute(&t);
+	tx_commit(&t, 1, false, &out);
+	tx_check_done(&t);
+	assert_true(out.blk_wr < out.reg_wr);
+	assert_int_equal(out.blk_wr, tx_blk_calls);
+
+	tx_setup(false);
+	tx_topo_free(&t);
+	(void)state; // unused
+}
+
+static void rt_txn_bench(const char *name, struct tx_topo *t,
+		uint32_t threads, bool blk)
+{
+	rio_rt_txn_out_t out;
+	uint32_t s;
+
+	tx_setup(blk);
+	// Model the latency of a maintenance transaction
+	tx_wr_delay_ns = 10000;
+	tx_compute(t);
+	tx_commit(t, threads, false, &out);
+	tx_check_done(t);
+	printf("%-24s %2u threads: %4u switches %6u entries %3u phases "
+			"%7llu regs %7llu accesses %8.2f ms\n",
+			name, threads, out.sw_cnt, out.rte_cnt, out.phase_cnt,
+			(unsigned long long)out.reg_wr,
+			(unsigned long long)out.blk_wr,
+			(double)out.usecs / 1000);
+
+	// Restore the initial state of the hardware for the next run
+	for (s = 0; s < t->sw_cnt; s++) {
+		tx_init_rt(&t->rt[s]);
+		tx_init_sw(&t->sw[s]);
+	}
+	tx_setup(false);
+}
+
+static void rt_txn_bench_test(void **state)
+{
+	struct tx_topo t;
+
+	tx_ring(&t, 32, 4, tt_dev8, true);
+	rt_txn_bench("ring dev8", &t, 1, false);
+	rt_txn_bench("ring dev8", &t, 8, false);
+	rt_txn_bench("ring dev8 blocks", &t, 1, true);
+	rt_txn_bench("ring dev8 blocks", &t, 8, true);
+	tx_topo_free(&t);
+
+	tx_ring(&t, 32, 16, tt_dev16, true);
+	rt_txn_bench("ring dev16", &t, 1, false);
+	rt_txn_bench("ring dev16", &t, 8, false);
+	rt_txn_bench("ring dev16 blocks", &t, 8, true);
+	tx_topo_free(&t);
+	(void)state; // unused
+}
+
+int main(int argc, char** argv)
+{
+	(void)argv; // not used
+	argc++; // not used
+
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(assumptions_test),
+		cmocka_unit_test(rt_txn_parms_test),
+		cmocka_unit_test(rt_txn_order_test),
+		cmocka_unit_test(rt_txn_unordered_test),
+		cmocka_unit_test(rt_txn_blk_test),
+		cmocka_unit_test(rt_txn_bench_test),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
+
+#endif /* RXS_DAR_WANTED */
+
+#ifdef __cplusplus
+}
+#endif
@@ -321,6 +321,74 @@ static void rio_sc_other_if_names_test(void **state)
 	(void)state; // unused
 }
 
+static void rio_sc_accum_ctrs_clr_test(void **state)
+{
+	rio_sc_ctr_val_t ctrs[3] = {INIT_RIO_SC_CTR_VAL, INIT_RIO_SC_CTR_VAL,
+						INIT_RIO_SC_CTR_VAL};
+	rio_sc_ctr_val_t *ctr_p[3] = {&ctrs[0], &ctrs[1], &ctrs[2]};
+	DAR_read_entry_out_t rd_out[3];
+	uint32_t i;
+
+	// Clear on read counters add each value read to the total.
+	for (i = 0; i < 3; i++) {
+		rd_out[i].rc = RIO_SUCCESS;
+		rd_out[i].value_read = 10 * (i + 1);
+	}
+	assert_int_equal(3, rio_sc_accum_ctrs(ctr_p, rd_out, 3, false));
+	assert_int_equal(3, rio_sc_accum_ctrs(ctr_p, rd_out, 3, false));
+	for (i = 0; i < 3; i++) {
+		assert_int_equal(10 * (i + 1), ctrs[i].last_inc);
+		assert_int_equal(20 * (i + 1), ctrs[i].total);
+	}
+
+	// Failed reads leave the counter unchanged, and the index of the
+	// first failure is returned.
+	rd_out[1].rc = 0x55;
+	rd_out[2].rc = 0x66;
+	rd_out[0].value_read = 0xFFFFFFFF;
+	rd_out[1].value_read = 5;
+	assert_int_equal(1, rio_sc_accum_ctrs(ctr_p, rd_out, 3, false));
+	assert_int_equal(0xFFFFFFFF, ctrs[0].last_inc);
+	assert_int_equal(20 + (uint64_t)0xFFFFFFFF, ctrs[0].total);
+	assert_int_equal(20, ctrs[1].last_inc);
+	assert_int_equal(40, ctrs[1].total);
+	assert_int_equal(30, ctrs[2].last_inc);
+	assert_int_equal(60, ctrs[2].total);
+
+	(void)state; // unused
+}
+
+static void rio_sc_accum_ctrs_wrap_test(void **state)
+{
+	rio_sc_ctr_val_t ctrs[2] = {INIT_RIO_SC_CTR_VAL, INIT_RIO_SC_CTR_VAL};
+	rio_sc_ctr_val_t *ctr_p[2] = {&ctrs[0], &ctrs[1]};
+	DAR_read_entry_out_t rd_out[2];
+
+	// Free running counters set the lower 32 bits of the total,
+	// and carry into the upper 32 bits when the counter wraps.
+	ctrs[0].total = 0x1FFFFFFF0;
+	ctrs[1].total = 0x100;
+	rd_out[0].rc = RIO_SUCCESS;
+	rd_out[0].value_read = 0x10;
+	rd_out[1].rc = RIO_SUCCESS;
+	rd_out[1].value_read = 0x180;
+	assert_int_equal(2, rio_sc_accum_ctrs(ctr_p, rd_out, 2, true));
+	assert_int_equal(0x20, ctrs[0].last_inc);
+	assert_int_equal(0x200000010, ctrs[0].total);
+	assert_int_equal(0x80, ctrs[1].last_inc);
+	assert_int_equal(0x180, ctrs[1].total);
+
+	rd_out[0].rc = 0x77;
+	rd_out[1].value_read = 0x180;
+	assert_int_equal(0, rio_sc_accum_ctrs(ctr_p, rd_out, 2, true));
+	assert_int_equal(0x20, ctrs[0].last_inc);
+	assert_int_equal(0x200000010, ctrs[0].total);
+	assert_int_equal(0, ctrs[1].last_inc);
+	assert_int_equal(0x180, ctrs[1].total);
+
+	(void)state; // unused
+}
+
 int main(int argc, char** argv)
 {
 	(void)argv; // not used
@@ -331,7 +399,9 @@ int main(int argc, char** argv)
 		cmocka_unit_test(sc_info_test),
 		cmocka_unit_test(sc_ctr_flag_test),
 		cmocka_unit_test(sc_gen_flag_test),
-		cmocka_unit_test(rio_sc_other_if_names_test)
+		cmocka_unit_test(rio_sc_other_if_names_test),
+		cmocka_unit_test(rio_sc_accum_ctrs_clr_test),
+		cmocka_unit_test(rio_sc_accum_ctrs_wrap_test)
 	};
 
 	return cmocka_run_group_tests(tests, NULL, NULL);
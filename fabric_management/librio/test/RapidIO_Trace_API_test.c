@@ -0,0 +1,746 @@
+/*
+ ************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ l of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this l of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <stdarg.h>
+#include <setjmp.h>
+#include "cmocka.h"
+
+#include "RapidIO_Trace_API.h"
+#include "src/RapidIO_Trace_API.c"
+#include "rio_ecosystem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Records written to the capture, used to compute the expected results */
+typedef struct trace_test_rec_t_TAG {
+	uint64_t ts;
+	uint8_t port;
+	bool is_pkt;
+	bool crc_ok;
+	uint8_t ftype;
+	did_reg_t dest;
+	did_reg_t src;
+	uint16_t len;
+	uint32_t data_bytes;
+	uint8_t stype0;
+	uint8_t stype1;
+} trace_test_rec_t;
+
+#define TRACE_TEST_MAX_RECS 300000
+
+static trace_test_rec_t *recs;
+static uint32_t rec_cnt;
+static char trace_path[] = "/tmp/rio_trace_testXXXXXX";
+
+static uint32_t trace_test_seed = 0x2545f491;
+
+static uint32_t trace_test_rand(void)
+{
+	trace_test_seed ^= trace_test_seed << 13;
+	trace_test_seed ^= trace_test_seed >> 17;
+	trace_test_seed ^= trace_test_seed << 5;
+	return trace_test_seed;
+}
+
+static bool trace_test_pkt(DAR_pkt_bytes_t *bytes, trace_test_rec_t *rec)
+{
+	const DAR_pkt_type types[] = {pkt_nr, pkt_nw, pkt_nwr, pkt_sw,
+			pkt_mr, pkt_mw, pkt_db, pkt_msg, pkt_resp_data,
+			pkt_dstm};
+	const uint32_t sizes[] = {8, 16, 32, 64, 128, 256};
+	DAR_pkt_fields_t fields;
+	uint8_t pkt_data[RIO_MAX_PKT_BYTES];
+
+	memset(&fields, 0, sizeof(fields));
+	memset(pkt_data, 0xa5, sizeof(pkt_data));
+	fields.phys.pkt_prio = trace_test_rand() & 3;
+	fields.trans.tt_code = tt_large;
+	fields.trans.destID = 0x100 + (trace_test_rand() & 7);
+	fields.trans.srcID = 0x200 + (trace_test_rand() & 3);
+	fields.pkt_type = types[trace_test_rand()
+					% (sizeof(types) / sizeof(types[0]))];
+	fields.pkt_bytes = sizes[trace_test_rand()
+					% (sizeof(sizes) / sizeof(sizes[0]))];
+	fields.pkt_data = pkt_data;
+	fields.log_rw.pkt_addr_size = rio_addr_34;
+	switch (fields.pkt_type) {
+	case pkt_mr:
+	case pkt_mw:
+		// Maintenance offsets are always 21 bits
+		fields.log_rw.pkt_addr_size = rio_addr_21;
+		break;
+	case pkt_db:
+		fields.pkt_bytes = 2;
+		break;
+	default:
+		break;
+	}
+	fields.log_rw.addr[0] = trace_test_rand() & ~0xFF;
+	fields.log_rw.tid = trace_test_rand() & 0xFF;
+	fields.log_ds.dstm_end_seg = true;
+	fields.log_ms.msg_len = 1;
+
+	memset(bytes, 0, sizeof(*bytes));
+	bytes->pkt_addr_size = rio_addr_34;
+	if (DAR_pkt_fields_to_bytes(&fields, bytes)) {
+		return false;
+	}
+
+	// Data bytes as counted by the full packet parser
+	memset(&fields, 0, sizeof(fields));
+	fields.pkt_data = pkt_data;
+	assert_int_equal(RIO_SUCCESS, DAR_pkt_bytes_to_fields(bytes, &fields));
+
+	rec->is_pkt = true;
+	rec->crc_ok = true;
+	rec->ftype = bytes->pkt_data[1] & 0xF;
+	rec->dest = fields.trans.destID;
+	rec->src = fields.trans.srcID;
+	rec->len = bytes->num_chars;
+	rec->data_bytes = fields.pkt_bytes;
+
+	if (!(trace_test_rand() % 50)) {
+		bytes->pkt_data[bytes->num_chars - 3] ^= 0x40;
+		rec->crc_ok = false;
+	}
+	return true;
+}
+
+static bool trace_test_cs(CS_bytes_t *bytes, trace_test_rec_t *rec)
+{
+	CS_field_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.cs_size = cs_large;
+	fields.cs_t0 = (stype0)(trace_test_rand() & 7);
+	fields.parm_0 = trace_test_rand() & 0x3F;
+	fields.parm_1 = trace_test_rand() & 0x3F;
+	fields.cs_t1 = (stype1)(trace_test_rand() & 7);
+
+	memset(bytes, 0, sizeof(*bytes));
+	if (CS_fields_to_bytes(&fields, bytes)) {
+		return false;
+	}
+
+	rec->is_pkt = false;
+	rec->crc_ok = true;
+	rec->stype0 = fields.cs_t0;
+	rec->stype1 = fields.cs_t1;
+	return true;
+}
+
+/* Writes a capture of cnt records with the given block size */
+static void trace_test_write(uint32_t cnt, uint32_t blk_size)
+{
+	rio_trace_wr_t wr;
+	DAR_pkt_bytes_t pkt;
+	CS_bytes_t cs;
+	trace_test_rec_t *rec;
+	uint64_t ts = 1000;
+	bool ok;
+
+	assert_int_equal(RIO_SUCCESS,
+		rio_trace_wr_open(&wr, trace_path, blk_size, rio_addr_34));
+
+	rec_cnt = 0;
+	while (rec_cnt < cnt) {
+		rec = &recs[rec_cnt];
+		memset(rec, 0, sizeof(*rec));
+		ts += 1 + (trace_test_rand() % 100);
+		rec->ts = ts;
+		rec->port = trace_test_rand() & 3;
+		if (trace_test_rand() & 3) {
+			ok = trace_test_pkt(&pkt, rec);
+			if (ok) {
+				assert_int_equal(RIO_SUCCESS, rio_trace_wr_pkt(
+						&wr, ts, rec->port, &pkt));
+			}
+		} else {
+			ok = trace_test_cs(&cs, rec);
+			if (ok) {
+				assert_int_equal(RIO_SUCCESS, rio_trace_wr_cs(
+						&wr, ts, rec->port, &cs));
+			}
+		}
+		if (ok) {
+			rec_cnt++;
+		}
+	}
+	assert_int_equal(rec_cnt, wr.rec_cnt);
+	assert_int_equal(RIO_SUCCESS, rio_trace_wr_close(&wr));
+}
+
+static bool trace_test_sel(trace_test_rec_t *rec, rio_trace_filter_t *filt)
+{
+	if (NULL == filt) {
+		return true;
+	}
+	if ((rec->ts < filt->ts_min) || (filt->ts_max
+						&& (rec->ts > filt->ts_max))) {
+		return false;
+	}
+	if (filt->port_mask && !((1 << rec->port) & filt->port_mask)) {
+		return false;
+	}
+	if (((rio_trace_crc_ok == filt->crc) && !rec->crc_ok)
+		|| ((rio_trace_crc_bad == filt->crc) && rec->crc_ok)) {
+		return false;
+	}
+	if (!rec->is_pkt) {
+		return !filt->ftype_mask && !filt->dest_en && !filt->src_en
+				&& !filt->no_cs;
+	}
+	if (filt->ftype_mask && !((1 << rec->ftype) & filt->ftype_mask)) {
+		return false;
+	}
+	if ((filt->dest_en && (rec->dest != filt->dest))
+			|| (filt->src_en && (rec->src != filt->src))) {
+		return false;
+	}
+	return true;
+}
+
+/* Scans the capture and checks the aggregates against the records */
+static void trace_test_scan_chk(rio_trace_filter_t *filt,
+		rio_trace_grp_t grp, uint32_t thread_cnt)
+{
+	rio_trace_t trace;
+	rio_trace_scan_in_t in_parms;
+	rio_trace_scan_out_t out_parms;
+	rio_trace_agg_t exp;
+	uint64_t *grp_pkts, *grp_wire, *grp_data;
+	trace_test_rec_t *rec;
+	uint32_t i, key;
+
+	memset(&exp, 0, sizeof(exp));
+	grp_pkts = (uint64_t *)calloc(RIO_TRACE_GRP_KEYS, sizeof(uint64_t));
+	grp_wire = (uint64_t *)calloc(RIO_TRACE_GRP_KEYS, sizeof(uint64_t));
+	grp_data = (uint64_t *)calloc(RIO_TRACE_GRP_KEYS, sizeof(uint64_t));
+	assert_non_null(grp_pkts);
+	assert_non_null(grp_wire);
+	assert_non_null(grp_data);
+
+	for (i = 0; i < rec_cnt; i++) {
+		rec = &recs[i];
+		if (!trace_test_sel(rec, filt)) {
+			continue;
+		}
+		if (!exp.ts_first) {
+			exp.ts_first = rec->ts;
+		}
+		exp.ts_last = rec->ts;
+		if (!rec->crc_ok) {
+			exp.crc_errs++;
+		}
+		if (!rec->is_pkt) {
+			exp.cs++;
+			exp.stype0[rec->stype0]++;
+			exp.stype1[rec->stype1]++;
+			continue;
+		}
+		exp.pkts++;
+		exp.ftype[rec->ftype]++;
+		exp.wire_bytes += rec->len;
+		exp.data_bytes += rec->data_bytes;
+		switch (grp) {
+		case rio_trace_grp_dest:
+			key = rec->dest;
+			break;
+		case rio_trace_grp_src:
+			key = rec->src;
+			break;
+		case rio_trace_grp_ftype:
+			key = rec->ftype;
+			break;
+		default:
+			key = rec->port;
+			break;
+		}
+		grp_pkts[key]++;
+		grp_wire[key] += rec->len;
+		grp_data[key] += rec->data_bytes;
+	}
+
+	assert_int_equal(RIO_SUCCESS, rio_trace_open(&trace, trace_path));
+	memset(&in_parms, 0, sizeof(in_parms));
+	in_parms.trace = &trace;
+	in_parms.filter = filt;
+	in_parms.grp = grp;
+	in_parms.thread_cnt = thread_cnt;
+	assert_int_equal(RIO_SUCCESS, rio_trace_scan(&in_parms, &out_parms));
+	rio_trace_close(&trace);
+
+	assert_int_equal(RIO_SUCCESS, out_parms.imp_rc);
+	assert_int_equal(rec_cnt, out_parms.agg.recs);
+	assert_int_equal(0, out_parms.agg.decode_errs);
+	assert_int_equal(exp.pkts, out_parms.agg.pkts);
+	assert_int_equal(exp.cs, out_parms.agg.cs);
+	assert_int_equal(exp.wire_bytes, out_parms.agg.wire_bytes);
+	assert_int_equal(exp.data_bytes, out_parms.agg.data_bytes);
+	assert_int_equal(exp.crc_errs, out_parms.agg.crc_errs);
+	assert_int_equal(exp.ts_first, out_parms.agg.ts_first);
+	assert_int_equal(exp.ts_last, out_parms.agg.ts_last);
+	assert_memory_equal(exp.ftype, out_parms.agg.ftype, sizeof(exp.ftype));
+	assert_memory_equal(exp.stype0, out_parms.agg.stype0,
+							sizeof(exp.stype0));
+	assert_memory_equal(exp.stype1, out_parms.agg.stype1,
+							sizeof(exp.stype1));
+
+	assert_int_equal(grp, out_parms.agg.grp);
+	if (rio_trace_grp_none == grp) {
+		assert_null(out_parms.agg.grp_pkts);
+	} else {
+		assert_memory_equal(grp_pkts, out_parms.agg.grp_pkts,
+				RIO_TRACE_GRP_KEYS * sizeof(uint64_t));
+		assert_memory_equal(grp_wire, out_parms.agg.grp_wire,
+				RIO_TRACE_GRP_KEYS * sizeof(uint64_t));
+		assert_memory_equal(grp_data, out_parms.agg.grp_data,
+				RIO_TRACE_GRP_KEYS * sizeof(uint64_t));
+	}
+
+	rio_trace_agg_free(&out_parms.agg);
+	assert_null(out_parms.agg.grp_pkts);
+	free(grp_pkts);
+	free(grp_wire);
+	free(grp_data);
+}
+
+static int trace_test_setup(void **state)
+{
+	int fd;
+
+	recs = (trace_test_rec_t *)calloc(TRACE_TEST_MAX_RECS, sizeof(*recs));
+	if (NULL == recs) {
+		return -1;
+	}
+	fd = mkstemp(trace_path);
+	if (fd < 0) {
+		return -1;
+	}
+	close(fd);
+
+	(void)state; // unused
+	return 0;
+}
+
+static int trace_test_teardown(void **state)
+{
+	unlink(trace_path);
+	free(recs);
+
+	(void)state; // unused
+	return 0;
+}
+
+static void assumptions(void **state)
+{
+	assert_int_equal(32, sizeof(rio_trace_file_hdr_t));
+	assert_int_equal(16, sizeof(rio_trace_rec_hdr_t));
+	assert_int_equal(16, RIO_TRACE_REC_SIZE(0));
+	assert_int_equal(24, RIO_TRACE_REC_SIZE(1));
+	assert_int_equal(24, RIO_TRACE_REC_SIZE(8));
+	assert_int_equal(16 + 280, RIO_TRACE_REC_SIZE(RIO_MAX_PKT_BYTES));
+	assert_true(RIO_TRACE_BATCH_SZ <= 0x10000);
+
+	(void)state; // unused
+}
+
+static void rio_trace_wr_parms_test(void **state)
+{
+	rio_trace_wr_t wr;
+	DAR_pkt_bytes_t pkt;
+	CS_bytes_t cs;
+
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			rio_trace_wr_open(NULL, trace_path, 0, rio_addr_34));
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			rio_trace_wr_open(&wr, NULL, 0, rio_addr_34));
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_wr_open(&wr, trace_path, 0x800, rio_addr_34));
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_wr_open(&wr, trace_path, 0x1800,
+								rio_addr_34));
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_wr_open(&wr, trace_path, 0,
+					(rio_addr_size)(rio_addr_66 + 1)));
+	assert_int_equal(RIO_ERR_ACCESS,
+			rio_trace_wr_open(&wr, "/nonexistent/dir/trace", 0,
+								rio_addr_34));
+
+	assert_int_equal(RIO_SUCCESS,
+			rio_trace_wr_open(&wr, trace_path, 0, rio_addr_34));
+	assert_int_equal(RIO_TRACE_DFLT_BLK_SIZE, wr.blk_size);
+
+	memset(&pkt, 0, sizeof(pkt));
+	memset(&cs, 0, sizeof(cs));
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			rio_trace_wr_pkt(NULL, 0, 0, &pkt));
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			rio_trace_wr_pkt(&wr, 0, 0, NULL));
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_wr_pkt(&wr, 0, 0, &pkt));
+	pkt.num_chars = RIO_MAX_PKT_BYTES + 1;
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_wr_pkt(&wr, 0, 0, &pkt));
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			rio_trace_wr_cs(&wr, 0, 0, NULL));
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_wr_cs(&wr, 0, 0, &cs));
+	assert_int_equal(0, wr.rec_cnt);
+
+	assert_int_equal(RIO_SUCCESS, rio_trace_wr_close(&wr));
+	assert_int_equal(RIO_SUCCESS, rio_trace_wr_close(&wr));
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_wr_cs(&wr, 0, 0, &cs));
+
+	(void)state; // unused
+}
+
+static void rio_trace_open_test(void **state)
+{
+	rio_trace_t trace;
+	rio_trace_file_hdr_t hdr;
+	rio_trace_scan_in_t in_parms;
+	rio_trace_scan_out_t out_parms;
+	FILE *fp;
+
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			rio_trace_open(NULL, trace_path));
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR, rio_trace_open(&trace, NULL));
+	assert_int_equal(RIO_ERR_ACCESS,
+			rio_trace_open(&trace, "/nonexistent/dir/trace"));
+
+	// Too short for the file header
+	fp = fopen(trace_path, "wb");
+	assert_non_null(fp);
+	fclose(fp);
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_open(&trace, trace_path));
+
+	// Bad magic, version and block size
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, RIO_TRACE_MAGIC, RIO_TRACE_MAGIC_LEN);
+	hdr.version = RIO_TRACE_VERSION + 1;
+	hdr.blk_size = RIO_TRACE_MIN_BLK_SIZE;
+	fp = fopen(trace_path, "wb");
+	assert_non_null(fp);
+	assert_int_equal(sizeof(hdr), fwrite(&hdr, 1, sizeof(hdr), fp));
+	fclose(fp);
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_open(&trace, trace_path));
+
+	hdr.version = RIO_TRACE_VERSION;
+	hdr.blk_size = RIO_TRACE_MIN_BLK_SIZE + 8;
+	fp = fopen(trace_path, "wb");
+	assert_non_null(fp);
+	assert_int_equal(sizeof(hdr), fwrite(&hdr, 1, sizeof(hdr), fp));
+	fclose(fp);
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_open(&trace, trace_path));
+
+	// An empty capture
+	hdr.blk_size = RIO_TRACE_MIN_BLK_SIZE;
+	hdr.addr_size = rio_addr_50;
+	fp = fopen(trace_path, "wb");
+	assert_non_null(fp);
+	assert_int_equal(sizeof(hdr), fwrite(&hdr, 1, sizeof(hdr), fp));
+	fclose(fp);
+	assert_int_equal(RIO_SUCCESS, rio_trace_open(&trace, trace_path));
+	assert_int_equal(1, trace.blk_cnt);
+	assert_int_equal(rio_addr_50, trace.addr_size);
+
+	memset(&in_parms, 0, sizeof(in_parms));
+	in_parms.trace = &trace;
+	in_parms.grp = rio_trace_grp_dest;
+	assert_int_equal(RIO_SUCCESS, rio_trace_scan(&in_parms, &out_parms));
+	assert_int_equal(0, out_parms.agg.recs);
+	assert_int_equal(0, out_parms.agg.ts_first);
+	assert_non_null(out_parms.agg.grp_pkts);
+	rio_trace_agg_free(&out_parms.agg);
+
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			rio_trace_scan(NULL, &out_parms));
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			rio_trace_scan(&in_parms, NULL));
+	in_parms.grp = (rio_trace_grp_t)(rio_trace_grp_port + 1);
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_scan(&in_parms, &out_parms));
+	assert_int_equal(RIO_TRACE(1), out_parms.imp_rc);
+
+	rio_trace_close(&trace);
+	assert_null(trace.base);
+	rio_trace_close(&trace);
+
+	in_parms.grp = rio_trace_grp_none;
+	assert_int_equal(RIO_ERR_INVALID_PARAMETER,
+			rio_trace_scan(&in_parms, &out_parms));
+
+	(void)state; // unused
+}
+
+/* Every record written is decoded once, whatever the number of threads */
+static void rio_trace_scan_test(void **state)
+{
+	const uint32_t threads[] = {1, 2, 4, 0};
+	uint32_t t;
+
+	trace_test_write(20000, RIO_TRACE_MIN_BLK_SIZE);
+
+	for (t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+		trace_test_scan_chk(NULL, rio_trace_grp_none, threads[t]);
+		trace_test_scan_chk(NULL, rio_trace_grp_dest, threads[t]);
+		trace_test_scan_chk(NULL, rio_trace_grp_src, threads[t]);
+		trace_test_scan_chk(NULL, rio_trace_grp_ftype, threads[t]);
+		trace_test_scan_chk(NULL, rio_trace_grp_port, threads[t]);
+	}
+
+	(void)state; // unused
+}
+
+static void rio_trace_filter_test(void **state)
+{
+	rio_trace_filter_t filt;
+	uint32_t t;
+
+	trace_test_write(20000, RIO_TRACE_MIN_BLK_SIZE * 2);
+
+	for (t = 1; t <= 4; t += 3) {
+		memset(&filt, 0, sizeof(filt));
+		trace_test_scan_chk(&filt, rio_trace_grp_dest, t);
+
+		filt.dest_en = true;
+		filt.dest = 0x103;
+		trace_test_scan_chk(&filt, rio_trace_grp_src, t);
+
+		filt.src_en = true;
+		filt.src = 0x201;
+		trace_test_scan_chk(&filt, rio_trace_grp_dest, t);
+
+		memset(&filt, 0, sizeof(filt));
+		filt.ftype_mask = (1 << 5) | (1 << 8);
+		trace_test_scan_chk(&filt, rio_trace_grp_ftype, t);
+
+		memset(&filt, 0, sizeof(filt));
+		filt.crc = rio_trace_crc_bad;
+		trace_test_scan_chk(&filt, rio_trace_grp_port, t);
+		filt.crc = rio_trace_crc_ok;
+		trace_test_scan_chk(&filt, rio_trace_grp_port, t);
+
+		memset(&filt, 0, sizeof(filt));
+		filt.port_mask = 0x5;
+		trace_test_scan_chk(&filt, rio_trace_grp_port, t);
+		filt.no_cs = true;
+		trace_test_scan_chk(&filt, rio_trace_grp_port, t);
+
+		memset(&filt, 0, sizeof(filt));
+		filt.ts_min = recs[rec_cnt / 4].ts;
+		filt.ts_max = recs[rec_cnt / 2].ts;
+		trace_test_scan_chk(&filt, rio_trace_grp_dest, t);
+
+		filt.ts_min = recs[rec_cnt - 1].ts + 1;
+		filt.ts_max = 0;
+		trace_test_scan_chk(&filt, rio_trace_grp_none, t);
+	}
+
+	(void)state; // unused
+}
+
+typedef struct trace_test_list_t_TAG {
+	uint32_t pkts;
+	uint32_t cs;
+	uint64_t last_ts;
+	uint64_t last_off;
+	bool in_order;
+} trace_test_list_t;
+
+static void trace_test_list_fn(rio_trace_batch_t *batch, void *arg)
+{
+	trace_test_list_t *list = (trace_test_list_t *)arg;
+	uint32_t i;
+	uint16_t r;
+
+	for (i = 0; i < batch->pkt_sel_cnt; i++) {
+		r = batch->pkt_sel[i];
+		if ((batch->pkt_ts[r] <= list->last_ts)
+				|| (batch->pkt_off[r] <= list->last_off)
+				|| !(batch->pkt_flags[r]
+					& RIO_TRACE_F_DECODE_OK)) {
+			list->in_order = false;
+		}
+		list->last_ts = batch->pkt_ts[r];
+		list->last_off = batch->pkt_off[r];
+	}
+	list->pkts += batch->pkt_sel_cnt;
+	list->cs += batch->cs_sel_cnt;
+}
+
+/* Batches are passed in file order with one thread, and each record is
+ * passed once with several threads.
+ */
+static void rio_trace_batch_fn_test(void **state)
+{
+	rio_trace_t trace;
+	rio_trace_scan_in_t in_parms;
+	rio_trace_scan_out_t out_parms;
+	trace_test_list_t list;
+	uint32_t t;
+
+	trace_test_write(10000, RIO_TRACE_MIN_BLK_SIZE);
+	assert_int_equal(RIO_SUCCESS, rio_trace_open(&trace, trace_path));
+
+	for (t = 1; t <= 4; t += 3) {
+		memset(&list, 0, sizeof(list));
+		list.in_order = true;
+		memset(&in_parms, 0, sizeof(in_parms));
+		in_parms.trace = &trace;
+		in_parms.thread_cnt = t;
+		in_parms.batch_fn = trace_test_list_fn;
+		in_parms.batch_arg = &list;
+		assert_int_equal(RIO_SUCCESS,
+				rio_trace_scan(&in_parms, &out_parms));
+
+		assert_int_equal(out_parms.agg.pkts, list.pkts);
+		assert_int_equal(out_parms.agg.cs, list.cs);
+		assert_int_equal(rec_cnt, list.pkts + list.cs);
+		if (1 == t) {
+			assert_true(list.in_order);
+		}
+		rio_trace_agg_free(&out_parms.agg);
+	}
+
+	rio_trace_close(&trace);
+
+	(void)state; // unused
+}
+
+/* A capture cut short in the middle of a record loses only that record */
+static void rio_trace_truncated_test(void **state)
+{
+	rio_trace_t trace;
+	rio_trace_scan_in_t in_parms;
+	rio_trace_scan_out_t out_parms;
+	rio_trace_rec_hdr_t hdr;
+	uint64_t off, last_off = 0;
+
+	trace_test_write(2000, RIO_TRACE_MIN_BLK_SIZE);
+
+	// Find the start of the last record
+	assert_int_equal(RIO_SUCCESS, rio_trace_open(&trace, trace_path));
+	off = (trace.blk_cnt - 1) * trace.blk_size;
+	if (!off) {
+		off = sizeof(rio_trace_file_hdr_t);
+	}
+	while (off + sizeof(hdr) <= trace.size) {
+		memcpy(&hdr, trace.base + off, sizeof(hdr));
+		last_off = off;
+		off += RIO_TRACE_REC_SIZE(hdr.len);
+	}
+	rio_trace_close(&trace);
+	assert_int_equal(0, truncate(trace_path, last_off + sizeof(hdr) + 1));
+
+	assert_int_equal(RIO_SUCCESS, rio_trace_open(&trace, trace_path));
+	memset(&in_parms, 0, sizeof(in_parms));
+	in_parms.trace = &trace;
+	in_parms.thread_cnt = 1;
+	assert_int_equal(RIO_SUCCESS, rio_trace_scan(&in_parms, &out_parms));
+	rio_trace_close(&trace);
+
+	assert_int_equal(rec_cnt, out_parms.agg.recs);
+	assert_int_equal(1, out_parms.agg.decode_errs);
+	assert_int_equal(rec_cnt - 1, out_parms.agg.pkts + out_parms.agg.cs);
+	rio_trace_agg_free(&out_parms.agg);
+
+	(void)state; // unused
+}
+
+/* Reports decode rates for a larger capture */
+static void rio_trace_scan_rate_test(void **state)
+{
+	rio_trace_t trace;
+	rio_trace_scan_in_t in_parms;
+	rio_trace_scan_out_t out_parms;
+	const uint32_t threads[] = {1, 0};
+	uint32_t t;
+
+	trace_test_write(TRACE_TEST_MAX_RECS, 0);
+	assert_int_equal(RIO_SUCCESS, rio_trace_open(&trace, trace_path));
+
+	for (t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+		memset(&in_parms, 0, sizeof(in_parms));
+		in_parms.trace = &trace;
+		in_parms.grp = rio_trace_grp_dest;
+		in_parms.thread_cnt = threads[t];
+		assert_int_equal(RIO_SUCCESS,
+				rio_trace_scan(&in_parms, &out_parms));
+		assert_int_equal(rec_cnt, out_parms.agg.recs);
+		printf("threads %u: %u records, %llu bytes in %llu usecs\n",
+			threads[t], rec_cnt, (unsigned long long)trace.size,
+			(unsigned long long)out_parms.usecs);
+		rio_trace_agg_free(&out_parms.agg);
+	}
+
+	rio_trace_close(&trace);
+
+	(void)state; // unused
+}
+
+int main(int argc, char** argv)
+{
+	(void)argv; // not used
+	argc++; // not used
+
+	const struct CMUnitTest tests[] = {
+	cmocka_unit_test(assumptions),
+	cmocka_unit_test(rio_trace_wr_parms_test),
+	cmocka_unit_test(rio_trace_open_test),
+	cmocka_unit_test(rio_trace_scan_test),
+	cmocka_unit_test(rio_trace_filter_test),
+	cmocka_unit_test(rio_trace_batch_fn_test),
+	cmocka_unit_test(rio_trace_truncated_test),
+	cmocka_unit_test(rio_trace_scan_rate_test),
+	};
+	return cmocka_run_group_tests(tests, trace_test_setup,
+			trace_test_teardown);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -35,6 +35,7 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
+#include <time.h>
 
 #include <stdarg.h>
 #include <setjmp.h>
@@ -3607,6 +3608,160 @@ static void count_bits_test(void **state)
 }
 
 
+static uint32_t crc_test_rand_state = 0x12345678;
+
+static uint32_t crc_test_rand(void)
+{
+	// xorshift32, so the tests are repeatable
+	crc_test_rand_state ^= crc_test_rand_state << 13;
+	crc_test_rand_state ^= crc_test_rand_state >> 17;
+	crc_test_rand_state ^= crc_test_rand_state << 5;
+	return crc_test_rand_state;
+}
+
+static void compute_13bit_crc_table_test(void **state)
+{
+	uint32_t i, ms, ls;
+
+	// Every single bit, then random values
+	for (i = 0; i < 32; i++) {
+		ms = 0x80000000 >> i;
+		assert_int_equal(compute_13bit_crc_bitwise(ms, 0),
+						compute_13bit_crc(ms, 0));
+	}
+	for (i = 0; i < 8; i++) {
+		ls = i << 29;
+		assert_int_equal(compute_13bit_crc_bitwise(0, ls),
+						compute_13bit_crc(0, ls));
+	}
+
+	for (i = 0; i < 100000; i++) {
+		ms = crc_test_rand();
+		ls = crc_test_rand();
+		assert_int_equal(compute_13bit_crc_bitwise(ms, ls),
+						compute_13bit_crc(ms, ls));
+	}
+
+	(void)state; // unused
+}
+
+static void compute_5bit_crc_table_test(void **state)
+{
+	uint32_t i, val;
+
+	// All 24 bit values used by the reference implementation
+	for (i = 0; i < 0x1000000; i += 7) {
+		assert_int_equal(compute_5bit_crc_bitwise(i),
+						compute_5bit_crc(i));
+	}
+
+	for (i = 0; i < 100000; i++) {
+		val = crc_test_rand();
+		assert_int_equal(compute_5bit_crc_bitwise(val),
+						compute_5bit_crc(val));
+	}
+
+	(void)state; // unused
+}
+
+static void crc_comp_bytewise_table_test(void **state)
+{
+	uint8_t pkt[RIO_MAX_PKT_BYTES];
+	int i, len;
+
+	// Every byte value in the first slice
+	for (i = 0; i < 256; i++) {
+		pkt[0] = (uint8_t)i;
+		assert_int_equal(crc_comp_bitwise(0xFFFF, pkt, 1),
+						crc_comp_bytewise(pkt, 1));
+	}
+
+	for (i = 0; i < 2000; i++) {
+		for (len = 0; len < RIO_MAX_PKT_BYTES; len++) {
+			pkt[len] = (uint8_t)crc_test_rand();
+		}
+		len = i % (RIO_MAX_PKT_BYTES + 1);
+		assert_int_equal(crc_comp_bitwise(0xFFFF, pkt, len),
+						crc_comp_bytewise(pkt, len));
+	}
+
+	(void)state; // unused
+}
+
+static double crc_bench_secs(struct timespec *st)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (double)(end.tv_sec - st->tv_sec)
+				+ (double)(end.tv_nsec - st->tv_nsec) / 1e9;
+}
+
+#define CRC_BENCH_CS 200000
+#define CRC_BENCH_PKTS 20000
+
+static void crc_bench_test(void **state)
+{
+	static uint32_t cs[CRC_BENCH_CS];
+	static uint8_t pkt[RIO_MAX_PKT_BYTES];
+	struct timespec st;
+	volatile int sink = 0;
+	double ref, tbl;
+	uint32_t i;
+
+	for (i = 0; i < CRC_BENCH_CS; i++) {
+		cs[i] = crc_test_rand();
+	}
+	for (i = 0; i < RIO_MAX_PKT_BYTES; i++) {
+		pkt[i] = (uint8_t)crc_test_rand();
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	for (i = 0; i < CRC_BENCH_CS; i++) {
+		sink ^= compute_13bit_crc_bitwise(cs[i], cs[i] << 3);
+	}
+	ref = crc_bench_secs(&st);
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	for (i = 0; i < CRC_BENCH_CS; i++) {
+		sink ^= compute_13bit_crc(cs[i], cs[i] << 3);
+	}
+	tbl = crc_bench_secs(&st);
+	printf("13 bit CRC: %8.1f Msym/s bitwise %8.1f Msym/s table\n",
+			CRC_BENCH_CS / ref / 1e6, CRC_BENCH_CS / tbl / 1e6);
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	for (i = 0; i < CRC_BENCH_CS; i++) {
+		sink ^= compute_5bit_crc_bitwise(cs[i]);
+	}
+	ref = crc_bench_secs(&st);
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	for (i = 0; i < CRC_BENCH_CS; i++) {
+		sink ^= compute_5bit_crc(cs[i]);
+	}
+	tbl = crc_bench_secs(&st);
+	printf(" 5 bit CRC: %8.1f Msym/s bitwise %8.1f Msym/s table\n",
+			CRC_BENCH_CS / ref / 1e6, CRC_BENCH_CS / tbl / 1e6);
+
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	for (i = 0; i < CRC_BENCH_PKTS / 100; i++) {
+		pkt[0] = (uint8_t)i;
+		sink ^= crc_comp_bitwise(0xFFFF, pkt, RIO_MAX_PKT_BYTES);
+	}
+	ref = crc_bench_secs(&st) * 100;
+	clock_gettime(CLOCK_MONOTONIC, &st);
+	for (i = 0; i < CRC_BENCH_PKTS; i++) {
+		pkt[0] = (uint8_t)i;
+		sink ^= crc_comp_bytewise(pkt, RIO_MAX_PKT_BYTES);
+	}
+	tbl = crc_bench_secs(&st);
+	printf("Packet CRC: %8.1f MB/s   bitwise %8.1f MB/s   table\n",
+		(double)CRC_BENCH_PKTS * RIO_MAX_PKT_BYTES / ref / 1e6,
+		(double)CRC_BENCH_PKTS * RIO_MAX_PKT_BYTES / tbl / 1e6);
+
+	(void)sink;
+	(void)state; // unused
+}
+
 int main(int argc, char** argv)
 {
 	(void)argv; // not used
@@ -3674,6 +3829,10 @@ int main(int argc, char** argv)
 	cmocka_unit_test(DAR_addr_size_addr_size_50_roundtrip_test),
 	cmocka_unit_test(DAR_addr_size_addr_size_66_roundtrip_test),
 	cmocka_unit_test(count_bits_test),
+	cmocka_unit_test(compute_13bit_crc_table_test),
+	cmocka_unit_test(compute_5bit_crc_table_test),
+	cmocka_unit_test(crc_comp_bytewise_table_test),
+	cmocka_unit_test(crc_bench_test),
 	};
 	return cmocka_run_group_tests(tests, NULL, NULL);
 }
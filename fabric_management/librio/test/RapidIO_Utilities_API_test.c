@@ -2422,6 +2422,178 @@ static void DAR_pkt_bytes_to_fields_ftype_raw_pkt_type_test(void **state)
 	(void)state; // unused
 }
 
+static void DAR_pkt_summary_chk(DAR_pkt_bytes_t *bytes_in)
+{
+	DAR_pkt_fields_t fields;
+	DAR_pkt_summary_t summ;
+	uint8_t pkt_data[RIO_MAX_PKT_BYTES];
+	uint32_t f_rc, s_rc;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.pkt_data = pkt_data;
+
+	f_rc = DAR_pkt_bytes_to_fields(bytes_in, &fields);
+	s_rc = DAR_pkt_bytes_to_summary(bytes_in->pkt_data,
+			bytes_in->num_chars, bytes_in->pkt_addr_size,
+			bytes_in->pkt_has_crc, &summ);
+	assert_int_equal(f_rc, s_rc);
+	if (RIO_SUCCESS != f_rc) {
+		return;
+	}
+
+	assert_int_equal(fields.pkt_type, summ.pkt_type);
+	assert_int_equal(fields.trans.tt_code, summ.tt_code);
+	assert_int_equal(bytes_in->pkt_data[1] & 0xF, summ.ftype);
+	assert_int_equal(fields.phys.pkt_prio, summ.prio);
+	assert_int_equal(fields.trans.destID, summ.destID);
+	assert_int_equal(fields.trans.srcID, summ.srcID);
+	assert_int_equal(fields.pkt_bytes, summ.pkt_bytes);
+
+	switch (fields.pkt_type) {
+	case pkt_nr:
+	case pkt_nr_inc:
+	case pkt_nr_dec:
+	case pkt_nr_set:
+	case pkt_nr_clr:
+	case pkt_nw:
+	case pkt_nwr:
+	case pkt_nw_swap:
+	case pkt_nw_cmp_swap:
+	case pkt_nw_tst_swap:
+	case pkt_mr:
+	case pkt_mw:
+	case pkt_mrr:
+	case pkt_mwr:
+	case pkt_pw:
+		assert_int_equal(fields.log_rw.tid, summ.tid);
+		// Fall through
+	case pkt_sw:
+		assert_int_equal(((uint64_t)fields.log_rw.addr[1] << 32)
+				| fields.log_rw.addr[0], summ.addr);
+		assert_int_equal(fields.log_rw.addr[2], summ.addr_msbs);
+		break;
+	case pkt_resp:
+	case pkt_resp_data:
+		assert_int_equal(fields.log_rw.tid, summ.tid);
+		break;
+	default:
+		break;
+	}
+}
+
+static uint32_t summ_test_seed = 0x1d872b41;
+
+static uint32_t summ_test_rand(void)
+{
+	summ_test_seed ^= summ_test_seed << 13;
+	summ_test_seed ^= summ_test_seed >> 17;
+	summ_test_seed ^= summ_test_seed << 5;
+	return summ_test_seed;
+}
+
+static void DAR_pkt_bytes_to_summary_test(void **state)
+{
+	const DAR_pkt_type types[] = {pkt_nr, pkt_nr_inc, pkt_nw, pkt_nwr,
+			pkt_nw_swap, pkt_sw, pkt_fc, pkt_mr, pkt_mw, pkt_mrr,
+			pkt_mwr, pkt_pw, pkt_dstm, pkt_db, pkt_msg, pkt_resp,
+			pkt_resp_data, pkt_msg_resp};
+	const uint32_t sizes[] = {1, 2, 4, 8, 16, 32, 64, 80, 128, 256};
+	DAR_pkt_fields_t fields_in;
+	DAR_pkt_bytes_t bytes;
+	uint8_t pkt_data[RIO_MAX_PKT_BYTES];
+	uint32_t t, s, a, tt, i, rc;
+	DAR_pkt_summary_t summ;
+
+	memset(pkt_data, 0x5a, sizeof(pkt_data));
+
+	// Packets composed by DAR_pkt_fields_to_bytes
+	for (t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+		for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+			for (a = rio_addr_21; a <= rio_addr_66; a++) {
+				for (tt = tt_small; tt <= tt_large; tt++) {
+					memset(&fields_in, 0, sizeof(fields_in));
+					fields_in.phys.pkt_prio = s & 3;
+					fields_in.trans.tt_code = (rio_TT_code)tt;
+					fields_in.trans.destID = tt ? 0xcafe : 0xca;
+					fields_in.trans.srcID = tt ? 0xbabe : 0xba;
+					fields_in.pkt_type = types[t];
+					fields_in.pkt_bytes = sizes[s];
+					fields_in.pkt_data = pkt_data;
+					fields_in.log_rw.pkt_addr_size =
+							(rio_addr_size)a;
+					fields_in.log_rw.addr[0] = 0x12345678
+								& ~7;
+					fields_in.log_rw.addr[1] = (a ==
+						rio_addr_34) ? 2 : 0x1234;
+					fields_in.log_rw.addr[2] = (a ==
+						rio_addr_66) ? 3 : 0;
+					fields_in.log_rw.tid = t + s;
+					fields_in.log_ds.dstm_xh_seg =
+								(s & 1);
+					fields_in.log_ds.dstm_end_seg = true;
+					fields_in.log_ms.msg_len = 1;
+					fields_in.log_ms.letter = 1;
+
+					memset(&bytes, 0, sizeof(bytes));
+					bytes.pkt_addr_size = (rio_addr_size)a;
+					if (DAR_pkt_fields_to_bytes(&fields_in,
+							&bytes)) {
+						continue;
+					}
+					DAR_pkt_summary_chk(&bytes);
+
+					rc = DAR_pkt_bytes_to_summary(
+						bytes.pkt_data, bytes.num_chars,
+						bytes.pkt_addr_size, true,
+						&summ);
+					assert_true(summ.crc_ok);
+
+					bytes.pkt_data[bytes.num_chars / 2]
+									^= 0x10;
+					rc = DAR_pkt_bytes_to_summary(
+						bytes.pkt_data, bytes.num_chars,
+						bytes.pkt_addr_size, true,
+						&summ);
+					assert_false(summ.crc_ok);
+					(void)rc;
+				}
+			}
+		}
+	}
+
+	// Arbitrary bytes must be rejected, or parsed, as
+	// DAR_pkt_bytes_to_fields does.
+	for (i = 0; i < 200000; i++) {
+		memset(&bytes, 0, sizeof(bytes));
+		bytes.num_chars = 8 + (summ_test_rand() % 80);
+		if (!(i & 7)) {
+			bytes.num_chars = 8 + (summ_test_rand()
+						% (RIO_MAX_PKT_BYTES - 7));
+		}
+		for (s = 0; s < bytes.num_chars; s++) {
+			bytes.pkt_data[s] = (uint8_t)summ_test_rand();
+		}
+		if (i & 1) {
+			bytes.pkt_data[bytes.num_chars - 1] = 0;
+			bytes.pkt_data[bytes.num_chars - 2] = 0;
+		}
+		bytes.pkt_data[1] &= 0xDF;
+		bytes.pkt_addr_size = (rio_addr_size)((i >> 1) % 5);
+		bytes.pkt_has_crc = (i & 2) ? true : false;
+		DAR_pkt_summary_chk(&bytes);
+	}
+
+	// Lengths outside the packet size limits
+	memset(&bytes, 0, sizeof(bytes));
+	assert_int_equal(DAR_UTIL_BAD_DATA_SIZE, DAR_pkt_bytes_to_summary(
+			bytes.pkt_data, 7, rio_addr_32, true, &summ));
+	assert_int_equal(DAR_UTIL_BAD_DATA_SIZE, DAR_pkt_bytes_to_summary(
+			bytes.pkt_data, RIO_MAX_PKT_BYTES + 1, rio_addr_32,
+			true, &summ));
+
+	(void)state; // unused
+}
+
 static void DAR_pkt_ftype_descr_test(void **state)
 {
 	// highlights if a string changes value
@@ -2672,6 +2844,371 @@ static void DAR_pkt_resp_status_descr_test(void **state)
 	(void)state; // unused
 }
 
+// Emulated register file for the multi-register access tests.
+#define MR_REGS 0x400
+#define MR_NO_FAIL 0xFFFFFFFF
+
+static uint32_t mr_regs[MR_REGS];
+static uint32_t mr_fail_oset;
+static uint32_t mr_rd_calls;
+static uint32_t mr_blk_rd_calls;
+static uint32_t mr_wr_calls;
+static uint32_t mr_blk_wr_calls;
+
+static uint32_t mr_rd(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t *readdata)
+{
+	(void)dev_info;
+	mr_rd_calls++;
+	if ((offset == mr_fail_oset) || (offset >= (4 * MR_REGS))) {
+		return RIO_ERR_ACCESS;
+	}
+	*readdata = mr_regs[offset / 4];
+	return RIO_SUCCESS;
+}
+
+static uint32_t mr_wr(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t writedata)
+{
+	(void)dev_info;
+	mr_wr_calls++;
+	if ((offset == mr_fail_oset) || (offset >= (4 * MR_REGS))) {
+		return RIO_ERR_ACCESS;
+	}
+	mr_regs[offset / 4] = writedata;
+	return RIO_SUCCESS;
+}
+
+static void mr_wait(uint32_t delay_nsec, uint32_t delay_sec)
+{
+	(void)delay_nsec;
+	(void)delay_sec;
+}
+
+static uint32_t mr_rd_blk(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *readdata)
+{
+	uint32_t i;
+
+	(void)dev_info;
+	mr_blk_rd_calls++;
+	assert_true(cnt <= DAR_MULTI_REG_MAX_BLK);
+	for (i = 0; i < cnt; i++) {
+		if ((offset + (4 * i) == mr_fail_oset)
+				|| (offset + (4 * i) >= (4 * MR_REGS))) {
+			return RIO_ERR_ACCESS;
+		}
+		readdata[i] = mr_regs[(offset / 4) + i];
+	}
+	return RIO_SUCCESS;
+}
+
+static uint32_t mr_wr_blk(DAR_DEV_INFO_t *dev_info, uint32_t offset,
+		uint32_t cnt, uint32_t *writedata)
+{
+	uint32_t i;
+
+	(void)dev_info;
+	mr_blk_wr_calls++;
+	for (i = 0; i < cnt; i++) {
+		if ((offset + (4 * i) == mr_fail_oset)
+				|| (offset + (4 * i) >= (4 * MR_REGS))) {
+			return RIO_ERR_ACCESS;
+		}
+	}
+	for (i = 0; i < cnt; i++) {
+		mr_regs[(offset / 4) + i] = writedata[i];
+	}
+	return RIO_SUCCESS;
+}
+
+static void mr_setup(DAR_DEV_INFO_t *dev, bool blk)
+{
+	uint32_t i;
+
+	memset(dev, 0, sizeof(*dev));
+	dev->devID = 0x80E60038;
+	dev->dsf_h = 0x00380000;
+	dev->driver_family = RIO_RXS_DEVICE;
+
+	for (i = 0; i < MR_REGS; i++) {
+		mr_regs[i] = 0x5A000000 + i;
+	}
+	mr_fail_oset = MR_NO_FAIL;
+	mr_rd_calls = mr_blk_rd_calls = 0;
+	mr_wr_calls = mr_blk_wr_calls = 0;
+
+	assert_int_equal(RIO_SUCCESS, DAR_proc_ptr_init(mr_rd, mr_wr, mr_wait));
+	assert_int_equal(RIO_SUCCESS,
+			DAR_blk_rd_proc_ptr_init(blk ? mr_rd_blk : NULL));
+	assert_int_equal(RIO_SUCCESS,
+			DAR_blk_proc_ptr_init(blk ? mr_wr_blk : NULL));
+}
+
+static void DAR_multi_reg_read_parms_test(void **state)
+{
+	DAR_DEV_INFO_t dev;
+	DAR_read_entry_in_t in[1];
+	DAR_read_entry_out_t out[1];
+
+	mr_setup(&dev, true);
+	in[0].offset = 0;
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			DAR_multi_reg_read(NULL, in, out, 1));
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			DAR_multi_reg_read(&dev, NULL, out, 1));
+	assert_int_equal(RIO_ERR_NULL_PARM_PTR,
+			DAR_multi_reg_read(&dev, in, NULL, 1));
+	assert_int_equal(RIO_SUCCESS, DAR_multi_reg_read(&dev, in, out, 0));
+	assert_int_equal(0, mr_rd_calls + mr_blk_rd_calls);
+
+	(void)state; // unused
+}
+
+// Unsorted entries covering three runs of consecutive registers, with a
+// duplicate, are read with one block access per run.
+static void DAR_multi_reg_read_merge_test(void **state)
+{
+	const uint32_t osets[] = {0x108, 0x10, 0x100, 0x14, 0x200, 0x104,
+					0x18, 0x100};
+	const uint32_t n = sizeof(osets) / sizeof(osets[0]);
+	DAR_DEV_INFO_t dev;
+	DAR_read_entry_in_t in[8];
+	DAR_read_entry_out_t out[8];
+	DAR_rd_stats_t st_b, st_a;
+	uint32_t i;
+
+	mr_setup(&dev, true);
+	for (i = 0; i < n; i++) {
+		in[i].offset = osets[i];
+		out[i].rc = 0xFFFF;
+	}
+	DAR_get_rd_stats(&st_b);
+	assert_int_equal(RIO_SUCCESS, DAR_multi_reg_read(&dev, in, out, n));
+	DAR_get_rd_stats(&st_a);
+
+	for (i = 0; i < n; i++) {
+		assert_int_equal(RIO_SUCCESS, out[i].rc);
+		assert_int_equal(mr_regs[osets[i] / 4], out[i].value_read);
+	}
+	// 0x10-0x18 and 0x100-0x108 are blocks, 0x200 is a single read
+	assert_int_equal(2, mr_blk_rd_calls);
+	assert_int_equal(1, mr_rd_calls);
+	assert_int_equal(7, st_a.reg_rd - st_b.reg_rd);
+	assert_int_equal(3, st_a.blk_rd - st_b.blk_rd);
+
+	(void)state; // unused
+}
+
+// Without a block read routine, every register is read once.
+static void DAR_multi_reg_read_no_blk_test(void **state)
+{
+	DAR_DEV_INFO_t dev;
+	DAR_read_entry_in_t in[10];
+	DAR_read_entry_out_t out[10];
+	uint32_t i;
+
+	mr_setup(&dev, false);
+	for (i = 0; i < 10; i++) {
+		in[i].offset = 0x40 - (4 * i);
+	}
+	assert_int_equal(RIO_SUCCESS, DAR_multi_reg_read(&dev, in, out, 10));
+	for (i = 0; i < 10; i++) {
+		assert_int_equal(RIO_SUCCESS, out[i].rc);
+		assert_int_equal(mr_regs[in[i].offset / 4], out[i].value_read);
+	}
+	assert_int_equal(0, mr_blk_rd_calls);
+	assert_int_equal(10, mr_rd_calls);
+
+	(void)state; // unused
+}
+
+// Runs longer than the maximum block size are split, and large requests
+// are sorted in allocated memory.
+static void DAR_multi_reg_read_large_test(void **state)
+{
+	DAR_DEV_INFO_t dev;
+	DAR_read_entry_in_t *in;
+	DAR_read_entry_out_t *out;
+	uint32_t i, n = MR_REGS;
+
+	in = (DAR_read_entry_in_t *)malloc(n * sizeof(*in));
+	out = (DAR_read_entry_out_t *)malloc(n * sizeof(*out));
+	assert_non_null(in);
+	assert_non_null(out);
+
+	mr_setup(&dev, true);
+	for (i = 0; i < n; i++) {
+		in[i].offset = 4 * ((i * 7) % n);
+	}
+	assert_int_equal(RIO_SUCCESS, DAR_multi_reg_read(&dev, in, out, n));
+	for (i = 0; i < n; i++) {
+		assert_int_equal(RIO_SUCCESS, out[i].rc);
+		assert_int_equal(mr_regs[in[i].offset / 4], out[i].value_read);
+	}
+	assert_int_equal(n / DAR_MULTI_REG_MAX_BLK, mr_blk_rd_calls);
+	assert_int_equal(0, mr_rd_calls);
+
+	free(in);
+	free(out);
+	(void)state; // unused
+}
+
+// A failed register only affects the entries which read it.
+static void DAR_multi_reg_read_fail_test(void **state)
+{
+	DAR_DEV_INFO_t dev;
+	DAR_read_entry_in_t in[6];
+	DAR_read_entry_out_t out[6];
+	uint32_t i;
+
+	mr_setup(&dev, true);
+	for (i = 0; i < 5; i++) {
+		in[i].offset = 0x80 + (4 * i);
+	}
+	in[5].offset = 0x88;
+	mr_fail_oset = 0x88;
+
+	assert_int_equal(RIO_ERR_ACCESS, DAR_multi_reg_read(&dev, in, out, 6));
+	for (i = 0; i < 6; i++) {
+		if (0x88 == in[i].offset) {
+			assert_int_equal(RIO_ERR_ACCESS, out[i].rc);
+			assert_int_equal(0, out[i].value_read);
+			continue;
+		}
+		assert_int_equal(RIO_SUCCESS, out[i].rc);
+		assert_int_equal(mr_regs[in[i].offset / 4], out[i].value_read);
+	}
+	assert_int_equal(1, mr_blk_rd_calls);
+	assert_int_equal(5, mr_rd_calls);
+
+	(void)state; // unused
+}
+
+// Without a block read routine, registers read before the failed
+// register are not read again, so clear on read values are not lost.
+static void DAR_multi_reg_read_no_blk_fail_test(void **state)
+{
+	DAR_DEV_INFO_t dev;
+	DAR_read_entry_in_t in[5];
+	DAR_read_entry_out_t out[5];
+	uint32_t i;
+
+	mr_setup(&dev, false);
+	for (i = 0; i < 5; i++) {
+		in[i].offset = 0x80 + (4 * i);
+	}
+	mr_fail_oset = 0x88;
+
+	assert_int_equal(RIO_ERR_ACCESS, DAR_multi_reg_read(&dev, in, out, 5));
+	for (i = 0; i < 5; i++) {
+		if (0x88 == in[i].offset) {
+			assert_int_equal(RIO_ERR_ACCESS, out[i].rc);
+			assert_int_equal(0, out[i].value_read);
+			continue;
+		}
+		assert_int_equal(RIO_SUCCESS, out[i].rc);
+		assert_int_equal(mr_regs[in[i].offset / 4], out[i].value_read);
+	}
+	// 0x80 and 0x84 once, 0x88 twice, then 0x8C and 0x90 once
+	assert_int_equal(0, mr_blk_rd_calls);
+	assert_int_equal(6, mr_rd_calls);
+
+	(void)state; // unused
+}
+
+static void DAR_multi_reg_acc_test(void **state)
+{
+	DAR_DEV_INFO_t dev;
+	DAR_read_write_entry_in_t in[4];
+	DAR_read_write_entry_out_t out[4];
+	uint32_t regs[MR_REGS];
+
+	mr_setup(&dev, true);
+	memcpy(regs, mr_regs, sizeof(regs));
+
+	// Write only, read only, and two read/modify/writes
+	in[0].offset = 0x24;
+	in[0].mask = 0;
+	in[0].value_delta = 0x11111111;
+	in[1].offset = 0x20;
+	in[1].mask = 0xFFFFFFFF;
+	in[1].value_delta = 0x22222222;
+	in[2].offset = 0x28;
+	in[2].mask = 0xFFFF0000;
+	in[2].value_delta = 0x33333333;
+	in[3].offset = 0x2C;
+	in[3].mask = 0x0000FFFF;
+	in[3].value_delta = 0x44444444;
+
+	assert_int_equal(RIO_SUCCESS, DAR_multi_reg_acc(&dev, in, out, 4));
+
+	assert_int_equal(0, out[0].read_value);
+	assert_int_equal(0x11111111, out[0].write_value);
+	assert_int_equal(0x11111111, mr_regs[0x24 / 4]);
+
+	assert_int_equal(regs[0x20 / 4], out[1].read_value);
+	assert_int_equal(regs[0x20 / 4], mr_regs[0x20 / 4]);
+
+	assert_int_equal(regs[0x28 / 4], out[2].read_value);
+	assert_int_equal((regs[0x28 / 4] & 0xFFFF0000) | 0x3333,
+			out[2].write_value);
+	assert_int_equal(out[2].write_value, mr_regs[0x28 / 4]);
+
+	assert_int_equal(regs[0x2C / 4], out[3].read_value);
+	assert_int_equal((regs[0x2C / 4] & 0xFFFF) | 0x44440000,
+			out[3].write_value);
+	assert_int_equal(out[3].write_value, mr_regs[0x2C / 4]);
+
+	// 0x24 is not read, so 0x20 is read alone and 0x28-0x2C is one
+	// block.  0x20 is not written, so 0x24-0x2C is one block write.
+	assert_int_equal(1, mr_blk_rd_calls);
+	assert_int_equal(1, mr_blk_wr_calls);
+	assert_int_equal(1, mr_rd_calls);
+	assert_int_equal(0, mr_wr_calls);
+
+	(void)state; // unused
+}
+
+// Entries which access the same register are performed in order, and
+// a register which cannot be read is not written.
+static void DAR_multi_reg_acc_dup_fail_test(void **state)
+{
+	DAR_DEV_INFO_t dev;
+	DAR_read_write_entry_in_t in[3];
+	DAR_read_write_entry_out_t out[3];
+	uint32_t reg;
+
+	mr_setup(&dev, true);
+	reg = mr_regs[0x30 / 4];
+
+	in[0].offset = 0x30;
+	in[0].mask = 0xFFFFFF00;
+	in[0].value_delta = 0x12;
+	in[1].offset = 0x30;
+	in[1].mask = 0xFFFF00FF;
+	in[1].value_delta = 0x3400;
+	in[2].offset = 0x40;
+	in[2].mask = 0;
+	in[2].value_delta = 0x56;
+	mr_fail_oset = 0x40;
+
+	assert_int_equal(RIO_ERR_ACCESS, DAR_multi_reg_acc(&dev, in, out, 3));
+	assert_int_equal(RIO_SUCCESS, out[0].write_rc);
+	assert_int_equal((reg & 0xFFFFFF00) | 0x12, out[1].read_value);
+	assert_int_equal((reg & 0xFFFF0000) | 0x3412, mr_regs[0x30 / 4]);
+	assert_int_equal(RIO_SUCCESS, out[2].read_rc);
+	assert_int_equal(RIO_ERR_ACCESS, out[2].write_rc);
+
+	in[2].mask = 0xFF;
+	assert_int_equal(RIO_ERR_ACCESS, DAR_multi_reg_acc(&dev, in, out, 3));
+	assert_int_equal(RIO_ERR_ACCESS, out[2].read_rc);
+	assert_int_equal(RIO_ERR_ACCESS, out[2].write_rc);
+	assert_int_equal(0x5A000010, mr_regs[0x40 / 4]);
+
+	(void)state; // unused
+}
+
 int main(int argc, char** argv)
 {
 	(void)argv; // not used
@@ -2718,9 +3255,18 @@ int main(int argc, char** argv)
 	cmocka_unit_test(DAR_pkt_bytes_to_fields_ftype_11_pkt_type_test),
 	cmocka_unit_test(DAR_pkt_bytes_to_fields_ftype_13_pkt_type_test),
 	cmocka_unit_test(DAR_pkt_bytes_to_fields_ftype_raw_pkt_type_test),
+	cmocka_unit_test(DAR_pkt_bytes_to_summary_test),
 	cmocka_unit_test(DAR_pkt_ftype_descr_test),
 	cmocka_unit_test(DAR_pkt_trans_descr_test),
 	cmocka_unit_test(DAR_pkt_resp_status_descr_test),
+	cmocka_unit_test(DAR_multi_reg_read_parms_test),
+	cmocka_unit_test(DAR_multi_reg_read_merge_test),
+	cmocka_unit_test(DAR_multi_reg_read_no_blk_test),
+	cmocka_unit_test(DAR_multi_reg_read_large_test),
+	cmocka_unit_test(DAR_multi_reg_read_fail_test),
+	cmocka_unit_test(DAR_multi_reg_read_no_blk_fail_test),
+	cmocka_unit_test(DAR_multi_reg_acc_test),
+	cmocka_unit_test(DAR_multi_reg_acc_dup_fail_test),
 
 	};
 	return cmocka_run_group_tests(tests, NULL, NULL);
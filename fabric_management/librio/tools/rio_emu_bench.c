@@ -0,0 +1,503 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+/**
+ * \file rio_emu_bench.c
+ * \brief Counts the maintenance accesses, and measures the time, of librio
+ * device configuration routines run against emulated devices.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "tok_parse.h"
+#include "RapidIO_Device_Access_Routines_API.h"
+#include "RapidIO_Device_Emulation_API.h"
+#include "RapidIO_Routing_Table_API.h"
+#include "RapidIO_Error_Management_API.h"
+#include "RapidIO_Port_Config_API.h"
+#include "RapidIO_Statistics_Counter_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct bench_state {
+	DAR_DEV_INFO_t dev_info;
+	rio_rt_state_t rt;
+	rio_sc_p_ctrs_val_t sc[RIO_MAX_PORTS];
+	rio_sc_dev_ctrs_t sc_dev;
+	rio_pc_get_config_out_t pc;
+	rio_pc_get_status_out_t ps;
+};
+
+typedef uint32_t (*bench_fn_t)(struct bench_state *st, uint32_t *imp_rc);
+
+// Programs every routing table entry on all ports
+static uint32_t bench_rt_set_all(struct bench_state *st, uint32_t *imp_rc)
+{
+	rio_rt_initialize_in_t init_in;
+	rio_rt_initialize_out_t init_out;
+	rio_rt_set_all_in_t set_in;
+	rio_rt_set_all_out_t set_out;
+	uint32_t rc;
+	uint32_t idx;
+
+	init_in.set_on_port = RIO_ALL_PORTS;
+	init_in.default_route = RIO_RTE_DROP;
+	init_in.default_route_table_port = RIO_RTE_DROP;
+	init_in.update_hw = false;
+	init_in.rt = &st->rt;
+	rc = rio_rt_initialize(&st->dev_info, &init_in, &init_out);
+	if (RIO_SUCCESS != rc) {
+		*imp_rc = init_out.imp_rc;
+		return rc;
+	}
+
+	for (idx = 0; idx < RIO_RT_GRP_SZ; idx++) {
+		st->rt.dev_table[idx].rte_val = idx % NUM_PORTS(&st->dev_info);
+	}
+
+	set_in.set_on_port = RIO_ALL_PORTS;
+	set_in.rt = &st->rt;
+	rc = rio_rt_set_all(&st->dev_info, &set_in, &set_out);
+	*imp_rc = set_out.imp_rc;
+	return rc;
+}
+
+// Enables detection of the fatal and drop events on all ports
+static uint32_t bench_em_cfg_set(struct bench_state *st, uint32_t *imp_rc)
+{
+	rio_em_cfg_t events[] = {
+		{rio_em_f_los, rio_em_detect_on, 1000000},
+		{rio_em_f_port_err, rio_em_detect_on, 0},
+		{rio_em_f_2many_retx, rio_em_detect_on, 0x10},
+		{rio_em_f_2many_pna, rio_em_detect_on, 0x10},
+		{rio_em_d_ttl, rio_em_detect_on, 1000000},
+		{rio_em_d_rte, rio_em_detect_on, 0},
+		{rio_em_i_sig_det, rio_em_detect_on, 0},
+	};
+	rio_em_cfg_set_in_t in_parms;
+	rio_em_cfg_set_out_t out_parms;
+	uint32_t rc;
+
+	in_parms.ptl.num_ports = RIO_ALL_PORTS;
+	in_parms.notfn = rio_em_notfn_none;
+	in_parms.num_events = sizeof(events) / sizeof(events[0]);
+	in_parms.events = events;
+	rc = rio_em_cfg_set(&st->dev_info, &in_parms, &out_parms);
+	*imp_rc = out_parms.imp_rc;
+	return rc;
+}
+
+static uint32_t bench_pc_set_config(struct bench_state *st, uint32_t *imp_rc)
+{
+	rio_pc_get_config_in_t pc_in;
+	rio_pc_set_config_in_t set_in;
+	uint32_t rc;
+
+	pc_in.ptl.num_ports = RIO_ALL_PORTS;
+	rc = rio_pc_get_config(&st->dev_info, &pc_in, &st->pc);
+	if (RIO_SUCCESS != rc) {
+		*imp_rc = st->pc.imp_rc;
+		return rc;
+	}
+
+	set_in.lrto = 50;
+	set_in.log_rto = 500;
+	set_in.oob_reg_acc = false;
+	set_in.reg_acc_port = 0;
+	set_in.num_ports = st->pc.num_ports;
+	memcpy(set_in.pc, st->pc.pc, sizeof(set_in.pc));
+	rc = rio_pc_set_config(&st->dev_info, &set_in, &st->pc);
+	*imp_rc = st->pc.imp_rc;
+	return rc;
+}
+
+static uint32_t bench_sc_init_dev_ctrs(struct bench_state *st, uint32_t *imp_rc)
+{
+	rio_sc_init_dev_ctrs_in_t in_parms;
+	rio_sc_init_dev_ctrs_out_t out_parms;
+	uint32_t rc;
+
+	st->sc_dev.num_p_ctrs = NUM_PORTS(&st->dev_info);
+	st->sc_dev.valid_p_ctrs = 0;
+	st->sc_dev.p_ctrs = st->sc;
+	in_parms.ptl.num_ports = RIO_ALL_PORTS;
+	in_parms.dev_ctrs = &st->sc_dev;
+	rc = rio_sc_init_dev_ctrs(&st->dev_info, &in_parms, &out_parms);
+	*imp_rc = out_parms.imp_rc;
+	return (RIO_STUBBED == rc) ? RIO_SUCCESS : rc;
+}
+
+static uint32_t bench_sc_read_ctrs(struct bench_state *st, uint32_t *imp_rc)
+{
+	rio_sc_read_ctrs_in_t in_parms;
+	rio_sc_read_ctrs_out_t out_parms;
+	uint32_t rc;
+
+	rc = bench_sc_init_dev_ctrs(st, imp_rc);
+	if (RIO_SUCCESS != rc) {
+		return rc;
+	}
+
+	in_parms.ptl.num_ports = RIO_ALL_PORTS;
+	in_parms.dev_ctrs = &st->sc_dev;
+	rc = rio_sc_read_ctrs(&st->dev_info, &in_parms, &out_parms);
+	*imp_rc = out_parms.imp_rc;
+	return (RIO_STUBBED == rc) ? RIO_SUCCESS : rc;
+}
+
+static uint32_t bench_probe_all_rt(struct bench_state *st, uint32_t *imp_rc)
+{
+	rio_rt_probe_all_in_t in_parms;
+	rio_rt_probe_all_out_t out_parms;
+	uint32_t rc;
+	uint8_t port;
+
+	in_parms.probe_on_port = RIO_ALL_PORTS;
+	in_parms.rt = &st->rt;
+	rc = rio_rt_probe_all(&st->dev_info, &in_parms, &out_parms);
+	for (port = 0; (RIO_SUCCESS == rc) && (port < NUM_PORTS(&st->dev_info));
+			port++) {
+		in_parms.probe_on_port = port;
+		rc = rio_rt_probe_all(&st->dev_info, &in_parms, &out_parms);
+	}
+	*imp_rc = out_parms.imp_rc;
+	return rc;
+}
+
+// The librio calls made by generic_device_init for a device which is
+// not in the configuration file.
+static uint32_t bench_dev_init(struct bench_state *st, uint32_t *imp_rc)
+{
+	DAR_DEV_INFO_t *dev_h = &st->dev_info;
+	struct DAR_ptl ptl;
+	rio_pc_get_status_in_t ps_in;
+	rio_pc_dev_reset_config_in_t rst_in;
+	rio_pc_dev_reset_config_out_t rst_out;
+	rio_em_dev_rpt_ctl_in_t rpt_in;
+	rio_em_dev_rpt_ctl_out_t rpt_out;
+	rio_em_cfg_pw_t pw_cfg;
+	uint32_t rc;
+
+	ptl.num_ports = RIO_ALL_PORTS;
+	rc = DARrioPortEnable(dev_h, &ptl, true, false, SWITCH(dev_h));
+	if (RIO_SUCCESS != rc) {
+		return rc;
+	}
+
+	rc = DARrioSetEnumBound(dev_h, &ptl, 0);
+	if (RIO_SUCCESS != rc) {
+		return rc;
+	}
+
+	if (MEMORY(dev_h)) {
+		rc = DARrioSetAddrMode(dev_h, RIO_PE_LL_CTL_34BIT);
+		if (RIO_SUCCESS != rc) {
+			return rc;
+		}
+	}
+
+	rc = bench_pc_set_config(st, imp_rc);
+	if (RIO_SUCCESS != rc) {
+		return rc;
+	}
+
+	ps_in.ptl.num_ports = RIO_ALL_PORTS;
+	rc = rio_pc_get_status(dev_h, &ps_in, &st->ps);
+	if (RIO_SUCCESS != rc) {
+		*imp_rc = st->ps.imp_rc;
+		return rc;
+	}
+
+	if (SWITCH(dev_h)) {
+		rc = bench_probe_all_rt(st, imp_rc);
+		if (RIO_SUCCESS != rc) {
+			return rc;
+		}
+		rc = bench_rt_set_all(st, imp_rc);
+		if (RIO_SUCCESS != rc) {
+			return rc;
+		}
+		rc = bench_probe_all_rt(st, imp_rc);
+		if (RIO_SUCCESS != rc) {
+			return rc;
+		}
+	}
+
+	rc = bench_sc_init_dev_ctrs(st, imp_rc);
+	if (RIO_SUCCESS != rc) {
+		return rc;
+	}
+
+	rst_in.rst = rio_pc_rst_port;
+	rc = rio_pc_dev_reset_config(dev_h, &rst_in, &rst_out);
+	if (RIO_SUCCESS != rc) {
+		*imp_rc = rst_out.imp_rc;
+		return rc;
+	}
+
+	rpt_in.ptl.num_ports = RIO_ALL_PORTS;
+	rpt_in.notfn = rio_em_notfn_none;
+	rc = rio_em_dev_rpt_ctl(dev_h, &rpt_in, &rpt_out);
+	if (RIO_SUCCESS != rc) {
+		*imp_rc = rpt_out.imp_rc;
+		return rc;
+	}
+
+	memset(&pw_cfg, 0, sizeof(pw_cfg));
+	pw_cfg.deviceID_tt = tt_dev8;
+	pw_cfg.port_write_destID = 0;
+	pw_cfg.srcID_valid = true;
+	pw_cfg.port_write_srcID = 1;
+	pw_cfg.priority = 3;
+	pw_cfg.CRF = true;
+	rc = rio_em_cfg_pw(dev_h, &pw_cfg, &pw_cfg);
+	*imp_rc = pw_cfg.imp_rc;
+	return rc;
+}
+
+struct bench_t {
+	const char *name;
+	bench_fn_t fn;
+	bool sw_only;
+};
+
+static const struct bench_t benches[] = {
+	{"rt_set_all", bench_rt_set_all, true},
+	{"em_cfg_set", bench_em_cfg_set, false},
+	{"pc_set_config", bench_pc_set_config, false},
+	{"sc_read_ctrs", bench_sc_read_ctrs, false},
+	{"dev_init", bench_dev_init, false},
+};
+
+#define NUM_BENCHES (sizeof(benches) / sizeof(benches[0]))
+
+static void usage(char *program)
+{
+	printf("%s - count maintenance accesses of librio routines\n",
+			program);
+	printf("Usage:\n");
+	printf("  %s [options]\n", program);
+	printf("Options are:\n");
+	printf("  -h\n");
+	printf("    display this message\n");
+	printf("  -m <model>[,<model>...]\n");
+	printf("    emulated devices to use (default all):\n");
+	printf("    rxs2448, rxs1632, cps1848, cps1616, tsi578, tsi721\n");
+	printf("  -a <ns>\n");
+	printf("    latency of each maintenance access (default 2000)\n");
+	printf("  -r <ns>\n");
+	printf("    additional latency per register accessed (default 20)\n");
+	printf("  -w\n");
+	printf("    wait for the modeled latency on each access\n");
+	printf("  -s\n");
+	printf("    access one register at a time, without block accesses\n");
+	printf("  -i <iterations>\n");
+	printf("    number of times each routine is run (default 10)\n");
+	printf("\n");
+}
+
+static int parse_models(char *arg, bool *models)
+{
+	char *tok, *save = NULL;
+	rio_emu_model_t model;
+
+	memset(models, 0, rio_emu_model_last * sizeof(bool));
+	for (tok = strtok_r(arg, ",", &save); NULL != tok;
+				tok = strtok_r(NULL, ",", &save)) {
+		model = rio_emu_model_by_name(tok);
+		if (rio_emu_model_last == model) {
+			printf("Unknown model \"%s\"\n", tok);
+			return -1;
+		}
+		models[model] = true;
+	}
+	return 0;
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+static int run_model(rio_emu_model_t model, rio_emu_lat_t *lat,
+		uint32_t iters)
+{
+	struct bench_state *st;
+	rio_emu_dev_t *emu;
+	rio_emu_stats_t stats;
+	uint64_t start, elapsed;
+	uint32_t rc, imp_rc, b, i;
+
+	st = (struct bench_state *)calloc(1, sizeof(struct bench_state));
+	emu = rio_emu_create(model);
+	if ((NULL == st) || (NULL == emu)) {
+		fprintf(stderr, "Out of memory\n");
+		free(st);
+		rio_emu_destroy(emu);
+		return -1;
+	}
+
+	rc = rio_emu_dev_info_init(emu, &st->dev_info);
+	if (RIO_SUCCESS != rc) {
+		fprintf(stderr, "%s: device not found: 0x%x\n",
+				rio_emu_model_name(model), rc);
+		goto fail;
+	}
+	rio_emu_set_lat(emu, lat);
+
+	for (b = 0; b < NUM_BENCHES; b++) {
+		if (benches[b].sw_only && !SWITCH(&st->dev_info)) {
+			continue;
+		}
+
+		rio_emu_reset(emu);
+		rio_emu_clr_stats(emu);
+		start = now_ns();
+		for (i = 0; i < iters; i++) {
+			imp_rc = 0;
+			rc = benches[b].fn(st, &imp_rc);
+			if (RIO_SUCCESS != rc) {
+				fflush(stdout);
+				fprintf(stderr, "%s %s failed: 0x%x 0x%x\n",
+						rio_emu_model_name(model),
+						benches[b].name, rc, imp_rc);
+				goto fail;
+			}
+		}
+		elapsed = now_ns() - start;
+		rio_emu_get_stats(emu, &stats);
+
+		printf("%-8s %-17s %8" PRIu64 " %8" PRIu64 " %8" PRIu64
+				" %8" PRIu64 " %10.1f %10.1f\n",
+				rio_emu_model_name(model), benches[b].name,
+				stats.rd_acc / iters, stats.regs_rd / iters,
+				stats.wr_acc / iters, stats.regs_wr / iters,
+				(double)stats.lat_ns / iters / 1000.0,
+				(double)elapsed / iters / 1000.0);
+	}
+
+	free(st);
+	rio_emu_destroy(emu);
+	return 0;
+
+fail:
+	free(st);
+	rio_emu_destroy(emu);
+	return -1;
+}
+
+int main(int argc, char *argv[])
+{
+	bool models[rio_emu_model_last];
+	rio_emu_lat_t lat;
+	uint32_t iters = 10;
+	uint32_t idx;
+	bool blk = true;
+	int rc = EXIT_SUCCESS;
+	int c;
+
+	memset(models, 1, sizeof(models));
+	lat.acc_ns = 2000;
+	lat.reg_ns = 20;
+	lat.wait = false;
+
+	while (-1 != (c = getopt(argc, argv, "hm:a:r:wsi:"))) {
+		switch (c) {
+		case 'm':
+			if (parse_models(optarg, models)) {
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'a':
+		case 'r':
+			if (tok_parse_ulong(optarg, &idx, 0, 1000000000, 0)) {
+				printf(TOK_ERR_ULONG_MSG_FMT, "Latency", 0,
+						1000000000);
+				exit(EXIT_FAILURE);
+			}
+			if ('a' == c) {
+				lat.acc_ns = idx;
+			} else {
+				lat.reg_ns = idx;
+			}
+			break;
+		case 'w':
+			lat.wait = true;
+			break;
+		case 's':
+			blk = false;
+			break;
+		case 'i':
+			if (tok_parse_ulong(optarg, &iters, 1, 1000000, 0)) {
+				printf(TOK_ERR_ULONG_MSG_FMT, "Iterations", 1,
+						1000000);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	rio_emu_bind(blk);
+
+	printf("Per call averages over %u iterations, %s accesses\n", iters,
+			blk ? "block" : "single register");
+	printf("%-8s %-17s %8s %8s %8s %8s %10s %10s\n", "Device", "Routine",
+			"Rd acc", "Rd regs", "Wr acc", "Wr regs",
+			"Model us", "Wall us");
+	for (idx = 0; idx < rio_emu_model_last; idx++) {
+		if (models[idx] && run_model((rio_emu_model_t)idx, &lat,
+				iters)) {
+			rc = EXIT_FAILURE;
+		}
+	}
+	return rc;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,379 @@
+/*
+ ****************************************************************************
+ Copyright (c) 2017, Integrated Device Technology Inc.
+ Copyright (c) 2017, RapidIO Trade Association
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright holder nor the names of its contributors
+ may be used to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************
+ */
+
+/**
+ * \file rio_trace.c
+ * \brief Filters, lists and summarizes packet and control symbol captures.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#include "tok_parse.h"
+#include "RapidIO_Device_Access_Routines_API.h"
+#include "RapidIO_Trace_API.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const char *pkt_type_names[pkt_type_max + 1] = {
+	"RAW", "NREAD", "ATOMIC_INC", "ATOMIC_DEC", "ATOMIC_SET",
+	"ATOMIC_CLR", "NWRITE", "NWRITE_R", "ATOMIC_SWAP", "ATOMIC_CSWAP",
+	"ATOMIC_TSWAP", "SWRITE", "FLOW_CTL", "MAINT_RD", "MAINT_WR",
+	"MAINT_RD_RSP", "MAINT_WR_RSP", "PORT_WRITE", "DSTREAM", "DOORBELL",
+	"MESSAGE", "RESP", "RESP_DATA", "MSG_RESP",
+};
+
+static const char *grp_names[] = {"", "destID", "srcID", "ftype", "port"};
+
+struct list_state {
+	uint64_t max_lines;
+	uint64_t lines;
+};
+
+static void usage(char *program)
+{
+	printf("%s - filter, list and summarize RapidIO trace captures\n",
+			program);
+	printf("Usage:\n");
+	printf("  %s [options] <capture file>\n", program);
+	printf("Options are:\n");
+	printf("  -h\n");
+	printf("    display this message\n");
+	printf("  -t <threads>\n");
+	printf("    number of decoding threads (default online processors)\n");
+	printf("  -f <ftype>[,<ftype>...]\n");
+	printf("    select packets with these FTYPEs\n");
+	printf("  -d <destID>\n");
+	printf("    select packets sent to destID\n");
+	printf("  -s <srcID>\n");
+	printf("    select packets sent by srcID\n");
+	printf("  -c ok|bad\n");
+	printf("    select records with correct, or incorrect, CRCs\n");
+	printf("  -p <port>[,<port>...]\n");
+	printf("    select records captured on these ports (0 to 63)\n");
+	printf("  -b <ns>\n");
+	printf("  -e <ns>\n");
+	printf("    select records captured from/until these times\n");
+	printf("  -x\n");
+	printf("    exclude control symbols\n");
+	printf("  -g dest|src|ftype|port\n");
+	printf("    display packet and byte counts for each value\n");
+	printf("  -l\n");
+	printf("    list the selected records, in capture order\n");
+	printf("  -n <count>\n");
+	printf("    limit the records listed, or groups displayed\n");
+	printf("\n");
+}
+
+static int parse_list(char *arg, uint64_t *mask, uint32_t max, const char *name)
+{
+	char *tok, *save = NULL;
+	uint32_t val;
+
+	*mask = 0;
+	for (tok = strtok_r(arg, ",", &save); NULL != tok;
+				tok = strtok_r(NULL, ",", &save)) {
+		if (tok_parse_ulong(tok, &val, 0, max, 0)) {
+			printf(TOK_ERR_ULONG_MSG_FMT, name, 0, max);
+			return -1;
+		}
+		*mask |= (uint64_t)1 << val;
+	}
+	return 0;
+}
+
+static void list_batch(rio_trace_batch_t *batch, void *arg)
+{
+	struct list_state *ls = (struct list_state *)arg;
+	uint32_t p = 0, c = 0, r;
+	bool pkt;
+
+	// Merge packets and control symbols in capture order
+	while ((p < batch->pkt_sel_cnt) || (c < batch->cs_sel_cnt)) {
+		if (ls->max_lines && (ls->lines >= ls->max_lines)) {
+			return;
+		}
+		pkt = (c >= batch->cs_sel_cnt) || ((p < batch->pkt_sel_cnt)
+				&& (batch->pkt_ts[batch->pkt_sel[p]]
+				<= batch->cs_ts[batch->cs_sel[c]]));
+		if (pkt) {
+			r = batch->pkt_sel[p++];
+			printf("%16" PRIu64 " p%-2u PKT %-12s ft %2u pri %u "
+				"dst 0x%04x src 0x%04x addr 0x%016" PRIx64
+				" bytes %3u len %3u tid %3u%s%s\n",
+				batch->pkt_ts[r], batch->pkt_port[r],
+				(batch->pkt_type[r] <= pkt_type_max) ?
+					pkt_type_names[batch->pkt_type[r]] :
+					"?",
+				batch->ftype[r], batch->prio[r],
+				batch->dest[r], batch->src[r], batch->addr[r],
+				batch->bytes[r], batch->len[r], batch->tid[r],
+				(batch->pkt_flags[r] & RIO_TRACE_F_CRC_OK) ?
+							"" : " CRC_ERR",
+				(batch->pkt_flags[r] & RIO_TRACE_F_DECODE_OK) ?
+							"" : " DECODE_ERR");
+		} else {
+			r = batch->cs_sel[c++];
+			printf("%16" PRIu64 " p%-2u CS  stype0 %u parm0 0x%02x "
+				"parm1 0x%02x stype1 %u cmd %u%s%s\n",
+				batch->cs_ts[r], batch->cs_port[r],
+				batch->stype0[r], batch->parm0[r],
+				batch->parm1[r], batch->stype1[r],
+				batch->cmd[r],
+				(batch->cs_flags[r] & RIO_TRACE_F_CRC_OK) ?
+							"" : " CRC_ERR",
+				(batch->cs_flags[r] & RIO_TRACE_F_DECODE_OK) ?
+							"" : " DECODE_ERR");
+		}
+		ls->lines++;
+	}
+}
+
+static void print_groups(rio_trace_agg_t *agg, uint32_t max_grps)
+{
+	uint32_t *keys;
+	uint32_t cnt = 0, i, j, k;
+
+	keys = (uint32_t *)malloc(RIO_TRACE_GRP_KEYS * sizeof(uint32_t));
+	if (NULL == keys) {
+		return;
+	}
+	for (i = 0; i < RIO_TRACE_GRP_KEYS; i++) {
+		if (agg->grp_pkts[i]) {
+			keys[cnt++] = i;
+		}
+	}
+
+	// Largest byte counts first
+	for (i = 1; i < cnt; i++) {
+		k = keys[i];
+		for (j = i; j && (agg->grp_wire[keys[j - 1]] < agg->grp_wire[k]);
+									j--) {
+			keys[j] = keys[j - 1];
+		}
+		keys[j] = k;
+	}
+
+	printf("\n%8s %14s %16s %16s\n", grp_names[agg->grp], "Packets",
+						"Bytes", "Data Bytes");
+	for (i = 0; (i < cnt) && (!max_grps || (i < max_grps)); i++) {
+		k = keys[i];
+		printf("  0x%04x %14" PRIu64 " %16" PRIu64 " %16" PRIu64 "\n",
+				k, agg->grp_pkts[k], agg->grp_wire[k],
+				agg->grp_data[k]);
+	}
+	free(keys);
+}
+
+static void print_summary(rio_trace_t *trace, rio_trace_scan_out_t *out)
+{
+	rio_trace_agg_t *agg = &out->agg;
+	double secs = (double)out->usecs / 1e6;
+	uint32_t i;
+
+	printf("\nRecords      %16" PRIu64 "  (%" PRIu64 " decode errors)\n",
+			agg->recs, agg->decode_errs);
+	printf("Packets      %16" PRIu64 "\n", agg->pkts);
+	printf("Ctl Symbols  %16" PRIu64 "\n", agg->cs);
+	printf("Bytes        %16" PRIu64 "\n", agg->wire_bytes);
+	printf("Data Bytes   %16" PRIu64 "\n", agg->data_bytes);
+	printf("CRC Errors   %16" PRIu64 "\n", agg->crc_errs);
+	if (agg->pkts || agg->cs) {
+		printf("Time         %16" PRIu64 " to %" PRIu64 " ns\n",
+				agg->ts_first, agg->ts_last);
+	}
+	for (i = 0; i < 16; i++) {
+		if (agg->ftype[i]) {
+			printf("  FTYPE %2u   %16" PRIu64 "\n", i,
+							agg->ftype[i]);
+		}
+	}
+	printf("Scanned %" PRIu64 " bytes in %.3f s, %.1f MB/s\n",
+			trace->size, secs,
+			secs ? (double)trace->size / secs / 1e6 : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+	rio_trace_t trace;
+	rio_trace_filter_t filter;
+	rio_trace_scan_in_t in_parms;
+	rio_trace_scan_out_t out_parms;
+	struct list_state ls;
+	uint64_t mask;
+	uint32_t val, max_cnt = 0;
+	bool list = false;
+	uint32_t rc;
+	int c;
+
+	memset(&filter, 0, sizeof(filter));
+	memset(&in_parms, 0, sizeof(in_parms));
+
+	while (-1 != (c = getopt(argc, argv, "ht:f:d:s:c:p:b:e:xg:ln:"))) {
+		switch (c) {
+		case 't':
+			if (tok_parse_ulong(optarg, &in_parms.thread_cnt, 1,
+						RIO_TRACE_MAX_THREADS, 0)) {
+				printf(TOK_ERR_ULONG_MSG_FMT, "Threads", 1,
+						RIO_TRACE_MAX_THREADS);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'f':
+			if (parse_list(optarg, &mask, 15, "FTYPE")) {
+				exit(EXIT_FAILURE);
+			}
+			filter.ftype_mask = (uint32_t)mask;
+			break;
+		case 'd':
+		case 's':
+			if (tok_parse_ulong(optarg, &val, 0, 0xFFFF, 0)) {
+				printf(TOK_ERR_ULONG_HEX_MSG_FMT, "Device ID",
+							0, 0xFFFF);
+				exit(EXIT_FAILURE);
+			}
+			if ('d' == c) {
+				filter.dest_en = true;
+				filter.dest = val;
+			} else {
+				filter.src_en = true;
+				filter.src = val;
+			}
+			break;
+		case 'c':
+			if (!strcmp(optarg, "ok")) {
+				filter.crc = rio_trace_crc_ok;
+			} else if (!strcmp(optarg, "bad")) {
+				filter.crc = rio_trace_crc_bad;
+			} else {
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'p':
+			if (parse_list(optarg, &filter.port_mask, 63, "Port")) {
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'b':
+		case 'e':
+			if (tok_parse_ull(optarg, ('b' == c) ?
+					&filter.ts_min : &filter.ts_max, 0)) {
+				printf(TOK_ERR_ULL_HEX_MSG_FMT, "Time");
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'x':
+			filter.no_cs = true;
+			break;
+		case 'g':
+			for (val = rio_trace_grp_dest;
+					val <= rio_trace_grp_port; val++) {
+				if (!strncmp(optarg, grp_names[val], 3)
+						|| !strcmp(optarg,
+							grp_names[val])) {
+					break;
+				}
+			}
+			if (val > rio_trace_grp_port) {
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+			}
+			in_parms.grp = (rio_trace_grp_t)val;
+			break;
+		case 'l':
+			list = true;
+			break;
+		case 'n':
+			if (tok_parse_ul(optarg, &max_cnt, 0)) {
+				printf(TOK_ERR_UL_HEX_MSG_FMT, "Count");
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (optind >= argc) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	rc = rio_trace_open(&trace, argv[optind]);
+	if (RIO_SUCCESS != rc) {
+		fprintf(stderr, "Cannot open capture \"%s\": 0x%x\n",
+				argv[optind], rc);
+		exit(EXIT_FAILURE);
+	}
+
+	in_parms.trace = &trace;
+	in_parms.filter = &filter;
+	if (list) {
+		// Batches are only passed in capture order by a single thread
+		ls.max_lines = max_cnt;
+		ls.lines = 0;
+		in_parms.thread_cnt = 1;
+		in_parms.batch_fn = list_batch;
+		in_parms.batch_arg = &ls;
+	}
+
+	rc = rio_trace_scan(&in_parms, &out_parms);
+	if (RIO_SUCCESS != rc) {
+		fprintf(stderr, "Scan failed: 0x%x 0x%x\n", rc,
+							out_parms.imp_rc);
+		rio_trace_close(&trace);
+		exit(EXIT_FAILURE);
+	}
+
+	print_summary(&trace, &out_parms);
+	if (rio_trace_grp_none != in_parms.grp) {
+		print_groups(&out_parms.agg, max_cnt);
+	}
+
+	rio_trace_agg_free(&out_parms.agg);
+	rio_trace_close(&trace);
+	return EXIT_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
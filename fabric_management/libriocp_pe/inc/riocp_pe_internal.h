@@ -108,6 +108,7 @@ struct riocp_pe_mport {
 	bool is_host;				/**< Is mport host/agent */
 	struct riocp_pe *any_id_target;		/**< Current programmed ANY_ID route to this PE*/
 	struct riocp_pe_llist_item handles;	/**< Handles of PEs behind this mport */
+	struct riocp_pe_llist_item ef_cache;	/**< Capabilities and feature layout of each device type */
 	void *private_data;			/**< Mport private data */
 };
 
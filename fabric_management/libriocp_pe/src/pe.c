@@ -10,6 +10,7 @@
 #define _XOPEN_SOURCE 500
 
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "rio_ecosystem.h"
@@ -22,13 +23,139 @@
 #include "handle.h"
 #include "comptag.h"
 #include "driver.h"
+#include "llist.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Capabilities which do not change after reset, and extended feature
+ * layout, of a device type.  Devices of the same type are identified by the
+ * device and assembly identity and information CARs.
+ */
+struct riocp_pe_ef_cache {
+	uint32_t dev_id;
+	uint32_t dev_info;
+	uint32_t asbly_id;
+	uint32_t asbly_info;
+	uint32_t pe_feat;
+	uint32_t src_op;
+	uint32_t dst_op;
+	uint32_t lut_size;
+	bool efb_valid;			/**< efb_hdr and efptr fields are valid */
+	uint32_t efb_hdr;		/**< First extended feature block header */
+	uint32_t efptr_phys;
+	uint32_t efptr_phys_type;
+	uint32_t efptr_em;
+};
+
+/**
+ * Find the cache entry for the device type of a PE
+ * @note The PE should already have the identity CARs read
+ * @param pe Target PE
+ * @returns Cache entry, or NULL when the device type is not cached
+ */
+static struct riocp_pe_ef_cache *riocp_pe_ef_cache_find(struct riocp_pe *pe)
+{
+	struct riocp_pe_llist_item *item;
+	struct riocp_pe_ef_cache *c;
+
+	RIOCP_PE_LLIST_FOREACH(item, pe->mport->minfo->ef_cache.next) {
+		c = (struct riocp_pe_ef_cache *)item->data;
+		if (c->dev_id == pe->cap.dev_id
+				&& c->dev_info == pe->cap.dev_info
+				&& c->asbly_id == pe->cap.asbly_id
+				&& c->asbly_info == pe->cap.asbly_info)
+			return c;
+	}
+
+	return NULL;
+}
+
+/**
+ * Check that the cached feature layout applies to a PE, by comparing the
+ * first extended feature block header
+ * @param pe Target PE
+ * @param c  Cache entry for the device type of the PE
+ * @retval 1 The cache entry may be used
+ * @retval 0 The cache entry must be refreshed
+ * @retval < 0 Error in maintenance access
+ */
+static int RIOCP_WU riocp_pe_ef_cache_check(struct riocp_pe *pe,
+		struct riocp_pe_ef_cache *c)
+{
+	int ret;
+	uint32_t efptr = c->asbly_info & RIO_ASSY_INF_EFB_PTR;
+	uint32_t val;
+
+	if (!(c->pe_feat & RIO_PEF_EXT_FEATURES) || !efptr)
+		return 1;
+
+	if (!c->efb_valid)
+		return 0;
+
+	ret = riocp_pe_maint_read(pe, efptr, &val);
+	if (ret)
+		return ret;
+
+	return (val == c->efb_hdr) ? 1 : 0;
+}
+
+/**
+ * Add or refresh the cache entry for the device type of a PE with the
+ * capabilities of the PE.  Failure to allocate an entry is not an error,
+ * the next PE of the same type is read in full.
+ * @param pe Target PE
+ */
+static void riocp_pe_ef_cache_update(struct riocp_pe *pe)
+{
+	struct riocp_pe_ef_cache *c;
+
+	c = riocp_pe_ef_cache_find(pe);
+	if (c == NULL) {
+		c = (struct riocp_pe_ef_cache *)calloc(1, sizeof(*c));
+		if (c == NULL)
+			return;
+		if (riocp_pe_llist_add(&pe->mport->minfo->ef_cache, c)) {
+			free(c);
+			return;
+		}
+	}
+
+	c->dev_id     = pe->cap.dev_id;
+	c->dev_info   = pe->cap.dev_info;
+	c->asbly_id   = pe->cap.asbly_id;
+	c->asbly_info = pe->cap.asbly_info;
+	c->pe_feat    = pe->cap.pe_feat;
+	c->src_op     = pe->cap.src_op;
+	c->dst_op     = pe->cap.dst_op;
+	c->lut_size   = pe->cap.lut_size;
+	c->efb_valid  = false;
+}
+
+/**
+ * Free the capabilities and feature layout cache of an mport
+ * @param minfo Mport information
+ */
+void riocp_pe_ef_cache_free(struct riocp_pe_mport *minfo)
+{
+	struct riocp_pe_llist_item *item;
+
+	RIOCP_PE_LLIST_FOREACH(item, minfo->ef_cache.next) {
+		free(item->data);
+	}
+	if (minfo->ef_cache.next != NULL)
+		riocp_pe_llist_free(minfo->ef_cache.next);
+	minfo->ef_cache.next = NULL;
+}
+
 /**
  * Read the capabilities into the handle
+ *
+ * Capabilities which do not change after reset are read once for each
+ * device type, and taken from the mport cache for later PEs of the same
+ * type.
  * @param pe Target PE
  * @returns
  *    - 0 on success
@@ -37,6 +164,7 @@ extern "C" {
 int riocp_pe_read_capabilities(struct riocp_pe *pe)
 {
 	int ret = 0;
+	struct riocp_pe_ef_cache *c;
 
 	RIOCP_TRACE("Read capabilities\n");
 
@@ -56,6 +184,26 @@ int riocp_pe_read_capabilities(struct riocp_pe *pe)
 	if (ret)
 		return ret;
 
+	c = riocp_pe_ef_cache_find(pe);
+	if (c) {
+		ret = riocp_pe_ef_cache_check(pe, c);
+		if (ret < 0)
+			return ret;
+		if (ret) {
+			pe->cap.pe_feat  = c->pe_feat;
+			pe->cap.src_op   = c->src_op;
+			pe->cap.dst_op   = c->dst_op;
+			pe->cap.lut_size = c->lut_size;
+
+			ret = riocp_pe_maint_read(pe, RIO_SW_PORT_INF, &pe->cap.sw_port);
+			if (ret)
+				return ret;
+
+			RIOCP_TRACE("Read capabilities ok (cached)\n");
+			return 0;
+		}
+	}
+
 	ret = riocp_pe_maint_read(pe, RIO_PE_FEAT, &pe->cap.pe_feat);
 	if (ret)
 		return ret;
@@ -76,6 +224,8 @@ int riocp_pe_read_capabilities(struct riocp_pe *pe)
 	if (ret)
 		return ret;
 
+	riocp_pe_ef_cache_update(pe);
+
 	RIOCP_TRACE("Read capabilities ok\n");
 
 	return 0;
@@ -118,8 +268,10 @@ static int RIOCP_WU riocp_pe_get_efb(struct riocp_pe *pe, uint32_t from, uint32_
  * Get RapidIO Physical extended feature pointer
  * @param pe Target PE
  * @param[out] efptr Extended feature pointer
+ * @param[out] efb_hdr First extended feature block header
  */
-static int riocp_pe_get_efptr_phys(struct riocp_pe *pe, uint32_t *efptr, uint32_t *efptr_type, uint32_t *value)
+static int riocp_pe_get_efptr_phys(struct riocp_pe *pe, uint32_t *efptr, uint32_t *efptr_type, uint32_t *value,
+		uint32_t *efb_hdr)
 {
 	int ret;
 	uint32_t _efptr;
@@ -136,6 +288,9 @@ static int riocp_pe_get_efptr_phys(struct riocp_pe *pe, uint32_t *efptr, uint32_
 		if (ret)
 			return ret;
 
+		if (_efptr == pe->efptr)
+			*efb_hdr = _efptr_hdr;
+
 		_efptr_hdr = RIO_EFB_ID(_efptr_hdr);
 		switch (_efptr_hdr) {
 		case RIO_EFB_T_SP_EP:
@@ -224,6 +379,9 @@ static int riocp_pe_get_efptr_phys(struct riocp_pe *pe, uint32_t *efptr, uint32_
 
 /**
  * Read and initialize handle extended feature pointers when available
+ *
+ * The extended feature pointers are found once for each device type, and
+ * taken from the mport cache for later PEs of the same type.
  * @note The pe should already have the cap attribute read
  * @param pe Target PE
  * @retval < 0 Error
@@ -231,13 +389,31 @@ static int riocp_pe_get_efptr_phys(struct riocp_pe *pe, uint32_t *efptr, uint32_
 int riocp_pe_read_features(struct riocp_pe *pe)
 {
 	int ret = 0;
+	struct riocp_pe_ef_cache *c;
+	uint32_t efb_hdr = 0;
 
 	/* Get extended feature pointers when available */
 	if (pe->cap.pe_feat & RIO_PEF_EXT_FEATURES) {
-		
-		ret = riocp_pe_get_efptr_phys(pe, &pe->efptr_phys, &pe->efptr_phys_type, &pe->efptr_em);
-		if (ret)
-			return ret;
+		c = riocp_pe_ef_cache_find(pe);
+		if (c && c->efb_valid) {
+			pe->efptr           = pe->cap.asbly_info & RIO_ASSY_INF_EFB_PTR;
+			pe->efptr_phys      = c->efptr_phys;
+			pe->efptr_phys_type = c->efptr_phys_type;
+			pe->efptr_em        = c->efptr_em;
+		} else {
+			ret = riocp_pe_get_efptr_phys(pe, &pe->efptr_phys, &pe->efptr_phys_type, &pe->efptr_em,
+					&efb_hdr);
+			if (ret)
+				return ret;
+
+			if (c) {
+				c->efb_hdr         = efb_hdr;
+				c->efptr_phys      = pe->efptr_phys;
+				c->efptr_phys_type = pe->efptr_phys_type;
+				c->efptr_em        = pe->efptr_em;
+				c->efb_valid       = true;
+			}
+		}
 
                 /*ret = riocp_pe_get_ef(pe, RIO_EFB_T_EMHS, &pe->efptr_em);
 		if (ret)
@@ -37,6 +37,7 @@ struct riocp_pe_device_id {
 
 int RIOCP_WU riocp_pe_read_capabilities(struct riocp_pe *pe);
 int RIOCP_WU riocp_pe_read_features(struct riocp_pe *pe);
+void riocp_pe_ef_cache_free(struct riocp_pe_mport *minfo);
 int RIOCP_WU riocp_pe_is_port_active(struct riocp_pe *pe, uint32_t port);
 int RIOCP_WU riocp_pe_is_discovered(struct riocp_pe *pe);
 int RIOCP_WU riocp_pe_set_discovered(struct riocp_pe *pe);
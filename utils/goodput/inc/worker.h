@@ -63,6 +63,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "rapidio_mport_mgmt.h"
 #include "rapidio_mport_sock.h"
 #include "libtime_utils.h"
+#include "librsvdmem.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -146,6 +147,8 @@ struct worker {
 	uint64_t ib_rio_addr; /* Inbound window RapidIO address */
 	uint64_t ib_byte_cnt; /* Inbound window size */
 	void *ib_ptr; /* Pointer to mapped ib_handle */
+	struct rsvd_buddy *ib_rsvd; /* Reserved memory ib_handle came from */
+	uint64_t ib_rsvd_addr; /* Block of ib_rsvd holding the window */
 
 	uint8_t data8_tx;
 	uint16_t data16_tx;
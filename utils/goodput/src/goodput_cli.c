@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #ifndef __STDC_FORMAT_MACROS
 #define __STDC_FORMAT_MACROS
 #endif
@@ -423,6 +424,7 @@ static int IBAllocCmd(struct cli_env *env, int argc, char **argv)
 	uint64_t ib_size;
 	uint64_t ib_rio_addr = RIO_ANY_ADDR;
 	uint64_t ib_phys_addr= RIO_ANY_ADDR;
+	struct rsvd_buddy *rsvd = NULL;
 
 	if (gp_parse_worker_index_check_thread(env, argv[0], &idx, 1)) {
 		goto exit;
@@ -433,13 +435,25 @@ static int IBAllocCmd(struct cli_env *env, int argc, char **argv)
 		goto exit;
 	}
 
-	/* Note: RSVD overrides rio_addr */
+	/* Note: RSVD overrides rio_addr.  The window is a block of the
+	 * reserved memory, shared with other processes by its allocator.
+	 */
 	if (argc > 3) {
-		if (get_rsvd_phys_mem(argv[3], &ib_phys_addr, &ib_size)) {
+		if (wkr[idx].ib_valid || (NULL != wkr[idx].ib_rsvd)) {
+			LOGMSG(env, "\nInbound window already allocated\n");
+			goto exit;
+		}
+		if (rsvd_buddy_open(argv[3], &rsvd)) {
 			LOGMSG(env, "\nNo reserved memory found for keyword %s",
 					argv[3]);
 			goto exit;
 		}
+		if (rsvd_buddy_alloc_ibwin(rsvd, ib_size, &ib_phys_addr)) {
+			LOGMSG(env, "\nNo free 0x%" PRIx64 " byte block in %s\n",
+					ib_size, argv[3]);
+			rsvd_buddy_close(rsvd);
+			goto exit;
+		}
 	} else if ((argc > 2)
 			&& (tok_parse_ulonglong(argv[2], &ib_rio_addr, 1,
 					UINT64_MAX, 0))) {
@@ -458,6 +472,8 @@ static int IBAllocCmd(struct cli_env *env, int argc, char **argv)
 	wkr[idx].ib_byte_cnt = ib_size;
 	wkr[idx].ib_rio_addr = ib_rio_addr;
 	wkr[idx].ib_handle = ib_phys_addr;
+	wkr[idx].ib_rsvd = rsvd;
+	wkr[idx].ib_rsvd_addr = (NULL == rsvd) ? 0 : ib_phys_addr;
 	wkr[idx].stop_req = 0;
 	sem_post(&wkr[idx].run);
 
@@ -475,7 +491,8 @@ struct cli_cmd IBAlloc = {
 	"<addr> is the optional RapidIO address for the inbound window\n"
 	"       NOTE: <addr> must be aligned to <size>\n"
 	"<RSVD> is a keyword for reserved memory area\n"
-	"       NOTE: If <RSVD> is specified, <addr> is ignored\n",
+	"       NOTE: If <RSVD> is specified, <addr> is ignored, and the\n"
+	"       window is a <size> block of the reserved memory area\n",
 IBAllocCmd,
 ATTR_NONE
 };
@@ -2569,7 +2586,9 @@ static int UTimeCmd(struct cli_env *env, int argc, char **argv)
 	struct seq_ts *ts_p = NULL;
 	uint64_t lim = 0;
 	int got_one = 0;
-	struct timespec diff, min, max, tot;
+	struct timespec diff;
+	struct time_ns_stats stats;
+	int64_t *deltas = NULL;
 
 	if (gp_parse_worker_index_check_thread(env, argv[0], &idx, 0)) {
 		goto exit;
@@ -2680,18 +2699,28 @@ static int UTimeCmd(struct cli_env *env, int argc, char **argv)
 			lim = 0;
 		}
 
+		// Allocated per command, CLI sessions may run concurrently
+		deltas = (int64_t *)calloc(end_i - st_i + 1, sizeof(*deltas));
+		if (NULL == deltas) {
+			LOGMSG(env, "\nFAILED: Could not allocate deltas\n");
+			goto exit;
+		}
+		if (seq_ts_deltas_ns(ts_p, st_i, end_i, deltas) < 0) {
+			LOGMSG(env, "\nFAILED: Invalid timestamp indices\n");
+			goto exit;
+		}
+		time_ns_stats_init(&stats);
+		time_ns_reduce(deltas, end_i - st_i, &stats);
+
 		for (idx = st_i; idx < end_i; idx++) {
-			time_track(idx, ts_p->ts_val[idx], ts_p->ts_val[idx+1],
-				&tot, &min, &max);
-			diff = time_difference(ts_p->ts_val[idx],
-						ts_p->ts_val[idx+1]);
-			if ((uint64_t)diff.tv_nsec < lim)
+			if ((uint64_t)deltas[idx - st_i] < lim)
 				continue;
 			if (!got_one) {
 				LOGMSG(env,
 				"\nIdx ---->> Sec<<---- Nsec---MMMuuuNNN Marker\n");
 				got_one = 1;
 			}
+			diff = time_ns_to_ts(deltas[idx - st_i]);
 			LOGMSG(env, "%4d %16ld %16ld %d -> %d\n", idx,
 				diff.tv_sec, diff.tv_nsec,
 				ts_p->ts_mkr[idx], ts_p->ts_mkr[idx+1]);
@@ -2703,19 +2732,25 @@ static int UTimeCmd(struct cli_env *env, int argc, char **argv)
 		}
 		LOGMSG(env,
 			"\n==== ---->> Sec<<---- Nsec---MMMuuuNNN\n");
+		diff = time_ns_to_ts(stats.count ? stats.min : 0);
 		LOGMSG(env, "Min: %16ld %16ld\n",
-				min.tv_sec, min.tv_nsec);
-		diff = time_div(tot, end_i - st_i);
+				diff.tv_sec, diff.tv_nsec);
+		diff = time_ns_to_ts(stats.count ?
+				stats.total / (int64_t)stats.count : 0);
 		LOGMSG(env, "Avg: %16ld %16ld\n",
 				diff.tv_sec, diff.tv_nsec);
+		diff = time_ns_to_ts(stats.count ? stats.max : 0);
 		LOGMSG(env, "Max: %16ld %16ld\n",
-				max.tv_sec, max.tv_nsec);
+				diff.tv_sec, diff.tv_nsec);
+		LOGMSG(env, "Std: %16s %16.0f\n", "",
+				time_ns_stats_stddev(&stats));
 		break;
 	default:
 		LOGMSG(env, "FAILED: <cmd> not 's','p' or 'l'\n");
 	}
 
 exit:
+	free(deltas);
 	return 0;
 }
 
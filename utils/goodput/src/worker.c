@@ -111,6 +111,8 @@ void init_worker_info(struct worker *info, int first_time)
 	info->ib_rio_addr = 0;
 	info->ib_byte_cnt = 0;
 	info->ib_ptr = NULL;
+	info->ib_rsvd = NULL;
+	info->ib_rsvd_addr = 0;
 
 	info->data8_tx = 0x12;
 	info->data16_tx= 0x3456;
@@ -1344,6 +1346,21 @@ exit:
 
 }
 
+/* Returns the reserved memory block of the inbound window, if any */
+static void dma_free_ib_rsvd(struct worker *info)
+{
+	if (NULL == info->ib_rsvd) {
+		return;
+	}
+	if (rsvd_buddy_free(info->ib_rsvd, info->ib_rsvd_addr)) {
+		ERR("FAILED: rsvd_buddy_free 0x%" PRIx64 " : %s\n",
+				info->ib_rsvd_addr, strerror(errno));
+	}
+	rsvd_buddy_close(info->ib_rsvd);
+	info->ib_rsvd = NULL;
+	info->ib_rsvd_addr = 0;
+}
+
 bool dma_alloc_ibwin(struct worker *info)
 {
 	uint64_t i;
@@ -1359,10 +1376,12 @@ bool dma_alloc_ibwin(struct worker *info)
 	if (rc) {
 		ERR("FAILED: riomp_dma_ibwin_map rc %d:%s\n",
 					rc, strerror(errno));
+		dma_free_ib_rsvd(info);
 		return false;
 	}
 	if (info->ib_handle == 0) {
 		ERR("FAILED: riomp_dma_ibwin_map failed silently with info->ib_handle==0!\n");
+		dma_free_ib_rsvd(info);
 		return false;
 	}
 
@@ -1374,11 +1393,13 @@ bool dma_alloc_ibwin(struct worker *info)
 		riomp_dma_ibwin_free(info->mp_h, &info->ib_handle);
 		ERR("FAILED: riomp_dma_map_memory rc %d:%s\n",
 					rc, strerror(errno));
+		dma_free_ib_rsvd(info);
 		return false;
 	}
 	if (info->ib_ptr == NULL) {
 		riomp_dma_ibwin_free(info->mp_h, &info->ib_handle);
 		ERR("FAILED: riomp_dma_map_memory failed silently with ib_ptr==NULL!\n");
+		dma_free_ib_rsvd(info);
 		return false;
 	}
 
@@ -1415,6 +1436,7 @@ void dma_free_ibwin(struct worker *info)
 		return;
 	}
 
+	dma_free_ib_rsvd(info);
 	info->ib_valid = 0;
 	info->ib_rio_addr = 0;
 	info->ib_byte_cnt = 0;